@@ -59,7 +59,7 @@ const int MAX_CASCADE_COUNT = 4;
 const int MAX_SHADOWCASTING_DIRECTIONAL = 4;
 const int MAX_SHADOWCASTING_SPOT = 8;
 const int MAX_SHADOWCASTING_POINT = 8;
-const int MAX_SHADOWCASTING_LIGHT_MATRICES = 64;
+const int MAX_SHADOWCASTING_LIGHT_MATRICES = 72;
 const float PI = 3.14159265359;
 const float EPSILON = 0.0000001;
 const float BASE_DEPTH_BIAS = 0.005;
@@ -97,13 +97,36 @@ layout(set = 0, binding = 0) uniform EnviromentLightingUbo {
     vec4 cameraPosition;
     float ambientIntensity;
     float reflectionIntensity;
+    uint hasIrradianceSH;
+    vec4 irradianceSH[9];
 } enviromentLighting;
 
+// Visible lights of this frame, each referencing a persistent slot plus its shadow assignment
+struct VisibleLight {
+    int lightSlot;
+    int lightMatrixOffset;
+    int shadowmapIndex;
+    int isCastingShadow;
+};
+
 layout(set = 1, binding = 0) uniform LightUbo {
-    Light lights[MAX_LIGHTS];
+    VisibleLight lights[MAX_LIGHTS];
     int lightCount;
 } unifiedLights;
 
+layout(set = 1, binding = 1) readonly buffer LightSlots {
+    Light lights[];
+} lightSlots;
+
+Light fetchVisibleLight(int index) {
+    VisibleLight visible = unifiedLights.lights[index];
+    Light light = lightSlots.lights[visible.lightSlot];
+    light.lightMatrixOffset = visible.lightMatrixOffset;
+    light.shadowmapIndex = visible.shadowmapIndex;
+    light.isCastingShadow = visible.isCastingShadow;
+    return light;
+}
+
 layout(set = 2, binding = 0) uniform sampler2D positionTexture;
 layout(set = 2, binding = 1) uniform sampler2D normalTexture;
 layout(set = 2, binding = 2) uniform sampler2D albedoTexture;
@@ -571,6 +594,20 @@ float SpecularEnergyCompensation(float roughness) {
 //=============================================================================
 
 vec3 sampleDiffuseIBL(vec3 normal) {
+    if (enviromentLighting.hasIrradianceSH != 0u) {
+        // Irradiance / pi of the skybox, cosine convolution and basis constants are folded in on the CPU
+        vec3 n = normal;
+        vec3 irradiance = enviromentLighting.irradianceSH[0].rgb
+            + enviromentLighting.irradianceSH[1].rgb * n.y
+            + enviromentLighting.irradianceSH[2].rgb * n.z
+            + enviromentLighting.irradianceSH[3].rgb * n.x
+            + enviromentLighting.irradianceSH[4].rgb * (n.x * n.y)
+            + enviromentLighting.irradianceSH[5].rgb * (n.y * n.z)
+            + enviromentLighting.irradianceSH[6].rgb * (3.0 * n.z * n.z - 1.0)
+            + enviromentLighting.irradianceSH[7].rgb * (n.x * n.z)
+            + enviromentLighting.irradianceSH[8].rgb * (n.x * n.x - n.y * n.y);
+        return max(irradiance, vec3(0.0));
+    }
     // Sample the lowest mip to approximate an irradiance-like blur
     float mipCount = float(textureQueryLevels(enviromentMap));
     float diffuseMip = max(mipCount - 1.0, 0.0);
@@ -581,6 +618,7 @@ vec3 calculateIBLSpecular(vec3 normal, vec3 viewDir, vec3 albedo, float roughnes
     vec3 R = normalize(reflect(-viewDir, normal));
     vec3 F0 = mix(vec3(0.04), albedo, metallic);
 
+    // Level i of the prefiltered environment is GGX-filtered for roughness i / (levels - 1)
     float mipCount = float(textureQueryLevels(enviromentMap));
     float mipLevel = roughness * max(mipCount - 1.0, 0.0);
     vec3 prefilteredColor = textureLod(enviromentMap, R, mipLevel).rgb;
@@ -729,7 +767,7 @@ void main() {
     vec3 directIncident = vec3(0.0);
     for (int i = 0; i < unifiedLights.lightCount; ++i) {
         vec3 incident = vec3(0.0);
-        directLighting += calculateUnifiedLight(unifiedLights.lights[i], worldPos, normal,
+        directLighting += calculateUnifiedLight(fetchVisibleLight(i), worldPos, normal,
                                                 viewDir, albedo, roughness, metallic, F0, kS, kD,
                                                 incident);
         directIncident += incident;
@@ -14,7 +14,7 @@ layout(push_constant) uniform PushConstants {
 } push;
 
 layout(set = 0, binding = 0) uniform ShadowUBO {
-    mat4 lightSpaceMatrices[64];
+    mat4 lightSpaceMatrices[72];
 } ubo;
 
 layout(std430, set = 1, binding = 0) readonly buffer ModelMatrixBuffer {
@@ -0,0 +1,61 @@
+#version 450
+#extension GL_EXT_multiview : enable
+//=============================================================================
+// SINGLE-PASS POINT LIGHT SHADOW (MULTIVIEW)
+//=============================================================================
+//
+// Renders all six cube faces of a point light in one render pass.
+// gl_ViewIndex selects the face, so the light matrix is lightMatrixIndex + face.
+//
+// Face Masks:
+//   - The CPU tests each caster against the six face frustums and stores
+//     a 6-bit mask per instance (bit N = face N)
+//   - Instances that do not touch the current face are moved outside the
+//     clip volume so the rasterizer rejects them before any fragment work
+//
+//=============================================================================
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 uv;
+
+layout(location = 0) out vec3 outWorldPos;
+layout(location = 1) out vec2 outUV;
+
+layout(push_constant) uniform PushConstants {
+    vec4 lightPosRange;
+    uint lightMatrixIndex;       // Base index of the six face matrices
+    uint modelMatrixOffset;      // Offset into model matrix buffer
+    uint lightType;              // Always 2 = point
+} push;
+
+layout(set = 0, binding = 0) uniform ShadowUBO {
+    mat4 lightSpaceMatrices[72];
+} ubo;
+
+layout(std430, set = 1, binding = 0) readonly buffer ModelMatrixBuffer {
+    mat4 modelMatrices[];
+} modelMatrixBuffer;
+
+layout(std430, set = 1, binding = 1) readonly buffer FaceMaskBuffer {
+    uint faceMasks[];
+} faceMaskBuffer;
+
+
+void main() {
+    uint instanceIndex = gl_InstanceIndex + push.modelMatrixOffset;
+    uint faceMask = faceMaskBuffer.faceMasks[instanceIndex];
+
+    mat4 modelMatrix = modelMatrixBuffer.modelMatrices[instanceIndex];
+    vec4 worldPos = modelMatrix * vec4(position, 1.0);
+
+    outWorldPos = worldPos.xyz;
+    outUV = uv;
+
+    if ((faceMask & (1u << gl_ViewIndex)) == 0u) {
+        // Every vertex of the instance lands at the same point outside the clip volume
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    gl_Position = ubo.lightSpaceMatrices[push.lightMatrixIndex + gl_ViewIndex] * worldPos;
+}
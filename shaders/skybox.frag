@@ -7,5 +7,6 @@ layout(location = 0) out vec4 outColor;
 layout(set = 1, binding = 0) uniform samplerCube skybox;
 
 void main() {
-    outColor = texture(skybox, inTexCoord);
+    // Lower levels are prefiltered for rough reflections, not downsampled sky
+    outColor = textureLod(skybox, inTexCoord, 0.0);
 }
\ No newline at end of file
@@ -48,7 +48,7 @@ const int MAX_CASCADE_COUNT = 4;
 const int MAX_SHADOWCASTING_DIRECTIONAL = 4;
 const int MAX_SHADOWCASTING_SPOT = 8;
 const int MAX_SHADOWCASTING_POINT = 8;
-const int MAX_SHADOWCASTING_LIGHT_MATRICES = 64;
+const int MAX_SHADOWCASTING_LIGHT_MATRICES = 72;
 const float PI = 3.14159265359;
 const float EPSILON = 0.0000001;
 const float BASE_AMBIENT_INTENSITY = 0.05;
@@ -85,11 +85,32 @@ layout(set = 0, binding = 0) uniform CameraUBO {
 } camera;
 
 // Set 1: Unified light array
+// Visible lights of this frame, each referencing a persistent slot plus its shadow assignment
+struct VisibleLight {
+    int lightSlot;
+    int lightMatrixOffset;
+    int shadowmapIndex;
+    int isCastingShadow;
+};
+
 layout(set = 1, binding = 0) uniform LightUbo {
-    Light lights[MAX_LIGHTS];
+    VisibleLight lights[MAX_LIGHTS];
     int lightCount;
 } unifiedLights;
 
+layout(set = 1, binding = 1) readonly buffer LightSlots {
+    Light lights[];
+} lightSlots;
+
+Light fetchVisibleLight(int index) {
+    VisibleLight visible = unifiedLights.lights[index];
+    Light light = lightSlots.lights[visible.lightSlot];
+    light.lightMatrixOffset = visible.lightMatrixOffset;
+    light.shadowmapIndex = visible.shadowmapIndex;
+    light.isCastingShadow = visible.isCastingShadow;
+    return light;
+}
+
 // Set 2: Shadow map samplers
 layout(set = 2, binding = 0) uniform sampler2DArray directionalShadowMaps[MAX_SHADOWCASTING_DIRECTIONAL];
 layout(set = 2, binding = 1) uniform sampler2D spotShadowMaps[MAX_SHADOWCASTING_SPOT];
@@ -149,13 +170,15 @@ float saturate(float x) {
 vec3 calculateNormal() {
     vec3 N = normalize(fragNormal);
     
-    vec3 normalMapValue = texture(normalTexture, fragUV).xyz;
+    // BC5 normal maps only store RG; Z is reconstructed as in geometry.frag
+    vec2 normalMapValue = texture(normalTexture, fragUV).rg;
     
-    if (normalMapValue == vec3(0.5, 0.5, 1.0) || length(normalMapValue) < 0.1) {
+    if (length(normalMapValue) < 0.1) {
         return N;
     }
     
-    vec3 tangentSpaceNormal = normalMapValue * 2.0 - 1.0;
+    vec2 normalXY = normalMapValue * 2.0 - 1.0;
+    vec3 tangentSpaceNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
     
     mat3 TBN = mat3(
         normalize(fragTangent),
@@ -556,7 +579,7 @@ void main() {
     vec3 directLighting = vec3(0.0);
     for (int i = 0; i < unifiedLights.lightCount; ++i) {
         directLighting += calculateUnifiedLight(
-            unifiedLights.lights[i], fragPosition, N, V,
+            fetchVisibleLight(i), fragPosition, N, V,
             baseColor.rgb, roughness, metallic, F0, kS, kD
         );
     }
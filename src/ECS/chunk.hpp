@@ -25,6 +25,8 @@ public:
 
     bool isFull() const;
     std::size_t addComponent(const T& component);
+    // Copies as many of the components as fit and returns how many; they are contiguous from firstIndex
+    std::size_t appendComponents(const T* components, std::size_t count, std::size_t& firstIndex);
     void addComponentToPosition(const ComponentIndex& componentIndex, const T& component);
     void removeComponent(std::size_t index);
     T* getComponent(std::size_t index);
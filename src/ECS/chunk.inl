@@ -27,6 +27,21 @@ std::size_t Chunk<T>::addComponent(const T& component) {
     return index;
 }
 
+template<typename T>
+std::size_t Chunk<T>::appendComponents(const T* components, std::size_t count, std::size_t& firstIndex) {
+    // Free slots are scattered, fill them one at a time
+    if (!m_freeIndices.empty()) {
+        firstIndex = addComponent(components[0]);
+        return 1;
+    }
+
+    std::size_t appended = std::min(count, m_capacity - m_size);
+    std::copy(components, components + appended, m_data.get() + m_size);
+    firstIndex = m_size;
+    m_size += appended;
+    return appended;
+}
+
 template<typename T>
 void Chunk<T>::addComponentToPosition(const ComponentIndex& componentIndex, const T& component) {   
     if (componentIndex.componentIndex >= m_capacity) {
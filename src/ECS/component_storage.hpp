@@ -30,6 +30,8 @@ namespace ECS{
         explicit ComponentStorage(std::size_t chunkSize) : m_chunkSize(chunkSize) {}
 
         void addComponent(EntityID entityId, const T& component);
+        // Appends count components in chunk-sized runs, writing each one's address to stored
+        void addComponents(const EntityID* entityIds, const T* components, std::size_t count, T** stored);
         void removeEntity(ECS::EntityID entityId) override;
         T* getComponent(EntityID entityId);
         T* getFirstComponent();
@@ -17,6 +17,31 @@ template<typename T>
     }
 
 
+template<typename T>
+    void ComponentStorage<T>::addComponents(const EntityID* entityIds, const T* components, std::size_t count, T** stored) {
+        m_entityComponentMap.reserve(m_entityComponentMap.size() + count);
+        m_componentEntityMap.reserve(m_componentEntityMap.size() + count);
+
+        std::size_t added = 0;
+        while (added < count) {
+            if (m_chunks.empty() || m_chunks.back()->isFull()) {
+                m_chunks.push_back(std::make_unique<Chunk<T>>(m_chunkSize));
+            }
+
+            Chunk<T>& chunk = *m_chunks.back();
+            std::size_t chunkIndex = m_chunks.size() - 1;
+            std::size_t firstIndex = 0;
+            std::size_t appended = chunk.appendComponents(components + added, count - added, firstIndex);
+            for (std::size_t i = 0; i < appended; i++) {
+                ComponentIndex location{chunkIndex, firstIndex + i};
+                mapEntity(entityIds[added + i], location);
+                stored[added + i] = chunk.getComponent(firstIndex + i);
+            }
+            m_lastComponentLocation = ComponentIndex{chunkIndex, firstIndex + appended - 1};
+            added += appended;
+        }
+    }
+
  template<typename T>
     void ComponentStorage<T>::removeEntity(EntityID entityId) {
         auto it = m_entityComponentMap.find(entityId);
@@ -10,6 +10,18 @@ EntityID ECSManager::createEntity() {
     return id;
 }
 
+EntityID ECSManager::createEntities(std::size_t count) {
+    EntityID first = nextEntityId;
+    m_Entities.reserve(m_Entities.size() + count);
+    entityMasks.reserve(entityMasks.size() + count);
+    for (std::size_t i = 0; i < count; i++) {
+        m_Entities.emplace_back(static_cast<EntityID>(first + i));
+        entityMasks.emplace(static_cast<EntityID>(first + i), ComponentMask());
+    }
+    nextEntityId += static_cast<EntityID>(count);
+    return first;
+}
+
 void ECSManager::destroyEntity(EntityID entity) {
     // Get the component mask for this entity
     auto maskIt = entityMasks.find(entity);
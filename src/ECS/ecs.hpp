@@ -47,6 +47,8 @@ namespace ECS{
             ECSManager& operator=(ECSManager&&) = default;
 
             EntityID createEntity();
+            // Reserves count consecutive ids in one go and returns the first; the entities start without components
+            EntityID createEntities(std::size_t count);
             void destroyEntity(EntityID entity);
             
             template<typename T>
@@ -55,6 +57,11 @@ namespace ECS{
             template<typename T>
             void addComponent(EntityID entity, const T& component);
 
+            // components[i] goes to entities[i]; the type is looked up once and the chunks are filled in runs.
+            // Returns where each component is stored
+            template<typename T>
+            std::vector<T*> addComponents(const std::vector<EntityID>& entities, const std::vector<T>& components);
+
             template<typename T>
             void removeComponent(EntityID entity);
 
@@ -32,6 +32,28 @@ void ECSManager::registerComponentType(std::size_t chunkSize) {
 
 
 
+    template<typename T>
+    std::vector<T*> ECSManager::addComponents(const std::vector<EntityID>& entities, const std::vector<T>& components) {
+        if (entities.size() != components.size()) {
+            throw std::runtime_error("addComponents needs one entity per component");
+        }
+
+        const char* typeName = typeid(T).name();
+        if (componentTypes.find(typeName) == componentTypes.end()) {
+            registerComponentType<T>();
+        }
+
+        ComponentTypeID typeId = getComponentTypeID<T>();
+        auto& storage = static_cast<ComponentStorage<T>&>(*componentStorages[typeId]);
+        std::vector<T*> stored(components.size());
+        storage.addComponents(entities.data(), components.data(), components.size(), stored.data());
+
+        for (EntityID entity : entities) {
+            entityMasks[entity].set(typeId);
+        }
+        return stored;
+    }
+
     template<typename T>
     void ECSManager::removeComponent(EntityID entity) {
         ComponentTypeID typeId = getComponentTypeID<T>();
@@ -1,14 +1,27 @@
 #include "alpha_engine.hpp"
 
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
 // Define deltaTime here
 float AlphaEngine::deltaTime = 0.0f;
 
+namespace {
+    ECS::Transform* getCameraTransform() {
+        auto& ecsManager = ECS::ECSManager::getInstance();
+        ECS::Camera* camera = ecsManager.getFirstComponent<ECS::Camera>();
+        return camera ? ecsManager.getComponent<ECS::Transform>(camera->owner) : nullptr;
+    }
+}
+
     void AlphaEngine::run(){
         init();
+        if (settings.headless) {
+            runBenchmark();
+            return;
+        }
         auto currentTime = std::chrono::high_resolution_clock::now();
         deltaTime=0.0f;
 
@@ -20,7 +33,13 @@ float AlphaEngine::deltaTime = 0.0f;
         int frameCount = 0;
         float currentFPS = 0.0f;
 
+        // Flown path for later headless playback, timed from the first frame that has a camera
+        Engine::CameraPath recordedPath;
+        float recordedTime = 0.0f;
+
+        CPU_PROFILE_THREAD("Main");
         while (!window->shouldClose()) {
+            CPU_PROFILE_FRAME();
             glfwPollEvents();
             auto newTime = std::chrono::high_resolution_clock::now();
             deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
@@ -45,11 +64,28 @@ float AlphaEngine::deltaTime = 0.0f;
                 renderer->getImGuiManager()->setFrameStats(currentFPS, deltaTime * 1000.0f);
             }
 
-            keyboardMovementSystem->run(deltaTime);
-            Systems::CameraSystem::run(*window);
+            if (sceneLoader) {
+                CPU_PROFILE_ZONE("Scene load commit");
+                updateSceneLoad();
+            }
+
+            {
+                CPU_PROFILE_ZONE("Input and camera");
+                keyboardMovementSystem->run(deltaTime);
+                Systems::CameraSystem::run(*window);
+            }
+            if (!settings.recordCameraPath.empty()) {
+                if (ECS::Transform* transform = getCameraTransform()) {
+                    recordedPath.addKey(recordedTime, transform->position, transform->rotation);
+                    recordedTime += deltaTime;
+                }
+            }
             renderer->run();
         }
     
+        // Closing mid-load waits for the loader thread, which must not race the idle wait on the queues
+        sceneLoader.reset();
+        sceneUploadManager.reset();
         vkDeviceWaitIdle(device->getDevice());
 
         // --- Debug: Report stutter frames after the loop ---
@@ -58,48 +94,175 @@ float AlphaEngine::deltaTime = 0.0f;
             ++stutterCount;
         }
 
+#if CPU_PROFILER_ENABLED
+        if (Engine::CPU_PROFILER_EXPORT_ON_EXIT) {
+            Engine::CpuProfiler::getInstance().exportCapture();
+        }
+#endif
+
         std::cout << "Total stutter frames (>16ms): " << stutterCount << " out of " << frameTimes.size() << std::endl;
+
+        if (!settings.recordCameraPath.empty() && !recordedPath.empty()) {
+            recordedPath.save(settings.recordCameraPath);
+            std::cout << "Camera path written to " << settings.recordCameraPath << std::endl;
+        }
+    }
+
+    void AlphaEngine::runBenchmark() {
+        CPU_PROFILE_THREAD("Main");
+        ECS::Transform* cameraTransform = getCameraTransform();
+        if (cameraTransform == nullptr) {
+            throw std::runtime_error("the scene has no camera to benchmark");
+        }
+        Engine::CameraPath cameraPath;
+        if (!settings.cameraPath.empty()) {
+            cameraPath.load(settings.cameraPath);
+        }
+        uint32_t frameCount = settings.frameCount;
+        if (frameCount == 0) {
+            frameCount = cameraPath.empty()
+                ? Engine::BENCHMARK_DEFAULT_FRAMES
+                : static_cast<uint32_t>(std::ceil(cameraPath.getDuration() / settings.timestep)) + 1;
+        }
+
+        // No resize event ever reaches a headless window, so the aspect ratio is set once here
+        Systems::CameraSystem::setAspectRatio(static_cast<float>(settings.width) / static_cast<float>(settings.height));
+        deltaTime = settings.timestep;
+
+        Engine::BenchmarkRecorder recorder{settings};
+        GpuProfiler* gpuProfiler = renderer->getGpuProfiler();
+        std::vector<uint8_t> pixels;
+        std::cout << "Benchmark: " << settings.warmupFrames << " warm-up and " << frameCount << " measured frames at "
+                  << settings.width << "x" << settings.height << ", " << renderer->getRecordingThreads()
+                  << " recording thread(s), " << renderer->getFramesInFlight() << " frame(s) in flight" << std::endl;
+
+        // A headless frame is never skipped, so the loop index is also the GPU profiler's frame number
+        const uint32_t totalFrames = settings.warmupFrames + frameCount;
+        for (uint32_t frame = 0; frame < totalFrames; ++frame) {
+            CPU_PROFILE_FRAME();
+            const auto frameStart = std::chrono::high_resolution_clock::now();
+
+            // Warm-up frames hold the first key so pipelines, caches and temporal history settle on it
+            const bool measured = frame >= settings.warmupFrames;
+            const float time = measured ? static_cast<float>(frame - settings.warmupFrames) * settings.timestep : 0.0f;
+            if (!cameraPath.empty()) {
+                CPU_PROFILE_ZONE("Camera path");
+                cameraPath.sample(time, cameraTransform->position, cameraTransform->rotation);
+                TransformSystem::updateTransform(*cameraTransform);
+            }
+            Systems::CameraSystem::run(*window);
+            renderer->run();
+
+            const double cpuMs = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - frameStart).count();
+            if (gpuProfiler) {
+                recorder.collectGpuTimings(*gpuProfiler);
+            }
+            if (!measured) {
+                continue;
+            }
+            const Renderer::RecordingStats& recording = renderer->getRecordingStats();
+            recorder.recordFrame(frame, time, cpuMs, recording.recordMs, recording.batchDraws,
+                                 recording.lightUpdateMs, recording.shadowViews);
+            const uint32_t measuredIndex = frame - settings.warmupFrames;
+            if (settings.dumpInterval > 0 && measuredIndex % settings.dumpInterval == 0 && renderer->captureLastFrame(pixels)) {
+                recorder.writeImage(frame, settings.width, settings.height, pixels);
+            }
+        }
+
+        vkDeviceWaitIdle(device->getDevice());
+        if (gpuProfiler) {
+            gpuProfiler->flush();
+            recorder.collectGpuTimings(*gpuProfiler);
+        }
+        if (!recorder.finish(device->deviceProperties.deviceName, renderer->getRecordingThreads())) {
+            throw std::runtime_error("failed to write benchmark results to " + settings.outputDirectory);
+        }
     }
 
     void AlphaEngine::init(){
-        
-        window=std::make_unique<Window>(WIDTH, HEIGHT, "Alpha Engine");
+        const bool headless = settings.headless;
+        if (headless) {
+            window=std::make_unique<Window>(static_cast<int>(settings.width), static_cast<int>(settings.height), "Alpha Engine", true);
+        } else {
+            window=std::make_unique<Window>(WIDTH, HEIGHT, "Alpha Engine");
+        }
         device=std::make_unique<Device>(*window);
+        // Before the renderer, which sizes its swapchain fences and per-frame resources from it
+        device->setFramesInFlight(settings.framesInFlight);
         resourceManager=std::make_unique<ResourceManager>(*device);
+        uploadManager=std::make_unique<UploadManager>(*device);
+        if (TEXTURE_STREAMING_ENABLED && (!headless || settings.textureStreaming)) {
+            textureStreamer=std::make_unique<TextureStreamer>(*device, *uploadManager, *resourceManager->getPBRMaterialPool());
+            resourceManager->setTextureStreamer(textureStreamer.get());
+        }
 
-        loadScene();
-
-        renderer=std::make_unique<Renderer>(*window, *device);
+        // Headless runs load synchronously so every measured frame sees the whole scene
+        if (INCREMENTAL_SCENE_LOADING_ENABLED && !headless) {
+            // The renderer comes up first and keeps drawing while the scene streams in from run()
+            renderer=std::make_unique<Renderer>(*window, *device);
+            renderer->setTextureStreamer(textureStreamer.get());
+            beginSceneLoad();
+        } else {
+            loadScene();
+            renderer=std::make_unique<Renderer>(*window, *device);
+            renderer->setTextureStreamer(textureStreamer.get());
+        }
+        if (settings.recordingThreads != PARALLEL_RECORDING_THREADS) {
+            renderer->setRecordingThreads(settings.recordingThreads);
+        }
         
-        keyboardMovementSystem=std::make_unique<KeyboardMovemenSystem>(window->getGLFWwindow());
+        if (!headless) {
+            keyboardMovementSystem=std::make_unique<KeyboardMovemenSystem>(window->getGLFWwindow());
+        }
         
     }
 
     void AlphaEngine::loadScene() {     
     
-        Resources::SceneLoader sceneLoader{*resourceManager, *device};
-        sceneLoader.loadUnityScene("Assets/Scene/Scene.json");
+        Resources::SceneLoader sceneLoader{*resourceManager, *device, *uploadManager, textureStreamer.get()};
+        sceneLoader.loadUnityScene(settings.scenePath);
 
     }
 
-    std::future<bool> AlphaEngine::loadSceneAsync() {
-        Resources::SceneLoader sceneLoader{*resourceManager, *device};
-        return sceneLoader.loadUnitySceneAsync("Assets/Scene/Scene.json");
+    void AlphaEngine::beginSceneLoad() {
+        // The loader thread records its uploads on its own manager; the main one belongs to the texture streamer
+        sceneUploadManager=std::make_unique<UploadManager>(*device);
+        sceneLoader=std::make_unique<Resources::SceneLoader>(*resourceManager, *device, *sceneUploadManager, textureStreamer.get());
+        sceneLoader->beginUnitySceneLoad(settings.scenePath);
+    }
+
+    void AlphaEngine::updateSceneLoad() {
+        if (!sceneLoader->commitPending(SCENE_LOAD_COMMIT_BUDGET_MS)) {
+            return;
+        }
+        sceneLoader.reset();
+        sceneUploadManager.reset();
     }
 
     AlphaEngine::~AlphaEngine() {
+        // Joins the loader thread if the engine goes down mid-load
+        sceneLoader.reset();
+        sceneUploadManager.reset();
         if (device) {
             vkDeviceWaitIdle(device->getDevice());
         }
         
         // Destroy renderer and all its resources first
         renderer.reset();
+        // Materials still reference streamed images, so those go before the resource manager
+        if (resourceManager) {
+            resourceManager->setTextureStreamer(nullptr);
+        }
+        textureStreamer.reset();
         
         // Clean up resource manager
         if (resourceManager) {
             resourceManager->cleanup();
         }
         resourceManager.reset();
+        // Waits for any uploads still in flight before its semaphore and pools go
+        uploadManager.reset();
         
         // Destroy device last
         device.reset();
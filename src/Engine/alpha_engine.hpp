@@ -7,6 +7,8 @@
 #include "Systems/keyboard_movement_system.hpp"
 #include "Systems/transform_system.hpp"
 #include "Rendering/renderer.hpp"
+#include "Engine/cpu_profiler.hpp"
+#include "Engine/benchmark.hpp"
 
 #include <unordered_map>
 #include <future>
@@ -21,7 +23,8 @@ using namespace Resources;
         static constexpr int WIDTH = 1920;
         static constexpr int HEIGHT = 1080;
        
-        AlphaEngine() = default;
+        // settings.headless runs the benchmark instead of the interactive loop
+        explicit AlphaEngine(const Engine::BenchmarkSettings& settings = {}) : settings{settings} {}
         ~AlphaEngine();
         
         void run();
@@ -34,8 +37,18 @@ using namespace Resources;
         std::unique_ptr<Renderer> renderer;      
         std::unique_ptr<KeyboardMovemenSystem> keyboardMovementSystem;
         std::unique_ptr<ResourceManager> resourceManager;
+        std::unique_ptr<UploadManager> uploadManager;
+        std::unique_ptr<TextureStreamer> textureStreamer;
+        // Alive while an incremental load is in progress
+        std::unique_ptr<UploadManager> sceneUploadManager;
+        std::unique_ptr<SceneLoader> sceneLoader;
+        Engine::BenchmarkSettings settings;
         static float deltaTime;
         void init();
+        // Headless: replays the camera path at the fixed timestep and writes the recorder's results
+        void runBenchmark();
         void loadScene();
-        std::future<bool> loadSceneAsync();
+        void beginSceneLoad();
+        // Commits a budgeted slice of the load, called once per frame before the camera and renderer run
+        void updateSceneLoad();
     };
@@ -0,0 +1,383 @@
+#include "benchmark.hpp"
+#include "cpu_profiler.hpp"
+#include "Rendering/Core/gpu_profiler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace Engine {
+
+    namespace {
+        struct Statistics {
+            double mean = 0.0;
+            double p50 = 0.0;
+            double p95 = 0.0;
+            double p99 = 0.0;
+            double max = 0.0;
+        };
+
+        // Nearest-rank percentiles, the same definition the GPU profiler's summary uses
+        Statistics computeStatistics(std::vector<double> values) {
+            Statistics statistics;
+            if (values.empty()) {
+                return statistics;
+            }
+            std::sort(values.begin(), values.end());
+            double sum = 0.0;
+            for (double value : values) {
+                sum += value;
+            }
+            auto percentile = [&values](size_t p) {
+                const size_t rank = (values.size() * p + 99) / 100;
+                return values[std::min(rank > 0 ? rank - 1 : 0, values.size() - 1)];
+            };
+            statistics.mean = sum / values.size();
+            statistics.p50 = percentile(50);
+            statistics.p95 = percentile(95);
+            statistics.p99 = percentile(99);
+            statistics.max = values.back();
+            return statistics;
+        }
+
+        void writeStatistics(std::ostream& out, const Statistics& statistics) {
+            out << "{\"mean\": " << statistics.mean << ", \"p50\": " << statistics.p50 << ", \"p95\": " << statistics.p95
+                << ", \"p99\": " << statistics.p99 << ", \"max\": " << statistics.max << "}";
+        }
+
+        std::string escapeJson(const std::string& text) {
+            std::string escaped;
+            escaped.reserve(text.size());
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+            return escaped;
+        }
+
+        const char* requireValue(int argc, char** argv, int& index) {
+            if (index + 1 >= argc) {
+                throw std::runtime_error(std::string("missing value for ") + argv[index]);
+            }
+            return argv[++index];
+        }
+
+        uint32_t parseUnsigned(const char* name, const char* value) {
+            char* end = nullptr;
+            const unsigned long parsed = std::strtoul(value, &end, 10);
+            if (end == value || *end != '\0' || value[0] == '-') {
+                throw std::runtime_error(std::string("invalid value for ") + name + ": " + value);
+            }
+            return static_cast<uint32_t>(parsed);
+        }
+    }
+
+    BenchmarkSettings BenchmarkSettings::parse(int argc, char** argv) {
+        BenchmarkSettings settings;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            if (argument == "--headless") {
+                settings.headless = true;
+            } else if (argument == "--width") {
+                settings.width = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--height") {
+                settings.height = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--frames") {
+                settings.frameCount = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--warmup") {
+                settings.warmupFrames = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--timestep") {
+                const char* value = requireValue(argc, argv, i);
+                settings.timestep = std::strtof(value, nullptr);
+                if (!(settings.timestep > 0.0f)) {
+                    throw std::runtime_error(std::string("invalid value for --timestep: ") + value);
+                }
+            } else if (argument == "--scene") {
+                settings.scenePath = requireValue(argc, argv, i);
+            } else if (argument == "--camera-path") {
+                settings.cameraPath = requireValue(argc, argv, i);
+            } else if (argument == "--output") {
+                settings.outputDirectory = requireValue(argc, argv, i);
+            } else if (argument == "--dump-every") {
+                settings.dumpInterval = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--texture-streaming") {
+                settings.textureStreaming = true;
+            } else if (argument == "--record-camera-path") {
+                settings.recordCameraPath = requireValue(argc, argv, i);
+            } else if (argument == "--recording-threads") {
+                settings.recordingThreads = parseUnsigned(argv[i], requireValue(argc, argv, i));
+            } else if (argument == "--frames-in-flight") {
+                settings.framesInFlight = parseUnsigned(argv[i], requireValue(argc, argv, i));
+                if (settings.framesInFlight == 0 || settings.framesInFlight > Rendering::MAX_FRAMES_IN_FLIGHT) {
+                    throw std::runtime_error("--frames-in-flight must be between 1 and " +
+                                             std::to_string(Rendering::MAX_FRAMES_IN_FLIGHT));
+                }
+            } else {
+                throw std::runtime_error("unknown argument: " + argument);
+            }
+        }
+        if (settings.width == 0 || settings.height == 0) {
+            throw std::runtime_error("--width and --height must be greater than zero");
+        }
+        return settings;
+    }
+
+    void CameraPath::load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("failed to open camera path: " + path);
+        }
+        keys.clear();
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            std::istringstream stream(line);
+            Key key{};
+            if (!(stream >> key.time)) {
+                continue;   // blank or comment-only line
+            }
+            if (!(stream >> key.position.x >> key.position.y >> key.position.z
+                         >> key.rotation.w >> key.rotation.x >> key.rotation.y >> key.rotation.z)) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected time px py pz qw qx qy qz");
+            }
+            if (!keys.empty() && key.time <= keys.back().time) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": key times must increase");
+            }
+            key.rotation = glm::normalize(key.rotation);
+            keys.push_back(key);
+        }
+        if (keys.empty()) {
+            throw std::runtime_error("camera path has no keys: " + path);
+        }
+    }
+
+    void CameraPath::save(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            throw std::runtime_error("failed to write camera path: " + path);
+        }
+        file << "# time px py pz qw qx qy qz\n";
+        file << std::fixed << std::setprecision(6);
+        for (const Key& key : keys) {
+            file << key.time << ' ' << key.position.x << ' ' << key.position.y << ' ' << key.position.z << ' '
+                 << key.rotation.w << ' ' << key.rotation.x << ' ' << key.rotation.y << ' ' << key.rotation.z << '\n';
+        }
+        if (!file) {
+            throw std::runtime_error("failed to write camera path: " + path);
+        }
+    }
+
+    void CameraPath::addKey(float time, const glm::vec3& position, const glm::quat& rotation) {
+        if (!keys.empty() && time <= keys.back().time) {
+            return;
+        }
+        keys.push_back({time, position, rotation});
+    }
+
+    void CameraPath::sample(float time, glm::vec3& position, glm::quat& rotation) const {
+        if (keys.empty()) {
+            return;
+        }
+        // Paths start wherever the recording did; playback time is relative to the first key
+        time += keys.front().time;
+        auto next = std::upper_bound(keys.begin(), keys.end(), time,
+                                     [](float t, const Key& key) { return t < key.time; });
+        if (next == keys.begin() || next == keys.end()) {
+            const Key& key = next == keys.begin() ? keys.front() : keys.back();
+            position = key.position;
+            rotation = key.rotation;
+            return;
+        }
+        const Key& previous = *(next - 1);
+        const float t = (time - previous.time) / (next->time - previous.time);
+        position = glm::mix(previous.position, next->position, t);
+        rotation = glm::normalize(glm::slerp(previous.rotation, next->rotation, t));
+    }
+
+    BenchmarkRecorder::BenchmarkRecorder(const BenchmarkSettings& settings) : settings{settings} {
+        std::error_code error;
+        std::filesystem::create_directories(settings.outputDirectory, error);
+        if (error) {
+            throw std::runtime_error("failed to create benchmark output directory " + settings.outputDirectory + ": " + error.message());
+        }
+    }
+
+    std::string BenchmarkRecorder::outputPath(const std::string& name) const {
+        return (std::filesystem::path(settings.outputDirectory) / name).string();
+    }
+
+    void BenchmarkRecorder::recordFrame(uint64_t frameNumber, float time, double cpuMs, double recordMs, uint32_t batchDraws,
+                                        double lightUpdateMs, uint32_t shadowViews) {
+        frames.push_back({frameNumber, time, cpuMs, recordMs, batchDraws, lightUpdateMs, shadowViews, false});
+    }
+
+    void BenchmarkRecorder::collectGpuTimings(const Rendering::GpuProfiler& profiler) {
+        for (const Rendering::GpuProfiler::FrameTimings& frame : profiler.getHistory()) {
+            if (frame.frameNumber < nextGpuFrame) {
+                continue;
+            }
+            nextGpuFrame = frame.frameNumber + 1;
+            if (frame.frameNumber < settings.warmupFrames || frame.scopes.empty()) {
+                continue;
+            }
+            // scopes[0] is the frame scope
+            gpuFrameMs[frame.frameNumber] = frame.scopes.front().ms;
+            for (const Rendering::GpuProfiler::ScopeTiming& scope : frame.scopes) {
+                scopes.push_back({frame.frameNumber, Rendering::GpuProfiler::getLabel(scope), scope.depth, scope.ms});
+            }
+        }
+    }
+
+    void BenchmarkRecorder::writeImage(uint64_t frameNumber, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb) {
+        std::ostringstream name;
+        name << "frame_" << std::setw(5) << std::setfill('0') << frameNumber - settings.warmupFrames << ".ppm";
+        const std::string path = outputPath(name.str());
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n" << width << ' ' << height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        if (!file) {
+            std::cerr << "Benchmark: cannot write " << path << std::endl;
+            return;
+        }
+        if (!frames.empty() && frames.back().frameNumber == frameNumber) {
+            frames.back().dumped = true;
+        }
+    }
+
+    bool BenchmarkRecorder::writeFrames(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "Benchmark: cannot write " << path << std::endl;
+            return false;
+        }
+        // cpu_ms is the main thread's wall time for the frame, fence waits included; gpu_ms is empty when the
+        // device has no timestamps. record_ms is the part spent recording command buffers, draws the batch draws
+        // recorded. light_ms is LightSystem::updateFrameContext, shadow_views the shadow views it emitted. Frames with
+        // an image dump waited for the device and are flagged.
+        file << "frame,time_s,cpu_ms,gpu_ms,record_ms,draws,light_ms,shadow_views,dumped\n";
+        file << std::fixed << std::setprecision(4);
+        for (const FrameSample& frame : frames) {
+            file << frame.frameNumber - settings.warmupFrames << ',' << frame.time << ',' << frame.cpuMs << ',';
+            auto gpu = gpuFrameMs.find(frame.frameNumber);
+            if (gpu != gpuFrameMs.end()) {
+                file << gpu->second;
+            }
+            file << ',' << frame.recordMs << ',' << frame.batchDraws << ',' << frame.lightUpdateMs << ','
+                 << frame.shadowViews << ',' << (frame.dumped ? 1 : 0) << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool BenchmarkRecorder::writeScopes(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "Benchmark: cannot write " << path << std::endl;
+            return false;
+        }
+        file << "frame,scope,depth,ms\n";
+        file << std::fixed << std::setprecision(4);
+        for (const ScopeSample& scope : scopes) {
+            file << scope.frameNumber - settings.warmupFrames << ',' << scope.label << ',' << scope.depth << ',' << scope.ms << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool BenchmarkRecorder::writeSummary(const std::string& path, const std::string& deviceName, uint32_t recordingThreads) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "Benchmark: cannot write " << path << std::endl;
+            return false;
+        }
+
+        std::vector<double> cpuMs;
+        std::vector<double> gpuMs;
+        std::vector<double> recordMs;
+        std::vector<double> recordUsPerDraw;
+        std::vector<double> lightUpdateMs;
+        for (const FrameSample& frame : frames) {
+            cpuMs.push_back(frame.cpuMs);
+            recordMs.push_back(frame.recordMs);
+            lightUpdateMs.push_back(frame.lightUpdateMs);
+            if (frame.batchDraws > 0) {
+                recordUsPerDraw.push_back(frame.recordMs * 1000.0 / frame.batchDraws);
+            }
+            auto gpu = gpuFrameMs.find(frame.frameNumber);
+            if (gpu != gpuFrameMs.end()) {
+                gpuMs.push_back(gpu->second);
+            }
+        }
+
+        // Per pass in order of first appearance, like GpuProfiler::summarize
+        std::vector<std::pair<std::string, uint32_t>> passes;
+        std::map<std::string, std::vector<double>> passSamples;
+        for (const ScopeSample& scope : scopes) {
+            auto [it, inserted] = passSamples.try_emplace(scope.label);
+            if (inserted) {
+                passes.emplace_back(scope.label, scope.depth);
+            }
+            it->second.push_back(scope.ms);
+        }
+
+        file << std::fixed << std::setprecision(4);
+        file << "{\n";
+        file << "  \"device\": \"" << escapeJson(deviceName) << "\",\n";
+        file << "  \"width\": " << settings.width << ",\n";
+        file << "  \"height\": " << settings.height << ",\n";
+        file << "  \"frames\": " << frames.size() << ",\n";
+        file << "  \"warmup_frames\": " << settings.warmupFrames << ",\n";
+        file << "  \"timestep\": " << std::setprecision(6) << settings.timestep << std::setprecision(4) << ",\n";
+        file << "  \"scene\": \"" << escapeJson(settings.scenePath) << "\",\n";
+        file << "  \"camera_path\": \"" << escapeJson(settings.cameraPath) << "\",\n";
+        file << "  \"cpu_ms\": ";
+        writeStatistics(file, computeStatistics(cpuMs));
+        file << ",\n  \"gpu_ms\": ";
+        if (gpuMs.empty()) {
+            file << "null";     // no timestamp support
+        } else {
+            writeStatistics(file, computeStatistics(gpuMs));
+        }
+        file << ",\n  \"recording_threads\": " << recordingThreads;
+        file << ",\n  \"frames_in_flight\": " << settings.framesInFlight;
+        file << ",\n  \"record_ms\": ";
+        writeStatistics(file, computeStatistics(recordMs));
+        file << ",\n  \"record_us_per_draw\": ";
+        writeStatistics(file, computeStatistics(recordUsPerDraw));
+        file << ",\n  \"light_ms\": ";
+        writeStatistics(file, computeStatistics(lightUpdateMs));
+        file << ",\n  \"passes\": [";
+        for (size_t i = 0; i < passes.size(); ++i) {
+            file << (i == 0 ? "\n" : ",\n");
+            file << "    {\"name\": \"" << escapeJson(passes[i].first) << "\", \"depth\": " << passes[i].second << ", \"ms\": ";
+            writeStatistics(file, computeStatistics(passSamples[passes[i].first]));
+            file << "}";
+        }
+        file << "\n  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    bool BenchmarkRecorder::finish(const std::string& deviceName, uint32_t recordingThreads) const {
+        bool written = writeFrames(outputPath("frames.csv"));
+        written = writeScopes(outputPath("gpu_scopes.csv")) && written;
+        written = writeSummary(outputPath("summary.json"), deviceName, recordingThreads) && written;
+#if CPU_PROFILER_ENABLED
+        // Fails only when no zone was recorded, which does not invalidate the timings
+        CpuProfiler::getInstance().exportChromeTrace(outputPath("cpu_trace.json"));
+#endif
+        std::cout << "Benchmark: " << frames.size() << " frames written to " << settings.outputDirectory << std::endl;
+        return written;
+    }
+
+} // namespace Engine
@@ -0,0 +1,130 @@
+#pragma once
+
+// Headless benchmark runs: command line settings, the camera path they replay and the per-frame results they write.
+// A run renders offscreen at a fixed timestep, so the same path, scene and build always produce the same frames.
+
+#include "core.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering {
+    class GpuProfiler;
+}
+
+namespace Engine {
+
+    constexpr uint32_t BENCHMARK_DEFAULT_FRAMES = 600;          // measured frames when there is no camera path
+    constexpr uint32_t BENCHMARK_DEFAULT_WARMUP_FRAMES = 60;    // rendered at the first key, not measured
+    constexpr float BENCHMARK_DEFAULT_TIMESTEP = 1.0f / 60.0f;
+    constexpr const char* BENCHMARK_DEFAULT_OUTPUT_DIRECTORY = "Benchmark";
+    constexpr const char* DEFAULT_SCENE_PATH = "Assets/Scene/Scene.json";
+
+    struct BenchmarkSettings {
+        bool headless = false;
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        uint32_t frameCount = 0;            // 0: the camera path's duration, BENCHMARK_DEFAULT_FRAMES without one
+        uint32_t warmupFrames = BENCHMARK_DEFAULT_WARMUP_FRAMES;
+        float timestep = BENCHMARK_DEFAULT_TIMESTEP;
+        std::string scenePath = DEFAULT_SCENE_PATH;    // windowed runs load it too
+        std::string cameraPath;             // replayed by headless runs; the scene camera stays put without one
+        std::string outputDirectory = BENCHMARK_DEFAULT_OUTPUT_DIRECTORY;
+        uint32_t dumpInterval = 0;          // every n-th measured frame is written as a PPM, 0 writes none
+        // Streaming decodes on a worker thread, so which mips are resident depends on timing; headless runs
+        // upload full mip chains unless this is set
+        bool textureStreaming = false;
+        std::string recordCameraPath;       // windowed runs write the flown camera path here on exit
+        // Threads recording shadow views and opaque batches: 1 records inline, 0 picks hardware_concurrency - 1.
+        // Runs with different counts compare recording time against the draws per frame
+        uint32_t recordingThreads = 0;
+        // 1..MAX_FRAMES_IN_FLIGHT; fewer trades throughput for latency
+        uint32_t framesInFlight = Rendering::DEFAULT_FRAMES_IN_FLIGHT;
+
+        // Throws std::runtime_error on an unknown argument or a missing or malformed value
+        static BenchmarkSettings parse(int argc, char** argv);
+    };
+
+    // Camera keys over time, sampled with position lerp and rotation slerp. The text format is one key per line,
+    // "time px py pz qw qx qy qz", with '#' comments; keys are in increasing time.
+    class CameraPath {
+    public:
+        struct Key {
+            float time;
+            glm::vec3 position;
+            glm::quat rotation;
+        };
+
+        // Both throw std::runtime_error when the file cannot be read or written or a line is malformed
+        void load(const std::string& path);
+        void save(const std::string& path) const;
+
+        // Ignored unless time is past the last key
+        void addKey(float time, const glm::vec3& position, const glm::quat& rotation);
+        // Clamped to the first and last key
+        void sample(float time, glm::vec3& position, glm::quat& rotation) const;
+
+        bool empty() const { return keys.empty(); }
+        float getDuration() const { return keys.empty() ? 0.0f : keys.back().time - keys.front().time; }
+
+    private:
+        std::vector<Key> keys;
+    };
+
+    // Collects the measured frames of a headless run and writes them into the output directory:
+    // frames.csv (per frame CPU, GPU, command recording and light update time, batch draws, shadow views),
+    // gpu_scopes.csv (per frame and pass),
+    // summary.json (percentiles over the run, per pass means), cpu_trace.json when the CPU profiler is compiled in,
+    // and frame_NNNNN.ppm dumps.
+    class BenchmarkRecorder {
+    public:
+        // Creates the output directory; throws std::runtime_error when it cannot
+        explicit BenchmarkRecorder(const BenchmarkSettings& settings);
+
+        // frameNumber counts every rendered frame, warm-up included, and matches the GPU profiler's
+        // recordMs, batchDraws, lightUpdateMs and shadowViews are the renderer's recording stats of the frame
+        void recordFrame(uint64_t frameNumber, float time, double cpuMs, double recordMs, uint32_t batchDraws,
+                         double lightUpdateMs, uint32_t shadowViews);
+        // Takes the profiler frames not seen yet; call after every frame and once more after GpuProfiler::flush
+        void collectGpuTimings(const Rendering::GpuProfiler& profiler);
+        // rgb is tightly packed, as Renderer::captureLastFrame returns it
+        void writeImage(uint64_t frameNumber, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb);
+
+        // Writes the CSVs, the summary and the CPU trace; returns false if any of them failed
+        bool finish(const std::string& deviceName, uint32_t recordingThreads) const;
+
+    private:
+        struct FrameSample {
+            uint64_t frameNumber;
+            float time;
+            double cpuMs;
+            double recordMs;
+            uint32_t batchDraws;
+            double lightUpdateMs;
+            uint32_t shadowViews;
+            bool dumped;
+        };
+
+        struct ScopeSample {
+            uint64_t frameNumber;
+            std::string label;
+            uint32_t depth;
+            float ms;
+        };
+
+        bool writeFrames(const std::string& path) const;
+        bool writeScopes(const std::string& path) const;
+        bool writeSummary(const std::string& path, const std::string& deviceName, uint32_t recordingThreads) const;
+        std::string outputPath(const std::string& name) const;
+
+        BenchmarkSettings settings;
+        std::vector<FrameSample> frames;
+        std::vector<ScopeSample> scopes;
+        std::unordered_map<uint64_t, float> gpuFrameMs;
+        uint64_t nextGpuFrame = 0;
+    };
+
+} // namespace Engine
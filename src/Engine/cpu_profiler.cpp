@@ -0,0 +1,227 @@
+#include "cpu_profiler.hpp"
+
+#if CPU_PROFILER_ENABLED
+
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace Engine {
+
+    namespace {
+        constexpr uint64_t RING_MASK = CPU_PROFILER_EVENTS_PER_THREAD - 1;
+        static_assert((CPU_PROFILER_EVENTS_PER_THREAD & RING_MASK) == 0, "CPU_PROFILER_EVENTS_PER_THREAD must be a power of two");
+
+        void writeJsonString(std::ostream& out, const std::string& text) {
+            out << '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out << '\\';
+                }
+                out << c;
+            }
+            out << '"';
+        }
+    }
+
+    CpuProfiler::ThreadState::~ThreadState() {
+        if (buffer) {
+            CpuProfiler::getInstance().releaseBuffer(buffer);
+        }
+    }
+
+    CpuProfiler::ThreadState& CpuProfiler::threadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    CpuProfiler::ThreadBuffer& CpuProfiler::acquireBuffer() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& buffer : buffers) {
+            if (!buffer->inUse) {
+                buffer->inUse = true;
+                buffer->firstIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+                buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+                return *buffer;
+            }
+        }
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->threadId = static_cast<uint32_t>(buffers.size());
+        buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+        buffer->inUse = true;
+        buffers.push_back(std::move(buffer));
+        return *buffers.back();
+    }
+
+    void CpuProfiler::releaseBuffer(ThreadBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->inUse = false;
+    }
+
+    void CpuProfiler::setThreadName(const std::string& name) {
+        ThreadState& state = threadState();
+        if (!state.buffer) {
+            state.buffer = &acquireBuffer();
+        }
+        std::lock_guard<std::mutex> lock(registryMutex);
+        state.buffer->threadName = name;
+    }
+
+    uint32_t CpuProfiler::enterZone() {
+        ThreadState& state = threadState();
+        if (!state.buffer) {
+            state.buffer = &acquireBuffer();
+        }
+        return state.depth++;
+    }
+
+    void CpuProfiler::leaveZone(const char* name, uint64_t startNs, uint32_t depth) {
+        const uint64_t endNs = now();
+        ThreadState& state = threadState();
+        state.depth = depth;
+        ThreadBuffer& buffer = *state.buffer;
+        // Only this thread writes the index; the release publishes the zone to readers
+        const uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+        buffer.zones[index & RING_MASK] = {name, startNs, endNs, depth};
+        buffer.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    void CpuProfiler::markFrame() {
+        frameStarts[frameCount % CPU_PROFILER_FRAME_HISTORY] = now();
+        frameCount++;
+    }
+
+    bool CpuProfiler::getLastFrame(uint64_t& startNs, uint64_t& endNs) const {
+        if (frameCount < 2) {
+            return false;
+        }
+        startNs = frameStarts[(frameCount - 2) % CPU_PROFILER_FRAME_HISTORY];
+        endNs = frameStarts[(frameCount - 1) % CPU_PROFILER_FRAME_HISTORY];
+        return true;
+    }
+
+    void CpuProfiler::copyZones(const ThreadBuffer& buffer, uint64_t minEndNs, std::vector<Zone>& zones) const {
+        const uint64_t end = buffer.writeIndex.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(buffer.firstIndex, end > CPU_PROFILER_EVENTS_PER_THREAD ? end - CPU_PROFILER_EVENTS_PER_THREAD : 0);
+
+        // Zones are written in end order, so the walk back stops at the first one ending before minEndNs
+        const size_t firstCopied = zones.size();
+        uint64_t index = end;
+        while (index > begin) {
+            const Zone& zone = buffer.zones[(index - 1) & RING_MASK];
+            if (zone.endNs < minEndNs) {
+                break;
+            }
+            zones.push_back(zone);
+            index--;
+        }
+
+        // The owner kept writing meanwhile: anything it may have wrapped over is dropped (the oldest copies)
+        const uint64_t written = buffer.writeIndex.load(std::memory_order_acquire);
+        if (written > CPU_PROFILER_EVENTS_PER_THREAD) {
+            const uint64_t firstIntact = written - CPU_PROFILER_EVENTS_PER_THREAD + 1;
+            while (zones.size() > firstCopied && index < firstIntact) {
+                zones.pop_back();
+                index++;
+            }
+        }
+        std::reverse(zones.begin() + firstCopied, zones.end());
+    }
+
+    std::vector<CpuProfiler::ThreadZones> CpuProfiler::collect(uint64_t startNs, uint64_t endNs) const {
+        std::vector<ThreadZones> threads;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : buffers) {
+            ThreadZones thread{buffer->threadId, buffer->threadName, {}};
+            copyZones(*buffer, startNs, thread.zones);
+            thread.zones.erase(std::remove_if(thread.zones.begin(), thread.zones.end(),
+                                              [endNs](const Zone& zone) { return zone.startNs >= endNs; }),
+                               thread.zones.end());
+            if (!thread.zones.empty()) {
+                threads.push_back(std::move(thread));
+            }
+        }
+        return threads;
+    }
+
+    bool CpuProfiler::exportChromeTrace(const std::string& path) const {
+        std::vector<ThreadZones> threads;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (const auto& buffer : buffers) {
+                ThreadZones thread{buffer->threadId, buffer->threadName, {}};
+                copyZones(*buffer, 0, thread.zones);
+                threads.push_back(std::move(thread));
+            }
+        }
+
+        uint64_t originNs = UINT64_MAX;
+        for (const ThreadZones& thread : threads) {
+            for (const Zone& zone : thread.zones) {
+                originNs = std::min(originNs, zone.startNs);
+            }
+        }
+        if (originNs == UINT64_MAX) {
+            return false;
+        }
+
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "CPU profiler: cannot write " << path << std::endl;
+            return false;
+        }
+        // trace_event timestamps are microseconds; three decimals keep the nanoseconds
+        auto micros = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"AlphaRenderer\"}}";
+        for (const ThreadZones& thread : threads) {
+            file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.threadId << ",\"args\":{\"name\":";
+            writeJsonString(file, thread.threadName);
+            file << "}}";
+            for (const Zone& zone : thread.zones) {
+                file << ",\n{\"name\":";
+                writeJsonString(file, zone.name);
+                file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.threadId
+                     << ",\"ts\":" << micros(zone.startNs - originNs) << ",\"dur\":" << micros(zone.endNs - zone.startNs) << "}";
+            }
+        }
+        const uint64_t frameHistory = std::min<uint64_t>(frameCount, CPU_PROFILER_FRAME_HISTORY);
+        for (uint64_t frame = frameCount - frameHistory; frame < frameCount; frame++) {
+            const uint64_t frameStart = frameStarts[frame % CPU_PROFILER_FRAME_HISTORY];
+            if (frameStart < originNs) {
+                continue;
+            }
+            file << ",\n{\"name\":\"Frame " << frame << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+                 << micros(frameStart - originNs) << "}";
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+    std::string CpuProfiler::exportCapture() const {
+        std::error_code error;
+        std::filesystem::create_directories(CPU_PROFILER_EXPORT_DIRECTORY, error);
+        if (error) {
+            std::cerr << "CPU profiler: cannot create " << CPU_PROFILER_EXPORT_DIRECTORY << ": " << error.message() << std::endl;
+            return {};
+        }
+
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::ostringstream name;
+        name << "cpu_trace_" << std::put_time(std::localtime(&now), "%Y%m%d_%H%M%S") << ".json";
+        const std::string path = (std::filesystem::path(CPU_PROFILER_EXPORT_DIRECTORY) / name.str()).string();
+        if (!exportChromeTrace(path)) {
+            return {};
+        }
+        std::cout << "CPU profiler: wrote " << path << std::endl;
+        return path;
+    }
+
+} // namespace Engine
+
+#endif
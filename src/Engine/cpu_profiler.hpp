@@ -0,0 +1,143 @@
+#pragma once
+
+// Scoped CPU zones: CPU_PROFILE_ZONE("name") times the rest of the enclosing block on whatever thread runs it.
+// Builds with CPU_PROFILER_ENABLED=0 (CMake option ALPHA_CPU_PROFILER) compile every macro to nothing.
+#ifndef CPU_PROFILER_ENABLED
+#define CPU_PROFILER_ENABLED 1
+#endif
+
+#if CPU_PROFILER_ENABLED
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Engine {
+
+    // Zones per thread kept for the flame view and the trace export; a power of two
+    constexpr uint32_t CPU_PROFILER_EVENTS_PER_THREAD = 1u << 15;
+    constexpr uint32_t CPU_PROFILER_FRAME_HISTORY = 128;
+    constexpr bool CPU_PROFILER_EXPORT_ON_EXIT = false;    // writes a trace when the engine shuts down
+    constexpr const char* CPU_PROFILER_EXPORT_DIRECTORY = "Profiles";
+
+    // Collects the zones of every thread. Each thread appends to its own ring buffer without locks or atomics
+    // beyond its write index; readers (the overlay, the exporter) copy a ring and drop what was overwritten while
+    // they copied. The registry mutex is only taken when a thread records its first zone, is named or exits, and
+    // by readers. Rings of exited threads are reused by new ones.
+    class CpuProfiler {
+    public:
+        struct Zone {
+            const char* name;       // string literal given to the zone
+            uint64_t startNs;       // since the profiler's epoch
+            uint64_t endNs;
+            uint32_t depth;         // nesting on its thread
+        };
+
+        struct ThreadZones {
+            uint32_t threadId;      // stable per ring, used as the trace tid
+            std::string threadName;
+            std::vector<Zone> zones;    // in end order
+        };
+
+        static CpuProfiler& getInstance() {
+            static CpuProfiler instance{};
+            return instance;
+        }
+
+        CpuProfiler(const CpuProfiler&) = delete;
+        CpuProfiler& operator=(const CpuProfiler&) = delete;
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Shown in the overlay and the trace instead of the thread id
+        void setThreadName(const std::string& name);
+
+        // Main thread, once per frame before anything of the frame is recorded
+        void markFrame();
+        // The last frame that has ended; false before the second markFrame
+        bool getLastFrame(uint64_t& startNs, uint64_t& endNs) const;
+
+        // Zones of every thread that overlap [startNs, endNs)
+        std::vector<ThreadZones> collect(uint64_t startNs, uint64_t endNs) const;
+
+        // Chrome trace_event JSON of everything still buffered, with the frame starts as instant events; opens in
+        // chrome://tracing or Perfetto
+        bool exportChromeTrace(const std::string& path) const;
+        // Into CPU_PROFILER_EXPORT_DIRECTORY under a timestamped name; returns the path, empty on failure
+        std::string exportCapture() const;
+
+        // Used by CpuProfileZone
+        uint32_t enterZone();
+        void leaveZone(const char* name, uint64_t startNs, uint32_t depth);
+
+    private:
+        struct ThreadBuffer {
+            std::unique_ptr<Zone[]> zones{new Zone[CPU_PROFILER_EVENTS_PER_THREAD]};
+            std::atomic<uint64_t> writeIndex{0};
+            // Set under the registry mutex: zones before firstIndex belong to a previous owner of the ring
+            uint64_t firstIndex = 0;
+            uint32_t threadId = 0;
+            std::string threadName;
+            bool inUse = false;
+        };
+
+        // Per-thread handle; its destructor returns the ring when the thread exits
+        struct ThreadState {
+            ThreadBuffer* buffer = nullptr;
+            uint32_t depth = 0;
+            ~ThreadState();
+        };
+
+        CpuProfiler() = default;
+
+        ThreadBuffer& acquireBuffer();
+        void releaseBuffer(ThreadBuffer* buffer);
+        static ThreadState& threadState();
+        // Copies buffer's zones ending at or after minEndNs, oldest first; the registry mutex must be held
+        void copyZones(const ThreadBuffer& buffer, uint64_t minEndNs, std::vector<Zone>& zones) const;
+
+        mutable std::mutex registryMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+        std::array<uint64_t, CPU_PROFILER_FRAME_HISTORY> frameStarts{};
+        uint64_t frameCount = 0;
+    };
+
+    class CpuProfileZone {
+    public:
+        explicit CpuProfileZone(const char* name)
+            : name{name}, depth{CpuProfiler::getInstance().enterZone()}, startNs{CpuProfiler::now()} {}
+        ~CpuProfileZone() { CpuProfiler::getInstance().leaveZone(name, startNs, depth); }
+
+        CpuProfileZone(const CpuProfileZone&) = delete;
+        CpuProfileZone& operator=(const CpuProfileZone&) = delete;
+
+    private:
+        const char* name;
+        uint32_t depth;
+        uint64_t startNs;
+    };
+
+} // namespace Engine
+
+#define CPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILE_CONCAT(a, b) CPU_PROFILE_CONCAT_INNER(a, b)
+#define CPU_PROFILE_ZONE(name) ::Engine::CpuProfileZone CPU_PROFILE_CONCAT(cpuProfileZone, __LINE__)(name)
+#define CPU_PROFILE_THREAD(name) ::Engine::CpuProfiler::getInstance().setThreadName(name)
+#define CPU_PROFILE_FRAME() ::Engine::CpuProfiler::getInstance().markFrame()
+
+#else
+
+#define CPU_PROFILE_ZONE(name) ((void)0)
+#define CPU_PROFILE_THREAD(name) ((void)0)
+#define CPU_PROFILE_FRAME() ((void)0)
+
+#endif
@@ -81,6 +81,9 @@ public:
     ~Octree() = default;
 
     OctreeObject* createObject(T* data, const AABB& bounds);
+    // data[i] with bounds[i]. A batch at least as large as the tree is built top-down together with what is already
+    // there, so loading a scene costs one pass instead of an insert each; smaller batches are inserted one by one
+    std::vector<OctreeObject*> createObjects(const std::vector<T*>& data, const std::vector<AABB>& bounds);
     void removeObject(OctreeObject* object);
     void updateObject(OctreeObject* object, const AABB& newBounds);
     
@@ -88,13 +91,22 @@ public:
     std::vector<T*> getIntersectingObjects(const AABB& bounds) const;
     
     void clear();
+    // Fits the world bounds to the objects and rebuilds the nodes top-down. Single inserts only ever split the root,
+    // so call this after a run of them
+    void rebuild();
 
     // Make these public so Node can access them
     bool shouldSubdivide(const Node* node) const;
+    bool shouldSubdivide(const Node* node, size_t objectCount) const;
     int getOctant(const AABB& objectBounds, const AABB& nodeBounds) const;
     bool intersects(const AABB& a, const AABB& b) const;
 
 private:
+    // Enlarges the world bounds to contain bounds and reinserts every object
+    void grow(const AABB& bounds);
+    // Places objects in node, or splits them among its children while there are too many for one node
+    void buildNode(Node* node, std::vector<OctreeObject*>& objects);
+
     Settings settings;
     AABB worldBounds;
     std::unique_ptr<Node> root;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <limits>
 
 
 template <typename T>
@@ -161,11 +162,102 @@ typename Octree<T>::OctreeObject* Octree<T>::createObject(T* data, const AABB& b
         if (shouldSubdivide(root.get())) {
             root->subdivide();
         }
+    } else {
+        // Outside the world bounds, which were sized for whatever existed when the tree was built
+        grow(bounds);
     }
     
     return obj;
 }
 
+template <typename T>
+std::vector<typename Octree<T>::OctreeObject*> Octree<T>::createObjects(const std::vector<T*>& data, const std::vector<AABB>& bounds) {
+    std::vector<OctreeObject*> created;
+    created.reserve(data.size());
+    if (data.size() < objectPool.size()) {
+        for (size_t i = 0; i < data.size(); i++) {
+            created.push_back(createObject(data[i], bounds[i]));
+        }
+        return created;
+    }
+
+    objectPool.reserve(objectPool.size() + data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        objectPool.push_back(std::make_unique<OctreeObject>(data[i], bounds[i]));
+        created.push_back(objectPool.back().get());
+    }
+    rebuild();
+    return created;
+}
+
+template <typename T>
+void Octree<T>::rebuild() {
+    if (objectPool.empty()) {
+        return;
+    }
+
+    glm::vec3 minPoint(std::numeric_limits<float>::max());
+    glm::vec3 maxPoint(std::numeric_limits<float>::lowest());
+    std::vector<OctreeObject*> objects;
+    objects.reserve(objectPool.size());
+    for (const auto& object : objectPool) {
+        minPoint = glm::min(minPoint, object->bounds.center - object->bounds.extents);
+        maxPoint = glm::max(maxPoint, object->bounds.center + object->bounds.extents);
+        object->currentNode = nullptr;
+        objects.push_back(object.get());
+    }
+
+    // Same padding as grow(), and never smaller than a node may be
+    glm::vec3 extents = glm::max((maxPoint - minPoint) * 0.5f * 1.5f, glm::vec3(settings.minNodeSize));
+    worldBounds = AABB((minPoint + maxPoint) * 0.5f, extents);
+    root = std::make_unique<Node>(this, worldBounds, 0);
+    buildNode(root.get(), objects);
+}
+
+template <typename T>
+void Octree<T>::buildNode(Node* node, std::vector<OctreeObject*>& objects) {
+    if (!shouldSubdivide(node, objects.size())) {
+        node->objects = std::move(objects);
+        for (OctreeObject* object : node->objects) {
+            object->currentNode = node;
+        }
+        return;
+    }
+
+    // Same placement rule as insert(): an object goes down only if it fits one octant
+    node->subdivide();
+    std::array<std::vector<OctreeObject*>, 8> childObjects;
+    for (OctreeObject* object : objects) {
+        int octant = getOctant(object->bounds, node->bounds);
+        if (octant != -1 && intersects(node->children[octant]->bounds, object->bounds)) {
+            childObjects[octant].push_back(object);
+        } else {
+            node->objects.push_back(object);
+            object->currentNode = node;
+        }
+    }
+    std::vector<OctreeObject*>().swap(objects);
+
+    for (int i = 0; i < 8; ++i) {
+        buildNode(node->children[i].get(), childObjects[i]);
+    }
+}
+
+template <typename T>
+void Octree<T>::grow(const AABB& bounds) {
+    AABB combined = AABB::combineAABBs(worldBounds, bounds);
+    // Padded like the scene bounds so a stream of objects along one direction does not rebuild every time
+    worldBounds = AABB(combined.center, combined.extents * 1.5f);
+    root = std::make_unique<Node>(this, worldBounds, 0);
+    for (const auto& object : objectPool) {
+        object->currentNode = nullptr;
+        root->insert(object.get());
+    }
+    if (shouldSubdivide(root.get())) {
+        root->subdivide();
+    }
+}
+
 template <typename T>
 void Octree<T>::removeObject(typename Octree<T>::OctreeObject* object) {
     if (object->currentNode) {
@@ -243,7 +335,12 @@ void Octree<T>::clear() {
 
 template <typename T>
 bool Octree<T>::shouldSubdivide(const Node* node) const {
-    return node->objects.size() > settings.maxObjectsPerNode &&
+    return shouldSubdivide(node, node->objects.size());
+}
+
+template <typename T>
+bool Octree<T>::shouldSubdivide(const Node* node, size_t objectCount) const {
+    return objectCount > settings.maxObjectsPerNode &&
            node->depth < settings.maxDepth &&
            node->bounds.extents.x > settings.minNodeSize &&
            node->bounds.extents.y > settings.minNodeSize &&
@@ -0,0 +1,147 @@
+#include "async_compute.hpp"
+
+#include <stdexcept>
+
+namespace Rendering {
+
+    static VkSemaphore createTimelineSemaphore(Device& device) {
+        VkSemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &timelineInfo;
+        VkSemaphore semaphore;
+        if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create async compute timeline semaphore!");
+        }
+        return semaphore;
+    }
+
+    AsyncCompute::AsyncCompute(Device& device) : device{device} {
+        if (!device.hasAsyncComputeQueue() || !device.supportsTimelineSemaphores()) {
+            throw std::runtime_error("AsyncCompute requires a second queue and timeline semaphores!");
+        }
+        graphicsTimeline = createTimelineSemaphore(device);
+        computeTimeline = createTimelineSemaphore(device);
+
+        // The compute queue is of the graphics family, so the device's pool serves both
+        std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT * 3> allocated{};
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = device.getCommandPool();
+        allocInfo.commandBufferCount = static_cast<uint32_t>(allocated.size());
+        if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, allocated.data()) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate async compute command buffers!");
+        }
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+            commandBuffers[i].compute = allocated[i * 3 + 0];
+            commandBuffers[i].parallel = allocated[i * 3 + 1];
+            commandBuffers[i].join = allocated[i * 3 + 2];
+        }
+    }
+
+    AsyncCompute::~AsyncCompute() {
+        vkDeviceWaitIdle(device.getDevice());
+        for (RenderGraph::QueueCommandBuffers& frame : commandBuffers) {
+            VkCommandBuffer buffers[] = {frame.compute, frame.parallel, frame.join};
+            vkFreeCommandBuffers(device.getDevice(), device.getCommandPool(), 3, buffers);
+        }
+        vkDestroySemaphore(device.getDevice(), computeTimeline, nullptr);
+        vkDestroySemaphore(device.getDevice(), graphicsTimeline, nullptr);
+    }
+
+    const RenderGraph::QueueCommandBuffers& AsyncCompute::begin(size_t frameSlot) {
+        currentSlot = frameSlot;
+        const RenderGraph::QueueCommandBuffers& frame = commandBuffers[frameSlot];
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        for (VkCommandBuffer commandBuffer : {frame.compute, frame.parallel, frame.join}) {
+            if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+                throw std::runtime_error("failed to begin async compute command buffer!");
+            }
+        }
+        return frame;
+    }
+
+    SwapChain::SemaphoreWait AsyncCompute::submit(VkCommandBuffer prologue) {
+        const RenderGraph::QueueCommandBuffers& frame = commandBuffers[currentSlot];
+        for (VkCommandBuffer commandBuffer : {prologue, frame.compute, frame.parallel}) {
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("failed to record async compute command buffer!");
+            }
+        }
+
+        const uint64_t frameNumber = ++submittedFrames;
+        // Graphics first: the compute batch waits on a value only the prologue signals
+        submitGraphics(prologue, frame.parallel, frameNumber);
+        submitCompute(frame.compute, frameNumber);
+
+        // Composition is the first consumer of the GI; everything before its fragment shaders runs ahead
+        return {computeTimeline, frameNumber, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+    }
+
+    void AsyncCompute::submitGraphics(VkCommandBuffer prologue, VkCommandBuffer parallel, uint64_t frame) {
+        // The first frame has no previous compute work to wait for
+        const uint64_t previousFrame = frame - 1;
+        const VkPipelineStageFlags historyWaitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        VkTimelineSemaphoreSubmitInfo prologueTimeline{};
+        prologueTimeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        prologueTimeline.waitSemaphoreValueCount = previousFrame > 0 ? 1 : 0;
+        prologueTimeline.pWaitSemaphoreValues = &previousFrame;
+        prologueTimeline.signalSemaphoreValueCount = 1;
+        prologueTimeline.pSignalSemaphoreValues = &frame;
+
+        std::array<VkSubmitInfo, 2> submitInfos{};
+        submitInfos[0].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfos[0].pNext = &prologueTimeline;
+        submitInfos[0].waitSemaphoreCount = previousFrame > 0 ? 1 : 0;
+        submitInfos[0].pWaitSemaphores = &computeTimeline;
+        submitInfos[0].pWaitDstStageMask = &historyWaitStage;
+        submitInfos[0].commandBufferCount = 1;
+        submitInfos[0].pCommandBuffers = &prologue;
+        submitInfos[0].signalSemaphoreCount = 1;
+        submitInfos[0].pSignalSemaphores = &graphicsTimeline;
+
+        submitInfos[1].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfos[1].commandBufferCount = 1;
+        submitInfos[1].pCommandBuffers = &parallel;
+
+        std::lock_guard<std::mutex> lock(device.getGraphicsQueueMutex());
+        if (vkQueueSubmit(device.getGraphicsQueue(), static_cast<uint32_t>(submitInfos.size()), submitInfos.data(),
+                          VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit graphics command buffers!");
+        }
+    }
+
+    void AsyncCompute::submitCompute(VkCommandBuffer compute, uint64_t frame) {
+        const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &frame;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &frame;
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &graphicsTimeline;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &compute;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &computeTimeline;
+
+        std::lock_guard<std::mutex> lock(device.getComputeQueueMutex());
+        if (vkQueueSubmit(device.getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit async compute command buffer!");
+        }
+    }
+}
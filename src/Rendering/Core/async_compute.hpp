@@ -0,0 +1,47 @@
+#pragma once
+
+#include "device.hpp"
+#include "render_graph.hpp"
+#include "swapchain.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace Rendering {
+
+    // Submits the render graph's async compute pass on the device's compute queue. Frame n becomes four batches:
+    //   prologue  (graphics, passes before the async one)    signals graphicsTimeline = n
+    //   compute   (compute queue, the async pass)             waits graphicsTimeline >= n, signals computeTimeline = n
+    //   parallel  (graphics, passes not depending on it)
+    //   join      (graphics, submitted by the swapchain)      waits computeTimeline >= n
+    // The previous frame's compute work reads this frame's G-buffer positions as history, so the prologue waits for
+    // it before writing color attachments; shadow rendering, which writes none, overlaps it. Anything older is
+    // covered by the frame fence, which the join batch only signals once the compute work is done.
+    // Only used from the render thread.
+    class AsyncCompute {
+    public:
+        explicit AsyncCompute(Device& device);
+        ~AsyncCompute();
+
+        AsyncCompute(const AsyncCompute&) = delete;
+        AsyncCompute& operator=(const AsyncCompute&) = delete;
+
+        // Begins frameSlot's compute, parallel and join command buffers; the slot's fence must have been waited for
+        const RenderGraph::QueueCommandBuffers& begin(size_t frameSlot);
+        // Ends and submits the prologue, compute and parallel batches of the frame begun last. The join command
+        // buffer is ended by the caller and submitted with the returned wait
+        SwapChain::SemaphoreWait submit(VkCommandBuffer prologue);
+
+    private:
+        void submitGraphics(VkCommandBuffer prologue, VkCommandBuffer parallel, uint64_t frame);
+        void submitCompute(VkCommandBuffer compute, uint64_t frame);
+
+        Device& device;
+        VkSemaphore graphicsTimeline{VK_NULL_HANDLE};
+        VkSemaphore computeTimeline{VK_NULL_HANDLE};
+        std::array<RenderGraph::QueueCommandBuffers, MAX_FRAMES_IN_FLIGHT> commandBuffers{};
+        size_t currentSlot{0};
+        uint64_t submittedFrames{0};   // value both timelines reach once the last submitted frame is done
+    };
+}
@@ -36,7 +36,7 @@ namespace Rendering {
         VkBufferUsageFlags usageFlags,
         VkMemoryPropertyFlags memoryPropertyFlags,
         VkDeviceSize minOffsetAlignment)
-        : device{ device },        
+        : device{ &device },        
         instanceCount{ instanceCount },
         instanceSize{ instanceSize },
         usageFlags{ usageFlags },
@@ -46,10 +46,24 @@ namespace Rendering {
         device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
     }
 
+    Buffer::Buffer(VkDeviceSize instanceSize, uint32_t instanceCount, VkDeviceSize minOffsetAlignment)
+        : device{ nullptr },
+        instanceCount{ instanceCount },
+        instanceSize{ instanceSize },
+        usageFlags{ 0 },
+        memoryPropertyFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT } {
+        alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
+        bufferSize = alignmentSize * instanceCount;
+        hostMemory.resize(bufferSize);
+    }
+
     Buffer::~Buffer() {
         unmap();
-        vkDestroyBuffer(device.getDevice(), buffer, nullptr);
-        vkFreeMemory(device.getDevice(), memory, nullptr);
+        if (device == nullptr) {
+            return;
+        }
+        vkDestroyBuffer(device->getDevice(), buffer, nullptr);
+        vkFreeMemory(device->getDevice(), memory, nullptr);
     }
 
     /**
@@ -62,8 +76,12 @@ namespace Rendering {
      * @return VkResult of the buffer mapping call
      */
     VkResult Buffer::map(VkDeviceSize size, VkDeviceSize offset) {
+    if (device == nullptr) {
+        mapped = hostMemory.data() + offset;
+        return VK_SUCCESS;
+    }
     assert(buffer && memory && "Called map on buffer before create");
-    VkResult result = vkMapMemory(device.getDevice(), memory, offset, size, 0, &mapped);
+    VkResult result = vkMapMemory(device->getDevice(), memory, offset, size, 0, &mapped);
     if (result != VK_SUCCESS) {
         std::cerr << "Failed to map memory: VkResult = " << result << std::endl;
     }   
@@ -76,7 +94,9 @@ namespace Rendering {
      */
     void Buffer::unmap() {
         if (mapped) {
-            vkUnmapMemory(device.getDevice(), memory);
+            if (device != nullptr) {
+                vkUnmapMemory(device->getDevice(), memory);
+            }
             mapped = nullptr;
         }
     }
@@ -91,14 +111,8 @@ namespace Rendering {
      *
      */
     void Buffer::writeToBuffer(void* data, VkDeviceSize size, VkDeviceSize offset) {
-    assert(mapped && "Cannot copy to unmapped buffer");
-    if (size == VK_WHOLE_SIZE) {
-        memcpy(mapped, data, bufferSize);
-    } else {
-        char* memOffset = (char*)mapped;
-        memOffset += offset;
-        memcpy(memOffset, data, size);
-    }
+        // Same bounds check as the const overload
+        writeToBuffer(static_cast<const void*>(data), size, offset);
     }
 
    void Buffer::writeToBuffer(const void* data, VkDeviceSize size, VkDeviceSize offset) {
@@ -128,12 +142,15 @@ namespace Rendering {
      * @return VkResult of the flush call
      */
     VkResult Buffer::flush(VkDeviceSize size, VkDeviceSize offset) {
+        if (device == nullptr) {
+            return VK_SUCCESS;
+        }
         VkMappedMemoryRange mappedRange = {};
         mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
         mappedRange.memory = memory;
         mappedRange.offset = offset;
         mappedRange.size = size;
-        return vkFlushMappedMemoryRanges(device.getDevice(), 1, &mappedRange);
+        return vkFlushMappedMemoryRanges(device->getDevice(), 1, &mappedRange);
     }
 
     /**
@@ -148,12 +165,15 @@ namespace Rendering {
      * @return VkResult of the invalidate call
      */
     VkResult Buffer::invalidate(VkDeviceSize size, VkDeviceSize offset) {
+        if (device == nullptr) {
+            return VK_SUCCESS;
+        }
         VkMappedMemoryRange mappedRange = {};
         mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
         mappedRange.memory = memory;
         mappedRange.offset = offset;
         mappedRange.size = size;
-        return vkInvalidateMappedMemoryRanges(device.getDevice(), 1, &mappedRange);
+        return vkInvalidateMappedMemoryRanges(device->getDevice(), 1, &mappedRange);
     }
 
     /**
@@ -216,29 +236,34 @@ namespace Rendering {
     }
 
     /**
-     * Resize the buffer to accommodate a new instance count
+     * Resize the buffer to a new byte size
      * 
-     * @note This destroys the existing buffer and creates a new one.
-     * All previous data will be lost and the buffer will be unmapped.
+     * @note This replaces the existing buffer; the old one is released to the device's resource pool
+     * once no frame in flight uses it. All previous data will be lost and the buffer will be unmapped.
      * 
-     * @param newInstanceCount The new number of instances the buffer should hold
+     * @param newSize The new size of the buffer in bytes
      */
     void Buffer::resize(VkDeviceSize newSize) {
         // Unmap the buffer if it's currently mapped
         unmap();
-        
-        // Destroy the old buffer and free memory
-        if (buffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(device.getDevice(), buffer, nullptr);
-            buffer = VK_NULL_HANDLE;
-        }
-        if (memory != VK_NULL_HANDLE) {
-            vkFreeMemory(device.getDevice(), memory, nullptr);
-            memory = VK_NULL_HANDLE;
+
+        if (device == nullptr) {
+            bufferSize = newSize;
+            instanceCount = static_cast<uint32_t>(newSize / alignmentSize);
+            hostMemory.assign(bufferSize, 0);
+            return;
         }
-              
-        // Create new buffer with updated size
-        device.createBuffer(newSize, usageFlags, memoryPropertyFlags, buffer, memory);
+
+        // Frames in flight may still read the old buffer, so the pool only takes it back once they are done
+        ResourcePool& pool = device->getResourcePool();
+        pool.releaseBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
+        buffer = VK_NULL_HANDLE;
+        memory = VK_NULL_HANDLE;
+
+        // Create new buffer with updated size, reusing an idle one of the same size when there is one
+        bufferSize = newSize;
+        instanceCount = static_cast<uint32_t>(newSize / alignmentSize);
+        pool.acquireBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
     }
 
 }  // namespace lve
@@ -2,6 +2,8 @@
 
 #include "device.hpp"
 
+#include <vector>
+
 namespace Rendering {
 
     class Buffer {
@@ -13,6 +15,9 @@ namespace Rendering {
             VkBufferUsageFlags usageFlags,
             VkMemoryPropertyFlags memoryPropertyFlags,
             VkDeviceSize minOffsetAlignment = 1);
+        // Host memory only, no VkBuffer behind it: map hands out the allocation, flush and invalidate do nothing.
+        // For CPU-side tools that run the systems writing frame buffers without a device
+        Buffer(VkDeviceSize instanceSize, uint32_t instanceCount, VkDeviceSize minOffsetAlignment = 1);
         ~Buffer();
 
         Buffer(const Buffer&) = delete;
@@ -45,7 +50,8 @@ namespace Rendering {
     private:
         static VkDeviceSize getAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment);
 
-        Device& device;
+        Device* device;     // null for host memory buffers
+        std::vector<unsigned char> hostMemory;
         void* mapped = nullptr;
         VkBuffer buffer = VK_NULL_HANDLE;
         VkDeviceMemory memory = VK_NULL_HANDLE;
@@ -1,4 +1,5 @@
 #include "compute_pipeline.hpp"
+#include "Engine/cpu_profiler.hpp"
 #include <cassert>
 #include <fstream>
 #include <stdexcept>
@@ -11,10 +12,17 @@ ComputePipeline::ComputePipeline(
     const std::string& computeFilepath,
     const ComputePipelineConfigInfo& configInfo
 ) : device{device}, pipelineLayout{configInfo.pipelineLayout} {
-    createComputePipeline(computeFilepath, configInfo);
+    assert(configInfo.pipelineLayout != VK_NULL_HANDLE && 
+           "Cannot create compute pipeline: no pipelineLayout provided in configInfo");
+    creation = device.getPipelineCache().submit([this, computeFilepath, configInfo]() {
+        createComputePipeline(computeFilepath, configInfo);
+    });
 }
 
 ComputePipeline::~ComputePipeline() {
+    if (creation.valid()) {
+        creation.wait();
+    }
     if (computeShaderModule != VK_NULL_HANDLE) {
         vkDestroyShaderModule(device.getDevice(), computeShaderModule, nullptr);
     }
@@ -55,9 +63,7 @@ void ComputePipeline::createComputePipeline(
     const std::string& computeFilepath,
     const ComputePipelineConfigInfo& configInfo
 ) {
-    assert(configInfo.pipelineLayout != VK_NULL_HANDLE && 
-           "Cannot create compute pipeline: no pipelineLayout provided in configInfo");
-
+    CPU_PROFILE_ZONE("Create compute pipeline");
     // Load and create compute shader module
     auto computeCode = readFile(computeFilepath);
     createShaderModule(computeCode, &computeShaderModule);
@@ -75,18 +81,26 @@ void ComputePipeline::createComputePipeline(
     pipelineInfo.stage = computeShaderStageInfo;
     pipelineInfo.layout = configInfo.pipelineLayout;
 
-    if (vkCreateComputePipelines(device.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &computePipeline) != VK_SUCCESS) {
+    if (vkCreateComputePipelines(device.getDevice(), device.getPipelineCache().getCache(), 1, &pipelineInfo, nullptr, &computePipeline) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create compute pipeline");
     }
 }
 
+void ComputePipeline::waitUntilCreated() const {
+    std::call_once(created, [this]() {
+        if (creation.valid()) {
+            creation.get();
+        }
+    });
+}
+
 void ComputePipeline::dispatch(
     VkCommandBuffer commandBuffer, 
     uint32_t groupCountX, 
     uint32_t groupCountY, 
     uint32_t groupCountZ
 ) const {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, getPipeline());
     vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
 }
 
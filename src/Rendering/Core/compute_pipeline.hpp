@@ -1,5 +1,7 @@
 #pragma once
 #include "device.hpp"
+#include <future>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -22,7 +24,8 @@ public:
     ComputePipeline(const ComputePipeline&) = delete;
     ComputePipeline& operator=(const ComputePipeline&) = delete;
 
-    VkPipeline getPipeline() const { return computePipeline; }
+    // Created on the pipeline cache's workers like Pipeline; waits for the creation job the first time
+    VkPipeline getPipeline() const { waitUntilCreated(); return computePipeline; }
     VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
 
     // Dispatch helper
@@ -32,11 +35,14 @@ private:
     static std::vector<char> readFile(const std::string& filepath);
     void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
     void createComputePipeline(const std::string& computeFilepath, const ComputePipelineConfigInfo& configInfo);
+    void waitUntilCreated() const;
 
     Device& device;
     VkPipeline computePipeline{VK_NULL_HANDLE};
     VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
     VkShaderModule computeShaderModule{VK_NULL_HANDLE};
+    mutable std::future<void> creation;
+    mutable std::once_flag created;
 };
 
 } // namespace Rendering
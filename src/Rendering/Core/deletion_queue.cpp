@@ -0,0 +1,62 @@
+#include "deletion_queue.hpp"
+
+#include <utility>
+
+namespace Rendering {
+
+    void DeletionQueue::push(std::function<void()> release) {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_back({frameNumber, std::move(release)});
+    }
+
+    void DeletionQueue::endFrame() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++frameNumber;
+    }
+
+    void DeletionQueue::collect(uint64_t completedFrames) {
+        std::deque<Entry> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!entries.empty() && entries.front().frame < completedFrames) {
+                ready.push_back(std::move(entries.front()));
+                entries.pop_front();
+            }
+        }
+        run(ready);
+    }
+
+    void DeletionQueue::flush() {
+        // Releases can queue further ones (an object owning others), so drain until nothing is left
+        for (;;) {
+            std::deque<Entry> ready;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready.swap(entries);
+            }
+            if (ready.empty()) {
+                return;
+            }
+            run(ready);
+        }
+    }
+
+    uint64_t DeletionQueue::getFrameNumber() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frameNumber;
+    }
+
+    size_t DeletionQueue::pendingCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    void DeletionQueue::run(std::deque<Entry>& ready) {
+        for (Entry& entry : ready) {
+            entry.release();
+            entry.release = nullptr;    // captured owners are destroyed here too
+        }
+        ready.clear();
+    }
+
+} // namespace Rendering
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Rendering {
+
+    // Releases GPU objects once no submitted frame can still use them, instead of idling the device first.
+    // Each release is tagged with the number of the frame being recorded when it was queued; the renderer counts
+    // submitted frames and, after each acquire, collects everything older than the oldest frame still in flight.
+    // Thread-safe: loaders may queue releases while the render thread collects
+    class DeletionQueue {
+    public:
+        DeletionQueue() = default;
+        ~DeletionQueue() { flush(); }
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        // Runs release after the current frame and every frame submitted before it have finished
+        void push(std::function<void()> release);
+
+        // Destroys the object once no frame in flight can use it. The queue takes sole ownership
+        template <typename T>
+        void retire(std::unique_ptr<T> object) {
+            if (object) {
+                push([retired = std::shared_ptr<T>(std::move(object))]() mutable { retired.reset(); });
+            }
+        }
+
+        // Copies the handles; the caller resets its own array or vector
+        template <typename Container>
+        void retireFramebuffers(VkDevice device, const Container& framebuffers) {
+            std::vector<VkFramebuffer> retired(framebuffers.begin(), framebuffers.end());
+            push([device, retired = std::move(retired)]() {
+                for (VkFramebuffer framebuffer : retired) {
+                    if (framebuffer != VK_NULL_HANDLE) {
+                        vkDestroyFramebuffer(device, framebuffer, nullptr);
+                    }
+                }
+            });
+        }
+
+        // Called once per submitted frame, after its submission
+        void endFrame();
+        // Runs the releases of every frame numbered below completedFrames
+        void collect(uint64_t completedFrames);
+        // Runs everything left; the device must be idle
+        void flush();
+
+        // Frames submitted so far, which is also the number of the frame being recorded
+        uint64_t getFrameNumber() const;
+        size_t pendingCount() const;
+
+    private:
+        struct Entry {
+            uint64_t frame;
+            std::function<void()> release;
+        };
+
+        // Runs entries already taken out from under the lock, as a release may itself queue more
+        void run(std::deque<Entry>& entries);
+
+        mutable std::mutex mutex;
+        std::deque<Entry> entries;  // ordered by frame
+        uint64_t frameNumber = 0;
+    };
+
+} // namespace Rendering
@@ -104,6 +104,17 @@ DescriptorPool::~DescriptorPool() {
     vkDestroyDescriptorPool(device_.getDevice(), descriptorPool, nullptr);
 }
 
+void DescriptorPool::freeDescriptors(const std::vector<VkDescriptorSet>& descriptors) const {
+    if (descriptors.empty()) {
+        return;
+    }
+    vkFreeDescriptorSets(
+        device_.getDevice(),
+        descriptorPool,
+        static_cast<uint32_t>(descriptors.size()),
+        descriptors.data());
+}
+
 // *************** Descriptor Writer *********************
 
 DescriptorWriter::DescriptorWriter(VkDescriptorSetLayout layout, DescriptorPool& pool) 
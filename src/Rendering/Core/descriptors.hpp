@@ -72,6 +72,8 @@ namespace Rendering {
 
         VkDescriptorPool getDescriptorPool() const { return descriptorPool; }
         Device& device() const { return device_; }
+        // Pool must have been created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+        void freeDescriptors(const std::vector<VkDescriptorSet>& descriptors) const;
 
     private:
         Device& device_;
@@ -1,6 +1,8 @@
 #include "device.hpp"
+#include "Rendering/rendering_constants.hpp"
 
 // std headers
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <set>
@@ -58,10 +60,17 @@ namespace Rendering {
         pickPhysicalDevice();
         createLogicalDevice();
         createCommandPool();
+        pipelineCache = std::make_unique<PipelineCache>(device_, deviceProperties);
+        resourcePool = std::make_unique<ResourcePool>(*this);
     }
 
     Device::~Device() {
          std::cout << "Device destructor called" << std::endl;
+        vkDeviceWaitIdle(device_);
+        deletionQueue.flush();
+        // After the flush, which hands the last releases to the pool
+        resourcePool.reset();
+        pipelineCache.reset();
         vkDestroyCommandPool(device_, commandPool, nullptr);
         vkDestroyDevice(device_, nullptr);
 
@@ -69,10 +78,16 @@ namespace Rendering {
             DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
         }
 
-        vkDestroySurfaceKHR(instance, surface_, nullptr);
+        if (surface_ != VK_NULL_HANDLE) {
+            vkDestroySurfaceKHR(instance, surface_, nullptr);
+        }
         vkDestroyInstance(instance, nullptr);
     }
 
+    void Device::setFramesInFlight(uint32_t count) {
+        framesInFlight = std::clamp(count, 1u, MAX_FRAMES_IN_FLIGHT);
+    }
+
     void Device::createInstance() {
         if (enableValidationLayers && !checkValidationLayerSupport()) {
             throw std::runtime_error("validation layers requested, but not available!");
@@ -136,6 +151,16 @@ namespace Rendering {
         }
     }
 
+    // Otherwise take the first suitable device, which also covers software ICDs such as lavapipe
+    if (physicalDevice == VK_NULL_HANDLE) {
+        for (const auto& device : devices) {
+            if (isDeviceSuitable(device)) {
+                physicalDevice = device;
+                break;
+            }
+        }
+    }
+
         if (physicalDevice == VK_NULL_HANDLE) {
             throw std::runtime_error("failed to find a suitable GPU!");
         }
@@ -149,14 +174,19 @@ namespace Rendering {
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily, indices.presentFamily };
+        if (indices.transferFamilyHasValue) {
+            uniqueQueueFamilies.insert(indices.transferFamily);
+        }
 
-        float queuePriority = 1.0f;
+        // The graphics family gets a second queue for async compute when it has one
+        const bool asyncCompute = ASYNC_COMPUTE_ENABLED && indices.graphicsQueueCount >= 2;
+        const float queuePriorities[] = {1.0f, 1.0f};
         for (uint32_t queueFamily : uniqueQueueFamilies) {
             VkDeviceQueueCreateInfo queueCreateInfo = {};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queueFamily;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount = (asyncCompute && queueFamily == indices.graphicsFamily) ? 2 : 1;
+            queueCreateInfo.pQueuePriorities = queuePriorities;
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
@@ -165,15 +195,50 @@ namespace Rendering {
         deviceFeatures.independentBlend = VK_TRUE;
         deviceFeatures.geometryShader = VK_TRUE;
 
+        // Multiview lets point light shadows render all six cube faces in one pass
+        VkPhysicalDeviceTimelineSemaphoreFeatures supportedTimeline{};
+        supportedTimeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        VkPhysicalDeviceMultiviewFeatures supportedMultiview{};
+        supportedMultiview.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+        supportedMultiview.pNext = &supportedTimeline;
+        VkPhysicalDeviceFeatures2 supportedFeatures2{};
+        supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures2.pNext = &supportedMultiview;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures2);
+
+        VkPhysicalDeviceMultiviewProperties multiviewProperties{};
+        multiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &multiviewProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+        multiviewEnabled = supportedMultiview.multiview == VK_TRUE &&
+                           multiviewProperties.maxMultiviewViewCount >= 6;
+
+        VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+        multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+        multiviewFeatures.multiview = multiviewEnabled ? VK_TRUE : VK_FALSE;
+        std::cout << "Multiview " << (multiviewEnabled ? "enabled" : "not supported") << std::endl;
+
+        // Timeline semaphores let uploads signal a counter the renderer and loader can poll or wait on
+        timelineSemaphoresEnabled = supportedTimeline.timelineSemaphore == VK_TRUE;
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+        timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        timelineFeatures.timelineSemaphore = timelineSemaphoresEnabled ? VK_TRUE : VK_FALSE;
+        multiviewFeatures.pNext = &timelineFeatures;
+
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &multiviewFeatures;
 
         createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
         createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        const std::vector<const char*> enabledExtensions = getDeviceExtensions();
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         // might not really be necessary anymore because device specific validation layers
         // have been deprecated
@@ -191,6 +256,25 @@ namespace Rendering {
 
         vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
         vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
+
+        graphicsFamily_ = indices.graphicsFamily;
+        if (indices.transferFamilyHasValue) {
+            transferFamily_ = indices.transferFamily;
+            vkGetDeviceQueue(device_, indices.transferFamily, 0, &transferQueue_);
+        } else {
+            transferFamily_ = indices.graphicsFamily;
+            transferQueue_ = graphicsQueue_;
+        }
+        std::cout << "Transfer queue: " << (indices.transferFamilyHasValue ? "dedicated family " : "shared with graphics family ")
+                  << transferFamily_ << std::endl;
+
+        if (asyncCompute) {
+            vkGetDeviceQueue(device_, indices.graphicsFamily, 1, &computeQueue_);
+        } else {
+            computeQueue_ = graphicsQueue_;
+        }
+        std::cout << "Async compute queue: " << (asyncCompute ? "second queue of the graphics family" : "none, compute runs on the graphics queue")
+                  << std::endl;
     }
 
     void Device::createCommandPool() {
@@ -207,15 +291,19 @@ namespace Rendering {
         }
     }
 
-    void Device::createSurface() { window.createWindowSurface(instance, &surface_); }
+    void Device::createSurface() {
+        if (!window.isHeadless()) {
+            window.createWindowSurface(instance, &surface_);
+        }
+    }
 
     bool Device::isDeviceSuitable(VkPhysicalDevice device) {
         QueueFamilyIndices indices = findQueueFamilies(device);
 
         bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-        bool swapChainAdequate = false;
-        if (extensionsSupported) {
+        bool swapChainAdequate = window.isHeadless();
+        if (extensionsSupported && !swapChainAdequate) {
             SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
         }
@@ -275,11 +363,12 @@ namespace Rendering {
     }
 
     std::vector<const char*> Device::getRequiredExtensions() {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        std::vector<const char*> extensions;
+        if (!window.isHeadless()) {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (enableValidationLayers) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -322,7 +411,8 @@ namespace Rendering {
             &extensionCount,
             availableExtensions.data());
 
-        std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+        const std::vector<const char*> enabledExtensions = getDeviceExtensions();
+        std::set<std::string> requiredExtensions(enabledExtensions.begin(), enabledExtensions.end());
 
         for (const auto& extension : availableExtensions) {
             requiredExtensions.erase(extension.extensionName);
@@ -331,6 +421,16 @@ namespace Rendering {
         return requiredExtensions.empty();
     }
 
+    std::vector<const char*> Device::getDeviceExtensions() const {
+        std::vector<const char*> extensions;
+        for (const char* extension : deviceExtensions) {
+            if (!window.isHeadless() || std::strcmp(extension, VK_KHR_SWAPCHAIN_EXTENSION_NAME) != 0) {
+                extensions.push_back(extension);
+            }
+        }
+        return extensions;
+    }
+
     QueueFamilyIndices Device::findQueueFamilies(VkPhysicalDevice device) {
         QueueFamilyIndices indices;
 
@@ -344,10 +444,14 @@ namespace Rendering {
         for (const auto& queueFamily : queueFamilies) {
             if (queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 indices.graphicsFamily = i;
+                indices.graphicsQueueCount = queueFamily.queueCount;
                 indices.graphicsFamilyHasValue = true;
             }
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+            // Headless frames are never presented, the graphics family stands in for the present family
+            VkBool32 presentSupport = window.isHeadless() && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+            if (!window.isHeadless()) {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+            }
             if (queueFamily.queueCount > 0 && presentSupport) {
                 indices.presentFamily = i;
                 indices.presentFamilyHasValue = true;
@@ -359,6 +463,25 @@ namespace Rendering {
             i++;
         }
 
+        // Prefer a transfer-only family (the DMA engines), then any other non-graphics family that can copy.
+        // Families with a coarse image transfer granularity cannot copy small mips and are skipped
+        int bestTransferScore = 0;
+        for (uint32_t family = 0; family < queueFamilies.size(); family++) {
+            const auto& queueFamily = queueFamilies[family];
+            const VkExtent3D& granularity = queueFamily.minImageTransferGranularity;
+            if (queueFamily.queueCount == 0 || (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) ||
+                !(queueFamily.queueFlags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) ||
+                granularity.width != 1 || granularity.height != 1 || granularity.depth != 1) {
+                continue;
+            }
+            int score = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+            if (score > bestTransferScore) {
+                bestTransferScore = score;
+                indices.transferFamily = family;
+                indices.transferFamilyHasValue = true;
+            }
+        }
+
         return indices;
     }
 
@@ -475,8 +598,11 @@ namespace Rendering {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &commandBuffer;
 
-        vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(graphicsQueue_);
+        {
+            std::lock_guard<std::mutex> lock(graphicsQueueMutex);
+            vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
+            vkQueueWaitIdle(graphicsQueue_);
+        }
 
         vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
     }
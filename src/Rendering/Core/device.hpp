@@ -1,8 +1,15 @@
 #pragma once
 
 #include "window.hpp"
+#include "pipeline_cache.hpp"
+#include "deletion_queue.hpp"
+#include "resource_pool.hpp"
+#include "Rendering/rendering_constants.hpp"
 
 // std lib headers
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <ktxvulkan.h>
@@ -18,8 +25,11 @@ namespace Rendering {
     struct QueueFamilyIndices {
         uint32_t graphicsFamily;
         uint32_t presentFamily;
+        uint32_t transferFamily;  // only set for a transfer-capable family other than graphics
+        uint32_t graphicsQueueCount = 0;
         bool graphicsFamilyHasValue = false;
         bool presentFamilyHasValue = false;
+        bool transferFamilyHasValue = false;
         bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
     };
 
@@ -50,8 +60,39 @@ namespace Rendering {
         VkSurfaceKHR getSurface() { return surface_; }
         VkQueue getGraphicsQueue() { return graphicsQueue_; }
         VkQueue getPresentQueue() { return presentQueue_; }
+        // Falls back to the graphics queue and family when the device has no separate transfer family
+        VkQueue getTransferQueue() { return transferQueue_; }
+        uint32_t getGraphicsQueueFamily() const { return graphicsFamily_; }
+        uint32_t getTransferQueueFamily() const { return transferFamily_; }
+        bool hasDedicatedTransferQueue() const { return transferFamily_ != graphicsFamily_; }
+        // Second queue of the graphics family, for compute that overlaps the frame's raster work. Sharing the
+        // family keeps every image and buffer usable from both queues without ownership transfers. Falls back
+        // to the graphics queue when the family exposes only one queue or ASYNC_COMPUTE_ENABLED is off
+        VkQueue getComputeQueue() { return computeQueue_; }
+        bool hasAsyncComputeQueue() const { return computeQueue_ != graphicsQueue_; }
+        // Queues are externally synchronized: every submit/present on the graphics queue (and on the transfer
+        // queue when it aliases graphics) holds this lock, so the upload thread can submit while the renderer runs
+        std::mutex& getGraphicsQueueMutex() { return graphicsQueueMutex; }
+        // Same for the dedicated transfer queue, shared by every UploadManager (scene loader and texture streamer)
+        std::mutex& getTransferQueueMutex() { return transferQueueMutex; }
+        std::mutex& getComputeQueueMutex() { return hasAsyncComputeQueue() ? computeQueueMutex : graphicsQueueMutex; }
+        // Pass getPipelineCache().getCache() to every vkCreate*Pipelines; it also runs pipeline creation jobs
+        PipelineCache& getPipelineCache() { return *pipelineCache; }
+        // Objects a frame in flight may still use are handed here rather than destroyed on the spot
+        DeletionQueue& getDeletionQueue() { return deletionQueue; }
+        // Recycles images and buffers released at runtime; releases are deferred through the deletion queue
+        ResourcePool& getResourcePool() { return *resourcePool; }
+        // Frames the CPU may record ahead of the GPU (1..MAX_FRAMES_IN_FLIGHT): one frame fence per frame in
+        // flight. Set it before the renderer is created; Renderer::setFramesInFlight changes it for a live one
+        uint32_t getFramesInFlight() const { return framesInFlight; }
+        void setFramesInFlight(uint32_t count);
+        // Per-frame resources (command buffers, uniform buffers, render targets) rotate through this many slots,
+        // independently of the swapchain's image count
+        uint32_t getFrameSlotCount() const { return std::max(framesInFlight, MIN_FRAME_SLOTS); }
         VkPhysicalDevice getPhysicalDevice(){return physicalDevice;}
         VkInstance getInstance() { return instance; }
+        // No surface, no swapchain extension: the swapchain renders into offscreen images
+        bool isHeadless() const { return window.isHeadless(); }
         
         SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); }
         uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
@@ -84,6 +125,11 @@ namespace Rendering {
         // Helper to find the best supported compressed format
         VkFormat findBestCompressedFormat(bool srgb = true, bool hasAlpha = true);
 
+        // True when VK_KHR_multiview (core 1.1) was enabled with at least 6 views
+        bool supportsMultiview() const { return multiviewEnabled; }
+        // Core in Vulkan 1.2; required by UploadManager
+        bool supportsTimelineSemaphores() const { return timelineSemaphoresEnabled; }
+
         VkPhysicalDeviceProperties deviceProperties;
         VkFormat getDepthFormat();
 
@@ -113,6 +159,7 @@ namespace Rendering {
         void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
         void hasGflwRequiredInstanceExtensions();
         bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+        std::vector<const char*> getDeviceExtensions() const;
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
 
         VkInstance instance;
@@ -122,11 +169,24 @@ namespace Rendering {
         VkCommandPool commandPool;
 
         VkDevice device_;
-        VkSurfaceKHR surface_;
+        VkSurfaceKHR surface_{VK_NULL_HANDLE};
         VkQueue graphicsQueue_;
         VkQueue presentQueue_;
+        VkQueue transferQueue_;
+        VkQueue computeQueue_;
+        uint32_t graphicsFamily_ = 0;
+        uint32_t transferFamily_ = 0;
+        std::mutex graphicsQueueMutex;
+        std::mutex transferQueueMutex;
+        std::mutex computeQueueMutex;
+        std::unique_ptr<PipelineCache> pipelineCache;
+        DeletionQueue deletionQueue;
+        std::unique_ptr<ResourcePool> resourcePool;
+        uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
 
         VkFormat depthFormat{VK_FORMAT_UNDEFINED};
+        bool multiviewEnabled = false;
+        bool timelineSemaphoresEnabled = false;
         const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
         const std::vector<const char*> deviceExtensions = { 
             VK_KHR_SWAPCHAIN_EXTENSION_NAME,
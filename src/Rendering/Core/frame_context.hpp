@@ -13,6 +13,10 @@ using namespace ECS;
 using namespace Math;
 namespace Rendering{
 
+	class GpuProfiler;
+	class ParallelRecorder;
+	class RenderingResources;
+
     // Maps for instanced rendering - use mesh pointer as key along with material
            struct MeshMaterialSubmeshKey {
                Mesh* mesh;
@@ -47,27 +51,83 @@ namespace Rendering{
 
 namespace Rendering {
 
+	// A light visible this frame: the component is only valid until the end of the frame,
+	// the registry slot identifies the light across frames
+	template<typename LightT>
+	struct SlottedLight{
+		uint32_t slot;
+		LightT* light;
+	};
+
     struct LightData{
-		std::vector<SpotLight*> spotLights;
-		std::vector<PointLight*> pointLights;
-		std::vector<DirectionalLight*> directionalLights;
+		std::vector<SlottedLight<SpotLight>> spotLights;
+		std::vector<SlottedLight<PointLight>> pointLights;
+		std::vector<SlottedLight<DirectionalLight>> directionalLights;
+	};
+
+	// Shadowcasting light of this frame: its shadow map and the lightMatrixBuffer range holding its matrices
+	struct ShadowcastingLight{
+		uint32_t lightSlot;
+		uint32_t shadowmapIndex;
+		uint32_t lightMatrixBase;
+		uint32_t matrixCount;
+		const glm::mat4* matrices;
+		glm::vec4 lightPosRange;
+	};
+
+	// One shadow map render target: a directional cascade, a spot map, a point cube face,
+	// or a whole cube when point shadows are rendered with multiview
+	struct ShadowView{
+		LightType lightType;
+		uint32_t shadowmapIndex;
+		uint32_t layer;
+		uint32_t lightMatrixIndex;
+		glm::vec4 lightPosRange;
+		bool multiview;
+		uint32_t instanceOffset;	// range in ShadowcastingData::instances while culling
+		uint32_t instanceCount;
+		uint32_t batchOffset;		// range in FrameContext::shadowBatches once uploaded
+		uint32_t batchCount;
+	};
+
+	struct ShadowCasterInstance{
+		MeshMaterialSubmeshKey key;
+		const glm::mat4* modelMatrix;
+		uint32_t faceMask;			// cube faces touched, multiview point lights only
 	};
 
+	// Flat per-frame scratch for shadow casting; reset() keeps the vectors' capacity so steady-state frames
+	// do not allocate. Each view owns a contiguous range of instances.
 	struct ShadowcastingData{
-		// Per-light storage of model matrices to keep cascades/faces independent
-		std::unordered_map<DirectionalLight*,std::array<std::unordered_map<MeshMaterialSubmeshKey,std::vector<glm::mat4>>, MAX_SHADOW_CASCADE_COUNT>> directionalShadowModelsByCascade;
-		std::unordered_map<SpotLight*,std::unordered_map<MeshMaterialSubmeshKey,std::vector<glm::mat4>>> spotShadowModels;
-		std::unordered_map<PointLight*,std::array<std::unordered_map<MeshMaterialSubmeshKey,std::vector<glm::mat4>>, 6>> pointShadowModelsByFace;
-
-		std::unordered_map<DirectionalLight*,std::array<std::vector<MeshMaterialSubmeshKey>, MAX_SHADOW_CASCADE_COUNT>> directionalShadowcastingKeyMapByCascade;
-		std::unordered_map<SpotLight*,std::vector<MeshMaterialSubmeshKey>> spotShadowcastingKeyMap;
-		std::unordered_map<PointLight*,std::array<std::vector<MeshMaterialSubmeshKey>, 6>> pointShadowcastingKeyMapByFace;
+		std::vector<ShadowcastingLight> lights;
+		std::array<int32_t, MAX_LIGHTS> lightIndexBySlot;
+		std::vector<ShadowView> views;
+		std::vector<ShadowCasterInstance> instances;
+		uint32_t lightMatrixCount=0;
 		uint32_t directionalShadowCastingCount=0;
 		uint32_t spotShadowCastingCount=0;
 		uint32_t pointShadowCastingCount=0;
-	};
-
 
+		ShadowcastingData(){ reset(); }
+
+		void reset(){
+			lights.clear();
+			lightIndexBySlot.fill(-1);
+			views.clear();
+			instances.clear();
+			lightMatrixCount=0;
+			directionalShadowCastingCount=0;
+			spotShadowCastingCount=0;
+			pointShadowCastingCount=0;
+		}
+
+		const ShadowcastingLight* findLight(uint32_t slot) const {
+			if(slot >= MAX_LIGHTS || lightIndexBySlot[slot] < 0){
+				return nullptr;
+			}
+			return &lights[lightIndexBySlot[slot]];
+		}
+	};
 
 	struct MaterialBatch{
 		Material* material;
@@ -112,10 +172,14 @@ namespace Rendering {
 
     struct FrameContext {
         // === CORE FRAME DATA ===
-        uint32_t frameIndex;
+        uint32_t frameIndex;        // frame slot: indexes every per-frame resource
+        uint32_t imageIndex;        // acquired swapchain image, for passes that draw to it
         VkCommandBuffer commandBuffer;
         VkExtent2D extent;
         float frameTime;
+		GpuProfiler* gpuProfiler = nullptr;	// null when profiling is off; see GpuProfileScope
+		ParallelRecorder* parallelRecorder = nullptr;	// null when passes record inline
+		RenderingResources* renderingResources = nullptr;	// grows the instance buffers below when culling outgrows them; null keeps them as sized
         
 		VkDescriptorSet cameraDescriptorSet;
 		VkDescriptorSet modelsDescriptorSet;
@@ -130,6 +194,7 @@ namespace Rendering {
 		VkDescriptorSet transparencyModelDescriptorSet;
 		VkDescriptorSet compositionDescriptorSet;
 		VkDescriptorSet depthPyramidDescriptorSet;
+		VkDescriptorSet depthBoundsDescriptorSet;
 		VkDescriptorSet rcBuildDescriptorSet;
 		VkDescriptorSet rcResolveDescriptorSet;
 		VkDescriptorSet smaaEdgeDescriptorSet;
@@ -140,11 +205,15 @@ namespace Rendering {
         Buffer* cameraUniformBuffer;
         Buffer* modelMatrixBuffer;
 		Buffer* normalMatrixBuffer;
-		Buffer* lightArrayUniformBuffer;
+		Buffer* lightArrayUniformBuffer;    // visible light list, indexes lightSlotBuffer
+		Buffer* lightSlotBuffer;            // device-local persistent light data, shared by all frames
+		Buffer* lightSlotStagingBuffer;
 		Buffer* cascadeSplitsBuffer;
 		Buffer* sceneLightingBuffer;
 		Buffer* lightMatrixBuffer;
 		Buffer* shadowModelMatrixBuffer;
+		Buffer* shadowFaceMaskBuffer;
+		Buffer* depthBoundsBuffer;       // SDSM readback, holds the bounds from this context's previous use
 		Buffer* transparencyModelMatrixBuffer;
 		Buffer* transparencyNormalMatrixBuffer;
 		
@@ -159,11 +228,15 @@ namespace Rendering {
 		std::vector<VkDescriptorSet> depthPyramidMipDescriptorSets;
 
 		VkImageView lightPassResultView;
+		VkImage lightPassResultImage;
 		VkSampler lightPassSampler;
 		VkImageView lightIncidentView;
+		VkImage lightIncidentImage;
 
 		VkImageView accumulationView;
+		VkImage accumulationImage;
 		VkImageView revealageView;
+		VkImage revealageImage;
 
 		// Indirect GI buffer
 		VkImageView giIndirectView;
@@ -181,7 +254,9 @@ namespace Rendering {
 
 		// GI history for temporal accumulation (previous frame's GI output)
 		VkImageView giHistoryView;
+		VkImage giHistoryImage;
 		VkSampler giHistorySampler;
+		VkImage gBufferPositionHistoryImage;	// previous frame's positions, reprojected by the RC resolve
 
 		// Previous frame camera data for motion vector computation
 		PrevCameraData prevCameraData;
@@ -196,6 +271,7 @@ namespace Rendering {
 
 		// RC per-cascade atlas views for this frame
 		std::array<VkImageView, RC_CASCADE_COUNT> rcRadianceViews{};
+		std::array<VkImage, RC_CASCADE_COUNT> rcRadianceImages{};
 
 		VkImage gBufferPositionImage;
 		VkImage gBufferNormalImage;
@@ -207,6 +283,9 @@ namespace Rendering {
 		std::array<ShadowMap*, MAX_SPOT_LIGHTS> spotShadowMaps{};
 		std::array<ShadowMap*, MAX_POINT_LIGHTS> pointShadowMaps{};
 
+		// Dirty light slots staged by LightSystem, copied into lightSlotBuffer by the light pass
+		std::vector<VkBufferCopy> lightSlotCopyRegions;
+
 		AABB frameSceneBounds;
 		CameraData cameraData;
         std::array<MaterialBatch,BASE_INSTANCED_RENDERABLES> opaqueMaterialBatches;
@@ -215,14 +294,14 @@ namespace Rendering {
 		std::array<MaterialBatch,BASE_INSTANCED_RENDERABLES> transparentMaterialBatches;
 		uint32_t transparentMaterialBatchCount = 0;
 
-		std::unordered_map<DirectionalLight*,std::array<std::vector<MaterialBatch>, MAX_SHADOW_CASCADE_COUNT>> directionalShadowcastingMaterialMap;
-		std::unordered_map<SpotLight*,std::vector<MaterialBatch>> spotShadowcastingMaterialMap;
-		std::unordered_map<PointLight*,std::array<std::vector<MaterialBatch>, 6>> pointShadowcastingMaterialMapByFace;
+		// Texture streaming feedback from camera culling: screen pixels covered by one UV unit, the largest over
+		// this frame's visible instances of each material
+		std::unordered_map<Material*, float> materialScreenDensity;
 
-		// Matrix base indices in lightMatrixBuffer for each light type
-		std::unordered_map<DirectionalLight*, uint32_t> directionalLightMatrixBase;
-		std::unordered_map<SpotLight*, uint32_t> spotLightMatrixBase;
-		std::unordered_map<PointLight*, uint32_t> pointLightMatrixBase;
+		// Shadow views in render order; each draws its own contiguous range of shadowBatches
+		std::vector<ShadowView> shadowViews;
+		std::vector<MaterialBatch> shadowBatches;
+		bool singlePassPointShadows = false;
     };
     
 }
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Rendering {
+
+    namespace {
+        // Weight of the newest frame in the overlay's averages
+        constexpr float AVERAGE_WEIGHT = 0.05f;
+
+        std::string escapeJson(const std::string& text) {
+            std::string escaped;
+            escaped.reserve(text.size());
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+            return escaped;
+        }
+    }
+
+    GpuProfiler::GpuProfiler(Device& device) : device{device} {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &familyCount, families.data());
+
+        const uint32_t validBits = families[device.getGraphicsQueueFamily()].timestampValidBits;
+        const float timestampPeriod = device.deviceProperties.limits.timestampPeriod;
+        if (validBits == 0 || timestampPeriod <= 0.0f) {
+            std::cout << "GPU profiler: the graphics queue does not support timestamps, profiling disabled" << std::endl;
+            return;
+        }
+        timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        nanosecondsPerTick = timestampPeriod;
+
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = MAX_FRAMES_IN_FLIGHT * GPU_PROFILER_MAX_SCOPES * 2;
+        if (vkCreateQueryPool(device.getDevice(), &poolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create timestamp query pool!");
+        }
+
+        for (FrameSlot& slot : slots) {
+            slot.scopes.reserve(GPU_PROFILER_MAX_SCOPES);
+        }
+        results.resize(GPU_PROFILER_MAX_SCOPES * 2);
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        if (queryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device.getDevice(), queryPool, nullptr);
+        }
+    }
+
+    void GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+        if (!isSupported()) {
+            return;
+        }
+        currentSlot = frameSlot;
+        FrameSlot& slot = slots[frameSlot];
+        if (slot.submitted) {
+            readBack(frameSlot);
+        }
+        slot.scopes.clear();
+        slot.submitted = false;
+        slot.frameNumber = frameCounter++;
+
+        vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery(frameSlot), GPU_PROFILER_MAX_SCOPES * 2);
+        recording = true;
+        depth = 0;
+        frameScope = beginScope(commandBuffer, "GPU frame");
+    }
+
+    void GpuProfiler::endFrame(VkCommandBuffer commandBuffer) {
+        if (!recording) {
+            return;
+        }
+        // Unbalanced scopes would leave queries unwritten and the whole slot unreadable
+        FrameSlot& slot = slots[currentSlot];
+        for (uint32_t i = static_cast<uint32_t>(slot.scopes.size()); i-- > 0;) {
+            if (!slot.scopes[i].closed && i != frameScope) {
+                endScope(commandBuffer, i);
+            }
+        }
+        endScope(commandBuffer, frameScope);
+        frameScope = INVALID_SCOPE;
+    }
+
+    void GpuProfiler::markSubmitted() {
+        if (!recording) {
+            return;
+        }
+        slots[currentSlot].submitted = true;
+        recording = false;
+    }
+
+    void GpuProfiler::flush() {
+        if (!isSupported()) {
+            return;
+        }
+        std::vector<uint32_t> pending;
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+            if (slots[i].submitted) {
+                pending.push_back(i);
+            }
+        }
+        std::sort(pending.begin(), pending.end(),
+                  [this](uint32_t a, uint32_t b) { return slots[a].frameNumber < slots[b].frameNumber; });
+        for (uint32_t frameSlot : pending) {
+            readBack(frameSlot);
+            slots[frameSlot].scopes.clear();
+            slots[frameSlot].submitted = false;
+        }
+    }
+
+    uint32_t GpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name, int32_t index) {
+        if (!recording) {
+            return INVALID_SCOPE;
+        }
+        FrameSlot& slot = slots[currentSlot];
+        if (slot.scopes.size() >= GPU_PROFILER_MAX_SCOPES) {
+            droppedScopeCount++;
+            return INVALID_SCOPE;
+        }
+        const uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+        slot.scopes.push_back({name, index, depth, false});
+        depth++;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, firstQuery(currentSlot) + scope * 2);
+        return scope;
+    }
+
+    void GpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t scope) {
+        if (!recording || scope == INVALID_SCOPE) {
+            return;
+        }
+        ScopeRecord& record = slots[currentSlot].scopes[scope];
+        if (record.closed) {
+            return;
+        }
+        record.closed = true;
+        depth = record.depth;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, firstQuery(currentSlot) + scope * 2 + 1);
+    }
+
+    void GpuProfiler::readBack(uint32_t frameSlot) {
+        const FrameSlot& slot = slots[frameSlot];
+        if (slot.scopes.empty()) {
+            return;
+        }
+        const uint32_t queryCount = static_cast<uint32_t>(slot.scopes.size()) * 2;
+        // No wait flag: the fence of this slot has signaled, VK_NOT_READY only happens after a device loss or reset
+        VkResult result = vkGetQueryPoolResults(device.getDevice(), queryPool, firstQuery(frameSlot), queryCount,
+                                                queryCount * sizeof(uint64_t), results.data(), sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            return;
+        }
+
+        FrameTimings frame;
+        frame.frameNumber = slot.frameNumber;
+        frame.scopes.reserve(slot.scopes.size());
+        for (size_t i = 0; i < slot.scopes.size(); ++i) {
+            const ScopeRecord& record = slot.scopes[i];
+            const uint64_t ticks = (results[i * 2 + 1] - results[i * 2]) & timestampMask;
+            const float ms = static_cast<float>(static_cast<double>(ticks) * nanosecondsPerTick * 1e-6);
+            frame.scopes.push_back({record.name, record.index, record.depth, ms});
+
+            auto [average, inserted] = averages.try_emplace({record.name, record.index}, ms);
+            if (!inserted) {
+                average->second += (ms - average->second) * AVERAGE_WEIGHT;
+            }
+        }
+
+        history.push_back(std::move(frame));
+        while (history.size() > GPU_PROFILER_HISTORY_FRAMES) {
+            history.pop_front();
+        }
+    }
+
+    float GpuProfiler::getAverageMs(const ScopeTiming& scope) const {
+        auto it = averages.find({scope.name, scope.index});
+        return it != averages.end() ? it->second : scope.ms;
+    }
+
+    std::string GpuProfiler::getLabel(const ScopeTiming& scope) {
+        if (scope.index < 0) {
+            return scope.name;
+        }
+        return std::string(scope.name) + " " + std::to_string(scope.index);
+    }
+
+    std::vector<GpuProfiler::ScopeSummary> GpuProfiler::summarize() const {
+        std::vector<ScopeSummary> summaries;
+        std::vector<std::vector<float>> samples;
+        std::unordered_map<std::string, size_t> indexByLabel;
+        for (const FrameTimings& frame : history) {
+            for (const ScopeTiming& scope : frame.scopes) {
+                std::string label = getLabel(scope);
+                auto [it, inserted] = indexByLabel.try_emplace(label, summaries.size());
+                if (inserted) {
+                    ScopeSummary summary;
+                    summary.label = std::move(label);
+                    summary.depth = scope.depth;
+                    summaries.push_back(std::move(summary));
+                    samples.emplace_back();
+                }
+                samples[it->second].push_back(scope.ms);
+            }
+        }
+
+        for (size_t i = 0; i < summaries.size(); ++i) {
+            std::vector<float>& values = samples[i];
+            std::sort(values.begin(), values.end());
+            double sum = 0.0;
+            for (float value : values) {
+                sum += value;
+            }
+            ScopeSummary& summary = summaries[i];
+            summary.sampleCount = static_cast<uint32_t>(values.size());
+            summary.meanMs = static_cast<float>(sum / values.size());
+            summary.minMs = values.front();
+            summary.maxMs = values.back();
+            const size_t p95Index = (values.size() * 95 + 99) / 100 - 1;
+            summary.p95Ms = values[std::min(p95Index, values.size() - 1)];
+        }
+        return summaries;
+    }
+
+    bool GpuProfiler::exportCsv(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "GPU profiler: cannot write " << path << std::endl;
+            return false;
+        }
+        file << "frame,scope,depth,ms\n";
+        for (const FrameTimings& frame : history) {
+            for (const ScopeTiming& scope : frame.scopes) {
+                file << frame.frameNumber << ',' << getLabel(scope) << ',' << scope.depth << ','
+                     << std::fixed << std::setprecision(4) << scope.ms << '\n';
+            }
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool GpuProfiler::exportJson(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "GPU profiler: cannot write " << path << std::endl;
+            return false;
+        }
+        file << std::fixed << std::setprecision(4);
+        file << "{\n";
+        file << "  \"device\": \"" << escapeJson(device.deviceProperties.deviceName) << "\",\n";
+        file << "  \"frames\": " << history.size() << ",\n";
+        file << "  \"scopes\": [";
+        const std::vector<ScopeSummary> summaries = summarize();
+        for (size_t i = 0; i < summaries.size(); ++i) {
+            const ScopeSummary& summary = summaries[i];
+            file << (i == 0 ? "\n" : ",\n");
+            file << "    {\"name\": \"" << escapeJson(summary.label) << "\", \"depth\": " << summary.depth
+                 << ", \"samples\": " << summary.sampleCount
+                 << ", \"mean_ms\": " << summary.meanMs << ", \"min_ms\": " << summary.minMs
+                 << ", \"max_ms\": " << summary.maxMs << ", \"p95_ms\": " << summary.p95Ms << "}";
+        }
+        file << "\n  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    std::string GpuProfiler::exportCapture() const {
+        if (history.empty()) {
+            return {};
+        }
+        std::error_code error;
+        std::filesystem::create_directories(GPU_PROFILER_EXPORT_DIRECTORY, error);
+        if (error) {
+            std::cerr << "GPU profiler: cannot create " << GPU_PROFILER_EXPORT_DIRECTORY << ": " << error.message() << std::endl;
+            return {};
+        }
+
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::ostringstream name;
+        name << "gpu_profile_" << std::put_time(std::localtime(&now), "%Y%m%d_%H%M%S");
+        const std::filesystem::path base = std::filesystem::path(GPU_PROFILER_EXPORT_DIRECTORY) / name.str();
+        const std::string csvPath = base.string() + ".csv";
+        if (!exportCsv(csvPath) || !exportJson(base.string() + ".json")) {
+            return {};
+        }
+        std::cout << "GPU profiler: wrote " << history.size() << " frames to " << base.string() << ".csv/.json" << std::endl;
+        return csvPath;
+    }
+
+} // namespace Rendering
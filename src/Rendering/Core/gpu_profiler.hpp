@@ -0,0 +1,146 @@
+#pragma once
+
+#include "device.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Rendering {
+
+    // Times ranges of the frame's command buffer with timestamp queries. Each frame slot owns a slice of one query
+    // pool that is read back in beginFrame, after the swapchain has waited for the fence covering that slot, so
+    // results are Device::getFrameSlotCount() frames old and reading them never stalls. Scopes nest and must be
+    // recorded outside render pass instances: inside a multiview render pass a timestamp takes one query per view.
+    // Only used from the render thread.
+    class GpuProfiler {
+    public:
+        static constexpr uint32_t INVALID_SCOPE = UINT32_MAX;
+
+        struct ScopeTiming {
+            const char* name;   // as passed to beginScope
+            int32_t index;      // appended to the name when >= 0 (shadow view, cascade...)
+            uint32_t depth;     // 0 for the frame scope
+            float ms;
+        };
+
+        struct FrameTimings {
+            uint64_t frameNumber = 0;
+            std::vector<ScopeTiming> scopes;    // in begin order, scopes[0] spans the whole frame
+        };
+
+        struct ScopeSummary {
+            std::string label;
+            uint32_t depth = 0;
+            uint32_t sampleCount = 0;
+            float meanMs = 0.0f;
+            float minMs = 0.0f;
+            float maxMs = 0.0f;
+            float p95Ms = 0.0f;
+        };
+
+        explicit GpuProfiler(Device& device);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // False when the graphics queue has no timestamp support; every call is then a no-op
+        bool isSupported() const { return queryPool != VK_NULL_HANDLE; }
+
+        // Right after the command buffer is begun: reads back frameSlot's previous frame, resets its queries and
+        // opens the frame scope
+        void beginFrame(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+        // Closes the frame scope and any scope left open; before the command buffer is ended
+        void endFrame(VkCommandBuffer commandBuffer);
+        // The frame was submitted, its queries will be read back next time its slot begins
+        void markSubmitted();
+        // After the device is idle: reads back every submitted slot, oldest frame first, so the history ends with
+        // the last frame rendered
+        void flush();
+
+        // name must outlive the profiler (a string literal); the label is only formatted for display and export
+        uint32_t beginScope(VkCommandBuffer commandBuffer, const char* name, int32_t index = -1);
+        void endScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+        // Oldest first, at most GPU_PROFILER_HISTORY_FRAMES
+        const std::deque<FrameTimings>& getHistory() const { return history; }
+        // Exponential moving average of the scope over the frames it appeared in
+        float getAverageMs(const ScopeTiming& scope) const;
+        uint32_t getDroppedScopeCount() const { return droppedScopeCount; }
+
+        // Per label over the history, in order of first appearance
+        std::vector<ScopeSummary> summarize() const;
+        static std::string getLabel(const ScopeTiming& scope);
+
+        // CSV: one row per scope and frame of the history. JSON: the summary plus the device it was taken on
+        bool exportCsv(const std::string& path) const;
+        bool exportJson(const std::string& path) const;
+        // Both into GPU_PROFILER_EXPORT_DIRECTORY under a timestamped name; returns the CSV path, empty on failure
+        std::string exportCapture() const;
+
+    private:
+        struct ScopeRecord {
+            const char* name;
+            int32_t index;
+            uint32_t depth;
+            bool closed;
+        };
+
+        struct FrameSlot {
+            std::vector<ScopeRecord> scopes;
+            uint64_t frameNumber = 0;
+            bool submitted = false;
+        };
+
+        void readBack(uint32_t frameSlot);
+        uint32_t firstQuery(uint32_t frameSlot) const { return frameSlot * GPU_PROFILER_MAX_SCOPES * 2; }
+
+        Device& device;
+        VkQueryPool queryPool{VK_NULL_HANDLE};
+        double nanosecondsPerTick = 1.0;
+        uint64_t timestampMask = ~0ull;
+
+        std::array<FrameSlot, MAX_FRAMES_IN_FLIGHT> slots;
+        uint32_t currentSlot = 0;
+        bool recording = false;
+        uint32_t depth = 0;
+        uint32_t frameScope = INVALID_SCOPE;
+        uint64_t frameCounter = 0;
+        uint32_t droppedScopeCount = 0;
+
+        std::deque<FrameTimings> history;
+        std::map<std::pair<const char*, int32_t>, float> averages;
+        std::vector<uint64_t> results;      // readback scratch
+    };
+
+    // Times the enclosing block; does nothing when profiler is null
+    class GpuProfileScope {
+    public:
+        GpuProfileScope(GpuProfiler* profiler, VkCommandBuffer commandBuffer, const char* name, int32_t index = -1)
+            : profiler{profiler}, commandBuffer{commandBuffer} {
+            if (profiler) {
+                scope = profiler->beginScope(commandBuffer, name, index);
+            }
+        }
+        ~GpuProfileScope() {
+            if (profiler) {
+                profiler->endScope(commandBuffer, scope);
+            }
+        }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler* profiler;
+        VkCommandBuffer commandBuffer;
+        uint32_t scope = GpuProfiler::INVALID_SCOPE;
+    };
+
+} // namespace Rendering
@@ -1,6 +1,8 @@
 #include "imgui_manager.hpp"
 #include <stdexcept>
+#include <algorithm>
 #include <array>
+#include <functional>
 #include <iostream>
 
 namespace Rendering {
@@ -135,7 +137,7 @@ void ImGuiManager::initImGui(Window& window, uint32_t imageCount) {
     initInfo.Device = device.getDevice();
     initInfo.QueueFamily = device.findPhysicalQueueFamilies().graphicsFamily;
     initInfo.Queue = device.getGraphicsQueue();
-    initInfo.PipelineCache = VK_NULL_HANDLE;
+    initInfo.PipelineCache = device.getPipelineCache().getCache();
     initInfo.DescriptorPool = imguiDescriptorPool;
     initInfo.MinImageCount = imageCount;
     initInfo.ImageCount = imageCount;
@@ -158,6 +160,12 @@ void ImGuiManager::run(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
     
     // Render all ImGui UI elements here
     renderFPSCounter();
+    if (gpuProfiler) {
+        renderGpuTimings();
+    }
+#if CPU_PROFILER_ENABLED
+    renderCpuFlameView();
+#endif
     
     endFrame(commandBuffer, imageIndex);
 }
@@ -219,11 +227,158 @@ void ImGuiManager::renderFPSCounter() {
     ImGui::End();
 }
 
-void ImGuiManager::onWindowResize(SwapChain& swapChain) {
-    // Cleanup old framebuffers
-    for (auto framebuffer : framebuffers) {
-        vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
+void ImGuiManager::renderGpuTimings() {
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(io.DisplaySize.x - 10.0f, 10.0f), ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.35f);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+
+    if (ImGui::Begin("GPU Timings", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        const auto& history = gpuProfiler->getHistory();
+        if (history.empty()) {
+            ImGui::Text("Waiting for results...");
+        } else {
+            // The frame scope comes first in every frame
+            gpuFrameTimes.clear();
+            float maxFrameMs = 0.0f;
+            for (const auto& frame : history) {
+                gpuFrameTimes.push_back(frame.scopes.front().ms);
+                maxFrameMs = std::max(maxFrameMs, frame.scopes.front().ms);
+            }
+            ImGui::PlotLines("##gpuFrame", gpuFrameTimes.data(), static_cast<int>(gpuFrameTimes.size()), 0,
+                             "GPU frame (ms)", 0.0f, maxFrameMs * 1.1f, ImVec2(320.0f, 60.0f));
+
+            const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+            if (ImGui::BeginTable("gpuScopes", 3, tableFlags)) {
+                ImGui::TableSetupColumn("Pass");
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("avg ms");
+                ImGui::TableHeadersRow();
+                for (const auto& scope : history.back().scopes) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    // Indent(0) would use the default spacing, so the depth is indented explicitly
+                    const float indent = scope.depth * 10.0f;
+                    if (indent > 0.0f) {
+                        ImGui::Indent(indent);
+                    }
+                    ImGui::TextUnformatted(GpuProfiler::getLabel(scope).c_str());
+                    if (indent > 0.0f) {
+                        ImGui::Unindent(indent);
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", scope.ms);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", gpuProfiler->getAverageMs(scope));
+                }
+                ImGui::EndTable();
+            }
+            if (gpuProfiler->getDroppedScopeCount() > 0) {
+                ImGui::Text("%u scopes over the per-frame limit were not timed", gpuProfiler->getDroppedScopeCount());
+            }
+
+            if (ImGui::Button("Export CSV/JSON")) {
+                lastExportPath = gpuProfiler->exportCapture();
+                if (lastExportPath.empty()) {
+                    lastExportPath = "export failed";
+                }
+            }
+            if (!lastExportPath.empty()) {
+                ImGui::SameLine();
+                ImGui::TextUnformatted(lastExportPath.c_str());
+            }
+        }
+    }
+    ImGui::End();
+}
+
+#if CPU_PROFILER_ENABLED
+void ImGuiManager::renderCpuFlameView() {
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(io.DisplaySize.x * 0.5f, 0.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("CPU Frame", nullptr, ImGuiWindowFlags_NoFocusOnAppearing)) {
+        ImGui::End();
+        return;
+    }
+
+    // Collected here, on the main thread, before this frame's own zones have ended
+    Engine::CpuProfiler& profiler = Engine::CpuProfiler::getInstance();
+    uint64_t frameStartNs = 0;
+    uint64_t frameEndNs = 0;
+    if (!cpuFramePaused && profiler.getLastFrame(frameStartNs, frameEndNs)) {
+        cpuFrameZones = profiler.collect(frameStartNs, frameEndNs);
+        cpuFrameStartNs = frameStartNs;
+        cpuFrameEndNs = frameEndNs;
     }
+
+    ImGui::Checkbox("Pause", &cpuFramePaused);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) {
+        lastCpuExportPath = profiler.exportCapture();
+        if (lastCpuExportPath.empty()) {
+            lastCpuExportPath = "export failed";
+        }
+    }
+    if (!lastCpuExportPath.empty()) {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(lastCpuExportPath.c_str());
+    }
+
+    const double frameNs = static_cast<double>(cpuFrameEndNs - cpuFrameStartNs);
+    if (frameNs <= 0.0) {
+        ImGui::Text("Waiting for a frame...");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("Frame: %.2f ms", frameNs * 1e-6);
+
+    // One lane per thread, zones stacked by depth and clipped to the frame
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    for (const auto& thread : cpuFrameZones) {
+        uint32_t maxDepth = 0;
+        for (const auto& zone : thread.zones) {
+            maxDepth = std::max(maxDepth, zone.depth);
+        }
+        ImGui::TextUnformatted(thread.threadName.c_str());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float laneHeight = (maxDepth + 1) * rowHeight;
+        ImGui::PushID(static_cast<int>(thread.threadId));
+        ImGui::InvisibleButton("lane", ImVec2(width, laneHeight));
+        ImGui::PopID();
+        const bool laneHovered = ImGui::IsItemHovered();
+        const ImVec2 mouse = io.MousePos;
+
+        for (const auto& zone : thread.zones) {
+            const double start = std::max(0.0, static_cast<double>(zone.startNs) - static_cast<double>(cpuFrameStartNs));
+            const double end = std::min(frameNs, static_cast<double>(zone.endNs) - static_cast<double>(cpuFrameStartNs));
+            const ImVec2 min(origin.x + static_cast<float>(start / frameNs) * width, origin.y + zone.depth * rowHeight);
+            const ImVec2 max(std::max(min.x + 1.0f, origin.x + static_cast<float>(end / frameNs) * width), min.y + rowHeight - 1.0f);
+
+            // Same name, same colour across frames
+            const float hue = static_cast<float>(std::hash<const void*>{}(zone.name) % 97) / 97.0f;
+            drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.45f, 0.75f));
+            if (max.x - min.x > 20.0f) {
+                const ImVec4 clip(min.x, min.y, max.x - 2.0f, max.y);
+                drawList->AddText(nullptr, 0.0f, ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), zone.name, nullptr, 0.0f, &clip);
+            }
+            if (laneHovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                ImGui::SetTooltip("%s\n%.3f ms", zone.name, static_cast<double>(zone.endNs - zone.startNs) * 1e-6);
+            }
+        }
+    }
+    ImGui::End();
+}
+#endif
+
+void ImGuiManager::onWindowResize(SwapChain& swapChain) {
+    // The old framebuffers wrap images of the retired swap chain that frames in flight still draw into
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
     framebuffers.clear();
     
     // Recreate framebuffers with new swap chain
@@ -3,10 +3,14 @@
 #include "device.hpp"
 #include "window.hpp"
 #include "swapchain.hpp"
+#include "gpu_profiler.hpp"
+#include "Engine/cpu_profiler.hpp"
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Rendering {
 
@@ -52,6 +56,12 @@ public:
      */
     void setFrameStats(float fps, float frameTime);
 
+    /**
+     * @brief Show per-pass GPU timings
+     * @param profiler Profiler owned by the renderer, null hides the window
+     */
+    void setGpuProfiler(GpuProfiler* profiler) { gpuProfiler = profiler; }
+
     /**
      * @brief Handle window resize
      * @param swapChain Reference to the new swap chain after resize
@@ -71,6 +81,10 @@ private:
     void beginFrame();
     void endFrame(VkCommandBuffer commandBuffer, uint32_t imageIndex);
     void renderFPSCounter();
+    void renderGpuTimings();
+#if CPU_PROFILER_ENABLED
+    void renderCpuFlameView();
+#endif
 
     Device& device;
     VkDescriptorPool imguiDescriptorPool{VK_NULL_HANDLE};
@@ -81,6 +95,19 @@ private:
     // Frame statistics
     float currentFPS{0.0f};
     float currentFrameTime{0.0f};
+
+    GpuProfiler* gpuProfiler{nullptr};
+    std::vector<float> gpuFrameTimes;   // plot scratch
+    std::string lastExportPath;
+
+#if CPU_PROFILER_ENABLED
+    // Last frame's zones of every thread, kept while paused
+    std::vector<Engine::CpuProfiler::ThreadZones> cpuFrameZones;
+    uint64_t cpuFrameStartNs{0};
+    uint64_t cpuFrameEndNs{0};
+    bool cpuFramePaused{false};
+    std::string lastCpuExportPath;
+#endif
 };
 
 } // namespace Rendering
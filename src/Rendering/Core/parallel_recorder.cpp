@@ -0,0 +1,128 @@
+#include "parallel_recorder.hpp"
+#include "Engine/cpu_profiler.hpp"
+
+#include <stdexcept>
+
+namespace Rendering {
+
+    ParallelRecorder::ParallelRecorder(Device& device, uint32_t threadCount)
+        : device{device}, workers{threadCount, "Recording"} {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = device.getGraphicsQueueFamily();
+        for (std::vector<WorkerPool>& slotPools : pools) {
+            slotPools.resize(workers.getThreadCount());
+            for (WorkerPool& workerPool : slotPools) {
+                if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &workerPool.pool) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to create recording command pool!");
+                }
+            }
+        }
+    }
+
+    ParallelRecorder::~ParallelRecorder() {
+        // Jobs of an unfinished frame still write into the pools
+        for (std::future<VkCommandBuffer>& job : pending) {
+            if (job.valid()) {
+                job.wait();
+            }
+        }
+        vkDeviceWaitIdle(device.getDevice());
+        for (std::vector<WorkerPool>& slotPools : pools) {
+            for (WorkerPool& workerPool : slotPools) {
+                vkDestroyCommandPool(device.getDevice(), workerPool.pool, nullptr);
+            }
+        }
+    }
+
+    void ParallelRecorder::beginFrame(size_t frameSlot) {
+        currentSlot = frameSlot;
+        pending.clear();
+        recorded.clear();
+        for (WorkerPool& workerPool : pools[frameSlot]) {
+            if (workerPool.used > 0) {
+                vkResetCommandPool(device.getDevice(), workerPool.pool, 0);
+                workerPool.used = 0;
+            }
+        }
+    }
+
+    ParallelRecorder::Job ParallelRecorder::record(const Inheritance& inheritance, RecordFunction function) {
+        const Job job = static_cast<Job>(pending.size());
+        pending.push_back(workers.submit([this, inheritance, function = std::move(function)]() {
+            return recordJob(inheritance, function);
+        }));
+        recorded.push_back(VK_NULL_HANDLE);
+        return job;
+    }
+
+    VkCommandBuffer ParallelRecorder::recordJob(const Inheritance& inheritance, const RecordFunction& function) {
+        CPU_PROFILE_ZONE("Record secondary");
+        // Only this worker touches its pool until the main thread waits for the frame's jobs
+        WorkerPool& workerPool = pools[currentSlot][Resources::ThreadPool::currentWorkerIndex()];
+        if (workerPool.used == workerPool.buffers.size()) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandPool = workerPool.pool;
+            allocInfo.commandBufferCount = 1;
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate secondary command buffer!");
+            }
+            workerPool.buffers.push_back(commandBuffer);
+        }
+        VkCommandBuffer commandBuffer = workerPool.buffers[workerPool.used++];
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = inheritance.renderPass;
+        inheritanceInfo.subpass = inheritance.subpass;
+        inheritanceInfo.framebuffer = inheritance.framebuffer;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin secondary command buffer!");
+        }
+        function(commandBuffer);
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to record secondary command buffer!");
+        }
+        return commandBuffer;
+    }
+
+    VkCommandBuffer ParallelRecorder::waitForJob(Job job) {
+        if (pending[job].valid()) {
+            recorded[job] = pending[job].get();
+        }
+        return recorded[job];
+    }
+
+    void ParallelRecorder::execute(VkCommandBuffer primary, const Job* jobs, uint32_t count) {
+        if (count == 0) {
+            return;
+        }
+        CPU_PROFILE_ZONE("Wait for secondaries");
+        executeScratch.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            executeScratch.push_back(waitForJob(jobs[i]));
+        }
+        vkCmdExecuteCommands(primary, count, executeScratch.data());
+    }
+
+    void ParallelRecorder::endFrame() {
+        // Wait for all of them before rethrowing, none may still be recording once the frame is abandoned
+        for (std::future<VkCommandBuffer>& job : pending) {
+            if (job.valid()) {
+                job.wait();
+            }
+        }
+        for (Job job = 0; job < pending.size(); ++job) {
+            waitForJob(job);
+        }
+    }
+}
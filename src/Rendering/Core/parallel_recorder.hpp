@@ -0,0 +1,69 @@
+#pragma once
+
+#include "device.hpp"
+#include "Rendering/rendering_constants.hpp"
+#include "Resources/thread_pool.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace Rendering {
+
+    // Records secondary command buffers on a worker pool. Every worker owns one command pool per frame in flight,
+    // reset when its frame slot comes around again, so jobs never share a pool and recording takes no lock.
+    // A job records the inside of one subpass: it sets its own viewport and scissor, binds its own pipeline and
+    // descriptor sets and draws. Render pass begin/end, barriers and GPU timestamps stay on the main thread, which
+    // executes the finished buffers in the order it queued them.
+    // Jobs read the frame context; nothing it holds may change between record() and endFrame().
+    class ParallelRecorder {
+    public:
+        using RecordFunction = std::function<void(VkCommandBuffer)>;
+        using Job = uint32_t;
+
+        struct Inheritance {
+            VkRenderPass renderPass;
+            uint32_t subpass;
+            VkFramebuffer framebuffer;
+        };
+
+        // 0 threads picks hardware_concurrency - 1
+        ParallelRecorder(Device& device, uint32_t threadCount = 0);
+        ~ParallelRecorder();
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+        // After the slot's fence: resets the slot's pools. Jobs of the previous frame must have been waited for
+        void beginFrame(size_t frameSlot);
+        // Queues a job recording into a secondary command buffer continuing inheritance's subpass
+        Job record(const Inheritance& inheritance, RecordFunction function);
+        // Waits for the jobs and executes their command buffers, in the given order, inside the primary's render
+        // pass, which has to have been begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+        void execute(VkCommandBuffer primary, const Job* jobs, uint32_t count);
+        // Waits for every job of the frame, executed or not; rethrows the first exception one of them threw
+        void endFrame();
+
+        uint32_t getThreadCount() const { return workers.getThreadCount(); }
+
+    private:
+        struct WorkerPool {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> buffers;   // allocated so far, reused after each reset
+            uint32_t used = 0;
+        };
+
+        VkCommandBuffer recordJob(const Inheritance& inheritance, const RecordFunction& function);
+        VkCommandBuffer waitForJob(Job job);
+
+        Device& device;
+        Resources::ThreadPool workers;
+        std::array<std::vector<WorkerPool>, MAX_FRAMES_IN_FLIGHT> pools;   // [frame slot][worker]
+        size_t currentSlot{0};
+        std::vector<std::future<VkCommandBuffer>> pending;    // per job of the frame, invalid once waited for
+        std::vector<VkCommandBuffer> recorded;
+        std::vector<VkCommandBuffer> executeScratch;
+    };
+}
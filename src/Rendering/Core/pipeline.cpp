@@ -1,4 +1,5 @@
 #include "pipeline.hpp"
+#include "Engine/cpu_profiler.hpp"
 #include <cassert>
 #include <fstream>
 #include <stdexcept>
@@ -14,7 +15,11 @@ Pipeline::Pipeline(
     const PipelineConfigInfo& configInfo)
     : device{device}, pipelineLayout{configInfo.pipelineLayout} {
 
-    createGraphicsPipeline(vertFilepath,geometryFilepath,fragFilepath, configInfo);
+    std::vector<ShaderStageInfo> stages;
+    if (vertFilepath.has_value()) stages.push_back({VK_SHADER_STAGE_VERTEX_BIT, vertFilepath.value()});
+    if (geometryFilepath.has_value()) stages.push_back({VK_SHADER_STAGE_GEOMETRY_BIT, geometryFilepath.value()});
+    if (fragFilepath.has_value()) stages.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, fragFilepath.value()});
+    startCreation(stages, configInfo);
 }
 
 
@@ -23,12 +28,48 @@ Pipeline::Pipeline(
     const std::vector<ShaderStageInfo>& shaderStages,
     const PipelineConfigInfo& configInfo)
     : device{device}, pipelineLayout{configInfo.pipelineLayout} {
-    createGraphicsPipeline(shaderStages, configInfo);
+    startCreation(shaderStages, configInfo);
 }
 
 
 Pipeline::~Pipeline() {
-    vkDestroyPipeline(device.getDevice(), graphicsPipeline, nullptr);
+    // The job writes graphicsPipeline; a failed one left it null
+    if (creation.valid()) {
+        creation.wait();
+    }
+    if (graphicsPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device.getDevice(), graphicsPipeline, nullptr);
+    }
+}
+
+void Pipeline::startCreation(const std::vector<ShaderStageInfo>& shaderStages, const PipelineConfigInfo& configInfo) {
+    assert(configInfo.pipelineLayout != VK_NULL_HANDLE && "Cannot create graphics pipeline: no pipelineLayout provided in configInfo");
+    assert(configInfo.renderPass != VK_NULL_HANDLE && "Cannot create graphics pipeline: no renderPass provided in configInfo");
+    assert(!shaderStages.empty() && "At least one shader stage must be provided for a graphics pipeline");
+
+    CreateJob job;
+    job.shaderStages = shaderStages;
+    job.configInfo = configInfo;
+    const VkPipelineColorBlendStateCreateInfo& colorBlendInfo = configInfo.colorBlendInfo;
+    if (colorBlendInfo.attachmentCount > 0 && colorBlendInfo.pAttachments != nullptr) {
+        job.colorBlendAttachments.assign(colorBlendInfo.pAttachments, colorBlendInfo.pAttachments + colorBlendInfo.attachmentCount);
+    }
+    const VkPipelineDynamicStateCreateInfo& dynamicStateInfo = configInfo.dynamicStateInfo;
+    if (dynamicStateInfo.dynamicStateCount > 0 && dynamicStateInfo.pDynamicStates != nullptr) {
+        job.dynamicStates.assign(dynamicStateInfo.pDynamicStates, dynamicStateInfo.pDynamicStates + dynamicStateInfo.dynamicStateCount);
+    }
+
+    creation = device.getPipelineCache().submit([this, job = std::move(job)]() mutable {
+        createGraphicsPipeline(job);
+    });
+}
+
+void Pipeline::waitUntilCreated() const {
+    std::call_once(created, [this]() {
+        if (creation.valid()) {
+            creation.get();
+        }
+    });
 }
 
 std::vector<char> Pipeline::readFile(const std::string& filepath) {
@@ -132,40 +173,20 @@ void Pipeline::createShaderModule(const std::vector<char>& code, VkShaderModule*
     }
     
 
-    void Pipeline::createGraphicsPipeline(
-        const std::optional<std::string>& vertFilepath,
-        const std::optional<std::string>& geometryFilepath ,
-        const std::optional<std::string>& fragFilepath,
-        const PipelineConfigInfo& configInfo){
-        assert(configInfo.pipelineLayout != VK_NULL_HANDLE && "Cannot create graphics pipeline: no pipelineLayout provided in configInfo");
-        assert(configInfo.renderPass != VK_NULL_HANDLE && "Cannot create graphics pipeline: no renderPass provided in configInfo");
-        
-        // Check if optionals have values and get their sizes correctly
-        bool hasVertShader = vertFilepath.has_value();
-        bool hasGeometryShader = geometryFilepath.has_value();
-        bool hasFragShader = fragFilepath.has_value();
-        
-        std::vector<ShaderStageInfo> stages;
-        if (hasVertShader) stages.push_back({VK_SHADER_STAGE_VERTEX_BIT, vertFilepath.value()});
-        if (hasGeometryShader) stages.push_back({VK_SHADER_STAGE_GEOMETRY_BIT, geometryFilepath.value()});
-        if (hasFragShader) stages.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, fragFilepath.value()});
-        createGraphicsPipeline(stages, configInfo);
-    }
-
-    void Pipeline::createGraphicsPipeline(
-        const std::vector<ShaderStageInfo>& shaderStageInfos,
-        const PipelineConfigInfo& configInfo){
-        assert(configInfo.pipelineLayout != VK_NULL_HANDLE && "Cannot create graphics pipeline: no pipelineLayout provided in configInfo");
-        assert(configInfo.renderPass != VK_NULL_HANDLE && "Cannot create graphics pipeline: no renderPass provided in configInfo");
-        assert(!shaderStageInfos.empty() && "At least one shader stage must be provided for a graphics pipeline");
+    void Pipeline::createGraphicsPipeline(CreateJob& job){
+        CPU_PROFILE_ZONE("Create graphics pipeline");
+        PipelineConfigInfo& configInfo = job.configInfo;
+        // The copies point into the caller's arrays
+        configInfo.colorBlendInfo.pAttachments = job.colorBlendAttachments.empty() ? nullptr : job.colorBlendAttachments.data();
+        configInfo.dynamicStateInfo.pDynamicStates = job.dynamicStates.empty() ? nullptr : job.dynamicStates.data();
 
         // Load and create shader modules
         std::vector<VkShaderModule> shaderModules;
-        shaderModules.reserve(shaderStageInfos.size());
+        shaderModules.reserve(job.shaderStages.size());
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
-        shaderStages.reserve(shaderStageInfos.size());
+        shaderStages.reserve(job.shaderStages.size());
 
-        for (const auto& stageInfo : shaderStageInfos) {
+        for (const auto& stageInfo : job.shaderStages) {
             auto code = readFile(stageInfo.spirvFilepath);
             VkShaderModule module{VK_NULL_HANDLE};
             createShaderModule(code, &module);
@@ -210,7 +231,7 @@ void Pipeline::createShaderModule(const std::vector<char>& code, VkShaderModule*
         pipelineInfo.basePipelineIndex = -1;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-        if (vkCreateGraphicsPipelines(device.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(device.getDevice(), device.getPipelineCache().getCache(), 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
             // Cleanup modules before throwing
             for (auto m : shaderModules) {
                 vkDestroyShaderModule(device.getDevice(), m, nullptr);
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <future>
+#include <mutex>
 #include "Rendering/Resources/mesh.hpp"
 
 namespace Rendering {
@@ -90,28 +92,36 @@ public:
     Pipeline(const Pipeline&) = delete;
     Pipeline& operator=(const Pipeline&) = delete;
 
-    VkPipeline getPipeline() const { return graphicsPipeline; }
+    // Creation runs on the pipeline cache's workers: the constructor copies the config and the arrays it points to,
+    // so they may go away once it returns, while the layout and render pass must outlive the pipeline.
+    // Waits for the creation job the first time, from any thread; rethrows what it threw
+    VkPipeline getPipeline() const { waitUntilCreated(); return graphicsPipeline; }
     VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
 
     static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
 
 private:
+    // Copy of everything vkCreateGraphicsPipelines reads, owned by the creation job
+    struct CreateJob {
+        std::vector<ShaderStageInfo> shaderStages;
+        PipelineConfigInfo configInfo;
+        std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments;
+        std::vector<VkDynamicState> dynamicStates;
+    };
+
     static std::vector<char> readFile(const std::string& filepath);
 
-    void createGraphicsPipeline(
-        const std::optional<std::string>& vertFilepath,
-        const std::optional<std::string>& geometryFilepath,
-        const std::optional<std::string>& fragFilepath,
-        const PipelineConfigInfo& configInfo);
+    void startCreation(const std::vector<ShaderStageInfo>& shaderStages, const PipelineConfigInfo& configInfo);
+    void waitUntilCreated() const;
 
-    void createGraphicsPipeline(
-        const std::vector<ShaderStageInfo>& shaderStages,
-        const PipelineConfigInfo& configInfo);
+    void createGraphicsPipeline(CreateJob& job);
 
     void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
     
     Device& device;
-    VkPipeline graphicsPipeline;
+    VkPipeline graphicsPipeline{VK_NULL_HANDLE};
     VkPipelineLayout pipelineLayout;  // Store just the layout instead of entire config
+    mutable std::future<void> creation;
+    mutable std::once_flag created;
 };
 }  // namespace lve 
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "pipeline_cache.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Rendering {
+
+    namespace {
+        uint64_t hashData(const char* data, size_t size) {
+            uint64_t hash = 14695981039346656037ull;    // FNV-1a
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    }
+
+    PipelineCache::PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties)
+        : device{device}, properties{properties}, workers{PIPELINE_COMPILE_THREADS, "Pipelines"} {
+        load();
+    }
+
+    PipelineCache::~PipelineCache() {
+        save();
+        vkDestroyPipelineCache(device, cache, nullptr);
+    }
+
+    void PipelineCache::load() {
+        std::vector<char> initialData;
+        if (PIPELINE_CACHE_ENABLED) {
+            std::error_code error;
+            const uintmax_t fileSize = std::filesystem::file_size(PIPELINE_CACHE_PATH, error);
+            std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary);
+            PipelineCacheFileHeader header{};
+            if (!error && file && file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                header.dataSize == fileSize - sizeof(header) &&
+                header.magic == PIPELINE_CACHE_MAGIC && header.version == PIPELINE_CACHE_VERSION &&
+                header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+                header.driverVersion == properties.driverVersion &&
+                std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0) {
+                initialData.resize(header.dataSize);
+                if (!file.read(initialData.data(), static_cast<std::streamsize>(initialData.size())) ||
+                    hashData(initialData.data(), initialData.size()) != header.dataHash) {
+                    initialData.clear();
+                }
+            }
+        }
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = initialData.size();
+        cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+        if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline cache!");
+        }
+        std::cout << "Pipeline cache: " << (initialData.empty() ? "empty" : "loaded " +
+                     std::to_string(initialData.size() / 1024) + " KB") << std::endl;
+    }
+
+    bool PipelineCache::save() const {
+        if (!PIPELINE_CACHE_ENABLED) {
+            return false;
+        }
+        size_t dataSize = 0;
+        if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+            return false;
+        }
+        std::vector<char> data(dataSize);
+        if (vkGetPipelineCacheData(device, cache, &dataSize, data.data()) != VK_SUCCESS) {
+            return false;
+        }
+        data.resize(dataSize);
+
+        PipelineCacheFileHeader header{};
+        header.magic = PIPELINE_CACHE_MAGIC;
+        header.version = PIPELINE_CACHE_VERSION;
+        header.vendorID = properties.vendorID;
+        header.deviceID = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+        header.dataSize = data.size();
+        header.dataHash = hashData(data.data(), data.size());
+
+        // Written next to the old file and renamed over it, so a crash mid-write leaves the previous cache
+        const std::filesystem::path path{PIPELINE_CACHE_PATH};
+        const std::filesystem::path tempPath{path.string() + ".tmp"};
+        std::error_code error;
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+                !file.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+                std::cerr << "Failed to write pipeline cache " << tempPath.string() << std::endl;
+                file.close();
+                std::filesystem::remove(tempPath, error);
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace Rendering
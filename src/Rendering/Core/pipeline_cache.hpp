@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core.hpp"
+#include "Resources/thread_pool.hpp"
+
+#include <cstdint>
+#include <future>
+#include <utility>
+
+namespace Rendering {
+
+    // File written in front of the driver's cache data. The driver checks its own header too, but not the driver
+    // version, and some drivers crash on a blob they should reject; anything that does not match is discarded.
+    struct PipelineCacheFileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+    // The device's VkPipelineCache, shared by every graphics and compute pipeline (and ImGui's), plus the workers
+    // pipelines are created on. VkPipelineCache is internally synchronized, so creation jobs use it concurrently.
+    // Loaded from PIPELINE_CACHE_PATH when the file was written by the same device and driver, saved on destruction
+    class PipelineCache {
+    public:
+        PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties);
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        VkPipelineCache getCache() const { return cache; }
+
+        // Runs a pipeline creation job on the workers. Everything the job reads must outlive the returned future
+        template <typename F>
+        std::future<void> submit(F&& job) { return workers.submit(std::forward<F>(job)); }
+
+        // Writes the current contents; failures are logged, the cache is only an accelerator
+        bool save() const;
+
+    private:
+        void load();
+
+        VkDevice device;
+        VkPhysicalDeviceProperties properties;
+        VkPipelineCache cache{VK_NULL_HANDLE};
+        Resources::ThreadPool workers;
+    };
+
+} // namespace Rendering
@@ -0,0 +1,606 @@
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace Rendering {
+
+    namespace {
+        constexpr VkAccessFlags WRITE_ACCESS_MASK =
+            VK_ACCESS_SHADER_WRITE_BIT |
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_TRANSFER_WRITE_BIT |
+            VK_ACCESS_HOST_WRITE_BIT |
+            VK_ACCESS_MEMORY_WRITE_BIT;
+
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+            return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+        }
+    }
+
+    RenderGraph::ImageUsage RenderGraph::colorTarget(VkImageLayout finalLayout) {
+        // Read as well: transparency and composition blend into what they cleared
+        return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED, finalLayout};
+    }
+
+    RenderGraph::ImageUsage RenderGraph::colorTargetLoad(VkImageLayout layout, VkImageLayout finalLayout) {
+        return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                layout, finalLayout};
+    }
+
+    RenderGraph::ImageUsage RenderGraph::depthTarget(VkImageLayout finalLayout) {
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED, finalLayout};
+    }
+
+    RenderGraph::ImageUsage RenderGraph::depthTest() {
+        return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_UNDEFINED};
+    }
+
+    RenderGraph::ImageUsage RenderGraph::sampled(VkPipelineStageFlags stages, VkImageLayout layout) {
+        return {stages, VK_ACCESS_SHADER_READ_BIT, layout, VK_IMAGE_LAYOUT_UNDEFINED};
+    }
+
+    RenderGraph::ImageUsage RenderGraph::storage(VkPipelineStageFlags stages, VkImageLayout finalLayout) {
+        return {stages, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, finalLayout};
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(ResourceHandle resource, const ImageUsage& usage) {
+        graph.addUse(pass, resource, usage, false);
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(ResourceHandle resource, const ImageUsage& usage) {
+        graph.addUse(pass, resource, usage, true);
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffects() {
+        graph.passes[pass].hasSideEffects = true;
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::asyncCompute() {
+        graph.passes[pass].asyncCompute = true;
+        return *this;
+    }
+
+    RenderGraph::ResourceHandle RenderGraph::importImage(const std::string& name, const ImageDesc& desc) {
+        Resource resource{};
+        resource.name = name;
+        resource.desc = desc;
+        resources.push_back(std::move(resource));
+        compiled = false;
+        return static_cast<ResourceHandle>(resources.size() - 1);
+    }
+
+    RenderGraph::ResourceHandle RenderGraph::createTransientImage(const std::string& name, VkImageAspectFlags aspect) {
+        ImageDesc desc{};
+        desc.aspect = aspect;
+        const ResourceHandle handle = importImage(name, desc);
+        resources[handle].transient = true;
+        return handle;
+    }
+
+    void RenderGraph::markOutput(ResourceHandle resource) {
+        if (resource >= resources.size()) {
+            throw std::runtime_error("render graph: unknown output resource");
+        }
+        resources[resource].output = true;
+        compiled = false;
+    }
+
+    RenderGraph::PassBuilder RenderGraph::addPass(const char* name, ExecuteFunction execute) {
+        Pass pass{};
+        pass.name = name;
+        pass.execute = std::move(execute);
+        passes.push_back(std::move(pass));
+        compiled = false;
+        return PassBuilder(*this, static_cast<uint32_t>(passes.size() - 1));
+    }
+
+    void RenderGraph::addUse(uint32_t pass, ResourceHandle resource, const ImageUsage& usage, bool write) {
+        if (resource >= resources.size()) {
+            throw std::runtime_error(std::string("render graph: pass ") + passes[pass].name + " uses an unknown resource");
+        }
+        for (const PassUse& use : passes[pass].uses) {
+            if (use.resource == resource) {
+                throw std::runtime_error(std::string("render graph: pass ") + passes[pass].name + " uses " +
+                                         resources[resource].name + " twice");
+            }
+        }
+        passes[pass].uses.push_back({resource, usage, write});
+        compiled = false;
+    }
+
+    RenderGraph::ResourceHandle RenderGraph::findResource(const std::string& name) const {
+        for (size_t i = 0; i < resources.size(); ++i) {
+            if (resources[i].name == name) {
+                return static_cast<ResourceHandle>(i);
+            }
+        }
+        return INVALID_RESOURCE;
+    }
+
+    void RenderGraph::compile() {
+        cullPasses();
+        findAsyncRange();
+        computeLifetimes();
+        for (Resource& resource : resources) {
+            resource.aliasedAfter.clear();
+        }
+        transientMemorySaved = 0;
+        buildBarriers();
+        compiled = true;
+
+        std::cout << "Render graph: " << passes.size() << " passes, " << getCulledPassCount() << " culled, "
+                  << getBarrierCount() << " barriers per frame" << std::endl;
+        for (const Pass& pass : passes) {
+            if (pass.culled) {
+                std::cout << "  culled " << pass.name << ": nothing consumes its results" << std::endl;
+            }
+        }
+        if (usesAsyncCompute()) {
+            std::cout << "  " << passes[asyncPass].name << " on the async compute queue, joined before "
+                      << (joinPass < passes.size() ? passes[joinPass].name : "the end of the frame") << std::endl;
+        }
+    }
+
+    void RenderGraph::cullPasses() {
+        // Walk back from what leaves the frame: a pass is kept when a later kept pass (or the frame's output)
+        // consumes something it writes. A write that loads keeps the earlier writers alive, one that discards ends
+        // the value's lifetime
+        std::vector<bool> live(resources.size(), false);
+        for (size_t i = 0; i < resources.size(); ++i) {
+            live[i] = resources[i].output;
+        }
+        for (size_t p = passes.size(); p-- > 0;) {
+            Pass& pass = passes[p];
+            bool needed = pass.hasSideEffects;
+            for (const PassUse& use : pass.uses) {
+                needed |= use.write && live[use.resource];
+            }
+            pass.culled = !needed;
+            if (!needed) {
+                continue;
+            }
+            for (const PassUse& use : pass.uses) {
+                if (use.write && use.usage.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+                    live[use.resource] = false;
+                }
+            }
+            for (const PassUse& use : pass.uses) {
+                if (!use.write || use.usage.layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                    live[use.resource] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::findAsyncRange() {
+        asyncPass = NO_PASS;
+        joinPass = NO_PASS;
+        uint32_t asyncPassCount = 0;
+        for (uint32_t p = 0; p < passes.size(); ++p) {
+            if (!passes[p].asyncCompute) {
+                continue;
+            }
+            ++asyncPassCount;
+            if (asyncComputeEnabled && !passes[p].culled) {
+                asyncPass = p;
+            }
+        }
+        if (asyncPassCount > 1) {
+            throw std::runtime_error("render graph: only one pass can run on the async compute queue");
+        }
+        if (asyncPass == NO_PASS) {
+            return;
+        }
+
+        // The join is the first later pass that conflicts with the async one: it touches an image the async pass
+        // writes, writes one it reads, or needs one in another layout. Passes before it run alongside
+        joinPass = static_cast<uint32_t>(passes.size());
+        for (uint32_t p = asyncPass + 1; p < passes.size() && joinPass == passes.size(); ++p) {
+            if (passes[p].culled) {
+                continue;
+            }
+            for (const PassUse& use : passes[p].uses) {
+                for (const PassUse& asyncUse : passes[asyncPass].uses) {
+                    if (use.resource == asyncUse.resource &&
+                        (use.write || asyncUse.write || use.usage.layout != asyncUse.usage.layout)) {
+                        joinPass = p;
+                    }
+                }
+            }
+        }
+    }
+
+    void RenderGraph::computeLifetimes() {
+        for (Resource& resource : resources) {
+            resource.firstPass = UINT32_MAX;
+            resource.lastPass = 0;
+        }
+        for (uint32_t p = 0; p < passes.size(); ++p) {
+            if (passes[p].culled) {
+                continue;
+            }
+            for (const PassUse& use : passes[p].uses) {
+                Resource& resource = resources[use.resource];
+                resource.firstPass = std::min(resource.firstPass, p);
+                resource.lastPass = std::max(resource.lastPass, p);
+            }
+        }
+        if (usesAsyncCompute()) {
+            // The async pass may still be running until the join: its images must not share memory with
+            // anything the parallel passes use
+            for (const PassUse& use : passes[asyncPass].uses) {
+                Resource& resource = resources[use.resource];
+                resource.lastPass = std::max(resource.lastPass, joinPass - 1);
+            }
+        }
+        for (const Resource& resource : resources) {
+            if (!resource.transient || resource.firstPass == UINT32_MAX) {
+                continue;
+            }
+            const Pass& first = passes[resource.firstPass];
+            for (const PassUse& use : first.uses) {
+                if (use.resource == static_cast<ResourceHandle>(&resource - resources.data()) && !use.write) {
+                    throw std::runtime_error("render graph: transient " + resource.name + " is read by " +
+                                             first.name + " before any pass writes it");
+                }
+            }
+        }
+    }
+
+    RenderGraph::ResourceState RenderGraph::frameStartState(const Resource& resource,
+                                                            const ResourceState& previousEnd) const {
+        ResourceState state{};
+        if (resource.transient || resource.desc.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+            return state;
+        }
+        if (resource.desc.initialStages != 0) {
+            state.layout = resource.desc.initialLayout;
+            state.writeStages = resource.desc.initialStages;
+            state.writeAccess = resource.desc.initialAccess;
+            return state;
+        }
+        state = previousEnd;
+        if (state.layout != resource.desc.initialLayout) {
+            // Put back by endOfFrameBarrier
+            state.layout = resource.desc.initialLayout;
+            state.writeStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            state.writeAccess = 0;
+            state.visibleStages = 0;
+            state.readStages = 0;
+        }
+        return state;
+    }
+
+    void RenderGraph::applyUse(BarrierBatch& batch, ResourceState& state, const PassUse& use) const {
+        const ImageUsage& usage = use.usage;
+        const VkPipelineStageFlags hazards = state.writeStages | state.readStages;
+        const bool transition = usage.layout != VK_IMAGE_LAYOUT_UNDEFINED && usage.layout != state.layout;
+
+        if (transition) {
+            // A layout transition writes the image: it waits for every access since the last write as well
+            batch.transitions.push_back({use.resource, state.layout, usage.layout, state.writeAccess, usage.access});
+            batch.srcStages |= hazards != 0 ? hazards : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            batch.dstStages |= usage.stages;
+        }
+
+        if (use.write) {
+            if (!transition && hazards != 0) {
+                batch.srcStages |= hazards;
+                batch.srcAccess |= state.writeAccess;
+                batch.dstStages |= usage.stages;
+                batch.dstAccess |= usage.access;
+            }
+            if (usage.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                state.layout = usage.finalLayout;
+            } else if (usage.layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+                state.layout = usage.layout;
+            }
+            state.writeStages = usage.stages;
+            state.writeAccess = usage.access & WRITE_ACCESS_MASK;
+            state.visibleStages = 0;
+            state.readStages = 0;
+            return;
+        }
+
+        if (transition) {
+            state.layout = usage.layout;
+            state.writeStages = usage.stages;
+            state.writeAccess = 0;
+            state.visibleStages = usage.stages;
+            state.readStages = usage.stages;
+            return;
+        }
+        // Read after read needs nothing; read after write once per stage
+        if (state.writeStages != 0 && (usage.stages & ~state.visibleStages) != 0) {
+            batch.srcStages |= state.writeStages;
+            batch.srcAccess |= state.writeAccess;
+            batch.dstStages |= usage.stages;
+            batch.dstAccess |= usage.access;
+            state.visibleStages |= usage.stages;
+        }
+        state.readStages |= usage.stages;
+    }
+
+    void RenderGraph::buildBarriers() {
+        // The frame is simulated twice: the first run settles the state persistent images are left in, the
+        // second starts from it and is what gets recorded, so the first pass also waits on the previous frame
+        std::vector<ResourceState> states(resources.size());
+        for (size_t i = 0; i < resources.size(); ++i) {
+            const ImageDesc& desc = resources[i].desc;
+            if (!resources[i].transient) {
+                states[i].layout = desc.initialLayout;
+                states[i].writeStages = desc.initialStages;
+                states[i].writeAccess = desc.initialAccess;
+            }
+        }
+
+        for (int run = 0; run < 2; ++run) {
+            const bool recorded = run == 1;
+            if (recorded) {
+                for (size_t i = 0; i < resources.size(); ++i) {
+                    states[i] = frameStartState(resources[i], states[i]);
+                }
+            }
+            std::vector<bool> touched(resources.size(), false);
+            for (Pass& pass : passes) {
+                if (pass.culled) {
+                    continue;
+                }
+                BarrierBatch batch{};
+                for (const PassUse& use : pass.uses) {
+                    ResourceState& state = states[use.resource];
+                    const Resource& resource = resources[use.resource];
+                    if (resource.transient && !touched[use.resource]) {
+                        // Memory shared with transients used earlier in the frame: their accesses come first
+                        for (ResourceHandle previous : resource.aliasedAfter) {
+                            state.writeStages |= states[previous].writeStages | states[previous].readStages;
+                            state.writeAccess |= states[previous].writeAccess;
+                        }
+                    }
+                    touched[use.resource] = true;
+                    applyUse(batch, state, use);
+                }
+                if (recorded) {
+                    pass.barrier = std::move(batch);
+                }
+            }
+        }
+
+        endOfFrameBarrier = BarrierBatch{};
+        for (size_t i = 0; i < resources.size(); ++i) {
+            const Resource& resource = resources[i];
+            if (resource.transient || resource.desc.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+                resource.desc.initialStages != 0 || states[i].layout == resource.desc.initialLayout) {
+                continue;
+            }
+            const ResourceState& state = states[i];
+            const VkPipelineStageFlags hazards = state.writeStages | state.readStages;
+            endOfFrameBarrier.transitions.push_back(
+                {static_cast<ResourceHandle>(i), state.layout, resource.desc.initialLayout, state.writeAccess, 0});
+            endOfFrameBarrier.srcStages |= hazards != 0 ? hazards : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            endOfFrameBarrier.dstStages |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+    }
+
+    RenderGraph::TransientMemoryPlan RenderGraph::planTransientMemory(const std::vector<TransientRequest>& requests) {
+        if (!compiled) {
+            throw std::runtime_error("render graph: planTransientMemory before compile");
+        }
+        for (Resource& resource : resources) {
+            resource.aliasedAfter.clear();
+        }
+
+        auto overlaps = [&](ResourceHandle a, ResourceHandle b) {
+            const Resource& first = resources[a];
+            const Resource& second = resources[b];
+            // Transients no live pass uses keep memory of their own
+            if (a == b || first.firstPass == UINT32_MAX || second.firstPass == UINT32_MAX) {
+                return true;
+            }
+            return !(first.lastPass < second.firstPass || second.lastPass < first.firstPass);
+        };
+
+        struct Bucket {
+            uint32_t memoryTypeBits;
+            VkDeviceSize size;
+            VkDeviceSize alignment;
+            std::vector<uint32_t> members;   // request indices, all at the bucket's offset
+        };
+        std::vector<Bucket> buckets;
+
+        // Largest first, so smaller images fit under ones already placed
+        std::vector<uint32_t> order(requests.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return requests[a].requirements.size > requests[b].requirements.size;
+        });
+
+        TransientMemoryPlan plan{};
+        plan.placements.resize(requests.size());
+        for (uint32_t index : order) {
+            const TransientRequest& request = requests[index];
+            if (request.resource >= resources.size() || !resources[request.resource].transient) {
+                throw std::runtime_error("render graph: memory requested for a resource that is not transient");
+            }
+            plan.requestedSize += request.requirements.size;
+
+            Bucket* target = nullptr;
+            for (Bucket& bucket : buckets) {
+                if ((bucket.memoryTypeBits & request.requirements.memoryTypeBits) == 0) {
+                    continue;
+                }
+                const bool fits = std::none_of(bucket.members.begin(), bucket.members.end(), [&](uint32_t member) {
+                    return overlaps(requests[member].resource, request.resource);
+                });
+                if (fits) {
+                    target = &bucket;
+                    break;
+                }
+            }
+            if (target == nullptr) {
+                buckets.push_back({request.requirements.memoryTypeBits, 0, 1, {}});
+                target = &buckets.back();
+            }
+            target->memoryTypeBits &= request.requirements.memoryTypeBits;
+            target->size = std::max(target->size, request.requirements.size);
+            target->alignment = std::max(target->alignment, request.requirements.alignment);
+            target->members.push_back(index);
+        }
+
+        for (Bucket& bucket : buckets) {
+            uint32_t heap = 0;
+            while (heap < plan.heapSizes.size() && (plan.heapMemoryTypeBits[heap] & bucket.memoryTypeBits) == 0) {
+                ++heap;
+            }
+            if (heap == plan.heapSizes.size()) {
+                plan.heapSizes.push_back(0);
+                plan.heapMemoryTypeBits.push_back(bucket.memoryTypeBits);
+            }
+            const VkDeviceSize offset = alignUp(plan.heapSizes[heap], bucket.alignment);
+            plan.heapSizes[heap] = offset + bucket.size;
+            plan.heapMemoryTypeBits[heap] &= bucket.memoryTypeBits;
+            for (uint32_t member : bucket.members) {
+                plan.placements[member] = {heap, offset};
+            }
+
+            // Members in the order the frame uses them; each takes the memory over from the one before
+            std::sort(bucket.members.begin(), bucket.members.end(), [&](uint32_t a, uint32_t b) {
+                return resources[requests[a].resource].firstPass < resources[requests[b].resource].firstPass;
+            });
+            for (size_t i = 1; i < bucket.members.size(); ++i) {
+                const ResourceHandle previous = requests[bucket.members[i - 1]].resource;
+                std::vector<ResourceHandle>& aliasedAfter = resources[requests[bucket.members[i]].resource].aliasedAfter;
+                if (std::find(aliasedAfter.begin(), aliasedAfter.end(), previous) == aliasedAfter.end()) {
+                    aliasedAfter.push_back(previous);
+                }
+            }
+        }
+
+        plan.allocatedSize = std::accumulate(plan.heapSizes.begin(), plan.heapSizes.end(), VkDeviceSize{0});
+        transientMemorySaved = plan.requestedSize > plan.allocatedSize ? plan.requestedSize - plan.allocatedSize : 0;
+        buildBarriers();
+        return plan;
+    }
+
+    void RenderGraph::bindImage(ResourceHandle resource, VkImage image) {
+        bindImages(resource, &image, image != VK_NULL_HANDLE ? 1u : 0u);
+    }
+
+    void RenderGraph::bindImages(ResourceHandle resource, const VkImage* images, uint32_t count) {
+        std::vector<VkImage>& bound = resources[resource].images;
+        bound.assign(images, images + count);
+    }
+
+    void RenderGraph::execute(FrameContext& frameContext, const QueueCommandBuffers* queueCommandBuffers) {
+        if (!compiled) {
+            throw std::runtime_error("render graph: execute before compile");
+        }
+        if (usesAsyncCompute() && queueCommandBuffers == nullptr) {
+            throw std::runtime_error("render graph: async compute needs the frame's queue command buffers");
+        }
+        const VkCommandBuffer prologue = frameContext.commandBuffer;
+        for (uint32_t p = 0; p < passes.size(); ++p) {
+            Pass& pass = passes[p];
+            if (pass.culled) {
+                continue;
+            }
+            if (usesAsyncCompute()) {
+                frameContext.commandBuffer = p < asyncPass  ? prologue :
+                                             p == asyncPass ? queueCommandBuffers->compute :
+                                             p < joinPass   ? queueCommandBuffers->parallel :
+                                                              queueCommandBuffers->join;
+            }
+            // Same-family queues: barriers before the async pass may name graphics stages, the semaphore
+            // handoff orders the other queue's work and these cover the compute queue's own
+            record(frameContext.commandBuffer, pass.barrier);
+
+            bool writes = false;
+            bool boundWrite = false;
+            for (const PassUse& use : pass.uses) {
+                if (use.write) {
+                    writes = true;
+                    boundWrite |= !resources[use.resource].images.empty();
+                }
+            }
+            // Nothing to render into this frame (no shadow views); its barrier still keeps the states in step
+            if (writes && !boundWrite && !pass.hasSideEffects) {
+                continue;
+            }
+            pass.execute(frameContext);
+        }
+        if (usesAsyncCompute()) {
+            frameContext.commandBuffer = queueCommandBuffers->join;
+        }
+        record(frameContext.commandBuffer, endOfFrameBarrier);
+    }
+
+    void RenderGraph::record(VkCommandBuffer commandBuffer, const BarrierBatch& batch) {
+        if (batch.empty()) {
+            return;
+        }
+        imageBarrierScratch.clear();
+        for (const ImageTransition& transition : batch.transitions) {
+            const Resource& resource = resources[transition.resource];
+            for (VkImage image : resource.images) {
+                VkImageMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.srcAccessMask = transition.srcAccess;
+                barrier.dstAccessMask = transition.dstAccess;
+                barrier.oldLayout = transition.oldLayout;
+                barrier.newLayout = transition.newLayout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = image;
+                barrier.subresourceRange.aspectMask = resource.desc.aspect;
+                barrier.subresourceRange.baseMipLevel = 0;
+                barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+                barrier.subresourceRange.baseArrayLayer = 0;
+                barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+                imageBarrierScratch.push_back(barrier);
+            }
+        }
+
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = batch.srcAccess;
+        memoryBarrier.dstAccessMask = batch.dstAccess;
+        const bool hasMemoryBarrier = batch.srcAccess != 0 || batch.dstAccess != 0;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            batch.srcStages,
+            batch.dstStages,
+            0,
+            hasMemoryBarrier ? 1u : 0u, hasMemoryBarrier ? &memoryBarrier : nullptr,
+            0, nullptr,
+            static_cast<uint32_t>(imageBarrierScratch.size()), imageBarrierScratch.data()
+        );
+    }
+
+    uint32_t RenderGraph::getCulledPassCount() const {
+        return static_cast<uint32_t>(std::count_if(passes.begin(), passes.end(),
+                                                   [](const Pass& pass) { return pass.culled; }));
+    }
+
+    uint32_t RenderGraph::getBarrierCount() const {
+        uint32_t count = endOfFrameBarrier.empty() ? 0u : 1u;
+        for (const Pass& pass : passes) {
+            count += (!pass.culled && !pass.barrier.empty()) ? 1u : 0u;
+        }
+        return count;
+    }
+}
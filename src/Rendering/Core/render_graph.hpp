@@ -0,0 +1,215 @@
+#pragma once
+
+#include "device.hpp"
+#include "frame_context.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Rendering {
+
+    // Frame graph over the renderer's passes. Passes are declared once, in execution order, with the images they
+    // read and write; compile() culls passes whose results nobody consumes and derives, per pass, the barrier that
+    // has to precede it. Each frame the renderer binds the frame context's images to the graph's resources and
+    // execute() records one merged vkCmdPipelineBarrier before every pass: image barriers only where the layout
+    // changes, everything else folded into a single global memory barrier. Transient resources live within one
+    // frame; planTransientMemory() packs the ones whose pass ranges do not overlap into shared memory.
+    // Barriers inside a pass (mip chains, compute passes feeding each other, host readbacks) stay with the pass.
+    // With async compute one compute-only pass is recorded into its own command buffer for a second queue; the
+    // graphics passes up to the first one that depends on it go into a parallel command buffer, the rest into a
+    // join command buffer that the caller submits after waiting on the compute work.
+    // Only used from the render thread.
+    class RenderGraph {
+    public:
+        using ResourceHandle = uint32_t;
+        static constexpr ResourceHandle INVALID_RESOURCE = UINT32_MAX;
+
+        struct ImageDesc {
+            VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            // Layout the image is in when the graph first sees it. UNDEFINED: contents are not carried from one
+            // frame to the next (swapchain images), so every frame starts without hazards
+            VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            // Non-zero for images written outside this frame's graph, such as the previous frame's output read as
+            // history: the frame then always starts from this access instead of the end of the previous frame
+            VkPipelineStageFlags initialStages = 0;
+            VkAccessFlags initialAccess = 0;
+        };
+
+        // How a pass touches an image. layout is what the pass needs when it starts; UNDEFINED means the pass
+        // discards the contents itself (a render pass clearing from UNDEFINED) and the graph only orders it.
+        // finalLayout is what the pass leaves behind, UNDEFINED when it keeps layout
+        struct ImageUsage {
+            VkPipelineStageFlags stages = 0;
+            VkAccessFlags access = 0;
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        };
+
+        // Common usages of the renderer's passes
+        static ImageUsage colorTarget(VkImageLayout finalLayout);                      // cleared color attachment
+        static ImageUsage colorTargetLoad(VkImageLayout layout, VkImageLayout finalLayout);
+        static ImageUsage depthTarget(VkImageLayout finalLayout);                      // cleared depth attachment
+        static ImageUsage depthTest();                                                 // read-only depth attachment
+        static ImageUsage sampled(VkPipelineStageFlags stages,
+                                  VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        static ImageUsage storage(VkPipelineStageFlags stages,
+                                  VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED); // GENERAL read/write
+
+        using ExecuteFunction = std::function<void(FrameContext&)>;
+
+        class PassBuilder {
+        public:
+            // One use per resource and pass; a pass that loads and writes an image declares the write
+            PassBuilder& read(ResourceHandle resource, const ImageUsage& usage);
+            PassBuilder& write(ResourceHandle resource, const ImageUsage& usage);
+            // Never culled, for passes with results outside the graph (host readbacks, buffers)
+            PassBuilder& sideEffects();
+            // Runs on the async compute queue when the graph was compiled with async compute; one pass at most
+            PassBuilder& asyncCompute();
+
+        private:
+            friend class RenderGraph;
+            PassBuilder(RenderGraph& graph, uint32_t pass) : graph{graph}, pass{pass} {}
+            RenderGraph& graph;
+            uint32_t pass;
+        };
+
+        struct TransientRequest {
+            ResourceHandle resource;
+            VkMemoryRequirements requirements;
+        };
+        struct TransientPlacement {
+            uint32_t heap;
+            VkDeviceSize offset;
+        };
+        // Placements follow the request order; each heap is one allocation per frame in flight
+        struct TransientMemoryPlan {
+            std::vector<TransientPlacement> placements;
+            std::vector<VkDeviceSize> heapSizes;
+            std::vector<uint32_t> heapMemoryTypeBits;
+            VkDeviceSize requestedSize = 0;   // what the requests take in separate allocations
+            VkDeviceSize allocatedSize = 0;   // sum of the heaps
+        };
+
+        // Command buffers of one frame besides the caller's, all begun by the caller. execute() points
+        // frameContext.commandBuffer at each in turn and leaves it at join
+        struct QueueCommandBuffers {
+            VkCommandBuffer compute = VK_NULL_HANDLE;    // the async pass
+            VkCommandBuffer parallel = VK_NULL_HANDLE;   // graphics passes not depending on it
+            VkCommandBuffer join = VK_NULL_HANDLE;       // from the first graphics pass that does
+        };
+
+        RenderGraph() = default;
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        // Declaration, before compile()
+        ResourceHandle importImage(const std::string& name, const ImageDesc& desc);
+        ResourceHandle createTransientImage(const std::string& name, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+        // Consumed after the frame (presented, read as history next frame); keeps its writers alive
+        void markOutput(ResourceHandle resource);
+        PassBuilder addPass(const char* name, ExecuteFunction execute);
+        // Before compile(): whether asyncCompute() passes leave the graphics command buffer
+        void setAsyncCompute(bool enabled) { asyncComputeEnabled = enabled; compiled = false; }
+        void compile();
+
+        ResourceHandle findResource(const std::string& name) const;
+        bool isCompiled() const { return compiled; }
+        // After compile(): an async pass survived culling and execute() needs QueueCommandBuffers
+        bool usesAsyncCompute() const { return asyncPass != NO_PASS; }
+
+        // After compile(), once the transient images exist: requirements of one frame's images, several per
+        // resource allowed. Transients sharing memory are ordered by the barriers execute() records
+        TransientMemoryPlan planTransientMemory(const std::vector<TransientRequest>& requests);
+
+        // Per frame, before execute(): the images the resources stand for this frame. A pass whose written
+        // resources are all bound to no image is skipped
+        void bindImage(ResourceHandle resource, VkImage image);
+        void bindImages(ResourceHandle resource, const VkImage* images, uint32_t count);
+        void execute(FrameContext& frameContext, const QueueCommandBuffers* queueCommandBuffers = nullptr);
+
+        uint32_t getPassCount() const { return static_cast<uint32_t>(passes.size()); }
+        uint32_t getCulledPassCount() const;
+        uint32_t getBarrierCount() const;     // vkCmdPipelineBarrier calls per frame, before pass skipping
+        VkDeviceSize getTransientMemorySaved() const { return transientMemorySaved; }
+
+    private:
+        static constexpr uint32_t NO_PASS = UINT32_MAX;
+
+        struct Resource {
+            std::string name;
+            ImageDesc desc;
+            bool transient = false;
+            bool output = false;
+            uint32_t firstPass = UINT32_MAX;   // live pass range, after compile()
+            uint32_t lastPass = 0;
+            std::vector<ResourceHandle> aliasedAfter;   // transients whose memory this one takes over
+            std::vector<VkImage> images;        // bound for the current frame
+        };
+
+        struct PassUse {
+            ResourceHandle resource;
+            ImageUsage usage;
+            bool write;
+        };
+
+        struct ImageTransition {
+            ResourceHandle resource;
+            VkImageLayout oldLayout;
+            VkImageLayout newLayout;
+            VkAccessFlags srcAccess;
+            VkAccessFlags dstAccess;
+        };
+
+        // Everything recorded before a pass in one vkCmdPipelineBarrier
+        struct BarrierBatch {
+            VkPipelineStageFlags srcStages = 0;
+            VkPipelineStageFlags dstStages = 0;
+            VkAccessFlags srcAccess = 0;          // global memory barrier
+            VkAccessFlags dstAccess = 0;
+            std::vector<ImageTransition> transitions;
+
+            bool empty() const { return srcStages == 0 && dstStages == 0; }
+        };
+
+        struct Pass {
+            const char* name;
+            ExecuteFunction execute;
+            std::vector<PassUse> uses;
+            bool hasSideEffects = false;
+            bool asyncCompute = false;
+            bool culled = false;
+            BarrierBatch barrier;
+        };
+
+        // Access history of a resource while the frame is simulated
+        struct ResourceState {
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags writeStages = 0;     // last write, or layout transition
+            VkAccessFlags writeAccess = 0;
+            VkPipelineStageFlags visibleStages = 0;   // stages the last write is already visible to
+            VkPipelineStageFlags readStages = 0;      // reads since the last write
+        };
+
+        void addUse(uint32_t pass, ResourceHandle resource, const ImageUsage& usage, bool write);
+        void cullPasses();
+        void findAsyncRange();
+        void computeLifetimes();
+        void buildBarriers();
+        ResourceState frameStartState(const Resource& resource, const ResourceState& previousEnd) const;
+        void applyUse(BarrierBatch& batch, ResourceState& state, const PassUse& use) const;
+        void record(VkCommandBuffer commandBuffer, const BarrierBatch& batch);
+
+        std::vector<Resource> resources;
+        std::vector<Pass> passes;
+        BarrierBatch endOfFrameBarrier;     // puts persistent images back into their initial layout
+        bool compiled = false;
+        bool asyncComputeEnabled = false;
+        uint32_t asyncPass = NO_PASS;     // runs on the compute queue, after compile()
+        uint32_t joinPass = NO_PASS;      // first graphics pass ordered after it; passes.size() when none is
+        VkDeviceSize transientMemorySaved = 0;
+        std::vector<VkImageMemoryBarrier> imageBarrierScratch;
+    };
+}
@@ -0,0 +1,171 @@
+#include "resource_pool.hpp"
+#include "device.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace Rendering {
+
+    ResourcePool::ResourcePool(Device& device) : device{device} {}
+
+    ResourcePool::~ResourcePool() {
+        clear();
+    }
+
+    bool ResourcePool::matches(const VkImageCreateInfo& a, const VkImageCreateInfo& b) {
+        return a.flags == b.flags && a.imageType == b.imageType && a.format == b.format &&
+               a.extent.width == b.extent.width && a.extent.height == b.extent.height &&
+               a.extent.depth == b.extent.depth && a.mipLevels == b.mipLevels && a.arrayLayers == b.arrayLayers &&
+               a.samples == b.samples && a.tiling == b.tiling && a.usage == b.usage &&
+               a.sharingMode == b.sharingMode;
+    }
+
+    void ResourcePool::acquireImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                                    VkImage& image, VkDeviceMemory& memory) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // Most recently released first: its memory is the likeliest to still be resident
+            for (size_t i = idleImages.size(); i-- > 0;) {
+                IdleImage& idle = idleImages[i];
+                if (idle.properties == properties && matches(idle.info, imageInfo)) {
+                    image = idle.image;
+                    memory = idle.memory;
+                    idleBytes -= idle.bytes;
+                    idleImages.erase(idleImages.begin() + static_cast<std::ptrdiff_t>(i));
+                    reused++;
+                    return;
+                }
+            }
+            created++;
+        }
+        device.createImageWithInfo(imageInfo, properties, image, memory);
+    }
+
+    void ResourcePool::releaseImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                                    VkImage image, VkDeviceMemory memory) {
+        if (image == VK_NULL_HANDLE) {
+            return;
+        }
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(device.getDevice(), image, &requirements);
+
+        IdleImage idle{imageInfo, properties, image, memory, requirements.size, 0};
+        // Chained structs and queue family lists belong to the caller and are not compared
+        idle.info.pNext = nullptr;
+        idle.info.queueFamilyIndexCount = 0;
+        idle.info.pQueueFamilyIndices = nullptr;
+        const bool reusable = imageInfo.pNext == nullptr && imageInfo.sharingMode == VK_SHARING_MODE_EXCLUSIVE;
+        VkDevice vkDevice = device.getDevice();
+        device.getDeletionQueue().push([this, idle, reusable, vkDevice]() {
+            if (reusable) {
+                addIdleImage(idle);
+            } else {
+                vkDestroyImage(vkDevice, idle.image, nullptr);
+                vkFreeMemory(vkDevice, idle.memory, nullptr);
+            }
+        });
+    }
+
+    void ResourcePool::acquireBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                     VkBuffer& buffer, VkDeviceMemory& memory) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = idleBuffers.size(); i-- > 0;) {
+                IdleBuffer& idle = idleBuffers[i];
+                if (idle.size == size && idle.usage == usage && idle.properties == properties) {
+                    buffer = idle.buffer;
+                    memory = idle.memory;
+                    idleBytes -= idle.size;
+                    idleBuffers.erase(idleBuffers.begin() + static_cast<std::ptrdiff_t>(i));
+                    reused++;
+                    return;
+                }
+            }
+            created++;
+        }
+        device.createBuffer(size, usage, properties, buffer, memory);
+    }
+
+    void ResourcePool::releaseBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                     VkBuffer buffer, VkDeviceMemory memory) {
+        if (buffer == VK_NULL_HANDLE) {
+            return;
+        }
+        IdleBuffer idle{size, usage, properties, buffer, memory, 0};
+        device.getDeletionQueue().push([this, idle]() { addIdleBuffer(idle); });
+    }
+
+    void ResourcePool::addIdleImage(IdleImage idle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.idleSince = device.getDeletionQueue().getFrameNumber();
+        idleBytes += idle.bytes;
+        idleImages.push_back(idle);
+        trimLocked(idle.idleSince);
+    }
+
+    void ResourcePool::addIdleBuffer(IdleBuffer idle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.idleSince = device.getDeletionQueue().getFrameNumber();
+        idleBytes += idle.size;
+        idleBuffers.push_back(idle);
+        trimLocked(idle.idleSince);
+    }
+
+    void ResourcePool::trim() {
+        const uint64_t frameNumber = device.getDeletionQueue().getFrameNumber();
+        std::lock_guard<std::mutex> lock(mutex);
+        trimLocked(frameNumber);
+    }
+
+    void ResourcePool::trimLocked(uint64_t frameNumber) {
+        auto expired = [frameNumber](uint64_t idleSince) {
+            return frameNumber > idleSince + RESOURCE_POOL_MAX_IDLE_FRAMES;
+        };
+        // Both lists are in release order, so the oldest entry of either is at its front
+        while ((!idleImages.empty() && expired(idleImages.front().idleSince)) ||
+               (!idleBuffers.empty() && expired(idleBuffers.front().idleSince)) ||
+               (idleBytes > RESOURCE_POOL_MAX_IDLE_BYTES && (!idleImages.empty() || !idleBuffers.empty()))) {
+            destroyOldestLocked();
+        }
+    }
+
+    void ResourcePool::destroyOldestLocked() {
+        VkDevice vkDevice = device.getDevice();
+        const bool imageFirst = !idleImages.empty() &&
+            (idleBuffers.empty() || idleImages.front().idleSince <= idleBuffers.front().idleSince);
+        if (imageFirst) {
+            IdleImage& idle = idleImages.front();
+            vkDestroyImage(vkDevice, idle.image, nullptr);
+            vkFreeMemory(vkDevice, idle.memory, nullptr);
+            idleBytes -= idle.bytes;
+            idleImages.erase(idleImages.begin());
+        } else if (!idleBuffers.empty()) {
+            IdleBuffer& idle = idleBuffers.front();
+            vkDestroyBuffer(vkDevice, idle.buffer, nullptr);
+            vkFreeMemory(vkDevice, idle.memory, nullptr);
+            idleBytes -= idle.size;
+            idleBuffers.erase(idleBuffers.begin());
+        }
+    }
+
+    void ResourcePool::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!idleImages.empty() || !idleBuffers.empty()) {
+            destroyOldestLocked();
+        }
+        idleBytes = 0;
+    }
+
+    ResourcePool::Stats ResourcePool::getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats stats{};
+        stats.idleImages = static_cast<uint32_t>(idleImages.size());
+        stats.idleBuffers = static_cast<uint32_t>(idleBuffers.size());
+        stats.idleBytes = idleBytes;
+        stats.reused = reused;
+        stats.created = created;
+        return stats;
+    }
+
+} // namespace Rendering
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Rendering {
+
+    class Device;
+
+    // Recycles images and buffers that get created and destroyed over and over (streamed texture mips, resized
+    // buffers). A released object goes through the device's deletion queue and only becomes idle once no frame in
+    // flight can use it; an acquire with the same create parameters then takes it instead of allocating. Contents
+    // and layout are not preserved, so a reused image must be transitioned from VK_IMAGE_LAYOUT_UNDEFINED.
+    // Thread-safe: loader threads acquire while the render thread releases
+    class ResourcePool {
+    public:
+        struct Stats {
+            uint32_t idleImages;
+            uint32_t idleBuffers;
+            uint64_t idleBytes;
+            uint64_t reused;        // acquires served from the idle lists
+            uint64_t created;       // acquires that had to allocate
+        };
+
+        explicit ResourcePool(Device& device);
+        ~ResourcePool();
+
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        void acquireImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                          VkImage& image, VkDeviceMemory& memory);
+        // imageInfo and properties must be the ones the image was acquired with
+        void releaseImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties,
+                          VkImage image, VkDeviceMemory memory);
+
+        void acquireBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                           VkBuffer& buffer, VkDeviceMemory& memory);
+        void releaseBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                           VkBuffer buffer, VkDeviceMemory memory);
+
+        // Frees idle objects past RESOURCE_POOL_MAX_IDLE_FRAMES or RESOURCE_POOL_MAX_IDLE_BYTES, oldest first
+        void trim();
+        // Frees every idle object; releases still in the deletion queue are not affected
+        void clear();
+
+        Stats getStats() const;
+
+    private:
+        struct IdleImage {
+            VkImageCreateInfo info;
+            VkMemoryPropertyFlags properties;
+            VkImage image;
+            VkDeviceMemory memory;
+            VkDeviceSize bytes;
+            uint64_t idleSince;     // deletion queue frame number
+        };
+
+        struct IdleBuffer {
+            VkDeviceSize size;
+            VkBufferUsageFlags usage;
+            VkMemoryPropertyFlags properties;
+            VkBuffer buffer;
+            VkDeviceMemory memory;
+            uint64_t idleSince;
+        };
+
+        static bool matches(const VkImageCreateInfo& a, const VkImageCreateInfo& b);
+
+        void addIdleImage(IdleImage idle);
+        void addIdleBuffer(IdleBuffer idle);
+        // Callers hold mutex
+        void trimLocked(uint64_t frameNumber);
+        void destroyOldestLocked();
+
+        Device& device;
+        mutable std::mutex mutex;
+        std::vector<IdleImage> idleImages;      // in release order
+        std::vector<IdleBuffer> idleBuffers;
+        uint64_t idleBytes = 0;
+        uint64_t reused = 0;
+        uint64_t created = 0;
+    };
+
+} // namespace Rendering
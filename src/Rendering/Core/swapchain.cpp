@@ -8,6 +8,7 @@
 #include <limits>
 #include <set>
 #include <stdexcept>
+#include <utility>
 
 namespace Rendering {
 
@@ -23,9 +24,20 @@ SwapChain::SwapChain(Device& deviceRef, VkExtent2D extent, std::shared_ptr<SwapC
 }
 
 void SwapChain::init() {  
-    createSwapChain();
+    if (device.isHeadless()) {
+        createOffscreenImages();
+    } else {
+        createSwapChain();
+    }
     createImageViews();
-    createSyncObjects();
+    // A new frames-in-flight count needs its own set of fences; the renderer idles the device for that change
+    if (oldSwapChain && oldSwapChain->inFlightFences.size() == device.getFramesInFlight()) {
+        adoptSyncObjects(*oldSwapChain);
+    } else {
+        createSyncObjects();
+    }
+    // Only guards reuse of this chain's images: the renderer's frame resources follow the frame slot
+    imagesInFlight.assign(imageCount(), VK_NULL_HANDLE);
 }
 
 SwapChain::~SwapChain() {      
@@ -34,17 +46,26 @@ SwapChain::~SwapChain() {
     }
     swapChainImageViews.clear();
 
+    for (size_t i = 0; i < offscreenImageMemory.size(); i++) {
+        vkDestroyImage(device.getDevice(), swapChainImages[i], nullptr);
+        vkFreeMemory(device.getDevice(), offscreenImageMemory[i], nullptr);
+    }
+    offscreenImageMemory.clear();
 
     if (vkSwapChain != nullptr) {
         vkDestroySwapchainKHR(device.getDevice(), vkSwapChain, nullptr);
         vkSwapChain = nullptr;
     }
 
-    // cleanup synchronization objects
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroySemaphore(device.getDevice(), renderFinishedSemaphores[i], nullptr);
-        vkDestroySemaphore(device.getDevice(), imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(device.getDevice(), inFlightFences[i], nullptr);
+    // cleanup synchronization objects; empty once handed on to a successor
+    for (VkSemaphore semaphore : renderFinishedSemaphores) {
+        vkDestroySemaphore(device.getDevice(), semaphore, nullptr);
+    }
+    for (VkSemaphore semaphore : imageAvailableSemaphores) {
+        vkDestroySemaphore(device.getDevice(), semaphore, nullptr);
+    }
+    for (VkFence fence : inFlightFences) {
+        vkDestroyFence(device.getDevice(), fence, nullptr);
     }
     std::cout << "Swapchain cleaned up" << std::endl;
 }
@@ -57,31 +78,57 @@ VkResult SwapChain::acquireNextImage(uint32_t* imageIndex) {
         VK_TRUE,
         std::numeric_limits<uint64_t>::max());
 
-    VkResult result = vkAcquireNextImageKHR(
-        device.getDevice(),
-        vkSwapChain,
-        std::numeric_limits<uint64_t>::max(),
-        imageAvailableSemaphores[currentFrame],
-        VK_NULL_HANDLE,
-        imageIndex);
-
-    
+    VkResult result = VK_SUCCESS;
+    if (device.isHeadless()) {
+        *imageIndex = static_cast<uint32_t>(currentFrame);
+    } else {
+        result = vkAcquireNextImageKHR(
+            device.getDevice(),
+            vkSwapChain,
+            std::numeric_limits<uint64_t>::max(),
+            imageAvailableSemaphores[currentFrame],
+            VK_NULL_HANDLE,
+            imageIndex);
+    }
 
+    // Waited for here rather than at submit: with async compute part of the frame is submitted before that
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+        if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
+            vkWaitForFences(device.getDevice(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
+        }
+        imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
+    }
     return result;
 }
 
-VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex) {
-    if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
-        vkWaitForFences(device.getDevice(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
-    }
-    imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
-
+VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex,
+                                         const SemaphoreWait* timelineWait) {
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    // Headless images are never acquired from or presented to a surface, the fence alone orders the frames
+    const bool headless = device.isHeadless();
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitStages[2];
+    uint64_t waitValues[2] = {0, 0};    // binary semaphores ignore theirs
+    uint32_t waitCount = 0;
+    if (!headless) {
+        waitSemaphores[waitCount] = imageAvailableSemaphores[currentFrame];
+        waitStages[waitCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ++waitCount;
+    }
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    if (timelineWait != nullptr) {
+        waitSemaphores[waitCount] = timelineWait->semaphore;
+        waitStages[waitCount] = timelineWait->stages;
+        waitValues[waitCount] = timelineWait->value;
+        ++waitCount;
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = waitCount;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        submitInfo.pNext = &timelineInfo;
+    }
+    submitInfo.waitSemaphoreCount = waitCount;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
 
@@ -89,14 +136,20 @@ VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_
     submitInfo.pCommandBuffers = buffers;
 
     VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
-    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.signalSemaphoreCount = headless ? 0 : 1;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
     vkResetFences(device.getDevice(), 1, &inFlightFences[currentFrame]);
+    std::lock_guard<std::mutex> queueLock(device.getGraphicsQueueMutex());
     if (vkQueueSubmit(device.getGraphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
         throw std::runtime_error("failed to submit draw command buffer!");
     }
 
+    if (headless) {
+        currentFrame = (currentFrame + 1) % inFlightFences.size();
+        return VK_SUCCESS;
+    }
+
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -108,7 +161,7 @@ VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_
     presentInfo.pImageIndices = imageIndex;
 
     auto result = vkQueuePresentKHR(device.getPresentQueue(), &presentInfo);
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    currentFrame = (currentFrame + 1) % inFlightFences.size();
     return result;
 }
 
@@ -167,6 +220,33 @@ void SwapChain::createSwapChain() {
     swapChainExtent = extent;
 }
 
+void SwapChain::createOffscreenImages() {
+    swapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    swapChainExtent = windowExtent;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = swapChainImageFormat;
+    imageInfo.extent = {swapChainExtent.width, swapChainExtent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // Same usage as the surface images, plus transfer source for captures
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    const uint32_t imageCount = device.getFramesInFlight();
+    swapChainImages.resize(imageCount);
+    offscreenImageMemory.resize(imageCount);
+    for (size_t i = 0; i < imageCount; i++) {
+        device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, swapChainImages[i], offscreenImageMemory[i]);
+    }
+    std::cout << "Headless: rendering offscreen at " << swapChainExtent.width << "x" << swapChainExtent.height << std::endl;
+}
+
 void SwapChain::createImageViews() {
     swapChainImageViews.resize(swapChainImages.size());
     for (size_t i = 0; i < swapChainImages.size(); i++) {
@@ -188,10 +268,10 @@ void SwapChain::createImageViews() {
 }
 
 void SwapChain::createSyncObjects() {
-    imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-    imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+    const uint32_t framesInFlight = device.getFramesInFlight();
+    imageAvailableSemaphores.resize(framesInFlight);
+    renderFinishedSemaphores.resize(framesInFlight);
+    inFlightFences.resize(framesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo = {};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -200,7 +280,7 @@ void SwapChain::createSyncObjects() {
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
             vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
             vkCreateFence(device.getDevice(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
@@ -209,6 +289,18 @@ void SwapChain::createSyncObjects() {
     }
 }
 
+void SwapChain::adoptSyncObjects(SwapChain& previous) {
+    // The fences of frames submitted before the resize stay the ones acquireNextImage waits for, and the frame
+    // slot keeps counting, so frame-fenced work (the deletion queue, per-frame resources) sees no discontinuity
+    imageAvailableSemaphores = std::move(previous.imageAvailableSemaphores);
+    renderFinishedSemaphores = std::move(previous.renderFinishedSemaphores);
+    inFlightFences = std::move(previous.inFlightFences);
+    currentFrame = previous.currentFrame;
+    previous.imageAvailableSemaphores.clear();
+    previous.renderFinishedSemaphores.clear();
+    previous.inFlightFences.clear();
+}
+
 VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
     for (const auto& availableFormat : availableFormats) {
         if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB &&
@@ -18,6 +18,7 @@ namespace Rendering {
         SwapChain& operator=(const SwapChain&) = delete;
 
         VkImageView getImageView(size_t index) { return swapChainImageViews[index]; }
+        VkImage getImage(size_t index) const { return swapChainImages[index]; }
         std::vector<VkImageView>& getImageViews()  { return swapChainImageViews; }
         VkExtent2D getExtent() { return swapChainExtent; }     
         VkFormat getSwapChainImageFormat() const { return swapChainImageFormat; }
@@ -27,8 +28,16 @@ namespace Rendering {
             return static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height);
         }
 
+        // A timeline semaphore value the frame's submission waits for besides the acquired image
+        struct SemaphoreWait {
+            VkSemaphore semaphore;
+            uint64_t value;
+            VkPipelineStageFlags stages;
+        };
+
         VkResult acquireNextImage(uint32_t* imageIndex);
-        VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex);
+        VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex,
+                                      const SemaphoreWait* timelineWait = nullptr);
 
         bool compareSwapFormats(const SwapChain& other) const {
             return other.swapChainImageFormat == swapChainImageFormat;
@@ -37,8 +46,12 @@ namespace Rendering {
     private:
         void init();
         void createSwapChain();
+        // Headless: one image per frame in flight, acquired in order and never presented
+        void createOffscreenImages();
         void createImageViews();
         void createSyncObjects();
+        // Takes over the semaphores, fences and frame slot of the swapchain being replaced
+        void adoptSyncObjects(SwapChain& previous);
 
         // Helper functions
         VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -50,11 +63,12 @@ namespace Rendering {
 
         std::vector<VkImage> swapChainImages;
         std::vector<VkImageView> swapChainImageViews;
+        std::vector<VkDeviceMemory> offscreenImageMemory;   // headless only, owns swapChainImages
 
         Device& device;
         VkExtent2D windowExtent;
 
-        VkSwapchainKHR vkSwapChain;
+        VkSwapchainKHR vkSwapChain{VK_NULL_HANDLE};
         std::shared_ptr<SwapChain> oldSwapChain;
 
         std::vector<VkSemaphore> imageAvailableSemaphores;
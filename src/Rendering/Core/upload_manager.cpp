@@ -0,0 +1,335 @@
+#include "upload_manager.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace Rendering {
+
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    static VkCommandPool createUploadCommandPool(Device& device, uint32_t queueFamily) {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = queueFamily;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        VkCommandPool commandPool;
+        if (vkCreateCommandPool(device.getDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create upload command pool!");
+        }
+        return commandPool;
+    }
+
+    UploadManager::UploadManager(Device& device, VkDeviceSize chunkSize)
+        : device{device}, dedicatedTransfer{device.hasDedicatedTransferQueue()}, chunkSize{chunkSize} {
+        if (!device.supportsTimelineSemaphores()) {
+            throw std::runtime_error("UploadManager requires timeline semaphore support!");
+        }
+
+        transferPool = createUploadCommandPool(device, device.getTransferQueueFamily());
+        graphicsPool = dedicatedTransfer ? createUploadCommandPool(device, device.getGraphicsQueueFamily()) : transferPool;
+
+        VkSemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &timelineInfo;
+        if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &timelineSemaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create upload timeline semaphore!");
+        }
+
+        // Chunks are created lazily so a small load does not reserve the whole ring
+        std::cout << "Upload manager using " << (dedicatedTransfer ? "dedicated transfer queue" : "graphics queue") << std::endl;
+    }
+
+    UploadManager::~UploadManager() {
+        finish();
+        for (auto& chunk : chunks) {
+            chunk.staging.reset();
+        }
+        vkDestroySemaphore(device.getDevice(), timelineSemaphore, nullptr);
+        if (graphicsPool != transferPool) {
+            vkDestroyCommandPool(device.getDevice(), graphicsPool, nullptr);
+        }
+        vkDestroyCommandPool(device.getDevice(), transferPool, nullptr);
+    }
+
+    void UploadManager::createChunk(Chunk& chunk, VkDeviceSize size) {
+        chunk.staging = std::make_unique<Buffer>(
+            device,
+            size,
+            1,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        chunk.staging->map();
+
+        if (chunk.transferCommands != VK_NULL_HANDLE) {
+            return;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        allocInfo.commandPool = transferPool;
+        if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &chunk.transferCommands) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate upload command buffer!");
+        }
+
+        // Without a separate transfer family both halves of the chunk are recorded into one command buffer
+        if (dedicatedTransfer) {
+            allocInfo.commandPool = graphicsPool;
+            if (vkAllocateCommandBuffers(device.getDevice(), &allocInfo, &chunk.graphicsCommands) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate upload command buffer!");
+            }
+        } else {
+            chunk.graphicsCommands = chunk.transferCommands;
+        }
+    }
+
+    void UploadManager::beginChunk(Chunk& chunk) {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkResetCommandBuffer(chunk.transferCommands, 0);
+        vkBeginCommandBuffer(chunk.transferCommands, &beginInfo);
+        if (chunk.graphicsCommands != chunk.transferCommands) {
+            vkResetCommandBuffer(chunk.graphicsCommands, 0);
+            vkBeginCommandBuffer(chunk.graphicsCommands, &beginInfo);
+        }
+        chunk.used = 0;
+        chunk.recording = true;
+    }
+
+    void UploadManager::submit(VkQueue queue, VkCommandBuffer commandBuffer, UploadTicket waitValue, VkPipelineStageFlags waitStage, UploadTicket signalValue) {
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = waitValue > 0 ? 1 : 0;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = waitValue > 0 ? 1 : 0;
+        submitInfo.pWaitSemaphores = &timelineSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+        VkResult result;
+        if (queue == device.getGraphicsQueue()) {
+            std::lock_guard<std::mutex> lock(device.getGraphicsQueueMutex());
+            result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        } else {
+            std::lock_guard<std::mutex> lock(device.getTransferQueueMutex());
+            result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        }
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit upload commands!");
+        }
+        stats.submitCount++;
+    }
+
+    void UploadManager::submitChunk(Chunk& chunk) {
+        if (!chunk.recording) {
+            return;
+        }
+
+        if (dedicatedTransfer) {
+            // Release everything written in this chunk to the graphics family...
+            if (!pendingBufferReleases.empty() || !pendingImageReleases.empty()) {
+                vkCmdPipelineBarrier(
+                    chunk.transferCommands,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                    0,
+                    0, nullptr,
+                    static_cast<uint32_t>(pendingBufferReleases.size()), pendingBufferReleases.data(),
+                    static_cast<uint32_t>(pendingImageReleases.size()), pendingImageReleases.data());
+            }
+            vkEndCommandBuffer(chunk.transferCommands);
+            UploadTicket transferDone = ++lastSignaledValue;
+            submit(device.getTransferQueue(), chunk.transferCommands, 0, 0, transferDone);
+
+            // ...and acquire it on the graphics queue once the copies have signaled. Image acquires were recorded
+            // up front because the mip blits that follow them depend on them
+            if (!pendingBufferAcquires.empty()) {
+                vkCmdPipelineBarrier(
+                    chunk.graphicsCommands,
+                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pendingAcquireStages,
+                    0,
+                    0, nullptr,
+                    static_cast<uint32_t>(pendingBufferAcquires.size()), pendingBufferAcquires.data(),
+                    0, nullptr);
+            }
+            vkEndCommandBuffer(chunk.graphicsCommands);
+            submit(device.getGraphicsQueue(), chunk.graphicsCommands, transferDone, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, ++lastSignaledValue);
+        } else {
+            if (!pendingBufferAcquires.empty()) {
+                vkCmdPipelineBarrier(
+                    chunk.transferCommands,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, pendingAcquireStages,
+                    0,
+                    0, nullptr,
+                    static_cast<uint32_t>(pendingBufferAcquires.size()), pendingBufferAcquires.data(),
+                    0, nullptr);
+            }
+            vkEndCommandBuffer(chunk.transferCommands);
+            submit(device.getGraphicsQueue(), chunk.transferCommands, 0, 0, ++lastSignaledValue);
+        }
+
+        pendingBufferReleases.clear();
+        pendingBufferAcquires.clear();
+        pendingImageReleases.clear();
+        pendingAcquireStages = 0;
+        chunk.completionValue = lastSignaledValue;
+        chunk.recording = false;
+    }
+
+    UploadManager::StagingAllocation UploadManager::stage(const void* data, VkDeviceSize size) {
+        Chunk* chunk = &chunks[currentChunk];
+        VkDeviceSize offset = (chunk->used + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+        if (!chunk->recording || chunk->staging->getBufferSize() < offset + size) {
+            // Hand the full chunk to the GPU and move on to the oldest one in the ring
+            if (chunk->recording) {
+                submitChunk(*chunk);
+                currentChunk = (currentChunk + 1) % UPLOAD_STAGING_CHUNK_COUNT;
+                chunk = &chunks[currentChunk];
+            }
+            wait(chunk->completionValue);
+
+            if (!chunk->staging || chunk->staging->getBufferSize() < size) {
+                createChunk(*chunk, size > chunkSize ? size : chunkSize);
+            }
+            beginChunk(*chunk);
+            offset = 0;
+        }
+
+        void* mapped = static_cast<char*>(chunk->staging->getMappedMemory()) + offset;
+        if (data != nullptr) {
+            std::memcpy(mapped, data, static_cast<size_t>(size));
+        }
+        chunk->used = offset + size;
+        stats.bytesStaged += size;
+
+        return {chunk->transferCommands, chunk->graphicsCommands, chunk->staging->getBuffer(), offset, mapped};
+    }
+
+    void UploadManager::uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset,
+                                     VkAccessFlags dstAccess, VkPipelineStageFlags dstStage) {
+        StagingAllocation allocation = stage(data, size);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = allocation.offset;
+        copyRegion.dstOffset = dstOffset;
+        copyRegion.size = size;
+        vkCmdCopyBuffer(allocation.transferCommands, allocation.buffer, dstBuffer, 1, &copyRegion);
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.buffer = dstBuffer;
+        barrier.offset = dstOffset;
+        barrier.size = size;
+        if (dedicatedTransfer) {
+            barrier.srcQueueFamilyIndex = device.getTransferQueueFamily();
+            barrier.dstQueueFamilyIndex = device.getGraphicsQueueFamily();
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            pendingBufferReleases.push_back(barrier);
+            barrier.srcAccessMask = 0;
+        } else {
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        }
+        barrier.dstAccessMask = dstAccess;
+        pendingBufferAcquires.push_back(barrier);
+        pendingAcquireStages |= dstStage;
+    }
+
+    void UploadManager::handOffImage(const StagingAllocation& allocation, VkImage image, const VkImageSubresourceRange& range,
+                                     VkImageLayout oldLayout, VkImageLayout newLayout,
+                                     VkAccessFlags dstAccess, VkPipelineStageFlags dstStage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.image = image;
+        barrier.subresourceRange = range;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+
+        if (dedicatedTransfer) {
+            // Release and acquire must describe the same layout transition
+            barrier.srcQueueFamilyIndex = device.getTransferQueueFamily();
+            barrier.dstQueueFamilyIndex = device.getGraphicsQueueFamily();
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            pendingImageReleases.push_back(barrier);
+
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = dstAccess;
+            vkCmdPipelineBarrier(
+                allocation.graphicsCommands,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+        } else {
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = dstAccess;
+            vkCmdPipelineBarrier(
+                allocation.graphicsCommands,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+        }
+    }
+
+    UploadTicket UploadManager::flush() {
+        submitChunk(chunks[currentChunk]);
+        return lastSignaledValue;
+    }
+
+    bool UploadManager::isComplete(UploadTicket ticket) const {
+        uint64_t completedValue = 0;
+        vkGetSemaphoreCounterValue(device.getDevice(), timelineSemaphore, &completedValue);
+        return completedValue >= ticket;
+    }
+
+    void UploadManager::wait(UploadTicket ticket) {
+        if (ticket == 0 || isComplete(ticket)) {
+            return;
+        }
+
+        auto waitStart = std::chrono::high_resolution_clock::now();
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timelineSemaphore;
+        waitInfo.pValues = &ticket;
+        vkWaitSemaphores(device.getDevice(), &waitInfo, UINT64_MAX);
+        stats.waitMs += std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - waitStart).count();
+    }
+
+    void UploadManager::finish() {
+        wait(flush());
+    }
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "device.hpp"
+#include "buffer.hpp"
+#include "Rendering/rendering_constants.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Rendering {
+
+    // Value of the upload timeline semaphore that marks a batch of uploads as usable by the graphics queue
+    using UploadTicket = uint64_t;
+
+    // Streams staging copies to the GPU on the dedicated transfer queue when the device has one, falling back to the
+    // graphics queue otherwise. Staging memory comes from a small ring of persistently mapped chunks; each chunk is one
+    // transfer submission plus a graphics submission that acquires ownership and runs graphics-only work (mip blits).
+    // Completion is tracked with one timeline semaphore instead of fences or queue idles, so the renderer can keep
+    // submitting frames and only has to check isComplete() before using what was uploaded.
+    // Recording is not thread-safe: one thread (the loader) owns the manager at a time. Threads that upload
+    // concurrently each use their own manager; queue submissions are serialized through the device's queue locks.
+    class UploadManager {
+    public:
+        struct StagingAllocation {
+            VkCommandBuffer transferCommands;  // copies reading this allocation, runs on the transfer queue
+            VkCommandBuffer graphicsCommands;  // runs after transferCommands on the graphics queue; may be the same buffer
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            void* mapped;                      // holds the staged data, or is left for the caller to fill when data was null
+        };
+
+        struct Stats {
+            uint32_t submitCount = 0;
+            VkDeviceSize bytesStaged = 0;
+            double waitMs = 0.0;  // host time blocked on the timeline, recycling chunks or in wait()
+        };
+
+        explicit UploadManager(Device& device, VkDeviceSize chunkSize = UPLOAD_STAGING_CHUNK_SIZE);
+        ~UploadManager();
+
+        UploadManager(const UploadManager&) = delete;
+        UploadManager& operator=(const UploadManager&) = delete;
+
+        // Copies size bytes into staging memory (16-byte aligned, enough for block-compressed and float formats).
+        // Requests larger than a chunk grow that chunk instead of failing
+        StagingAllocation stage(const void* data, VkDeviceSize size);
+        // Stages data into dstBuffer and hands it to the graphics queue for the given first use
+        void uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0,
+                          VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                          VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        // Moves an image written by allocation.transferCommands to the graphics queue, changing its layout on the way.
+        // Must be called before anything recorded into allocation.graphicsCommands touches the image
+        void handOffImage(const StagingAllocation& allocation, VkImage image, const VkImageSubresourceRange& range,
+                          VkImageLayout oldLayout, VkImageLayout newLayout,
+                          VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+
+        // Submits everything recorded so far; the returned ticket completes once it is usable for rendering
+        UploadTicket flush();
+        bool isComplete(UploadTicket ticket) const;
+        void wait(UploadTicket ticket);
+        // flush() followed by wait()
+        void finish();
+
+        VkSemaphore getTimelineSemaphore() const { return timelineSemaphore; }
+        const Stats& getStats() const { return stats; }
+
+    private:
+        struct Chunk {
+            std::unique_ptr<Buffer> staging;
+            VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+            VkCommandBuffer graphicsCommands = VK_NULL_HANDLE;
+            UploadTicket completionValue = 0;
+            VkDeviceSize used = 0;
+            bool recording = false;
+        };
+
+        void createChunk(Chunk& chunk, VkDeviceSize size);
+        void beginChunk(Chunk& chunk);
+        void submitChunk(Chunk& chunk);
+        void submit(VkQueue queue, VkCommandBuffer commandBuffer, UploadTicket waitValue, VkPipelineStageFlags waitStage, UploadTicket signalValue);
+
+        Device& device;
+        bool dedicatedTransfer;
+        VkCommandPool transferPool = VK_NULL_HANDLE;
+        VkCommandPool graphicsPool = VK_NULL_HANDLE;
+        VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+        UploadTicket lastSignaledValue = 0;
+
+        VkDeviceSize chunkSize;
+        std::array<Chunk, UPLOAD_STAGING_CHUNK_COUNT> chunks{};
+        uint32_t currentChunk = 0;
+
+        // Buffer ownership barriers are batched per chunk: releases close the transfer commands, acquires the graphics ones
+        std::vector<VkBufferMemoryBarrier> pendingBufferReleases;
+        std::vector<VkBufferMemoryBarrier> pendingBufferAcquires;
+        std::vector<VkImageMemoryBarrier> pendingImageReleases;
+        VkPipelineStageFlags pendingAcquireStages = 0;
+        Stats stats{};
+    };
+
+}
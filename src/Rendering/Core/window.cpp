@@ -6,13 +6,17 @@
 
 namespace Rendering {
 
-    Window::Window(int w, int h, std::string name) : width{ w }, height{ h }, windowName{ name } {
-        initWindow();
+    Window::Window(int w, int h, std::string name, bool headless) : width{ w }, height{ h }, windowName{ name } {
+        if (!headless) {
+            initWindow();
+        }
     }
 
     Window::~Window() {
-        glfwDestroyWindow(window);
-        glfwTerminate();
+        if (window) {
+            glfwDestroyWindow(window);
+            glfwTerminate();
+        }
     }
 
     void Window::initWindow() {
@@ -37,6 +41,9 @@ namespace Rendering {
     }
 
     void Window::createWindowSurface(VkInstance instance, VkSurfaceKHR* surface) {
+        if (!window) {
+            throw std::runtime_error("a headless window has no surface");
+        }
         if (glfwCreateWindowSurface(instance, window, nullptr, surface) != VK_SUCCESS) {
             throw std::runtime_error("failed to craete window surface");
         }
@@ -8,18 +8,20 @@ namespace Rendering {
 
 	class Window {
 	public:
-		Window(int w, int h, std::string name);
+		// A headless window has no GLFW window or surface: the device renders offscreen at w x h
+		Window(int w, int h, std::string name, bool headless = false);
 		~Window();
 
 		Window(const Window&) = delete;
 		Window& operator=(const Window&) = delete;
 
-		bool shouldClose() { return glfwWindowShouldClose(window); }
+		bool shouldClose() { return window && glfwWindowShouldClose(window); }
 		VkExtent2D getExtent() { return { static_cast<uint32_t>(width), static_cast<uint32_t>(height) }; }
 		bool wasWindowResized() { return framebufferResized; }
 		void resetWindowResizedFlag() { framebufferResized = false; }
 		GLFWwindow* getGLFWwindow() const { return window; }
-		bool isMinimized() const { return glfwGetWindowAttrib(window, GLFW_ICONIFIED) == GLFW_TRUE; }
+		bool isMinimized() const { return window && glfwGetWindowAttrib(window, GLFW_ICONIFIED) == GLFW_TRUE; }
+		bool isHeadless() const { return window == nullptr; }
 
 		void createWindowSurface(VkInstance instance, VkSurfaceKHR* surface);
 
@@ -32,6 +34,6 @@ namespace Rendering {
 		bool framebufferResized = false;
 
 		std::string windowName;
-		GLFWwindow* window;
+		GLFWwindow* window = nullptr;
 	};
 } 
\ No newline at end of file
@@ -20,13 +20,26 @@ ColorCorrectionPass::~ColorCorrectionPass() {
     cleanup();
 }
 
-void ColorCorrectionPass::cleanup() {
+void ColorCorrectionPass::resize(const CreateInfo& info) {
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+    framebuffers.clear();
+    width = info.width;
+    height = info.height;
+    targetViews = info.targetViews;
+    createFramebuffers();
+}
+
+void ColorCorrectionPass::destroyFramebuffers() {
     for (auto framebuffer : framebuffers) {
         if (framebuffer != VK_NULL_HANDLE) {
             vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
         }
     }
-    framebuffers.fill(VK_NULL_HANDLE);
+    framebuffers.clear();
+}
+
+void ColorCorrectionPass::cleanup() {
+    destroyFramebuffers();
 
     pipeline.reset();
     if (pipelineLayout != VK_NULL_HANDLE) {
@@ -82,7 +95,8 @@ void ColorCorrectionPass::createRenderPass() {
 }
 
 void ColorCorrectionPass::createFramebuffers() {
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    framebuffers.assign(targetViews->size(), VK_NULL_HANDLE);
+    for (size_t i = 0; i < framebuffers.size(); i++) {
         std::array<VkImageView, 1> attachments = {
             (*targetViews)[i]
         };
@@ -135,7 +149,7 @@ void ColorCorrectionPass::beginRenderPass(FrameContext& frameContext) {
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffers[frameContext.frameIndex];
+    renderPassInfo.framebuffer = framebuffers[frameContext.imageIndex];
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = {width, height};
 
@@ -145,6 +159,21 @@ void ColorCorrectionPass::beginRenderPass(FrameContext& frameContext) {
     renderPassInfo.pClearValues = &clearValue;
 
     vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    // Set viewport and scissor
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(width);
+    viewport.height = static_cast<float>(height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(frameContext.commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {width, height};
+    vkCmdSetScissor(frameContext.commandBuffer, 0, 1, &scissor);
 }
 
 void ColorCorrectionPass::endRenderPass(FrameContext& frameContext) {
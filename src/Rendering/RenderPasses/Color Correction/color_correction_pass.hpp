@@ -5,6 +5,8 @@
 #include "Rendering/Core/frame_context.hpp"
 #include "Rendering/Core/swapchain.hpp"
 
+#include <vector>
+
 namespace Rendering {
 
 class ColorCorrectionPass {
@@ -14,7 +16,7 @@ public:
         uint32_t height;
         VkFormat targetFormat;
         VkDescriptorSetLayout descriptorSetLayout;
-        std::array<VkImageView, MAX_FRAMES_IN_FLIGHT>* targetViews;
+        std::vector<VkImageView>* targetViews;     // one per swapchain image
     };
 
     ColorCorrectionPass(Device& device, const CreateInfo& info);
@@ -24,11 +26,15 @@ public:
     ColorCorrectionPass& operator=(const ColorCorrectionPass&) = delete;
 
     void run(FrameContext& frameContext);
+    VkFormat getTargetFormat() const { return targetFormat; }
+    // Recreates the framebuffers only
+    void resize(const CreateInfo& info);
 
 private:
     void cleanup();
     void createRenderPass();
     void createFramebuffers();
+    void destroyFramebuffers();
     void createPipeline();
     void beginRenderPass(FrameContext& frameContext);
     void endRenderPass(FrameContext& frameContext);
@@ -37,11 +43,11 @@ private:
     uint32_t width;
     uint32_t height;
     VkFormat targetFormat;
-    std::array<VkImageView, MAX_FRAMES_IN_FLIGHT>* targetViews;
+    std::vector<VkImageView>* targetViews;
     VkDescriptorSetLayout descriptorSetLayout{VK_NULL_HANDLE};
 
     VkRenderPass renderPass{VK_NULL_HANDLE};
-    std::array<VkFramebuffer, MAX_FRAMES_IN_FLIGHT> framebuffers{};
+    std::vector<VkFramebuffer> framebuffers;    // per swapchain image, picked by the frame's imageIndex
     std::unique_ptr<Pipeline> pipeline{nullptr};
     VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
 };
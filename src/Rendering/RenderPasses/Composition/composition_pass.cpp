@@ -24,11 +24,24 @@ CompositionPass::~CompositionPass() {
     cleanup();
 }
 
-void CompositionPass::cleanup() {
-    // Clean up framebuffers
+void CompositionPass::resize(const CreateInfo& createInfo) {
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+    framebuffers.fill(VK_NULL_HANDLE);
+    width = createInfo.width;
+    height = createInfo.height;
+    targetViews = createInfo.targetViews;
+    createFramebuffers();
+}
+
+void CompositionPass::destroyFramebuffers() {
     for (auto framebuffer : framebuffers) {
         vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
     }
+    framebuffers.fill(VK_NULL_HANDLE);
+}
+
+void CompositionPass::cleanup() {
+    destroyFramebuffers();
 
     // Clean up pipeline resources
     pipeline.reset();
@@ -91,7 +104,7 @@ void CompositionPass::createRenderPass() {
 }
 
 void CompositionPass::createFramebuffers() {
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
         std::array<VkImageView, 1> attachments = {
             (*targetViews)[i]
         };
@@ -166,6 +179,21 @@ void CompositionPass::beginRenderPass(FrameContext& frameContext) {
     renderPassInfo.pClearValues = &clearValue;
 
     vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    // Viewport and scissor are dynamic so the pipeline survives resizes
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(width);
+    viewport.height = static_cast<float>(height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(frameContext.commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {width, height};
+    vkCmdSetScissor(frameContext.commandBuffer, 0, 1, &scissor);
 }
 
 void CompositionPass::endRenderPass(FrameContext& frameContext) {
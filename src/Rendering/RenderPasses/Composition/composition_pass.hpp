@@ -33,12 +33,15 @@ public:
     CompositionPass& operator=(const CompositionPass&) = delete;
 
     void run(FrameContext& frameContext);
+    // Retargets the framebuffers at the new views and extent
+    void resize(const CreateInfo& createInfo);
 
 private:
     void cleanup();
     void createRenderPass();
     void createPipeline(const CreateInfo& createInfo);
     void createFramebuffers();
+    void destroyFramebuffers();
 
     void beginRenderPass(FrameContext& frameContext);
     void endRenderPass(FrameContext& frameContext);
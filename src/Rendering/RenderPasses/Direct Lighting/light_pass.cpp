@@ -11,10 +11,8 @@ namespace Rendering {
 
 LightPass::LightPass(
     Device& device, 
-    SwapChain& swapChain, 
     const CreateInfo& createInfo)
     : device{device},
-      swapChain{swapChain},
       width{createInfo.width},
       height{createInfo.height} {
     
@@ -28,11 +26,23 @@ LightPass::~LightPass() {
     cleanup();
 }
 
-void LightPass::cleanup() {
-    // Clean up framebuffers
+void LightPass::resize(const CreateInfo& createInfo) {
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+    framebuffers.fill(VK_NULL_HANDLE);
+    width = createInfo.width;
+    height = createInfo.height;
+    createFramebuffers(createInfo);
+}
+
+void LightPass::destroyFramebuffers() {
     for (auto framebuffer : framebuffers) {
         vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
     }
+    framebuffers.fill(VK_NULL_HANDLE);
+}
+
+void LightPass::cleanup() {
+    destroyFramebuffers();
 
 
     // Clean up pipeline resources
@@ -55,7 +65,7 @@ void LightPass::cleanup() {
 
 
 void LightPass::run(FrameContext& frameContext) {
-    setBarriers(frameContext);
+    uploadLightSlots(frameContext);
 
     beginRenderPass(frameContext);
     vkCmdBindPipeline(
@@ -168,7 +178,7 @@ void LightPass::createFramebuffers(const CreateInfo& createInfo) {
 
     std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> imageViews = *createInfo.lightPassResultViewsPtr;
     std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> incidentViews = *createInfo.lightIncidentViewsPtr;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
 
         VkImageView attachments[2] = { imageViews[i], incidentViews[i] };
         VkFramebufferCreateInfo framebufferInfo{};
@@ -263,136 +273,81 @@ void LightPass::beginRenderPass(FrameContext& frameContext) {
 
         vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+    // Dynamic state: the pipeline is not rebuilt when the window size changes
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(width);
+    viewport.height = static_cast<float>(height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(frameContext.commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {width, height};
+    vkCmdSetScissor(frameContext.commandBuffer, 0, 1, &scissor);
 }
 
 void LightPass::endRenderPass(FrameContext& frameContext) {
     vkCmdEndRenderPass(frameContext.commandBuffer);
 }
 
-void LightPass::setBarriers(FrameContext& frameContext) {
+void LightPass::uploadLightSlots(FrameContext& frameContext) {
+    if (frameContext.lightSlotCopyRegions.empty()) {
+        return;
+    }
     VkCommandBuffer commandBuffer = frameContext.commandBuffer;
-    
-    // Buffer barriers for UBOs
-    std::array<VkBufferMemoryBarrier, 3> bufferBarriers{};  // Change from 1 to 3
-    
-    // Lighting UBO barrier
-    bufferBarriers[0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferBarriers[0].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufferBarriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    bufferBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[0].buffer = frameContext.sceneLightingBuffer->getBuffer();
-    bufferBarriers[0].offset = 0;
-    bufferBarriers[0].size = VK_WHOLE_SIZE;
-
-    // Unified light buffer barrier
-    bufferBarriers[1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferBarriers[1].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufferBarriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    bufferBarriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[1].buffer = frameContext.lightArrayUniformBuffer->getBuffer();
-    bufferBarriers[1].offset = 0;
-    bufferBarriers[1].size = VK_WHOLE_SIZE;
-
-    // Cascade splits buffer barrier
-    bufferBarriers[2].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferBarriers[2].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufferBarriers[2].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    bufferBarriers[2].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[2].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[2].buffer = frameContext.cascadeSplitsBuffer->getBuffer();
-    bufferBarriers[2].offset = 0;
-    bufferBarriers[2].size = VK_WHOLE_SIZE;
-    
-    // Need to wait for G-Buffer images to be written by Geometry Pass
-    std::array<VkImageMemoryBarrier, 5> imageBarriers{};
-    
-    // Position buffer barrier
-    imageBarriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageBarriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    imageBarriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageBarriers[0].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;  // Should already be in this layout
-    imageBarriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[0].image = frameContext.gBufferPositionImage;
-    imageBarriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageBarriers[0].subresourceRange.baseMipLevel = 0;
-    imageBarriers[0].subresourceRange.levelCount = 1;
-    imageBarriers[0].subresourceRange.baseArrayLayer = 0;
-    imageBarriers[0].subresourceRange.layerCount = 1;
-    
-    // Normal buffer barrier
-    imageBarriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageBarriers[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    imageBarriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageBarriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[1].image = frameContext.gBufferNormalImage;
-    imageBarriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageBarriers[1].subresourceRange.baseMipLevel = 0;
-    imageBarriers[1].subresourceRange.levelCount = 1;
-    imageBarriers[1].subresourceRange.baseArrayLayer = 0;
-    imageBarriers[1].subresourceRange.layerCount = 1;
-    
-    // Albedo buffer barrier
-    imageBarriers[2].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageBarriers[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    imageBarriers[2].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageBarriers[2].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[2].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[2].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[2].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[2].image = frameContext.gBufferAlbedoImage;
-    imageBarriers[2].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageBarriers[2].subresourceRange.baseMipLevel = 0;
-    imageBarriers[2].subresourceRange.levelCount = 1;
-    imageBarriers[2].subresourceRange.baseArrayLayer = 0;
-    imageBarriers[2].subresourceRange.layerCount = 1;
-    
-    // Material buffer barrier
-    imageBarriers[3].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageBarriers[3].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    imageBarriers[3].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageBarriers[3].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[3].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageBarriers[3].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[3].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[3].image = frameContext.gbufferMaterialImage;
-    imageBarriers[3].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageBarriers[3].subresourceRange.baseMipLevel = 0;
-    imageBarriers[3].subresourceRange.levelCount = 1;
-    imageBarriers[3].subresourceRange.baseArrayLayer = 0;
-    imageBarriers[3].subresourceRange.layerCount = 1;
- 
-    // Depth buffer barrier
-    imageBarriers[4].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    imageBarriers[4].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    imageBarriers[4].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageBarriers[4].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-    imageBarriers[4].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-    imageBarriers[4].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[4].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageBarriers[4].image = frameContext.depthImage;
-    imageBarriers[4].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    imageBarriers[4].subresourceRange.baseMipLevel = 0;
-    imageBarriers[4].subresourceRange.levelCount = 1;
-    imageBarriers[4].subresourceRange.baseArrayLayer = 0;
-    imageBarriers[4].subresourceRange.layerCount = 1;
 
-    
+    // The slot buffer is shared by all frames in flight: wait for earlier frames to stop reading it
+    // (execution dependency only) and make the host-written staging data visible to the copy
+    VkBufferMemoryBarrier stagingBarrier{};
+    stagingBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    stagingBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
+    stagingBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    stagingBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    stagingBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    stagingBarrier.buffer = frameContext.lightSlotStagingBuffer->getBuffer();
+    stagingBarrier.offset = 0;
+    stagingBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, nullptr,
+        1, &stagingBarrier,
+        0, nullptr
+    );
+
+    // Only the slots whose light changed since the last upload
+    vkCmdCopyBuffer(
+        commandBuffer,
+        frameContext.lightSlotStagingBuffer->getBuffer(),
+        frameContext.lightSlotBuffer->getBuffer(),
+        static_cast<uint32_t>(frameContext.lightSlotCopyRegions.size()),
+        frameContext.lightSlotCopyRegions.data()
+    );
+
+    VkBufferMemoryBarrier slotBarrier{};
+    slotBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    slotBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    slotBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    slotBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    slotBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    slotBarrier.buffer = frameContext.lightSlotBuffer->getBuffer();
+    slotBarrier.offset = 0;
+    slotBarrier.size = VK_WHOLE_SIZE;
 
     vkCmdPipelineBarrier(
         commandBuffer,
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         0,
         0, nullptr,
-        static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
-        static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data()
+        1, &slotBarrier,
+        0, nullptr
     );
 }
 
@@ -36,7 +36,6 @@ public:
 
     LightPass(
         Device& device, 
-        SwapChain& swapChain, 
         const CreateInfo& createInfo);
     ~LightPass();
 
@@ -44,6 +43,8 @@ public:
     LightPass& operator=(const LightPass&) = delete;
 
     void run(FrameContext& frameContext);
+    // Rebuilds the framebuffers over the new light pass targets; the pipeline outlives window resizes
+    void resize(const CreateInfo& createInfo);
    
    
 private:
@@ -51,15 +52,16 @@ private:
     void createRenderPass(const CreateInfo& createInfo);
     void createPipeline(const CreateInfo& createInfo);
     void createFramebuffers(const CreateInfo& createInfo);
+    void destroyFramebuffers();
 
     void transitionGBufferImages(VkCommandBuffer commandBuffer);
-    void setBarriers(FrameContext& frameContext);
+    // Copies dirty light slots from this frame's staging buffer into the persistent slot buffer
+    void uploadLightSlots(FrameContext& frameContext);
     VkWriteDescriptorSet createWrite(VkDescriptorSet dstSet, uint32_t binding, VkDescriptorImageInfo* imageInfo);
     void beginRenderPass(FrameContext& frameContext);
     void endRenderPass(FrameContext& frameContext);
 
     Device& device;
-    SwapChain& swapChain;    
     uint32_t width;
     uint32_t height;
 
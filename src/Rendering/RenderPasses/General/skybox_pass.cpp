@@ -17,45 +17,30 @@ SkyboxPass::~SkyboxPass() {
     cleanup();
 }
 
-void SkyboxPass::setBarriers(FrameContext& frameContext){
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = frameContext.gBufferAlbedoImage;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    vkCmdPipelineBarrier(
-        frameContext.commandBuffer,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, // previous usage
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, // next usage
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
+void SkyboxPass::resize(const CreateInfo& createInfo) {
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+    framebuffers.fill(VK_NULL_HANDLE);
+    width = createInfo.width;
+    height = createInfo.height;
+    createFramebuffers(createInfo);
 }
 
-void SkyboxPass::cleanup() {
-    // Destroy framebuffers
+void SkyboxPass::destroyFramebuffers() {
     for (auto framebuffer : framebuffers) {
         vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
     }
+    framebuffers.fill(VK_NULL_HANDLE);
+}
+
+void SkyboxPass::cleanup() {
+    destroyFramebuffers();
     
-    // Destroy pipeline resources
+    // Destroy pipeline resources; the pipeline first, its creation job reads the layout
+    pipeline.reset();
     if (pipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(device.getDevice(), pipelineLayout, nullptr);
         pipelineLayout = VK_NULL_HANDLE;
     }
-    pipeline.reset();
     
     // Destroy render pass
     vkDestroyRenderPass(device.getDevice(), renderPass, nullptr);
@@ -183,7 +168,7 @@ void SkyboxPass::createFramebuffers(const CreateInfo& createInfo) {
     std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> albedoViews = *createInfo.albedoViewsPtr;
     std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> depthViews = *createInfo.depthViewsPtr;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
         std::array<VkImageView, 2> attachments = {
             albedoViews[i],      // Light pass output instead of albedo
             depthViews[i]   // Depth buffer stays the same
@@ -236,9 +221,6 @@ void SkyboxPass::endRenderPass(FrameContext& frameContext) {
 }
 
 void SkyboxPass::run(FrameContext& frameContext) {
-
-    setBarriers(frameContext);
-    
     beginRenderPass(frameContext);
     
     // Bind pipeline
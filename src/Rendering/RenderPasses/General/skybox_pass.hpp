@@ -40,15 +40,17 @@ namespace Rendering{
                 const CreateInfo& createInfo);
             ~SkyboxPass();
             void run(FrameContext& frameContext);
+            // Recreates the framebuffers for the new extent and views, keeping the pipeline
+            void resize(const CreateInfo& createInfo);
         private:
             void cleanup();
             void createRenderPass(const CreateInfo& createInfo);
             void createPipeline(const CreateInfo& createInfo);
             void createFramebuffers(const CreateInfo& createInfo);
+            void destroyFramebuffers();
 
             void beginRenderPass(FrameContext& frameContext);
             void endRenderPass(FrameContext& frameContext);
-            void setBarriers(FrameContext& frameContext);            
             Device& device;
             VkRenderPass renderPass{VK_NULL_HANDLE}; 
             std::unique_ptr<Pipeline> pipeline{nullptr};
@@ -1,4 +1,5 @@
 #include "geometry_pass.hpp"
+#include <algorithm>
 #include <array>
 #include <stdexcept>
 #include <iostream>
@@ -23,18 +24,31 @@ namespace Rendering {
 
    
 
-    void GeometryPass::cleanup() {
-            // Clean up framebuffers
+    void GeometryPass::resize(const CreateInfo& createInfo) {
+        device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+        framebuffers.fill(VK_NULL_HANDLE);
+        width = createInfo.width;
+        height = createInfo.height;
+        createFramebuffers(createInfo);
+    }
+
+    void GeometryPass::destroyFramebuffers() {
         for (auto framebuffer : framebuffers) {
             vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
         }
+        framebuffers.fill(VK_NULL_HANDLE);
+    }
 
+    void GeometryPass::cleanup() {
+        destroyFramebuffers();
 
+
+        // The pipeline first, its creation job reads the layout
+        pipeline.reset();
         if (pipelineLayout != VK_NULL_HANDLE) {
             vkDestroyPipelineLayout(device.getDevice(), pipelineLayout, nullptr);
             pipelineLayout = VK_NULL_HANDLE;
         }
-        pipeline.reset();
 
          // Clean up render pass and pipeline resources
         if (renderPass != VK_NULL_HANDLE) {
@@ -143,7 +157,7 @@ namespace Rendering {
         
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> depthViews = *createInfo.depthViewsPtr;
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
             std::array<VkImageView, 5> attachments = {
                 createInfo.gBuffer->getPositionView(i),
                 createInfo.gBuffer->getNormalView(i),
@@ -167,7 +181,7 @@ namespace Rendering {
         }
     }
 
-    void GeometryPass::beginRenderPass(FrameContext& frameContext) {
+    void GeometryPass::beginRenderPass(FrameContext& frameContext, VkSubpassContents contents) {
         std::array<VkClearValue, 5> clearValues{};
         clearValues[0].color = {0.0f, 0.0f, 0.0f, 0.0f};  // Position w=0 is used for cascade building
         clearValues[1].color = {0.0f, 0.0f, 0.0f, 1.0f};  // Normal
@@ -184,8 +198,11 @@ namespace Rendering {
         renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
         renderPassInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, contents);
+    }
 
+    void GeometryPass::bindPipelineState(const FrameContext& frameContext, VkCommandBuffer commandBuffer) {
+        // Dynamic state is not inherited by secondary command buffers, every chunk sets its own
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
@@ -198,8 +215,16 @@ namespace Rendering {
         scissor.offset = {0, 0};
         scissor.extent = {width, height};
 
-        vkCmdSetViewport(frameContext.commandBuffer, 0, 1, &viewport);
-        vkCmdSetScissor(frameContext.commandBuffer, 0, 1, &scissor);
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        vkCmdBindPipeline(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipeline->getPipeline()
+            );
+
+        updateCameraModelMatrixDescriptors(frameContext, commandBuffer);
     }
 
     void GeometryPass::endRenderPass(FrameContext& frameContext) {
@@ -264,21 +289,40 @@ namespace Rendering {
 
     }
 
-    void GeometryPass::run(FrameContext& frameContext) {
-        setBarriers(frameContext);
-        beginRenderPass(frameContext);
-        vkCmdBindPipeline(
-            frameContext.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipeline->getPipeline()
-            );
+    void GeometryPass::prepare(FrameContext& frameContext) {
+        // Contiguous chunks keep the draw order of the batches; small scenes stay in one job
+        ParallelRecorder* recorder = frameContext.parallelRecorder;
+        const uint32_t batchCount = frameContext.opaqueMaterialBatchCount;
+        const uint32_t maxJobs = (batchCount + PARALLEL_RECORDING_MIN_BATCHES - 1) / PARALLEL_RECORDING_MIN_BATCHES;
+        const uint32_t jobCount = std::max(1u, std::min(recorder->getThreadCount(), maxJobs));
+        const ParallelRecorder::Inheritance inheritance{renderPass, 0, framebuffers[frameContext.frameIndex]};
+        const FrameContext* context = &frameContext;
+
+        chunkJobs.clear();
+        for (uint32_t job = 0; job < jobCount; job++) {
+            const uint32_t begin = batchCount * job / jobCount;
+            const uint32_t end = batchCount * (job + 1) / jobCount;
+            chunkJobs.push_back(recorder->record(inheritance, [this, context, begin, end](VkCommandBuffer commandBuffer) {
+                bindPipelineState(*context, commandBuffer);
+                drawBatches(*context, commandBuffer, begin, end);
+            }));
+        }
+    }
 
-        updateCameraModelMatrixDescriptors(frameContext);
-        drawBatches(frameContext);
+    void GeometryPass::run(FrameContext& frameContext) {
+        // With a parallel recorder the draws were recorded by prepare()
+        if (ParallelRecorder* recorder = frameContext.parallelRecorder) {
+            beginRenderPass(frameContext, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            recorder->execute(frameContext.commandBuffer, chunkJobs.data(), static_cast<uint32_t>(chunkJobs.size()));
+        } else {
+            beginRenderPass(frameContext, VK_SUBPASS_CONTENTS_INLINE);
+            bindPipelineState(frameContext, frameContext.commandBuffer);
+            drawBatches(frameContext, frameContext.commandBuffer, 0, frameContext.opaqueMaterialBatchCount);
+        }
         endRenderPass(frameContext);
     }
 
-    void GeometryPass::updateCameraModelMatrixDescriptors(FrameContext& frameContext) {
+    void GeometryPass::updateCameraModelMatrixDescriptors(const FrameContext& frameContext, VkCommandBuffer commandBuffer) {
     
         std::array<VkDescriptorSet, 2> descriptorSets = {
             frameContext.cameraDescriptorSet, 
@@ -286,7 +330,7 @@ namespace Rendering {
         };
 
         vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
+            commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             pipelineLayout,
             0,
@@ -298,13 +342,13 @@ namespace Rendering {
            
     }
   
-    void GeometryPass::drawBatches(FrameContext& frameContext) {
+    void GeometryPass::drawBatches(const FrameContext& frameContext, VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) {
 
-        for (uint32_t i = 0; i < frameContext.opaqueMaterialBatchCount; i++) {
+        for (uint32_t i = begin; i < end; i++) {
             const auto& materialBatch = frameContext.opaqueMaterialBatches[i];
             VkDescriptorSet materialDescriptorSet = materialBatch.material->getMaterialDescriptorSet();
             vkCmdBindDescriptorSets(
-                frameContext.commandBuffer,
+                commandBuffer,
                 VK_PIPELINE_BIND_POINT_GRAPHICS,
                 pipelineLayout,
                 2,
@@ -316,7 +360,7 @@ namespace Rendering {
         
             uint32_t bufferIndexOffset=materialBatch.matrixOffset;
             vkCmdPushConstants(
-                frameContext.commandBuffer,
+                commandBuffer,
                 pipelineLayout,
                 VK_SHADER_STAGE_VERTEX_BIT,
                 0,
@@ -326,55 +370,10 @@ namespace Rendering {
        
             // Bind the mesh
             auto mesh = materialBatch.mesh;
-            mesh->bind(frameContext.commandBuffer);           
-            mesh->drawSubmeshInstanced(frameContext.commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);
+            mesh->bind(commandBuffer);           
+            mesh->drawSubmeshInstanced(commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);
         }
         
     }
     
-    void GeometryPass::setBarriers(FrameContext& frameContext) {
-        VkCommandBuffer commandBuffer = frameContext.commandBuffer;
-        // We need barriers for instance model matrices, normal matrices, and camera UBO
-        std::array<VkBufferMemoryBarrier, 3> barriers{};
-        
-        // Instance model matrices barrier
-        barriers[0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-        barriers[0].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[0].buffer = frameContext.modelMatrixBuffer->getBuffer();
-        barriers[0].offset = 0;
-        barriers[0].size = VK_WHOLE_SIZE;
-        
-        // Instance normal matrices barrier
-        barriers[1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-        barriers[1].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[1].buffer = frameContext.normalMatrixBuffer->getBuffer();
-        barriers[1].offset = 0;
-        barriers[1].size = VK_WHOLE_SIZE;
-        
-        // Camera uniform buffer barrier
-        barriers[2].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-        barriers[2].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-        barriers[2].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        barriers[2].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[2].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barriers[2].buffer = frameContext.cameraUniformBuffer->getBuffer();
-        barriers[2].offset = 0;
-        barriers[2].size = VK_WHOLE_SIZE;
-        
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            VK_PIPELINE_STAGE_HOST_BIT,               
-            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,      
-            0,                                        
-            0, nullptr,                                
-            static_cast<uint32_t>(barriers.size()), barriers.data(),  
-            0, nullptr                                 
-        );
-    }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Rendering/RenderPasses/render_passes_buffers.hpp"
 #include "Rendering/Core/swapchain.hpp"
 #include "Rendering/Core/pipeline.hpp"
+#include "Rendering/Core/parallel_recorder.hpp"
 #include "ECS/ecs.hpp"
 #include "ECS/components.hpp"
 #include "ECS/ecs_types.hpp"
@@ -11,6 +12,7 @@
 #include "Rendering/Resources/rendering_resources.hpp"
 #include "Rendering/Core/frame_context.hpp"
 #include <array>
+#include <vector>
 
 using namespace ECS;
 namespace Rendering {
@@ -38,18 +40,25 @@ public:
 
    
     VkRenderPass getRenderPass() const { return renderPass; }
+    // With a parallel recorder in the frame context: queues the opaque batches as secondary command buffers,
+    // split into chunks across the workers, which run() then executes in order
+    void prepare(FrameContext& frameContext);
     void run(FrameContext& frameContext);
+    // Window resize: new G-buffer views and extent, same render pass and pipeline
+    void resize(const CreateInfo& createInfo);
 private:
     void cleanup();
 
     void createPipeline(const CreateInfo& createInfo);
     void createRenderPass(const CreateInfo& createInfo);
     void createFramebuffers(const CreateInfo& createInfo);
-    void updateCameraModelMatrixDescriptors(FrameContext& frameContext);
-    void drawBatches(FrameContext& frameContext);
-    void beginRenderPass(FrameContext& frameContext);
+    void destroyFramebuffers();
+    void updateCameraModelMatrixDescriptors(const FrameContext& frameContext, VkCommandBuffer commandBuffer);
+    // Viewport, scissor, pipeline and the camera and model sets
+    void bindPipelineState(const FrameContext& frameContext, VkCommandBuffer commandBuffer);
+    void drawBatches(const FrameContext& frameContext, VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end);
+    void beginRenderPass(FrameContext& frameContext, VkSubpassContents contents);
     void endRenderPass(FrameContext& frameContext);
-    void setBarriers(FrameContext& frameContext);
  
     Device& device;
     uint32_t width;
@@ -61,6 +70,7 @@ private:
     
     VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
     std::array<VkFramebuffer,MAX_FRAMES_IN_FLIGHT> framebuffers{};  
+    std::vector<ParallelRecorder::Job> chunkJobs;   // of the frame, from prepare()
 
 
 };
@@ -1,4 +1,5 @@
 #include "rc_gi_pass.hpp"
+#include "Rendering/Core/gpu_profiler.hpp"
 
 #include <algorithm>
 #include <stdexcept>
@@ -31,6 +32,7 @@ RCGIPass::RCGIPass(Device& device, const CreateInfo& createInfo)
     }
 
     createDepthPyramidPipeline();
+    createDepthBoundsPipeline();
     createRCBuildPipeline();
     createRCMergePipeline();
     createRCResolvePipeline();
@@ -47,6 +49,13 @@ RCGIPass::~RCGIPass() {
         vkDestroyPipelineLayout(device.getDevice(), depthPyramidPipelineLayout, nullptr);
         depthPyramidPipelineLayout = VK_NULL_HANDLE;
     }
+    if (depthBoundsPipeline) {
+        depthBoundsPipeline.reset();
+    }
+    if (depthBoundsPipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device.getDevice(), depthBoundsPipelineLayout, nullptr);
+        depthBoundsPipelineLayout = VK_NULL_HANDLE;
+    }
     if (rcSampler != VK_NULL_HANDLE) {
         vkDestroySampler(device.getDevice(), rcSampler, nullptr);
         rcSampler = VK_NULL_HANDLE;
@@ -102,6 +111,124 @@ void RCGIPass::createDepthPyramidPipeline() {
     );
 }
 
+void RCGIPass::createDepthBoundsPipeline() {
+    if (!Rendering::SDSM_ENABLED || info.depthBoundsSetLayout == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkPushConstantRange pcRange{};
+    pcRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pcRange.offset = 0;
+    pcRange.size = static_cast<uint32_t>(sizeof(DepthBoundsPushConstants));
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &info.depthBoundsSetLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pcRange;
+
+    if (vkCreatePipelineLayout(device.getDevice(), &layoutInfo, nullptr, &depthBoundsPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout for depth bounds reduction");
+    }
+
+    ComputePipelineConfigInfo cfg{};
+    cfg.pipelineLayout = depthBoundsPipelineLayout;
+    depthBoundsPipeline = std::make_unique<ComputePipeline>(
+        device,
+        "shaders/sdsm_depth_bounds.comp.spv",
+        cfg
+    );
+}
+
+void RCGIPass::reduceDepthBounds(FrameContext& frameContext) {
+    if (!depthBoundsPipeline || frameContext.depthPyramidMipLevels == 0u) {
+        return;
+    }
+    VkCommandBuffer cmd = frameContext.commandBuffer;
+    VkBuffer boundsBuffer = frameContext.depthBoundsBuffer->getBuffer();
+
+    // Reset: min = FLT_MAX bits, max/count = 0. The host already consumed last use's values in updateFrameContext.
+    vkCmdFillBuffer(cmd, boundsBuffer, 0, sizeof(uint32_t), 0x7F7FFFFFu);
+    vkCmdFillBuffer(cmd, boundsBuffer, sizeof(uint32_t), sizeof(DepthBoundsBuffer) - sizeof(uint32_t), 0u);
+
+    VkBufferMemoryBarrier resetBarrier{};
+    resetBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    resetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    resetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    resetBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    resetBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    resetBarrier.buffer = boundsBuffer;
+    resetBarrier.offset = 0;
+    resetBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0,
+        0, nullptr,
+        1, &resetBarrier,
+        0, nullptr
+    );
+
+    // Pick the finest mip that is at most SDSM_REDUCTION_MAX_WIDTH wide
+    uint32_t sourceMip = 0;
+    while (sourceMip + 1 < frameContext.depthPyramidMipLevels &&
+           std::max(1u, info.width >> sourceMip) > Rendering::SDSM_REDUCTION_MAX_WIDTH) {
+        ++sourceMip;
+    }
+    const uint32_t mipWidth = std::max(1u, info.width >> sourceMip);
+    const uint32_t mipHeight = std::max(1u, info.height >> sourceMip);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, depthBoundsPipeline->getPipeline());
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        depthBoundsPipelineLayout,
+        0,
+        1,
+        &frameContext.depthBoundsDescriptorSet,
+        0,
+        nullptr
+    );
+
+    DepthBoundsPushConstants pc{};
+    pc.sourceMip = static_cast<int>(sourceMip);
+    pc.cameraFar = frameContext.cameraData.farPlane;
+    vkCmdPushConstants(
+        cmd,
+        depthBoundsPipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(DepthBoundsPushConstants),
+        &pc
+    );
+
+    const uint32_t groupSizeX = 8;
+    const uint32_t groupSizeY = 8;
+    depthBoundsPipeline->dispatch(
+        cmd,
+        (mipWidth + groupSizeX - 1) / groupSizeX,
+        (mipHeight + groupSizeY - 1) / groupSizeY,
+        1);
+
+    // Make the result visible to the host once this frame's fence signals
+    VkBufferMemoryBarrier readbackBarrier = resetBarrier;
+    readbackBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &readbackBarrier,
+        0, nullptr
+    );
+}
+
 void RCGIPass::createRCBuildPipeline() {
     // Push constants: cascadeIndex, probeStridePx, tileSize, depthMipCount, frameIndex, tStart, segmentLen
     VkPushConstantRange pcRange{};
@@ -242,6 +369,8 @@ void RCGIPass::mergeRCCascades(FrameContext& frameContext) {
         if (dispatchInfo.groupsX == 0u || dispatchInfo.groupsY == 0u) {
             continue;
         }
+        // Merges are serialized by their barriers, so each one can be timed (builds overlap and cannot)
+        GpuProfileScope scope(frameContext.gpuProfiler, cmd, "RC merge cascade", cascade);
 
         vkCmdPushConstants(
             cmd,
@@ -415,86 +544,23 @@ void RCGIPass::resolveIndirect(FrameContext& frameContext) {
     rcResolvePipeline->dispatch(cmd, groupsX, groupsY, 1);
 }
 
-void RCGIPass::setDepthPyramidBarriersBefore(FrameContext& frameContext) {
-    VkCommandBuffer cmd = frameContext.commandBuffer;
-
-    // Make scene depth visible to COMPUTE sampling
-    VkImageMemoryBarrier depthBarrier{};
-    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    depthBarrier.image = frameContext.depthImage;
-    depthBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    depthBarrier.subresourceRange.baseMipLevel = 0;
-    depthBarrier.subresourceRange.levelCount = 1;
-    depthBarrier.subresourceRange.baseArrayLayer = 0;
-    depthBarrier.subresourceRange.layerCount = 1;
-
-    // Transition mip 0 to GENERAL for write
-    VkImageMemoryBarrier mip0ToGeneral{};
-    mip0ToGeneral.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    mip0ToGeneral.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    mip0ToGeneral.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    mip0ToGeneral.image = frameContext.depthPyramidImage;
-    mip0ToGeneral.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    mip0ToGeneral.subresourceRange.baseMipLevel = 0;
-    mip0ToGeneral.subresourceRange.levelCount = 1;
-    mip0ToGeneral.subresourceRange.baseArrayLayer = 0;
-    mip0ToGeneral.subresourceRange.layerCount = 1;
-    // Previous writer was depth attachment; be explicit about the dependency.
-    mip0ToGeneral.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    mip0ToGeneral.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    mip0ToGeneral.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    mip0ToGeneral.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-
-    std::array<VkImageMemoryBarrier, 2> barriers{depthBarrier, mip0ToGeneral};
-    vkCmdPipelineBarrier(
-        cmd,
-        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        0,
-        0, nullptr,
-        0, nullptr,
-        static_cast<uint32_t>(barriers.size()), barriers.data()
-    );
-}
-
-
 void RCGIPass::setMipLevelBarriers(FrameContext& frameContext, uint32_t mipLevel) {
-    
+    // The render graph hands the pyramid over in GENERAL; only the mip just written moves to READ_ONLY
     VkCommandBuffer cmd = frameContext.commandBuffer;
-    VkImageMemoryBarrier barriers[2]{};           
-    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; // prev mip to READ_ONLY
-    barriers[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    barriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[0].image = frameContext.depthPyramidImage;
-    barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barriers[0].subresourceRange.baseMipLevel =mipLevel - 1;
-    barriers[0].subresourceRange.levelCount = 1;
-    barriers[0].subresourceRange.baseArrayLayer = 0;
-    barriers[0].subresourceRange.layerCount = 1;
-
-    barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER; // dst mip to GENERAL
-    barriers[1].srcAccessMask = 0;
-    barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // conservative starting state
-    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barriers[1].image = frameContext.depthPyramidImage;
-    barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barriers[1].subresourceRange.baseMipLevel = mipLevel;
-    barriers[1].subresourceRange.levelCount = 1;
-    barriers[1].subresourceRange.baseArrayLayer = 0;
-    barriers[1].subresourceRange.layerCount = 1;
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = frameContext.depthPyramidImage;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = mipLevel - 1;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
 
     vkCmdPipelineBarrier(
         cmd,
@@ -503,7 +569,7 @@ void RCGIPass::setMipLevelBarriers(FrameContext& frameContext, uint32_t mipLevel
         0,
         0, nullptr,
         0, nullptr,
-        2, barriers
+        1, &barrier
     );
 }
 
@@ -540,7 +606,6 @@ void RCGIPass::setDepthPyramidCompletedBarriers(FrameContext& frameContext) {
 }
 
 void RCGIPass::buildDepthPyramid(FrameContext& frameContext) {
-    setDepthPyramidBarriersBefore(frameContext);
     VkCommandBuffer cmd = frameContext.commandBuffer;
     // Seed mip 0
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, depthPyramidSeedPipeline->getPipeline());
@@ -603,11 +668,29 @@ void RCGIPass::buildDepthPyramid(FrameContext& frameContext) {
 }
 
 void RCGIPass::run(FrameContext& frameContext) {
+    GpuProfiler* profiler = frameContext.gpuProfiler;
+    VkCommandBuffer cmd = frameContext.commandBuffer;
     computeCascadeBands();
-    buildDepthPyramid(frameContext);
-    buildRCCascades(frameContext);
-    mergeRCCascades(frameContext);
-    resolveIndirect(frameContext);
+    {
+        GpuProfileScope scope(profiler, cmd, "Depth pyramid");
+        buildDepthPyramid(frameContext);
+    }
+    {
+        GpuProfileScope scope(profiler, cmd, "Depth bounds");
+        reduceDepthBounds(frameContext);
+    }
+    {
+        GpuProfileScope scope(profiler, cmd, "RC build cascades");
+        buildRCCascades(frameContext);
+    }
+    {
+        GpuProfileScope scope(profiler, cmd, "RC merge");
+        mergeRCCascades(frameContext);
+    }
+    {
+        GpuProfileScope scope(profiler, cmd, "RC resolve");
+        resolveIndirect(frameContext);
+    }
 }
 
 void RCGIPass::emitComputeBarrier(VkCommandBuffer cmd) const {
@@ -20,6 +20,7 @@ namespace Rendering {
             uint32_t height{0};
             VkDescriptorSetLayout depthPyramidSetLayout{VK_NULL_HANDLE};
             VkFormat depthPyramidFormat{VK_FORMAT_UNDEFINED};
+            VkDescriptorSetLayout depthBoundsSetLayout{VK_NULL_HANDLE};
             VkDescriptorSetLayout rcBuildSetLayout{VK_NULL_HANDLE};
             VkDescriptorSetLayout rcResolveSetLayout{VK_NULL_HANDLE};
             VkDescriptorSetLayout skyboxSetLayout{VK_NULL_HANDLE};
@@ -33,6 +34,8 @@ namespace Rendering {
 
         // Entry point: sequences compute stages
         void run(FrameContext& frameContext);
+        // Dispatch sizes follow the extent; the pipelines do not depend on it
+        void resize(const CreateInfo& createInfo) { info.width = createInfo.width; info.height = createInfo.height; }
 
 
 
@@ -40,10 +43,13 @@ namespace Rendering {
         // Depth pyramid stage (current)
         void createDepthPyramidPipeline();
         void buildDepthPyramid(FrameContext& frameContext);
-        void setDepthPyramidBarriersBefore(FrameContext& frameContext);
         void setMipLevelBarriers(FrameContext& frameContext, uint32_t mipLevel);
         void setDepthPyramidCompletedBarriers(FrameContext& frameContext);
 
+        // SDSM: reduce a coarse pyramid mip to the visible min/max depth for the light system to read back
+        void createDepthBoundsPipeline();
+        void reduceDepthBounds(FrameContext& frameContext);
+
 
         // RC build/resolve stages
         void createRCBuildPipeline();
@@ -83,6 +89,11 @@ namespace Rendering {
             float padding;
         };
 
+        struct DepthBoundsPushConstants {
+            int sourceMip;
+            float cameraFar;
+        };
+
         struct CascadeBand {
             float start;
             float length;
@@ -100,6 +111,10 @@ namespace Rendering {
         std::unique_ptr<ComputePipeline> depthPyramidDownsamplePipeline;
         VkSampler rcSampler{VK_NULL_HANDLE};
 
+        // Depth bounds reduction (SDSM)
+        VkPipelineLayout depthBoundsPipelineLayout{VK_NULL_HANDLE};
+        std::unique_ptr<ComputePipeline> depthBoundsPipeline;
+
         // RC build/resolve compute
         VkPipelineLayout rcBuildPipelineLayout{VK_NULL_HANDLE};        
         VkPipelineLayout rcResolvePipelineLayout{VK_NULL_HANDLE};
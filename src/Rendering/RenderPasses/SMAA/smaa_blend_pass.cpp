@@ -20,13 +20,26 @@ SMAABlendPass::~SMAABlendPass() {
     cleanup();
 }
 
-void SMAABlendPass::cleanup() {
+void SMAABlendPass::resize(const CreateInfo& info) {
+    device.getDeletionQueue().retireFramebuffers(device.getDevice(), framebuffers);
+    framebuffers.fill(VK_NULL_HANDLE);
+    width = info.width;
+    height = info.height;
+    targetViews = info.targetViews;
+    createFramebuffers();
+}
+
+void SMAABlendPass::destroyFramebuffers() {
     for (auto framebuffer : framebuffers) {
         if (framebuffer != VK_NULL_HANDLE) {
             vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
         }
     }
     framebuffers.fill(VK_NULL_HANDLE);
+}
+
+void SMAABlendPass::cleanup() {
+    destroyFramebuffers();
 
     pipeline.reset();
     if (pipelineLayout != VK_NULL_HANDLE) {
@@ -82,7 +95,7 @@ void SMAABlendPass::createRenderPass() {
 }
 
 void SMAABlendPass::createFramebuffers() {
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
         std::array<VkImageView, 1> attachments = {
             (*targetViews)[i]
         };
@@ -145,6 +158,21 @@ void SMAABlendPass::beginRenderPass(FrameContext& frameContext) {
     renderPassInfo.pClearValues = &clearValue;
 
     vkCmdBeginRenderPass(frameContext.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    // Set viewport and scissor
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(width);
+    viewport.height = static_cast<float>(height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(frameContext.commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = {width, height};
+    vkCmdSetScissor(frameContext.commandBuffer, 0, 1, &scissor);
 }
 
 void SMAABlendPass::endRenderPass(FrameContext& frameContext) {
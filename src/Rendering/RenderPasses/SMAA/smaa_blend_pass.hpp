@@ -23,11 +23,14 @@ public:
     SMAABlendPass& operator=(const SMAABlendPass&) = delete;
 
     void run(FrameContext& frameContext);
+    // Recreates the framebuffers only
+    void resize(const CreateInfo& info);
 
 private:
     void cleanup();
     void createRenderPass();
     void createFramebuffers();
+    void destroyFramebuffers();
     void createPipeline();
     void beginRenderPass(FrameContext& frameContext);
     void endRenderPass(FrameContext& frameContext);
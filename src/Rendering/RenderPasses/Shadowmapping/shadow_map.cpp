@@ -34,6 +34,11 @@ void ShadowMap::cleanup() {
     }
     layerViews.clear();
 
+    if (arrayView != VK_NULL_HANDLE) {
+        vkDestroyImageView(device.getDevice(), arrayView, nullptr);
+        arrayView = VK_NULL_HANDLE;
+    }
+
     if (depthView != VK_NULL_HANDLE) {
         vkDestroyImageView(device.getDevice(), depthView, nullptr);
         depthView = VK_NULL_HANDLE;
@@ -152,6 +157,16 @@ void ShadowMap::createImageView() {
         throw std::runtime_error("failed to create shadow map image view!");
     }
 
+    // Cube views cannot back a multiview framebuffer, so expose the same layers as a 2D array
+    if (arrayLayers > 1) {
+        VkImageViewCreateInfo arrayViewInfo = viewInfo;
+        arrayViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+
+        if (vkCreateImageView(device.getDevice(), &arrayViewInfo, nullptr, &arrayView) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create shadow map array image view!");
+        }
+    }
+
     // Create per-layer 2D views for single-layer rendering when arrayLayers > 1
     layerViews.resize(arrayLayers);
     for (uint32_t layer = 0; layer < arrayLayers; ++layer) {
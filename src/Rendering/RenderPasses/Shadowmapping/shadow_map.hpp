@@ -25,6 +25,8 @@ public:
    
     VkImageView getImageView() const { return depthView; }
     VkImageView getLayerImageView(uint32_t layer) const { return layerViews[layer]; }
+    // 2D array view over every layer, used as a multiview framebuffer attachment
+    VkImageView getArrayImageView() const { return arrayView; }
     VkSampler getSampler() const { return shadowSampler; }
     VkImage getImage() const { return depthImage; }
 
@@ -43,6 +45,7 @@ protected:
     VkImage depthImage{};
     VkDeviceMemory depthMemory{};
     VkImageView depthView{};
+    VkImageView arrayView{VK_NULL_HANDLE};
     std::vector<VkImageView> layerViews{};
 };
 
@@ -1,5 +1,7 @@
 #include "shadow_pass.hpp"
 #include "Rendering/Resources/mesh.hpp"
+#include "Rendering/Core/gpu_profiler.hpp"
+#include "Rendering/Core/parallel_recorder.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <vector>
@@ -27,6 +29,9 @@ ShadowPass::ShadowPass(Device& device, CreateInfo& createInfo)
     depthFormat = device.getDepthFormat();
     
     createRenderPass();
+    if (device.supportsMultiview()) {
+        createMultiviewRenderPass();
+    }
     createFramebuffers(createInfo);
     createPipelines(createInfo); 
 }
@@ -45,6 +50,7 @@ void ShadowPass::cleanup() {
     directionalLightPipeline.reset();
     spotLightPipeline.reset();
     pointLightPipeline.reset();
+    pointLightMultiviewPipeline.reset();
     
 
     if (directionalPipelineLayout != VK_NULL_HANDLE) {
@@ -68,6 +74,11 @@ void ShadowPass::cleanup() {
         shadowRenderPass = VK_NULL_HANDLE;
     }
 
+    if (pointMultiviewRenderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(device.getDevice(), pointMultiviewRenderPass, nullptr);
+        pointMultiviewRenderPass = VK_NULL_HANDLE;
+    }
+
 
     std::cout << "Shadow pass cleaned up" << std::endl;
 }
@@ -129,6 +140,70 @@ void ShadowPass::createRenderPass() {
     }
 }
 
+void ShadowPass::createMultiviewRenderPass() {
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference depthReference{};
+    depthReference.attachment = 0;
+    depthReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 0;
+    subpass.pDepthStencilAttachment = &depthReference;
+
+    std::array<VkSubpassDependency, 2> dependencies{};
+
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // One view per cube face; faces are rendered independently so no correlation is declared
+    const uint32_t viewMask = 0x3F;
+    const uint32_t correlationMask = 0;
+
+    VkRenderPassMultiviewCreateInfo multiviewInfo{};
+    multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+    multiviewInfo.subpassCount = 1;
+    multiviewInfo.pViewMasks = &viewMask;
+    multiviewInfo.correlationMaskCount = 1;
+    multiviewInfo.pCorrelationMasks = &correlationMask;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.pNext = &multiviewInfo;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &depthAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(device.getDevice(), &renderPassInfo, nullptr, &pointMultiviewRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create point light multiview render pass!");
+    }
+}
+
 
 void ShadowPass::createPipelines(const CreateInfo& createInfo) {
 
@@ -254,82 +329,116 @@ void ShadowPass::createPipelines(const CreateInfo& createInfo) {
         );
     }
 
-   
+    if (pointMultiviewRenderPass != VK_NULL_HANDLE) {
+        pipelineConfig.pipelineLayout = pointPipelineLayout;
+        pipelineConfig.renderPass = pointMultiviewRenderPass;
+
+        std::vector<ShaderStageInfo> stages = {
+            {VK_SHADER_STAGE_VERTEX_BIT, "shaders/shadowmap_multiview.vert.spv"},
+            {VK_SHADER_STAGE_FRAGMENT_BIT, "shaders/shadowmap.frag.spv"}
+        };
+        pointLightMultiviewPipeline = std::make_unique<Pipeline>(
+            device,
+            stages,
+            pipelineConfig
+        );
+    }
 }
 
 
-void ShadowPass::beginShadowRenderPass(
-    VkCommandBuffer commandBuffer, 
-    uint32_t frameIndex,
-    size_t lightIndex, 
-    LightType lightType,
-    uint32_t layerIndex) {
-    
-    VkFramebuffer framebuffer;
-    VkExtent2D extent;    
-    switch(lightType) {
+ShadowPass::ViewTarget ShadowPass::getViewTarget(const ShadowView& view, uint32_t frameIndex) const {
+    ViewTarget target{};
+    target.renderPass = shadowRenderPass;
+    switch (view.lightType) {
         case LightType::DIRECTIONAL_LIGHT:
-            framebuffer = directionalFramebuffers[lightIndex][frameIndex][layerIndex];
-            extent = {DIRECTIONAL_SHADOW_MAP_RES, DIRECTIONAL_SHADOW_MAP_RES};
+            target.framebuffer = directionalFramebuffers[view.shadowmapIndex][frameIndex][view.layer];
+            target.extent = {DIRECTIONAL_SHADOW_MAP_RES, DIRECTIONAL_SHADOW_MAP_RES};
+            target.pipeline = directionalLightPipeline.get();
+            target.pipelineLayout = directionalPipelineLayout;
+            target.label = "Directional shadow view";
             break;
         case LightType::POINT_LIGHT:
-            framebuffer = pointFramebuffers[lightIndex][frameIndex][layerIndex];
-            extent = {POINT_SHADOW_MAP_RES, POINT_SHADOW_MAP_RES};
+            target.extent = {POINT_SHADOW_MAP_RES, POINT_SHADOW_MAP_RES};
+            target.pipelineLayout = pointPipelineLayout;
+            if (view.multiview) {
+                // All six faces are written by one render pass; the vertex shader offsets the matrix by gl_ViewIndex
+                target.renderPass = pointMultiviewRenderPass;
+                target.framebuffer = pointMultiviewFramebuffers[view.shadowmapIndex][frameIndex];
+                target.pipeline = pointLightMultiviewPipeline.get();
+                target.label = "Point shadow cube";
+            } else {
+                target.framebuffer = pointFramebuffers[view.shadowmapIndex][frameIndex][view.layer];
+                target.pipeline = pointLightPipeline.get();
+                target.label = "Point shadow face";
+            }
             break;
         default: // Spot
-            framebuffer = spotFramebuffers[lightIndex][frameIndex];
-            extent = {SPOT_SHADOW_MAP_RES, SPOT_SHADOW_MAP_RES};
+            target.framebuffer = spotFramebuffers[view.shadowmapIndex][frameIndex];
+            target.extent = {SPOT_SHADOW_MAP_RES, SPOT_SHADOW_MAP_RES};
+            target.pipeline = spotLightPipeline.get();
+            target.pipelineLayout = spotPipelineLayout;
+            target.label = "Spot shadow view";
             break;
     }
-    
+    return target;
+}
+
+void ShadowPass::beginShadowRenderPass(VkCommandBuffer commandBuffer, const ViewTarget& target, VkSubpassContents contents) {
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = shadowRenderPass;
-    renderPassInfo.framebuffer = framebuffer;
+    renderPassInfo.renderPass = target.renderPass;
+    renderPassInfo.framebuffer = target.framebuffer;
     renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = extent;
+    renderPassInfo.renderArea.extent = target.extent;
 
     VkClearValue clearValue;
     clearValue.depthStencil = {1.0f, 0};
     renderPassInfo.clearValueCount = 1;
     renderPassInfo.pClearValues = &clearValue;
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // Set viewport and scissor
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = extent;
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
 }
 
 void ShadowPass::endShadowRenderPass(VkCommandBuffer commandBuffer) {
     vkCmdEndRenderPass(commandBuffer);
 }
 
-void ShadowPass::run(FrameContext& frameContext) {
-
-    setBarriers(frameContext);
-    
-    if (frameContext.directionalShadowcastingMaterialMap.size() > 0) {
-        renderDirectionalLights(frameContext);
-    }
-    
-    if (frameContext.spotShadowcastingMaterialMap.size() > 0) {
-        renderSpotLights(frameContext);
+void ShadowPass::prepare(FrameContext& frameContext) {
+    ParallelRecorder* recorder = frameContext.parallelRecorder;
+    viewJobs.clear();
+    for (const ShadowView& view : frameContext.shadowViews) {
+        if (!canRender(view)) {
+            viewJobs.push_back(0);      // never executed
+            continue;
+        }
+        const ViewTarget target = getViewTarget(view, frameContext.frameIndex);
+        const FrameContext* context = &frameContext;
+        viewJobs.push_back(recorder->record({target.renderPass, 0, target.framebuffer},
+            [this, context, &view, target](VkCommandBuffer commandBuffer) {
+                recordView(*context, commandBuffer, view, target);
+            }));
     }
-    
-    if (frameContext.pointShadowcastingMaterialMapByFace.size() > 0) {
-        renderPointLights(frameContext);
+}
+
+void ShadowPass::run(FrameContext& frameContext) {
+    // Each view is its own render pass; with a parallel recorder its draws were recorded by prepare()
+    ParallelRecorder* recorder = frameContext.parallelRecorder;
+    for (size_t i = 0; i < frameContext.shadowViews.size(); i++) {
+        const ShadowView& view = frameContext.shadowViews[i];
+        if (!canRender(view)) {
+            continue;
+        }
+        const ViewTarget target = getViewTarget(view, frameContext.frameIndex);
+        // Timed outside the render pass, inside a multiview one each timestamp would take a query per view
+        GpuProfileScope scope(frameContext.gpuProfiler, frameContext.commandBuffer, target.label, static_cast<int32_t>(i));
+        if (recorder) {
+            beginShadowRenderPass(frameContext.commandBuffer, target, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            recorder->execute(frameContext.commandBuffer, &viewJobs[i], 1);
+        } else {
+            beginShadowRenderPass(frameContext.commandBuffer, target, VK_SUBPASS_CONTENTS_INLINE);
+            recordView(frameContext, frameContext.commandBuffer, view, target);
+        }
+        endShadowRenderPass(frameContext.commandBuffer);
     }
 }
 
@@ -360,313 +469,91 @@ std::vector<VkVertexInputAttributeDescription> ShadowPass::ShadowVertex::getAttr
 }
 
 
-void ShadowPass::renderDirectionalLights(FrameContext& frameContext) {
+void ShadowPass::bindShadowPipeline(const FrameContext& frameContext, VkCommandBuffer commandBuffer, Pipeline& pipeline, VkPipelineLayout pipelineLayout) {
     vkCmdBindPipeline(
-        frameContext.commandBuffer,
+        commandBuffer,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        directionalLightPipeline->getPipeline()
+        pipeline.getPipeline()
     );
-    VkDescriptorSet lightMatrixDescriptorSet = frameContext.lightMatrixDescriptorSet;
+
+    std::array<VkDescriptorSet, 2> sharedSets = {
+        frameContext.lightMatrixDescriptorSet,
+        frameContext.shadowModelMatrixDescriptorSet
+    };
     vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
+            commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
-            directionalPipelineLayout,
+            pipelineLayout,
             0,
-            1,
-            &lightMatrixDescriptorSet,
+            static_cast<uint32_t>(sharedSets.size()),
+            sharedSets.data(),
             0,
             nullptr
     );
-    
-    const auto& directionalMap = frameContext.directionalShadowcastingMaterialMap;
-
-    uint32_t lightIndex = 0;
-
-    for (auto& [directionalLight, cascadeBatches] : directionalMap) {
-
-        VkDescriptorSet modelMatrixDescriptorSet = frameContext.shadowModelMatrixDescriptorSet;
-        vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            directionalPipelineLayout,
-            1,
-            1,
-            &modelMatrixDescriptorSet,
-            0,
-            nullptr
-        );
-
-        const uint32_t lightMatrixBase = frameContext.directionalLightMatrixBase.at(directionalLight);
-        glm::vec4 lightPosRange = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
-
-        for (uint32_t cascadeIndex = 0; cascadeIndex < MAX_SHADOW_CASCADE_COUNT; ++cascadeIndex) {
-            const auto& materialBatches = cascadeBatches[cascadeIndex];
-            if (materialBatches.empty()) {
-                continue;
-            }
-            beginShadowRenderPass(frameContext.commandBuffer, frameContext.frameIndex, lightIndex, LightType::DIRECTIONAL_LIGHT, cascadeIndex);
-            
-            // Draw all batches in the current buffer update
-            for (uint32_t i = 0; i < materialBatches.size(); i++) {
-                const auto& materialBatch = materialBatches[i];
-                
-                InstancedPushConstants pushConstants{
-                    lightPosRange,
-                    lightMatrixBase + cascadeIndex,
-                    materialBatch.matrixOffset,
-                    0u // directional
-                };
-                
-                vkCmdPushConstants(
-                    frameContext.commandBuffer,
-                    directionalPipelineLayout,
-                    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                    0,
-                    sizeof(InstancedPushConstants),
-                    &pushConstants
-                );
+}
 
-                VkDescriptorSet materialDescriptorSet = materialBatch.material->getMaterialDescriptorSet();
-                vkCmdBindDescriptorSets(
-                    frameContext.commandBuffer,
-                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    directionalPipelineLayout,
-                    2,
-                    1,
-                    &materialDescriptorSet,
-                    0,
-                    nullptr
-                );
+void ShadowPass::drawShadowView(const FrameContext& frameContext, VkCommandBuffer commandBuffer, const ShadowView& view, VkPipelineLayout pipelineLayout) {
+    // 0 = directional, 1 = spot, 2 = point, as in the shadow shaders
+    const uint32_t lightType = view.lightType == LightType::DIRECTIONAL_LIGHT ? 0u :
+                               view.lightType == LightType::SPOT_LIGHT ? 1u : 2u;
 
-                materialBatch.mesh->bind(frameContext.commandBuffer);
-                materialBatch.mesh->drawSubmeshInstanced(frameContext.commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);     
-            }
-            endShadowRenderPass(frameContext.commandBuffer);
-        }
-        lightIndex++;
-    }
-}
+    for (uint32_t i = view.batchOffset; i < view.batchOffset + view.batchCount; i++) {
+        const MaterialBatch& materialBatch = frameContext.shadowBatches[i];
 
-void ShadowPass::renderSpotLights(FrameContext& frameContext) {
-    vkCmdBindPipeline(
-        frameContext.commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        spotLightPipeline->getPipeline()
-    );
+        InstancedPushConstants pushConstants{
+            view.lightPosRange,
+            view.lightMatrixIndex,
+            materialBatch.matrixOffset,
+            lightType
+        };
 
-    VkDescriptorSet lightMatrixDescriptorSet = frameContext.lightMatrixDescriptorSet;
-    vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            spotPipelineLayout,
-            0,
-            1,
-            &lightMatrixDescriptorSet,
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
             0,
-            nullptr
-    );
-    
-    const auto& spotMap = frameContext.spotShadowcastingMaterialMap;
-    uint32_t lightIndex = 0;
-    for (auto& [spotLightPtr, materialBatches] : spotMap) {
-
-        SpotLight& spotLight = *spotLightPtr;
-        glm::vec3 lightPos = spotLight.transform.position;
-        float range = spotLight.range;
-        glm::vec4 lightPosRange = glm::vec4(lightPos, range);
-        
-        beginShadowRenderPass(frameContext.commandBuffer, frameContext.frameIndex, lightIndex, LightType::SPOT_LIGHT);
-
-        VkDescriptorSet modelMatrixDescriptorSet = frameContext.shadowModelMatrixDescriptorSet;
-        vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            spotPipelineLayout,
-            1,
-            1,
-            &modelMatrixDescriptorSet,
-            0,
-            nullptr
+            sizeof(InstancedPushConstants),
+            &pushConstants
         );
-            
-            // Draw all batches in the current buffer update
-        for (uint32_t i = 0; i < materialBatches.size(); i++) {
-            const auto& materialBatch = materialBatches[i];
-                
-            const uint32_t lightMatrixBase = frameContext.spotLightMatrixBase.at(spotLightPtr);
-            InstancedPushConstants pushConstants{
-                lightPosRange,
-                lightMatrixBase,
-                materialBatch.matrixOffset,
-                1u // spot
-            };
-                
-            vkCmdPushConstants(
-                frameContext.commandBuffer,
-                spotPipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(InstancedPushConstants),
-                &pushConstants
-            );
-
-            VkDescriptorSet materialDescriptorSet = materialBatch.material->getMaterialDescriptorSet();
-            vkCmdBindDescriptorSets(
-                frameContext.commandBuffer,
-                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                spotPipelineLayout,
-                2,
-                1,
-                &materialDescriptorSet,
-                0,
-                nullptr
-            );
 
-            materialBatch.mesh->bind(frameContext.commandBuffer);
-            materialBatch.mesh->drawSubmeshInstanced(frameContext.commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);
-        }
-            
-        endShadowRenderPass(frameContext.commandBuffer);
-        
-        
-        lightIndex++;
-    }
-}
-
-void ShadowPass::renderPointLights(FrameContext& frameContext) {
-    vkCmdBindPipeline(
-        frameContext.commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pointLightPipeline->getPipeline()
-    );
-
-
-    VkDescriptorSet lightMatrixDescriptorSet = frameContext.lightMatrixDescriptorSet;
-    vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pointPipelineLayout,
-            0,
-            1,
-            &lightMatrixDescriptorSet,
-            0,
-            nullptr
-    );
-    
-    const auto& pointMap = frameContext.pointShadowcastingMaterialMapByFace;
-    
-    uint32_t lightIndex = 0;
-    
-    for (auto& [pointLightPtr, faceBatches] : pointMap) {
-        PointLight& pointLight = *pointLightPtr;
-        glm::vec3 lightPos = pointLight.transform.position;
-        float range = pointLight.range;
-        glm::vec4 lightPosRange = glm::vec4(lightPos, range);
-        const uint32_t lightMatrixBase = frameContext.pointLightMatrixBase.at(pointLightPtr);
-
-        VkDescriptorSet modelMatrixDescriptorSet = frameContext.shadowModelMatrixDescriptorSet;
+        VkDescriptorSet materialDescriptorSet = materialBatch.material->getMaterialDescriptorSet();
         vkCmdBindDescriptorSets(
-            frameContext.commandBuffer,
+            commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pointPipelineLayout,
-            1,
+            pipelineLayout,
+            2,
             1,
-            &modelMatrixDescriptorSet,
+            &materialDescriptorSet,
             0,
             nullptr
         );
 
-        for (uint32_t face = 0; face < 6; ++face) {
-            const auto& materialBatches = faceBatches[face];
-            if (materialBatches.empty()) {
-                continue;
-            }
-            beginShadowRenderPass(frameContext.commandBuffer, frameContext.frameIndex, lightIndex, LightType::POINT_LIGHT, face);
-
-            // Draw all batches in the current buffer update
-            for (uint32_t i = 0; i < materialBatches.size(); i++) {
-                const auto& materialBatch = materialBatches[i];
-                
-                InstancedPushConstants pushConstants{
-                    lightPosRange,
-                    lightMatrixBase + face,
-                    materialBatch.matrixOffset,
-                    2u // point
-                };
-                
-                vkCmdPushConstants(
-                    frameContext.commandBuffer,
-                    pointPipelineLayout,
-                    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                    0,
-                    sizeof(InstancedPushConstants),
-                    &pushConstants
-                );
-
-                VkDescriptorSet materialDescriptorSet = materialBatch.material->getMaterialDescriptorSet();
-                vkCmdBindDescriptorSets(
-                    frameContext.commandBuffer,
-                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    pointPipelineLayout,
-                    2,
-                    1,
-                    &materialDescriptorSet,
-                    0,
-                    nullptr
-                );
-
-                materialBatch.mesh->bind(frameContext.commandBuffer);
-                materialBatch.mesh->drawSubmeshInstanced(frameContext.commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);
-            }
-            
-            endShadowRenderPass(frameContext.commandBuffer);
-        }
-
-        lightIndex++;
+        materialBatch.mesh->bind(commandBuffer);
+        materialBatch.mesh->drawSubmeshInstanced(commandBuffer, materialBatch.submeshIndex, materialBatch.instanceCount);
     }
 }
-// Helper method to update instance buffers from DrawingData
 
+void ShadowPass::recordView(const FrameContext& frameContext, VkCommandBuffer commandBuffer, const ShadowView& view, const ViewTarget& target) {
+    // Dynamic state is not inherited by secondary command buffers, every view sets its own
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(target.extent.width);
+    viewport.height = static_cast<float>(target.extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-void ShadowPass::setBarriers(FrameContext& frameContext) {
-    VkCommandBuffer commandBuffer = frameContext.commandBuffer;
-    
-    // Create barriers for the shadow uniform buffer and instance model matrix buffer
-    std::array<VkBufferMemoryBarrier, 2> bufferBarriers{};
-    
-    // Shadow uniform buffer barrier - contains light matrices
-    bufferBarriers[0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferBarriers[0].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufferBarriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    bufferBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[0].buffer = frameContext.lightMatrixBuffer->getBuffer();
-    bufferBarriers[0].offset = 0;
-    bufferBarriers[0].size = VK_WHOLE_SIZE;
-    
-    // Instance model matrix buffer barrier
-    bufferBarriers[1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferBarriers[1].srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-    bufferBarriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    bufferBarriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    bufferBarriers[1].buffer = frameContext.shadowModelMatrixBuffer->getBuffer();
-    bufferBarriers[1].offset = 0;
-    bufferBarriers[1].size = VK_WHOLE_SIZE;
-    
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = target.extent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    // Issue all barriers at once
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 
-        0, 
-        0, nullptr, 
-        static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(), 
-        0, nullptr 
-    );
+    bindShadowPipeline(frameContext, commandBuffer, *target.pipeline, target.pipelineLayout);
+    drawShadowView(frameContext, commandBuffer, view, target.pipelineLayout);
 }
 
+// Helper method to update instance buffers from DrawingData
 
 
 void ShadowPass::updateMatrixBufferDescriptorSets(FrameContext& frameContext) {
@@ -693,7 +580,7 @@ void ShadowPass::updateMatrixBufferDescriptorSets(FrameContext& frameContext) {
 void ShadowPass::createFramebuffers(const CreateInfo& createInfo) {
     // Create framebuffers for directional lights (one per cascade)
     for (size_t lightIndex = 0; lightIndex < MAX_DIRECTIONAL_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < device.getFrameSlotCount(); frameIndex++) {
             auto& shadowMap = (*createInfo.directionalShadowMaps)[lightIndex][frameIndex];
             for (uint32_t cascadeIndex = 0; cascadeIndex < MAX_SHADOW_CASCADE_COUNT; ++cascadeIndex) {
                 createShadowFramebuffer(
@@ -707,7 +594,7 @@ void ShadowPass::createFramebuffers(const CreateInfo& createInfo) {
 
     // Create framebuffers for spot lights
     for (size_t lightIndex = 0; lightIndex < MAX_SPOT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < device.getFrameSlotCount(); frameIndex++) {
             auto& shadowMap = (*createInfo.spotShadowMaps)[lightIndex][frameIndex];
             createShadowFramebuffer(
                 shadowMap->getImageView(),
@@ -719,7 +606,7 @@ void ShadowPass::createFramebuffers(const CreateInfo& createInfo) {
 
     // Create framebuffers for point lights (one per face)
     for (size_t lightIndex = 0; lightIndex < MAX_POINT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < device.getFrameSlotCount(); frameIndex++) {
             auto& shadowMap = (*createInfo.pointShadowMaps)[lightIndex][frameIndex];
             for (uint32_t face = 0; face < 6; ++face) {
                 createShadowFramebuffer(
@@ -728,6 +615,16 @@ void ShadowPass::createFramebuffers(const CreateInfo& createInfo) {
                     pointFramebuffers[lightIndex][frameIndex][face]
                 );
             }
+
+            // Multiview framebuffers have a single layer; the view mask selects the array layers
+            if (pointMultiviewRenderPass != VK_NULL_HANDLE) {
+                createShadowFramebuffer(
+                    shadowMap->getArrayImageView(),
+                    POINT_SHADOW_MAP_RES, POINT_SHADOW_MAP_RES, 1,
+                    pointMultiviewFramebuffers[lightIndex][frameIndex],
+                    pointMultiviewRenderPass
+                );
+            }
         }
     }
 }
@@ -766,6 +663,15 @@ void ShadowPass::cleanupFramebuffers() {
             }
         }
     }
+
+    for (auto& frameBufferArray : pointMultiviewFramebuffers) {
+        for (auto& framebuffer : frameBufferArray) {
+            if (framebuffer != VK_NULL_HANDLE) {
+                vkDestroyFramebuffer(device.getDevice(), framebuffer, nullptr);
+                framebuffer = VK_NULL_HANDLE;
+            }
+        }
+    }
 }
 
 void ShadowPass::createShadowFramebuffer(
@@ -773,11 +679,12 @@ void ShadowPass::createShadowFramebuffer(
     uint32_t width,
     uint32_t height,
     uint32_t layers,
-    VkFramebuffer& framebuffer) {
+    VkFramebuffer& framebuffer,
+    VkRenderPass renderPass) {
     
     VkFramebufferCreateInfo framebufferInfo{};
     framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    framebufferInfo.renderPass = shadowRenderPass;
+    framebufferInfo.renderPass = (renderPass != VK_NULL_HANDLE) ? renderPass : shadowRenderPass;
     framebufferInfo.attachmentCount = 1;
     framebufferInfo.pAttachments = &imageView;
     framebufferInfo.width = width;
@@ -7,6 +7,7 @@
 #include "Rendering/RenderPasses/render_passes_buffers.hpp"
 #include "Rendering/RenderPasses/Geometry/geometry_pass.hpp"
 #include "Rendering/Core/pipeline.hpp"
+#include "Rendering/Core/parallel_recorder.hpp"
 #include "Rendering/Core/descriptors.hpp"
 #include "Rendering/Core/swapchain.hpp"
 #include "Systems/bounding_box_system.hpp"
@@ -68,11 +69,25 @@ public:
     ShadowPass(const ShadowPass&) = delete;
     ShadowPass& operator=(const ShadowPass&) = delete;
 
+    // With a parallel recorder in the frame context: queues one secondary command buffer per shadow view, which
+    // run() then executes inside the view's render pass
+    void prepare(FrameContext& frameContext);
     void run(FrameContext& frameContext);
 private:
+    // Render pass, framebuffer and pipeline a shadow view is drawn with
+    struct ViewTarget {
+        VkRenderPass renderPass;
+        VkFramebuffer framebuffer;
+        VkExtent2D extent;
+        Pipeline* pipeline;
+        VkPipelineLayout pipelineLayout;
+        const char* label;      // of the view's GPU timing
+    };
+
     // Resource management functions
     void cleanup();
     void createRenderPass();
+    void createMultiviewRenderPass();
     void createPipelines(const CreateInfo& createInfo);
     void createFramebuffers(const CreateInfo& createInfo);
     void cleanupFramebuffers();
@@ -81,41 +96,44 @@ private:
         uint32_t width,
         uint32_t height,
         uint32_t layers,
-        VkFramebuffer& framebuffer
+        VkFramebuffer& framebuffer,
+        VkRenderPass renderPass = VK_NULL_HANDLE
     );
 
 
-    void setBarriers(FrameContext& frameContext);
     // Rendering functions
-    void renderDirectionalLights(FrameContext& frameContext);
-    void renderPointLights(FrameContext& frameContext);
-    void renderSpotLights(FrameContext& frameContext);
-    void beginShadowRenderPass(
-        VkCommandBuffer commandBuffer, 
-        uint32_t frameIndex,
-        size_t lightIndex, 
-        LightType lightType,
-        uint32_t layerIndex = 0
-        );
-
+    ViewTarget getViewTarget(const ShadowView& view, uint32_t frameIndex) const;
+    // Cube views need the multiview pipeline, which is null when multiview is unsupported
+    bool canRender(const ShadowView& view) const { return !view.multiview || pointLightMultiviewPipeline; }
+    // Everything inside the view's render pass: viewport, pipeline, descriptor sets and draws
+    void recordView(const FrameContext& frameContext, VkCommandBuffer commandBuffer, const ShadowView& view, const ViewTarget& target);
+    // Binds the pipeline with the light matrix (set 0) and shadow model matrix (set 1) descriptor sets
+    void bindShadowPipeline(const FrameContext& frameContext, VkCommandBuffer commandBuffer, Pipeline& pipeline, VkPipelineLayout pipelineLayout);
+    void drawShadowView(const FrameContext& frameContext, VkCommandBuffer commandBuffer, const ShadowView& view, VkPipelineLayout pipelineLayout);
+    void beginShadowRenderPass(VkCommandBuffer commandBuffer, const ViewTarget& target, VkSubpassContents contents);
     void endShadowRenderPass(VkCommandBuffer commandBuffer);
 
     void updateMatrixBufferDescriptorSets(FrameContext& frameContext);
 
     Device& device;
     VkRenderPass shadowRenderPass{VK_NULL_HANDLE};
+    // Renders all six cube faces at once (viewMask 0x3F); null when multiview is unsupported
+    VkRenderPass pointMultiviewRenderPass{VK_NULL_HANDLE};
     VkFormat depthFormat{VK_FORMAT_UNDEFINED};
     
     // Pipeline and layout resources for instanced rendering
     std::unique_ptr<Pipeline> directionalLightPipeline;
     std::unique_ptr<Pipeline> spotLightPipeline;
     std::unique_ptr<Pipeline> pointLightPipeline;
+    std::unique_ptr<Pipeline> pointLightMultiviewPipeline;
     VkPipelineLayout directionalPipelineLayout{VK_NULL_HANDLE};
     VkPipelineLayout spotPipelineLayout{VK_NULL_HANDLE};
     VkPipelineLayout pointPipelineLayout{VK_NULL_HANDLE};
     std::array<std::array<std::array<VkFramebuffer, MAX_SHADOW_CASCADE_COUNT>, MAX_FRAMES_IN_FLIGHT>, MAX_DIRECTIONAL_LIGHTS> directionalFramebuffers{};
     std::array<std::array<VkFramebuffer, MAX_FRAMES_IN_FLIGHT>, MAX_SPOT_LIGHTS> spotFramebuffers{};
     std::array<std::array<std::array<VkFramebuffer, 6>, MAX_FRAMES_IN_FLIGHT>, MAX_POINT_LIGHTS> pointFramebuffers{};    
+    std::array<std::array<VkFramebuffer, MAX_FRAMES_IN_FLIGHT>, MAX_POINT_LIGHTS> pointMultiviewFramebuffers{};
+    std::vector<ParallelRecorder::Job> viewJobs;    // per shadow view of the frame, from prepare()
     
 };
 
@@ -44,6 +44,8 @@ public:
 
     VkRenderPass getRenderPass() const { return renderPass; }
     void run(FrameContext& frameContext);
+    // Recreates the framebuffers for the new extent; the render pass and pipeline stay
+    void resize(const CreateInfo& createInfo);
     
     
 private:
@@ -51,8 +53,8 @@ private:
     void createRenderPass(const CreateInfo& createInfo);
     void createPipeline(const CreateInfo& createInfo);
     void createFramebuffers(const CreateInfo& createInfo);
+    void destroyFramebuffers();
 
-    void setBarriers(FrameContext& frameContext);
     void beginRenderPass(FrameContext& frameContext);
     void endRenderPass(FrameContext& frameContext);
     void updateDescriptorSets(FrameContext& frameContext);
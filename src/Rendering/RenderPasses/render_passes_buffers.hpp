@@ -22,8 +22,17 @@ namespace Rendering{
     	alignas(16)glm::mat4 shadowcastingLightMatrices[MAX_SHADOWCASTING_LIGHT_MATRICES];
 	};
 
-    struct UnifiedLightBuffer {
-        alignas(16) Light lights[MAX_LIGHTS];
+	// Per-frame reference into the persistent light slot buffer; the shadow fields override the slot's
+	// because shadow maps and light matrices are reassigned every frame
+	struct VisibleLight {
+		alignas(4) uint32_t lightSlot;
+		alignas(4) uint32_t lightMatrixOffset;
+		alignas(4) uint32_t shadowmapIndex;
+		alignas(4) uint32_t isCastingShadow;
+	};
+
+    struct VisibleLightBuffer {
+        alignas(16) VisibleLight lights[MAX_LIGHTS];
 		alignas(4) uint32_t lightCount;
     };
 	
@@ -37,6 +46,16 @@ namespace Rendering{
 		alignas(16) glm::vec4 cameraPosition;
 		alignas(4) float ambientIntensity;
 		alignas(4) float reflectionIntensity;
+		alignas(4) uint32_t hasIrradianceSH;    // 0 = diffuse IBL reads the environment map's last level
+		alignas(16) glm::vec4 irradianceSH[9];  // premultiplied SH9, see Resources::PrefilteredEnvironment
+	};
+
+	// Visible linear depth range written by the SDSM reduction (float bits, so atomicMin/Max keep ordering)
+	struct DepthBoundsBuffer {
+		alignas(4) uint32_t minDepthBits;
+		alignas(4) uint32_t maxDepthBits;
+		alignas(4) uint32_t sampleCount;
+		alignas(4) uint32_t padding;
 	};
 
     struct CameraUbo {
@@ -106,12 +106,12 @@ void GBuffer::createAttachments() {
         materialFormat,
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         materialImages, materialMemories, materialViews, "GBuffer_Material");
-    
-    // Initialize all GBuffer images to SHADER_READ_ONLY_OPTIMAL layout
-    VkCommandBuffer cmd = device.beginSingleTimeCommands();
-    
-    auto transitionAttachment = [&](const std::array<VkImage, MAX_FRAMES_IN_FLIGHT>& images) {
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+}
+
+void GBuffer::appendLayoutInits(std::vector<VkImageMemoryBarrier>& barriers) const {
+    // The render graph imports the attachments as SHADER_READ_ONLY_OPTIMAL
+    for (const auto* images : {&positionImages, &normalImages, &albedoImages, &materialImages}) {
+        for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
             VkImageMemoryBarrier barrier{};
             barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
             barrier.srcAccessMask = 0;
@@ -120,31 +120,40 @@ void GBuffer::createAttachments() {
             barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.image = images[i];
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseMipLevel = 0;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
-
-            vkCmdPipelineBarrier(
-                cmd,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-            );
+            barrier.image = (*images)[i];
+            barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+            barriers.push_back(barrier);
         }
+    }
+}
+
+void GBuffer::resize(uint32_t newWidth, uint32_t newHeight) {
+    // Frames in flight still render into the current attachments; they go once those frames are done
+    DeletionQueue& deletionQueue = device.getDeletionQueue();
+    const VkDevice vkDevice = device.getDevice();
+    auto retireArray = [&](
+        std::array<VkImage, MAX_FRAMES_IN_FLIGHT>& images,
+        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT>& memories,
+        std::array<VkImageView, MAX_FRAMES_IN_FLIGHT>& views) {
+        deletionQueue.push([vkDevice, images, memories, views]() {
+            for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+                vkDestroyImageView(vkDevice, views[i], nullptr);
+                vkDestroyImage(vkDevice, images[i], nullptr);
+                vkFreeMemory(vkDevice, memories[i], nullptr);
+            }
+        });
+        images.fill(VK_NULL_HANDLE);
+        memories.fill(VK_NULL_HANDLE);
+        views.fill(VK_NULL_HANDLE);
     };
-    
-    transitionAttachment(positionImages);
-    transitionAttachment(normalImages);
-    transitionAttachment(albedoImages);
-    transitionAttachment(materialImages);
-    
-    device.endSingleTimeCommands(cmd);
+    retireArray(positionImages, positionMemories, positionViews);
+    retireArray(normalImages, normalMemories, normalViews);
+    retireArray(albedoImages, albedoMemories, albedoViews);
+    retireArray(materialImages, materialMemories, materialViews);
+
+    width = newWidth;
+    height = newHeight;
+    createAttachments();
 }
 
 void GBuffer::createAttachment(
@@ -170,7 +179,7 @@ void GBuffer::createAttachment(
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < device.getFrameSlotCount(); i++) {
         device.createImageWithInfo(
             imageInfo,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
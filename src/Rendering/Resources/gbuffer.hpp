@@ -21,6 +21,11 @@ public:
     GBuffer(Device& device, const CreateInfo& createInfo);
     ~GBuffer();
 
+    // Recreates the attachments at the new size; the old ones are released through the device's deletion queue
+    void resize(uint32_t width, uint32_t height);
+    // UNDEFINED -> SHADER_READ_ONLY_OPTIMAL for every attachment, to be recorded before the attachments' first use
+    void appendLayoutInits(std::vector<VkImageMemoryBarrier>& barriers) const;
+
     VkImageView getPositionView(size_t frameIndex) const { return positionViews[frameIndex]; }
     VkImageView getNormalView(size_t frameIndex) const { return normalViews[frameIndex]; }
     VkImageView getAlbedoView(size_t frameIndex) const { return albedoViews[frameIndex]; }
@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <mutex>
 #include <iostream>
+#include <utility>
 namespace Rendering {
 
 // Initialize static members
@@ -16,9 +17,9 @@ void Material::setDebugName(VkObjectType objectType, uint64_t handle, const std:
     nameInfo.objectHandle = handle;
     nameInfo.pObjectName = name.c_str();
     
-    auto func = (PFN_vkSetDebugUtilsObjectNameEXT)vkGetDeviceProcAddr(device.getDevice(), "vkSetDebugUtilsObjectNameEXT");
+    auto func = (PFN_vkSetDebugUtilsObjectNameEXT)vkGetDeviceProcAddr(device->getDevice(), "vkSetDebugUtilsObjectNameEXT");
     if (func != nullptr) {
-        func(device.getDevice(), &nameInfo);
+        func(device->getDevice(), &nameInfo);
     }
 }
 
@@ -28,10 +29,10 @@ Material::Material(
     const MaterialInfo& materialInfo,
     DescriptorPool& descriptorPool,
     VkDescriptorSetLayout materialSetLayout)
-    : device{device},
+    : device{&device},
       info{materialInfo},
       properties{materialInfo.properties},
-      descriptorPool{descriptorPool},
+      descriptorPool{&descriptorPool},
       materialSetLayout{materialSetLayout},
       transparencyType{materialInfo.transparencyType} {
     
@@ -54,10 +55,26 @@ Material::Material(
         updateDescriptorSet();
 }
 
-Material::~Material() = default;
+Material::Material(const MaterialInfo& materialInfo)
+    : device{nullptr},
+      info{materialInfo},
+      properties{materialInfo.properties},
+      descriptorPool{nullptr},
+      transparencyType{materialInfo.transparencyType} {
+    propertiesBuffer = std::make_unique<Buffer>(sizeof(MaterialUbo), 1);
+    propertiesBuffer->map();
+    propertiesBuffer->writeToBuffer(&properties);
+}
+
+Material::~Material() {
+    // Unloaded materials are destroyed through the deletion queue, after the last frame that bound this set
+    if (materialDescriptorSet != VK_NULL_HANDLE) {
+        descriptorPool->freeDescriptors({materialDescriptorSet});
+    }
+}
 
 void Material::createMaterialDescriptorSet() {
-    if (!DescriptorWriter(materialSetLayout, descriptorPool)
+    if (!DescriptorWriter(materialSetLayout, *descriptorPool)
             .build(materialDescriptorSet)) {
         std::cerr << "Failed to allocate descriptor set for material: " << info.name << std::endl;
         std::cerr << "This might indicate that the descriptor pool is exhausted." << std::endl;
@@ -77,7 +94,7 @@ void Material::updateDescriptorSet() {
         // Create a 1x1 white texture
         const uint32_t whitePixel = 0xFFFFFFFF;
         s_defaultTexture = std::make_unique<Texture>(
-            device,
+            *device,
             1, 1,  // width, height
             VK_FORMAT_R8G8B8A8_SRGB,
             VK_IMAGE_TILING_OPTIMAL,
@@ -107,7 +124,7 @@ void Material::updateDescriptorSet() {
         s_defaultTexture->getDescriptorInfo();
 
     // Write all descriptors
-    DescriptorWriter(materialSetLayout, descriptorPool)
+    DescriptorWriter(materialSetLayout, *descriptorPool)
         .writeBuffer(0, &bufferInfo)
         .writeImage(1, &albedoInfo)
         .writeImage(2, &normalInfo)
@@ -144,6 +161,50 @@ void Material::setOcclusionTexture(Texture* texture) {
     updateDescriptorSet();
 }
 
+VkDescriptorSet Material::replaceTexture(Texture* oldTexture, Texture* newTexture) {
+    bool replaced = false;
+    for (Texture** slot : {&albedoTexture, &normalTexture, &metallicSmoothnessTexture, &occlusionTexture}) {
+        if (*slot == oldTexture) {
+            *slot = newTexture;
+            replaced = true;
+        }
+    }
+    if (!replaced) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorSet retiredSet = materialDescriptorSet;
+    createMaterialDescriptorSet();
+    updateDescriptorSet();
+    return retiredSet;
+}
+
+VkDescriptorSet Material::dropTextures(const std::unordered_set<Texture*>& textures) {
+    std::pair<Texture**, int*> slots[] = {
+        {&albedoTexture, &properties.hasAlbedoMap},
+        {&normalTexture, &properties.hasNormalMap},
+        {&metallicSmoothnessTexture, &properties.hasMetallicSmoothnessMap},
+        {&occlusionTexture, &properties.hasOcclusionMap}
+    };
+    bool dropped = false;
+    for (auto& [slot, hasMap] : slots) {
+        if (*slot != nullptr && textures.count(*slot) != 0) {
+            *slot = nullptr;
+            *hasMap = 0;
+            dropped = true;
+        }
+    }
+    if (!dropped) {
+        return VK_NULL_HANDLE;
+    }
+
+    propertiesBuffer->writeToBuffer(&properties);
+    VkDescriptorSet retiredSet = materialDescriptorSet;
+    createMaterialDescriptorSet();
+    updateDescriptorSet();
+    return retiredSet;
+}
+
 void Material::setAlbedoColor(glm::vec4 color) {
     properties.albedoColor = color;
     propertiesBuffer->writeToBuffer(&properties);
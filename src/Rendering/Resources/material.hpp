@@ -6,8 +6,10 @@
 #include "Rendering/Core/buffer.hpp"
 #include "Rendering/Core/descriptors.hpp"
 
+#include <array>
 #include <memory>
 #include <mutex>
+#include <unordered_set>
 
 #include "core.hpp"
 
@@ -51,6 +53,9 @@ class Material {
             DescriptorPool& descriptorPool,
             VkDescriptorSetLayout materialSetLayout
         );
+        // Properties only: a host memory UBO and no descriptor set. For CPU-side tools that sort and cull by
+        // material without binding one; the texture setters need the device constructor
+        explicit Material(const MaterialInfo& materialInfo);
         ~Material();
 
         Material(const Material&) = delete;
@@ -61,6 +66,13 @@ class Material {
         void setNormalTexture(Texture* texture);
         void setMetallicSmoothnessTexture(Texture* texture);
         void setOcclusionTexture(Texture* texture);
+        // Points every slot holding oldTexture at newTexture. The change is written into a freshly allocated descriptor
+        // set because the current one may still be bound by frames in flight; that set is returned for the caller to
+        // free once those frames are done (VK_NULL_HANDLE when no slot used oldTexture)
+        VkDescriptorSet replaceTexture(Texture* oldTexture, Texture* newTexture);
+        // Clears every slot holding one of textures, so the default texture is sampled and its map flag is off. Like
+        // replaceTexture, the change goes into a fresh set and the old one is returned for deferred freeing
+        VkDescriptorSet dropTextures(const std::unordered_set<Texture*>& textures);
 
         // Property setters
         void setAlbedoColor(glm::vec4 color);
@@ -74,6 +86,7 @@ class Material {
         VkDescriptorSet getMaterialDescriptorSet() const { return materialDescriptorSet; }
         TransparencyType getTransparencyType() const { return transparencyType; }
         bool isGPUInstancingEnabled() const { return info.enableGPUInstancing; }
+        std::array<Texture*, 4> getTextures() const { return {albedoTexture, normalTexture, metallicSmoothnessTexture, occlusionTexture}; }
 
         // Static cleanup function for default texture
         static void cleanupDefaultTexture();
@@ -86,12 +99,12 @@ class Material {
         void updateDescriptorSet();
         void setDebugName(VkObjectType objectType, uint64_t handle, const std::string& name);
 
-        Device& device;
+        Device* device;     // null for properties-only materials
         MaterialInfo info;
         MaterialUbo properties;
 
         std::unique_ptr<Buffer> propertiesBuffer{nullptr};
-        DescriptorPool& descriptorPool;
+        DescriptorPool* descriptorPool;
         VkDescriptorSet materialDescriptorSet{VK_NULL_HANDLE};
         VkDescriptorSetLayout materialSetLayout{VK_NULL_HANDLE};
         
@@ -1,9 +1,18 @@
 #include "mesh.hpp"
+#include "Resources/mesh_binary.hpp"
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <stdexcept>
 
 namespace Rendering {
 
+// .amesh vertex blobs are uploaded without conversion
+static_assert(sizeof(Mesh::Vertex) == sizeof(Resources::MeshBinaryVertex), "Mesh::Vertex must match the binary mesh layout");
+static_assert(offsetof(Mesh::Vertex, normal) == offsetof(Resources::MeshBinaryVertex, normal), "Mesh::Vertex must match the binary mesh layout");
+static_assert(offsetof(Mesh::Vertex, uv) == offsetof(Resources::MeshBinaryVertex, uv), "Mesh::Vertex must match the binary mesh layout");
+static_assert(offsetof(Mesh::Vertex, tangent) == offsetof(Resources::MeshBinaryVertex, tangent), "Mesh::Vertex must match the binary mesh layout");
+
 void Mesh::setDebugName(VkObjectType objectType, uint64_t handle, const std::string& name) {
     VkDebugUtilsObjectNameInfoEXT nameInfo{};
     nameInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -11,40 +20,43 @@ void Mesh::setDebugName(VkObjectType objectType, uint64_t handle, const std::str
     nameInfo.objectHandle = handle;
     nameInfo.pObjectName = name.c_str();
     
-    auto func = (PFN_vkSetDebugUtilsObjectNameEXT)vkGetDeviceProcAddr(device.getDevice(), "vkSetDebugUtilsObjectNameEXT");
+    auto func = (PFN_vkSetDebugUtilsObjectNameEXT)vkGetDeviceProcAddr(device->getDevice(), "vkSetDebugUtilsObjectNameEXT");
     if (func != nullptr) {
-        func(device.getDevice(), &nameInfo);
+        func(device->getDevice(), &nameInfo);
     }
 }
 
 Mesh::~Mesh() {}
 
-void Mesh::createVertexBuffers(const std::vector<Vertex>& vertices) {
-    vertexCount = static_cast<uint32_t>(vertices.size());
+void Mesh::createVertexBuffers(const Vertex* vertices, uint32_t count, UploadManager* uploadManager) {
+    vertexCount = count;
     assert(vertexCount >= 3 && "Vertex count must be at least 3");
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
-    uint32_t vertexSize = sizeof(vertices[0]);
-
-    Buffer stagingBuffer{
-        device,
-        vertexSize,
-        vertexCount,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    };
-    
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer((void*)vertices.data());
+    VkDeviceSize bufferSize = sizeof(Vertex) * vertexCount;
+    uint32_t vertexSize = sizeof(Vertex);
 
     vertexBuffer = std::make_unique<Buffer>(
-        device,
+        *device,
         vertexSize,
         vertexCount,
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
-    
-    device.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+
+    if (uploadManager != nullptr) {
+        uploadManager->uploadBuffer(vertexBuffer->getBuffer(), vertices, bufferSize);
+    } else {
+        Buffer stagingBuffer{
+            *device,
+            vertexSize,
+            vertexCount,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+
+        stagingBuffer.map();
+        stagingBuffer.writeToBuffer(static_cast<const void*>(vertices));
+        device->copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+    }
     
     // Set debug name for vertex buffer
     if (!meshName.empty()) {
@@ -52,37 +64,40 @@ void Mesh::createVertexBuffers(const std::vector<Vertex>& vertices) {
     }
 }
 
-void Mesh::createIndexBuffers(const std::vector<uint32_t>& indices) {
-    indexCount = static_cast<uint32_t>(indices.size());
+void Mesh::createIndexBuffers(const uint32_t* indices, uint32_t count, UploadManager* uploadManager) {
+    indexCount = count;
     hasIndexBuffer = indexCount > 0;
 
     if (!hasIndexBuffer) {
         return;
     }
 
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
-    uint32_t indexSize = sizeof(indices[0]);
-
-    Buffer stagingBuffer{
-        device,
-        indexSize,
-        indexCount,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    };
-
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer((void*)indices.data());
+    VkDeviceSize bufferSize = sizeof(uint32_t) * indexCount;
+    uint32_t indexSize = sizeof(uint32_t);
 
     indexBuffer = std::make_unique<Buffer>(
-        device,
+        *device,
         indexSize,
         indexCount,
         VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
 
-    device.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+    if (uploadManager != nullptr) {
+        uploadManager->uploadBuffer(indexBuffer->getBuffer(), indices, bufferSize);
+    } else {
+        Buffer stagingBuffer{
+            *device,
+            indexSize,
+            indexCount,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+
+        stagingBuffer.map();
+        stagingBuffer.writeToBuffer(static_cast<const void*>(indices));
+        device->copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+    }
     
     // Set debug name for index buffer
     if (!meshName.empty()) {
@@ -155,10 +170,41 @@ void Mesh::addSubmesh(uint32_t indexStart, uint32_t indexCount) {
 
 
 Mesh::Mesh(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::string& debugName) 
-    : device{device}, meshName{debugName} {
-    createVertexBuffers(vertices);
-    createIndexBuffers(indices);
+    : device{&device}, meshName{debugName} {
+    createVertexBuffers(vertices.data(), static_cast<uint32_t>(vertices.size()));
+    createIndexBuffers(indices.data(), static_cast<uint32_t>(indices.size()));
     calculateLocalBounds(vertices);
+    calculateUVDensity(vertices.data(), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+}
+
+Mesh::Mesh(Device& device,
+           const Vertex* vertices, uint32_t vertexCount,
+           const uint32_t* indices, uint32_t indexCount,
+           const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+           const std::string& debugName)
+    : device{&device}, meshName{debugName} {
+    createVertexBuffers(vertices, vertexCount);
+    createIndexBuffers(indices, indexCount);
+    setLocalBounds(boundsMin, boundsMax);
+    calculateUVDensity(vertices, vertexCount, indices, indexCount);
+}
+
+Mesh::Mesh(Device& device,
+           UploadManager& uploadManager,
+           const Vertex* vertices, uint32_t vertexCount,
+           const uint32_t* indices, uint32_t indexCount,
+           const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+           const std::string& debugName)
+    : device{&device}, meshName{debugName} {
+    createVertexBuffers(vertices, vertexCount, &uploadManager);
+    createIndexBuffers(indices, indexCount, &uploadManager);
+    setLocalBounds(boundsMin, boundsMax);
+    calculateUVDensity(vertices, vertexCount, indices, indexCount);
+}
+
+Mesh::Mesh(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const std::string& debugName)
+    : device{nullptr}, meshName{debugName} {
+    setLocalBounds(boundsMin, boundsMax);
 }
 
 
@@ -192,12 +238,38 @@ void Mesh::calculateLocalBounds(const std::vector<Vertex>& vertices) {
         min = glm::min(min, vertex.position);
         max = glm::max(max, vertex.position);
     }
-    
+    setLocalBounds(min, max);
+}
+
+void Mesh::setLocalBounds(const glm::vec3& min, const glm::vec3& max) {
     // Calculate center and extents
     localAABB.center = (min + max) * 0.5f;
     localAABB.extents =glm::max(glm::vec3(0.01f), (max - min) * 0.5f);// Add minimum thickness to prevent zero-volume AABBs
     
 }
 
+void Mesh::calculateUVDensity(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+    // Ratio of total UV area to total surface area, so one value covers the whole mesh regardless of triangle count
+    double uvArea = 0.0;
+    double surfaceArea = 0.0;
+    for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+        if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) {
+            continue;
+        }
+        const Vertex& a = vertices[indices[i]];
+        const Vertex& b = vertices[indices[i + 1]];
+        const Vertex& c = vertices[indices[i + 2]];
+
+        surfaceArea += 0.5 * glm::length(glm::cross(b.position - a.position, c.position - a.position));
+        glm::vec2 uvEdge0 = b.uv - a.uv;
+        glm::vec2 uvEdge1 = c.uv - a.uv;
+        uvArea += 0.5 * std::abs(uvEdge0.x * uvEdge1.y - uvEdge0.y * uvEdge1.x);
+    }
+
+    if (surfaceArea > 0.0 && uvArea > 0.0) {
+        uvDensity = static_cast<float>(std::sqrt(uvArea / surfaceArea));
+    }
+}
+
 
 } // namespace Rendering
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Rendering/Core/device.hpp"
 #include "Rendering/Core/buffer.hpp"
+#include "Rendering/Core/upload_manager.hpp"
 #include <memory>
 #include <vector>
 #include "Systems/bounding_box_system.hpp"
@@ -36,6 +37,21 @@ namespace Rendering {
         };
   
         Mesh(Device& device, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::string& debugName = "");
+        // Uploads straight from caller-owned memory (e.g. a mapped .amesh file) with precomputed bounds
+        Mesh(Device& device,
+             const Vertex* vertices, uint32_t vertexCount,
+             const uint32_t* indices, uint32_t indexCount,
+             const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+             const std::string& debugName = "");
+        // Same, but the copies are recorded into the shared upload manager; the source only has to outlive this call
+        Mesh(Device& device,
+             UploadManager& uploadManager,
+             const Vertex* vertices, uint32_t vertexCount,
+             const uint32_t* indices, uint32_t indexCount,
+             const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+             const std::string& debugName = "");
+        // Bounds only, no vertex or index buffers: for CPU-side tools that cull and batch meshes but never draw them
+        Mesh(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const std::string& debugName = "");
         ~Mesh();
 
         Mesh(const Mesh&) = delete;
@@ -62,24 +78,30 @@ namespace Rendering {
         uint32_t getSubmeshCount() const { return static_cast<uint32_t>(submeshes.size()); }
         
         const Math::AABB& getLocalBounds() const { return localAABB; }
+        // UV units per object-space unit, averaged over the mesh surface; drives texture streaming
+        float getUVDensity() const { return uvDensity; }
         
      
     private:
         void setDebugName(VkObjectType objectType, uint64_t handle, const std::string& name);
 
-        void createVertexBuffers(const std::vector<Vertex>& vertices);
-        void createIndexBuffers(const std::vector<uint32_t>& indices);
+        // Without an upload manager the copy goes through a private staging buffer and a blocking submit
+        void createVertexBuffers(const Vertex* vertices, uint32_t count, UploadManager* uploadManager = nullptr);
+        void createIndexBuffers(const uint32_t* indices, uint32_t count, UploadManager* uploadManager = nullptr);
 
         void calculateLocalBounds(const std::vector<Vertex>& vertices);
-        Device& device;
+        void setLocalBounds(const glm::vec3& min, const glm::vec3& max);
+        void calculateUVDensity(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+        Device* device;     // null for bounds-only meshes
         std::string meshName;
         std::unique_ptr<Buffer> vertexBuffer;
-        uint32_t vertexCount;
+        uint32_t vertexCount = 0;
         
         bool hasIndexBuffer = false;
         std::unique_ptr<Buffer> indexBuffer;
-        uint32_t indexCount;
+        uint32_t indexCount = 0;
         Math::AABB localAABB;
+        float uvDensity = 1.0f;
         
 
         // Submesh data for multi-material meshes
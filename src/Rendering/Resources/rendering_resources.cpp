@@ -2,12 +2,23 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include "Engine/cpu_profiler.hpp"
 #include "Scene/scene.hpp"
 #include "external/smaa_textures/AreaTex.h"
 #include "external/smaa_textures/SearchTex.h"
 
 namespace Rendering {
 
+namespace {
+    // Full chain down to 1x1, capped by RC_DEPTH_MIP_LEVELS when that is set
+    uint32_t depthPyramidMipCount(uint32_t width, uint32_t height) {
+        uint32_t maxDim = std::max(width, height);
+        uint32_t levels = 1;
+        while ((maxDim >>= 1) > 0) { ++levels; }
+        return RC_DEPTH_MIP_LEVELS == 0 ? levels : std::min<uint32_t>(RC_DEPTH_MIP_LEVELS, levels);
+    }
+}
+
 void RenderingResources::setDebugName(VkObjectType objectType, uint64_t handle, const std::string& name) {
     VkDebugUtilsObjectNameInfoEXT nameInfo{};
     nameInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
@@ -21,11 +32,11 @@ void RenderingResources::setDebugName(VkObjectType objectType, uint64_t handle,
     }
 }
 
-RenderingResources::RenderingResources(Device& device, SwapChain& swapChain)
-    : device(device), swapChain(swapChain) {
+RenderingResources::RenderingResources(Device& device, VkExtent2D extent, RenderGraph& renderGraph)
+    : device(device), renderGraph(renderGraph), frameSlots(device.getFrameSlotCount()) {
     
-    width = swapChain.getExtent().width;
-    height = swapChain.getExtent().height;
+    width = extent.width;
+    height = extent.height;
     
     // Create GBuffer first (it determines its own formats)
     GBuffer::CreateInfo gBufferInfo{};
@@ -44,13 +55,18 @@ RenderingResources::RenderingResources(Device& device, SwapChain& swapChain)
     createGIResources();
     createRCAtlases();
     createPostProcessResources();
+    allocateTransientMemory();
     createBuffers();
     createDescriptorPool();
     createDescriptorSetLayouts();
     loadSMAALUTTextures();
     createShadowMapResources();      
     createDescriptorSets();
+    for (uint32_t i = 0; i < frameSlots; i++) {
+        writeImageDescriptorSets(i);
+    }
     createShadowMapSamplerDescriptorSets();
+    gBuffer->appendLayoutInits(pendingLayoutInits);
     
     // TODO: Replace with proper skybox texture when implemented
     // For now, use a placeholder to avoid validation errors
@@ -63,6 +79,166 @@ RenderingResources::~RenderingResources() {
     cleanup();
 }
 
+void RenderingResources::resize(VkExtent2D extent) {
+    CPU_PROFILE_ZONE("RenderingResources::resize");
+    retireSizedResources();
+
+    width = extent.width;
+    height = extent.height;
+    gBuffer->resize(width, height);
+
+    createDepthResources();
+    createDepthPyramidResources();
+    createLightPassResources();
+    createTransparencyResources();
+    createGIResources();
+    createRCAtlases();
+    createPostProcessResources();
+    allocateTransientMemory();
+    gBuffer->appendLayoutInits(pendingLayoutInits);
+
+    // A slot's sets may still be bound by a frame in flight, so each is rewritten only when the slot comes round
+    staleDescriptorSets.fill(true);
+
+    std::cout << "RenderingResources resized to " << width << "x" << height << std::endl;
+}
+
+void RenderingResources::refreshDescriptorSets(uint32_t frameIndex) {
+    if (staleDescriptorSets[frameIndex]) {
+        writeImageDescriptorSets(frameIndex);
+    }
+}
+
+bool RenderingResources::growBuffer(Buffer& buffer, VkDeviceSize elementSize, uint32_t elementCount) {
+    const VkDeviceSize capacity = buffer.getBufferSize() / elementSize;
+    if (elementCount <= capacity) {
+        return false;
+    }
+    // Half again over the request, so a slowly growing view does not resize every frame
+    const VkDeviceSize newCount = std::max<VkDeviceSize>(elementCount + elementCount / 2, capacity * 2);
+    buffer.resize(newCount * elementSize);
+    buffer.map();
+    return true;
+}
+
+void RenderingResources::reserveOpaqueInstances(uint32_t frameIndex, uint32_t instanceCount) {
+    bool grown = growBuffer(*modelMatrixBuffers[frameIndex], sizeof(glm::mat4), instanceCount);
+    grown = growBuffer(*normalMatrixBuffers[frameIndex], sizeof(glm::mat4), instanceCount) || grown;
+    if (!grown) {
+        return;
+    }
+    VkDescriptorBufferInfo modelBufferInfo = modelMatrixBuffers[frameIndex]->descriptorInfo();
+    VkDescriptorBufferInfo normalBufferInfo = normalMatrixBuffers[frameIndex]->descriptorInfo();
+    DescriptorWriter(modelsDescriptorSetLayout, *descriptorPool)
+        .writeBuffer(0, &modelBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .writeBuffer(1, &normalBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .overwrite(modelsDescriptorSets[frameIndex]);
+}
+
+void RenderingResources::reserveTransparentInstances(uint32_t frameIndex, uint32_t instanceCount) {
+    bool grown = growBuffer(*transparencyModelMatrixBuffers[frameIndex], sizeof(glm::mat4), instanceCount);
+    grown = growBuffer(*transparencyNormalMatrixBuffers[frameIndex], sizeof(glm::mat4), instanceCount) || grown;
+    if (!grown) {
+        return;
+    }
+    VkDescriptorBufferInfo modelBufferInfo = transparencyModelMatrixBuffers[frameIndex]->descriptorInfo();
+    VkDescriptorBufferInfo normalBufferInfo = transparencyNormalMatrixBuffers[frameIndex]->descriptorInfo();
+    DescriptorWriter(transparencyModelDescriptorSetLayout, *descriptorPool)
+        .writeBuffer(0, &modelBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .writeBuffer(1, &normalBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .overwrite(transparencyModelMatrixDescriptorSets[frameIndex]);
+}
+
+void RenderingResources::reserveShadowInstances(uint32_t frameIndex, uint32_t instanceCount) {
+    bool grown = growBuffer(*shadowModelMatrixBuffers[frameIndex], sizeof(glm::mat4), instanceCount);
+    grown = growBuffer(*shadowFaceMaskBuffers[frameIndex], sizeof(uint32_t), instanceCount) || grown;
+    if (!grown) {
+        return;
+    }
+    VkDescriptorBufferInfo modelBufferInfo = shadowModelMatrixBuffers[frameIndex]->descriptorInfo();
+    VkDescriptorBufferInfo faceMaskBufferInfo = shadowFaceMaskBuffers[frameIndex]->descriptorInfo();
+    DescriptorWriter(shadowModelMatrixDescriptorSetLayout, *descriptorPool)
+        .writeBuffer(0, &modelBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .writeBuffer(1, &faceMaskBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .overwrite(shadowModelMatrixDescriptorSets[frameIndex]);
+}
+
+void RenderingResources::recordLayoutInits(VkCommandBuffer commandBuffer) {
+    if (pendingLayoutInits.empty()) {
+        return;
+    }
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        0, nullptr,
+        0, nullptr,
+        static_cast<uint32_t>(pendingLayoutInits.size()), pendingLayoutInits.data()
+    );
+    pendingLayoutInits.clear();
+}
+
+uint32_t RenderingResources::maxDepthPyramidMipLevels() const {
+    const uint32_t maxDimension = device.deviceProperties.limits.maxImageDimension2D;
+    return depthPyramidMipCount(maxDimension, maxDimension);
+}
+
+void RenderingResources::retireSizedResources() {
+    std::vector<VkImageView> views;
+    std::vector<VkImage> images;
+    std::vector<VkDeviceMemory> memories;
+    auto take = [](auto& handle, auto& list) {
+        if (handle != VK_NULL_HANDLE) {
+            list.push_back(handle);
+            handle = VK_NULL_HANDLE;
+        }
+    };
+
+    for (size_t i = 0; i < frameSlots; i++) {
+        take(depthViews[i], views);
+        take(depthImages[i], images);
+        take(depthMemories[i], memories);
+
+        for (VkImageView& mipView : depthPyramidMipStorageViews[i]) {
+            take(mipView, views);
+        }
+        depthPyramidMipStorageViews[i].clear();
+        take(depthPyramidViews[i], views);
+        take(depthPyramidImages[i], images);
+        take(depthPyramidMemories[i], memories);
+
+        take(giIndirectViews[i], views);
+        take(giIndirectImages[i], images);
+        take(giIndirectMemories[i], memories);
+
+        for (VkDeviceMemory heap : transientHeaps[i]) {
+            memories.push_back(heap);
+        }
+        transientHeaps[i].clear();
+    }
+    // Light pass, transparency, post-process and RC atlas images are all transients
+    for (const TransientImage& transient : transientImages) {
+        take(*transient.view, views);
+        take(*transient.image, images);
+    }
+    transientImages.clear();
+
+    const VkDevice vkDevice = device.getDevice();
+    device.getDeletionQueue().push([vkDevice, views = std::move(views), images = std::move(images),
+                                    memories = std::move(memories)]() {
+        for (VkImageView view : views) {
+            vkDestroyImageView(vkDevice, view, nullptr);
+        }
+        for (VkImage image : images) {
+            vkDestroyImage(vkDevice, image, nullptr);
+        }
+        for (VkDeviceMemory memory : memories) {
+            vkFreeMemory(vkDevice, memory, nullptr);
+        }
+    });
+}
+
 void RenderingResources::findResourcesFormats() {
     // Initialize depth format
     depthFormat = device.getDepthFormat();
@@ -146,7 +322,7 @@ void RenderingResources::createDepthResources() {
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         // Create depth image
         device.createImageWithInfo(
             imageInfo,
@@ -181,18 +357,9 @@ void RenderingResources::createDepthResources() {
 }
 
 void RenderingResources::createDepthPyramidResources(){
-    auto computeMipLevels = [&](uint32_t w, uint32_t h)->uint32_t {
-        uint32_t maxDim = std::max(w, h);
-        uint32_t levels = 1;
-        while ((maxDim >>= 1) > 0) { ++levels; }
-        return levels;
-    };
-
-    const uint32_t requested = RC_DEPTH_MIP_LEVELS;
-    const uint32_t maxPossible = computeMipLevels(width, height);
-    const uint32_t mipLevels = requested == 0 ? maxPossible : std::min(requested, maxPossible);
+    const uint32_t mipLevels = depthPyramidMipCount(width, height);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -263,9 +430,8 @@ void RenderingResources::createDepthPyramidResources(){
         setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)depthPyramidMemories[i], "DepthPyramidMemory_Frame" + std::to_string(i));
     }
 
-    // One-time init: transition all pyramid images (all mips) to READ_ONLY so passes can assume a known starting layout
-    VkCommandBuffer cmd = device.beginSingleTimeCommands();
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    // Initial layout: all mips READ_ONLY so passes can assume a known starting layout. Recorded with the next frame
+    for (size_t i = 0; i < frameSlots; ++i) {
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.srcAccessMask = 0;
@@ -280,18 +446,8 @@ void RenderingResources::createDepthPyramidResources(){
         barrier.subresourceRange.levelCount = depthPyramidMipLevels[i];
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
-
-        vkCmdPipelineBarrier(
-            cmd,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
+        pendingLayoutInits.push_back(barrier);
     }
-    device.endSingleTimeCommands(cmd);
 
     // Create a dedicated sampler for depth pyramid sampling.
     // IMPORTANT: depth comparisons must be done with point sampling to avoid mixing geometry depth
@@ -313,7 +469,7 @@ void RenderingResources::createDepthPyramidResources(){
         samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = static_cast<float>(mipLevels);
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;    // outlives resizes, which change the mip count
 
         if (vkCreateSampler(device.getDevice(), &samplerInfo, nullptr, &depthPyramidSampler) != VK_SUCCESS) {
             throw std::runtime_error("failed to create depth pyramid sampler!");
@@ -327,32 +483,34 @@ void RenderingResources::createDepthPyramidResources(){
 void RenderingResources::createLightPassResources(){
 
     std::cout << "Creating light pass resources" << std::endl;
-     // Create a sampler for the light pass result
-     VkSamplerCreateInfo samplerInfo{};
-     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-     samplerInfo.magFilter = VK_FILTER_LINEAR;
-     samplerInfo.minFilter = VK_FILTER_LINEAR;
-     samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-     samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-     samplerInfo.anisotropyEnable = VK_FALSE;
-     samplerInfo.maxAnisotropy = 1.0f;
-     samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
-     samplerInfo.unnormalizedCoordinates = VK_FALSE;
-     samplerInfo.compareEnable = VK_FALSE;
-     samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-     samplerInfo.mipLodBias = 0.0f;
-     samplerInfo.minLod = 0.0f;
-     samplerInfo.maxLod = 0.0f;
- 
-     if (vkCreateSampler(device.getDevice(), &samplerInfo, nullptr, &lightPassSampler) != VK_SUCCESS) {
-         throw std::runtime_error("failed to create light pass sampler!");
+     // Create a sampler for the light pass result; it survives resizes
+     if (lightPassSampler == VK_NULL_HANDLE) {
+         VkSamplerCreateInfo samplerInfo{};
+         samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+         samplerInfo.magFilter = VK_FILTER_LINEAR;
+         samplerInfo.minFilter = VK_FILTER_LINEAR;
+         samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+         samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+         samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+         samplerInfo.anisotropyEnable = VK_FALSE;
+         samplerInfo.maxAnisotropy = 1.0f;
+         samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+         samplerInfo.unnormalizedCoordinates = VK_FALSE;
+         samplerInfo.compareEnable = VK_FALSE;
+         samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+         samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+         samplerInfo.mipLodBias = 0.0f;
+         samplerInfo.minLod = 0.0f;
+         samplerInfo.maxLod = 0.0f;
+
+         if (vkCreateSampler(device.getDevice(), &samplerInfo, nullptr, &lightPassSampler) != VK_SUCCESS) {
+             throw std::runtime_error("failed to create light pass sampler!");
+         }
+
+         std::cout << "Light pass sampler created" << std::endl;
      }
- 
-     std::cout << "Light pass sampler created" << std::endl;
      // Create light pass render target images
-     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+     for (size_t i = 0; i < frameSlots; i++) {
 
          VkImageCreateInfo imageInfo{};
          imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -369,49 +527,11 @@ void RenderingResources::createLightPassResources(){
          imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
          imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
  
-         device.createImageWithInfo(
-             imageInfo,
-             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-             lightPassResultImages[i],
-             lightPassResultMemories[i]
-         );
-
-         // Create image view
-         VkImageViewCreateInfo viewInfo{};
-         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-         viewInfo.image = lightPassResultImages[i];
-         viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-         viewInfo.format = hdrFormat;
-         viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-         viewInfo.subresourceRange.baseMipLevel = 0;
-         viewInfo.subresourceRange.levelCount = 1;
-         viewInfo.subresourceRange.baseArrayLayer = 0;
-         viewInfo.subresourceRange.layerCount = 1;
- 
-         if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &lightPassResultViews[i]) != VK_SUCCESS) {
-             throw std::runtime_error("failed to create light pass image view!");
-         }
-
-         // Set debug names
-         setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)lightPassResultImages[i], "LightPassImage_Frame" + std::to_string(i));
-         setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)lightPassResultViews[i], "LightPassView_Frame" + std::to_string(i));
-         setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)lightPassResultMemories[i], "LightPassMemory_Frame" + std::to_string(i));
-
+         createTransientImage(imageInfo, TransientImages::LIGHT_PASS_RESULT, i,
+                              lightPassResultImages[i], lightPassResultViews[i], "LightPass_Frame" + std::to_string(i));
          // Incident diffuse buffer (pre-albedo) – same format/usages
-         device.createImageWithInfo(
-             imageInfo,
-             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-             lightIncidentImages[i],
-             lightIncidentMemories[i]
-         );
-
-         viewInfo.image = lightIncidentImages[i];
-         if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &lightIncidentViews[i]) != VK_SUCCESS) {
-             throw std::runtime_error("failed to create light incident image view!");
-         }
-         setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)lightIncidentImages[i], "LightIncidentImage_Frame" + std::to_string(i));
-         setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)lightIncidentViews[i], "LightIncidentView_Frame" + std::to_string(i));
-         setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)lightIncidentMemories[i], "LightIncidentMemory_Frame" + std::to_string(i));
+         createTransientImage(imageInfo, TransientImages::LIGHT_INCIDENT, i,
+                              lightIncidentImages[i], lightIncidentViews[i], "LightIncident_Frame" + std::to_string(i));
      }
 
      // Set debug name for sampler
@@ -503,6 +623,10 @@ void RenderingResources::cleanup() {
         vkDestroyDescriptorSetLayout(device.getDevice(), depthPyramidSetLayout, nullptr);
         depthPyramidSetLayout = VK_NULL_HANDLE;
     }
+    if (depthBoundsSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device.getDevice(), depthBoundsSetLayout, nullptr);
+        depthBoundsSetLayout = VK_NULL_HANDLE;
+    }
 
     // Clean up samplers
     if (lightPassSampler != VK_NULL_HANDLE) {
@@ -553,7 +677,7 @@ void RenderingResources::cleanup() {
     }
 
     // Clean up depth resources
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         if (depthViews[i] != VK_NULL_HANDLE) {
             vkDestroyImageView(device.getDevice(), depthViews[i], nullptr);
             depthViews[i] = VK_NULL_HANDLE;
@@ -569,7 +693,7 @@ void RenderingResources::cleanup() {
     }
 
     // Clean up depth pyramid resources
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         // Clean up per-mip storage views first
         for (auto& mipView : depthPyramidMipStorageViews[i]) {
             if (mipView != VK_NULL_HANDLE) {
@@ -594,7 +718,7 @@ void RenderingResources::cleanup() {
     }
 
     // Clean up light pass resources
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         if (lightPassResultViews[i] != VK_NULL_HANDLE) {
             vkDestroyImageView(device.getDevice(), lightPassResultViews[i], nullptr);
             lightPassResultViews[i] = VK_NULL_HANDLE;
@@ -611,18 +735,10 @@ void RenderingResources::cleanup() {
             vkDestroyImage(device.getDevice(), lightIncidentImages[i], nullptr);
             lightIncidentImages[i] = VK_NULL_HANDLE;
         }
-        if (lightPassResultMemories[i] != VK_NULL_HANDLE) {
-            vkFreeMemory(device.getDevice(), lightPassResultMemories[i], nullptr);
-            lightPassResultMemories[i] = VK_NULL_HANDLE;
-        }
-        if (lightIncidentMemories[i] != VK_NULL_HANDLE) {
-            vkFreeMemory(device.getDevice(), lightIncidentMemories[i], nullptr);
-            lightIncidentMemories[i] = VK_NULL_HANDLE;
-        }
     }
 
     // Clean up transparency resources
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         if (accumulationViews[i] != VK_NULL_HANDLE) {
             vkDestroyImageView(device.getDevice(), accumulationViews[i], nullptr);
             accumulationViews[i] = VK_NULL_HANDLE;
@@ -631,10 +747,6 @@ void RenderingResources::cleanup() {
             vkDestroyImage(device.getDevice(), accumulationImages[i], nullptr);
             accumulationImages[i] = VK_NULL_HANDLE;
         }
-        if (accumulationMemories[i] != VK_NULL_HANDLE) {
-            vkFreeMemory(device.getDevice(), accumulationMemories[i], nullptr);
-            accumulationMemories[i] = VK_NULL_HANDLE;
-        }
 
         if (revealageViews[i] != VK_NULL_HANDLE) {
             vkDestroyImageView(device.getDevice(), revealageViews[i], nullptr);
@@ -644,14 +756,10 @@ void RenderingResources::cleanup() {
             vkDestroyImage(device.getDevice(), revealageImages[i], nullptr);
             revealageImages[i] = VK_NULL_HANDLE;
         }
-        if (revealageMemories[i] != VK_NULL_HANDLE) {
-            vkFreeMemory(device.getDevice(), revealageMemories[i], nullptr);
-            revealageMemories[i] = VK_NULL_HANDLE;
-        }
     }
 
     // Clean up GI indirect resources
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         if (giIndirectViews[i] != VK_NULL_HANDLE) {
             vkDestroyImageView(device.getDevice(), giIndirectViews[i], nullptr);
             giIndirectViews[i] = VK_NULL_HANDLE;
@@ -667,8 +775,8 @@ void RenderingResources::cleanup() {
     }
 
     // Clean up post-process render targets
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        auto destroyImageTriple = [&](VkImage& image, VkDeviceMemory& memory, VkImageView& view) {
+    for (size_t i = 0; i < frameSlots; ++i) {
+        auto destroyImagePair = [&](VkImage& image, VkImageView& view) {
             if (view != VK_NULL_HANDLE) {
                 vkDestroyImageView(device.getDevice(), view, nullptr);
                 view = VK_NULL_HANDLE;
@@ -677,21 +785,17 @@ void RenderingResources::cleanup() {
                 vkDestroyImage(device.getDevice(), image, nullptr);
                 image = VK_NULL_HANDLE;
             }
-            if (memory != VK_NULL_HANDLE) {
-                vkFreeMemory(device.getDevice(), memory, nullptr);
-                memory = VK_NULL_HANDLE;
-            }
         };
 
-        destroyImageTriple(compositionColorImages[i], compositionColorMemories[i], compositionColorViews[i]);
-        destroyImageTriple(smaaEdgeImages[i], smaaEdgeMemories[i], smaaEdgeViews[i]);
-        destroyImageTriple(smaaBlendImages[i], smaaBlendMemories[i], smaaBlendViews[i]);
-        destroyImageTriple(postAAColorImages[i], postAAColorMemories[i], postAAColorViews[i]);
+        destroyImagePair(compositionColorImages[i], compositionColorViews[i]);
+        destroyImagePair(smaaEdgeImages[i], smaaEdgeViews[i]);
+        destroyImagePair(smaaBlendImages[i], smaaBlendViews[i]);
+        destroyImagePair(postAAColorImages[i], postAAColorViews[i]);
     }
 
     // Clean up RC atlases
     for (uint32_t cascade = 0; cascade < RC_CASCADE_COUNT; ++cascade) {
-        for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+        for (size_t frame = 0; frame < frameSlots; ++frame) {
             if (rcRadianceViews[cascade][frame] != VK_NULL_HANDLE) {
                 vkDestroyImageView(device.getDevice(), rcRadianceViews[cascade][frame], nullptr);
                 rcRadianceViews[cascade][frame] = VK_NULL_HANDLE;
@@ -700,43 +804,52 @@ void RenderingResources::cleanup() {
                 vkDestroyImage(device.getDevice(), rcRadianceImages[cascade][frame], nullptr);
                 rcRadianceImages[cascade][frame] = VK_NULL_HANDLE;
             }
-            if (rcRadianceMemories[cascade][frame] != VK_NULL_HANDLE) {
-                vkFreeMemory(device.getDevice(), rcRadianceMemories[cascade][frame], nullptr);
-                rcRadianceMemories[cascade][frame] = VK_NULL_HANDLE;
-            }
         }
     }
 
+    // Transient heaps, once every image bound to them is gone
+    for (size_t frame = 0; frame < frameSlots; ++frame) {
+        for (VkDeviceMemory heap : transientHeaps[frame]) {
+            vkFreeMemory(device.getDevice(), heap, nullptr);
+        }
+        transientHeaps[frame].clear();
+    }
+    transientImages.clear();
+
     // Clean up shadow maps - now per frame per light
     for (size_t lightIndex = 0; lightIndex < MAX_DIRECTIONAL_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             directionalMaps[lightIndex][frameIndex].reset();
         }
     }
     for (size_t lightIndex = 0; lightIndex < MAX_SPOT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             spotlightMaps[lightIndex][frameIndex].reset();
         }
     }
     for (size_t lightIndex = 0; lightIndex < MAX_POINT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             pointlightMaps[lightIndex][frameIndex].reset();
         }
     }
 
     // Clean up buffers (unique_ptr will handle destruction automatically)
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         cameraUniformBuffers[i].reset();
         modelMatrixBuffers[i].reset();
         normalMatrixBuffers[i].reset();
         lightArrayUniformBuffers[i].reset();
+        lightSlotStagingBuffers[i].reset();
         cascadeSplitsBuffers[i].reset();
         sceneLightingBuffers[i].reset();
         lightMatrixBuffers[i].reset();
         shadowModelMatrixBuffers[i].reset();
+        shadowFaceMaskBuffers[i].reset();
+        depthBoundsBuffers[i].reset();
         transparencyModelMatrixBuffers[i].reset();
         transparencyNormalMatrixBuffers[i].reset();
     }
+    lightSlotBuffer.reset();
 
     // Clean up GBuffer (unique_ptr will handle destruction automatically)
     gBuffer.reset();
@@ -750,7 +863,7 @@ void RenderingResources::cleanup() {
 void RenderingResources::createBuffers(){
     
     std::cout << "Creating camera, model, and normal matrix buffers..." << std::endl;
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (uint32_t i = 0; i < frameSlots; i++) {
         cameraUniformBuffers[i] = std::make_unique<Buffer>(
             device,
             sizeof(CameraUbo),
@@ -787,11 +900,11 @@ void RenderingResources::createBuffers(){
     std::cout << "Camera, model, and normal matrix buffers created successfully." << std::endl;
 
     std::cout << "Creating light array uniform buffers..." << std::endl;
-    VkDeviceSize unifiedLightBufferSize = sizeof(UnifiedLightBuffer); 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    VkDeviceSize visibleLightBufferSize = sizeof(VisibleLightBuffer); 
+    for (size_t i = 0; i < frameSlots; i++) {
         lightArrayUniformBuffers[i] = std::make_unique<Buffer>(
             device,
-            unifiedLightBufferSize,
+            visibleLightBufferSize,
             1,
             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
@@ -801,10 +914,32 @@ void RenderingResources::createBuffers(){
     }
     std::cout << "Light array uniform buffers created successfully." << std::endl;
 
+    std::cout << "Creating light slot buffers..." << std::endl;
+    lightSlotBuffer = std::make_unique<Buffer>(
+        device,
+        sizeof(Light),
+        MAX_LIGHTS,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    );
+    setDebugName(VK_OBJECT_TYPE_BUFFER, (uint64_t)lightSlotBuffer->getBuffer(), "LightSlotBuffer");
+    for (size_t i = 0; i < frameSlots; i++) {
+        lightSlotStagingBuffers[i] = std::make_unique<Buffer>(
+            device,
+            sizeof(Light),
+            MAX_LIGHTS,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        lightSlotStagingBuffers[i]->map();
+        setDebugName(VK_OBJECT_TYPE_BUFFER, (uint64_t)lightSlotStagingBuffers[i]->getBuffer(), "LightSlotStagingBuffer_Frame" + std::to_string(i));
+    }
+    std::cout << "Light slot buffers created successfully." << std::endl;
+
     std::cout << "Creating cascade splits buffers..." << std::endl;
     // Add cascade splits buffer creation
     VkDeviceSize cascadeSplitsBufferSize = sizeof(DirectionalLightCascadesBuffer);  
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         cascadeSplitsBuffers[i] = std::make_unique<Buffer>(
             device,
             cascadeSplitsBufferSize,
@@ -818,7 +953,7 @@ void RenderingResources::createBuffers(){
 
     std::cout << "Creating scene lighting buffers..." << std::endl;
     VkDeviceSize sceneLightingBufferSize = sizeof(SceneLightingUbo);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         sceneLightingBuffers[i] = std::make_unique<Buffer>(
             device,
             sceneLightingBufferSize,
@@ -833,7 +968,7 @@ void RenderingResources::createBuffers(){
 
     std::cout << "Creating light matrix buffers..." << std::endl;
     VkDeviceSize bufferSize = sizeof(ShadowcastingLightMatrices);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         lightMatrixBuffers[i] = std::make_unique<Buffer>(
             device,
             bufferSize,
@@ -847,7 +982,7 @@ void RenderingResources::createBuffers(){
 
     std::cout << "Creating shadow model matrix buffers..." << std::endl;
     VkDeviceSize shadowModelMatrixBuffer = sizeof(glm::mat4);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         shadowModelMatrixBuffers[i] = std::make_unique<Buffer>(
             device,
             shadowModelMatrixBuffer,
@@ -856,12 +991,39 @@ void RenderingResources::createBuffers(){
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
         );
         shadowModelMatrixBuffers[i]->map();
+
+        // One cube face mask per shadow instance, indexed like the model matrices
+        shadowFaceMaskBuffers[i] = std::make_unique<Buffer>(
+            device,
+            sizeof(uint32_t),
+            BASE_INSTANCED_RENDERABLES * MAX_SHADOW_CASCADE_COUNT,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        shadowFaceMaskBuffers[i]->map();
     }
     std::cout << "Shadow model matrix buffers created successfully." << std::endl;
 
+    std::cout << "Creating depth bounds readback buffers..." << std::endl;
+    for (size_t i = 0; i < frameSlots; i++) {
+        depthBoundsBuffers[i] = std::make_unique<Buffer>(
+            device,
+            sizeof(DepthBoundsBuffer),
+            1,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        depthBoundsBuffers[i]->map();
+        // Start empty so the first frames fall back to the fixed split scheme
+        DepthBoundsBuffer emptyBounds{};
+        depthBoundsBuffers[i]->writeToBuffer(&emptyBounds);
+        setDebugName(VK_OBJECT_TYPE_BUFFER, (uint64_t)depthBoundsBuffers[i]->getBuffer(), "DepthBoundsBuffer_Frame" + std::to_string(i));
+    }
+    std::cout << "Depth bounds readback buffers created successfully." << std::endl;
+
     std::cout << "Creating transparency buffers..." << std::endl;
     VkDeviceSize matrixBufferSize = sizeof(glm::mat4);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         transparencyModelMatrixBuffers[i] = std::make_unique<Buffer>(
             device,
             matrixBufferSize,
@@ -888,35 +1050,32 @@ void RenderingResources::createDescriptorPool(){
     std::cout << "Creating descriptor pool..." << std::endl;
     // Recompute descriptor pool sizes with current pipelines (including RC and depth pyramid)
     std::cout << "Calculating descriptor pool sizes..." << std::endl;
-    uint32_t pyrMaxMips = 0;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        pyrMaxMips = std::max(pyrMaxMips, depthPyramidMipLevels[i]);
-    }
+    const uint32_t pyrMaxMips = maxDepthPyramidMipLevels();
     const uint32_t pyramidExtraSetsPerFrame = (pyrMaxMips > 0) ? (pyrMaxMips - 1) : 0; // exclude seed mip0
 
     // Sets per frame:
-    // 18 core sets (models, camera, gbuffer, lights, shadows, transparency, composition,
-    // depth pyramid seed, RC build, RC resolve, SMAA edge/weight/blend, color correction, shadow sampler)
+    // 19 core sets (models, camera, gbuffer, lights, shadows, transparency, composition,
+    // depth pyramid seed, depth bounds, RC build, RC resolve, SMAA edge/weight/blend, color correction, shadow sampler)
     // + per-mip depth pyramid sets.
     const uint32_t totalDescriptorSets =
-        MAX_FRAMES_IN_FLIGHT * (18 + pyramidExtraSetsPerFrame) +
+        frameSlots * (19 + pyramidExtraSetsPerFrame) +
         1; // skybox
 
     // Uniform buffers per frame: camera, light array, cascade splits, scene lighting, light matrix, RC build, RC resolve
-    const uint32_t uniformBufferCount = MAX_FRAMES_IN_FLIGHT * 7;
+    const uint32_t uniformBufferCount = frameSlots * 7;
 
-    // Storage buffers per frame: models (2), shadow models (1), transparency models (2)
-    const uint32_t storageBufferCount = MAX_FRAMES_IN_FLIGHT * 5;
+    // Storage buffers per frame: models (2), shadow models + face masks (2), transparency models (2), depth bounds (1), light slots (1)
+    const uint32_t storageBufferCount = frameSlots * 8;
 
     // Combined image samplers per frame:
-    const uint32_t gbufferSamplers = MAX_FRAMES_IN_FLIGHT * 4;
-    const uint32_t shadowSamplers = MAX_FRAMES_IN_FLIGHT * (MAX_DIRECTIONAL_LIGHTS + MAX_SPOT_LIGHTS + MAX_POINT_LIGHTS);
-    const uint32_t compositionSamplers = MAX_FRAMES_IN_FLIGHT * 4;
-    const uint32_t depthPyramidSamplers = MAX_FRAMES_IN_FLIGHT * (1 + pyramidExtraSetsPerFrame); // seed + per-mip
-    const uint32_t rcBuildSamplers = MAX_FRAMES_IN_FLIGHT * 6; // gbuffer4 + depth + incident
-    const uint32_t rcResolveSamplers = MAX_FRAMES_IN_FLIGHT * (RC_CASCADE_COUNT + 6); // gbuffer4 + radiance array + history + prev pos
-    const uint32_t smaaSamplers = MAX_FRAMES_IN_FLIGHT * (1 + 3 + 2); // edge + weight + blend
-    const uint32_t colorCorrectionSamplers = MAX_FRAMES_IN_FLIGHT * 1;
+    const uint32_t gbufferSamplers = frameSlots * 4;
+    const uint32_t shadowSamplers = frameSlots * (MAX_DIRECTIONAL_LIGHTS + MAX_SPOT_LIGHTS + MAX_POINT_LIGHTS);
+    const uint32_t compositionSamplers = frameSlots * 4;
+    const uint32_t depthPyramidSamplers = frameSlots * (2 + pyramidExtraSetsPerFrame); // seed + per-mip + depth bounds
+    const uint32_t rcBuildSamplers = frameSlots * 6; // gbuffer4 + depth + incident
+    const uint32_t rcResolveSamplers = frameSlots * (RC_CASCADE_COUNT + 6); // gbuffer4 + radiance array + history + prev pos
+    const uint32_t smaaSamplers = frameSlots * (1 + 3 + 2); // edge + weight + blend
+    const uint32_t colorCorrectionSamplers = frameSlots * 1;
     const uint32_t skyboxSamplers = 1;
     const uint32_t combinedImageSamplerCount =
         gbufferSamplers +
@@ -932,7 +1091,7 @@ void RenderingResources::createDescriptorPool(){
     // Storage images per frame:
     // RC build radiance atlases (N), depth pyramid seed (1), per-mip outputs, RC resolve GI output (1)
     const uint32_t storageImageCount =
-        MAX_FRAMES_IN_FLIGHT * (RC_CASCADE_COUNT + 2 + pyramidExtraSetsPerFrame); // +2 = depth seed + gi output
+        frameSlots * (RC_CASCADE_COUNT + 2 + pyramidExtraSetsPerFrame); // +2 = depth seed + gi output
 
     std::cout << "Pool sizes: " << totalDescriptorSets << " sets, "
               << uniformBufferCount << " uniform buffers, "
@@ -1065,16 +1224,21 @@ void RenderingResources::createDescriptorSetLayouts(){
     std::cout << "GBuffer descriptor set layout created successfully." << std::endl;
 
     std::cout << "Creating light array descriptor set layout..." << std::endl;
-    VkDescriptorSetLayoutBinding lightArrayBinding{};
-    lightArrayBinding.binding = 0;
-    lightArrayBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    lightArrayBinding.descriptorCount = 1;
-    lightArrayBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    // Binding 0: visible light list (per frame), binding 1: persistent light slots
+    std::array<VkDescriptorSetLayoutBinding, 2> lightArrayBindings{};
+    lightArrayBindings[0].binding = 0;
+    lightArrayBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    lightArrayBindings[0].descriptorCount = 1;
+    lightArrayBindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    lightArrayBindings[1].binding = 1;
+    lightArrayBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    lightArrayBindings[1].descriptorCount = 1;
+    lightArrayBindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
     VkDescriptorSetLayoutCreateInfo lightLayoutInfo{};
     lightLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    lightLayoutInfo.bindingCount = 1;
-    lightLayoutInfo.pBindings = &lightArrayBinding;
+    lightLayoutInfo.bindingCount = static_cast<uint32_t>(lightArrayBindings.size());
+    lightLayoutInfo.pBindings = lightArrayBindings.data();
 
     if (vkCreateDescriptorSetLayout(device.getDevice(), &lightLayoutInfo, nullptr, &lightArrayDescriptorSetLayout) != VK_SUCCESS) {
         throw std::runtime_error("failed to create unified light descriptor set layout!");
@@ -1171,16 +1335,22 @@ void RenderingResources::createDescriptorSetLayouts(){
 
     //Create descriptor set layout for shadow model matrix
     std::cout << "Creating shadow model matrix descriptor set layout..." << std::endl;
-    VkDescriptorSetLayoutBinding shadowModelMatrixBinding{};
-    shadowModelMatrixBinding.binding = 0;
-    shadowModelMatrixBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    shadowModelMatrixBinding.descriptorCount = 1;
-    shadowModelMatrixBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    std::array<VkDescriptorSetLayoutBinding, 2> shadowModelMatrixBindings{};
+    shadowModelMatrixBindings[0].binding = 0;
+    shadowModelMatrixBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    shadowModelMatrixBindings[0].descriptorCount = 1;
+    shadowModelMatrixBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // Per-instance cube face masks for single-pass point light shadows
+    shadowModelMatrixBindings[1].binding = 1;
+    shadowModelMatrixBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    shadowModelMatrixBindings[1].descriptorCount = 1;
+    shadowModelMatrixBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     
     VkDescriptorSetLayoutCreateInfo shadowModelMatrixLayoutInfo{};
     shadowModelMatrixLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    shadowModelMatrixLayoutInfo.bindingCount = 1;
-    shadowModelMatrixLayoutInfo.pBindings = &shadowModelMatrixBinding;
+    shadowModelMatrixLayoutInfo.bindingCount = static_cast<uint32_t>(shadowModelMatrixBindings.size());
+    shadowModelMatrixLayoutInfo.pBindings = shadowModelMatrixBindings.data();
     
     if (vkCreateDescriptorSetLayout(device.getDevice(), &shadowModelMatrixLayoutInfo, nullptr, &shadowModelMatrixDescriptorSetLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create shadow model matrix descriptor set layout");
@@ -1480,12 +1650,37 @@ void RenderingResources::createDescriptorSetLayouts(){
     setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)depthPyramidSetLayout, "DepthPyramidDescriptorSetLayout");
     std::cout << "Depth pyramid descriptor set layout created successfully." << std::endl;
 
+    // Depth bounds reduction (SDSM): sampled pyramid + readback buffer
+    std::cout << "Creating depth bounds descriptor set layout..." << std::endl;
+    std::array<VkDescriptorSetLayoutBinding, 2> depthBoundsBindings{};
+    // 0: full depth pyramid (combined image sampler)
+    depthBoundsBindings[0].binding = 0;
+    depthBoundsBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    depthBoundsBindings[0].descriptorCount = 1;
+    depthBoundsBindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    // 1: min/max depth output (storage buffer, host visible)
+    depthBoundsBindings[1].binding = 1;
+    depthBoundsBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    depthBoundsBindings[1].descriptorCount = 1;
+    depthBoundsBindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo depthBoundsLayoutInfo{};
+    depthBoundsLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    depthBoundsLayoutInfo.bindingCount = static_cast<uint32_t>(depthBoundsBindings.size());
+    depthBoundsLayoutInfo.pBindings = depthBoundsBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device.getDevice(), &depthBoundsLayoutInfo, nullptr, &depthBoundsSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth bounds descriptor set layout!");
+    }
+    setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, (uint64_t)depthBoundsSetLayout, "DepthBoundsDescriptorSetLayout");
+    std::cout << "Depth bounds descriptor set layout created successfully." << std::endl;
+
 }
 
 void RenderingResources::createDescriptorSets(){
 
     std::cout << "Creating descriptor sets..." << std::endl;
-     for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++){
+     for (uint32_t i = 0; i < frameSlots; i++){
         std::cout << "Creating descriptor sets for frame " << i << std::endl;
         
         //Create descriptor set for instance buffer
@@ -1526,29 +1721,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate GBuffer descriptor set");
         }
         
-        // Then prepare the image infos and update the descriptor set
-        std::array<VkDescriptorImageInfo, 4> gbufferImageInfos;
-        gbufferImageInfos[0] = {gBuffer->getSampler(), gBuffer->getPositionView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
-        gbufferImageInfos[1] = {gBuffer->getSampler(), gBuffer->getNormalView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
-        gbufferImageInfos[2] = {gBuffer->getSampler(), gBuffer->getAlbedoView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
-        gbufferImageInfos[3] = {gBuffer->getSampler(), gBuffer->getMaterialView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
-
-        std::array<VkWriteDescriptorSet, 4> gbufferDescriptorWrites{};
-        for (size_t j = 0; j < gbufferDescriptorWrites.size(); j++) {
-            gbufferDescriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            gbufferDescriptorWrites[j].dstSet = gBufferDescriptorSets[i];
-            gbufferDescriptorWrites[j].dstBinding = j;
-            gbufferDescriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            gbufferDescriptorWrites[j].descriptorCount = 1;
-            gbufferDescriptorWrites[j].pImageInfo = &gbufferImageInfos[j];
-        }
-
-        vkUpdateDescriptorSets(
-            device.getDevice(),
-            static_cast<uint32_t>(gbufferDescriptorWrites.size()),
-            gbufferDescriptorWrites.data(),
-            0, nullptr
-        );
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)gBufferDescriptorSets[i], "GBufferDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  GBuffer descriptor set created successfully." << std::endl;
 
@@ -1568,15 +1740,23 @@ void RenderingResources::createDescriptorSets(){
         bufferInfoUnifiedLight.offset = 0;
         bufferInfoUnifiedLight.range = lightArrayUniformBuffers[i]->getBufferSize();
 
-        VkWriteDescriptorSet writeUnifiedLight{};
-        writeUnifiedLight.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeUnifiedLight.dstSet = lightArrayDescriptorSets[i];
-        writeUnifiedLight.dstBinding = 0;
-        writeUnifiedLight.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        writeUnifiedLight.descriptorCount = 1;
-        writeUnifiedLight.pBufferInfo = &bufferInfoUnifiedLight;
-
-        vkUpdateDescriptorSets(device.getDevice(), 1, &writeUnifiedLight, 0, nullptr);
+        VkDescriptorBufferInfo bufferInfoLightSlots = lightSlotBuffer->descriptorInfo();
+
+        std::array<VkWriteDescriptorSet, 2> writeUnifiedLight{};
+        writeUnifiedLight[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeUnifiedLight[0].dstSet = lightArrayDescriptorSets[i];
+        writeUnifiedLight[0].dstBinding = 0;
+        writeUnifiedLight[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writeUnifiedLight[0].descriptorCount = 1;
+        writeUnifiedLight[0].pBufferInfo = &bufferInfoUnifiedLight;
+        writeUnifiedLight[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeUnifiedLight[1].dstSet = lightArrayDescriptorSets[i];
+        writeUnifiedLight[1].dstBinding = 1;
+        writeUnifiedLight[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeUnifiedLight[1].descriptorCount = 1;
+        writeUnifiedLight[1].pBufferInfo = &bufferInfoLightSlots;
+
+        vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(writeUnifiedLight.size()), writeUnifiedLight.data(), 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)lightArrayDescriptorSets[i], "LightArrayDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  Light array descriptor set created successfully." << std::endl;
 
@@ -1657,8 +1837,11 @@ void RenderingResources::createDescriptorSets(){
         bufferInfoModelMatrix.offset = 0;
         bufferInfoModelMatrix.range = shadowModelMatrixBuffers[i]->getBufferSize();
 
+        VkDescriptorBufferInfo bufferInfoFaceMask = shadowFaceMaskBuffers[i]->descriptorInfo();
+
         DescriptorWriter(shadowModelMatrixDescriptorSetLayout, *descriptorPool)
             .writeBuffer(0, &bufferInfoModelMatrix, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+            .writeBuffer(1, &bufferInfoFaceMask, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
             .build(shadowModelMatrixDescriptorSets[i]);
         std::cout << "  Shadow model matrix descriptor set created successfully." << std::endl;
 
@@ -1685,47 +1868,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate composition descriptor set");
         }
 
-        // Prepare image infos
-        std::array<VkDescriptorImageInfo, 4> compositionImageInfos;
-        
-        // Opaque render result from light pass
-        compositionImageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        compositionImageInfos[0].imageView = lightPassResultViews[i];
-        compositionImageInfos[0].sampler = lightPassSampler;
-        
-        // Transparency accumulation buffer
-        compositionImageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        compositionImageInfos[1].imageView = accumulationViews[i];
-        compositionImageInfos[1].sampler = lightPassSampler;
-        
-        // Transparency revealage buffer
-        compositionImageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        compositionImageInfos[2].imageView = revealageViews[i];
-        compositionImageInfos[2].sampler = lightPassSampler;
-
-        // Indirect GI buffer stays in GENERAL because RCGI computes and readers share it within one frame.
-        compositionImageInfos[3].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-        compositionImageInfos[3].imageView = giIndirectViews[i];
-        compositionImageInfos[3].sampler = lightPassSampler;
-
-        // Prepare write descriptor sets
-        std::array<VkWriteDescriptorSet, 4> compositionDescriptorWrites{};
-        for (size_t j = 0; j < compositionDescriptorWrites.size(); j++) {
-            compositionDescriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            compositionDescriptorWrites[j].dstSet = compositionDescriptorSets[i];
-            compositionDescriptorWrites[j].dstBinding = j;
-            compositionDescriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            compositionDescriptorWrites[j].descriptorCount = 1;
-            compositionDescriptorWrites[j].pImageInfo = &compositionImageInfos[j];
-        }
-
-        // Update descriptor sets
-        vkUpdateDescriptorSets(
-            device.getDevice(),
-            static_cast<uint32_t>(compositionDescriptorWrites.size()),
-            compositionDescriptorWrites.data(),
-            0, nullptr
-        );
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)compositionDescriptorSets[i], "CompositionDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  Composition descriptor set created successfully." << std::endl;
 
@@ -1741,20 +1883,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate SMAA edge descriptor set");
         }
 
-        VkDescriptorImageInfo smaaEdgeInput{};
-        smaaEdgeInput.sampler = postProcessSampler;
-        smaaEdgeInput.imageView = compositionColorViews[i];
-        smaaEdgeInput.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkWriteDescriptorSet smaaEdgeWrite{};
-        smaaEdgeWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaEdgeWrite.dstSet = smaaEdgeDescriptorSets[i];
-        smaaEdgeWrite.dstBinding = 0;
-        smaaEdgeWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaEdgeWrite.descriptorCount = 1;
-        smaaEdgeWrite.pImageInfo = &smaaEdgeInput;
-
-        vkUpdateDescriptorSets(device.getDevice(), 1, &smaaEdgeWrite, 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)smaaEdgeDescriptorSets[i], "SMAAEdgeDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  SMAA edge descriptor set created successfully." << std::endl;
 
@@ -1770,49 +1898,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate SMAA weight descriptor set");
         }
 
-        VkDescriptorImageInfo smaaEdgesInfo{};
-        smaaEdgesInfo.sampler = postProcessSampler;
-        smaaEdgesInfo.imageView = smaaEdgeViews[i];
-        smaaEdgesInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkDescriptorImageInfo areaInfo{};
-        areaInfo.sampler = smaaAreaSampler;
-        areaInfo.imageView = smaaAreaView;
-        areaInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkDescriptorImageInfo searchInfo{};
-        searchInfo.sampler = smaaSearchSampler;
-        searchInfo.imageView = smaaSearchView;
-        searchInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        std::array<VkWriteDescriptorSet, 3> smaaWeightWrites{};
-        smaaWeightWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaWeightWrites[0].dstSet = smaaWeightDescriptorSets[i];
-        smaaWeightWrites[0].dstBinding = 0;
-        smaaWeightWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaWeightWrites[0].descriptorCount = 1;
-        smaaWeightWrites[0].pImageInfo = &smaaEdgesInfo;
-
-        smaaWeightWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaWeightWrites[1].dstSet = smaaWeightDescriptorSets[i];
-        smaaWeightWrites[1].dstBinding = 1;
-        smaaWeightWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaWeightWrites[1].descriptorCount = 1;
-        smaaWeightWrites[1].pImageInfo = &areaInfo;
-
-        smaaWeightWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaWeightWrites[2].dstSet = smaaWeightDescriptorSets[i];
-        smaaWeightWrites[2].dstBinding = 2;
-        smaaWeightWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaWeightWrites[2].descriptorCount = 1;
-        smaaWeightWrites[2].pImageInfo = &searchInfo;
-
-        vkUpdateDescriptorSets(
-            device.getDevice(),
-            static_cast<uint32_t>(smaaWeightWrites.size()),
-            smaaWeightWrites.data(),
-            0, nullptr
-        );
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)smaaWeightDescriptorSets[i], "SMAAWeightDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  SMAA weight descriptor set created successfully." << std::endl;
 
@@ -1828,37 +1913,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate SMAA blend descriptor set");
         }
 
-        VkDescriptorImageInfo blendColor{};
-        blendColor.sampler = postProcessSampler;
-        blendColor.imageView = compositionColorViews[i];
-        blendColor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkDescriptorImageInfo blendWeights{};
-        blendWeights.sampler = postProcessSampler;
-        blendWeights.imageView = smaaBlendViews[i];
-        blendWeights.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        std::array<VkWriteDescriptorSet, 2> smaaBlendWrites{};
-        smaaBlendWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaBlendWrites[0].dstSet = smaaBlendDescriptorSets[i];
-        smaaBlendWrites[0].dstBinding = 0;
-        smaaBlendWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaBlendWrites[0].descriptorCount = 1;
-        smaaBlendWrites[0].pImageInfo = &blendColor;
-
-        smaaBlendWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        smaaBlendWrites[1].dstSet = smaaBlendDescriptorSets[i];
-        smaaBlendWrites[1].dstBinding = 1;
-        smaaBlendWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        smaaBlendWrites[1].descriptorCount = 1;
-        smaaBlendWrites[1].pImageInfo = &blendWeights;
-
-        vkUpdateDescriptorSets(
-            device.getDevice(),
-            static_cast<uint32_t>(smaaBlendWrites.size()),
-            smaaBlendWrites.data(),
-            0, nullptr
-        );
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)smaaBlendDescriptorSets[i], "SMAABlendDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  SMAA blend descriptor set created successfully." << std::endl;
 
@@ -1874,20 +1928,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate color correction descriptor set");
         }
 
-        VkDescriptorImageInfo postAAInfo{};
-        postAAInfo.sampler = postProcessSampler;
-        postAAInfo.imageView = postAAColorViews[i];
-        postAAInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkWriteDescriptorSet colorCorrectWrite{};
-        colorCorrectWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        colorCorrectWrite.dstSet = colorCorrectionDescriptorSets[i];
-        colorCorrectWrite.dstBinding = 0;
-        colorCorrectWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        colorCorrectWrite.descriptorCount = 1;
-        colorCorrectWrite.pImageInfo = &postAAInfo;
-
-        vkUpdateDescriptorSets(device.getDevice(), 1, &colorCorrectWrite, 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)colorCorrectionDescriptorSets[i], "ColorCorrectionDescriptorSet_Frame" + std::to_string(i));
         std::cout << "  Color correction descriptor set created successfully." << std::endl;
 
@@ -1903,38 +1943,12 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate depth pyramid descriptor set");
         }
 
-        VkDescriptorImageInfo srcDepthInfo{};
-        srcDepthInfo.sampler = depthPyramidSampler; // point sampling for depth
-        srcDepthInfo.imageView = depthViews[i];
-        srcDepthInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-
-        VkDescriptorImageInfo dstPyrInfo{};
-        dstPyrInfo.sampler = VK_NULL_HANDLE;
-        // write mip0 storage view for seed
-        dstPyrInfo.imageView = depthPyramidMipStorageViews[i][0];
-        dstPyrInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // will be transitioned before dispatch
-
-        std::array<VkWriteDescriptorSet, 2> pyrWrites{};
-        pyrWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        pyrWrites[0].dstSet = depthPyramidDescriptorSets[i];
-        pyrWrites[0].dstBinding = 0;
-        pyrWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        pyrWrites[0].descriptorCount = 1;
-        pyrWrites[0].pImageInfo = &srcDepthInfo;
-
-        pyrWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        pyrWrites[1].dstSet = depthPyramidDescriptorSets[i];
-        pyrWrites[1].dstBinding = 1;
-        pyrWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-        pyrWrites[1].descriptorCount = 1;
-        pyrWrites[1].pImageInfo = &dstPyrInfo;
-
-        vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(pyrWrites.size()), pyrWrites.data(), 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)depthPyramidDescriptorSets[i], "DepthPyramidDescriptorSet_Frame" + std::to_string(i));
 
-        // Allocate per-mip descriptor sets (mips 1..N-1) for the downsample loop
-        depthPyramidMipDescriptorSets[i].resize(depthPyramidMipLevels[i]);
-        for (uint32_t m = 1; m < depthPyramidMipLevels[i]; ++m) {
+        // Allocate per-mip descriptor sets (mips 1..N-1) for the downsample loop. Sized for the largest pyramid
+        // the device allows, so a resize only rewrites them
+        depthPyramidMipDescriptorSets[i].resize(maxDepthPyramidMipLevels());
+        for (uint32_t m = 1; m < depthPyramidMipDescriptorSets[i].size(); ++m) {
             VkDescriptorSetAllocateInfo allocInfoMip{};
             allocInfoMip.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             allocInfoMip.descriptorPool = descriptorPool->getDescriptorPool();
@@ -1945,48 +1959,29 @@ void RenderingResources::createDescriptorSets(){
             }
             setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)depthPyramidMipDescriptorSets[i][m], 
                         "DepthPyramidMipDescriptorSet_Frame" + std::to_string(i) + "_Mip" + std::to_string(m));
-            
-            // Write the descriptor set immediately after allocation to avoid validation errors
-            // Source: previous mip level (m-1) as sampled input
-            // Note: The source mip will be in SHADER_READ_ONLY_OPTIMAL at dispatch time (transitioned by setMipLevelBarriers)
-            VkDescriptorImageInfo srcMipInfo{};
-            srcMipInfo.sampler = depthPyramidSampler;
-            srcMipInfo.imageView = depthPyramidMipStorageViews[i][m - 1];
-            srcMipInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            
-            // Destination: current mip level (m) as storage output
-            // Note: The destination mip will be in GENERAL at dispatch time (transitioned by setMipLevelBarriers)
-            VkDescriptorImageInfo dstMipInfo{};
-            dstMipInfo.sampler = VK_NULL_HANDLE;
-            dstMipInfo.imageView = depthPyramidMipStorageViews[i][m];
-            dstMipInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-            
-            std::array<VkWriteDescriptorSet, 2> mipWrites{};
-            mipWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mipWrites[0].dstSet = depthPyramidMipDescriptorSets[i][m];
-            mipWrites[0].dstBinding = 0;
-            mipWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            mipWrites[0].descriptorCount = 1;
-            mipWrites[0].pImageInfo = &srcMipInfo;
-            
-            mipWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mipWrites[1].dstSet = depthPyramidMipDescriptorSets[i][m];
-            mipWrites[1].dstBinding = 1;
-            mipWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-            mipWrites[1].descriptorCount = 1;
-            mipWrites[1].pImageInfo = &dstMipInfo;
-            
-            vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(mipWrites.size()), mipWrites.data(), 0, nullptr);
         }
         std::cout << "  Depth pyramid descriptor set created successfully." << std::endl;
 
+        // Create descriptor set for the SDSM depth bounds reduction
+        std::cout << "  Creating depth bounds descriptor set..." << std::endl;
+        VkDescriptorSetAllocateInfo allocInfoBounds{};
+        allocInfoBounds.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfoBounds.descriptorPool = descriptorPool->getDescriptorPool();
+        allocInfoBounds.descriptorSetCount = 1;
+        allocInfoBounds.pSetLayouts = &depthBoundsSetLayout;
+        if (vkAllocateDescriptorSets(device.getDevice(), &allocInfoBounds, &depthBoundsDescriptorSets[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate depth bounds descriptor set");
+        }
+        setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)depthBoundsDescriptorSets[i], "DepthBoundsDescriptorSet_Frame" + std::to_string(i));
+        std::cout << "  Depth bounds descriptor set created successfully." << std::endl;
+
         
         std::cout << "Descriptor sets for frame " << i << " completed successfully." << std::endl;
 
     }
 
     // RC build/resolve descriptor sets per frame
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (uint32_t i = 0; i < frameSlots; ++i) {
         // RC Build
         VkDescriptorSetAllocateInfo allocRCBuild{};
         allocRCBuild.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -1997,35 +1992,6 @@ void RenderingResources::createDescriptorSets(){
             throw std::runtime_error("Failed to allocate RC build descriptor set");
         }
 
-        // Camera UBO
-        VkDescriptorBufferInfo camUbo = cameraUniformBuffers[i]->descriptorInfo();
-        // GBuffer images
-        std::array<VkDescriptorImageInfo, 4> gbInfos{};
-        gbInfos[0] = { gBuffer->getSampler(), gBuffer->getPositionView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        gbInfos[1] = { gBuffer->getSampler(), gBuffer->getNormalView(i),   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        gbInfos[2] = { gBuffer->getSampler(), gBuffer->getAlbedoView(i),   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        gbInfos[3] = { gBuffer->getSampler(), gBuffer->getMaterialView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        // Depth pyramid must use point sampling; light pass can use linear.
-        VkDescriptorImageInfo depthPyrInfo{ depthPyramidSampler, depthPyramidViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        VkDescriptorImageInfo lightPassInfo{ lightPassSampler, lightIncidentViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-        // RC atlases as storage image arrays
-        std::vector<VkDescriptorImageInfo> radStorageInfos(RC_CASCADE_COUNT);
-        for (uint32_t c = 0; c < RC_CASCADE_COUNT; ++c) {
-            radStorageInfos[c] = { VK_NULL_HANDLE, rcRadianceViews[c][i], VK_IMAGE_LAYOUT_GENERAL };
-        }
-
-        std::vector<VkWriteDescriptorSet> writesBuild;
-        writesBuild.reserve(1 + 4 + 1 + 1 + 2);
-
-        VkWriteDescriptorSet w0{}; w0.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w0.dstSet = rcBuildDescriptorSets[i]; w0.dstBinding = 0; w0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; w0.descriptorCount = 1; w0.pBufferInfo = &camUbo; writesBuild.push_back(w0);
-        for (uint32_t b = 0; b < 4; ++b) {
-            VkWriteDescriptorSet w{}; w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w.dstSet = rcBuildDescriptorSets[i]; w.dstBinding = 1 + b; w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w.descriptorCount = 1; w.pImageInfo = &gbInfos[b]; writesBuild.push_back(w);
-        }
-        VkWriteDescriptorSet w5{}; w5.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w5.dstSet = rcBuildDescriptorSets[i]; w5.dstBinding = 5; w5.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w5.descriptorCount = 1; w5.pImageInfo = &depthPyrInfo; writesBuild.push_back(w5);
-        VkWriteDescriptorSet w6{}; w6.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w6.dstSet = rcBuildDescriptorSets[i]; w6.dstBinding = 6; w6.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w6.descriptorCount = 1; w6.pImageInfo = &lightPassInfo; writesBuild.push_back(w6);
-        VkWriteDescriptorSet w7{}; w7.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w7.dstSet = rcBuildDescriptorSets[i]; w7.dstBinding = 7; w7.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; w7.descriptorCount = RC_CASCADE_COUNT; w7.pImageInfo = radStorageInfos.data(); writesBuild.push_back(w7);
-
-        vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(writesBuild.size()), writesBuild.data(), 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)rcBuildDescriptorSets[i], "RCBuildDescriptorSet_Frame" + std::to_string(i));
 
         // RC Resolve
@@ -2037,44 +2003,6 @@ void RenderingResources::createDescriptorSets(){
         if (vkAllocateDescriptorSets(device.getDevice(), &allocRCResolve, &rcResolveDescriptorSets[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to allocate RC resolve descriptor set");
         }
-
-        // Camera
-        VkDescriptorBufferInfo camUboResolve = cameraUniformBuffers[i]->descriptorInfo();
-        // GBuffer again
-        std::array<VkDescriptorImageInfo, 4> gbInfosResolve = gbInfos;
-        // RC atlases sampled arrays (use lightPassSampler as generic sampler)
-        std::vector<VkDescriptorImageInfo> radSampleInfos(RC_CASCADE_COUNT);
-        for (uint32_t c = 0; c < RC_CASCADE_COUNT; ++c) {
-            // Atlases are kept in GENERAL during build+resolve; sample from GENERAL to avoid layout mismatches.
-            radSampleInfos[c] = { lightPassSampler, rcRadianceViews[c][i], VK_IMAGE_LAYOUT_GENERAL };
-        }
-        // Output GI storage image
-        VkDescriptorImageInfo giOut{}; giOut.imageLayout = VK_IMAGE_LAYOUT_GENERAL; giOut.imageView = giIndirectViews[i]; giOut.sampler = VK_NULL_HANDLE;
-
-        // GI history: use previous frame's GI output for temporal accumulation
-        // Frame i uses frame (i-1+MAX_FRAMES_IN_FLIGHT) % MAX_FRAMES_IN_FLIGHT as history
-        uint32_t historyFrameIndex = (i + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
-        VkDescriptorImageInfo giHistoryInfo{};
-        giHistoryInfo.sampler = lightPassSampler;
-        giHistoryInfo.imageView = giIndirectViews[historyFrameIndex];
-        giHistoryInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-
-        // Previous frame position buffer for temporal validation
-        VkDescriptorImageInfo prevPosInfo{};
-        prevPosInfo.sampler = gBuffer->getSampler();
-        prevPosInfo.imageView = gBuffer->getPositionView(historyFrameIndex);
-        prevPosInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        std::vector<VkWriteDescriptorSet> writesResolve;
-        writesResolve.reserve(1 + 4 + 2 + 1 + 1 + 1);
-        VkWriteDescriptorSet r0{}; r0.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r0.dstSet = rcResolveDescriptorSets[i]; r0.dstBinding = 0; r0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; r0.descriptorCount = 1; r0.pBufferInfo = &camUboResolve; writesResolve.push_back(r0);
-        for (uint32_t b = 0; b < 4; ++b) { VkWriteDescriptorSet r{}; r.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r.dstSet = rcResolveDescriptorSets[i]; r.dstBinding = 1 + b; r.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r.descriptorCount = 1; r.pImageInfo = &gbInfosResolve[b]; writesResolve.push_back(r);}        
-        VkWriteDescriptorSet r5{}; r5.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r5.dstSet = rcResolveDescriptorSets[i]; r5.dstBinding = 5; r5.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r5.descriptorCount = RC_CASCADE_COUNT; r5.pImageInfo = radSampleInfos.data(); writesResolve.push_back(r5);
-        VkWriteDescriptorSet r7{}; r7.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r7.dstSet = rcResolveDescriptorSets[i]; r7.dstBinding = 7; r7.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; r7.descriptorCount = 1; r7.pImageInfo = &giOut; writesResolve.push_back(r7);
-        VkWriteDescriptorSet r8{}; r8.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r8.dstSet = rcResolveDescriptorSets[i]; r8.dstBinding = 8; r8.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r8.descriptorCount = 1; r8.pImageInfo = &giHistoryInfo; writesResolve.push_back(r8);
-        VkWriteDescriptorSet r9{}; r9.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r9.dstSet = rcResolveDescriptorSets[i]; r9.dstBinding = 9; r9.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r9.descriptorCount = 1; r9.pImageInfo = &prevPosInfo; writesResolve.push_back(r9);
-
-        vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(writesResolve.size()), writesResolve.data(), 0, nullptr);
         setDebugName(VK_OBJECT_TYPE_DESCRIPTOR_SET, (uint64_t)rcResolveDescriptorSets[i], "RCResolveDescriptorSet_Frame" + std::to_string(i));
     }
     
@@ -2095,10 +2023,329 @@ void RenderingResources::createDescriptorSets(){
       
 }
 
+void RenderingResources::writeImageDescriptorSets(uint32_t i) {
+    // GBuffer attachments
+    std::array<VkDescriptorImageInfo, 4> gbufferImageInfos;
+    gbufferImageInfos[0] = {gBuffer->getSampler(), gBuffer->getPositionView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    gbufferImageInfos[1] = {gBuffer->getSampler(), gBuffer->getNormalView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    gbufferImageInfos[2] = {gBuffer->getSampler(), gBuffer->getAlbedoView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    gbufferImageInfos[3] = {gBuffer->getSampler(), gBuffer->getMaterialView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    std::array<VkWriteDescriptorSet, 4> gbufferDescriptorWrites{};
+    for (size_t j = 0; j < gbufferDescriptorWrites.size(); j++) {
+        gbufferDescriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        gbufferDescriptorWrites[j].dstSet = gBufferDescriptorSets[i];
+        gbufferDescriptorWrites[j].dstBinding = j;
+        gbufferDescriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        gbufferDescriptorWrites[j].descriptorCount = 1;
+        gbufferDescriptorWrites[j].pImageInfo = &gbufferImageInfos[j];
+    }
+
+    vkUpdateDescriptorSets(
+        device.getDevice(),
+        static_cast<uint32_t>(gbufferDescriptorWrites.size()),
+        gbufferDescriptorWrites.data(),
+        0, nullptr
+    );
+
+    // Composition inputs
+    std::array<VkDescriptorImageInfo, 4> compositionImageInfos;
+    
+    // Opaque render result from light pass
+    compositionImageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    compositionImageInfos[0].imageView = lightPassResultViews[i];
+    compositionImageInfos[0].sampler = lightPassSampler;
+    
+    // Transparency accumulation buffer
+    compositionImageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    compositionImageInfos[1].imageView = accumulationViews[i];
+    compositionImageInfos[1].sampler = lightPassSampler;
+    
+    // Transparency revealage buffer
+    compositionImageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    compositionImageInfos[2].imageView = revealageViews[i];
+    compositionImageInfos[2].sampler = lightPassSampler;
+
+    // Indirect GI buffer stays in GENERAL because RCGI computes and readers share it within one frame.
+    compositionImageInfos[3].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    compositionImageInfos[3].imageView = giIndirectViews[i];
+    compositionImageInfos[3].sampler = lightPassSampler;
+
+    // Prepare write descriptor sets
+    std::array<VkWriteDescriptorSet, 4> compositionDescriptorWrites{};
+    for (size_t j = 0; j < compositionDescriptorWrites.size(); j++) {
+        compositionDescriptorWrites[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        compositionDescriptorWrites[j].dstSet = compositionDescriptorSets[i];
+        compositionDescriptorWrites[j].dstBinding = j;
+        compositionDescriptorWrites[j].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        compositionDescriptorWrites[j].descriptorCount = 1;
+        compositionDescriptorWrites[j].pImageInfo = &compositionImageInfos[j];
+    }
+
+    // Update descriptor sets
+    vkUpdateDescriptorSets(
+        device.getDevice(),
+        static_cast<uint32_t>(compositionDescriptorWrites.size()),
+        compositionDescriptorWrites.data(),
+        0, nullptr
+    );
+
+    // SMAA edge detection input
+    VkDescriptorImageInfo smaaEdgeInput{};
+    smaaEdgeInput.sampler = postProcessSampler;
+    smaaEdgeInput.imageView = compositionColorViews[i];
+    smaaEdgeInput.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet smaaEdgeWrite{};
+    smaaEdgeWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaEdgeWrite.dstSet = smaaEdgeDescriptorSets[i];
+    smaaEdgeWrite.dstBinding = 0;
+    smaaEdgeWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaEdgeWrite.descriptorCount = 1;
+    smaaEdgeWrite.pImageInfo = &smaaEdgeInput;
+
+    vkUpdateDescriptorSets(device.getDevice(), 1, &smaaEdgeWrite, 0, nullptr);
+
+    // SMAA weights: edges plus the two LUTs
+    VkDescriptorImageInfo smaaEdgesInfo{};
+    smaaEdgesInfo.sampler = postProcessSampler;
+    smaaEdgesInfo.imageView = smaaEdgeViews[i];
+    smaaEdgesInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo areaInfo{};
+    areaInfo.sampler = smaaAreaSampler;
+    areaInfo.imageView = smaaAreaView;
+    areaInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo searchInfo{};
+    searchInfo.sampler = smaaSearchSampler;
+    searchInfo.imageView = smaaSearchView;
+    searchInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    std::array<VkWriteDescriptorSet, 3> smaaWeightWrites{};
+    smaaWeightWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaWeightWrites[0].dstSet = smaaWeightDescriptorSets[i];
+    smaaWeightWrites[0].dstBinding = 0;
+    smaaWeightWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaWeightWrites[0].descriptorCount = 1;
+    smaaWeightWrites[0].pImageInfo = &smaaEdgesInfo;
+
+    smaaWeightWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaWeightWrites[1].dstSet = smaaWeightDescriptorSets[i];
+    smaaWeightWrites[1].dstBinding = 1;
+    smaaWeightWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaWeightWrites[1].descriptorCount = 1;
+    smaaWeightWrites[1].pImageInfo = &areaInfo;
+
+    smaaWeightWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaWeightWrites[2].dstSet = smaaWeightDescriptorSets[i];
+    smaaWeightWrites[2].dstBinding = 2;
+    smaaWeightWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaWeightWrites[2].descriptorCount = 1;
+    smaaWeightWrites[2].pImageInfo = &searchInfo;
+
+    vkUpdateDescriptorSets(
+        device.getDevice(),
+        static_cast<uint32_t>(smaaWeightWrites.size()),
+        smaaWeightWrites.data(),
+        0, nullptr
+    );
+
+    // SMAA blend inputs
+    VkDescriptorImageInfo blendColor{};
+    blendColor.sampler = postProcessSampler;
+    blendColor.imageView = compositionColorViews[i];
+    blendColor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo blendWeights{};
+    blendWeights.sampler = postProcessSampler;
+    blendWeights.imageView = smaaBlendViews[i];
+    blendWeights.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    std::array<VkWriteDescriptorSet, 2> smaaBlendWrites{};
+    smaaBlendWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaBlendWrites[0].dstSet = smaaBlendDescriptorSets[i];
+    smaaBlendWrites[0].dstBinding = 0;
+    smaaBlendWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaBlendWrites[0].descriptorCount = 1;
+    smaaBlendWrites[0].pImageInfo = &blendColor;
+
+    smaaBlendWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    smaaBlendWrites[1].dstSet = smaaBlendDescriptorSets[i];
+    smaaBlendWrites[1].dstBinding = 1;
+    smaaBlendWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    smaaBlendWrites[1].descriptorCount = 1;
+    smaaBlendWrites[1].pImageInfo = &blendWeights;
+
+    vkUpdateDescriptorSets(
+        device.getDevice(),
+        static_cast<uint32_t>(smaaBlendWrites.size()),
+        smaaBlendWrites.data(),
+        0, nullptr
+    );
+
+    // Color correction input
+    VkDescriptorImageInfo postAAInfo{};
+    postAAInfo.sampler = postProcessSampler;
+    postAAInfo.imageView = postAAColorViews[i];
+    postAAInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet colorCorrectWrite{};
+    colorCorrectWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    colorCorrectWrite.dstSet = colorCorrectionDescriptorSets[i];
+    colorCorrectWrite.dstBinding = 0;
+    colorCorrectWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    colorCorrectWrite.descriptorCount = 1;
+    colorCorrectWrite.pImageInfo = &postAAInfo;
+
+    vkUpdateDescriptorSets(device.getDevice(), 1, &colorCorrectWrite, 0, nullptr);
+
+    // Depth pyramid seed (src depth + dst pyramid mip0)
+    VkDescriptorImageInfo srcDepthInfo{};
+    srcDepthInfo.sampler = depthPyramidSampler; // point sampling for depth
+    srcDepthInfo.imageView = depthViews[i];
+    srcDepthInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo dstPyrInfo{};
+    dstPyrInfo.sampler = VK_NULL_HANDLE;
+    // write mip0 storage view for seed
+    dstPyrInfo.imageView = depthPyramidMipStorageViews[i][0];
+    dstPyrInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // will be transitioned before dispatch
+
+    std::array<VkWriteDescriptorSet, 2> pyrWrites{};
+    pyrWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pyrWrites[0].dstSet = depthPyramidDescriptorSets[i];
+    pyrWrites[0].dstBinding = 0;
+    pyrWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pyrWrites[0].descriptorCount = 1;
+    pyrWrites[0].pImageInfo = &srcDepthInfo;
+
+    pyrWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    pyrWrites[1].dstSet = depthPyramidDescriptorSets[i];
+    pyrWrites[1].dstBinding = 1;
+    pyrWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    pyrWrites[1].descriptorCount = 1;
+    pyrWrites[1].pImageInfo = &dstPyrInfo;
+
+    vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(pyrWrites.size()), pyrWrites.data(), 0, nullptr);
+
+    // Downsample chain: each mip reads the one above it
+    for (uint32_t m = 1; m < depthPyramidMipLevels[i]; ++m) {
+        // Source: previous mip level (m-1) as sampled input
+        // Note: The source mip will be in SHADER_READ_ONLY_OPTIMAL at dispatch time (transitioned by setMipLevelBarriers)
+        VkDescriptorImageInfo srcMipInfo{};
+        srcMipInfo.sampler = depthPyramidSampler;
+        srcMipInfo.imageView = depthPyramidMipStorageViews[i][m - 1];
+        srcMipInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        
+        // Destination: current mip level (m) as storage output
+        // Note: The destination mip will be in GENERAL at dispatch time (transitioned by setMipLevelBarriers)
+        VkDescriptorImageInfo dstMipInfo{};
+        dstMipInfo.sampler = VK_NULL_HANDLE;
+        dstMipInfo.imageView = depthPyramidMipStorageViews[i][m];
+        dstMipInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        
+        std::array<VkWriteDescriptorSet, 2> mipWrites{};
+        mipWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mipWrites[0].dstSet = depthPyramidMipDescriptorSets[i][m];
+        mipWrites[0].dstBinding = 0;
+        mipWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        mipWrites[0].descriptorCount = 1;
+        mipWrites[0].pImageInfo = &srcMipInfo;
+        
+        mipWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mipWrites[1].dstSet = depthPyramidMipDescriptorSets[i][m];
+        mipWrites[1].dstBinding = 1;
+        mipWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        mipWrites[1].descriptorCount = 1;
+        mipWrites[1].pImageInfo = &dstMipInfo;
+        
+        vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(mipWrites.size()), mipWrites.data(), 0, nullptr);
+    }
+
+    // SDSM depth bounds reduction
+    VkDescriptorImageInfo depthBoundsPyramidInfo{ depthPyramidSampler, depthPyramidViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkDescriptorBufferInfo depthBoundsBufferInfo = depthBoundsBuffers[i]->descriptorInfo();
+    DescriptorWriter(depthBoundsSetLayout, *descriptorPool)
+        .writeImage(0, &depthBoundsPyramidInfo)
+        .writeBuffer(1, &depthBoundsBufferInfo, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        .overwrite(depthBoundsDescriptorSets[i]);
+
+    // RC build: camera UBO
+    VkDescriptorBufferInfo camUbo = cameraUniformBuffers[i]->descriptorInfo();
+    // GBuffer images
+    std::array<VkDescriptorImageInfo, 4> gbInfos{};
+    gbInfos[0] = { gBuffer->getSampler(), gBuffer->getPositionView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    gbInfos[1] = { gBuffer->getSampler(), gBuffer->getNormalView(i),   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    gbInfos[2] = { gBuffer->getSampler(), gBuffer->getAlbedoView(i),   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    gbInfos[3] = { gBuffer->getSampler(), gBuffer->getMaterialView(i), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    // Depth pyramid must use point sampling; light pass can use linear.
+    VkDescriptorImageInfo depthPyrInfo{ depthPyramidSampler, depthPyramidViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkDescriptorImageInfo lightPassInfo{ lightPassSampler, lightIncidentViews[i], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    // RC atlases as storage image arrays
+    std::vector<VkDescriptorImageInfo> radStorageInfos(RC_CASCADE_COUNT);
+    for (uint32_t c = 0; c < RC_CASCADE_COUNT; ++c) {
+        radStorageInfos[c] = { VK_NULL_HANDLE, rcRadianceViews[c][i], VK_IMAGE_LAYOUT_GENERAL };
+    }
+
+    std::vector<VkWriteDescriptorSet> writesBuild;
+    writesBuild.reserve(1 + 4 + 1 + 1 + 2);
+
+    VkWriteDescriptorSet w0{}; w0.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w0.dstSet = rcBuildDescriptorSets[i]; w0.dstBinding = 0; w0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; w0.descriptorCount = 1; w0.pBufferInfo = &camUbo; writesBuild.push_back(w0);
+    for (uint32_t b = 0; b < 4; ++b) {
+        VkWriteDescriptorSet w{}; w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w.dstSet = rcBuildDescriptorSets[i]; w.dstBinding = 1 + b; w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w.descriptorCount = 1; w.pImageInfo = &gbInfos[b]; writesBuild.push_back(w);
+    }
+    VkWriteDescriptorSet w5{}; w5.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w5.dstSet = rcBuildDescriptorSets[i]; w5.dstBinding = 5; w5.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w5.descriptorCount = 1; w5.pImageInfo = &depthPyrInfo; writesBuild.push_back(w5);
+    VkWriteDescriptorSet w6{}; w6.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w6.dstSet = rcBuildDescriptorSets[i]; w6.dstBinding = 6; w6.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; w6.descriptorCount = 1; w6.pImageInfo = &lightPassInfo; writesBuild.push_back(w6);
+    VkWriteDescriptorSet w7{}; w7.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; w7.dstSet = rcBuildDescriptorSets[i]; w7.dstBinding = 7; w7.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; w7.descriptorCount = RC_CASCADE_COUNT; w7.pImageInfo = radStorageInfos.data(); writesBuild.push_back(w7);
+
+    vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(writesBuild.size()), writesBuild.data(), 0, nullptr);
+
+    // RC resolve: camera
+    VkDescriptorBufferInfo camUboResolve = cameraUniformBuffers[i]->descriptorInfo();
+    // GBuffer again
+    std::array<VkDescriptorImageInfo, 4> gbInfosResolve = gbInfos;
+    // RC atlases sampled arrays (use lightPassSampler as generic sampler)
+    std::vector<VkDescriptorImageInfo> radSampleInfos(RC_CASCADE_COUNT);
+    for (uint32_t c = 0; c < RC_CASCADE_COUNT; ++c) {
+        // Atlases are kept in GENERAL during build+resolve; sample from GENERAL to avoid layout mismatches.
+        radSampleInfos[c] = { lightPassSampler, rcRadianceViews[c][i], VK_IMAGE_LAYOUT_GENERAL };
+    }
+    // Output GI storage image
+    VkDescriptorImageInfo giOut{}; giOut.imageLayout = VK_IMAGE_LAYOUT_GENERAL; giOut.imageView = giIndirectViews[i]; giOut.sampler = VK_NULL_HANDLE;
+
+    // GI history: use previous frame's GI output for temporal accumulation
+    // Slots are taken in order, so slot i's previous frame used slot (i-1+frameSlots) % frameSlots
+    uint32_t historyFrameIndex = (i + frameSlots - 1) % frameSlots;
+    VkDescriptorImageInfo giHistoryInfo{};
+    giHistoryInfo.sampler = lightPassSampler;
+    giHistoryInfo.imageView = giIndirectViews[historyFrameIndex];
+    giHistoryInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    // Previous frame position buffer for temporal validation
+    VkDescriptorImageInfo prevPosInfo{};
+    prevPosInfo.sampler = gBuffer->getSampler();
+    prevPosInfo.imageView = gBuffer->getPositionView(historyFrameIndex);
+    prevPosInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    std::vector<VkWriteDescriptorSet> writesResolve;
+    writesResolve.reserve(1 + 4 + 2 + 1 + 1 + 1);
+    VkWriteDescriptorSet r0{}; r0.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r0.dstSet = rcResolveDescriptorSets[i]; r0.dstBinding = 0; r0.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; r0.descriptorCount = 1; r0.pBufferInfo = &camUboResolve; writesResolve.push_back(r0);
+    for (uint32_t b = 0; b < 4; ++b) { VkWriteDescriptorSet r{}; r.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r.dstSet = rcResolveDescriptorSets[i]; r.dstBinding = 1 + b; r.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r.descriptorCount = 1; r.pImageInfo = &gbInfosResolve[b]; writesResolve.push_back(r);}        
+    VkWriteDescriptorSet r5{}; r5.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r5.dstSet = rcResolveDescriptorSets[i]; r5.dstBinding = 5; r5.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r5.descriptorCount = RC_CASCADE_COUNT; r5.pImageInfo = radSampleInfos.data(); writesResolve.push_back(r5);
+    VkWriteDescriptorSet r7{}; r7.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r7.dstSet = rcResolveDescriptorSets[i]; r7.dstBinding = 7; r7.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE; r7.descriptorCount = 1; r7.pImageInfo = &giOut; writesResolve.push_back(r7);
+    VkWriteDescriptorSet r8{}; r8.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r8.dstSet = rcResolveDescriptorSets[i]; r8.dstBinding = 8; r8.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r8.descriptorCount = 1; r8.pImageInfo = &giHistoryInfo; writesResolve.push_back(r8);
+    VkWriteDescriptorSet r9{}; r9.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET; r9.dstSet = rcResolveDescriptorSets[i]; r9.dstBinding = 9; r9.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; r9.descriptorCount = 1; r9.pImageInfo = &prevPosInfo; writesResolve.push_back(r9);
+
+    vkUpdateDescriptorSets(device.getDevice(), static_cast<uint32_t>(writesResolve.size()), writesResolve.data(), 0, nullptr);
+
+    staleDescriptorSets[i] = false;
+}
+
 void RenderingResources::createShadowMapSamplerDescriptorSets(){
     
     // Allocate descriptor sets for each frame
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         VkDescriptorSetAllocateInfo allocInfoShadowMapSampler{};
         allocInfoShadowMapSampler.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfoShadowMapSampler.descriptorPool = descriptorPool->getDescriptorPool();
@@ -2111,7 +2358,7 @@ void RenderingResources::createShadowMapSamplerDescriptorSets(){
     }
     
     // Update descriptor sets for each frame with frame-specific shadow maps
-    for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+    for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
         // Prepare image infos for directional lights - use frame-specific shadow maps
         std::vector<VkDescriptorImageInfo> directionalImageInfos;
         for (size_t lightIndex = 0; lightIndex < MAX_DIRECTIONAL_LIGHTS; lightIndex++) {
@@ -2191,7 +2438,7 @@ void RenderingResources::createShadowMapResources(){
 
     // Create shadow maps for directional lights - one per frame per light
     for (size_t lightIndex = 0; lightIndex < MAX_DIRECTIONAL_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             ShadowMap::ShadowMapCreateInfo createInfo{};
             createInfo.width = DIRECTIONAL_SHADOW_MAP_RES;
             createInfo.height = DIRECTIONAL_SHADOW_MAP_RES;
@@ -2203,7 +2450,7 @@ void RenderingResources::createShadowMapResources(){
 
     // Create shadow maps for spot lights - one per frame per light
     for (size_t lightIndex = 0; lightIndex < MAX_SPOT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             ShadowMap::ShadowMapCreateInfo createInfo{};
             createInfo.width = SPOT_SHADOW_MAP_RES;
             createInfo.height = SPOT_SHADOW_MAP_RES;
@@ -2215,7 +2462,7 @@ void RenderingResources::createShadowMapResources(){
 
      // Create shadow maps for point lights (cubemaps) - one per frame per light
     for (size_t lightIndex = 0; lightIndex < MAX_POINT_LIGHTS; lightIndex++) {
-        for (size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++) {
+        for (size_t frameIndex = 0; frameIndex < frameSlots; frameIndex++) {
             ShadowMap::ShadowMapCreateInfo createInfo{};
             createInfo.width = POINT_SHADOW_MAP_RES;
             createInfo.height = POINT_SHADOW_MAP_RES;
@@ -2228,7 +2475,7 @@ void RenderingResources::createShadowMapResources(){
 }
 
 void RenderingResources::createTransparencyResources(){
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
 
         VkImageCreateInfo accumulationImageInfo{};
         accumulationImageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -2245,27 +2492,8 @@ void RenderingResources::createTransparencyResources(){
         accumulationImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         accumulationImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        device.createImageWithInfo(
-            accumulationImageInfo,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            accumulationImages[i],
-            accumulationMemories[i]
-        );
-
-        VkImageViewCreateInfo accumulationViewInfo{};
-        accumulationViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        accumulationViewInfo.image = accumulationImages[i];
-        accumulationViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        accumulationViewInfo.format = hdrFormat;
-        accumulationViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        accumulationViewInfo.subresourceRange.baseMipLevel = 0;
-        accumulationViewInfo.subresourceRange.levelCount = 1;
-        accumulationViewInfo.subresourceRange.baseArrayLayer = 0;
-        accumulationViewInfo.subresourceRange.layerCount = 1;
-
-        if (vkCreateImageView(device.getDevice(), &accumulationViewInfo, nullptr, &accumulationViews[i]) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create accumulation image view!");
-        }
+        createTransientImage(accumulationImageInfo, TransientImages::ACCUMULATION, i,
+                             accumulationImages[i], accumulationViews[i], "Accumulation_Frame" + std::to_string(i));
 
 
         // Create revealage texture (R8)
@@ -2284,36 +2512,8 @@ void RenderingResources::createTransparencyResources(){
         revealageImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         revealageImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        device.createImageWithInfo(
-            revealageImageInfo,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            revealageImages[i],
-            revealageMemories[i]
-        );
-
-        VkImageViewCreateInfo revealageViewInfo{};
-        revealageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        revealageViewInfo.image = revealageImages[i];
-        revealageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        revealageViewInfo.format = revealageFormat;
-        revealageViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        revealageViewInfo.subresourceRange.baseMipLevel = 0;
-        revealageViewInfo.subresourceRange.levelCount = 1;
-        revealageViewInfo.subresourceRange.baseArrayLayer = 0;
-        revealageViewInfo.subresourceRange.layerCount = 1;
-
-        if (vkCreateImageView(device.getDevice(), &revealageViewInfo, nullptr, &revealageViews[i]) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create revealage image view!");
-        }
-
-        // Set debug names for transparency resources
-        setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)accumulationImages[i], "AccumulationImage_Frame" + std::to_string(i));
-        setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)accumulationViews[i], "AccumulationView_Frame" + std::to_string(i));
-        setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)accumulationMemories[i], "AccumulationMemory_Frame" + std::to_string(i));
-        
-        setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)revealageImages[i], "RevealageImage_Frame" + std::to_string(i));
-        setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)revealageViews[i], "RevealageView_Frame" + std::to_string(i));
-        setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)revealageMemories[i], "RevealageMemory_Frame" + std::to_string(i));
+        createTransientImage(revealageImageInfo, TransientImages::REVEALAGE, i,
+                             revealageImages[i], revealageViews[i], "Revealage_Frame" + std::to_string(i));
     }
 
 
@@ -2321,7 +2521,7 @@ void RenderingResources::createTransparencyResources(){
 
 void RenderingResources::createGIResources(){
     // Create per-frame GI indirect images and views
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -2367,9 +2567,8 @@ void RenderingResources::createGIResources(){
         setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)giIndirectMemories[i], "GIIndirectMemory_Frame" + std::to_string(i));
     }
 
-    // One-time init: transition GI images to GENERAL for compute writes
-    VkCommandBuffer cmd = device.beginSingleTimeCommands();
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    // GI images live in GENERAL for compute writes
+    for (size_t i = 0; i < frameSlots; ++i) {
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.srcAccessMask = 0;
@@ -2384,44 +2583,37 @@ void RenderingResources::createGIResources(){
         barrier.subresourceRange.levelCount = 1;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
-
-        vkCmdPipelineBarrier(
-            cmd,
-            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
+        pendingLayoutInits.push_back(barrier);
     }
-    device.endSingleTimeCommands(cmd);
 }
 
 void RenderingResources::createPostProcessResources() {
-    // Shared sampler for post-process textures (linear clamp)
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
-
-    if (vkCreateSampler(device.getDevice(), &samplerInfo, nullptr, &postProcessSampler) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create post-process sampler!");
-    }
-    setDebugName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)postProcessSampler, "PostProcessSampler");
-
-    auto makeColorImage = [&](VkFormat format, VkImage& image, VkDeviceMemory& memory, VkImageView& view, const std::string& name) {
+    // Shared sampler for post-process textures (linear clamp); kept across resizes
+    if (postProcessSampler == VK_NULL_HANDLE) {
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.anisotropyEnable = VK_FALSE;
+        samplerInfo.maxAnisotropy = 1.0f;
+        samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        samplerInfo.unnormalizedCoordinates = VK_FALSE;
+        samplerInfo.compareEnable = VK_FALSE;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = 0.0f;
+
+        if (vkCreateSampler(device.getDevice(), &samplerInfo, nullptr, &postProcessSampler) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create post-process sampler!");
+        }
+        setDebugName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)postProcessSampler, "PostProcessSampler");
+    }
+
+    auto makeColorImage = [&](VkFormat format, const char* graphName, size_t frame, VkImage& image, VkImageView& view,
+                              const std::string& name) {
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -2437,41 +2629,17 @@ void RenderingResources::createPostProcessResources() {
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        device.createImageWithInfo(
-            imageInfo,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            image,
-            memory
-        );
-
-        VkImageViewCreateInfo viewInfo{};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = image;
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = format;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-
-        if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create post-process image view: " + name);
-        }
-
-        setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)image, name + "_Image");
-        setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)view, name + "_View");
-        setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)memory, name + "_Memory");
+        createTransientImage(imageInfo, graphName, frame, image, view, name);
     };
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        makeColorImage(postProcessFormat, compositionColorImages[i], compositionColorMemories[i], compositionColorViews[i],
-                       "CompositionColor_Frame" + std::to_string(i));
-        makeColorImage(smaaEdgeFormat, smaaEdgeImages[i], smaaEdgeMemories[i], smaaEdgeViews[i],
+    for (size_t i = 0; i < frameSlots; ++i) {
+        makeColorImage(postProcessFormat, TransientImages::COMPOSITION_COLOR, i, compositionColorImages[i],
+                       compositionColorViews[i], "CompositionColor_Frame" + std::to_string(i));
+        makeColorImage(smaaEdgeFormat, TransientImages::SMAA_EDGE, i, smaaEdgeImages[i], smaaEdgeViews[i],
                        "SMAAEdge_Frame" + std::to_string(i));
-        makeColorImage(smaaBlendFormat, smaaBlendImages[i], smaaBlendMemories[i], smaaBlendViews[i],
+        makeColorImage(smaaBlendFormat, TransientImages::SMAA_BLEND, i, smaaBlendImages[i], smaaBlendViews[i],
                        "SMAABlend_Frame" + std::to_string(i));
-        makeColorImage(postProcessFormat, postAAColorImages[i], postAAColorMemories[i], postAAColorViews[i],
+        makeColorImage(postProcessFormat, TransientImages::POST_AA_COLOR, i, postAAColorImages[i], postAAColorViews[i],
                        "PostAAColor_Frame" + std::to_string(i));
     }
 }
@@ -2659,7 +2827,7 @@ void RenderingResources::createRCAtlases(){
         const uint32_t atlasWidth  = std::max(1u, probesX * tileSize);
         const uint32_t atlasHeight = std::max(1u, probesY * tileSize);
 
-        for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+        for (size_t frame = 0; frame < frameSlots; ++frame) {
             // Radiance atlas
             VkImageCreateInfo radInfo{};
             radInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -2676,77 +2844,96 @@ void RenderingResources::createRCAtlases(){
             radInfo.samples = VK_SAMPLE_COUNT_1_BIT;
             radInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-            device.createImageWithInfo(
-                radInfo,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                rcRadianceImages[cascade][frame],
-                rcRadianceMemories[cascade][frame]
-            );
-
-            VkImageViewCreateInfo radView{};
-            radView.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            radView.image = rcRadianceImages[cascade][frame];
-            radView.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            radView.format = VK_FORMAT_R16G16B16A16_SFLOAT;
-            radView.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            radView.subresourceRange.baseMipLevel = 0;
-            radView.subresourceRange.levelCount = 1;
-            radView.subresourceRange.baseArrayLayer = 0;
-            radView.subresourceRange.layerCount = 1;
-
-            if (vkCreateImageView(device.getDevice(), &radView, nullptr, &rcRadianceViews[cascade][frame]) != VK_SUCCESS) {
-                throw std::runtime_error("failed to create RC radiance atlas view");
-            }
-
-            // Set debug names
-            std::string cascadeFrameStr = "Cascade" + std::to_string(cascade) + "_Frame" + std::to_string(frame);
-            setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)rcRadianceImages[cascade][frame], "RCRadianceImage_" + cascadeFrameStr);
-            setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)rcRadianceViews[cascade][frame], "RCRadianceView_" + cascadeFrameStr);
-            setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)rcRadianceMemories[cascade][frame], "RCRadianceMemory_" + cascadeFrameStr);
+            // Every texel is rewritten by the build each frame, so the atlases are transients; the render graph
+            // moves them to GENERAL before the RC pass
+            createTransientImage(radInfo, TransientImages::RC_RADIANCE, frame, rcRadianceImages[cascade][frame],
+                                 rcRadianceViews[cascade][frame],
+                                 "RCRadiance_Cascade" + std::to_string(cascade) + "_Frame" + std::to_string(frame));
 
             std::cout << "RC atlas c=" << cascade << " f=" << frame
                       << " size=" << atlasWidth << "x" << atlasHeight
                       << " stridePx=" << stridePx << " tile=" << tileSize << std::endl;
         }
     }
+}
+
+void RenderingResources::createTransientImage(const VkImageCreateInfo& imageInfo, const char* graphName, size_t frame,
+                                              VkImage& image, VkImageView& view, const std::string& debugName) {
+    if (vkCreateImage(device.getDevice(), &imageInfo, nullptr, &image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create transient image: " + debugName);
+    }
+    setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)image, debugName + "_Image");
+    transientImages.push_back({graphName, frame, &image, &view, imageInfo.format, debugName});
+}
 
-    // One-time init: transition all RC atlas images to GENERAL for compute writes
-    VkCommandBuffer cmd = device.beginSingleTimeCommands();
-    for (uint32_t cascade = 0; cascade < RC_CASCADE_COUNT; ++cascade) {
-        for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
-            VkImageMemoryBarrier barrier{};
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.image = rcRadianceImages[cascade][frame];
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseMipLevel = 0;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
-
-            vkCmdPipelineBarrier(
-                cmd,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-            );
-        }
-    }
-    device.endSingleTimeCommands(cmd);
+void RenderingResources::allocateTransientMemory() {
+    // Every frame creates the same transients in the same order, so frame 0's requirements plan all of them
+    std::vector<RenderGraph::TransientRequest> requests;
+    for (const TransientImage& transient : transientImages) {
+        if (transient.frame != 0) {
+            continue;
+        }
+        const RenderGraph::ResourceHandle resource = renderGraph.findResource(transient.graphName);
+        if (resource == RenderGraph::INVALID_RESOURCE) {
+            throw std::runtime_error(std::string("render graph does not declare transient ") + transient.graphName);
+        }
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device.getDevice(), *transient.image, &requirements);
+        requests.push_back({resource, requirements});
+    }
+    const RenderGraph::TransientMemoryPlan plan = renderGraph.planTransientMemory(requests);
+
+    for (size_t frame = 0; frame < frameSlots; ++frame) {
+        for (size_t heap = 0; heap < plan.heapSizes.size(); ++heap) {
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = plan.heapSizes[heap];
+            allocInfo.memoryTypeIndex = device.findMemoryType(plan.heapMemoryTypeBits[heap], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+            VkDeviceMemory memory;
+            if (vkAllocateMemory(device.getDevice(), &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+                throw std::runtime_error("failed to allocate transient render target memory!");
+            }
+            transientHeaps[frame].push_back(memory);
+            setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)memory,
+                         "TransientHeap" + std::to_string(heap) + "_Frame" + std::to_string(frame));
+        }
+    }
+
+    std::array<size_t, MAX_FRAMES_IN_FLIGHT> requestIndex{};
+    for (const TransientImage& transient : transientImages) {
+        const RenderGraph::TransientPlacement& placement = plan.placements[requestIndex[transient.frame]++];
+        if (vkBindImageMemory(device.getDevice(), *transient.image, transientHeaps[transient.frame][placement.heap],
+                              placement.offset) != VK_SUCCESS) {
+            throw std::runtime_error("failed to bind transient image memory: " + transient.debugName);
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = *transient.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = transient.format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, transient.view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create transient image view: " + transient.debugName);
+        }
+        setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)*transient.view, transient.debugName + "_View");
+    }
+
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cout << "Transient render targets: " << plan.allocatedSize * mb << " MB per frame in "
+              << plan.heapSizes.size() << " heap(s) for " << requests.size() << " images, "
+              << renderGraph.getTransientMemorySaved() * mb << " MB saved by aliasing" << std::endl;
 }
 
 std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameContexts(){
     std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> contexts;
     
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < frameSlots; i++) {
         FrameContext& ctx = contexts[i];
         
         // Core frame data
@@ -2769,6 +2956,7 @@ std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameCo
         ctx.transparencyModelDescriptorSet = transparencyModelMatrixDescriptorSets[i];
         ctx.compositionDescriptorSet = compositionDescriptorSets[i];
         ctx.depthPyramidDescriptorSet = depthPyramidDescriptorSets[i];
+        ctx.depthBoundsDescriptorSet = depthBoundsDescriptorSets[i];
         ctx.rcBuildDescriptorSet = rcBuildDescriptorSets[i];
         ctx.rcResolveDescriptorSet = rcResolveDescriptorSets[i];
         ctx.smaaEdgeDescriptorSet = smaaEdgeDescriptorSets[i];
@@ -2781,12 +2969,18 @@ std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameCo
         ctx.modelMatrixBuffer = modelMatrixBuffers[i].get();
         ctx.normalMatrixBuffer = normalMatrixBuffers[i].get();
         ctx.lightArrayUniformBuffer = lightArrayUniformBuffers[i].get();
+        ctx.lightSlotBuffer = lightSlotBuffer.get();
+        ctx.lightSlotStagingBuffer = lightSlotStagingBuffers[i].get();
         ctx.cascadeSplitsBuffer = cascadeSplitsBuffers[i].get();
         ctx.sceneLightingBuffer = sceneLightingBuffers[i].get();
         ctx.lightMatrixBuffer = lightMatrixBuffers[i].get();
         ctx.shadowModelMatrixBuffer = shadowModelMatrixBuffers[i].get();
+        ctx.shadowFaceMaskBuffer = shadowFaceMaskBuffers[i].get();
+        ctx.depthBoundsBuffer = depthBoundsBuffers[i].get();
+        ctx.singlePassPointShadows = device.supportsMultiview();
         ctx.transparencyModelMatrixBuffer = transparencyModelMatrixBuffers[i].get();
         ctx.transparencyNormalMatrixBuffer = transparencyNormalMatrixBuffers[i].get();
+        ctx.renderingResources = this;
         
         // Depth resources
         ctx.depthView = depthViews[i];
@@ -2800,12 +2994,16 @@ std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameCo
         
         // Light pass resources
         ctx.lightPassResultView = lightPassResultViews[i];
+        ctx.lightPassResultImage = lightPassResultImages[i];
         ctx.lightPassSampler = lightPassSampler;  // Single sampler, not per frame
         ctx.lightIncidentView = lightIncidentViews[i];
+        ctx.lightIncidentImage = lightIncidentImages[i];
         
         // Transparency resources
         ctx.accumulationView = accumulationViews[i];
+        ctx.accumulationImage = accumulationImages[i];
         ctx.revealageView = revealageViews[i];
+        ctx.revealageImage = revealageImages[i];
         
         // GI indirect buffer
         ctx.giIndirectView = giIndirectViews[i];
@@ -2822,8 +3020,10 @@ std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameCo
         ctx.postAAColorImage = postAAColorImages[i];
 
         // GI history for temporal accumulation (previous frame's output)
-        uint32_t historyIndex = (i + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+        uint32_t historyIndex = static_cast<uint32_t>((i + frameSlots - 1) % frameSlots);
         ctx.giHistoryView = giIndirectViews[historyIndex];
+        ctx.giHistoryImage = giIndirectImages[historyIndex];
+        ctx.gBufferPositionHistoryImage = gBuffer->getPositionImage(historyIndex);
         ctx.giHistorySampler = lightPassSampler;
         
         // Initialize temporal frame index
@@ -2842,6 +3042,7 @@ std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> RenderingResources::createFrameCo
         // RC atlas views for this frame
         for (uint32_t cascade = 0; cascade < RC_CASCADE_COUNT; ++cascade) {
             ctx.rcRadianceViews[cascade] = rcRadianceViews[cascade][i];
+            ctx.rcRadianceImages[cascade] = rcRadianceImages[cascade][i];
         }
 
         // Shadow map references - now frame-specific shadow maps
@@ -2895,7 +3096,8 @@ void RenderingResources::initializeSkyboxFromScene() {
     } else {
         // Fallback to placeholder if no skybox texture is found
         std::cout << "No skybox texture found in scene, using placeholder..." << std::endl;
-        VkImageView placeholderView = gBuffer->getAlbedoView(0);
+        // Any view that lives as long as the set will do; window-sized images are replaced on resize
+        VkImageView placeholderView = smaaSearchView;
         VkSampler placeholderSampler = lightPassSampler;
         updateSkyboxDescriptorSet(placeholderView, placeholderSampler);
         std::cout << "Placeholder skybox created." << std::endl;
@@ -3,7 +3,6 @@
 // lib
 #include "core.hpp"
 #include "Rendering/Core/device.hpp"
-#include "Rendering/Core/swapchain.hpp"
 #include "Rendering/Core/buffer.hpp"
 #include "Rendering/Resources/gbuffer.hpp"
 #include "Rendering/Core/descriptors.hpp"
@@ -12,13 +11,29 @@
 #include "Rendering/RenderPasses/Shadowmapping/shadow_map.hpp"
 #include "Rendering/Resources/texture.hpp"
 #include "Rendering/Core/frame_context.hpp"
+#include "Rendering/Core/render_graph.hpp"
 
 namespace Rendering {
 
+    // Render graph names of the per-frame intermediates created as transients: their memory is shared with the
+    // ones the graph never needs at the same time. The renderer declares resources under these names
+    namespace TransientImages {
+        constexpr const char* LIGHT_PASS_RESULT = "LightPassResult";
+        constexpr const char* LIGHT_INCIDENT = "LightIncident";
+        constexpr const char* RC_RADIANCE = "RCRadiance";
+        constexpr const char* ACCUMULATION = "Accumulation";
+        constexpr const char* REVEALAGE = "Revealage";
+        constexpr const char* COMPOSITION_COLOR = "CompositionColor";
+        constexpr const char* SMAA_EDGE = "SMAAEdge";
+        constexpr const char* SMAA_BLEND = "SMAABlend";
+        constexpr const char* POST_AA_COLOR = "PostAAColor";
+    }
+
     // Central registry and lifetime owner of GPU resources
     class RenderingResources {
     public:
-        RenderingResources(Device& device, SwapChain& swapChain);
+        // renderGraph must be compiled; it places the transient images
+        RenderingResources(Device& device, VkExtent2D extent, RenderGraph& renderGraph);
         ~RenderingResources();
         
         // Non-copyable
@@ -26,6 +41,23 @@ namespace Rendering {
         RenderingResources& operator=(const RenderingResources&) = delete;
         
         void cleanup();
+
+        // Recreates every window-sized image at the new extent without waiting on the device: the old images go
+        // through the deletion queue and each frame slot's descriptor sets are rewritten by refreshDescriptorSets.
+        // Frame contexts must be rebuilt afterwards
+        void resize(VkExtent2D extent);
+        // Rewrites the slot's image descriptors if a resize replaced the images. Only valid once the last frame
+        // recorded with the slot has completed
+        void refreshDescriptorSets(uint32_t frameIndex);
+        // Grow the slot's instance buffers to hold at least instanceCount matrices and rewrite the descriptor sets
+        // that reference them; they never shrink. Same window as refreshDescriptorSets: the slot's last frame has
+        // completed and nothing has been recorded with it yet
+        void reserveOpaqueInstances(uint32_t frameIndex, uint32_t instanceCount);
+        void reserveTransparentInstances(uint32_t frameIndex, uint32_t instanceCount);
+        void reserveShadowInstances(uint32_t frameIndex, uint32_t instanceCount);
+        // Records the initial layouts of images created since the last call; the first frame after creation or a
+        // resize must call it before any pass touches them
+        void recordLayoutInits(VkCommandBuffer commandBuffer);
         
         // Accessor methods for formats and resources
         VkFormat getDepthFormat() const { return depthFormat; }
@@ -57,6 +89,7 @@ namespace Rendering {
         VkDescriptorSetLayout getRCBuildDescriptorSetLayout() const { return rcBuildSetLayout; }
         VkDescriptorSetLayout getRCResolveDescriptorSetLayout() const { return rcResolveSetLayout; }
         VkDescriptorSetLayout getDepthPyramidDescriptorSetLayout() const { return depthPyramidSetLayout; }
+        VkDescriptorSetLayout getDepthBoundsDescriptorSetLayout() const { return depthBoundsSetLayout; }
         // Post-processing layouts
         VkDescriptorSetLayout getSMAAEdgeSetLayout() const { return smaaEdgeSetLayout; }
         VkDescriptorSetLayout getSMAAWeightSetLayout() const { return smaaWeightSetLayout; }
@@ -93,7 +126,9 @@ namespace Rendering {
         void updateSkyboxDescriptorSet(VkImageView skyboxImageView, VkSampler skyboxSampler);
         void initializeSkyboxFromScene();
 
+        // The first getFrameSlotCount() entries are filled in
         std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> createFrameContexts();
+        uint32_t getFrameSlotCount() const { return frameSlots; }
     private:
         // Debug naming helper
         void setDebugName(VkObjectType objectType, uint64_t handle, const std::string& name);
@@ -107,6 +142,13 @@ namespace Rendering {
         void createBuffers();
         void createDescriptorSetLayouts();
         void createDescriptorSets();
+        void writeImageDescriptorSets(uint32_t frameIndex);
+        // Resizes and remaps buffer when it holds fewer than elementCount elements; returns whether it did
+        bool growBuffer(Buffer& buffer, VkDeviceSize elementSize, uint32_t elementCount);
+        // Largest mip count a pyramid can have on this device, which the per-mip descriptor sets are sized for
+        uint32_t maxDepthPyramidMipLevels() const;
+        // Hands every window-sized image, view and memory to the deletion queue and clears the handles
+        void retireSizedResources();
         void createShadowMapSamplerDescriptorSets();
         void createTransparencyResources();
         void createGIResources();
@@ -114,13 +156,30 @@ namespace Rendering {
         void createPostProcessResources();
         void loadSMAALUTTextures();
 
+        // Transient images are created without memory; allocateTransientMemory binds each frame's set into heaps
+        // laid out by the render graph and creates their views
+        struct TransientImage {
+            const char* graphName;
+            size_t frame;
+            VkImage* image;
+            VkImageView* view;
+            VkFormat format;
+            std::string debugName;
+        };
+        void createTransientImage(const VkImageCreateInfo& imageInfo, const char* graphName, size_t frame,
+                                  VkImage& image, VkImageView& view, const std::string& debugName);
+        void allocateTransientMemory();
 
 
         std::array<FrameContext,MAX_FRAMES_IN_FLIGHT> frameContexts;
 
 
         Device& device;
-        SwapChain& swapChain;
+        RenderGraph& renderGraph;
+        // Slots of the per-frame arrays in use, fixed for the lifetime of the resources
+        const uint32_t frameSlots;
+        std::vector<TransientImage> transientImages;
+        std::array<std::vector<VkDeviceMemory>, MAX_FRAMES_IN_FLIGHT> transientHeaps{};
         std::unique_ptr<GBuffer> gBuffer;
         uint32_t width;
         uint32_t height;
@@ -138,7 +197,6 @@ namespace Rendering {
         VkFormat smaaBlendFormat{VK_FORMAT_R8G8B8A8_UNORM};
         // Incident diffuse buffer (direct light, pre-albedo)
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> lightIncidentImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> lightIncidentMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> lightIncidentViews{};
 
         std::unique_ptr<DescriptorPool> descriptorPool{nullptr};
@@ -156,7 +214,6 @@ namespace Rendering {
         std::array<std::vector<VkDescriptorSet>, MAX_FRAMES_IN_FLIGHT> depthPyramidMipDescriptorSets{};
 
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> lightPassResultImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> lightPassResultMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> lightPassResultViews{};
         VkSampler lightPassSampler{VK_NULL_HANDLE};
         // Depth pyramid is used for ray-depth comparisons; it must be sampled with POINT/NEAREST filtering.
@@ -169,11 +226,9 @@ namespace Rendering {
         std::array<std::array<std::unique_ptr<ShadowMap>, MAX_FRAMES_IN_FLIGHT>, MAX_SPOT_LIGHTS> spotlightMaps;
 
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> accumulationImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> accumulationMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> accumulationViews{};
     
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> revealageImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> revealageMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> revealageViews{};
 
         // Indirect GI buffer (per-frame)
@@ -183,19 +238,15 @@ namespace Rendering {
 
         // Post-process render targets
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> compositionColorImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> compositionColorMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> compositionColorViews{};
 
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> smaaEdgeImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> smaaEdgeMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> smaaEdgeViews{};
 
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> smaaBlendImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> smaaBlendMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> smaaBlendViews{};
 
         std::array<VkImage, MAX_FRAMES_IN_FLIGHT> postAAColorImages{};
-        std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> postAAColorMemories{};
         std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> postAAColorViews{};
 
         // SMAA LUTs (shared) - manually managed for proper sampler/mip settings
@@ -211,7 +262,6 @@ namespace Rendering {
 
         // RC atlases per cascade (per frame)
         std::array<std::array<VkImage, MAX_FRAMES_IN_FLIGHT>, RC_CASCADE_COUNT> rcRadianceImages{};
-        std::array<std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT>, RC_CASCADE_COUNT> rcRadianceMemories{};
         std::array<std::array<VkImageView, MAX_FRAMES_IN_FLIGHT>, RC_CASCADE_COUNT> rcRadianceViews{};
 
         Texture* skyboxTexture{nullptr};
@@ -232,6 +282,7 @@ namespace Rendering {
         VkDescriptorSetLayout rcBuildSetLayout{VK_NULL_HANDLE};
         VkDescriptorSetLayout rcResolveSetLayout{VK_NULL_HANDLE};
         VkDescriptorSetLayout depthPyramidSetLayout{VK_NULL_HANDLE};
+        VkDescriptorSetLayout depthBoundsSetLayout{VK_NULL_HANDLE};
         VkDescriptorSetLayout smaaEdgeSetLayout{VK_NULL_HANDLE};
         VkDescriptorSetLayout smaaWeightSetLayout{VK_NULL_HANDLE};
         VkDescriptorSetLayout smaaBlendSetLayout{VK_NULL_HANDLE};
@@ -251,20 +302,29 @@ namespace Rendering {
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> rcBuildDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> rcResolveDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> depthPyramidDescriptorSets{};
+        std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> depthBoundsDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> smaaEdgeDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> smaaWeightDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> smaaBlendDescriptorSets{};
         std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> colorCorrectionDescriptorSets{};
         VkDescriptorSet skyboxDescriptorSet{VK_NULL_HANDLE};
+        // Slots whose image descriptors still point at images a resize replaced
+        std::array<bool, MAX_FRAMES_IN_FLIGHT> staleDescriptorSets{};
+        std::vector<VkImageMemoryBarrier> pendingLayoutInits;
 
         std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> modelMatrixBuffers{};
         std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> normalMatrixBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> cameraUniformBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> lightArrayUniformBuffers{};
+        // Persistent light slots live in one device-local buffer; each frame stages its dirty slots separately
+        std::unique_ptr<Buffer> lightSlotBuffer;
+        std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> lightSlotStagingBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> cascadeSplitsBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> sceneLightingBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> lightMatrixBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> shadowModelMatrixBuffers{};
+        std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> shadowFaceMaskBuffers{};
+        std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> depthBoundsBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> transparencyModelMatrixBuffers{};
         std::array<std::unique_ptr<Buffer>,MAX_FRAMES_IN_FLIGHT> transparencyNormalMatrixBuffers{};
     };
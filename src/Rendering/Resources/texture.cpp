@@ -1,7 +1,9 @@
 #include "texture.hpp"
 #include <stdexcept>
 #include "Rendering/Core/buffer.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 namespace Rendering {
 
@@ -65,12 +67,7 @@ void Texture::setDebugName(VkObjectType objectType, uint64_t handle, const std::
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 
 
-    device.createImageWithInfo(
-        imageInfo,
-        properties,
-        image,
-        imageMemory
-    );
+    acquireImage(imageInfo, properties);
 
     // Transition image layout for copy
     transitionImageLayout(
@@ -135,11 +132,155 @@ Texture::Texture(
         }
     }
 
+Texture::Texture(
+    Device& device,
+    UploadManager& uploadManager,
+    uint32_t width,
+    uint32_t height,
+    VkFormat format,
+    const void* data,
+    const std::string& debugName) : device{device}, imageFormat{format}, width{width}, height{height}, textureName{debugName} {
+
+    if (!supportsLinearBlit(format)) {
+        throw std::runtime_error("texture image format does not support linear blitting!");
+    }
+
+    // Calculate maximum number of mipmap levels
+    mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    VkDeviceSize imageSize = width * height * getFormatSize(format);
+
+    createUploadImage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
+    // Level 0 is copied on the transfer queue; blits are graphics-only, so the chain is built after the hand-off
+    UploadManager::StagingAllocation staging = uploadManager.stage(data, imageSize);
+    recordLayoutTransition(staging.transferCommands, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = staging.offset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {width, height, 1};
+    vkCmdCopyBufferToImage(staging.transferCommands, staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    handOffUpload(uploadManager, staging, 1, true);
+    recordMipmaps(staging.graphicsCommands, 1);
+    imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    createTextureImageView();
+    createTextureSampler();
+    setDebugNames();
+}
+
+Texture::Texture(
+    Device& device,
+    UploadManager& uploadManager,
+    uint32_t width,
+    uint32_t height,
+    VkFormat format,
+    uint32_t levelCount,
+    const void* data,
+    VkDeviceSize dataSize,
+    const std::vector<VkDeviceSize>& levelOffsets,
+    const std::string& debugName) : device{device}, imageFormat{format}, mipLevels{levelCount}, width{width}, height{height}, textureName{debugName} {
+
+    createUploadImage(VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+    // The whole chain is staged at once, one copy region per level
+    UploadManager::StagingAllocation staging = uploadManager.stage(data, dataSize);
+    recordLayoutTransition(staging.transferCommands, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    std::vector<VkBufferImageCopy> regions(mipLevels);
+    for (uint32_t level = 0; level < mipLevels; level++) {
+        VkBufferImageCopy& region = regions[level];
+        region = {};
+        region.bufferOffset = staging.offset + levelOffsets[level];
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {std::max(width >> level, 1u), std::max(height >> level, 1u), 1};
+    }
+    vkCmdCopyBufferToImage(
+        staging.transferCommands,
+        staging.buffer,
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<uint32_t>(regions.size()),
+        regions.data());
+
+    handOffUpload(uploadManager, staging, 1, false);
+    imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    createTextureImageView();
+    createTextureSampler();
+    setDebugNames();
+}
+
+void Texture::createUploadImage(VkImageUsageFlags usage) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {width, height, 1};
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = imageFormat;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    acquireImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void Texture::handOffUpload(UploadManager& uploadManager, const UploadManager::StagingAllocation& staging, uint32_t layerCount, bool mipsFollow) {
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = mipLevels;
+    range.baseArrayLayer = 0;
+    range.layerCount = layerCount;
+
+    // recordMipmaps expects every level still in TRANSFER_DST and moves them to SHADER_READ_ONLY itself
+    if (mipsFollow) {
+        uploadManager.handOffImage(
+            staging, image, range,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    } else {
+        uploadManager.handOffImage(
+            staging, image, range,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+}
+
+void Texture::setDebugNames() {
+    if (!textureName.empty()) {
+        setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)image, "TextureImage_" + textureName);
+        setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)imageView, "TextureView_" + textureName);
+        setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)imageMemory, "TextureMemory_" + textureName);
+        setDebugName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)sampler, "TextureSampler_" + textureName);
+    }
+}
+
 Texture::~Texture() {
     vkDestroySampler(device.getDevice(), sampler, nullptr);
     vkDestroyImageView(device.getDevice(), imageView, nullptr);
-    vkDestroyImage(device.getDevice(), image, nullptr);
-    vkFreeMemory(device.getDevice(), imageMemory, nullptr);
+    if (pooledImageInfo.sType == VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO) {
+        device.getResourcePool().releaseImage(pooledImageInfo, pooledMemoryProperties, image, imageMemory);
+    } else {
+        vkDestroyImage(device.getDevice(), image, nullptr);
+        vkFreeMemory(device.getDevice(), imageMemory, nullptr);
+    }
+}
+
+void Texture::acquireImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties) {
+    device.getResourcePool().acquireImage(imageInfo, properties, image, imageMemory);
+    pooledImageInfo = imageInfo;
+    pooledMemoryProperties = properties;
 }
 
 VkDescriptorImageInfo Texture::getDescriptorInfo() const {
@@ -201,6 +342,16 @@ void Texture::transitionImageLayout(
     uint32_t layerCount) {
     
     VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+    recordLayoutTransition(commandBuffer, vkImage, oldLayout, newLayout, layerCount);
+    device.endSingleTimeCommands(commandBuffer);
+}
+
+void Texture::recordLayoutTransition(
+    VkCommandBuffer commandBuffer,
+    VkImage vkImage,
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout,
+    uint32_t layerCount) {
 
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -241,80 +392,106 @@ void Texture::transitionImageLayout(
         0, nullptr,
         1, &barrier
     );
-
-    device.endSingleTimeCommands(commandBuffer);
 }
 
-void Texture::generateMipmaps() {
-    // Check if image format supports linear blitting
+bool Texture::supportsLinearBlit(VkFormat format) {
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(
         device.getPhysicalDevice(), 
-        imageFormat,
+        format,
         &formatProperties);
 
-    if (!(formatProperties.optimalTilingFeatures & 
-          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+}
+
+void Texture::generateMipmaps() {
+    // Check if image format supports linear blitting
+    if (!supportsLinearBlit(imageFormat)) {
         throw std::runtime_error("texture image format does not support linear blitting!");
     }
 
     VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+    recordMipmaps(commandBuffer, 1);
+    device.endSingleTimeCommands(commandBuffer);
+}
 
+void Texture::recordMipmaps(VkCommandBuffer commandBuffer, uint32_t layerCount) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = image;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
     barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
 
-    int32_t mipWidth = width;
-    int32_t mipHeight = height;
+    for (uint32_t layer = 0; layer < layerCount; layer++) {
+        barrier.subresourceRange.baseArrayLayer = layer;
 
-    for (uint32_t i = 1; i < mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        int32_t mipWidth = width;
+        int32_t mipHeight = height;
 
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier);
+        for (uint32_t i = 1; i < mipLevels; i++) {
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-        // Calculate next mip level size
-        int32_t nextMipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
-        int32_t nextMipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
-
-        VkImageBlit blit{};
-        blit.srcOffsets[0] = {0, 0, 0};
-        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        blit.dstOffsets[0] = {0, 0, 0};
-        blit.dstOffsets[1] = {nextMipWidth, nextMipHeight, 1};
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-
-        vkCmdBlitImage(
-            commandBuffer,
-            image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1, &blit,
-            VK_FILTER_LINEAR);
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
 
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            // Calculate next mip level size
+            int32_t nextMipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+            int32_t nextMipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = i - 1;
+            blit.srcSubresource.baseArrayLayer = layer;
+            blit.srcSubresource.layerCount = 1;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {nextMipWidth, nextMipHeight, 1};
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = i;
+            blit.dstSubresource.baseArrayLayer = layer;
+            blit.dstSubresource.layerCount = 1;
+
+            vkCmdBlitImage(
+                commandBuffer,
+                image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit,
+                VK_FILTER_LINEAR);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier);
+
+            // Update mip dimensions for next iteration
+            mipWidth = nextMipWidth;
+            mipHeight = nextMipHeight;
+        }
+
+        // Transition the last mip level of this layer
+        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
         vkCmdPipelineBarrier(
@@ -323,30 +500,12 @@ void Texture::generateMipmaps() {
             0, nullptr,
             0, nullptr,
             1, &barrier);
-
-        // Update mip dimensions for next iteration
-        mipWidth = nextMipWidth;
-        mipHeight = nextMipHeight;
     }
-
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier);
-
-    device.endSingleTimeCommands(commandBuffer);
 }
 
 std::unique_ptr<Texture> Texture::createCubemap(
     Device& device,
+    UploadManager& uploadManager,
     uint32_t size,
     VkFormat format,
     const std::vector<const void*>& faceData)
@@ -361,24 +520,11 @@ std::unique_ptr<Texture> Texture::createCubemap(
     // Calculate buffer sizes
     VkDeviceSize faceSize = size * size * getFormatSize(format);
     VkDeviceSize totalSize = faceSize * 6;
-    
-    // Create single staging buffer for all faces
-    Buffer stagingBuffer{
-        device,
-        totalSize,
-        1,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    };
 
-    // Copy all face data into staging buffer
-    stagingBuffer.map();
-    for (int i = 0; i < 6; i++) {
-        stagingBuffer.writeToBuffer(
-            faceData[i],
-            faceSize,  // size per face
-            i * faceSize  // offset for each face
-        );
+    // If mipmap generation isn't supported, fall back to just one level
+    bool generateMips = texture->supportsLinearBlit(format);
+    if (!generateMips) {
+        texture->mipLevels = 1;
     }
 
     // Create image for cubemap
@@ -396,15 +542,17 @@ std::unique_ptr<Texture> Texture::createCubemap(
     imageInfo.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    device.createImageWithInfo(
-        imageInfo,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        texture->image,
-        texture->imageMemory
-    );
+    texture->acquireImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // All faces go into one staging allocation, filled in place
+    UploadManager::StagingAllocation staging = uploadManager.stage(nullptr, totalSize);
+    for (int i = 0; i < 6; i++) {
+        std::memcpy(static_cast<char*>(staging.mapped) + i * faceSize, faceData[i], static_cast<size_t>(faceSize));
+    }
 
     // Transition image layout for copy
-    texture->transitionImageLayout(
+    texture->recordLayoutTransition(
+        staging.transferCommands,
         texture->image,
         VK_IMAGE_LAYOUT_UNDEFINED,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -414,7 +562,7 @@ std::unique_ptr<Texture> Texture::createCubemap(
     // Copy buffer to image
     VkBufferImageCopy regions[6];
     for (uint32_t face = 0; face < 6; face++) {
-        regions[face].bufferOffset = face * faceSize;
+        regions[face].bufferOffset = staging.offset + face * faceSize;
         regions[face].bufferRowLength = 0;
         regions[face].bufferImageHeight = 0;
         regions[face].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -426,140 +574,104 @@ std::unique_ptr<Texture> Texture::createCubemap(
     }
 
     // Copy all faces at once
-    VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
     vkCmdCopyBufferToImage(
-        commandBuffer,
-        stagingBuffer.getBuffer(),
+        staging.transferCommands,
+        staging.buffer,
         texture->image,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         6,
         regions
     );
-    device.endSingleTimeCommands(commandBuffer);
 
-    // For cubemaps, we need to generate mipmaps for each face
-    // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(
-        device.getPhysicalDevice(), 
-        format,
-        &formatProperties);
+    texture->handOffUpload(uploadManager, staging, 6, generateMips);
+    if (generateMips) {
+        // Generate mipmaps for each face, leaving every level in SHADER_READ_ONLY_OPTIMAL
+        texture->recordMipmaps(staging.graphicsCommands, 6);
+    }
+    texture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    if (!(formatProperties.optimalTilingFeatures & 
-          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-        // If mipmap generation isn't supported, fall back to just one level
-        texture->mipLevels = 1;
-        
-        // Transition to shader read layout
-        texture->transitionImageLayout(
-            texture->image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-            6  // layerCount
-        );
-    } else {
-        
-        // Generate mipmaps for each face
-        commandBuffer = device.beginSingleTimeCommands();
-
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.image = texture->image;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.layerCount = 1;
-
-        for (uint32_t face = 0; face < 6; face++) {
-            // Set the layer for this face
-            barrier.subresourceRange.baseArrayLayer = face;
-            
-            int32_t mipWidth = size;
-            int32_t mipHeight = size;
-
-            for (uint32_t i = 1; i < texture->mipLevels; i++) {
-                barrier.subresourceRange.baseMipLevel = i - 1;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-                vkCmdPipelineBarrier(
-                    commandBuffer,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-                    0, nullptr,
-                    0, nullptr,
-                    1, &barrier);
-
-                // Calculate next mip level size
-                int32_t nextMipWidth = mipWidth > 1 ? mipWidth / 2 : 1;
-                int32_t nextMipHeight = mipHeight > 1 ? mipHeight / 2 : 1;
-
-                VkImageBlit blit{};
-                blit.srcOffsets[0] = {0, 0, 0};
-                blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-                blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                blit.srcSubresource.mipLevel = i - 1;
-                blit.srcSubresource.baseArrayLayer = face;
-                blit.srcSubresource.layerCount = 1;
-                blit.dstOffsets[0] = {0, 0, 0};
-                blit.dstOffsets[1] = {nextMipWidth, nextMipHeight, 1};
-                blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                blit.dstSubresource.mipLevel = i;
-                blit.dstSubresource.baseArrayLayer = face;
-                blit.dstSubresource.layerCount = 1;
-
-                vkCmdBlitImage(
-                    commandBuffer,
-                    texture->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                    texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    1, &blit,
-                    VK_FILTER_LINEAR);
-
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-                vkCmdPipelineBarrier(
-                    commandBuffer,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-                    0, nullptr,
-                    0, nullptr,
-                    1, &barrier);
-
-                // Update mip dimensions for next iteration
-                mipWidth = nextMipWidth;
-                mipHeight = nextMipHeight;
-            }
-
-            // Transition the last mip level for this face
-            barrier.subresourceRange.baseMipLevel = texture->mipLevels - 1;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    // Create cubemap view and sampler
+    texture->createCubemapView();
+    texture->createCubemapSampler();
+    
+    // Set debug names for cubemap
+    texture->textureName = "Cubemap";
+    texture->setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)texture->image, "CubemapImage");
+    texture->setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)texture->imageView, "CubemapView");
+    texture->setDebugName(VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)texture->imageMemory, "CubemapMemory");
+    texture->setDebugName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)texture->sampler, "CubemapSampler");
 
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier);
-        }
+    return texture;
+}
+
+std::unique_ptr<Texture> Texture::createCubemap(
+    Device& device,
+    UploadManager& uploadManager,
+    uint32_t size,
+    VkFormat format,
+    uint32_t levelCount,
+    const void* data,
+    VkDeviceSize dataSize,
+    const std::vector<VkDeviceSize>& levelOffsets)
+{
+    std::unique_ptr<Texture> texture(new Texture(device));
+    texture->imageFormat = format;
+    texture->width = size;
+    texture->height = size;
+    texture->mipLevels = levelCount;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent = {size, size, 1};
+    imageInfo.mipLevels = levelCount;
+    imageInfo.arrayLayers = 6;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        device.endSingleTimeCommands(commandBuffer);
+    texture->acquireImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        // After generating mipmaps, we need to record that all mip levels are now in SHADER_READ_ONLY_OPTIMAL layout
-        texture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    UploadManager::StagingAllocation staging = uploadManager.stage(data, dataSize);
+    texture->recordLayoutTransition(
+        staging.transferCommands,
+        texture->image,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        6
+    );
+
+    // One region per level covers all six faces, they are tightly packed one after another
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        VkBufferImageCopy& region = regions[level];
+        region = {};
+        region.bufferOffset = staging.offset + levelOffsets[level];
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 6;
+        region.imageExtent = {std::max(size >> level, 1u), std::max(size >> level, 1u), 1};
     }
+    vkCmdCopyBufferToImage(
+        staging.transferCommands,
+        staging.buffer,
+        texture->image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<uint32_t>(regions.size()),
+        regions.data()
+    );
+
+    texture->handOffUpload(uploadManager, staging, 6, false);
+    texture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    // Create cubemap view and sampler
     texture->createCubemapView();
     texture->createCubemapSampler();
-    
-    // Set debug names for cubemap
+
     texture->textureName = "Cubemap";
     texture->setDebugName(VK_OBJECT_TYPE_IMAGE, (uint64_t)texture->image, "CubemapImage");
     texture->setDebugName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)texture->imageView, "CubemapView");
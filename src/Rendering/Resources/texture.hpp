@@ -2,6 +2,7 @@
 
 #include "Rendering/Core/device.hpp"
 #include "Rendering/Core/buffer.hpp"
+#include "Rendering/Core/upload_manager.hpp"
 #include <memory>
 namespace Rendering {
 
@@ -19,6 +20,27 @@ public:
         const void* data,
         uint32_t faces = 1,
         const std::string& debugName = "");
+    // Decoded RGBA pixels recorded into the shared upload manager; the mip chain is blitted on the GPU
+    Texture(
+        Device& device,
+        UploadManager& uploadManager,
+        uint32_t width,
+        uint32_t height,
+        VkFormat format,
+        const void* data,
+        const std::string& debugName = "");
+    // Prebuilt mip chain (e.g. transcoded KTX2) in one blob, levelOffsets[level] points at each level
+    Texture(
+        Device& device,
+        UploadManager& uploadManager,
+        uint32_t width,
+        uint32_t height,
+        VkFormat format,
+        uint32_t levelCount,
+        const void* data,
+        VkDeviceSize dataSize,
+        const std::vector<VkDeviceSize>& levelOffsets,
+        const std::string& debugName = "");
     ~Texture();
 
     // Delete copy constructors
@@ -37,9 +59,22 @@ public:
     
     static std::unique_ptr<Texture> createCubemap(
         Device& device,
+        UploadManager& uploadManager,
         uint32_t size,  // cubemap faces are square
         VkFormat format,
-        const std::vector<const void*>& faceData  // array of 6 face data pointers  
+        const std::vector<const void*>& faceData  // array of 6 face data pointers
+    );
+    // Prebuilt chain (e.g. a prefiltered environment) in one blob, levelOffsets[level] points at the level's six
+    // faces stored back to back
+    static std::unique_ptr<Texture> createCubemap(
+        Device& device,
+        UploadManager& uploadManager,
+        uint32_t size,
+        VkFormat format,
+        uint32_t levelCount,
+        const void* data,
+        VkDeviceSize dataSize,
+        const std::vector<VkDeviceSize>& levelOffsets
     );
 
     Texture(
@@ -68,8 +103,18 @@ private:
     
     void createTextureImageView();
     void createTextureSampler();
+    void createUploadImage(VkImageUsageFlags usage);
+    // Takes the image from the device's resource pool; the destructor hands it back
+    void acquireImage(const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags properties);
+    void setDebugNames();
     void transitionImageLayout(VkImage vkImage,VkImageLayout oldLayout,VkImageLayout newLayout,uint32_t layerCount = 1);
+    void recordLayoutTransition(VkCommandBuffer commandBuffer,VkImage vkImage,VkImageLayout oldLayout,VkImageLayout newLayout,uint32_t layerCount = 1);
     void generateMipmaps();
+    // Blits every layer's chain from level 0 and leaves all levels in SHADER_READ_ONLY_OPTIMAL
+    void recordMipmaps(VkCommandBuffer commandBuffer, uint32_t layerCount);
+    // Moves a freshly copied image from the upload's transfer commands to its graphics commands
+    void handOffUpload(UploadManager& uploadManager, const UploadManager::StagingAllocation& staging, uint32_t layerCount, bool mipsFollow);
+    bool supportsLinearBlit(VkFormat format);
     static uint32_t getFormatSize(VkFormat format);
     
     void createCubemapView();
@@ -81,6 +126,9 @@ private:
     VkImage image{VK_NULL_HANDLE};
     VkDeviceMemory imageMemory{VK_NULL_HANDLE};
     VkImageView imageView{VK_NULL_HANDLE};
+    // Set when the image came from the resource pool; adopted images are destroyed outright
+    VkImageCreateInfo pooledImageInfo{};
+    VkMemoryPropertyFlags pooledMemoryProperties{0};
     VkSampler sampler{VK_NULL_HANDLE};
     
     VkFormat imageFormat;
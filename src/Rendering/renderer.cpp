@@ -2,8 +2,12 @@ class AlphaEngine;
 
 #include "renderer.hpp"
 #include "Engine/alpha_engine.hpp"
+#include "Resources/texture_streamer.hpp"
+#include "Scene/scene.hpp"
 #include <iostream>
 #include <array>
+#include <algorithm>
+#include <chrono>
 
 
 using namespace ECS;
@@ -12,24 +16,53 @@ namespace Rendering {
 
     Renderer::Renderer(Window& window, Device& device) 
         : window{window}, device{device} {
+        if (device.hasAsyncComputeQueue() && device.supportsTimelineSemaphores()) {
+            asyncCompute = std::make_unique<AsyncCompute>(device);
+        }
+        setRecordingThreads(PARALLEL_RECORDING_THREADS);
         recreateSwapChain();
+        buildRenderGraph();
+        createRenderingResources();
         recreateWindowDependentResources();
         createCommandBuffers();
         
-        // Initialize ImGui after swap chain and command buffers are ready
-        imguiManager = std::make_unique<ImGuiManager>(
-            device, 
-            window, 
-            *swapChain, 
-            static_cast<uint32_t>(swapChain->imageCount())
-        );
+        // Initialize ImGui after swap chain and command buffers are ready; headless runs have no overlay
+        if (!window.isHeadless()) {
+            imguiManager = std::make_unique<ImGuiManager>(
+                device, 
+                window, 
+                *swapChain, 
+                static_cast<uint32_t>(swapChain->imageCount())
+            );
+        }
+
+        if (GPU_PROFILER_ENABLED) {
+            gpuProfiler = std::make_unique<GpuProfiler>(device);
+            if (!gpuProfiler->isSupported()) {
+                gpuProfiler.reset();
+            }
+            if (imguiManager) {
+                imguiManager->setGpuProfiler(gpuProfiler.get());
+            }
+        }
     }
 
     Renderer::~Renderer() {
+        if (GPU_PROFILER_EXPORT_ON_EXIT && gpuProfiler) {
+            gpuProfiler->exportCapture();
+        }
         // Cleanup ImGui first
         imguiManager.reset();
         
+        // Everything retired during the last frames goes before the objects it may reference
+        vkDeviceWaitIdle(device.getDevice());
+        device.getDeletionQueue().flush();
+
+        destroyPasses();
+        renderingResources.reset();
         cleanupWindowDependentResources();
+        parallelRecorder.reset();
+        asyncCompute.reset();
         freeCommandBuffers();
         swapChain.reset();
     }
@@ -45,19 +78,23 @@ namespace Rendering {
                 return;
             }
         }
-        
-        vkDeviceWaitIdle(device.getDevice());
 
         if (swapChain == nullptr) {
             swapChain = std::make_shared<SwapChain>(device, extent);
         } else {
             std::shared_ptr<SwapChain> oldSwapChain = std::move(swapChain);
             swapChain = std::make_shared<SwapChain>(device, extent, oldSwapChain);
+            // Frames in flight may still render into and present the old images
+            device.getDeletionQueue().push([retired = std::move(oldSwapChain)]() mutable { retired.reset(); });
         }
     }
 
     void Renderer::cleanupWindowDependentResources() {
         if (gBuffer) gBuffer.reset();
+        if (renderGraph) renderGraph.reset();
+    }
+
+    void Renderer::destroyPasses() {
         if (geometryPass) geometryPass.reset();
         if (skyboxPass) skyboxPass.reset();
         if (transparencyPass) transparencyPass.reset();
@@ -72,7 +109,7 @@ namespace Rendering {
     }
 
     void Renderer::recreateWindowDependentResources() {
-        createRenderingResources();
+        // First call creates the passes, later ones only retarget their framebuffers and dispatch sizes
         createGeometryPass();          
         createShadowPass();
         createSkyboxPass();
@@ -90,13 +127,10 @@ namespace Rendering {
             framebufferResized = false;
             return;
         }
-        
-        vkDeviceWaitIdle(device.getDevice());
-        
-        // First clean up resources that depend on the swapchain
-        cleanupWindowDependentResources();
-        
-        // Then recreate the swapchain
+        CPU_PROFILE_ZONE("Renderer::handleWindowResize");
+
+        // No device idle: the pipelines, render passes and render graph stay, and the window-sized images and
+        // framebuffers being replaced are released by the deletion queue once the frames using them are done
         recreateSwapChain();
         
         // Check if swapchain was created successfully (might be null if window closed)
@@ -105,18 +139,21 @@ namespace Rendering {
             return;
         }
         
-        // Finally recreate all the dependent resources with the new dimensions
+        renderingResources->resize(swapChain->getExtent());
+        frameContexts = renderingResources->createFrameContexts();
         recreateWindowDependentResources();
         
         // Notify ImGui about the resize
-        imguiManager->onWindowResize(*swapChain);
+        if (imguiManager) {
+            imguiManager->onWindowResize(*swapChain);
+        }
 
         
         framebufferResized = false;
     }
 
     void Renderer::createCommandBuffers() {
-        commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+        commandBuffers.resize(device.getFrameSlotCount());
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -140,6 +177,7 @@ namespace Rendering {
 
     VkCommandBuffer Renderer::beginFrame() {
         assert(!isFrameStarted && "Can't call beginFrame while frame is already in progress");
+        CPU_PROFILE_ZONE("Renderer::beginFrame");
 
         // Skip if window is minimized
         if (window.isMinimized() || window.getExtent().width == 0 || window.getExtent().height == 0) {
@@ -164,6 +202,16 @@ namespace Rendering {
             throw std::runtime_error("failed to acquire swap chain image!");
         }
 
+        // The acquire waited for the fence of the frame submitted framesInFlight ago
+        DeletionQueue& deletionQueue = device.getDeletionQueue();
+        const uint64_t frameNumber = deletionQueue.getFrameNumber();
+        const uint32_t framesInFlight = device.getFramesInFlight();
+        if (frameNumber + 1 >= framesInFlight) {
+            deletionQueue.collect(frameNumber + 1 - framesInFlight);
+        }
+        // Idle pooled objects nobody asked for in a while are freed
+        device.getResourcePool().trim();
+
         isFrameStarted = true;
         
         auto commandBuffer = getCurrentCommandBuffer();
@@ -179,20 +227,38 @@ namespace Rendering {
 
     void Renderer::endFrame() {
         assert(isFrameStarted && "Can't call endFrame while frame is not in progress");
+        CPU_PROFILE_ZONE("Renderer::endFrame");
         
         // Safety check: if window became minimized during frame, skip presentation
         if (window.isMinimized() || swapChain == nullptr) {
             isFrameStarted = false;
+            asyncCommandBuffers = nullptr;
             return;
         }
         
-        auto commandBuffer = getCurrentCommandBuffer();
+        // With async compute the graph left the frame's tail in the join command buffer
+        auto commandBuffer = asyncCommandBuffers ? asyncCommandBuffers->join : getCurrentCommandBuffer();
+        if (gpuProfiler) {
+            gpuProfiler->endFrame(commandBuffer);
+        }
         
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
             throw std::runtime_error("failed to record command buffer!");
         }
 
-        auto result = swapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
+        SwapChain::SemaphoreWait computeWait{};
+        if (asyncCommandBuffers) {
+            computeWait = asyncCompute->submit(getCurrentCommandBuffer());
+            asyncCommandBuffers = nullptr;
+        }
+        auto result = swapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex,
+                                                      computeWait.semaphore ? &computeWait : nullptr);
+        // Counted before a resize below retires anything, which this frame may still use
+        device.getDeletionQueue().endFrame();
+        if (gpuProfiler) {
+            gpuProfiler->markSubmitted();
+        }
+        lastSubmittedImage = static_cast<int32_t>(currentImageIndex);
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || 
             window.wasWindowResized()) {
             window.resetWindowResizedFlag();
@@ -202,7 +268,7 @@ namespace Rendering {
         }
 
         isFrameStarted = false;
-        currentFrameIndex = (currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+        currentFrameIndex = (currentFrameIndex + 1) % commandBuffers.size();
     }
 
     void Renderer::createShadowPass(){     
@@ -213,6 +279,10 @@ namespace Rendering {
         createInfo.directionalShadowMaps = &renderingResources->getDirectionalLightMaps();
         createInfo.pointShadowMaps = &renderingResources->getPointLightMaps();
         createInfo.spotShadowMaps = &renderingResources->getSpotLightMaps();
+        // Shadow maps do not follow the window, so a resize leaves the pass as it is
+        if (shadowmapPass) {
+            return;
+        }
         shadowmapPass = std::make_unique<ShadowPass>(device,createInfo);
     }
 
@@ -230,6 +300,10 @@ namespace Rendering {
         createInfo.cameraDescriptorSetLayout=renderingResources->getCameraDescriptorSetLayout();
         createInfo.modelsDescriptorSetLayout=renderingResources->getModelsDescriptorSetLayout();
         createInfo.materialDescriptorSetLayout=renderingResources->getMaterialDescriptorSetLayout();
+        if (geometryPass) {
+            geometryPass->resize(createInfo);
+            return;
+        }
         geometryPass=std::make_unique<GeometryPass>(device,createInfo);
     }
 
@@ -242,6 +316,10 @@ namespace Rendering {
         createInfo.albedoFormat = renderingResources->getAlbedoFormat();
         createInfo.albedoViewsPtr = &renderingResources->getAlbedoViews();
         createInfo.depthViewsPtr = &renderingResources->getDepthViews();
+        if (skyboxPass) {
+            skyboxPass->resize(createInfo);
+            return;
+        }
         skyboxPass = std::make_unique<SkyboxPass>(device, createInfo);
     }
 
@@ -263,9 +341,12 @@ namespace Rendering {
         createInfo.lightPassResultViewsPtr = &renderingResources->getLightPassResultViews();
         createInfo.lightIncidentViewsPtr = &renderingResources->getLightIncidentViews();
         
+        if (lightPass) {
+            lightPass->resize(createInfo);
+            return;
+        }
         lightPass=std::make_unique<LightPass>(
             device,
-            *swapChain,
             createInfo);
     }
 
@@ -275,14 +356,207 @@ namespace Rendering {
         createInfo.height = swapChain->getExtent().height;
         createInfo.depthPyramidSetLayout = renderingResources->getDepthPyramidDescriptorSetLayout();
         createInfo.depthPyramidFormat = renderingResources->getDepthPyramidFormat();
+        createInfo.depthBoundsSetLayout = renderingResources->getDepthBoundsDescriptorSetLayout();
         createInfo.rcBuildSetLayout = renderingResources->getRCBuildDescriptorSetLayout();
         createInfo.rcResolveSetLayout = renderingResources->getRCResolveDescriptorSetLayout();
         createInfo.skyboxSetLayout = renderingResources->getSkyboxDescriptorSetLayout();
+        if (rcgiPass) {
+            rcgiPass->resize(createInfo);
+            return;
+        }
         rcgiPass = std::make_unique<RCGIPass>(device, createInfo);
     }
 
+    void Renderer::buildRenderGraph() {
+        // Declares what every pass reads and writes; the graph derives the barriers between them. Transient
+        // images only live between their first and last pass and are given memory by RenderingResources
+        renderGraph = std::make_unique<RenderGraph>();
+        RenderGraph& graph = *renderGraph;
+        graph.setAsyncCompute(asyncCompute != nullptr);
+        GraphResources& r = graphResources;
+
+        RenderGraph::ImageDesc depthDesc{};
+        depthDesc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        depthDesc.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        r.depth = graph.importImage("Depth", depthDesc);
+
+        RenderGraph::ImageDesc sampledDesc{};
+        sampledDesc.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        r.depthPyramid = graph.importImage("DepthPyramid", sampledDesc);
+        r.gBufferPosition = graph.importImage("GBufferPosition", sampledDesc);
+        r.gBufferNormal = graph.importImage("GBufferNormal", sampledDesc);
+        r.gBufferAlbedo = graph.importImage("GBufferAlbedo", sampledDesc);
+        r.gBufferMaterial = graph.importImage("GBufferMaterial", sampledDesc);
+
+        // Written by the previous frame's context, which this frame's submission follows
+        RenderGraph::ImageDesc positionHistoryDesc = sampledDesc;
+        positionHistoryDesc.initialStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        positionHistoryDesc.initialAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        r.gBufferPositionHistory = graph.importImage("GBufferPositionHistory", positionHistoryDesc);
+
+        RenderGraph::ImageDesc shadowDesc = sampledDesc;
+        shadowDesc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        r.shadowMaps = graph.importImage("ShadowMaps", shadowDesc);
+
+        RenderGraph::ImageDesc giDesc{};
+        giDesc.initialLayout = VK_IMAGE_LAYOUT_GENERAL;
+        r.giIndirect = graph.importImage("GiIndirect", giDesc);
+        RenderGraph::ImageDesc giHistoryDesc = giDesc;
+        giHistoryDesc.initialStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        giHistoryDesc.initialAccess = VK_ACCESS_SHADER_WRITE_BIT;
+        r.giHistory = graph.importImage("GiHistory", giHistoryDesc);
+
+        r.swapchain = graph.importImage("Swapchain", RenderGraph::ImageDesc{});
+
+        r.lightPassResult = graph.createTransientImage(TransientImages::LIGHT_PASS_RESULT);
+        r.lightIncident = graph.createTransientImage(TransientImages::LIGHT_INCIDENT);
+        r.rcRadiance = graph.createTransientImage(TransientImages::RC_RADIANCE);
+        r.accumulation = graph.createTransientImage(TransientImages::ACCUMULATION);
+        r.revealage = graph.createTransientImage(TransientImages::REVEALAGE);
+        r.compositionColor = graph.createTransientImage(TransientImages::COMPOSITION_COLOR);
+        r.smaaEdge = graph.createTransientImage(TransientImages::SMAA_EDGE);
+        r.smaaBlend = graph.createTransientImage(TransientImages::SMAA_BLEND);
+        r.postAAColor = graph.createTransientImage(TransientImages::POST_AA_COLOR);
+
+        const VkPipelineStageFlags fragment = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        const VkPipelineStageFlags compute = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        const VkImageLayout readOnly = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        const VkImageLayout depthReadOnly = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+        graph.addPass("Shadows", [this](FrameContext& fc) { runPass("Shadows", *shadowmapPass, fc); })
+            .write(r.shadowMaps, RenderGraph::depthTarget(readOnly));
+
+        graph.addPass("Geometry", [this](FrameContext& fc) { runPass("Geometry", *geometryPass, fc); })
+            .write(r.depth, RenderGraph::depthTarget(depthReadOnly))
+            .write(r.gBufferPosition, RenderGraph::colorTarget(readOnly))
+            .write(r.gBufferNormal, RenderGraph::colorTarget(readOnly))
+            .write(r.gBufferAlbedo, RenderGraph::colorTarget(readOnly))
+            .write(r.gBufferMaterial, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("Skybox", [this](FrameContext& fc) { runPass("Skybox", *skyboxPass, fc); })
+            .read(r.depth, RenderGraph::depthTest())
+            .write(r.gBufferAlbedo, RenderGraph::colorTargetLoad(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, readOnly));
+
+        graph.addPass("Direct lighting", [this](FrameContext& fc) { runPass("Direct lighting", *lightPass, fc); })
+            .read(r.depth, RenderGraph::sampled(fragment, depthReadOnly))
+            .read(r.gBufferPosition, RenderGraph::sampled(fragment))
+            .read(r.gBufferNormal, RenderGraph::sampled(fragment))
+            .read(r.gBufferAlbedo, RenderGraph::sampled(fragment))
+            .read(r.gBufferMaterial, RenderGraph::sampled(fragment))
+            .read(r.shadowMaps, RenderGraph::sampled(fragment))
+            .write(r.lightPassResult, RenderGraph::colorTarget(readOnly))
+            .write(r.lightIncident, RenderGraph::colorTarget(readOnly));
+
+        // The depth bounds readback feeds next frame's cascade fit, so the pass always runs. With a second queue it
+        // runs there, overlapping transparency and the next frame's shadows
+        graph.addPass("RC GI", [this](FrameContext& fc) { runPass("RC GI", *rcgiPass, fc); })
+            .asyncCompute()
+            .read(r.depth, RenderGraph::sampled(compute, depthReadOnly))
+            .read(r.gBufferPosition, RenderGraph::sampled(compute))
+            .read(r.gBufferNormal, RenderGraph::sampled(compute))
+            .read(r.gBufferAlbedo, RenderGraph::sampled(compute))
+            .read(r.gBufferMaterial, RenderGraph::sampled(compute))
+            .read(r.gBufferPositionHistory, RenderGraph::sampled(compute))
+            .read(r.lightIncident, RenderGraph::sampled(compute))
+            .read(r.giHistory, RenderGraph::sampled(compute, VK_IMAGE_LAYOUT_GENERAL))
+            .write(r.depthPyramid, RenderGraph::storage(compute, readOnly))
+            .write(r.rcRadiance, RenderGraph::storage(compute))
+            .write(r.giIndirect, RenderGraph::storage(compute))
+            .sideEffects();
+
+        graph.addPass("Transparency", [this](FrameContext& fc) { runPass("Transparency", *transparencyPass, fc); })
+            .read(r.depth, RenderGraph::depthTest())
+            .read(r.shadowMaps, RenderGraph::sampled(fragment))
+            .write(r.accumulation, RenderGraph::colorTarget(readOnly))
+            .write(r.revealage, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("Composition", [this](FrameContext& fc) { runPass("Composition", *compositionPass, fc); })
+            .read(r.lightPassResult, RenderGraph::sampled(fragment))
+            .read(r.accumulation, RenderGraph::sampled(fragment))
+            .read(r.revealage, RenderGraph::sampled(fragment))
+            .read(r.giIndirect, RenderGraph::sampled(fragment, VK_IMAGE_LAYOUT_GENERAL))
+            .write(r.compositionColor, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("SMAA edges", [this](FrameContext& fc) { runPass("SMAA edges", *smaaEdgePass, fc); })
+            .read(r.compositionColor, RenderGraph::sampled(fragment))
+            .write(r.smaaEdge, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("SMAA weights", [this](FrameContext& fc) { runPass("SMAA weights", *smaaWeightPass, fc); })
+            .read(r.smaaEdge, RenderGraph::sampled(fragment))
+            .write(r.smaaBlend, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("SMAA blend", [this](FrameContext& fc) { runPass("SMAA blend", *smaaBlendPass, fc); })
+            .read(r.compositionColor, RenderGraph::sampled(fragment))
+            .read(r.smaaBlend, RenderGraph::sampled(fragment))
+            .write(r.postAAColor, RenderGraph::colorTarget(readOnly));
+
+        graph.addPass("Color correction", [this](FrameContext& fc) { runPass("Color correction", *colorCorrectionPass, fc); })
+            .read(r.postAAColor, RenderGraph::sampled(fragment))
+            .write(r.swapchain, RenderGraph::colorTarget(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL));
+
+        if (!window.isHeadless()) {
+            graph.addPass("ImGui", [this](FrameContext& fc) {
+                    if (imguiManager) {
+                        CPU_PROFILE_ZONE("ImGui");
+                        GpuProfileScope scope(fc.gpuProfiler, fc.commandBuffer, "ImGui");
+                        imguiManager->run(fc.commandBuffer, currentImageIndex);
+                    }
+                })
+                .write(r.swapchain, RenderGraph::colorTargetLoad(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                                           VK_IMAGE_LAYOUT_PRESENT_SRC_KHR));
+        }
+
+        // History images are read by the next frame's context
+        graph.markOutput(r.swapchain);
+        graph.markOutput(r.giIndirect);
+        graph.compile();
+    }
+
+    void Renderer::bindRenderGraphImages(const FrameContext& frameContext) {
+        RenderGraph& graph = *renderGraph;
+        const GraphResources& r = graphResources;
+        graph.bindImage(r.depth, frameContext.depthImage);
+        graph.bindImage(r.depthPyramid, frameContext.depthPyramidImage);
+        graph.bindImage(r.gBufferPosition, frameContext.gBufferPositionImage);
+        graph.bindImage(r.gBufferNormal, frameContext.gBufferNormalImage);
+        graph.bindImage(r.gBufferAlbedo, frameContext.gBufferAlbedoImage);
+        graph.bindImage(r.gBufferMaterial, frameContext.gbufferMaterialImage);
+        graph.bindImage(r.gBufferPositionHistory, frameContext.gBufferPositionHistoryImage);
+        graph.bindImage(r.lightPassResult, frameContext.lightPassResultImage);
+        graph.bindImage(r.lightIncident, frameContext.lightIncidentImage);
+        graph.bindImages(r.rcRadiance, frameContext.rcRadianceImages.data(),
+                         static_cast<uint32_t>(frameContext.rcRadianceImages.size()));
+        graph.bindImage(r.giIndirect, frameContext.giIndirectImage);
+        graph.bindImage(r.giHistory, frameContext.giHistoryImage);
+        graph.bindImage(r.accumulation, frameContext.accumulationImage);
+        graph.bindImage(r.revealage, frameContext.revealageImage);
+        graph.bindImage(r.compositionColor, frameContext.compositionColorImage);
+        graph.bindImage(r.smaaEdge, frameContext.smaaEdgeImage);
+        graph.bindImage(r.smaaBlend, frameContext.smaaBlendImage);
+        graph.bindImage(r.postAAColor, frameContext.postAAColorImage);
+        graph.bindImage(r.swapchain, swapChain->getImage(currentImageIndex));
+
+        // Only the maps rendered this frame; point lights list one view per cube face
+        shadowMapImages.clear();
+        for (const ShadowView& view : frameContext.shadowViews) {
+            ShadowMap* map = nullptr;
+            switch (view.lightType) {
+                case LightType::DIRECTIONAL_LIGHT: map = frameContext.directionalShadowMaps[view.shadowmapIndex]; break;
+                case LightType::SPOT_LIGHT: map = frameContext.spotShadowMaps[view.shadowmapIndex]; break;
+                case LightType::POINT_LIGHT: map = frameContext.pointShadowMaps[view.shadowmapIndex]; break;
+                default: break;
+            }
+            if (map != nullptr &&
+                std::find(shadowMapImages.begin(), shadowMapImages.end(), map->getImage()) == shadowMapImages.end()) {
+                shadowMapImages.push_back(map->getImage());
+            }
+        }
+        graph.bindImages(r.shadowMaps, shadowMapImages.data(), static_cast<uint32_t>(shadowMapImages.size()));
+    }
+
     void Renderer::createRenderingResources(){
-        renderingResources = std::make_unique<RenderingResources>(device,*swapChain);
+        renderingResources = std::make_unique<RenderingResources>(device,swapChain->getExtent(),*renderGraph);
+        boundSkybox = Scene::Scene::getInstance().getEnvironmentLighting().skyboxTexture;
         frameContexts = renderingResources->createFrameContexts();
     }
 
@@ -304,6 +578,10 @@ namespace Rendering {
         createInfo.accumulationViewsPtr = &renderingResources->getAccumulationViews();
         createInfo.revealageViewsPtr = &renderingResources->getRevealageViews();
         createInfo.depthViewsPtr = &renderingResources->getDepthViews();
+        if (transparencyPass) {
+            transparencyPass->resize(createInfo);
+            return;
+        }
         transparencyPass = std::make_unique<TransparencyPass>(
             device, 
             createInfo);
@@ -316,6 +594,10 @@ namespace Rendering {
         createInfo.compositionDescriptorSetLayout = renderingResources->getCompositionDescriptorSetLayout();
         createInfo.targetFormat = renderingResources->getHDRFormat();
         createInfo.targetViews = &renderingResources->getCompositionColorViews();
+        if (compositionPass) {
+            compositionPass->resize(createInfo);
+            return;
+        }
         compositionPass = std::make_unique<CompositionPass>(device, createInfo);
     }
 
@@ -329,7 +611,11 @@ namespace Rendering {
         edgeInfo.targetFormat = renderingResources->getSMAAEdgeFormat();
         edgeInfo.descriptorSetLayout = renderingResources->getSMAAEdgeSetLayout();
         edgeInfo.targetViews = &renderingResources->getSMAAEdgeViews();
-        smaaEdgePass = std::make_unique<SMAAEdgePass>(device, edgeInfo);
+        if (smaaEdgePass) {
+            smaaEdgePass->resize(edgeInfo);
+        } else {
+            smaaEdgePass = std::make_unique<SMAAEdgePass>(device, edgeInfo);
+        }
 
         SMAAWeightPass::CreateInfo weightInfo{};
         weightInfo.width = w;
@@ -337,7 +623,11 @@ namespace Rendering {
         weightInfo.targetFormat = renderingResources->getSMAABlendFormat();
         weightInfo.descriptorSetLayout = renderingResources->getSMAAWeightSetLayout();
         weightInfo.targetViews = &renderingResources->getSMAABlendViews();
-        smaaWeightPass = std::make_unique<SMAAWeightPass>(device, weightInfo);
+        if (smaaWeightPass) {
+            smaaWeightPass->resize(weightInfo);
+        } else {
+            smaaWeightPass = std::make_unique<SMAAWeightPass>(device, weightInfo);
+        }
 
         SMAABlendPass::CreateInfo blendInfo{};
         blendInfo.width = w;
@@ -345,16 +635,19 @@ namespace Rendering {
         blendInfo.targetFormat = renderingResources->getPostProcessFormat();
         blendInfo.descriptorSetLayout = renderingResources->getSMAABlendSetLayout();
         blendInfo.targetViews = &renderingResources->getPostAAColorViews();
-        smaaBlendPass = std::make_unique<SMAABlendPass>(device, blendInfo);
+        if (smaaBlendPass) {
+            smaaBlendPass->resize(blendInfo);
+        } else {
+            smaaBlendPass = std::make_unique<SMAABlendPass>(device, blendInfo);
+        }
     }
 
     void Renderer::createColorCorrectionPass() {
         const uint32_t w = swapChain->getExtent().width;
         const uint32_t h = swapChain->getExtent().height;
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-            swapchainImageViews[i] = swapChain->getImageView(static_cast<uint32_t>(i));
-        }
+        // One framebuffer per swapchain image, however many the driver returned
+        swapchainImageViews = swapChain->getImageViews();
 
         ColorCorrectionPass::CreateInfo info{};
         info.width = w;
@@ -363,6 +656,12 @@ namespace Rendering {
         info.descriptorSetLayout = renderingResources->getColorCorrectionSetLayout();
         info.targetViews = &swapchainImageViews;
 
+        // Its render pass is of the swapchain format, which a new surface may change
+        if (colorCorrectionPass && colorCorrectionPass->getTargetFormat() == info.targetFormat) {
+            colorCorrectionPass->resize(info);
+            return;
+        }
+        device.getDeletionQueue().retire(std::move(colorCorrectionPass));
         colorCorrectionPass = std::make_unique<ColorCorrectionPass>(device, info);
     }
 
@@ -371,37 +670,178 @@ namespace Rendering {
         if (window.isMinimized() || window.getExtent().width == 0 || window.getExtent().height == 0) {
             return;
         }
+        // Incremental scene loading commits the camera after the first frames; there is no view before that
+        if (ECSManager::getInstance().getFirstComponent<Camera>() == nullptr) {
+            return;
+        }
+        CPU_PROFILE_ZONE("Renderer::run");
+        refreshSkybox();
 
         // Begin frame
         VkCommandBuffer commandBuffer = beginFrame();
         if (commandBuffer == nullptr) {
             return;
         }
+        // Queries are sliced per command buffer, whose fence acquireNextImage has just waited for
+        if (gpuProfiler) {
+            gpuProfiler->beginFrame(commandBuffer, static_cast<uint32_t>(currentFrameIndex));
+        }
         
-        // Get the current frame context (match resources to the acquired swapchain image)
-        FrameContext& frameContext = frameContexts[currentImageIndex];
+        // Frame resources follow the frame slot; only the final blit targets the acquired swapchain image
+        FrameContext& frameContext = frameContexts[currentFrameIndex];
+        // There are at least framesInFlight slots, so the frame fence the acquire waited for covers this slot's
+        // last frame
+        renderingResources->refreshDescriptorSets(static_cast<uint32_t>(currentFrameIndex));
+        renderingResources->recordLayoutInits(commandBuffer);
         updateFrameContext(commandBuffer, frameContext);
 
-        shadowmapPass->run(frameContext);
-        geometryPass->run(frameContext);
-        skyboxPass->run(frameContext);
-        lightPass->run(frameContext);
-        rcgiPass->run(frameContext);
-        transparencyPass->run(frameContext);
-        compositionPass->run(frameContext);
-        smaaEdgePass->run(frameContext);
-        smaaWeightPass->run(frameContext);
-        smaaBlendPass->run(frameContext);
-        colorCorrectionPass->run(frameContext);
-
-        // Render ImGui overlay
-        imguiManager->run(commandBuffer, currentImageIndex);
+        // Material descriptor swaps must land before any pass records this frame's draws
+        if (textureStreamer) {
+            CPU_PROFILE_ZONE("TextureStreamer::update");
+            textureStreamer->update(frameContext);
+        }
+
+        const auto recordStart = std::chrono::high_resolution_clock::now();
+        bindRenderGraphImages(frameContext);
+        if (renderGraph->usesAsyncCompute()) {
+            asyncCommandBuffers = &asyncCompute->begin(currentFrameIndex);
+        }
+        // The draw-heavy passes start recording on the workers while the graph records everything before them
+        if (parallelRecorder) {
+            parallelRecorder->beginFrame(currentFrameIndex);
+            shadowmapPass->prepare(frameContext);
+            geometryPass->prepare(frameContext);
+        }
+        renderGraph->execute(frameContext, asyncCommandBuffers);
+        if (parallelRecorder) {
+            parallelRecorder->endFrame();
+        }
+        recordingStats.recordMs = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - recordStart).count();
+        recordingStats.batchDraws = frameContext.opaqueMaterialBatchCount + frameContext.transparentMaterialBatchCount;
+        for (const ShadowView& view : frameContext.shadowViews) {
+            recordingStats.batchDraws += view.batchCount;
+        }
 
         endFrame();
     }
 
+    bool Renderer::captureLastFrame(std::vector<uint8_t>& rgb) {
+        if (!window.isHeadless() || lastSubmittedImage < 0) {
+            return false;
+        }
+        vkDeviceWaitIdle(device.getDevice());
+
+        const VkExtent2D extent = swapChain->getExtent();
+        const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+        VkBuffer readbackBuffer;
+        VkDeviceMemory readbackMemory;
+        device.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            readbackBuffer, readbackMemory);
+
+        // The color correction pass leaves the target as a color attachment; it is put back for the next use
+        const VkImage image = swapChain->getImage(static_cast<size_t>(lastSubmittedImage));
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        VkCommandBuffer commandBuffer = device.beginSingleTimeCommands();
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {extent.width, extent.height, 1};
+        vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer, 1, &region);
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+        device.endSingleTimeCommands(commandBuffer);
+
+        // The target is B8G8R8A8; the sRGB bytes are written out unchanged
+        void* mapped = nullptr;
+        vkMapMemory(device.getDevice(), readbackMemory, 0, size, 0, &mapped);
+        const uint8_t* bgra = static_cast<const uint8_t*>(mapped);
+        const size_t pixelCount = static_cast<size_t>(extent.width) * extent.height;
+        rgb.resize(pixelCount * 3);
+        for (size_t i = 0; i < pixelCount; ++i) {
+            rgb[i * 3 + 0] = bgra[i * 4 + 2];
+            rgb[i * 3 + 1] = bgra[i * 4 + 1];
+            rgb[i * 3 + 2] = bgra[i * 4 + 0];
+        }
+        vkUnmapMemory(device.getDevice(), readbackMemory);
+        vkDestroyBuffer(device.getDevice(), readbackBuffer, nullptr);
+        vkFreeMemory(device.getDevice(), readbackMemory, nullptr);
+        return true;
+    }
+
+    void Renderer::setRecordingThreads(uint32_t threadCount) {
+        parallelRecorder.reset();
+        if (threadCount != 1) {
+            parallelRecorder = std::make_unique<ParallelRecorder>(device, threadCount);
+        }
+    }
+
+    void Renderer::setFramesInFlight(uint32_t count) {
+        assert(!isFrameStarted && "Can't change frames in flight while a frame is in progress");
+        count = std::clamp(count, 1u, MAX_FRAMES_IN_FLIGHT);
+        if (count == device.getFramesInFlight()) {
+            return;
+        }
+        CPU_PROFILE_ZONE("Renderer::setFramesInFlight");
+
+        // Fences, command buffers and every per-frame array change size, so nothing may still be in flight
+        vkDeviceWaitIdle(device.getDevice());
+        device.getDeletionQueue().flush();
+        if (gpuProfiler) {
+            gpuProfiler->flush();
+        }
+        destroyPasses();
+        renderingResources.reset();
+        freeCommandBuffers();
+
+        device.setFramesInFlight(count);
+        recreateSwapChain();
+        createRenderingResources();
+        recreateWindowDependentResources();
+        createCommandBuffers();
+        if (imguiManager) {
+            imguiManager->onWindowResize(*swapChain);
+        }
+
+        currentFrameIndex = 0;
+        lastSubmittedImage = -1;
+        hasPreviousFrame = false;   // the history images are new
+    }
+
+    void Renderer::refreshSkybox(){
+        // The environment can be set after the rendering resources were created (incremental loading)
+        Texture* sceneSkybox = Scene::Scene::getInstance().getEnvironmentLighting().skyboxTexture;
+        if (sceneSkybox == boundSkybox) {
+            return;
+        }
+        // Every frame samples the same skybox set, so this one-time rebind waits for them instead of buffering it.
+        // Idle graphics also means idle async compute: every frame's last graphics batch waits on its compute work
+        {
+            std::lock_guard<std::mutex> lock(device.getGraphicsQueueMutex());
+            vkQueueWaitIdle(device.getGraphicsQueue());
+        }
+        renderingResources->initializeSkyboxFromScene();
+        boundSkybox = sceneSkybox;
+    }
+
     void Renderer::updateFrameContext(VkCommandBuffer commandBuffer, FrameContext& frameContext){
-        
+        CPU_PROFILE_ZONE("Renderer::updateFrameContext");
         auto& ecsManager = ECSManager::getInstance();   
         Camera& camera=*ecsManager.getFirstComponent<Camera>();
         Transform& transform=*ecsManager.getComponent<Transform>(camera.owner);
@@ -419,9 +859,12 @@ namespace Rendering {
         frameContext.cameraData.invProjectionMatrix=glm::inverse(camera.projectionMatrix);
         
         frameContext.commandBuffer=commandBuffer;
-        frameContext.frameIndex=currentImageIndex;
+        frameContext.frameIndex=static_cast<uint32_t>(currentFrameIndex);
+        frameContext.imageIndex=currentImageIndex;
         frameContext.extent = swapChain->getExtent();
         frameContext.frameTime=AlphaEngine::getDeltaTime();
+        frameContext.gpuProfiler=gpuProfiler.get();
+        frameContext.parallelRecorder=parallelRecorder.get();
 
         // Temporal accumulation: set previous camera data for reprojection
         // (prevViewProjMatrix contains last frame's matrix, current frame's is already in cameraData)
@@ -441,17 +884,30 @@ namespace Rendering {
         prevViewProjMatrix = camera.viewProjectionMatrix;
         hasPreviousFrame = true;
 
-        CameraUbo cameraUbo = {
-            frameContext.cameraData.viewMatrix, 
-            frameContext.cameraData.projectionMatrix, 
-            frameContext.cameraData.viewProjectionMatrix ,
-            glm::vec4(frameContext.cameraData.position,1.0f),
-            glm::vec4(frameContext.cameraData.nearPlane,frameContext.cameraData.farPlane,frameContext.cameraData.farPlane - frameContext.cameraData.nearPlane,frameContext.cameraData.nearPlane * frameContext.cameraData.farPlane)};
-        frameContext.cameraUniformBuffer->writeToBuffer(&cameraUbo,sizeof(CameraUbo));
-        frameContext.cameraData.viewFrustum=CameraSystem::createFrustumFromCamera(camera);       
+        {
+            CPU_PROFILE_ZONE("Camera UBO");
+            CameraUbo cameraUbo = {
+                frameContext.cameraData.viewMatrix, 
+                frameContext.cameraData.projectionMatrix, 
+                frameContext.cameraData.viewProjectionMatrix ,
+                glm::vec4(frameContext.cameraData.position,1.0f),
+                glm::vec4(frameContext.cameraData.nearPlane,frameContext.cameraData.farPlane,frameContext.cameraData.farPlane - frameContext.cameraData.nearPlane,frameContext.cameraData.nearPlane * frameContext.cameraData.farPlane)};
+            frameContext.cameraUniformBuffer->writeToBuffer(&cameraUbo,sizeof(CameraUbo));
+            frameContext.cameraData.viewFrustum=CameraSystem::createFrustumFromCamera(camera);
+        }
         
-        CameraCulling::updateFrameContext(frameContext);
-        LightSystem::updateFrameContext(frameContext);
+        {
+            CPU_PROFILE_ZONE("CameraCulling::updateFrameContext");
+            CameraCulling::updateFrameContext(frameContext);
+        }
+        {
+            CPU_PROFILE_ZONE("LightSystem::updateFrameContext");
+            const auto lightStart = std::chrono::high_resolution_clock::now();
+            LightSystem::updateFrameContext(frameContext);
+            recordingStats.lightUpdateMs = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - lightStart).count();
+            recordingStats.shadowViews = static_cast<uint32_t>(frameContext.shadowViews.size());
+        }
 
     }
 
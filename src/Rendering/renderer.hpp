@@ -16,6 +16,11 @@
 #include "Rendering/RenderPasses/Color Correction/color_correction_pass.hpp"
 #include "Rendering/Resources/gbuffer.hpp"
 #include "Rendering/Core/imgui_manager.hpp"
+#include "Rendering/Core/gpu_profiler.hpp"
+#include "Rendering/Core/render_graph.hpp"
+#include "Rendering/Core/async_compute.hpp"
+#include "Rendering/Core/parallel_recorder.hpp"
+#include "Engine/cpu_profiler.hpp"
 #include "Systems/camera_system.hpp"
 #include "Systems/camera_culling.hpp"
 #include "Systems/light_system.hpp"
@@ -27,6 +32,10 @@
 #include <vector>
 
 
+namespace Resources {
+    class TextureStreamer;
+}
+
 namespace Rendering {
     class Renderer {
     public:
@@ -67,16 +76,50 @@ namespace Rendering {
         
         // ImGui access
         ImGuiManager* getImGuiManager() { return imguiManager.get(); }
+        // Null when GPU_PROFILER_ENABLED is off or the device has no timestamps
+        GpuProfiler* getGpuProfiler() { return gpuProfiler.get(); }
+
+        // Headless only: waits for the device and copies the last submitted frame as tightly packed RGB8
+        // (getSwapChainExtent() sized); false before the first frame or with a window
+        bool captureLastFrame(std::vector<uint8_t>& rgb);
+
+        // Updated every frame from the camera culling results; null disables streaming
+        void setTextureStreamer(Resources::TextureStreamer* streamer) { textureStreamer = streamer; }
+
+        // Worker threads recording shadow views and opaque batches; 1 records inline, 0 picks
+        // hardware_concurrency - 1. Replacing the workers waits for the device
+        void setRecordingThreads(uint32_t threadCount);
+        uint32_t getRecordingThreads() const { return parallelRecorder ? parallelRecorder->getThreadCount() : 1; }
+
+        // Frames recorded ahead of the GPU, clamped to 1..MAX_FRAMES_IN_FLIGHT: fewer lowers input latency, more
+        // keeps the GPU fed through CPU spikes. Changing it waits for the device and rebuilds the swapchain, the
+        // per-frame resources and the passes; call between frames
+        void setFramesInFlight(uint32_t count);
+        uint32_t getFramesInFlight() const { return device.getFramesInFlight(); }
+
+        // CPU side of the last frame: command recording from the first pass to the last, and the light update
+        struct RecordingStats {
+            double recordMs = 0.0;
+            uint32_t batchDraws = 0;    // instanced draws of the geometry, shadow and transparency batches
+            double lightUpdateMs = 0.0; // LightSystem::updateFrameContext: light and caster culling, buffer uploads
+            uint32_t shadowViews = 0;
+        };
+        const RecordingStats& getRecordingStats() const { return recordingStats; }
         
     private:
         void recreateSwapChain();
         void cleanupWindowDependentResources();
         void recreateWindowDependentResources();
+        void destroyPasses();
         void handleWindowResize();
         void createCommandBuffers();
         void freeCommandBuffers();
 
+        void buildRenderGraph();
+        void bindRenderGraphImages(const FrameContext& frameContext);
         void createRenderingResources();
+        // The passes own the pipelines and outlive resizes: each create function builds its pass once and
+        // afterwards only hands it the new extent and views
         void createShadowPass();
         void createGeometryPass();
         void createSkyboxPass();
@@ -87,10 +130,18 @@ namespace Rendering {
         void createSMAAPasses();
         void createColorCorrectionPass();
         void updateFrameContext(VkCommandBuffer commandBuffer, FrameContext& frameContext);
+        void refreshSkybox();
+        template<typename PassT>
+        void runPass(const char* name, PassT& pass, FrameContext& frameContext) {
+            CPU_PROFILE_ZONE(name);
+            GpuProfileScope scope(frameContext.gpuProfiler, frameContext.commandBuffer, name);
+            pass.run(frameContext);
+        }
         Window& window;
         Device& device;
         std::shared_ptr<SwapChain> swapChain;
         std::vector<VkCommandBuffer> commandBuffers;
+        std::unique_ptr<RenderGraph> renderGraph;
         std::unique_ptr<RenderingResources> renderingResources;
         std::array<FrameContext, MAX_FRAMES_IN_FLIGHT> frameContexts;
         std::unique_ptr<GBuffer> gBuffer;
@@ -106,10 +157,43 @@ namespace Rendering {
         std::unique_ptr<SMAABlendPass> smaaBlendPass;
         std::unique_ptr<ColorCorrectionPass> colorCorrectionPass;
 
-        std::array<VkImageView, MAX_FRAMES_IN_FLIGHT> swapchainImageViews{};
+        std::vector<VkImageView> swapchainImageViews;
+
+        // Render graph resources, bound to the frame context's images every frame
+        struct GraphResources {
+            RenderGraph::ResourceHandle depth;
+            RenderGraph::ResourceHandle depthPyramid;
+            RenderGraph::ResourceHandle gBufferPosition;
+            RenderGraph::ResourceHandle gBufferNormal;
+            RenderGraph::ResourceHandle gBufferAlbedo;
+            RenderGraph::ResourceHandle gBufferMaterial;
+            RenderGraph::ResourceHandle gBufferPositionHistory;
+            RenderGraph::ResourceHandle shadowMaps;
+            RenderGraph::ResourceHandle lightPassResult;
+            RenderGraph::ResourceHandle lightIncident;
+            RenderGraph::ResourceHandle rcRadiance;
+            RenderGraph::ResourceHandle giIndirect;
+            RenderGraph::ResourceHandle giHistory;
+            RenderGraph::ResourceHandle accumulation;
+            RenderGraph::ResourceHandle revealage;
+            RenderGraph::ResourceHandle compositionColor;
+            RenderGraph::ResourceHandle smaaEdge;
+            RenderGraph::ResourceHandle smaaBlend;
+            RenderGraph::ResourceHandle postAAColor;
+            RenderGraph::ResourceHandle swapchain;
+        } graphResources{};
+        std::vector<VkImage> shadowMapImages;     // scratch for binding this frame's rendered shadow maps
         std::unique_ptr<ImGuiManager> imguiManager;
+        std::unique_ptr<GpuProfiler> gpuProfiler;
+        std::unique_ptr<AsyncCompute> asyncCompute;     // null without a second queue; RC GI then stays inline
+        const RenderGraph::QueueCommandBuffers* asyncCommandBuffers{nullptr};   // of the frame in progress
+        std::unique_ptr<ParallelRecorder> parallelRecorder;   // null when recording inline
+        RecordingStats recordingStats{};
+        Resources::TextureStreamer* textureStreamer{nullptr};
+        Texture* boundSkybox{nullptr};      // scene skybox the skybox descriptor set was last written with
 
         uint32_t currentImageIndex{0};
+        int32_t lastSubmittedImage{-1};
         size_t currentFrameIndex{0};
         bool isFrameStarted{false};
         bool framebufferResized{false};
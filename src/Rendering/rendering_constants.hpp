@@ -2,7 +2,11 @@
 #include <cstdint>
 
 namespace Rendering {
-    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+    // Capacity of the per-frame arrays; the count in use is a runtime setting, see Device::getFramesInFlight()
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+    constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 3;
+    // Temporal passes read the previous frame's images, so there are at least this many frame slots
+    constexpr uint32_t MIN_FRAME_SLOTS = 2;
     constexpr uint32_t MAX_DIRECTIONAL_LIGHTS = 4;
     constexpr uint32_t MAX_SPOT_LIGHTS = 8;
     constexpr uint32_t MAX_POINT_LIGHTS = 8;
@@ -16,12 +20,58 @@ namespace Rendering {
     // Shadow casters beyond this distance from camera are culled (1.5x margin for shadows cast into view)
     constexpr float MAX_SHADOW_CASTER_DISTANCE = MAX_SHADOW_DISTANCE * 1.5f;
     constexpr float MAX_SHADOW_CASTER_DISTANCE_SQR = MAX_SHADOW_CASTER_DISTANCE * MAX_SHADOW_CASTER_DISTANCE;
-    constexpr uint32_t MAX_SHADOWCASTING_LIGHT_MATRICES = 64;//1 directional(4 Cascades) +8 spot + 48 point (8 pointlights with 6 for each side)
+    // Every shadowcasting light at once: 4 directional x 4 cascades + 8 spot + 8 point x 6 faces. Shaders size their
+    // light matrix arrays to match
+    constexpr uint32_t MAX_SHADOWCASTING_LIGHT_MATRICES = MAX_DIRECTIONAL_LIGHTS * MAX_SHADOW_CASCADE_COUNT + MAX_SPOT_LIGHTS + MAX_POINT_LIGHTS * 6;
     constexpr uint32_t MAX_SHADOWCASTING_DIRECTIONAL = 128;
     constexpr uint32_t DIRECTIONAL_SHADOW_MAP_RES = 2048;
     constexpr uint32_t SPOT_SHADOW_MAP_RES = 1028;
     constexpr uint32_t POINT_SHADOW_MAP_RES = 512;
-    
+    // Sample distribution shadow maps: fit cascade splits to the visible depth range read back from the depth pyramid
+    constexpr bool SDSM_ENABLED = true;
+    constexpr uint32_t SDSM_REDUCTION_MAX_WIDTH = 256; // coarsest pyramid mip at or below this width is reduced
+    // Asset uploads: staging ring used by UploadManager, each chunk is one submission tracked on its timeline semaphore
+    constexpr uint64_t UPLOAD_STAGING_CHUNK_SIZE = 64ull * 1024 * 1024;
+    constexpr uint32_t UPLOAD_STAGING_CHUNK_COUNT = 3;
+    // Texture streaming: scene textures load only the mips at or below the tail size, higher mips are streamed in
+    // from the screen-space UV density of visible materials and evicted least-recently-used over the budget
+    constexpr bool TEXTURE_STREAMING_ENABLED = true;
+    constexpr uint32_t TEXTURE_STREAMING_TAIL_SIZE = 128;         // largest dimension kept resident from load
+    constexpr uint64_t TEXTURE_STREAMING_BUDGET = 512ull * 1024 * 1024; // streamed mips only, tails are not counted
+    constexpr uint32_t TEXTURE_STREAMING_MAX_PENDING = 4;         // decodes queued or uploading at once
+    constexpr uint32_t TEXTURE_STREAMING_MAX_SWAPS_PER_FRAME = 2;
+    constexpr uint32_t TEXTURE_STREAMING_DESCRIPTOR_HEADROOM = 256; // material sets that may wait for retirement
+    constexpr float TEXTURE_STREAMING_MIP_BIAS = 0.0f;            // added to the computed level, > 0 trades sharpness for memory
+    // Incremental scene loading: a loader thread prepares meshes and textures while frames keep rendering, and the
+    // main thread commits materials and entities to the ECS and scene octree for at most the budget per frame
+    constexpr bool INCREMENTAL_SCENE_LOADING_ENABLED = true;
+    constexpr double SCENE_LOAD_COMMIT_BUDGET_MS = 2.0;
+    // GPU profiler: timestamp queries around each pass, read back when the frame slot comes around again and shown
+    // in the overlay; the history is what the CSV/JSON exports write
+    constexpr bool GPU_PROFILER_ENABLED = true;
+    constexpr uint32_t GPU_PROFILER_MAX_SCOPES = 128;      // per frame, scopes past it are not timed
+    constexpr uint32_t GPU_PROFILER_HISTORY_FRAMES = 300;
+    constexpr bool GPU_PROFILER_EXPORT_ON_EXIT = false;    // writes a capture when the engine shuts down
+    constexpr const char* GPU_PROFILER_EXPORT_DIRECTORY = "Profiles";
+    // Async compute: the RC GI pass (depth pyramid, cascades, resolve) is submitted on a second queue and overlaps
+    // the transparency pass and the next frame's shadows; without a second queue it stays on the graphics queue
+    constexpr bool ASYNC_COMPUTE_ENABLED = true;
+    // Parallel recording: shadow views and chunks of the opaque batches are recorded into secondary command buffers
+    // on worker threads; 1 thread records everything inline on the main thread
+    constexpr uint32_t PARALLEL_RECORDING_THREADS = 0;            // 0 picks hardware_concurrency - 1
+    constexpr uint32_t PARALLEL_RECORDING_MIN_BATCHES = 64;       // per geometry job, smaller chunks cost more than they save
+    // Pipeline cache: shared by every pipeline, loaded at startup and saved at shutdown; pipelines are created on
+    // worker threads and the first frame waits for each one where it binds it
+    constexpr bool PIPELINE_CACHE_ENABLED = true;
+    constexpr const char* PIPELINE_CACHE_PATH = "Cache/pipelines.bin";
+    constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x43504c41;          // "ALPC" little-endian
+    constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+    constexpr uint32_t PIPELINE_COMPILE_THREADS = 0;              // 0 picks hardware_concurrency - 1
+    // Resource pool: released images and buffers (evicted texture mips, resized buffers) are kept once the GPU is
+    // done with them and handed to the next identical request; idle ones past either limit are freed
+    constexpr uint64_t RESOURCE_POOL_MAX_IDLE_BYTES = 256ull * 1024 * 1024;
+    constexpr uint64_t RESOURCE_POOL_MAX_IDLE_FRAMES = 600;       // unused this long, an idle object is freed
+
 
     constexpr uint32_t RC_CASCADE_COUNT = 6;      
     constexpr uint32_t RC_BASE_TILE_SIZE = 2;     // i=0 tile: 2x2 = 4 directions per probe
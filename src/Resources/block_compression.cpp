@@ -0,0 +1,465 @@
+#include "block_compression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Resources {
+
+namespace {
+    constexpr uint32_t BLOCK_PIXELS = 16;
+    constexpr size_t BLOCK_BYTES = 16;
+    constexpr size_t BC4_BLOCK_BYTES = 8;  // one channel; a BC5 block is two of them
+    constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Gathers a 4x4 block, clamping reads at the right and bottom edges
+    void loadBlock(const unsigned char* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, unsigned char block[BLOCK_PIXELS][4]) {
+        for (uint32_t y = 0; y < 4; y++) {
+            uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; x++) {
+                uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                std::memcpy(block[y * 4 + x], rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+            }
+        }
+    }
+
+    void storeBlock(const unsigned char block[BLOCK_PIXELS][4], uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY,
+                    uint32_t firstChannel, uint32_t channelCount, unsigned char* rgba) {
+        for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++) {
+            for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++) {
+                unsigned char* pixel = rgba + ((static_cast<size_t>(blockY) * 4 + y) * width + blockX * 4 + x) * 4;
+                std::memcpy(pixel + firstChannel, block[y * 4 + x] + firstChannel, channelCount);
+            }
+        }
+    }
+
+    // Little-endian bit stream over one block; clears only the block's own bytes
+    class BitWriter {
+    public:
+        BitWriter(unsigned char* block, size_t byteCount) : bytes(block) { std::memset(bytes, 0, byteCount); }
+        void write(uint32_t value, uint32_t bitCount) {
+            for (uint32_t i = 0; i < bitCount; i++, position++) {
+                bytes[position >> 3] |= static_cast<unsigned char>(((value >> i) & 1u) << (position & 7));
+            }
+        }
+    private:
+        unsigned char* bytes;
+        uint32_t position = 0;
+    };
+
+    class BitReader {
+    public:
+        explicit BitReader(const unsigned char* block) : bytes(block) {}
+        uint32_t read(uint32_t bitCount) {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bitCount; i++, position++) {
+                value |= ((bytes[position >> 3] >> (position & 7)) & 1u) << i;
+            }
+            return value;
+        }
+    private:
+        const unsigned char* bytes;
+        uint32_t position = 0;
+    };
+
+    // ---- BC7 mode 6 ----
+
+    struct Bc7Endpoints {
+        uint32_t color[2][4];   // 7 bits per channel
+        uint32_t pbit[2];
+    };
+
+    int interpolateBc7(int e0, int e1, int weight) {
+        return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+    }
+
+    // Expands the endpoints into the 16-entry palette and picks the closest entry for every pixel
+    uint32_t assignBc7Indices(const unsigned char block[BLOCK_PIXELS][4], const Bc7Endpoints& endpoints, uint8_t indices[BLOCK_PIXELS]) {
+        int palette[16][4];
+        for (int channel = 0; channel < 4; channel++) {
+            int e0 = static_cast<int>((endpoints.color[0][channel] << 1) | endpoints.pbit[0]);
+            int e1 = static_cast<int>((endpoints.color[1][channel] << 1) | endpoints.pbit[1]);
+            for (int i = 0; i < 16; i++) {
+                palette[i][channel] = interpolateBc7(e0, e1, BC7_WEIGHTS[i]);
+            }
+        }
+
+        uint32_t totalError = 0;
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            uint32_t bestError = std::numeric_limits<uint32_t>::max();
+            for (uint8_t i = 0; i < 16; i++) {
+                uint32_t error = 0;
+                for (int channel = 0; channel < 4; channel++) {
+                    int difference = palette[i][channel] - block[pixel][channel];
+                    error += static_cast<uint32_t>(difference * difference);
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    indices[pixel] = i;
+                }
+            }
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+    // Quantizes float endpoints to 7 bits plus the p-bit that rounds each endpoint closest over its four channels
+    uint32_t quantizeBc7(const unsigned char block[BLOCK_PIXELS][4], const float endpoints[2][4], Bc7Endpoints& quantized, uint8_t indices[BLOCK_PIXELS]) {
+        for (int endpoint = 0; endpoint < 2; endpoint++) {
+            float bestError = std::numeric_limits<float>::max();
+            for (uint32_t pbit = 0; pbit < 2; pbit++) {
+                uint32_t color[4];
+                float error = 0.0f;
+                for (int channel = 0; channel < 4; channel++) {
+                    float value = (endpoints[endpoint][channel] - static_cast<float>(pbit)) * 0.5f;
+                    color[channel] = static_cast<uint32_t>(std::clamp(std::lround(value), 0l, 127l));
+                    float difference = static_cast<float>((color[channel] << 1) | pbit) - endpoints[endpoint][channel];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    quantized.pbit[endpoint] = pbit;
+                    std::memcpy(quantized.color[endpoint], color, sizeof(color));
+                }
+            }
+        }
+        return assignBc7Indices(block, quantized, indices);
+    }
+
+    // Endpoints spanning the block's projection onto its principal axis
+    void fitBc7Axis(const unsigned char block[BLOCK_PIXELS][4], float endpoints[2][4]) {
+        float mean[4] = {};
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            for (int channel = 0; channel < 4; channel++) {
+                mean[channel] += block[pixel][channel];
+            }
+        }
+        for (float& value : mean) {
+            value /= BLOCK_PIXELS;
+        }
+
+        float covariance[4][4] = {};
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            float centered[4];
+            for (int channel = 0; channel < 4; channel++) {
+                centered[channel] = block[pixel][channel] - mean[channel];
+            }
+            for (int row = 0; row < 4; row++) {
+                for (int column = 0; column < 4; column++) {
+                    covariance[row][column] += centered[row] * centered[column];
+                }
+            }
+        }
+
+        // Power iteration from the diagonal, a handful of steps is plenty for 16 points
+        float axis[4] = {covariance[0][0], covariance[1][1], covariance[2][2], covariance[3][3]};
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[4] = {};
+            for (int row = 0; row < 4; row++) {
+                for (int column = 0; column < 4; column++) {
+                    next[row] += covariance[row][column] * axis[column];
+                }
+            }
+            float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+            if (length < 1e-6f) {
+                break;
+            }
+            for (int channel = 0; channel < 4; channel++) {
+                axis[channel] = next[channel] / length;
+            }
+        }
+
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            float projection = 0.0f;
+            for (int channel = 0; channel < 4; channel++) {
+                projection += (block[pixel][channel] - mean[channel]) * axis[channel];
+            }
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        for (int channel = 0; channel < 4; channel++) {
+            endpoints[0][channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.0f, 255.0f);
+            endpoints[1][channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.0f, 255.0f);
+        }
+    }
+
+    // Least-squares endpoints for fixed weights; false when the weights do not constrain both endpoints
+    bool refineEndpoints(const unsigned char* values, size_t stride, const float* weights, uint32_t count, float& e0, float& e1) {
+        float a = 0.0f, b = 0.0f, c = 0.0f, rhs0 = 0.0f, rhs1 = 0.0f;
+        for (uint32_t i = 0; i < count; i++) {
+            float w = weights[i];
+            float x = values[i * stride];
+            a += (1.0f - w) * (1.0f - w);
+            b += (1.0f - w) * w;
+            c += w * w;
+            rhs0 += (1.0f - w) * x;
+            rhs1 += w * x;
+        }
+        float determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+        e0 = std::clamp((c * rhs0 - b * rhs1) / determinant, 0.0f, 255.0f);
+        e1 = std::clamp((a * rhs1 - b * rhs0) / determinant, 0.0f, 255.0f);
+        return true;
+    }
+
+    void encodeBc7Block(const unsigned char block[BLOCK_PIXELS][4], unsigned char* output) {
+        float endpoints[2][4];
+        fitBc7Axis(block, endpoints);
+
+        Bc7Endpoints best;
+        uint8_t indices[BLOCK_PIXELS];
+        uint32_t bestError = quantizeBc7(block, endpoints, best, indices);
+
+        for (uint32_t pass = 0; pass < BLOCK_COMPRESSION_REFINE_PASSES && bestError > 0; pass++) {
+            float weights[BLOCK_PIXELS];
+            for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+                weights[pixel] = BC7_WEIGHTS[indices[pixel]] / 64.0f;
+            }
+            float refined[2][4];
+            bool solved = true;
+            for (int channel = 0; channel < 4 && solved; channel++) {
+                solved = refineEndpoints(&block[0][channel], 4, weights, BLOCK_PIXELS, refined[0][channel], refined[1][channel]);
+            }
+            if (!solved) {
+                break;
+            }
+
+            Bc7Endpoints candidate;
+            uint8_t candidateIndices[BLOCK_PIXELS];
+            uint32_t error = quantizeBc7(block, refined, candidate, candidateIndices);
+            if (error >= bestError) {
+                break;
+            }
+            bestError = error;
+            best = candidate;
+            std::memcpy(indices, candidateIndices, BLOCK_PIXELS);
+        }
+
+        // The first index is stored without its top bit, so it has to be below 8: swap the endpoints if it is not
+        if (indices[0] >= 8) {
+            std::swap(best.color[0], best.color[1]);
+            std::swap(best.pbit[0], best.pbit[1]);
+            for (uint8_t& index : indices) {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter writer(output, BLOCK_BYTES);
+        writer.write(1u << 6, 7);
+        for (int channel = 0; channel < 4; channel++) {
+            writer.write(best.color[0][channel], 7);
+            writer.write(best.color[1][channel], 7);
+        }
+        writer.write(best.pbit[0], 1);
+        writer.write(best.pbit[1], 1);
+        writer.write(indices[0], 3);
+        for (uint32_t pixel = 1; pixel < BLOCK_PIXELS; pixel++) {
+            writer.write(indices[pixel], 4);
+        }
+    }
+
+    void decodeBc7Block(const unsigned char* input, unsigned char block[BLOCK_PIXELS][4]) {
+        BitReader reader(input);
+        if (reader.read(7) != (1u << 6)) {
+            std::memset(block, 0, BLOCK_PIXELS * 4);
+            return;
+        }
+
+        uint32_t color[2][4];
+        for (int channel = 0; channel < 4; channel++) {
+            color[0][channel] = reader.read(7);
+            color[1][channel] = reader.read(7);
+        }
+        uint32_t pbit[2] = {reader.read(1), reader.read(1)};
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            int weight = BC7_WEIGHTS[reader.read(pixel == 0 ? 3 : 4)];
+            for (int channel = 0; channel < 4; channel++) {
+                int e0 = static_cast<int>((color[0][channel] << 1) | pbit[0]);
+                int e1 = static_cast<int>((color[1][channel] << 1) | pbit[1]);
+                block[pixel][channel] = static_cast<unsigned char>(interpolateBc7(e0, e1, weight));
+            }
+        }
+    }
+
+    // ---- BC4, two of which make a BC5 block ----
+
+    // Palette of the 8-value mode (r0 > r1), index order as stored
+    void bc4Palette(int r0, int r1, float palette[8]) {
+        palette[0] = static_cast<float>(r0);
+        palette[1] = static_cast<float>(r1);
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * r0 + i * r1) / 7.0f;
+        }
+    }
+
+    float assignBc4Indices(const unsigned char* values, int r0, int r1, uint8_t indices[BLOCK_PIXELS]) {
+        float palette[8];
+        bc4Palette(r0, r1, palette);
+        float totalError = 0.0f;
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            float bestError = std::numeric_limits<float>::max();
+            for (uint8_t i = 0; i < 8; i++) {
+                float difference = palette[i] - values[pixel * 4];
+                if (difference * difference < bestError) {
+                    bestError = difference * difference;
+                    indices[pixel] = i;
+                }
+            }
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+    // Weight of each palette entry toward r1, matching bc4Palette
+    float bc4Weight(uint8_t index) {
+        return index == 0 ? 0.0f : index == 1 ? 1.0f : (index - 1) / 7.0f;
+    }
+
+    void encodeBc4Block(const unsigned char* values, unsigned char* output) {
+        int minValue = 255;
+        int maxValue = 0;
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            minValue = std::min<int>(minValue, values[pixel * 4]);
+            maxValue = std::max<int>(maxValue, values[pixel * 4]);
+        }
+
+        uint8_t indices[BLOCK_PIXELS] = {};
+        int r0 = maxValue;
+        int r1 = minValue;
+        if (r0 > r1) {
+            float bestError = assignBc4Indices(values, r0, r1, indices);
+            for (uint32_t pass = 0; pass < BLOCK_COMPRESSION_REFINE_PASSES && bestError > 0.0f; pass++) {
+                float weights[BLOCK_PIXELS];
+                for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+                    weights[pixel] = bc4Weight(indices[pixel]);
+                }
+                float e0 = 0.0f, e1 = 0.0f;
+                if (!refineEndpoints(values, 4, weights, BLOCK_PIXELS, e0, e1)) {
+                    break;
+                }
+                int candidate0 = static_cast<int>(std::lround(e0));
+                int candidate1 = static_cast<int>(std::lround(e1));
+                if (candidate0 <= candidate1) {
+                    break;
+                }
+                uint8_t candidateIndices[BLOCK_PIXELS];
+                float error = assignBc4Indices(values, candidate0, candidate1, candidateIndices);
+                if (error >= bestError) {
+                    break;
+                }
+                bestError = error;
+                r0 = candidate0;
+                r1 = candidate1;
+                std::memcpy(indices, candidateIndices, BLOCK_PIXELS);
+            }
+        }
+        // A flat block stays at r0 == r1, which decodes index 0 as r0 in either mode
+
+        BitWriter writer(output, BC4_BLOCK_BYTES);
+        writer.write(static_cast<uint32_t>(r0), 8);
+        writer.write(static_cast<uint32_t>(r1), 8);
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            writer.write(indices[pixel], 3);
+        }
+    }
+
+    void decodeBc4Block(const unsigned char* input, unsigned char block[BLOCK_PIXELS][4], uint32_t channel) {
+        BitReader reader(input);
+        int r0 = static_cast<int>(reader.read(8));
+        int r1 = static_cast<int>(reader.read(8));
+        float palette[8];
+        if (r0 > r1) {
+            bc4Palette(r0, r1, palette);
+        } else {
+            palette[0] = static_cast<float>(r0);
+            palette[1] = static_cast<float>(r1);
+            for (int i = 1; i < 5; i++) {
+                palette[i + 1] = ((5 - i) * r0 + i * r1) / 5.0f;
+            }
+            palette[6] = 0.0f;
+            palette[7] = 255.0f;
+        }
+        for (uint32_t pixel = 0; pixel < BLOCK_PIXELS; pixel++) {
+            block[pixel][channel] = static_cast<unsigned char>(std::lround(palette[reader.read(3)]));
+        }
+    }
+}
+
+size_t BlockCompression::getEncodedSize(uint32_t width, uint32_t height) {
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * BLOCK_BYTES;
+}
+
+void BlockCompression::encodeBC7(const unsigned char* rgba, uint32_t width, uint32_t height, unsigned char* blocks) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    unsigned char block[BLOCK_PIXELS][4];
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            loadBlock(rgba, width, height, blockX, blockY, block);
+            encodeBc7Block(block, blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * BLOCK_BYTES);
+        }
+    }
+}
+
+void BlockCompression::encodeBC5(const unsigned char* rgba, uint32_t width, uint32_t height, unsigned char* blocks) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    unsigned char block[BLOCK_PIXELS][4];
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            loadBlock(rgba, width, height, blockX, blockY, block);
+            unsigned char* output = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * BLOCK_BYTES;
+            encodeBc4Block(&block[0][0], output);
+            encodeBc4Block(&block[0][1], output + BC4_BLOCK_BYTES);
+        }
+    }
+}
+
+void BlockCompression::decodeBC7(const unsigned char* blocks, uint32_t width, uint32_t height, unsigned char* rgba) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    unsigned char block[BLOCK_PIXELS][4];
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            decodeBc7Block(blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * BLOCK_BYTES, block);
+            storeBlock(block, width, height, blockX, blockY, 0, 4, rgba);
+        }
+    }
+}
+
+void BlockCompression::decodeBC5(const unsigned char* blocks, uint32_t width, uint32_t height, unsigned char* rgba) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    unsigned char block[BLOCK_PIXELS][4];
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            const unsigned char* input = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * BLOCK_BYTES;
+            decodeBc4Block(input, block, 0);
+            decodeBc4Block(input + BC4_BLOCK_BYTES, block, 1);
+            storeBlock(block, width, height, blockX, blockY, 0, 2, rgba);
+        }
+    }
+}
+
+double BlockCompression::computePsnr(const unsigned char* reference, const unsigned char* decoded, size_t pixelCount, uint32_t channelCount) {
+    double squaredError = 0.0;
+    for (size_t pixel = 0; pixel < pixelCount; pixel++) {
+        for (uint32_t channel = 0; channel < channelCount; channel++) {
+            double difference = static_cast<double>(reference[pixel * 4 + channel]) - decoded[pixel * 4 + channel];
+            squaredError += difference * difference;
+        }
+    }
+    const double meanSquaredError = squaredError / (static_cast<double>(pixelCount) * channelCount);
+    if (meanSquaredError <= 0.0) {
+        return 99.0;
+    }
+    return std::min(99.0, 10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+}
+
+} // namespace Resources
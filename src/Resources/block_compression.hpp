@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Resources {
+
+    // PNG textures without a .ktx2 are encoded on the CPU to the formats the KTX2 path transcodes to: BC7 for color
+    // and BC5 for normal maps. Runs on the loader's worker threads and the result goes to the derived data cache, so
+    // a texture is only encoded once.
+    constexpr bool PNG_BLOCK_COMPRESSION_ENABLED = true;
+    // Least-squares endpoint refinements per block after the principal axis fit; 0 keeps the fit as is
+    constexpr uint32_t BLOCK_COMPRESSION_REFINE_PASSES = 2;
+
+    // BC7 is written in mode 6 only (one subset, RGBA endpoints with a p-bit each, 16 weights): no partitions to
+    // search, and alpha is encoded with the color. Images are RGBA8; partial edge blocks repeat the edge texels.
+    class BlockCompression {
+    public:
+        // 16 bytes per 4x4 block for both formats
+        static size_t getEncodedSize(uint32_t width, uint32_t height);
+
+        static void encodeBC7(const unsigned char* rgba, uint32_t width, uint32_t height, unsigned char* blocks);
+        // From the red and green channels
+        static void encodeBC5(const unsigned char* rgba, uint32_t width, uint32_t height, unsigned char* blocks);
+
+        // Decoders for measuring quality: decodeBC7 reads the mode 6 blocks encodeBC7 writes. Channels a format
+        // does not store are left untouched
+        static void decodeBC7(const unsigned char* blocks, uint32_t width, uint32_t height, unsigned char* rgba);
+        static void decodeBC5(const unsigned char* blocks, uint32_t width, uint32_t height, unsigned char* rgba);
+
+        // Over the first channelCount channels of two RGBA8 images, capped at 99 dB for identical ones
+        static double computePsnr(const unsigned char* reference, const unsigned char* decoded, size_t pixelCount, uint32_t channelCount);
+    };
+
+} // namespace Resources
@@ -0,0 +1,174 @@
+#include "derived_data_cache.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Resources {
+
+namespace {
+    constexpr uint64_t BLOB_ALIGNMENT = 16;
+    constexpr uint64_t HASH_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    constexpr uint64_t HASH_PRIME = 0x100000001b3ull;
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    bool rangeInside(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+        return offset <= fileSize && bytes <= fileSize - offset;
+    }
+
+    // FNV-1a over 8-byte words, the source files are hashed on every startup so bytes at a time would be too slow
+    uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset, sizeof(word));
+            hash = (hash ^ word) * HASH_PRIME;
+            hash ^= hash >> 29;
+        }
+        for (; offset < size; offset++) {
+            hash = (hash ^ bytes[offset]) * HASH_PRIME;
+        }
+        return hash;
+    }
+
+    const char* getEntryExtension(DerivedDataKind kind) {
+        return kind == DerivedDataKind::Mesh ? MESH_BINARY_EXTENSION : ".atex";
+    }
+
+    // Writes through a per-thread temporary file so a reader never maps a half-written entry
+    template <typename Writer>
+    bool writeEntry(const std::string& path, Writer&& writer) {
+        std::error_code error;
+        std::filesystem::create_directories(DERIVED_DATA_CACHE_DIRECTORY, error);
+
+        std::ostringstream tempPath;
+        tempPath << path << ".tmp" << std::hash<std::thread::id>{}(std::this_thread::get_id());
+        try {
+            writer(tempPath.str());
+        } catch (const std::exception& e) {
+            std::cerr << "\nFailed to write derived data cache entry " << path << ": " << e.what() << std::endl;
+            std::filesystem::remove(tempPath.str(), error);
+            return false;
+        }
+
+        std::filesystem::rename(tempPath.str(), path, error);
+        if (error) {
+            std::filesystem::remove(tempPath.str(), error);
+            return false;
+        }
+        return true;
+    }
+}
+
+uint64_t DerivedDataCache::computeKey(const std::string& sourcePath, DerivedDataKind kind, uint32_t target) {
+    return computeKey(std::vector<std::string>{sourcePath}, kind, target);
+}
+
+uint64_t DerivedDataCache::computeKey(const std::vector<std::string>& sourcePaths, DerivedDataKind kind, uint32_t target) {
+    const uint32_t salt[3] = {DERIVED_DATA_CACHE_VERSION, static_cast<uint32_t>(kind), target};
+    uint64_t key = hashBytes(salt, sizeof(salt), HASH_OFFSET_BASIS);
+    for (const std::string& sourcePath : sourcePaths) {
+        MappedFile source;
+        if (!source.open(sourcePath)) {
+            return 0;
+        }
+        key = hashBytes(source.data(), source.size(), key);
+    }
+    // 0 means "no key" to callers
+    return key != 0 ? key : 1;
+}
+
+std::string DerivedDataCache::getEntryPath(uint64_t key, DerivedDataKind kind) {
+    std::ostringstream path;
+    path << DERIVED_DATA_CACHE_DIRECTORY << "/" << std::hex << std::setw(16) << std::setfill('0') << key << getEntryExtension(kind);
+    return path.str();
+}
+
+bool DerivedDataCache::readTexture(uint64_t key, DerivedDataKind kind, MappedFile& mapping, DerivedTextureView& view) {
+    if (!mapping.open(getEntryPath(key, kind)) || mapping.size() < sizeof(DerivedTextureHeader)) {
+        return false;
+    }
+
+    const auto* bytes = static_cast<const unsigned char*>(mapping.data());
+    const auto* header = static_cast<const DerivedTextureHeader*>(mapping.data());
+    const uint64_t fileSize = mapping.size();
+    if (header->magic != DERIVED_DATA_CACHE_MAGIC ||
+        header->version != DERIVED_DATA_CACHE_VERSION ||
+        header->key != key ||
+        header->levelCount == 0 ||
+        header->levelTableOffset % alignof(DerivedTextureLevel) != 0 ||
+        !rangeInside(header->levelTableOffset, uint64_t(header->levelCount) * sizeof(DerivedTextureLevel), fileSize) ||
+        !rangeInside(header->dataOffset, header->dataSize, fileSize)) {
+        mapping.close();
+        return false;
+    }
+
+    const auto* levels = reinterpret_cast<const DerivedTextureLevel*>(bytes + header->levelTableOffset);
+    for (uint32_t level = 0; level < header->levelCount; level++) {
+        if (!rangeInside(levels[level].offset, levels[level].size, header->dataSize)) {
+            mapping.close();
+            return false;
+        }
+    }
+
+    view.header = header;
+    view.levels = levels;
+    view.data = bytes + header->dataOffset;
+    return true;
+}
+
+bool DerivedDataCache::writeTexture(uint64_t key, DerivedDataKind kind, uint32_t format, uint32_t width, uint32_t height,
+                                    const unsigned char* data, const std::vector<DerivedTextureLevel>& levels) {
+    // Levels are repacked in level order, whatever order the producer kept them in
+    DerivedTextureHeader header{};
+    header.magic = DERIVED_DATA_CACHE_MAGIC;
+    header.version = DERIVED_DATA_CACHE_VERSION;
+    header.key = key;
+    header.format = format;
+    header.width = width;
+    header.height = height;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.levelTableOffset = alignUp(sizeof(DerivedTextureHeader));
+    header.dataOffset = alignUp(header.levelTableOffset + levels.size() * sizeof(DerivedTextureLevel));
+
+    std::vector<DerivedTextureLevel> packedLevels(levels.size());
+    uint64_t dataSize = 0;
+    for (size_t level = 0; level < levels.size(); level++) {
+        packedLevels[level] = {dataSize, levels[level].size};
+        dataSize = alignUp(dataSize + levels[level].size);
+    }
+    header.dataSize = dataSize;
+
+    return writeEntry(getEntryPath(key, kind), [&](const std::string& path) {
+        std::vector<char> fileData(header.dataOffset + header.dataSize, 0);
+        std::memcpy(fileData.data(), &header, sizeof(header));
+        std::memcpy(fileData.data() + header.levelTableOffset, packedLevels.data(), packedLevels.size() * sizeof(DerivedTextureLevel));
+        for (size_t level = 0; level < levels.size(); level++) {
+            std::memcpy(fileData.data() + header.dataOffset + packedLevels[level].offset, data + levels[level].offset, levels[level].size);
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(fileData.data(), static_cast<std::streamsize>(fileData.size()))) {
+            throw std::runtime_error("write failed");
+        }
+    });
+}
+
+bool DerivedDataCache::writeMesh(uint64_t key, const std::string& id, const std::vector<MeshBinaryVertex>& vertices,
+                                 const std::vector<uint32_t>& indices, const std::vector<MeshBinarySubmesh>& submeshes) {
+    return writeEntry(getEntryPath(key, DerivedDataKind::Mesh), [&](const std::string& path) {
+        MeshBinary::write(path, id, vertices, indices, submeshes);
+    });
+}
+
+} // namespace Resources
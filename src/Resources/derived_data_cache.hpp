@@ -0,0 +1,75 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "mesh_binary.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Resources {
+
+    // On-disk cache of GPU-ready data derived from scene assets: transcoded KTX2 mip chains, RGBA8 or BC7/BC5 mip
+    // chains built from PNGs, prefiltered skyboxes and meshes packed from their JSON. Entries are named by a hash of
+    // the source file content, what it is derived into and DERIVED_DATA_CACHE_VERSION, so an edited source simply
+    // misses and old entries are never read again; deleting the directory clears the cache.
+    constexpr bool DERIVED_DATA_CACHE_ENABLED = true;
+    constexpr const char* DERIVED_DATA_CACHE_DIRECTORY = "Cache/DerivedData";
+    constexpr uint32_t DERIVED_DATA_CACHE_MAGIC = 0x58544441; // "ADTX" little-endian
+    // Bump whenever a producer changes its output (transcoder settings, mip filter, vertex layout)
+    constexpr uint32_t DERIVED_DATA_CACHE_VERSION = 1;
+
+    enum class DerivedDataKind : uint32_t {
+        TranscodedTexture = 1,  // KTX2 transcoded to a BCn format, target is the ktx_transcode_fmt_e
+        TextureMips = 2,        // RGBA8 image with a CPU-built mip chain, target is the VkFormat
+        Mesh = 3,               // JSON mesh in the .amesh container, target is MESH_BINARY_VERSION
+        CompressedTexture = 4,  // PNG mip chain block-compressed on the CPU, target is the BCn VkFormat
+        PrefilteredEnvironment = 5  // skybox faces prefiltered by EnvironmentPreprocessor, keyed by all six
+    };
+
+    // Texture entry layout: header, level table, then the levels in one 16-byte aligned blob
+    struct DerivedTextureHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;               // repeated from the file name so a renamed or truncated entry is rejected
+        uint32_t format;            // VkFormat of the levels
+        uint32_t width;             // level 0
+        uint32_t height;
+        uint32_t levelCount;
+        uint64_t levelTableOffset;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+
+    struct DerivedTextureLevel {
+        uint64_t offset;            // relative to the data blob
+        uint64_t size;
+    };
+
+    // Points into the mapped entry; valid only while the mapping is open
+    struct DerivedTextureView {
+        const DerivedTextureHeader* header = nullptr;
+        const DerivedTextureLevel* levels = nullptr;
+        const unsigned char* data = nullptr;
+    };
+
+    class DerivedDataCache {
+    public:
+        // Hashes the source file with the kind, target and cache version; 0 when the source cannot be read
+        static uint64_t computeKey(const std::string& sourcePath, DerivedDataKind kind, uint32_t target);
+        // Over several sources in order, for entries derived from more than one file
+        static uint64_t computeKey(const std::vector<std::string>& sourcePaths, DerivedDataKind kind, uint32_t target);
+        static std::string getEntryPath(uint64_t key, DerivedDataKind kind);
+
+        // Maps and validates a texture entry; false when it is missing or invalid
+        static bool readTexture(uint64_t key, DerivedDataKind kind, MappedFile& mapping, DerivedTextureView& view);
+        // Entries are written to a temporary file and renamed into place, so concurrent loaders never see a partial
+        // one. Failures are logged and return false, the cache is only an accelerator
+        static bool writeTexture(uint64_t key, DerivedDataKind kind, uint32_t format, uint32_t width, uint32_t height,
+                                 const unsigned char* data, const std::vector<DerivedTextureLevel>& levels);
+        static bool writeMesh(uint64_t key, const std::string& id, const std::vector<MeshBinaryVertex>& vertices,
+                              const std::vector<uint32_t>& indices, const std::vector<MeshBinarySubmesh>& submeshes);
+    };
+
+} // namespace Resources
@@ -1,4 +1,10 @@
 #include "deserialized_scene.hpp"
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+
 namespace glm {
     static vec2 from_json_vec2(const json& j) {
         return vec2{
@@ -34,6 +40,367 @@ namespace glm {
 }
 }
 namespace Resources {
+namespace {
+    // Streamed components come from one monotonic arena per parse instead of a heap allocation each. Every control
+    // block holds a copy of the allocator and with it the arena, so components stay valid after the scene is gone
+    template <typename T>
+    struct ArenaAllocator {
+        using value_type = T;
+
+        explicit ArenaAllocator(std::shared_ptr<std::pmr::monotonic_buffer_resource> resource) : arena(std::move(resource)) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+        T* allocate(size_t count) { return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) {}  // released with the arena
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+        std::shared_ptr<std::pmr::monotonic_buffer_resource> arena;
+    };
+
+    constexpr size_t COMPONENT_ARENA_BLOCK_SIZE = 64 * 1024;
+
+    // Fields of the object being streamed, keyed by their dotted path ("Position.x"). Entries are overwritten in place
+    // from one object to the next so their strings keep their capacity: past the first few objects filling the bag
+    // allocates nothing
+    class FieldBag {
+    public:
+        void clear() {
+            numberCount = 0;
+            stringCount = 0;
+        }
+
+        void addNumber(const std::string& name, double value) {
+            if (numberCount == numbers.size()) {
+                numbers.emplace_back();
+            }
+            numbers[numberCount].first.assign(name);
+            numbers[numberCount].second = value;
+            numberCount++;
+        }
+
+        void addString(const std::string& name, const std::string& value) {
+            if (stringCount == strings.size()) {
+                strings.emplace_back();
+            }
+            strings[stringCount].first.assign(name);
+            strings[stringCount].second.assign(value);
+            stringCount++;
+        }
+
+        float number(const char* key, const char* field = nullptr) const {
+            for (size_t i = 0; i < numberCount; i++) {
+                if (matches(numbers[i].first, key, field)) {
+                    return static_cast<float>(numbers[i].second);
+                }
+            }
+            throw std::runtime_error(std::string("Scene file is missing field ") + key + (field ? std::string(".") + field : ""));
+        }
+
+        bool flag(const char* key) const { return number(key) != 0.0f; }
+
+        glm::vec3 vec3(const char* key) const { return {number(key, "x"), number(key, "y"), number(key, "z")}; }
+        glm::quat quat(const char* key) const { return {number(key, "w"), number(key, "x"), number(key, "y"), number(key, "z")}; }
+
+        // Null when absent
+        const std::string* string(const char* key) const {
+            for (size_t i = 0; i < stringCount; i++) {
+                if (strings[i].first == key) {
+                    return &strings[i].second;
+                }
+            }
+            return nullptr;
+        }
+
+        // Array elements share their array's name and are visited in document order
+        template <typename Visitor>
+        void forEachString(const char* key, Visitor&& visitor) const {
+            for (size_t i = 0; i < stringCount; i++) {
+                if (strings[i].first == key) {
+                    visitor(strings[i].second);
+                }
+            }
+        }
+
+    private:
+        static bool matches(const std::string& name, const char* key, const char* field) {
+            if (field == nullptr) {
+                return name == key;
+            }
+            const size_t keyLength = std::strlen(key);
+            return name.size() == keyLength + 1 + std::strlen(field) &&
+                   name.compare(0, keyLength, key) == 0 &&
+                   name[keyLength] == '.' &&
+                   name.compare(keyLength + 1, std::string::npos, field) == 0;
+        }
+
+        std::vector<std::pair<std::string, double>> numbers;
+        std::vector<std::pair<std::string, std::string>> strings;
+        size_t numberCount = 0;
+        size_t stringCount = 0;
+    };
+
+    // Builds the scene straight from parser events. Depth counts the open containers: the root object is 1, a game
+    // object 3 and a component 5. Components and the environment block are collected into the field bag and turned
+    // into their structs when they close; everything the scene does not use is skipped without being stored.
+    class SceneSaxHandler : public nlohmann::json_sax<json> {
+    public:
+        SceneSaxHandler(DeserializedScene& scene, const std::function<void(DeserializedGameObject&&)>& onGameObject)
+            : scene(scene), onGameObject(onGameObject),
+              arena(std::make_shared<std::pmr::monotonic_buffer_resource>(COMPONENT_ARENA_BLOCK_SIZE)) {}
+
+        bool null() override { return true; }
+        bool boolean(bool value) override { return number(value ? 1.0 : 0.0); }
+        bool number_integer(number_integer_t value) override { return number(static_cast<double>(value)); }
+        bool number_unsigned(number_unsigned_t value) override { return number(static_cast<double>(value)); }
+        bool number_float(number_float_t value, const string_t&) override { return number(value); }
+        bool binary(binary_t&) override { return true; }
+
+        bool string(string_t& value) override {
+            if (bagDepth != 0) {
+                bag.addString(fieldName(), value);
+            } else if (depth == 2 && isArray[2]) {
+                if (std::vector<std::string>* paths = pathList()) {
+                    paths->push_back(value);
+                }
+            }
+            return true;
+        }
+
+        bool key(string_t& value) override {
+            keys[depth].assign(value);
+            if (depth == 1) {
+                section = sectionFor(value);
+            }
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            push(false);
+            if (section == Section::GameObjects && depth == 3) {
+                current = DeserializedGameObject{};
+            } else if (section == Section::GameObjects && depth == 5 && keys[3] == "components") {
+                beginBag();
+            } else if (section == Section::Environment && depth == 2) {
+                beginBag();
+            }
+            return true;
+        }
+
+        bool end_object() override {
+            if (bagDepth != 0 && depth == bagDepth) {
+                bagDepth = 0;
+                if (section == Section::Environment) {
+                    finishEnvironment();
+                } else if (std::shared_ptr<Component> component = finishComponent()) {
+                    current.components.push_back(std::move(component));
+                }
+            } else if (section == Section::GameObjects && depth == 3) {
+                if (onGameObject) {
+                    onGameObject(std::move(current));
+                } else {
+                    scene.gameObjects.push_back(std::move(current));
+                }
+            }
+            depth--;
+            return true;
+        }
+
+        bool start_array(std::size_t) override {
+            push(true);
+            return true;
+        }
+
+        bool end_array() override {
+            depth--;
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& error) override {
+            throw std::runtime_error(std::string("Failed to parse scene file: ") + error.what());
+        }
+
+    private:
+        enum class Section { None, ColorTextures, NormalTextures, Meshes, Materials, GameObjects, Environment };
+
+        static Section sectionFor(const std::string& key) {
+            if (key == "ColorTexturePaths") return Section::ColorTextures;
+            if (key == "NormalTexturePaths") return Section::NormalTextures;
+            if (key == "MeshPaths") return Section::Meshes;
+            if (key == "MaterialPaths") return Section::Materials;
+            if (key == "Gameobjects") return Section::GameObjects;
+            if (key == "EnviromentLighting") return Section::Environment;
+            return Section::None;
+        }
+
+        std::vector<std::string>* pathList() {
+            switch (section) {
+                case Section::ColorTextures: return &scene.colorTexturePaths;
+                case Section::NormalTextures: return &scene.normaltexturePaths;
+                case Section::Meshes: return &scene.meshPaths;
+                case Section::Materials: return &scene.materialPaths;
+                default: return nullptr;
+            }
+        }
+
+        void push(bool array) {
+            depth++;
+            if (depth == keys.size()) {
+                keys.emplace_back();
+                isArray.push_back(array);
+            } else {
+                keys[depth].clear();
+                isArray[depth] = array;
+            }
+        }
+
+        bool number(double value) {
+            if (bagDepth != 0) {
+                bag.addNumber(fieldName(), value);
+            } else if (section == Section::GameObjects && depth == 3 && keys[3] == "EntityID") {
+                current.entityId = static_cast<int>(value);
+            }
+            return true;
+        }
+
+        void beginBag() {
+            bag.clear();
+            bagDepth = depth;
+        }
+
+        // Dotted path of the current value below the bag's object; array levels add nothing, so the elements of
+        // "MaterialIDs" are all named "MaterialIDs"
+        const std::string& fieldName() {
+            name.clear();
+            for (size_t level = bagDepth; level <= depth; level++) {
+                if (isArray[level]) {
+                    continue;
+                }
+                if (!name.empty()) {
+                    name.push_back('.');
+                }
+                name.append(keys[level]);
+            }
+            return name;
+        }
+
+        template <typename T>
+        std::shared_ptr<T> allocate() {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena));
+        }
+
+        std::shared_ptr<Component> finishComponent() {
+            const std::string* type = bag.string("$type");
+            if (type == nullptr) {
+                return nullptr;
+            }
+
+            if (type->find("sTransform") != std::string::npos) {
+                auto transform = allocate<DeserializedTransform>();
+                transform->position = bag.vec3("Position");
+                transform->rotation = bag.quat("Rotation");
+                transform->scale = bag.vec3("Scale");
+                transform->componentType = ComponentType::Transform;
+                return transform;
+            } else if (type->find("sCamera") != std::string::npos) {
+                auto camera = allocate<DeserializedCamera>();
+                camera->fieldOfView = bag.number("FieldOfView");
+                camera->nearPlane = bag.number("NearPlane");
+                camera->farPlane = bag.number("FarPlane");
+                camera->componentType = ComponentType::Camera;
+                return camera;
+            } else if (type->find("sMeshRenderer") != std::string::npos) {
+                auto meshRenderer = allocate<DeserializedMeshRenderer>();
+                const std::string* meshId = bag.string("MeshID");
+                if (meshId == nullptr) {
+                    throw std::runtime_error("Scene file is missing field MeshID");
+                }
+                meshRenderer->meshId = *meshId;
+                meshRenderer->castingShadows = bag.flag("CastingShadows");
+                bag.forEachString("MaterialIDs", [&](const std::string& id) { meshRenderer->materialIds.push_back(id); });
+                meshRenderer->componentType = ComponentType::MeshRenderer;
+                return meshRenderer;
+            } else if (type->find("sDirectionalLight") != std::string::npos) {
+                auto light = allocate<DeserializedDirectionalLight>();
+                glm::vec3 direction = glm::rotate(bag.quat("Direction"), glm::vec3(0.0f, 0.0f, 1.0f));
+                light->direction = glm::vec4(direction, 0.0f);
+                light->color = bag.vec3("Color");
+                light->intensity = bag.number("Intensity");
+                light->isCastingShadows = bag.flag("IsCastingShadows");
+                light->shadowStrength = bag.number("ShadowStrength");
+                light->componentType = ComponentType::DirectionalLight;
+                return light;
+            } else if (type->find("sSpotLight") != std::string::npos) {
+                auto light = allocate<DeserializedSpotLight>();
+                light->intensity = bag.number("Intensity");
+                light->range = bag.number("Range");
+                light->innerCutoff = bag.number("InnerCutoff");
+                light->outerCutoff = bag.number("OuterCutoff");
+                light->color = bag.vec3("Color");
+                light->isCastingShadows = bag.flag("IsCastingShadows");
+                light->shadowStrength = bag.number("ShadowStrength");
+                light->componentType = ComponentType::SpotLight;
+                return light;
+            } else if (type->find("sPointLight") != std::string::npos) {
+                auto light = allocate<DeserializedPointLight>();
+                light->intensity = bag.number("Intensity");
+                light->range = bag.number("Range");
+                light->color = bag.vec3("Color");
+                light->isCastingShadows = bag.flag("IsCastingShadows");
+                light->shadowStrength = bag.number("ShadowStrength");
+                light->componentType = ComponentType::PointLight;
+                return light;
+            }
+            return nullptr;
+        }
+
+        void finishEnvironment() {
+            EnvironmentLighting& environment = scene.environmentLighting;
+            environment.ambientColor = bag.vec3("Color");
+            environment.ambientIntensity = bag.number("AmbientIntensity");
+            environment.reflectionIntensity = bag.number("ReflectionIntensity");
+            size_t face = 0;
+            bag.forEachString("SkyboxPaths", [&](const std::string& path) {
+                if (face < environment.skyboxPaths.size()) {
+                    environment.skyboxPaths[face++] = path;
+                }
+            });
+        }
+
+        DeserializedScene& scene;
+        const std::function<void(DeserializedGameObject&&)>& onGameObject;
+        std::shared_ptr<std::pmr::monotonic_buffer_resource> arena;
+
+        size_t depth = 0;
+        std::vector<std::string> keys{1};   // last key seen in the object at each depth
+        std::vector<bool> isArray{false};
+        Section section = Section::None;
+
+        DeserializedGameObject current;
+        FieldBag bag;
+        size_t bagDepth = 0;                // depth of the object the bag collects, 0 when none
+        std::string name;
+    };
+}
+
+    DeserializedScene DeserializedScene::deserialize_scene_file(const std::string& path,
+                                                                const std::function<void(DeserializedGameObject&&)>& onGameObject) {
+        MappedFile file;
+        if (!file.open(path)) {
+            throw std::runtime_error("Failed to open scene file: " + path);
+        }
+
+        DeserializedScene scene{};
+        SceneSaxHandler handler(scene, onGameObject);
+        const char* begin = static_cast<const char*>(file.data());
+        json::sax_parse(begin, begin + file.size(), &handler);
+        return scene;
+    }
+
     DeserializedScene DeserializedScene::deserialize_scene(const std::string& jsonStr) {
         DeserializedScene scene;
         json j = json::parse(jsonStr);
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <functional>
 #include <iostream>
 #include "external/libraries/json.hpp"
 #include "core.hpp"
@@ -165,6 +166,11 @@ struct DeserializedScene {
             EnvironmentLighting environmentLighting;
 
             static DeserializedScene deserialize_scene(const std::string& jsonStr);
+            // Maps the file and parses it as a SAX stream instead of building a DOM of the whole document. Components
+            // are allocated from an arena per parse and no temporaries outlive the object being parsed. When
+            // onGameObject is set each game object is handed to it as soon as it is complete and gameObjects stays empty
+            static DeserializedScene deserialize_scene_file(const std::string& path,
+                const std::function<void(DeserializedGameObject&&)>& onGameObject = nullptr);
         };
 
 
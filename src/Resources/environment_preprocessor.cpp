@@ -0,0 +1,410 @@
+#include "environment_preprocessor.hpp"
+#include "Engine/cpu_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <iostream>
+
+namespace Resources {
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+    constexpr uint32_t FACE_COUNT = 6;
+    constexpr uint32_t TEXEL_BYTES = 8;                 // RGBA16F
+    constexpr uint32_t ROWS_PER_JOB = 16;
+    // The SH projection reads the first source level at most this size, already box-filtered
+    constexpr uint32_t IRRADIANCE_FACE_SIZE = 64;
+    constexpr size_t IRRADIANCE_BYTES = sizeof(std::array<glm::vec4, 9>);
+
+    struct Direction {
+        float x, y, z;
+    };
+
+    Direction normalize(Direction d) {
+        float length = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+        return {d.x / length, d.y / length, d.z / length};
+    }
+
+    Direction cross(Direction a, Direction b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    // sc and tc in [-1, 1], inverting the cube face selection of the Vulkan spec
+    Direction faceDirection(uint32_t face, float sc, float tc) {
+        switch (face) {
+            case 0: return normalize({1.0f, -tc, -sc});
+            case 1: return normalize({-1.0f, -tc, sc});
+            case 2: return normalize({sc, 1.0f, tc});
+            case 3: return normalize({sc, -1.0f, -tc});
+            case 4: return normalize({sc, -tc, 1.0f});
+            default: return normalize({-sc, -tc, -1.0f});
+        }
+    }
+
+    // u and v in [0, 1]
+    void selectFace(Direction d, uint32_t& face, float& u, float& v) {
+        float ax = std::abs(d.x), ay = std::abs(d.y), az = std::abs(d.z);
+        float sc, tc, ma;
+        if (ax >= ay && ax >= az) {
+            face = d.x >= 0.0f ? 0 : 1;
+            sc = d.x >= 0.0f ? -d.z : d.z;
+            tc = -d.y;
+            ma = ax;
+        } else if (ay >= az) {
+            face = d.y >= 0.0f ? 2 : 3;
+            sc = d.x;
+            tc = d.y >= 0.0f ? d.z : -d.z;
+            ma = ay;
+        } else {
+            face = d.z >= 0.0f ? 4 : 5;
+            sc = d.z >= 0.0f ? d.x : -d.x;
+            tc = -d.y;
+            ma = az;
+        }
+        u = 0.5f * (sc / ma + 1.0f);
+        v = 0.5f * (tc / ma + 1.0f);
+    }
+
+    // Solid angle of the texel at (x, y) on a face of size^2
+    float texelSolidAngle(uint32_t x, uint32_t y, uint32_t size) {
+        auto area = [](float s, float t) { return std::atan2(s * t, std::sqrt(s * s + t * t + 1.0f)); };
+        float inverseSize = 1.0f / static_cast<float>(size);
+        float s0 = 2.0f * x * inverseSize - 1.0f, s1 = s0 + 2.0f * inverseSize;
+        float t0 = 2.0f * y * inverseSize - 1.0f, t1 = t0 + 2.0f * inverseSize;
+        return area(s0, t0) - area(s0, t1) - area(s1, t0) + area(s1, t1);
+    }
+
+    uint16_t floatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000u;
+        int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xffu) - 127 + 15;
+        uint32_t mantissa = bits & 0x7fffffu;
+        if (exponent >= 31) {
+            // Infinity and NaN both clamp to the largest finite half, HDR suns stay bright instead of breaking filtering
+            return static_cast<uint16_t>(sign | 0x7bffu);
+        }
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return static_cast<uint16_t>(sign);
+            }
+            mantissa |= 0x800000u;
+            uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+                half++;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+        uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1fffu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+            half++;   // may carry into the exponent, which is still the correctly rounded value
+        }
+        return static_cast<uint16_t>(sign | std::min(half, 0x7bffu));
+    }
+
+    // Box-filtered RGBA32F chain of the source faces down to 1x1; level 0 points at the decoded faces
+    class SourcePyramid {
+    public:
+        SourcePyramid(const std::vector<const float*>& faces, uint32_t faceSize) {
+            sizes.push_back(faceSize);
+            levels.push_back({});
+            for (uint32_t face = 0; face < FACE_COUNT; face++) {
+                levels[0][face] = faces[face];
+            }
+            while (sizes.back() > 1) {
+                uint32_t sourceSize = sizes.back();
+                uint32_t size = std::max(sourceSize / 2, 1u);
+                std::array<const float*, FACE_COUNT> level{};
+                for (uint32_t face = 0; face < FACE_COUNT; face++) {
+                    const float* source = levels.back()[face];
+                    storage.emplace_back(size_t(size) * size * 4);
+                    float* target = storage.back().data();
+                    for (uint32_t y = 0; y < size; y++) {
+                        for (uint32_t x = 0; x < size; x++) {
+                            uint32_t x0 = std::min(x * 2, sourceSize - 1), x1 = std::min(x * 2 + 1, sourceSize - 1);
+                            uint32_t y0 = std::min(y * 2, sourceSize - 1), y1 = std::min(y * 2 + 1, sourceSize - 1);
+                            for (uint32_t c = 0; c < 4; c++) {
+                                target[(size_t(y) * size + x) * 4 + c] = 0.25f * (
+                                    source[(size_t(y0) * sourceSize + x0) * 4 + c] + source[(size_t(y0) * sourceSize + x1) * 4 + c] +
+                                    source[(size_t(y1) * sourceSize + x0) * 4 + c] + source[(size_t(y1) * sourceSize + x1) * 4 + c]);
+                            }
+                        }
+                    }
+                    level[face] = target;
+                }
+                levels.push_back(level);
+                sizes.push_back(size);
+            }
+        }
+
+        uint32_t getLevelCount() const { return static_cast<uint32_t>(levels.size()); }
+        uint32_t getSize(uint32_t level) const { return sizes[level]; }
+        const float* getFace(uint32_t level, uint32_t face) const { return levels[level][face]; }
+
+        // Bilinear within the face, clamped at its edges
+        void sample(uint32_t level, uint32_t face, float u, float v, float* rgba) const {
+            const uint32_t size = sizes[level];
+            const float* texels = levels[level][face];
+            float x = std::clamp(u * size - 0.5f, 0.0f, static_cast<float>(size - 1));
+            float y = std::clamp(v * size - 0.5f, 0.0f, static_cast<float>(size - 1));
+            uint32_t x0 = static_cast<uint32_t>(x), y0 = static_cast<uint32_t>(y);
+            uint32_t x1 = std::min(x0 + 1, size - 1), y1 = std::min(y0 + 1, size - 1);
+            float fx = x - x0, fy = y - y0;
+            const float* t00 = texels + (size_t(y0) * size + x0) * 4;
+            const float* t10 = texels + (size_t(y0) * size + x1) * 4;
+            const float* t01 = texels + (size_t(y1) * size + x0) * 4;
+            const float* t11 = texels + (size_t(y1) * size + x1) * 4;
+            for (uint32_t c = 0; c < 4; c++) {
+                float top = t00[c] + (t10[c] - t00[c]) * fx;
+                float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+                rgba[c] = top + (bottom - top) * fy;
+            }
+        }
+
+        void sampleLod(Direction d, float lod, float* rgba) const {
+            uint32_t face;
+            float u, v;
+            selectFace(d, face, u, v);
+            lod = std::clamp(lod, 0.0f, static_cast<float>(levels.size() - 1));
+            uint32_t lower = static_cast<uint32_t>(lod);
+            uint32_t upper = std::min(lower + 1, getLevelCount() - 1);
+            float blend = lod - lower;
+            sample(lower, face, u, v, rgba);
+            if (blend > 0.0f && upper != lower) {
+                float next[4];
+                sample(upper, face, u, v, next);
+                for (uint32_t c = 0; c < 4; c++) {
+                    rgba[c] += (next[c] - rgba[c]) * blend;
+                }
+            }
+        }
+
+    private:
+        std::vector<uint32_t> sizes;
+        std::vector<std::array<const float*, FACE_COUNT>> levels;
+        std::vector<std::vector<float>> storage;
+    };
+
+    // Tangent space direction around N = V = (0, 0, 1) and the source level its solid angle covers
+    struct LobeSample {
+        Direction direction;
+        float weight;       // N.L
+        float lod;
+    };
+
+    // Filtered importance sampling of GGX (Karis' split sum with N = V)
+    std::vector<LobeSample> buildLobe(float roughness, uint32_t sourceSize) {
+        const float alpha = roughness * roughness;
+        const float alpha2 = alpha * alpha;
+        const float texelSolidAngle = 4.0f * PI / (FACE_COUNT * float(sourceSize) * float(sourceSize));
+        std::vector<LobeSample> lobe;
+        for (uint32_t i = 0; i < ENVIRONMENT_SPECULAR_SAMPLES; i++) {
+            // Hammersley point set
+            uint32_t bits = i;
+            bits = (bits << 16u) | (bits >> 16u);
+            bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+            bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+            bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+            bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+            float xi1 = float(i) / float(ENVIRONMENT_SPECULAR_SAMPLES);
+            float xi2 = float(bits) * 2.3283064365386963e-10f;
+
+            float phi = 2.0f * PI * xi1;
+            float cosTheta = std::sqrt((1.0f - xi2) / (1.0f + (alpha2 - 1.0f) * xi2));
+            float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+            Direction h{sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+            Direction l{2.0f * cosTheta * h.x, 2.0f * cosTheta * h.y, 2.0f * cosTheta * cosTheta - 1.0f};
+            if (l.z <= 0.0f) {
+                continue;
+            }
+
+            float denominator = cosTheta * cosTheta * (alpha2 - 1.0f) + 1.0f;
+            float distribution = alpha2 / (PI * denominator * denominator);
+            float pdf = distribution * 0.25f;
+            float sampleSolidAngle = 1.0f / (float(ENVIRONMENT_SPECULAR_SAMPLES) * pdf + 1e-6f);
+            float lod = 0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f;
+            lobe.push_back({l, l.z, std::max(lod, 0.0f)});
+        }
+        return lobe;
+    }
+
+    void prefilterRows(const SourcePyramid& source, const std::vector<LobeSample>& lobe, uint32_t face, uint32_t size,
+                       uint32_t firstRow, uint32_t rowCount, uint16_t* target) {
+        for (uint32_t y = firstRow; y < firstRow + rowCount; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                Direction n = faceDirection(face, 2.0f * (x + 0.5f) / size - 1.0f, 2.0f * (y + 0.5f) / size - 1.0f);
+                Direction up = std::abs(n.z) < 0.999f ? Direction{0.0f, 0.0f, 1.0f} : Direction{1.0f, 0.0f, 0.0f};
+                Direction tangent = normalize(cross(up, n));
+                Direction bitangent = cross(n, tangent);
+
+                float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                float totalWeight = 0.0f;
+                for (const LobeSample& sample : lobe) {
+                    Direction l{
+                        tangent.x * sample.direction.x + bitangent.x * sample.direction.y + n.x * sample.direction.z,
+                        tangent.y * sample.direction.x + bitangent.y * sample.direction.y + n.y * sample.direction.z,
+                        tangent.z * sample.direction.x + bitangent.z * sample.direction.y + n.z * sample.direction.z};
+                    float rgba[4];
+                    source.sampleLod(l, sample.lod, rgba);
+                    for (uint32_t c = 0; c < 4; c++) {
+                        sum[c] += rgba[c] * sample.weight;
+                    }
+                    totalWeight += sample.weight;
+                }
+
+                uint16_t* texel = target + (size_t(y) * size + x) * 4;
+                for (uint32_t c = 0; c < 4; c++) {
+                    texel[c] = floatToHalf(totalWeight > 0.0f ? sum[c] / totalWeight : 0.0f);
+                }
+            }
+        }
+    }
+
+    std::array<glm::vec4, 9> projectIrradiance(const SourcePyramid& source) {
+        uint32_t level = 0;
+        while (level + 1 < source.getLevelCount() && source.getSize(level) > IRRADIANCE_FACE_SIZE) {
+            level++;
+        }
+        const uint32_t size = source.getSize(level);
+
+        float coefficients[9][3] = {};
+        for (uint32_t face = 0; face < FACE_COUNT; face++) {
+            const float* texels = source.getFace(level, face);
+            for (uint32_t y = 0; y < size; y++) {
+                for (uint32_t x = 0; x < size; x++) {
+                    Direction d = faceDirection(face, 2.0f * (x + 0.5f) / size - 1.0f, 2.0f * (y + 0.5f) / size - 1.0f);
+                    float solidAngle = texelSolidAngle(x, y, size);
+                    const float basis[9] = {
+                        0.282095f,
+                        0.488603f * d.y, 0.488603f * d.z, 0.488603f * d.x,
+                        1.092548f * d.x * d.y, 1.092548f * d.y * d.z, 0.315392f * (3.0f * d.z * d.z - 1.0f),
+                        1.092548f * d.x * d.z, 0.546274f * (d.x * d.x - d.y * d.y)};
+                    const float* texel = texels + (size_t(y) * size + x) * 4;
+                    for (uint32_t i = 0; i < 9; i++) {
+                        for (uint32_t c = 0; c < 3; c++) {
+                            coefficients[i][c] += texel[c] * basis[i] * solidAngle;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Cosine lobe convolution per band (pi, 2pi/3, pi/4) divided by pi, times the constant of each basis function
+        const float fold[9] = {
+            1.0f * 0.282095f,
+            (2.0f / 3.0f) * 0.488603f, (2.0f / 3.0f) * 0.488603f, (2.0f / 3.0f) * 0.488603f,
+            0.25f * 1.092548f, 0.25f * 1.092548f, 0.25f * 0.315392f, 0.25f * 1.092548f, 0.25f * 0.546274f};
+        std::array<glm::vec4, 9> irradiance{};
+        for (uint32_t i = 0; i < 9; i++) {
+            irradiance[i] = glm::vec4(coefficients[i][0] * fold[i], coefficients[i][1] * fold[i], coefficients[i][2] * fold[i], 0.0f);
+        }
+        return irradiance;
+    }
+}
+
+uint64_t EnvironmentPreprocessor::computeKey(const std::vector<std::string>& facePaths) {
+    if (!DERIVED_DATA_CACHE_ENABLED) {
+        return 0;
+    }
+    // Changing the level or sample count changes the output
+    const uint32_t target = (ENVIRONMENT_SPECULAR_LEVELS << 16) | ENVIRONMENT_SPECULAR_SAMPLES;
+    return DerivedDataCache::computeKey(facePaths, DerivedDataKind::PrefilteredEnvironment, target);
+}
+
+bool EnvironmentPreprocessor::readCached(uint64_t key, PrefilteredEnvironment& environment) {
+    auto mapping = std::make_unique<MappedFile>();
+    DerivedTextureView view;
+    if (!DerivedDataCache::readTexture(key, DerivedDataKind::PrefilteredEnvironment, *mapping, view)) {
+        return false;
+    }
+    const uint32_t levelCount = view.header->levelCount - 1;
+    if (levelCount == 0 || view.header->format != ENVIRONMENT_CUBEMAP_FORMAT || view.levels[levelCount].size != IRRADIANCE_BYTES) {
+        return false;
+    }
+    environment.faceSize = view.header->width;
+    environment.levels.assign(view.levels, view.levels + levelCount);
+    std::memcpy(environment.irradianceSH.data(), view.data + view.levels[levelCount].offset, IRRADIANCE_BYTES);
+    environment.data = view.data;
+    environment.cacheMapping = std::move(mapping);
+    environment.fromCache = true;
+    return true;
+}
+
+bool EnvironmentPreprocessor::writeCached(uint64_t key, const PrefilteredEnvironment& environment) {
+    // build() leaves room for the coefficients after the last level
+    std::vector<DerivedTextureLevel> levels = environment.levels;
+    levels.push_back({levels.back().offset + levels.back().size, IRRADIANCE_BYTES});
+    if (environment.builtData.size() < levels.back().offset + IRRADIANCE_BYTES) {
+        return false;
+    }
+    return DerivedDataCache::writeTexture(key, DerivedDataKind::PrefilteredEnvironment, ENVIRONMENT_CUBEMAP_FORMAT,
+                                          environment.faceSize, environment.faceSize, environment.builtData.data(), levels);
+}
+
+PrefilteredEnvironment EnvironmentPreprocessor::build(const std::vector<const float*>& faces, uint32_t faceSize, ThreadPool& pool) {
+    CPU_PROFILE_ZONE("EnvironmentPreprocessor::build");
+    PrefilteredEnvironment environment;
+    environment.faceSize = faceSize;
+    SourcePyramid source(faces, faceSize);
+
+    const uint32_t levelCount = std::min(ENVIRONMENT_SPECULAR_LEVELS, source.getLevelCount());
+    size_t dataSize = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        uint32_t size = source.getSize(level);
+        environment.levels.push_back({dataSize, uint64_t(size) * size * TEXEL_BYTES * FACE_COUNT});
+        dataSize += environment.levels.back().size;
+    }
+    environment.builtData.resize(dataSize + IRRADIANCE_BYTES);
+
+    std::vector<std::vector<LobeSample>> lobes(levelCount);
+    std::vector<std::future<void>> jobs;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const uint32_t size = source.getSize(level);
+        auto* levelTexels = reinterpret_cast<uint16_t*>(environment.builtData.data() + environment.levels[level].offset);
+        if (level == 0 || levelCount == 1) {
+            // Mirror reflections and the sky itself read the source as is
+            for (uint32_t face = 0; face < FACE_COUNT; face++) {
+                const float* texels = source.getFace(0, face);
+                uint16_t* target = levelTexels + size_t(face) * size * size * 4;
+                jobs.push_back(pool.submit([texels, target, size]() {
+                    for (size_t i = 0; i < size_t(size) * size * 4; i++) {
+                        target[i] = floatToHalf(texels[i]);
+                    }
+                }));
+            }
+            continue;
+        }
+
+        lobes[level] = buildLobe(static_cast<float>(level) / static_cast<float>(levelCount - 1), faceSize);
+        const std::vector<LobeSample>* lobe = &lobes[level];
+        for (uint32_t face = 0; face < FACE_COUNT; face++) {
+            uint16_t* target = levelTexels + size_t(face) * size * size * 4;
+            for (uint32_t row = 0; row < size; row += ROWS_PER_JOB) {
+                uint32_t rowCount = std::min(ROWS_PER_JOB, size - row);
+                jobs.push_back(pool.submit([&source, lobe, face, size, row, rowCount, target]() {
+                    prefilterRows(source, *lobe, face, size, row, rowCount, target);
+                }));
+            }
+        }
+    }
+
+    environment.irradianceSH = projectIrradiance(source);
+    std::memcpy(environment.builtData.data() + dataSize, environment.irradianceSH.data(), IRRADIANCE_BYTES);
+    // Every job has to finish before source goes out of scope, get() rethrows the first failure afterwards
+    for (auto& job : jobs) {
+        job.wait();
+    }
+    for (auto& job : jobs) {
+        job.get();
+    }
+    environment.data = environment.builtData.data();
+    return environment;
+}
+
+} // namespace Resources
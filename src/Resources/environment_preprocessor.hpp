@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core.hpp"
+#include "derived_data_cache.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Resources {
+
+    // The skybox is turned into what the lighting samples instead of being uploaded raw: an RGBA16F cubemap whose
+    // levels are prefiltered with the GGX lobe (level i for roughness i / (levels - 1), the mapping
+    // calculateIBLSpecular uses) and the diffuse irradiance as nine spherical harmonics. Built on the loader's worker
+    // threads and kept in the derived data cache, keyed by the six face files.
+    constexpr bool ENVIRONMENT_PREPROCESSING_ENABLED = true;
+    constexpr uint32_t ENVIRONMENT_SPECULAR_LEVELS = 6;
+    // GGX samples per texel; each is read from the source level matching its solid angle, so few are needed
+    constexpr uint32_t ENVIRONMENT_SPECULAR_SAMPLES = 64;
+    constexpr VkFormat ENVIRONMENT_CUBEMAP_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+    struct PrefilteredEnvironment {
+        uint32_t faceSize = 0;                          // level 0
+        // Level i holds its six faces in cubemap order, offsets relative to data
+        std::vector<DerivedTextureLevel> levels;
+        const unsigned char* data = nullptr;            // into builtData or cacheMapping
+        std::vector<unsigned char> builtData;
+        std::unique_ptr<MappedFile> cacheMapping;
+        // Irradiance / pi with the cosine lobe and the SH basis constants folded in, so the shader evaluates
+        // c0 + c1 y + c2 z + c3 x + c4 xy + c5 yz + c6 (3z^2 - 1) + c7 xz + c8 (x^2 - y^2); w is unused
+        std::array<glm::vec4, 9> irradianceSH{};
+        bool fromCache = false;
+    };
+
+    class EnvironmentPreprocessor {
+    public:
+        // Over the six face files in cubemap order; 0 when one cannot be read or the cache is disabled
+        static uint64_t computeKey(const std::vector<std::string>& facePaths);
+        static bool readCached(uint64_t key, PrefilteredEnvironment& environment);
+        // The cache entry is a texture entry with the SH coefficients as one extra level after the specular chain
+        static bool writeCached(uint64_t key, const PrefilteredEnvironment& environment);
+
+        // faces are six RGBA32F images of faceSize^2 in cubemap order. Rows are spread over pool and the call waits
+        // for them, so it must not run on one of pool's threads
+        static PrefilteredEnvironment build(const std::vector<const float*>& faces, uint32_t faceSize, ThreadPool& pool);
+    };
+
+} // namespace Resources
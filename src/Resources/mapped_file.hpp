@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Resources {
+    // Read-only memory mapping of a whole file, unmapped on destruction
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Returns false when the file is missing, empty or cannot be mapped
+        bool open(const std::string& path);
+        void close();
+
+        const void* data() const { return mappedData; }
+        size_t size() const { return mappedSize; }
+        bool isOpen() const { return mappedData != nullptr; }
+
+    private:
+        const void* mappedData = nullptr;
+        size_t mappedSize = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+} // namespace Resources
@@ -0,0 +1,132 @@
+#include "mesh_binary.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace Resources {
+
+namespace {
+    constexpr uint64_t BLOB_ALIGNMENT = 16;
+
+    uint64_t alignUp(uint64_t value) {
+        return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    // Offset and byte count must both lie inside the file, without overflowing
+    bool rangeInside(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+        return offset <= fileSize && bytes <= fileSize - offset;
+    }
+}
+
+std::string MeshBinary::getBinaryPath(const std::string& jsonPath) {
+    const size_t extension = jsonPath.find_last_of('.');
+    const size_t separator = jsonPath.find_last_of("/\\");
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator)) {
+        return jsonPath + MESH_BINARY_EXTENSION;
+    }
+    return jsonPath.substr(0, extension) + MESH_BINARY_EXTENSION;
+}
+
+bool MeshBinary::parse(const void* data, size_t size, MeshBinaryView& view) {
+    if (data == nullptr || size < sizeof(MeshBinaryHeader)) {
+        return false;
+    }
+
+    const auto* bytes = static_cast<const char*>(data);
+    const auto* header = static_cast<const MeshBinaryHeader*>(data);
+    if (header->magic != MESH_BINARY_MAGIC ||
+        header->version != MESH_BINARY_VERSION ||
+        header->vertexStride != sizeof(MeshBinaryVertex)) {
+        return false;
+    }
+
+    const uint64_t fileSize = size;
+    const uint64_t vertexBytes = uint64_t(header->vertexCount) * sizeof(MeshBinaryVertex);
+    const uint64_t indexBytes = uint64_t(header->indexCount) * sizeof(uint32_t);
+    const uint64_t submeshBytes = uint64_t(header->submeshCount) * sizeof(MeshBinarySubmesh);
+    if (!rangeInside(header->idOffset, header->idLength, fileSize) ||
+        !rangeInside(header->submeshOffset, submeshBytes, fileSize) ||
+        !rangeInside(header->vertexOffset, vertexBytes, fileSize) ||
+        !rangeInside(header->indexOffset, indexBytes, fileSize)) {
+        return false;
+    }
+    if (header->vertexOffset % alignof(MeshBinaryVertex) != 0 ||
+        header->indexOffset % alignof(uint32_t) != 0 ||
+        header->submeshOffset % alignof(MeshBinarySubmesh) != 0) {
+        return false;
+    }
+
+    // Submeshes are drawn without further checks, so they must stay inside the index blob
+    const auto* submeshes = reinterpret_cast<const MeshBinarySubmesh*>(bytes + header->submeshOffset);
+    for (uint32_t i = 0; i < header->submeshCount; i++) {
+        if (uint64_t(submeshes[i].indexStart) + submeshes[i].indexCount > header->indexCount) {
+            return false;
+        }
+    }
+
+    view.header = header;
+    view.id = std::string_view(bytes + header->idOffset, header->idLength);
+    view.submeshes = submeshes;
+    view.vertices = reinterpret_cast<const MeshBinaryVertex*>(bytes + header->vertexOffset);
+    view.indices = reinterpret_cast<const uint32_t*>(bytes + header->indexOffset);
+    return true;
+}
+
+void MeshBinary::write(
+    const std::string& path,
+    const std::string& id,
+    const std::vector<MeshBinaryVertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    const std::vector<MeshBinarySubmesh>& submeshes) {
+
+    if (vertices.size() > std::numeric_limits<uint32_t>::max() ||
+        indices.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Mesh too large for binary container: " + id);
+    }
+
+    MeshBinaryHeader header{};
+    header.magic = MESH_BINARY_MAGIC;
+    header.version = MESH_BINARY_VERSION;
+    header.vertexStride = sizeof(MeshBinaryVertex);
+    header.vertexCount = static_cast<uint32_t>(vertices.size());
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.submeshCount = static_cast<uint32_t>(submeshes.size());
+    header.idLength = static_cast<uint32_t>(id.size());
+
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = vertices.empty() ? 0.0f : std::numeric_limits<float>::max();
+        header.boundsMax[axis] = vertices.empty() ? 0.0f : std::numeric_limits<float>::lowest();
+    }
+    for (const MeshBinaryVertex& vertex : vertices) {
+        for (int axis = 0; axis < 3; axis++) {
+            header.boundsMin[axis] = std::min(header.boundsMin[axis], vertex.position[axis]);
+            header.boundsMax[axis] = std::max(header.boundsMax[axis], vertex.position[axis]);
+        }
+    }
+
+    header.idOffset = sizeof(MeshBinaryHeader);
+    header.submeshOffset = alignUp(header.idOffset + header.idLength);
+    header.vertexOffset = alignUp(header.submeshOffset + submeshes.size() * sizeof(MeshBinarySubmesh));
+    header.indexOffset = alignUp(header.vertexOffset + vertices.size() * sizeof(MeshBinaryVertex));
+    const uint64_t fileSize = header.indexOffset + indices.size() * sizeof(uint32_t);
+
+    std::vector<char> fileData(fileSize, 0);
+    std::copy_n(reinterpret_cast<const char*>(&header), sizeof(header), fileData.data());
+    std::copy(id.begin(), id.end(), fileData.data() + header.idOffset);
+    std::copy_n(reinterpret_cast<const char*>(submeshes.data()), submeshes.size() * sizeof(MeshBinarySubmesh), fileData.data() + header.submeshOffset);
+    std::copy_n(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(MeshBinaryVertex), fileData.data() + header.vertexOffset);
+    std::copy_n(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t), fileData.data() + header.indexOffset);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open mesh binary for writing: " + path);
+    }
+    file.write(fileData.data(), static_cast<std::streamsize>(fileData.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write mesh binary: " + path);
+    }
+}
+
+} // namespace Resources
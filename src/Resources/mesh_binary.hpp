@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Resources {
+
+    // Versioned binary mesh container (.amesh), written next to the Unity JSON mesh by tools/mesh_converter.
+    // Layout: header, mesh id, submesh table, then the vertex and index blobs, each 16-byte aligned so they
+    // can be uploaded straight from a memory mapping.
+    constexpr uint32_t MESH_BINARY_MAGIC = 0x48534D41; // "AMSH" little-endian
+    constexpr uint32_t MESH_BINARY_VERSION = 1;
+    constexpr const char* MESH_BINARY_EXTENSION = ".amesh";
+
+    // Same layout as Rendering::Mesh::Vertex (checked in mesh.cpp), kept free of GLM for the converter
+    struct MeshBinaryVertex {
+        float position[3];
+        float normal[3];
+        float uv[2];
+        float tangent[4];
+    };
+
+    struct MeshBinarySubmesh {
+        uint32_t indexStart;
+        uint32_t indexCount;
+    };
+
+    struct MeshBinaryHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexStride;      // sizeof(MeshBinaryVertex) when written, rejected on mismatch
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t submeshCount;
+        uint32_t idLength;
+        uint32_t reserved;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t idOffset;
+        uint64_t submeshOffset;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+    };
+
+    // Points into the mapped file; valid only while the mapping is open
+    struct MeshBinaryView {
+        const MeshBinaryHeader* header = nullptr;
+        std::string_view id;
+        const MeshBinarySubmesh* submeshes = nullptr;
+        const MeshBinaryVertex* vertices = nullptr;
+        const uint32_t* indices = nullptr;
+    };
+
+    class MeshBinary {
+    public:
+        // Assets/Scene/meshes/Cube_x.json -> Assets/Scene/meshes/Cube_x.amesh
+        static std::string getBinaryPath(const std::string& jsonPath);
+
+        // Validates the container against the data size and fills the view; returns false on any mismatch
+        // (bad magic, older version, different vertex layout, truncated file) so callers can fall back to JSON
+        static bool parse(const void* data, size_t size, MeshBinaryView& view);
+
+        // Writes a container, computing the bounds from the vertex positions; throws on I/O failure
+        static void write(
+            const std::string& path,
+            const std::string& id,
+            const std::vector<MeshBinaryVertex>& vertices,
+            const std::vector<uint32_t>& indices,
+            const std::vector<MeshBinarySubmesh>& submeshes);
+    };
+
+} // namespace Resources
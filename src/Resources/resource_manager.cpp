@@ -1,4 +1,5 @@
 #include "resource_manager.hpp"
+#include "texture_streamer.hpp"
 #include <stdexcept>
 #include <iostream>
 namespace Resources {
@@ -54,42 +55,109 @@ namespace Resources {
     }
 
     void ResourceManager::unloadMesh(const std::string& name) {
-        meshes.erase(name);
+        auto it = meshes.find(name);
+        if (it == meshes.end()) {
+            return;
+        }
+        device.getDeletionQueue().retire(std::move(it->second));
+        meshes.erase(it);
     }
 
     void ResourceManager::unloadTexture(const std::string& name) {
-        textures.erase(name);
+        auto it = textures.find(name);
+        if (it == textures.end()) {
+            return;
+        }
+        detachTextures({it->second.get()});
+        device.getDeletionQueue().retire(std::move(it->second));
+        textures.erase(it);
     }
 
     void ResourceManager::unloadMaterial(const std::string& name) {
-        materials.erase(name);
+        auto it = materials.find(name);
+        if (it == materials.end()) {
+            return;
+        }
+        retireMaterial(std::move(it->second));
+        materials.erase(it);
     }
 
     void ResourceManager::unloadAllMeshes() {
+        for (auto& [name, mesh] : meshes) {
+            device.getDeletionQueue().retire(std::move(mesh));
+        }
         meshes.clear();
     }
 
     void ResourceManager::unloadAllTextures() {
+        std::unordered_set<Rendering::Texture*> unloaded;
+        for (const auto& [name, texture] : textures) {
+            unloaded.insert(texture.get());
+        }
+        // One new set per affected material, however many of its textures go
+        detachTextures(unloaded);
+        for (auto& [name, texture] : textures) {
+            device.getDeletionQueue().retire(std::move(texture));
+        }
         textures.clear();
     }
 
     void ResourceManager::unloadAllMaterials() {
+        for (auto& [name, material] : materials) {
+            retireMaterial(std::move(material));
+        }
         materials.clear();
     }
 
     void ResourceManager::unloadCubemap(const std::string& name) {
-        cubemaps.erase(name);
+        auto it = cubemaps.find(name);
+        if (it == cubemaps.end()) {
+            return;
+        }
+        device.getDeletionQueue().retire(std::move(it->second));
+        cubemaps.erase(it);
     }
 
     void ResourceManager::unloadAllCubemaps() {
+        for (auto& [name, cubemap] : cubemaps) {
+            device.getDeletionQueue().retire(std::move(cubemap));
+        }
         cubemaps.clear();
     }
 
+    void ResourceManager::detachTextures(const std::unordered_set<Rendering::Texture*>& unloaded) {
+        if (textureStreamer) {
+            for (Rendering::Texture* texture : unloaded) {
+                textureStreamer->unregisterTexture(texture);
+            }
+        }
+        DescriptorPool* pool = pbrMaterialDescriptorPool.get();
+        for (auto& [name, material] : materials) {
+            VkDescriptorSet retiredSet = material->dropTextures(unloaded);
+            if (retiredSet != VK_NULL_HANDLE) {
+                device.getDeletionQueue().push([pool, retiredSet]() { pool->freeDescriptors({retiredSet}); });
+            }
+        }
+    }
+
+    void ResourceManager::retireMaterial(std::unique_ptr<Rendering::Material> material) {
+        if (textureStreamer) {
+            textureStreamer->unregisterMaterial(material.get());
+        }
+        // Its destructor frees the material's set, which frames in flight may still have bound
+        device.getDeletionQueue().retire(std::move(material));
+    }
+
     void ResourceManager::cleanup() {
+        // Materials first, so unloading the textures has no material sets left to rewrite
+        unloadAllMaterials();
         unloadAllMeshes();
         unloadAllTextures();
-        unloadAllMaterials();
         unloadAllCubemaps();
+
+        // The material sets go back to the pool owned here, so everything queued above is released now
+        vkDeviceWaitIdle(device.getDevice());
+        device.getDeletionQueue().flush();
         
         // Clean up the static default texture used by all materials
         // This must be done before the device is destroyed
@@ -120,16 +188,18 @@ namespace Resources {
     void ResourceManager::createMaterialDescriptorPool() {
         // Calculate descriptor counts - increased to handle larger scenes
         const uint32_t maxMaterials = 500;
-        const uint32_t maxTextures = maxMaterials * 4; // 4 textures per material
+        // Texture streaming gives a material a new set on every swap and frees the old one a few frames later
+        const uint32_t maxSets = maxMaterials + TEXTURE_STREAMING_DESCRIPTOR_HEADROOM;
+        const uint32_t maxTextures = maxSets * 4; // 4 textures per material
 
         std::vector<VkDescriptorPoolSize> poolSizes = {
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxMaterials},           // Material UBOs
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxSets},                // Material UBOs
             {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxTextures}     // Textures
         };
 
         pbrMaterialDescriptorPool= DescriptorPool::Builder(device)
-            .setMaxSets(maxMaterials)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxMaterials)
+            .setMaxSets(maxSets)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxSets)
             .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxTextures)
             .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
             .build();
@@ -3,6 +3,7 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <unordered_set>
 #include "Rendering/Core/device.hpp"
 #include "Rendering/Resources/mesh.hpp"
 #include "Rendering/Resources/texture.hpp"
@@ -11,6 +12,8 @@
 #include <array>
 using namespace Rendering;
 namespace Resources {
+class TextureStreamer;
+
 class ResourceManager {
 public:
     ResourceManager(Device& device);
@@ -33,7 +36,9 @@ public:
     Rendering::Material* getMaterial(const std::string& name);
     Rendering::Texture* getCubemap(const std::string& name);
     
-    // Resource unloading
+    // Resource unloading. Safe while frames are in flight: the GPU objects are released through the device's
+    // deletion queue, materials using an unloaded texture fall back to the default one, and the texture streamer
+    // forgets what is unloaded. Entities must stop referencing an unloaded mesh or material first
     void unloadMesh(const std::string& name);
     void unloadTexture(const std::string& name);
     void unloadMaterial(const std::string& name);
@@ -45,11 +50,17 @@ public:
     void unloadAllCubemaps();
     void cleanup();
 
+    // Unloading unregisters textures and materials from it
+    void setTextureStreamer(TextureStreamer* streamer) { textureStreamer = streamer; }
+
     DescriptorPool* getPBRMaterialPool() { return pbrMaterialDescriptorPool.get();}
     VkDescriptorSetLayout getPBRDescriptorSetLayout()const{ return pbrDescriptorSetLayout;}
 private:
     void createMaterialDescriptorPool();
     void createPBRDescriptorSetLayout();
+    // Takes the textures out of the streamer and every material, queueing the replaced material sets for freeing
+    void detachTextures(const std::unordered_set<Rendering::Texture*>& unloaded);
+    void retireMaterial(std::unique_ptr<Rendering::Material> material);
 
     Device& device;
 
@@ -60,5 +71,6 @@ private:
 
     std::unique_ptr<DescriptorPool> pbrMaterialDescriptorPool{nullptr};
     VkDescriptorSetLayout pbrDescriptorSetLayout{VK_NULL_HANDLE};
+    TextureStreamer* textureStreamer{nullptr};
 };
 } // namespace Resources
\ No newline at end of file
@@ -11,115 +11,155 @@
 #if defined(_MSC_VER)
 #pragma warning(pop)
 #endif
+#include "Engine/cpu_profiler.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <iostream>
+#include <iomanip>
 #include <filesystem>
 #include <future>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <unordered_set>
 #include <ktx.h>
 #include <ktxvulkan.h>
 
 namespace Resources {
 
+namespace {
+    using LoadClock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(LoadClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(LoadClock::now() - start).count();
+    }
+}
+
 SceneLoader::SceneLoader(
     ResourceManager& resManager,
-    Rendering::Device& dev)
+    Rendering::Device& dev,
+    Rendering::UploadManager& uploads,
+    TextureStreamer* streamer)
     : resourceManager{resManager},
       device{dev},
+      uploadManager{uploads},
+      textureStreamer{streamer},
       descriptorPool{*resManager.getPBRMaterialPool()},
       ecsManager{ECS::ECSManager::getInstance()} {}
 
-bool SceneLoader::loadSkyboxCubemap(const std::array<std::string,6> texturesDirs) {
+SceneLoader::DecodedSkyboxFace SceneLoader::decodeSkyboxFace(const std::string& path) {
+    CPU_PROFILE_ZONE("SceneLoader::decodeSkyboxFace");
+    auto decodeStart = LoadClock::now();
+    DecodedSkyboxFace decoded;
+    int channels;
+    decoded.pixels.reset(stbi_loadf(path.c_str(), &decoded.width, &decoded.height, &channels, 4)); // Force RGBA
+    if (!decoded.pixels) {
+        decoded.error = path + " - " + stbi_failure_reason();
+    }
+    decoded.decodeMs = elapsedMs(decodeStart);
+    return decoded;
+}
+
+SceneLoader::LoadStageTiming SceneLoader::loadSkyboxCubemap(std::vector<std::future<DecodedSkyboxFace>>& faceJobs, PrefilteredEnvironment& environment,
+                                                           uint64_t environmentKey, ThreadPool& workerPool) {
+    CPU_PROFILE_ZONE("SceneLoader::loadSkyboxCubemap");
+    LoadStageTiming timing{"Skybox"};
+    auto stageStart = LoadClock::now();
+    hasSkyboxIrradiance = false;
     try {
-        // Unity skybox order: [FrontTex (Z), BackTex (-Z), RightTex (X), LeftTex (-X), UpTex (Y), DownTex (-Y)]
-        // Vulkan cubemap order: [+X, -X, +Y, -Y, +Z, -Z]
-        
-        // Define the face order mapping from Unity to Vulkan
-        const std::array<int, 6> unityToVulkanFaceMap = {
-            3,  // Unity RightTex (X) -> Vulkan +X (face 0)
-            2,  // Unity LeftTex (-X) -> Vulkan -X (face 1)
-            4,  // Unity UpTex (Y) -> Vulkan +Y (face 2)
-            5,  // Unity DownTex (-Y) -> Vulkan -Y (face 3)
-            0,  // Unity FrontTex (Z) -> Vulkan +Z (face 4)
-            1   // Unity BackTex (-Z) -> Vulkan -Z (face 5)
-        };
-
-        // Load the cubemap using stb_image for HDR
-        std::vector<float*> faceData(6, nullptr);
-        std::vector<int> widths(6, 0), heights(6, 0);
-        bool allLoaded = true;
-
-        // Load all textures in Unity order, but store them in the remapped positions
-        for (int vulkanFaceIdx = 0; vulkanFaceIdx < 6; vulkanFaceIdx++) {
-            // Get the Unity face index for this Vulkan face
-            int unityFaceIdx = unityToVulkanFaceMap[vulkanFaceIdx];
-            
-            // Load the texture from the Unity-ordered path
-            const auto& path = texturesDirs[unityFaceIdx];
-            int width, height, channels;
-            float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 4); // Force RGBA
-            
-            if (!data) {
-                std::cout << "Failed to load face " << vulkanFaceIdx << " (Unity face " << unityFaceIdx 
-                         << "): " << path << " - " << stbi_failure_reason() << std::endl;
-                allLoaded = false;
-                break;
+        if (!environment.fromCache) {
+            // Faces were queued in Vulkan cubemap order: [+X, -X, +Y, -Y, +Z, -Z]
+            std::vector<DecodedSkyboxFace> faces;
+            for (auto& job : faceJobs) {
+                faces.push_back(job.get());
+                timing.workerMs += faces.back().decodeMs;
             }
 
-            // Store in the Vulkan face position
-            faceData[vulkanFaceIdx] = data;
-            widths[vulkanFaceIdx] = width;
-            heights[vulkanFaceIdx] = height;
-        }
-
-        // Check if all faces were loaded successfully
-        if (!allLoaded) {
-            // Cleanup any loaded faces
-            for (auto data : faceData) {
-                if (data) stbi_image_free(data);
+            // Check if all faces were loaded successfully
+            for (size_t face = 0; face < faces.size(); face++) {
+                if (!faces[face].pixels) {
+                    std::cout << "Failed to load face " << face << ": " << faces[face].error << std::endl;
+                    throw std::runtime_error("Failed to load all cubemap faces");
+                }
             }
-            throw std::runtime_error("Failed to load all cubemap faces");
-        }
 
-        // Verify all faces have the same dimensions
-        int size = widths[0];
-        for (size_t i = 1; i < 6; i++) {
-            if (widths[i] != size || heights[i] != size) {
-                throw std::runtime_error("All cubemap faces must be square and the same size");
+            // Verify all faces have the same dimensions
+            int size = faces[0].width;
+            for (size_t i = 0; i < faces.size(); i++) {
+                if (faces[i].width != size || faces[i].height != size) {
+                    throw std::runtime_error("All cubemap faces must be square and the same size");
+                }
             }
-        }
-
-        // Create vector of face data pointers for texture creation
-        std::vector<const void*> facePointers;
-        for (auto data : faceData) {
-            facePointers.push_back(data);
-        }
 
-        // Create the cubemap texture
-        auto cubemapTexture = Rendering::Texture::createCubemap(
-            device,
-            size,
-            VK_FORMAT_R32G32B32A32_SFLOAT, 
-            facePointers
-        );
+            if (!ENVIRONMENT_PREPROCESSING_ENABLED) {
+                // Create vector of face data pointers for texture creation
+                std::vector<const void*> facePointers;
+                for (const auto& face : faces) {
+                    facePointers.push_back(face.pixels.get());
+                }
 
-        // Clean up the loaded face data
-        for (auto data : faceData) {
-            stbi_image_free(data);
+                // The faces are copied into staging memory here, so the decoded images can be released right after
+                auto cubemapTexture = Rendering::Texture::createCubemap(
+                    device,
+                    uploadManager,
+                    size,
+                    VK_FORMAT_R32G32B32A32_SFLOAT, 
+                    facePointers
+                );
+                resourceManager.addCubemap("skybox", std::move(cubemapTexture));
+                std::cout << "Skybox loaded successfully" << std::endl;
+            } else {
+                std::vector<const float*> facePointers;
+                for (const auto& face : faces) {
+                    facePointers.push_back(face.pixels.get());
+                }
+                auto prefilterStart = LoadClock::now();
+                environment = EnvironmentPreprocessor::build(facePointers, static_cast<uint32_t>(size), workerPool);
+                std::cout << "Skybox prefiltered into " << environment.levels.size() << " levels and SH9 irradiance in "
+                          << std::fixed << std::setprecision(1) << elapsedMs(prefilterStart) << " ms" << std::defaultfloat << std::endl;
+                if (environmentKey != 0) {
+                    EnvironmentPreprocessor::writeCached(environmentKey, environment);
+                }
+            }
         }
 
-        // Add the cubemap to the resource manager
-        resourceManager.addCubemap("skybox", std::move(cubemapTexture));
-        
-        std::cout << "Skybox loaded successfully" << std::endl;
-        return true;
+        // Empty when preprocessing is disabled and the raw faces were uploaded above
+        if (!environment.levels.empty()) {
+            std::vector<VkDeviceSize> levelOffsets;
+            for (const DerivedTextureLevel& level : environment.levels) {
+                levelOffsets.push_back(level.offset);
+            }
+            const VkDeviceSize dataSize = environment.levels.back().offset + environment.levels.back().size;
+            auto cubemapTexture = Rendering::Texture::createCubemap(
+                device,
+                uploadManager,
+                environment.faceSize,
+                ENVIRONMENT_CUBEMAP_FORMAT,
+                static_cast<uint32_t>(environment.levels.size()),
+                environment.data,
+                dataSize,
+                levelOffsets
+            );
+            resourceManager.addCubemap("skybox", std::move(cubemapTexture));
+            skyboxIrradianceSH = environment.irradianceSH;
+            hasSkyboxIrradiance = true;
 
+            std::cout << "Skybox loaded " << (environment.fromCache ? "from the derived data cache" : "successfully") << ": "
+                      << environment.levels.size() << " RGBA16F levels, " << dataSize / (1024 * 1024) << " MB" << std::endl;
+        }
     } catch (const std::exception& e) {
         std::cerr << "Failed to load skybox cubemap: " << e.what() << std::endl;
-        return false;
     }
+    preparedResources++;
+    timing.wallMs = elapsedMs(stageStart);
+    return timing;
 }
 
 void SceneLoader::createSkyboxEntity() {
@@ -131,80 +171,413 @@ void SceneLoader::createSkyboxEntity() {
     std::cout << "Skybox created" << std::endl;
 }
 
-bool SceneLoader::loadUnityScene(const std::string& jsonPath) {
-    std::cout << "\n=== Starting Unity Scene Loading: " << jsonPath << " ===" << std::endl;
+SceneLoader::LoadStageTiming SceneLoader::parseScene(const std::string& jsonPath, DeserializedScene& scene) {
+    CPU_PROFILE_ZONE("SceneLoader::parseScene");
+    auto stageStart = LoadClock::now();
     
-    // Read and parse JSON file
-    std::ifstream file(jsonPath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open Unity scene file: " + jsonPath);
-    }
-
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-   
+    // Streamed from the mapped file, the document is never held as a string or DOM
     std::cout << "Parsing scene JSON file..." << std::endl;
-    DeserializedScene scene = DeserializedScene::deserialize_scene(buffer.str());
+    scene = DeserializedScene::deserialize_scene_file(jsonPath);
     std::cout << "Scene parsed successfully with:" << std::endl;
     std::cout << "  " << scene.meshPaths.size() << " meshes" << std::endl;
     std::cout << "  " << scene.colorTexturePaths.size() + scene.normaltexturePaths.size() << " textures" << std::endl;
     std::cout << "  " << scene.materialPaths.size() << " materials" << std::endl;
     std::cout << "  " << scene.gameObjects.size() << " game objects" << std::endl;
 
+    objectCount = static_cast<uint32_t>(scene.materialPaths.size() + scene.gameObjects.size());
+    return {"Scene JSON", elapsedMs(stageStart), 0.0};
+}
+
+uint32_t SceneLoader::prepareResources(const DeserializedScene& scene, std::vector<DecodedMaterial>& materials, std::vector<LoadStageTiming>& stages) {
+    CPU_PROFILE_ZONE("SceneLoader::prepareResources");
+    // Every file read and decode is queued up front; the loading thread then consumes the results in order and
+    // records their uploads while the pool keeps decoding the rest
+    ThreadPool workerPool;
+
+    std::vector<std::future<DecodedMesh>> meshJobs;
+    for (const auto& meshPath : scene.meshPaths) {
+        meshJobs.push_back(workerPool.submit([meshPath]() { return decodeMesh(meshPath); }));
+    }
+
+    std::vector<std::future<DecodedTexture>> colorTextureJobs;
+    for (const auto& path : scene.colorTexturePaths) {
+        colorTextureJobs.push_back(workerPool.submit([path]() { return decodeTexture(path, KTX_TTF_BC7_RGBA, false, VK_FORMAT_R8G8B8A8_SRGB); }));
+    }
+    std::vector<std::future<DecodedTexture>> normalTextureJobs;
+    for (const auto& path : scene.normaltexturePaths) {
+        normalTextureJobs.push_back(workerPool.submit([path]() { return decodeTexture(path, KTX_TTF_BC5_RG, false, VK_FORMAT_R8G8B8A8_UNORM); }));
+    }
+
+    // Unity skybox order: [FrontTex (Z), BackTex (-Z), RightTex (X), LeftTex (-X), UpTex (Y), DownTex (-Y)]
+    // Vulkan cubemap order: [+X, -X, +Y, -Y, +Z, -Z]
+    const std::array<int, 6> unityToVulkanFaceMap = {
+        3,  // Unity RightTex (X) -> Vulkan +X (face 0)
+        2,  // Unity LeftTex (-X) -> Vulkan -X (face 1)
+        4,  // Unity UpTex (Y) -> Vulkan +Y (face 2)
+        5,  // Unity DownTex (-Y) -> Vulkan -Y (face 3)
+        0,  // Unity FrontTex (Z) -> Vulkan +Z (face 4)
+        1   // Unity BackTex (-Z) -> Vulkan -Z (face 5)
+    };
+    std::vector<std::string> skyboxFacePaths;
+    for (int vulkanFaceIdx = 0; vulkanFaceIdx < 6; vulkanFaceIdx++) {
+        skyboxFacePaths.push_back(scene.environmentLighting.skyboxPaths[unityToVulkanFaceMap[vulkanFaceIdx]]);
+    }
+    // A prefiltered skybox in the derived data cache spares decoding the faces at all
+    PrefilteredEnvironment environment;
+    const uint64_t environmentKey = ENVIRONMENT_PREPROCESSING_ENABLED ? EnvironmentPreprocessor::computeKey(skyboxFacePaths) : 0;
+    std::vector<std::future<DecodedSkyboxFace>> skyboxFaceJobs;
+    if (environmentKey == 0 || !EnvironmentPreprocessor::readCached(environmentKey, environment)) {
+        for (const std::string& path : skyboxFacePaths) {
+            skyboxFaceJobs.push_back(workerPool.submit([path]() { return decodeSkyboxFace(path); }));
+        }
+    }
+
+    std::vector<std::future<DecodedMaterial>> materialJobs;
+    for (const auto& materialPath : scene.materialPaths) {
+        materialJobs.push_back(workerPool.submit([materialPath]() { return decodeMaterial(materialPath); }));
+    }
+    // The skybox counts as one resource
+    resourceCount = static_cast<uint32_t>(meshJobs.size() + colorTextureJobs.size() + normalTextureJobs.size() + 1);
+
     //Cache all resources
-    std::cout << "\nStarting resource caching..." << std::endl;
-    cacheMeshes(scene.meshPaths);
-    cacheCompressedTextures(scene.colorTexturePaths,KTX_TTF_BC7_RGBA, "Color textures");
-    cacheCompressedTextures(scene.normaltexturePaths,KTX_TTF_BC5_RG, "Normal textures");
-    cacheTextures(scene.colorTexturePaths,VK_FORMAT_R8G8B8A8_SRGB);
-    cacheTextures(scene.normaltexturePaths,VK_FORMAT_R8G8B8A8_UNORM);
-    loadSkyboxCubemap(scene.environmentLighting.skyboxPaths);
-    cacheMaterials(scene.materialPaths); 
+    std::cout << "\nStarting resource caching on " << workerPool.getThreadCount() << " worker threads..." << std::endl;
+    stages.push_back(cacheMeshes(meshJobs));
+    stages.push_back(cacheTextures(colorTextureJobs, VK_FORMAT_R8G8B8A8_SRGB, "Color textures"));
+    stages.push_back(cacheTextures(normalTextureJobs, VK_FORMAT_R8G8B8A8_UNORM, "Normal textures"));
+    stages.push_back(loadSkyboxCubemap(skyboxFaceJobs, environment, environmentKey, workerPool));
+    stages.push_back(cacheMaterialTextures(materialJobs, workerPool, materials));
+
+    auto stageStart = LoadClock::now();
+    {
+        CPU_PROFILE_ZONE("Upload completion");
+        uploadManager.finish();
+    }
+    stages.push_back({"Upload completion", elapsedMs(stageStart), 0.0});
     std::cout << "Resource caching completed" << std::endl;
+    return workerPool.getThreadCount();
+}
+
+bool SceneLoader::loadUnityScene(const std::string& jsonPath) {
+    std::cout << "\n=== Starting Unity Scene Loading: " << jsonPath << " ===" << std::endl;
+    auto loadStart = LoadClock::now();
+    std::vector<LoadStageTiming> stages;
+
+    DeserializedScene scene;
+    stages.push_back(parseScene(jsonPath, scene));
+
+    const Rendering::UploadManager::Stats uploadStatsBefore = uploadManager.getStats();
+    std::vector<DecodedMaterial> materials;
+    uint32_t workerCount = prepareResources(scene, materials, stages);
+    registerStreamedTextures();
+
+    auto stageStart = LoadClock::now();
+    size_t currentMaterial = 0;
+    for (const auto& material : materials) {
+        createMaterial(material);
+        currentMaterial++;
+        std::cout << "\rMaterials cached " << currentMaterial << "/" << materials.size() << std::flush;
+    }
+    std::cout << std::endl;
+    stages.push_back({"Materials", elapsedMs(stageStart), 0.0});
 
     //Create entities
     std::cout << "\nCreating entities from scene data..." << std::endl;
-    size_t totalEntities = scene.gameObjects.size();
-    size_t currentEntity = 0;
-    for (const auto& gameObject : scene.gameObjects) {
-        createEntityFromUnityData(gameObject);
-        currentEntity++;
-        std::cout << "\rEntities created " << currentEntity << "/" << totalEntities << std::flush;
+    stageStart = LoadClock::now();
+    const ECS::EntityID firstEntity = ecsManager.createEntities(scene.gameObjects.size());
+    EntityBatch batch;
+    for (size_t i = 0; i < scene.gameObjects.size(); i++) {
+        appendToBatch(scene.gameObjects[i], firstEntity + static_cast<ECS::EntityID>(i), batch);
     }
-    std::cout << std::endl;
+    stages.push_back({"Entities", elapsedMs(stageStart), 0.0});
+    std::cout << "Entities created " << scene.gameObjects.size() << std::endl;
     
     std::cout << "\nSetting up scene hierarchy and lighting..." << std::endl;
-    createScene(scene);
-    std::cout << "Scene setup completed" << std::endl;
-    
+    stageStart = LoadClock::now();
+    commitBatch(batch);
+    applyEnvironmentLighting(scene);
     createSkyboxEntity();
+    stages.push_back({"Scene build", elapsedMs(stageStart), 0.0});
+    std::cout << "Scene setup completed" << std::endl;
+
+    // The manager outlives the loader, so only this load's share of its counters is reported
+    Rendering::UploadManager::Stats uploadStats = uploadManager.getStats();
+    uploadStats.submitCount -= uploadStatsBefore.submitCount;
+    uploadStats.bytesStaged -= uploadStatsBefore.bytesStaged;
+    uploadStats.waitMs -= uploadStatsBefore.waitMs;
+    printLoadReport(stages, uploadStats, elapsedMs(loadStart), workerCount);
     std::cout << "\n=== Unity Scene Loading Completed Successfully ===" << std::endl;
     return true;
 }
 
-std::future<bool> SceneLoader::loadUnitySceneAsync(const std::string& jsonPath) {
-    // Launch loading in background thread using std::async
-    return std::async(std::launch::async, [this, jsonPath]() {
-        try {
-            return loadUnityScene(jsonPath);
-        } catch (const std::exception& e) {
-            std::cerr << "Async scene loading failed: " << e.what() << std::endl;
-            return false;
+void SceneLoader::beginUnitySceneLoad(const std::string& jsonPath) {
+    if (phase != LoadPhase::Idle) {
+        throw std::runtime_error("Scene loader is already loading a scene");
+    }
+    std::cout << "\n=== Starting incremental Unity Scene Loading: " << jsonPath << " ===" << std::endl;
+    incrementalLoad = std::make_unique<IncrementalLoad>();
+    incrementalLoad->start = LoadClock::now();
+    phase = LoadPhase::Preparing;
+
+    IncrementalLoad* load = incrementalLoad.get();
+    prepareJob = std::async(std::launch::async, [this, load, jsonPath]() {
+        CPU_PROFILE_THREAD("Scene loader");
+        load->stages.push_back(parseScene(jsonPath, load->scene));
+        load->parsed.store(true, std::memory_order_release);
+
+        const Rendering::UploadManager::Stats uploadStatsBefore = uploadManager.getStats();
+        load->workerCount = prepareResources(load->scene, load->materials, load->stages);
+        load->uploadStats = uploadManager.getStats();
+        load->uploadStats.submitCount -= uploadStatsBefore.submitCount;
+        load->uploadStats.bytesStaged -= uploadStatsBefore.bytesStaged;
+        load->uploadStats.waitMs -= uploadStatsBefore.waitMs;
+    });
+}
+
+bool SceneLoader::commitPending(double budgetMs) {
+    CPU_PROFILE_ZONE("SceneLoader::commitPending");
+    if (phase == LoadPhase::Finished) {
+        return true;
+    }
+    if (phase == LoadPhase::Idle) {
+        return false;
+    }
+
+    IncrementalLoad& load = *incrementalLoad;
+    auto sliceStart = LoadClock::now();
+    load.commitFrames++;
+    // At least one item goes through per call so a tiny budget cannot stall the load
+    bool committedAny = false;
+    auto budgetLeft = [&]() { return !committedAny || elapsedMs(sliceStart) < budgetMs; };
+
+    if (!load.resourcesReady && prepareJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        prepareJob.get();
+        load.resourcesReady = true;
+        phase = LoadPhase::Committing;
+        // The loader thread is done with the streamer's inputs and the cubemap, hand them to this thread
+        registerStreamedTextures();
+        applyEnvironmentLighting(load.scene);
+        createSkyboxEntity();
+        committedAny = true;
+    }
+
+    if (load.parsed.load(std::memory_order_acquire)) {
+        const auto& gameObjects = load.scene.gameObjects;
+        if (!load.entitiesReserved) {
+            load.firstEntity = ecsManager.createEntities(gameObjects.size());
+            load.entitiesReserved = true;
+        }
+
+        // Camera and lights reference no resources, so the view is up before the loader thread is done
+        for (; load.nextObject < gameObjects.size() && budgetLeft(); load.nextObject++) {
+            if (hasMeshRenderer(gameObjects[load.nextObject])) {
+                continue;
+            }
+            appendToBatch(gameObjects[load.nextObject], load.firstEntity + static_cast<ECS::EntityID>(load.nextObject), load.batch);
+            committedObjects++;
+            committedAny = true;
         }
+
+        if (load.resourcesReady) {
+            for (; load.nextMaterial < load.materials.size() && budgetLeft(); load.nextMaterial++) {
+                createMaterial(load.materials[load.nextMaterial]);
+                committedObjects++;
+                committedAny = true;
+            }
+
+            if (load.nextMaterial == load.materials.size()) {
+                for (; load.nextRenderer < gameObjects.size() && budgetLeft(); load.nextRenderer++) {
+                    if (!hasMeshRenderer(gameObjects[load.nextRenderer])) {
+                        continue;
+                    }
+                    appendToBatch(gameObjects[load.nextRenderer], load.firstEntity + static_cast<ECS::EntityID>(load.nextRenderer), load.batch);
+                    committedObjects++;
+                    committedAny = true;
+                }
+            }
+        }
+        commitBatch(load.batch);
+    }
+    load.commitMs += elapsedMs(sliceStart);
+
+    if (!load.resourcesReady || load.nextObject < load.scene.gameObjects.size() ||
+        load.nextMaterial < load.materials.size() || load.nextRenderer < load.scene.gameObjects.size()) {
+        return false;
+    }
+
+    // Slices smaller than the tree were inserted one by one, which only splits the root
+    auto rebuildStart = LoadClock::now();
+    {
+        CPU_PROFILE_ZONE("Scene::rebuildSpatialIndex");
+        Scene::Scene::getInstance().rebuildSpatialIndex();
+    }
+    load.commitMs += elapsedMs(rebuildStart);
+
+    phase = LoadPhase::Finished;
+    load.stages.push_back({"Commit (" + std::to_string(load.commitFrames) + " frames)", load.commitMs, 0.0});
+    printLoadReport(load.stages, load.uploadStats, elapsedMs(load.start), load.workerCount);
+    std::cout << "\n=== Unity Scene Loading Completed Successfully ===" << std::endl;
+    incrementalLoad.reset();
+    return true;
+}
+
+SceneLoader::LoadProgress SceneLoader::getProgress() const {
+    LoadProgress progress;
+    progress.phase = phase;
+    progress.preparedResources = preparedResources;
+    progress.resourceCount = resourceCount;
+    progress.committedObjects = committedObjects;
+    progress.objectCount = objectCount;
+    return progress;
+}
+
+bool SceneLoader::hasMeshRenderer(const DeserializedGameObject& gameObject) {
+    return std::any_of(gameObject.components.begin(), gameObject.components.end(), [](const auto& component) {
+        return component->componentType == ComponentType::MeshRenderer;
     });
 }
 
-void SceneLoader::cacheMeshes(const std::vector<std::string>& meshPaths) {
-    size_t total = meshPaths.size();
+void SceneLoader::printLoadReport(const std::vector<LoadStageTiming>& stages, const Rendering::UploadManager::Stats& uploadStats, double totalMs, uint32_t workerCount) {
+    std::ios_base::fmtflags previousFlags = std::cout.flags();
+    std::streamsize previousPrecision = std::cout.precision();
+
+    std::cout << "\n--- Load time report (" << workerCount << " worker threads) ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& stage : stages) {
+        std::cout << "  " << std::left << std::setw(20) << stage.name << std::right << std::setw(10) << stage.wallMs << " ms";
+        if (stage.workerMs > 0.0) {
+            std::cout << "   (decode " << stage.workerMs << " ms across workers)";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "  GPU uploads: " << uploadStats.submitCount << " submissions, "
+              << static_cast<double>(uploadStats.bytesStaged) / (1024.0 * 1024.0) << " MB staged, "
+              << uploadStats.waitMs << " ms waiting on the upload timeline" << std::endl;
+    std::cout << "  Total " << totalMs << " ms" << std::endl;
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+SceneLoader::DecodedMesh SceneLoader::decodeMesh(const std::string& meshPath) {
+    CPU_PROFILE_ZONE("SceneLoader::decodeMesh");
+    auto decodeStart = LoadClock::now();
+    DecodedMesh decoded;
+    if (decodeBinaryMesh(meshPath, decoded)) {
+        decoded.fromBinary = true;
+        decoded.valid = true;
+    } else {
+        // No converted .amesh next to the JSON: the derived data cache holds the same container, keyed by content
+        uint64_t cacheKey = DERIVED_DATA_CACHE_ENABLED ? DerivedDataCache::computeKey(meshPath, DerivedDataKind::Mesh, MESH_BINARY_VERSION) : 0;
+        if (cacheKey != 0 && mapBinaryMesh(DerivedDataCache::getEntryPath(cacheKey, DerivedDataKind::Mesh), decoded)) {
+            decoded.fromCache = true;
+            decoded.valid = true;
+        } else {
+            decoded.valid = decodeJsonMesh(meshPath, decoded);
+            if (decoded.valid && cacheKey != 0) {
+                cacheDecodedMesh(cacheKey, decoded);
+            }
+        }
+    }
+    decoded.decodeMs = elapsedMs(decodeStart);
+    return decoded;
+}
+
+SceneLoader::LoadStageTiming SceneLoader::cacheMeshes(std::vector<std::future<DecodedMesh>>& meshJobs) {
+    CPU_PROFILE_ZONE("SceneLoader::cacheMeshes");
+    LoadStageTiming timing{"Meshes"};
+    auto stageStart = LoadClock::now();
+    size_t total = meshJobs.size();
     size_t current = 0;
+    size_t binaryCount = 0;
+    size_t cachedCount = 0;
     
-    for (const auto& meshPath : meshPaths) {
+    for (auto& job : meshJobs) {
+        DecodedMesh decoded = job.get();
+        current++;
+        preparedResources++;
+        timing.workerMs += decoded.decodeMs;
+        if (!decoded.valid) {
+            continue;
+        }
+
+        // Binary meshes are staged straight from the mapping, which is released once the copy is recorded
+        auto mesh = std::make_unique<Rendering::Mesh>(
+            device,
+            uploadManager,
+            decoded.vertexData, decoded.vertexCount,
+            decoded.indexData, decoded.indexCount,
+            decoded.boundsMin, decoded.boundsMax,
+            decoded.id);
+        for (const auto& submesh : decoded.submeshes) {
+            mesh->addSubmesh(submesh.indexStart, submesh.indexCount);
+        }
+
+        resourceManager.addMesh(decoded.id, std::move(mesh));
+        if (decoded.fromBinary) {
+            binaryCount++;
+        }
+        if (decoded.fromCache) {
+            cachedCount++;
+        }
+        std::cout << "\rMeshes loaded " << current << "/" << total << std::flush;       
+    }
+    std::cout << std::endl;
+    std::cout << "  " << binaryCount << "/" << total << " meshes loaded from " << MESH_BINARY_EXTENSION << " files" << std::endl;
+    if (cachedCount > 0) {
+        std::cout << "  " << cachedCount << "/" << total << " meshes read from the derived data cache" << std::endl;
+    }
+    timing.wallMs = elapsedMs(stageStart);
+    return timing;
+}
+
+bool SceneLoader::decodeBinaryMesh(const std::string& meshPath, DecodedMesh& decoded) {
+    const std::string binaryPath = MeshBinary::getBinaryPath(meshPath);
+    std::error_code error;
+    if (!std::filesystem::exists(binaryPath, error)) {
+        return false;
+    }
+    // A binary older than its JSON source is stale; rerun tools/mesh_converter to refresh it
+    if (std::filesystem::exists(meshPath, error) &&
+        std::filesystem::last_write_time(binaryPath, error) < std::filesystem::last_write_time(meshPath, error)) {
+        return false;
+    }
+
+    return mapBinaryMesh(binaryPath, decoded);
+}
+
+bool SceneLoader::mapBinaryMesh(const std::string& binaryPath, DecodedMesh& decoded) {
+    auto mappedFile = std::make_unique<MappedFile>();
+    MeshBinaryView view;
+    if (!mappedFile->open(binaryPath)) {
+        return false;
+    }
+    if (!MeshBinary::parse(mappedFile->data(), mappedFile->size(), view)) {
+        std::cerr << "\nIgnoring invalid binary mesh, falling back to JSON: " << binaryPath << std::endl;
+        return false;
+    }
+
+    const MeshBinaryHeader& header = *view.header;
+    decoded.id = std::string(view.id);
+    decoded.vertexData = reinterpret_cast<const Rendering::Mesh::Vertex*>(view.vertices);
+    decoded.vertexCount = header.vertexCount;
+    decoded.indexData = view.indices;
+    decoded.indexCount = header.indexCount;
+    decoded.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    decoded.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    for (uint32_t i = 0; i < header.submeshCount; i++) {
+        decoded.submeshes.push_back({view.submeshes[i].indexStart, view.submeshes[i].indexCount});
+    }
+    // The mapping is the only CPU copy and has to outlive the staging memcpy
+    decoded.mapping = std::move(mappedFile);
+    return true;
+}
+
+bool SceneLoader::decodeJsonMesh(const std::string& meshPath, DecodedMesh& decoded) {
         // Read JSON file first
         std::ifstream file(meshPath);
         if (!file.is_open()) {
             std::cerr << "\nFailed to open mesh file: " << meshPath << std::endl;
-            current++;
-            continue;
+            return false;
         }
         
         std::stringstream buffer;
@@ -214,9 +587,11 @@ void SceneLoader::cacheMeshes(const std::vector<std::string>& meshPaths) {
             
             // Now pass the parsed JSON object
             DeserializedMesh meshData = DeserializedMesh::from_json(jsonObject);
-            std::string meshID = meshData.id;          
-            // Create vertex data
-            std::vector<Rendering::Mesh::Vertex> vertices;
+            decoded.id = meshData.id;
+            // Create vertex data and the local bounds in the same pass
+            glm::vec3 boundsMin = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+            decoded.vertices.reserve(meshData.vertices.size());
             for (size_t i = 0; i < meshData.vertices.size(); i++) {
                 Rendering::Mesh::Vertex vertex{};
                 vertex.position = meshData.vertices[i];
@@ -233,186 +608,376 @@ void SceneLoader::cacheMeshes(const std::vector<std::string>& meshPaths) {
                     vertex.tangent = meshData.tangents[i];
                 }
                 
-                vertices.push_back(vertex);
+                boundsMin = glm::min(boundsMin, vertex.position);
+                boundsMax = glm::max(boundsMax, vertex.position);
+                decoded.vertices.push_back(vertex);
             }
 
-            std::vector<uint32_t> indices = meshData.indices;
-
-            // Create and store mesh with debug name
-            auto mesh = std::make_unique<Rendering::Mesh>(device, vertices, indices, meshID);
+            decoded.indices = std::move(meshData.indices);
             for(const auto& submesh : meshData.submeshes){
-                mesh->addSubmesh(submesh.indexStart, submesh.indexCount);
-            }          
-            
-            resourceManager.addMesh(meshID, std::move(mesh));
-            
-            current++;
-            std::cout << "\rMeshes loaded " << current << "/" << total << std::flush;       
+                decoded.submeshes.push_back({submesh.indexStart, submesh.indexCount});
+            }
+
+            decoded.vertexData = decoded.vertices.data();
+            decoded.vertexCount = static_cast<uint32_t>(decoded.vertices.size());
+            decoded.indexData = decoded.indices.data();
+            decoded.indexCount = static_cast<uint32_t>(decoded.indices.size());
+            decoded.boundsMin = boundsMin;
+            decoded.boundsMax = boundsMax;
+            return true;
+}
+
+void SceneLoader::cacheDecodedMesh(uint64_t cacheKey, const DecodedMesh& decoded) {
+    // Mesh::Vertex and MeshBinaryVertex share a layout (checked in mesh.cpp)
+    std::vector<MeshBinaryVertex> vertices(decoded.vertexCount);
+    std::memcpy(vertices.data(), decoded.vertexData, vertices.size() * sizeof(MeshBinaryVertex));
+    std::vector<uint32_t> indices(decoded.indexData, decoded.indexData + decoded.indexCount);
+    std::vector<MeshBinarySubmesh> submeshes;
+    for (const auto& submesh : decoded.submeshes) {
+        submeshes.push_back({submesh.indexStart, submesh.indexCount});
     }
-    std::cout << std::endl;
+    DerivedDataCache::writeMesh(cacheKey, decoded.id, vertices, indices, submeshes);
 }
 
-void SceneLoader::cacheTextures(const std::vector<std::string>& texturePaths,VkFormat format) {
-    size_t total = texturePaths.size();
-    size_t current = 0;
-    
-    for (const auto& path : texturePaths) { 
-        // Check if this texture has a compressed version already loaded
-        // If it exists in the map as a key, we can skip loading the regular version
-        if (compressedTextureMap.find(path) != compressedTextureMap.end()) {
-            current++;
-            std::cout << "\rTextures cached " << current << "/" << total << std::flush;
-            continue;
+SceneLoader::DecodedTexture SceneLoader::decodeTexture(const std::string& path, ktx_transcode_fmt_e targetFormat, bool pngOnly, VkFormat format) {
+    CPU_PROFILE_ZONE("SceneLoader::decodeTexture");
+    auto decodeStart = LoadClock::now();
+    DecodedTexture decoded;
+    decoded.path = path;
+    decoded.transcodeFormat = targetFormat;
+
+    if (!pngOnly) {
+        std::filesystem::path fsPath(path);
+        fsPath.replace_extension(".ktx2");
+        std::string ktxPath = fsPath.string();
+
+        decoded.cacheKind = DerivedDataKind::TranscodedTexture;
+        if (DERIVED_DATA_CACHE_ENABLED) {
+            decoded.cacheKey = DerivedDataCache::computeKey(ktxPath, DerivedDataKind::TranscodedTexture, targetFormat);
+            if (decoded.cacheKey != 0 && readCachedTexture(DerivedDataKind::TranscodedTexture, decoded)) {
+                decoded.fromKtx = true;
+                decoded.decodeMs = elapsedMs(decodeStart);
+                return decoded;
+            }
         }
 
-         int width, height, channels;
-            stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-            
-            // Extract filename for debug name
-            std::filesystem::path fsPath(path);
-            std::string debugName = fsPath.filename().string();
-            
-            auto texture = std::make_unique<Rendering::Texture>(
-                device,
-                width,
-                height,
-                format,
-                VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                pixels,
-                1,  // faces
-                debugName
-            );
-            resourceManager.addTexture(path, std::move(texture));
-            current++;
-            std::cout << "\rTextures cached " << current << "/" << total << std::flush;
+        ktxTexture2* kTexture2 = nullptr;
+        KTX_error_code result = ktxTexture2_CreateFromNamedFile(
+            ktxPath.c_str(), 
+            KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, 
+            &kTexture2);
+
+        if (result == KTX_SUCCESS) {
+            decoded.ktx.reset(kTexture2);
+
+            // Check if transcoding is needed and perform it
+            bool transcoded = ktxTexture2_NeedsTranscoding(kTexture2);
+            if (transcoded) {
+                // libktx sets up the Basis transcoder tables on first use; let the first transcode finish alone
+                // so that the other workers never race that setup
+                static std::mutex firstTranscodeMutex;
+                static std::atomic<bool> transcoderReady{false};
+                if (!transcoderReady.load()) {
+                    std::lock_guard<std::mutex> lock(firstTranscodeMutex);
+                    result = ktxTexture2_TranscodeBasis(kTexture2, targetFormat, 0);
+                    transcoderReady.store(true);
+                } else {
+                    result = ktxTexture2_TranscodeBasis(kTexture2, targetFormat, 0);
+                }
+            }
+
+            if (result == KTX_SUCCESS) {
+                ktxTexture* baseTexture = ktxTexture(kTexture2);
+                decoded.width = static_cast<int>(kTexture2->baseWidth);
+                decoded.height = static_cast<int>(kTexture2->baseHeight);
+                decoded.levelData = ktxTexture_GetData(baseTexture);
+                decoded.levelFormat = static_cast<VkFormat>(kTexture2->vkFormat);
+                decoded.fromKtx = true;
+                std::vector<DerivedTextureLevel> cacheLevels;
+                for (uint32_t level = 0; level < kTexture2->numLevels; level++) {
+                    ktx_size_t offset = 0;
+                    ktxTexture_GetImageOffset(baseTexture, level, 0, 0, &offset);
+                    decoded.levelOffsets.push_back(offset);
+                    decoded.levelSizes.push_back(ktxTexture_GetImageSize(baseTexture, level));
+                    cacheLevels.push_back({decoded.levelOffsets.back(), decoded.levelSizes.back()});
+                }
+
+                // Files that were stored already block-compressed are as cheap to read as a cache entry
+                if (!transcoded || decoded.cacheKey == 0 ||
+                    !DerivedDataCache::writeTexture(decoded.cacheKey, DerivedDataKind::TranscodedTexture, kTexture2->vkFormat,
+                                                    kTexture2->baseWidth, kTexture2->baseHeight, decoded.levelData, cacheLevels)) {
+                    decoded.cacheKey = 0;
+                }
+                decoded.decodeMs = elapsedMs(decodeStart);
+                return decoded;
+            }
+            std::cerr << "\nFailed to transcode KTX2 texture: " << ktxPath << std::endl;
+            decoded.ktx.reset();
+        } else {
+            std::cerr << "\nFailed to load KTX2 texture: " << ktxPath << std::endl;
+        }
     }
-    std::cout << std::endl;
+
+    // Only RGBA8 uploads can take a CPU-built chain; other formats (R8 occlusion) keep the GPU blits. Those chains are
+    // block-compressed to what the KTX2 would have been transcoded to
+    const bool srgb = format == VK_FORMAT_R8G8B8A8_SRGB;
+    const bool rgba8 = srgb || format == VK_FORMAT_R8G8B8A8_UNORM;
+    const bool compress = PNG_BLOCK_COMPRESSION_ENABLED && rgba8;
+    VkFormat compressedFormat = VK_FORMAT_UNDEFINED;
+    if (compress) {
+        compressedFormat = targetFormat == KTX_TTF_BC5_RG ? VK_FORMAT_BC5_UNORM_BLOCK
+                         : srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    decoded.cacheKind = compress ? DerivedDataKind::CompressedTexture : DerivedDataKind::TextureMips;
+    decoded.cacheKey = DERIVED_DATA_CACHE_ENABLED && rgba8
+        ? DerivedDataCache::computeKey(path, decoded.cacheKind, compress ? compressedFormat : format) : 0;
+    if (decoded.cacheKey != 0 && readCachedTexture(decoded.cacheKind, decoded)) {
+        decoded.decodeMs = elapsedMs(decodeStart);
+        return decoded;
+    }
+
+    int channels;
+    decoded.pixels.reset(stbi_load(path.c_str(), &decoded.width, &decoded.height, &channels, STBI_rgb_alpha));
+    if (!decoded.pixels) {
+        std::cerr << "\nFailed to load texture: " << path << " - " << stbi_failure_reason() << std::endl;
+        decoded.cacheKey = 0;
+    } else if (decoded.cacheKey != 0 || compress) {
+        // Build the chain the GPU would have blitted, so this run and the cached ones sample the same texels
+        uint32_t width = static_cast<uint32_t>(decoded.width);
+        uint32_t height = static_cast<uint32_t>(decoded.height);
+        uint32_t levelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+        std::vector<unsigned char> level(decoded.pixels.get(), decoded.pixels.get() + size_t(width) * height * 4);
+        for (uint32_t i = 0; i < levelCount; i++) {
+            if (i > 0) {
+                level = TextureStreamer::downsampleRGBA8(level.data(), width, height, 1, srgb);
+            }
+            decoded.levelOffsets.push_back(decoded.builtLevels.size());
+            decoded.levelSizes.push_back(level.size());
+            decoded.builtLevels.insert(decoded.builtLevels.end(), level.begin(), level.end());
+        }
+        decoded.levelFormat = format;
+        if (compress) {
+            compressLevels(decoded, compressedFormat);
+        }
+        decoded.levelData = decoded.builtLevels.data();
+        decoded.pixels.reset();
+
+        std::vector<DerivedTextureLevel> cacheLevels;
+        for (size_t i = 0; i < decoded.levelOffsets.size(); i++) {
+            cacheLevels.push_back({decoded.levelOffsets[i], decoded.levelSizes[i]});
+        }
+        if (decoded.cacheKey != 0 &&
+            !DerivedDataCache::writeTexture(decoded.cacheKey, decoded.cacheKind, decoded.levelFormat, static_cast<uint32_t>(decoded.width),
+                                            static_cast<uint32_t>(decoded.height), decoded.levelData, cacheLevels)) {
+            decoded.cacheKey = 0;
+        }
+    }
+    decoded.decodeMs = elapsedMs(decodeStart);
+    return decoded;
 }
 
-void SceneLoader::cacheCompressedTextures(const std::vector<std::string>& originalPaths, ktx_transcode_fmt_e targetFormat, const std::string& label) {
-    std::vector<std::string> compressedPaths=getCompressedTexturePaths();
+void SceneLoader::compressLevels(DecodedTexture& decoded, VkFormat compressedFormat) {
+    CPU_PROFILE_ZONE("SceneLoader::compressLevels");
+    auto encodeStart = LoadClock::now();
+    const bool bc5 = compressedFormat == VK_FORMAT_BC5_UNORM_BLOCK;
+    const uint32_t width = static_cast<uint32_t>(decoded.width);
+    const uint32_t height = static_cast<uint32_t>(decoded.height);
+
+    std::vector<unsigned char> blocks;
+    std::vector<VkDeviceSize> blockOffsets;
+    std::vector<VkDeviceSize> blockSizes;
+    for (size_t level = 0; level < decoded.levelOffsets.size(); level++) {
+        uint32_t levelWidth = std::max(width >> level, 1u);
+        uint32_t levelHeight = std::max(height >> level, 1u);
+        const unsigned char* pixels = decoded.builtLevels.data() + decoded.levelOffsets[level];
+        size_t offset = blocks.size();
+        blocks.resize(offset + BlockCompression::getEncodedSize(levelWidth, levelHeight));
+        if (bc5) {
+            BlockCompression::encodeBC5(pixels, levelWidth, levelHeight, blocks.data() + offset);
+        } else {
+            BlockCompression::encodeBC7(pixels, levelWidth, levelHeight, blocks.data() + offset);
+        }
+        blockOffsets.push_back(offset);
+        blockSizes.push_back(blocks.size() - offset);
+    }
+
+    // Quality of the level the camera sees up close; the smaller ones are filtered from it anyway
+    std::vector<unsigned char> roundTrip(decoded.levelSizes[0]);
+    if (bc5) {
+        BlockCompression::decodeBC5(blocks.data(), width, height, roundTrip.data());
+    } else {
+        BlockCompression::decodeBC7(blocks.data(), width, height, roundTrip.data());
+    }
+    decoded.encodePsnr = BlockCompression::computePsnr(decoded.builtLevels.data(), roundTrip.data(), size_t(width) * height, bc5 ? 2 : 4);
+
+    decoded.uncompressedBytes = decoded.builtLevels.size();
+    decoded.builtLevels = std::move(blocks);
+    decoded.levelOffsets = std::move(blockOffsets);
+    decoded.levelSizes = std::move(blockSizes);
+    decoded.levelFormat = compressedFormat;
+    decoded.encoded = true;
+    decoded.encodeMs = elapsedMs(encodeStart);
+}
+
+bool SceneLoader::readCachedTexture(DerivedDataKind kind, DecodedTexture& decoded) {
+    auto mapping = std::make_unique<MappedFile>();
+    DerivedTextureView view;
+    if (!DerivedDataCache::readTexture(decoded.cacheKey, kind, *mapping, view)) {
+        return false;
+    }
+    decoded.width = static_cast<int>(view.header->width);
+    decoded.height = static_cast<int>(view.header->height);
+    decoded.levelFormat = static_cast<VkFormat>(view.header->format);
+    for (uint32_t level = 0; level < view.header->levelCount; level++) {
+        decoded.levelOffsets.push_back(view.levels[level].offset);
+        decoded.levelSizes.push_back(view.levels[level].size);
+    }
+    decoded.levelData = view.data;
+    decoded.cacheMapping = std::move(mapping);
+    decoded.fromCache = true;
+    return true;
+}
+
+SceneLoader::LoadStageTiming SceneLoader::cacheTextures(std::vector<std::future<DecodedTexture>>& textureJobs, VkFormat format, const std::string& label) {
+    CPU_PROFILE_ZONE("SceneLoader::cacheTextures");
+    LoadStageTiming timing{label};
+    auto stageStart = LoadClock::now();
+    std::vector<std::string> requestedPaths;
     std::vector<std::string> succesfullyLoadedCompressedTexturePaths;
-    size_t total = originalPaths.size();
+    size_t total = textureJobs.size();
     size_t current = 0;
+    size_t compressedCount = 0;
+    size_t cachedCount = 0;
+    std::vector<std::string> encodeReports;
     
-    // Process all KTX2 textures, only map them if they load successfully
-    for (const auto& path : originalPaths) {
-
-            std::filesystem::path fsPath(path);
-            fsPath.replace_extension(".ktx2");
-            std::string ktxPath = fsPath.string();
-
-            ktxTexture2* kTexture2;
-            KTX_error_code result = ktxTexture2_CreateFromNamedFile(
-                ktxPath.c_str(), 
-                KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, 
-                &kTexture2);
-                
-            if (result != KTX_SUCCESS) {
-                std::cerr << "\nFailed to load KTX2 texture: " << ktxPath << std::endl;
-                current++;
-                std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
-                continue;
+    for (auto& job : textureJobs) {
+        DecodedTexture decoded = job.get();
+        current++;
+        preparedResources++;
+        timing.workerMs += decoded.decodeMs;
+        requestedPaths.push_back(decoded.path);
+
+        // Extract filename for debug name
+        std::filesystem::path fsPath(decoded.path);
+        std::unique_ptr<Rendering::Texture> texture;
+        TextureStreamer::Source streamingSource{};
+        streamingSource.path = decoded.path;
+        streamingSource.transcodeFormat = decoded.transcodeFormat;
+        streamingSource.format = format;
+        streamingSource.width = static_cast<uint32_t>(decoded.width);
+        streamingSource.height = static_cast<uint32_t>(decoded.height);
+        uint32_t tailLevel = 0;
+        if (decoded.levelData) {
+            // Upload the prebuilt mip chain as-is, one copy region per level; with streaming only the levels from
+            // the tail down, which may sit anywhere in the data (KTX2 stores the smallest first) so their byte range
+            // is taken from the offsets
+            uint32_t levelCount = static_cast<uint32_t>(decoded.levelOffsets.size());
+            uint32_t width = static_cast<uint32_t>(decoded.width);
+            uint32_t height = static_cast<uint32_t>(decoded.height);
+            streamingSource.ktx = decoded.fromKtx;
+            streamingSource.cacheKey = decoded.cacheKey;
+            streamingSource.cacheKind = decoded.cacheKind;
+            streamingSource.levelCount = levelCount;
+            if (textureStreamer) {
+                tailLevel = TextureStreamer::tailLevelFor(width, height, levelCount);
             }
-            
-            // Check if transcoding is needed and perform it
-            if (ktxTexture2_NeedsTranscoding(kTexture2)) {
-                result = ktxTexture2_TranscodeBasis(kTexture2, targetFormat, 0);
-                if (result != KTX_SUCCESS) {
-                    std::cerr << "\nFailed to transcode KTX2 texture: " << ktxPath << std::endl;
-                    ktxTexture2_Destroy(kTexture2);
-                    current++;
-                    std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
-                    continue;
-                }
+
+            VkDeviceSize rangeStart = std::numeric_limits<VkDeviceSize>::max();
+            VkDeviceSize rangeEnd = 0;
+            std::vector<VkDeviceSize> levelOffsets(levelCount - tailLevel);
+            for (uint32_t level = tailLevel; level < levelCount; level++) {
+                levelOffsets[level - tailLevel] = decoded.levelOffsets[level];
+                rangeStart = std::min<VkDeviceSize>(rangeStart, decoded.levelOffsets[level]);
+                rangeEnd = std::max<VkDeviceSize>(rangeEnd, decoded.levelOffsets[level] + decoded.levelSizes[level]);
             }
-            
-            // Create Vulkan image from transcoded KTX2 texture
-            ktxVulkanTexture vkTexture;
-            ktxVulkanDeviceInfo vkDeviceInfo;
-            ktxVulkanDeviceInfo_Construct(&vkDeviceInfo, 
-                                         device.getPhysicalDevice(), 
-                                         device.getDevice(), 
-                                         device.getGraphicsQueue(), 
-                                         device.getCommandPool(), 
-                                         nullptr);
-                                          
-            result = ktxTexture2_VkUploadEx(kTexture2, &vkDeviceInfo, &vkTexture,
-                                         VK_IMAGE_TILING_OPTIMAL,
-                                         VK_IMAGE_USAGE_SAMPLED_BIT,
-                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-                                         
-            if (result != KTX_SUCCESS) {
-                ktxTexture2_Destroy(kTexture2);
-                ktxVulkanDeviceInfo_Destruct(&vkDeviceInfo);
-                std::cerr << "\nFailed to upload KTX2 texture to Vulkan: " << ktxPath << std::endl;
-                current++;
-                std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
-                continue;
+            for (VkDeviceSize& offset : levelOffsets) {
+                offset -= rangeStart;
             }
-            
-            // Create image view
-            VkImageView imageView;
-            VkImageViewCreateInfo viewInfo{};
-            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            viewInfo.image = vkTexture.image;
-            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            viewInfo.format = vkTexture.imageFormat;
-            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            viewInfo.subresourceRange.baseMipLevel = 0;
-            viewInfo.subresourceRange.levelCount = vkTexture.levelCount;
-            viewInfo.subresourceRange.baseArrayLayer = 0;
-            viewInfo.subresourceRange.layerCount = vkTexture.layerCount;
-            
-            if (vkCreateImageView(device.getDevice(), &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
-                vkTexture.vkDestroyImage(device.getDevice(), vkTexture.image, nullptr);
-                vkTexture.vkFreeMemory(device.getDevice(), vkTexture.deviceMemory, nullptr);
-                ktxTexture2_Destroy(kTexture2);
-                ktxVulkanDeviceInfo_Destruct(&vkDeviceInfo);
-                std::cerr << "\nFailed to create image view for KTX2 texture: " << ktxPath << std::endl;
-                current++;
-                std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
-                continue;
+
+            if (decoded.fromKtx) {
+                fsPath.replace_extension(".ktx2");
             }
-            
-            // Extract filename for debug name (reuse fsPath from above)
-            std::string debugName = fsPath.filename().string();
-            
-            // Create texture
-            auto texture = std::make_unique<Rendering::Texture>(
+            texture = std::make_unique<Rendering::Texture>(
                 device,
-                vkTexture.width,
-                vkTexture.height,
-                vkTexture.imageFormat,
-                vkTexture.image,
-                imageView,
-                vkTexture.deviceMemory,
-                vkTexture.levelCount,
-                debugName
+                uploadManager,
+                std::max(width >> tailLevel, 1u),
+                std::max(height >> tailLevel, 1u),
+                decoded.levelFormat,
+                levelCount - tailLevel,
+                decoded.levelData + rangeStart,
+                rangeEnd - rangeStart,
+                levelOffsets,
+                fsPath.filename().string()
             );
-            
-            // Add to resource manager - Store with the KTX2 path
-            resourceManager.addTexture(path, std::move(texture));         
-            succesfullyLoadedCompressedTexturePaths.push_back(path);           
-            // Cleanup
-            ktxTexture2_Destroy(kTexture2);
-            ktxVulkanDeviceInfo_Destruct(&vkDeviceInfo);
-            
-            current++;
+            if (decoded.fromKtx) {
+                succesfullyLoadedCompressedTexturePaths.push_back(decoded.path);
+                compressedCount++;
+            }
+            if (decoded.fromCache) {
+                cachedCount++;
+            }
+            if (decoded.encoded) {
+                std::ostringstream report;
+                report << std::fixed << std::setprecision(1) << "  " << fsPath.filename().string() << ": "
+                       << (decoded.levelFormat == VK_FORMAT_BC5_UNORM_BLOCK ? "BC5 " : "BC7 ")
+                       << decoded.uncompressedBytes / 1024.0 << " KB -> " << decoded.builtLevels.size() / 1024.0
+                       << " KB, PSNR " << decoded.encodePsnr << " dB, " << decoded.encodeMs << " ms";
+                encodeReports.push_back(report.str());
+            }
+        } else if (decoded.pixels) {
+            uint32_t width = static_cast<uint32_t>(decoded.width);
+            uint32_t height = static_cast<uint32_t>(decoded.height);
+            streamingSource.levelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+            std::vector<unsigned char> tailPixels;
+            if (textureStreamer) {
+                tailLevel = TextureStreamer::tailLevelFor(width, height, streamingSource.levelCount);
+                if (tailLevel > 0) {
+                    tailPixels = TextureStreamer::downsampleRGBA8(decoded.pixels.get(), width, height, tailLevel, format == VK_FORMAT_R8G8B8A8_SRGB);
+                }
+            }
+
+            texture = std::make_unique<Rendering::Texture>(
+                device,
+                uploadManager,
+                width,
+                height,
+                format,
+                tailPixels.empty() ? decoded.pixels.get() : tailPixels.data(),
+                fsPath.filename().string()
+            );
+        } else {
             std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
-    }
-    std::cout << std::endl;
+            continue;
+        }
 
+        if (tailLevel > 0) {
+            pendingStreamingRegistrations.push_back({texture.get(), streamingSource, tailLevel});
+        }
 
+        // Add to resource manager - both versions are stored under the original path
+        resourceManager.addTexture(decoded.path, std::move(texture));
+        std::cout << "\r" << label << " cached " << current << "/" << total << std::flush;
+    }
+    std::cout << std::endl;
+    if (compressedCount > 0) {
+        std::cout << "  " << compressedCount << "/" << total << " loaded from KTX2" << std::endl;
+    }
+    if (cachedCount > 0) {
+        std::cout << "  " << cachedCount << "/" << total << " read from the derived data cache" << std::endl;
+    }
+    if (!encodeReports.empty()) {
+        std::cout << "  " << encodeReports.size() << "/" << total << " block-compressed from PNG:" << std::endl;
+        for (const std::string& report : encodeReports) {
+            std::cout << "  " << report << std::endl;
+        }
+    }
 
-     for (const std::string& compressedPath : succesfullyLoadedCompressedTexturePaths) {
+    for (const std::string& compressedPath : succesfullyLoadedCompressedTexturePaths) {
         std::filesystem::path compPath(compressedPath);
         std::string filename = compPath.stem().string();
 
-        // Look for matching .png in originalPaths
-        for (const std::string& origPath : originalPaths) {
+        // Look for matching .png in the requested paths
+        for (const std::string& origPath : requestedPaths) {
             std::filesystem::path orig(origPath);
             if (orig.stem() == filename) {
                 compressedTextureMap[origPath] = compressedPath;
@@ -421,138 +986,185 @@ void SceneLoader::cacheCompressedTextures(const std::vector<std::string>& origin
         }
     }
 
+    timing.wallMs = elapsedMs(stageStart);
+    return timing;
+}
+
+SceneLoader::DecodedMaterial SceneLoader::decodeMaterial(const std::string& materialPath) {
+    CPU_PROFILE_ZONE("SceneLoader::decodeMaterial");
+    auto decodeStart = LoadClock::now();
+    DecodedMaterial decoded;
+    decoded.path = materialPath;
 
+    std::ifstream file(materialPath);
+    if (file.is_open()) {
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        json matJson = json::parse(buffer.str());
+        decoded.data = DeserializedMaterial::from_json(matJson);
+        decoded.valid = true;
+    }
+    decoded.decodeMs = elapsedMs(decodeStart);
+    return decoded;
 }
 
-void SceneLoader::cacheMaterials(const std::vector<std::string>& materialPaths) {
-    size_t total = materialPaths.size();
-    size_t current = 0;
+SceneLoader::LoadStageTiming SceneLoader::cacheMaterialTextures(std::vector<std::future<DecodedMaterial>>& materialJobs, ThreadPool& workerPool, std::vector<DecodedMaterial>& materials) {
+    CPU_PROFILE_ZONE("SceneLoader::cacheMaterialTextures");
+    LoadStageTiming timing{"Material files"};
+    auto stageStart = LoadClock::now();
+    materials.reserve(materialJobs.size());
+    for (auto& job : materialJobs) {
+        materials.push_back(job.get());
+        timing.workerMs += materials.back().decodeMs;
+    }
 
-    for (const auto& materialPath : materialPaths) {
-        std::ifstream file(materialPath);
-        if (!file.is_open()) {
-            std::cerr << "\nFailed to open material file: " << materialPath << std::endl;
-            current++;
-            std::cout << "\rMaterials cached " << current << "/" << total << std::flush;
+    // Textures referenced only by materials (metallic/smoothness, occlusion, anything missing from the scene lists)
+    // are decoded together on the pool rather than one by one while the materials are built
+    std::map<VkFormat, std::vector<std::future<DecodedTexture>>> fallbackTextureJobs;
+    std::unordered_set<std::string> requestedTextures;
+    // targetFormat picks the block format the PNG is compressed to
+    auto requestTexture = [&](const std::string& path, VkFormat format, ktx_transcode_fmt_e targetFormat) {
+        if (path.empty() || resourceManager.getTexture(getCompressedTexturePath(path)) != nullptr || !requestedTextures.insert(path).second) {
+            return;
+        }
+        fallbackTextureJobs[format].push_back(workerPool.submit([path, format, targetFormat]() { return decodeTexture(path, targetFormat, true, format); }));
+        resourceCount++;
+    };
+    for (const auto& material : materials) {
+        if (!material.valid) {
             continue;
         }
+        requestTexture(material.data.albedoPath, VK_FORMAT_R8G8B8A8_SRGB, KTX_TTF_BC7_RGBA);
+        requestTexture(material.data.normalPath, VK_FORMAT_R8G8B8A8_UNORM, KTX_TTF_BC5_RG);
+        requestTexture(material.data.metallicSmoothnessPath, VK_FORMAT_R8G8B8A8_UNORM, KTX_TTF_BC7_RGBA);
+        requestTexture(material.data.occlusionPath, VK_FORMAT_R8_UNORM, KTX_TTF_BC7_RGBA);
+    }
+    for (auto& [format, jobs] : fallbackTextureJobs) {
+        timing.workerMs += cacheTextures(jobs, format, "Material textures").workerMs;
+    }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        json matJson = json::parse(buffer.str());
-        DeserializedMaterial matData = DeserializedMaterial::from_json(matJson);
-        std::string materialId = matData.id;
-        
-        // Determine material type and pipeline
-        Rendering::TransparencyType transparencyType;
-        int isMasked=0;
-        switch (matData.type) {
-            case MaterialType::Masked:
-                transparencyType = Rendering::TransparencyType::TYPE_MASK;
-                isMasked=1;
-                break;
-            case MaterialType::Transparent:
-                transparencyType = Rendering::TransparencyType::TYPE_TRANSPARENT;               
-                break;
-            default:
-                transparencyType = Rendering::TransparencyType::TYPE_OPAQUE;
-                break;
+    timing.wallMs = elapsedMs(stageStart);
+    return timing;
+}
+
+void SceneLoader::registerStreamedTextures() {
+    if (textureStreamer) {
+        for (const auto& registration : pendingStreamingRegistrations) {
+            textureStreamer->registerTexture(registration.tail, registration.source, registration.tailLevel);
         }
+    }
+    pendingStreamingRegistrations.clear();
+}
 
-        // Create material info
-        Rendering::Material::MaterialInfo materialInfo{};
-        materialInfo.name = materialId;
-        materialInfo.transparencyType = transparencyType;
-        materialInfo.enableGPUInstancing=matData.enableGPUInstancing;
-
-        // Set and log material properties
-        materialInfo.properties.albedoColor = glm::vec4(matData.albedoColor);
-        materialInfo.properties.metallic = matData.metallic;
-        materialInfo.properties.smoothness = matData.smoothness;
-        materialInfo.properties.ao = matData.ao;
-        materialInfo.properties.alphaCutoff = matData.alphaCutoff;
-        materialInfo.properties.isMasked=isMasked;
-        materialInfo.properties.normalStrength=matData.normalStrength;
-        materialInfo.properties.hasNormalMap=matData.normalPath.empty() ? 0 : 1;
-        materialInfo.properties.hasOcclusionMap=matData.occlusionPath.empty() ? 0 : 1;
-        try {
-
-            auto material = std::make_unique<Rendering::Material>(
-                device,
-                materialInfo,
-                descriptorPool,
-                resourceManager.getPBRDescriptorSetLayout()
-            );
+void SceneLoader::createMaterial(const DecodedMaterial& material) {
+    CPU_PROFILE_ZONE("SceneLoader::createMaterial");
+    if (!material.valid) {
+        std::cerr << "\nFailed to open material file: " << material.path << std::endl;
+        return;
+    }
+
+    const DeserializedMaterial& matData = material.data;
+    std::string materialId = matData.id;
+    
+    // Determine material type and pipeline
+    Rendering::TransparencyType transparencyType;
+    int isMasked=0;
+    switch (matData.type) {
+        case MaterialType::Masked:
+            transparencyType = Rendering::TransparencyType::TYPE_MASK;
+            isMasked=1;
+            break;
+        case MaterialType::Transparent:
+            transparencyType = Rendering::TransparencyType::TYPE_TRANSPARENT;               
+            break;
+        default:
+            transparencyType = Rendering::TransparencyType::TYPE_OPAQUE;
+            break;
+    }
 
+    // Create material info
+    Rendering::Material::MaterialInfo materialInfo{};
+    materialInfo.name = materialId;
+    materialInfo.transparencyType = transparencyType;
+    materialInfo.enableGPUInstancing=matData.enableGPUInstancing;
+
+    // Set and log material properties
+    materialInfo.properties.albedoColor = glm::vec4(matData.albedoColor);
+    materialInfo.properties.metallic = matData.metallic;
+    materialInfo.properties.smoothness = matData.smoothness;
+    materialInfo.properties.ao = matData.ao;
+    materialInfo.properties.alphaCutoff = matData.alphaCutoff;
+    materialInfo.properties.isMasked=isMasked;
+    materialInfo.properties.normalStrength=matData.normalStrength;
+    materialInfo.properties.hasNormalMap=matData.normalPath.empty() ? 0 : 1;
+    materialInfo.properties.hasOcclusionMap=matData.occlusionPath.empty() ? 0 : 1;
+    try {
 
-            if (!matData.albedoPath.empty()) {
-                auto compressedPath=getCompressedTexturePath(matData.albedoPath);
-                auto texture = resourceManager.getTexture(compressedPath);
-                if(texture==nullptr){
-                    cacheTextures(std::vector<std::string>{matData.albedoPath},VK_FORMAT_R8G8B8A8_SRGB);
-                    texture = resourceManager.getTexture(compressedPath);
-                }
-                material->setAlbedoTexture(texture);
-            } 
-
-            if (!matData.normalPath.empty()) {
-                auto compressedPath=getCompressedTexturePath(matData.normalPath);
-                auto texture = resourceManager.getTexture(compressedPath);
-                if(texture==nullptr){
-                    cacheTextures(std::vector<std::string>{matData.normalPath},VK_FORMAT_R8G8B8A8_UNORM);
-                    texture = resourceManager.getTexture(compressedPath);
-                }
-                material->setNormalTexture(texture);
-            } 
-
-            if (!matData.metallicSmoothnessPath.empty()) {
-                auto compressedPath=getCompressedTexturePath(matData.metallicSmoothnessPath);
-                auto texture = resourceManager.getTexture(compressedPath);
-                if(texture==nullptr){
-                    cacheTextures(std::vector<std::string>{matData.metallicSmoothnessPath},VK_FORMAT_R8G8B8A8_UNORM);
-                    texture = resourceManager.getTexture(compressedPath);
-                }
-                material->setMetallicSmoothnessTexture(texture);
-            }
+        auto newMaterial = std::make_unique<Rendering::Material>(
+            device,
+            materialInfo,
+            descriptorPool,
+            resourceManager.getPBRDescriptorSetLayout()
+        );
 
-            if (!matData.occlusionPath.empty()) {
-                auto compressedPath=getCompressedTexturePath(matData.occlusionPath);
-                auto texture = resourceManager.getTexture(compressedPath);
-                if(texture==nullptr){
-                    cacheTextures(std::vector<std::string>{matData.occlusionPath},VK_FORMAT_R8_UNORM);
-                    texture = resourceManager.getTexture(compressedPath);
-                }
-                material->setOcclusionTexture(texture);
-            }
+        // Every referenced texture was cached with the other resources, a missing one failed to decode
+        if (!matData.albedoPath.empty()) {
+            newMaterial->setAlbedoTexture(resourceManager.getTexture(getCompressedTexturePath(matData.albedoPath)));
+        } 
 
-            resourceManager.addMaterial(materialId, std::move(material));
-            current++;
-            std::cout << "\rMaterials cached " << current << "/" << total << std::flush;
+        if (!matData.normalPath.empty()) {
+            newMaterial->setNormalTexture(resourceManager.getTexture(getCompressedTexturePath(matData.normalPath)));
+        } 
 
-        } catch (const std::exception& e) {
-            std::cerr << "\nERROR: Failed to create material '" << materialId 
-                     << "': " << e.what() << std::endl;
-            current++;
-            std::cout << "\rMaterials cached " << current << "/" << total << std::flush;
-            throw;
+        if (!matData.metallicSmoothnessPath.empty()) {
+            newMaterial->setMetallicSmoothnessTexture(resourceManager.getTexture(getCompressedTexturePath(matData.metallicSmoothnessPath)));
         }
+
+        if (!matData.occlusionPath.empty()) {
+            newMaterial->setOcclusionTexture(resourceManager.getTexture(getCompressedTexturePath(matData.occlusionPath)));
+        }
+
+        if (textureStreamer) {
+            textureStreamer->registerMaterial(newMaterial.get());
+        }
+        resourceManager.addMaterial(materialId, std::move(newMaterial));
+
+    } catch (const std::exception& e) {
+        std::cerr << "\nERROR: Failed to create material '" << materialId 
+                 << "': " << e.what() << std::endl;
+        throw;
     }
-    std::cout << std::endl;
 }
 
-void SceneLoader::createEntityFromUnityData(const DeserializedGameObject& gameObject) {
-    ECS::EntityID entity = ecsManager.createEntity();
+void SceneLoader::EntityBatch::clear() {
+    transformEntities.clear();
+    transforms.clear();
+    cameraEntities.clear();
+    cameras.clear();
+    directionalLightEntities.clear();
+    directionalLights.clear();
+    spotLightEntities.clear();
+    spotLights.clear();
+    pointLightEntities.clear();
+    pointLights.clear();
+    renderableEntities.clear();
+    renderables.clear();
+}
+
+void SceneLoader::appendToBatch(const DeserializedGameObject& gameObject, ECS::EntityID entity, EntityBatch& batch) {
+    // Lights and renderers carry their own copy of the transform, the component is only kept when none takes it
+    ECS::Transform transform{entity};
+    bool hasTransform = false;
+    bool transformTaken = false;
     for (auto& componentData : gameObject.components) {
         switch(componentData->componentType) {
             case ComponentType::Transform: {
                 auto sTransform = std::static_pointer_cast<DeserializedTransform>(componentData);
-                ECS::Transform transform{entity};
                 transform.position=sTransform->position;             
                 transform.rotation=sTransform->rotation;
                 transform.scale = sTransform->scale;                                             
                 Systems::TransformSystem::updateTransform(transform);
-
-                ecsManager.addComponent<ECS::Transform>(entity, transform);
+                hasTransform = true;
                 break;
             }
            
@@ -563,7 +1175,8 @@ void SceneLoader::createEntityFromUnityData(const DeserializedGameObject& gameOb
                 camera.farPlane = sCamera->farPlane;
                 camera.fov=glm::radians(sCamera->fieldOfView);              
                 camera.aspectRatio=static_cast<float>(AlphaEngine::WIDTH) / static_cast<float>(AlphaEngine::HEIGHT);
-                ecsManager.addComponent<ECS::Camera>(entity, camera);
+                batch.cameraEntities.push_back(entity);
+                batch.cameras.push_back(camera);
                 break;
             }
            
@@ -578,13 +1191,13 @@ void SceneLoader::createEntityFromUnityData(const DeserializedGameObject& gameOb
                     sLight->isCastingShadows,
                     sLight->shadowStrength
                 );
-                ecsManager.addComponent<ECS::DirectionalLight>(entity, directionalLight);
+                batch.directionalLightEntities.push_back(entity);
+                batch.directionalLights.push_back(directionalLight);
                 break;
             }
 
             case ComponentType::SpotLight: {
                 auto sLight = std::static_pointer_cast<DeserializedSpotLight>(componentData);
-                auto transform=ecsManager.getComponent<ECS::Transform>(entity);
                 ECS::SpotLight spotLight{
                     entity,
                     sLight->intensity,
@@ -595,16 +1208,16 @@ void SceneLoader::createEntityFromUnityData(const DeserializedGameObject& gameOb
                     sLight->isCastingShadows,
                     sLight->shadowStrength
                 };  
-                spotLight.transform=*transform;
+                spotLight.transform=transform;
+                transformTaken = true;
 
-                ecsManager.addComponent<ECS::SpotLight>(entity, spotLight);
-                ecsManager.removeComponent<ECS::Transform>(entity);
+                batch.spotLightEntities.push_back(entity);
+                batch.spotLights.push_back(spotLight);
                 break;
             }
 
             case ComponentType::PointLight: {
                 auto sLight = std::static_pointer_cast<DeserializedPointLight>(componentData);
-                auto transform=ecsManager.getComponent<ECS::Transform>(entity);
                 ECS::PointLight pointLight{
                     entity,
                     sLight->intensity,
@@ -613,69 +1226,81 @@ void SceneLoader::createEntityFromUnityData(const DeserializedGameObject& gameOb
                     sLight->isCastingShadows,
                     sLight->shadowStrength
                 };  
-                pointLight.transform=*transform;
-                ecsManager.addComponent<ECS::PointLight>(entity, pointLight);
-                ecsManager.removeComponent<ECS::Transform>(entity);
-
-                Systems::TransformSystem::updateTransform(pointLight.transform);
+                pointLight.transform=transform;
+                transformTaken = true;
 
+                batch.pointLightEntities.push_back(entity);
+                batch.pointLights.push_back(pointLight);
                 break;
             }
            
             case ComponentType::MeshRenderer: {
                 auto sMeshRenderer = std::static_pointer_cast<DeserializedMeshRenderer>(componentData);
-                ECS::Transform* transform = ecsManager.getComponent<ECS::Transform>(entity);               
   
                 auto mesh = resourceManager.getMesh(sMeshRenderer->meshId);
-                uint32_t materialCount=sMeshRenderer->materialIds.size();
                 std::vector<Rendering::Material*> materials;
-                for(uint32_t i=0;i<materialCount;i++){
-                    auto materialId=sMeshRenderer->materialIds[i];
-                    auto material=resourceManager.getMaterial(materialId);
-                    materials.push_back(material);
+                materials.reserve(sMeshRenderer->materialIds.size());
+                for (const auto& materialId : sMeshRenderer->materialIds) {
+                    materials.push_back(resourceManager.getMaterial(materialId));
                 }
 
                 ECS::MeshRenderer meshRenderer(entity,mesh,materials,sMeshRenderer->castingShadows);
                 ECS::Renderable renderable{entity};
-                renderable.transform=*transform;
+                renderable.transform=transform;
                 renderable.meshRenderer=meshRenderer;
                 Systems::TransformSystem::updateTransform(renderable.transform);
-                
-                ecsManager.addComponent<ECS::Renderable>(entity, renderable);   
-                ecsManager.removeComponent<ECS::Transform>(entity);               
+                transformTaken = true;
+
+                batch.renderableEntities.push_back(entity);
+                batch.renderables.push_back(renderable);
                 break;             
             }
         }
     } 
-}
 
-void SceneLoader::createScene(const Resources::DeserializedScene& deserializedScene){
-    auto& scene=Scene::Scene::getInstance();
-    auto spotLights=ecsManager.getAllComponents<ECS::SpotLight>();
-    auto pointLights=ecsManager.getAllComponents<ECS::PointLight>();
-    auto renderers=ecsManager.getAllComponents<ECS::Renderable>();
-   
-    for(uint32_t i=0;i<spotLights.size();i++){
-         scene.addLight(static_cast<ECS::Light&>(*spotLights[i]));
+    if (hasTransform && !transformTaken) {
+        batch.transformEntities.push_back(entity);
+        batch.transforms.push_back(transform);
     }
+}
 
-    for(uint32_t i=0;i<pointLights.size();i++){
-        scene.addLight(static_cast<ECS::Light&>(*pointLights[i]));
-    }
+void SceneLoader::commitBatch(EntityBatch& batch) {
+    CPU_PROFILE_ZONE("SceneLoader::commitBatch");
+    ecsManager.addComponents(batch.transformEntities, batch.transforms);
+    ecsManager.addComponents(batch.cameraEntities, batch.cameras);
+    ecsManager.addComponents(batch.directionalLightEntities, batch.directionalLights);
 
-    for(uint32_t i=0;i<renderers.size();i++){
-        scene.addRenderer(static_cast<Renderable&>(*renderers[i]));
+    std::vector<ECS::Light*> lights;
+    lights.reserve(batch.spotLights.size() + batch.pointLights.size());
+    for (ECS::SpotLight* spotLight : ecsManager.addComponents(batch.spotLightEntities, batch.spotLights)) {
+        lights.push_back(spotLight);
+    }
+    for (ECS::PointLight* pointLight : ecsManager.addComponents(batch.pointLightEntities, batch.pointLights)) {
+        lights.push_back(pointLight);
     }
+    std::vector<ECS::Renderable*> renderables = ecsManager.addComponents(batch.renderableEntities, batch.renderables);
 
+    auto& scene=Scene::Scene::getInstance();
+    if (!lights.empty()) {
+        scene.addLights(lights);
+    }
+    if (!renderables.empty()) {
+        scene.addRenderers(renderables);
+    }
+    batch.clear();
+}
 
+void SceneLoader::applyEnvironmentLighting(const Resources::DeserializedScene& deserializedScene){
     Scene::EnvironmentLighting envLighting{
         deserializedScene.environmentLighting.ambientColor,
         deserializedScene.environmentLighting.ambientIntensity,
         resourceManager.getCubemap("skybox"),
         deserializedScene.environmentLighting.reflectionIntensity
     };
+    envLighting.irradianceSH = skyboxIrradianceSH;
+    envLighting.hasIrradianceSH = hasSkyboxIrradiance;
 
-    scene.setEnvironmentLighting(&envLighting);
+    Scene::Scene::getInstance().setEnvironmentLighting(&envLighting);
 }
 
 std::string SceneLoader::getCompressedTexturePath(const std::string& texturePath){
@@ -686,27 +1311,6 @@ std::string SceneLoader::getCompressedTexturePath(const std::string& texturePath
     return texturePath;
 }
 
-std::vector<std::string> SceneLoader::getCompressedTexturePaths() {
-    const std::string directory = "Assets/Scene/textures";
-    std::vector<std::string>compressedTexturePaths{};
-     if (!std::filesystem::exists(directory)) {
-            std::cerr << "Directory does not exist: " << directory << std::endl;
-            return compressedTexturePaths;
-        }
-        
-        // Iterate through directory
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
-            if (entry.is_regular_file()) {
-                std::string path = entry.path().string();
-                // Check if file has .ktx2 extension
-                if (path.find(".ktx2") != std::string::npos) {
-                    compressedTexturePaths.push_back(path);
-                }
-            }
-        }              
-        return compressedTexturePaths;
-   
-}
 } // namespace Resources
 
 
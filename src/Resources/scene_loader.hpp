@@ -10,6 +10,14 @@
 #include "Rendering/Core/descriptors.hpp"
 #include "Scene/scene.hpp"
 #include "deserialized_scene.hpp"
+#include "mapped_file.hpp"
+#include "mesh_binary.hpp"
+#include "derived_data_cache.hpp"
+#include "block_compression.hpp"
+#include "environment_preprocessor.hpp"
+#include "thread_pool.hpp"
+#include "texture_streamer.hpp"
+#include "Rendering/Core/upload_manager.hpp"
 #include "ECS/ecs.hpp"
 #include "Systems/transform_system.hpp"
 #include "external/libraries/tiny_gltf.h"
@@ -18,6 +26,9 @@
 
 #include <fstream>
 #include "external/libraries/json.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
@@ -29,38 +40,235 @@ namespace Resources {
     public:
         SceneLoader(
             ResourceManager& resourceManager, 
-            Rendering::Device& device
+            Rendering::Device& device,
+            Rendering::UploadManager& uploadManager,
+            TextureStreamer* textureStreamer = nullptr  // null uploads every texture with its full mip chain
         );
         ~SceneLoader() = default;
 
         SceneLoader(const SceneLoader&) = delete;
         SceneLoader& operator=(const SceneLoader&) = delete;
 
+        enum class LoadPhase {
+            Idle,
+            Preparing,      // loader thread decodes and uploads; objects that need no resources (camera, lights) commit
+            Committing,     // resources are uploaded, materials and mesh renderers are committed
+            Finished
+        };
+
+        struct LoadProgress {
+            LoadPhase phase = LoadPhase::Idle;
+            uint32_t preparedResources = 0;     // meshes, textures and skybox uploaded by the loader thread
+            uint32_t resourceCount = 0;         // 0 until the scene file is parsed
+            uint32_t committedObjects = 0;      // materials and game objects committed on the calling thread
+            uint32_t objectCount = 0;
+
+            float getFraction() const {
+                uint32_t total = resourceCount + objectCount;
+                return total > 0 ? static_cast<float>(preparedResources + committedObjects) / static_cast<float>(total) : 0.0f;
+            }
+        };
+
         bool loadUnityScene(const std::string& jsonPath);
-        
-        // Async version of the scene loader
-        std::future<bool> loadUnitySceneAsync(const std::string& jsonPath);
 
-        
+        // Incremental version: parsing, decoding and uploads run on a loader thread, which owns the UploadManager this
+        // loader was created with until the load finishes. The calling thread keeps rendering and calls commitPending()
+        // once per frame; only it touches the ECS, the Scene octree, the material descriptor pool and the streamer
+        void beginUnitySceneLoad(const std::string& jsonPath);
+        // Commits prepared work until budgetMs is spent, at least one item per call. Returns true once the scene is
+        // complete and rethrows whatever the loader thread failed with
+        bool commitPending(double budgetMs);
+        LoadProgress getProgress() const;
 
     private:
-        void cacheMeshes(const std::vector<std::string>& meshPaths);
-        void cacheTextures(const std::vector<std::string>& colorTexturePaths,VkFormat format);
-        void cacheCompressedTextures(const std::vector<std::string>& pngPaths,ktx_transcode_fmt_e targetFormat=KTX_TTF_BC7_RGBA, const std::string& label="Compressed textures");
-        void cacheMaterials(const std::vector<std::string>& materialPaths);
-        void createEntityFromUnityData(const Resources::DeserializedGameObject& gameObject);
-        void createScene(const Resources::DeserializedScene& deserializedScene);
-        bool loadSkyboxCubemap(const std::array<std::string,6> texturesDirs);
-        std::vector<std::string> getCompressedTexturePaths();
+        // CPU-side results produced on the worker pool and consumed in submission order on the loading thread
+        struct StbiImageDeleter {
+            void operator()(void* pixels) const { stbi_image_free(pixels); }
+        };
+        struct KtxTextureDeleter {
+            void operator()(ktxTexture2* texture) const { ktxTexture2_Destroy(texture); }
+        };
+
+        struct DecodedMesh {
+            bool valid = false;
+            bool fromBinary = false;
+            bool fromCache = false;
+            std::string id;
+            // Binary meshes point into the mapping, JSON meshes into the owned vectors
+            std::unique_ptr<MappedFile> mapping;
+            std::vector<Rendering::Mesh::Vertex> vertices;
+            std::vector<uint32_t> indices;
+            const Rendering::Mesh::Vertex* vertexData = nullptr;
+            uint32_t vertexCount = 0;
+            const uint32_t* indexData = nullptr;
+            uint32_t indexCount = 0;
+            std::vector<Rendering::Mesh::Submesh> submeshes;
+            glm::vec3 boundsMin{0.0f};
+            glm::vec3 boundsMax{0.0f};
+            double decodeMs = 0.0;
+        };
+
+        struct DecodedTexture {
+            std::string path;
+            // Prebuilt mip chain when available: a derived data cache entry, the transcoded KTX2, or RGBA8 levels built
+            // on a cache miss. levelData points into whichever of the three holds it
+            std::unique_ptr<MappedFile> cacheMapping;
+            std::unique_ptr<ktxTexture2, KtxTextureDeleter> ktx;
+            std::vector<unsigned char> builtLevels;
+            const unsigned char* levelData = nullptr;
+            std::vector<VkDeviceSize> levelOffsets;     // per level from level 0, in any order within levelData
+            std::vector<VkDeviceSize> levelSizes;
+            VkFormat levelFormat = VK_FORMAT_UNDEFINED;
+            bool fromKtx = false;
+            bool fromCache = false;
+            uint64_t cacheKey = 0;                      // entry the levels were read from or written to, 0 for none
+            DerivedDataKind cacheKind = DerivedDataKind::TextureMips;
+            // Set when a PNG chain was block-compressed during this load, for the report
+            bool encoded = false;
+            double encodeMs = 0.0;
+            double encodePsnr = 0.0;                    // level 0 against the source
+            size_t uncompressedBytes = 0;
+            // Otherwise the RGBA8 source image, mipmapped on the GPU
+            std::unique_ptr<stbi_uc, StbiImageDeleter> pixels;
+            ktx_transcode_fmt_e transcodeFormat = KTX_TTF_BC7_RGBA;
+            int width = 0;
+            int height = 0;
+            double decodeMs = 0.0;
+        };
+
+        struct DecodedSkyboxFace {
+            std::unique_ptr<float, StbiImageDeleter> pixels;
+            int width = 0;
+            int height = 0;
+            std::string error;
+            double decodeMs = 0.0;
+        };
+
+        struct DecodedMaterial {
+            bool valid = false;
+            std::string path;
+            DeserializedMaterial data;
+            double decodeMs = 0.0;
+        };
+
+        struct LoadStageTiming {
+            std::string name;
+            double wallMs = 0.0;    // time the loading thread spent in the stage, waits and upload recording included
+            double workerMs = 0.0;  // summed decode time of the stage's jobs across the pool
+        };
+
+        // Streamer registrations are replayed on the thread that runs TextureStreamer::update()
+        struct StreamingRegistration {
+            Rendering::Texture* tail;
+            TextureStreamer::Source source;
+            uint32_t tailLevel;
+        };
+
+        // Components of a run of game objects, gathered so that each type goes to the ECS in one call and the
+        // renderers and lights to the scene octrees in one pass
+        struct EntityBatch {
+            std::vector<ECS::EntityID> transformEntities;
+            std::vector<ECS::Transform> transforms;
+            std::vector<ECS::EntityID> cameraEntities;
+            std::vector<ECS::Camera> cameras;
+            std::vector<ECS::EntityID> directionalLightEntities;
+            std::vector<ECS::DirectionalLight> directionalLights;
+            std::vector<ECS::EntityID> spotLightEntities;
+            std::vector<ECS::SpotLight> spotLights;
+            std::vector<ECS::EntityID> pointLightEntities;
+            std::vector<ECS::PointLight> pointLights;
+            std::vector<ECS::EntityID> renderableEntities;
+            std::vector<ECS::Renderable> renderables;
+
+            void clear();
+        };
+
+        // State of beginUnitySceneLoad(); scene is written by the loader thread before parsed is set and only read
+        // afterwards, everything else it fills is handed over by the prepare future
+        struct IncrementalLoad {
+            DeserializedScene scene;
+            std::atomic<bool> parsed{false};
+            std::vector<DecodedMaterial> materials;
+            std::vector<LoadStageTiming> stages;
+            Rendering::UploadManager::Stats uploadStats{};
+            uint32_t workerCount = 0;
+            std::chrono::high_resolution_clock::time_point start;
+
+            bool resourcesReady = false;
+            size_t nextObject = 0;          // next game object without a mesh renderer, committed while preparing
+            size_t nextMaterial = 0;
+            size_t nextRenderer = 0;        // next game object with a mesh renderer, committed once resources are ready
+            uint32_t commitFrames = 0;
+            double commitMs = 0.0;
+            ECS::EntityID firstEntity = 0;  // game object i becomes firstEntity + i, reserved once parsed
+            bool entitiesReserved = false;
+            EntityBatch batch;
+        };
+
+        static DecodedMesh decodeMesh(const std::string& meshPath);
+        // Maps the .amesh next to meshPath; false when missing, stale or invalid
+        static bool decodeBinaryMesh(const std::string& meshPath, DecodedMesh& decoded);
+        static bool mapBinaryMesh(const std::string& binaryPath, DecodedMesh& decoded);
+        static bool decodeJsonMesh(const std::string& meshPath, DecodedMesh& decoded);
+        // Stores a JSON-decoded mesh in the derived data cache
+        static void cacheDecodedMesh(uint64_t cacheKey, const DecodedMesh& decoded);
+        // Tries the .ktx2 next to path first (transcoded to targetFormat) unless pngOnly, then falls back to the PNG,
+        // whose mips are built for format. Both go through the derived data cache
+        static DecodedTexture decodeTexture(const std::string& path, ktx_transcode_fmt_e targetFormat, bool pngOnly, VkFormat format);
+        static bool readCachedTexture(DerivedDataKind kind, DecodedTexture& decoded);
+        // Replaces the RGBA8 chain in builtLevels with compressedFormat blocks
+        static void compressLevels(DecodedTexture& decoded, VkFormat compressedFormat);
+        static DecodedSkyboxFace decodeSkyboxFace(const std::string& path);
+        static DecodedMaterial decodeMaterial(const std::string& materialPath);
+
+        static bool hasMeshRenderer(const DeserializedGameObject& gameObject);
+
+        LoadStageTiming parseScene(const std::string& jsonPath, DeserializedScene& scene);
+        // Decodes and uploads every mesh, texture and the skybox and reads the material files, waiting for the uploads
+        // to complete; touches only the resource manager and the upload manager. Returns the worker thread count
+        uint32_t prepareResources(const DeserializedScene& scene, std::vector<DecodedMaterial>& materials, std::vector<LoadStageTiming>& stages);
+        LoadStageTiming cacheMeshes(std::vector<std::future<DecodedMesh>>& meshJobs);
+        LoadStageTiming cacheTextures(std::vector<std::future<DecodedTexture>>& textureJobs, VkFormat format, const std::string& label);
+        // Reads the material files and caches the textures only they reference
+        LoadStageTiming cacheMaterialTextures(std::vector<std::future<DecodedMaterial>>& materialJobs, ThreadPool& workerPool, std::vector<DecodedMaterial>& materials);
+        void registerStreamedTextures();
+        void createMaterial(const DecodedMaterial& material);
+        // Converts a game object into entity's components; nothing reaches the ECS until commitBatch
+        void appendToBatch(const Resources::DeserializedGameObject& gameObject, ECS::EntityID entity, EntityBatch& batch);
+        // Adds the batch to the ECS and its lights and renderers to the scene, then clears it
+        void commitBatch(EntityBatch& batch);
+        void applyEnvironmentLighting(const Resources::DeserializedScene& deserializedScene);
+        // Uploads environment when it came from the cache, otherwise prefilters the decoded faces on workerPool first
+        LoadStageTiming loadSkyboxCubemap(std::vector<std::future<DecodedSkyboxFace>>& faceJobs, PrefilteredEnvironment& environment,
+                                          uint64_t environmentKey, ThreadPool& workerPool);
+        void printLoadReport(const std::vector<LoadStageTiming>& stages, const Rendering::UploadManager::Stats& uploadStats, double totalMs, uint32_t workerCount);
         void createSkyboxEntity();
         
+
         std::string getCompressedTexturePath(const std::string& texturePath);
         ResourceManager& resourceManager;
         Rendering::Device& device;
+        Rendering::UploadManager& uploadManager;
+        TextureStreamer* textureStreamer;
         Rendering::DescriptorPool& descriptorPool;
         ECS::ECSManager& ecsManager;
         std::string basePath;
         std::unordered_map<std::string, std::string> compressedTextureMap;
+        std::vector<StreamingRegistration> pendingStreamingRegistrations;
+        // Set by the loader thread with the skybox, read by applyEnvironmentLighting
+        std::array<glm::vec4, 9> skyboxIrradianceSH{};
+        bool hasSkyboxIrradiance = false;
+
+        // Progress counters, the atomic ones are advanced by the loader thread
+        std::atomic<uint32_t> preparedResources{0};
+        std::atomic<uint32_t> resourceCount{0};
+        std::atomic<uint32_t> objectCount{0};
+        uint32_t committedObjects = 0;
+        LoadPhase phase = LoadPhase::Idle;
+        std::unique_ptr<IncrementalLoad> incrementalLoad;
+
+        // Declared last so the loader thread is joined before anything it touches goes away
+        std::future<void> prepareJob;
     };
 } // namespace Resources
 
@@ -0,0 +1,470 @@
+#include "texture_streamer.hpp"
+#include "external/libraries/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace Resources {
+
+namespace {
+    float srgbToLinear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+}
+
+TextureStreamer::TextureStreamer(Rendering::Device& device, Rendering::UploadManager& uploadManager, Rendering::DescriptorPool& materialPool)
+    : device{device}, uploadManager{uploadManager}, materialPool{materialPool} {}
+
+TextureStreamer::~TextureStreamer() {
+    // Uploads still in flight write into images owned by pendingLoads
+    uploadManager.finish();
+    releaseRetired(true);
+}
+
+uint32_t TextureStreamer::tailLevelFor(uint32_t width, uint32_t height, uint32_t levelCount) {
+    uint32_t level = 0;
+    while (level + 1 < levelCount && std::max(width >> level, height >> level) > TEXTURE_STREAMING_TAIL_SIZE) {
+        level++;
+    }
+    return level;
+}
+
+std::vector<unsigned char> TextureStreamer::downsampleRGBA8(const unsigned char* pixels, uint32_t& width, uint32_t& height, uint32_t levels, bool srgb) {
+    std::vector<unsigned char> current(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    float toLinear[256];
+    for (int i = 0; i < 256; i++) {
+        toLinear[i] = srgb ? srgbToLinear(i / 255.0f) : i / 255.0f;
+    }
+
+    for (uint32_t level = 0; level < levels && (width > 1 || height > 1); level++) {
+        uint32_t nextWidth = std::max(width / 2, 1u);
+        uint32_t nextHeight = std::max(height / 2, 1u);
+        std::vector<unsigned char> next(static_cast<size_t>(nextWidth) * nextHeight * 4);
+
+        for (uint32_t y = 0; y < nextHeight; y++) {
+            uint32_t y0 = std::min(y * 2, height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, height - 1);
+            for (uint32_t x = 0; x < nextWidth; x++) {
+                uint32_t x0 = std::min(x * 2, width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                const unsigned char* taps[4] = {
+                    &current[(static_cast<size_t>(y0) * width + x0) * 4],
+                    &current[(static_cast<size_t>(y0) * width + x1) * 4],
+                    &current[(static_cast<size_t>(y1) * width + x0) * 4],
+                    &current[(static_cast<size_t>(y1) * width + x1) * 4]
+                };
+                unsigned char* out = &next[(static_cast<size_t>(y) * nextWidth + x) * 4];
+                for (int channel = 0; channel < 4; channel++) {
+                    // Alpha is always linear
+                    bool linearChannel = channel == 3 || !srgb;
+                    float sum = 0.0f;
+                    for (const unsigned char* tap : taps) {
+                        sum += linearChannel ? tap[channel] / 255.0f : toLinear[tap[channel]];
+                    }
+                    float average = sum * 0.25f;
+                    float encoded = linearChannel ? average : linearToSrgb(average);
+                    out[channel] = static_cast<unsigned char>(std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+
+        current = std::move(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    return current;
+}
+
+void TextureStreamer::registerTexture(Rendering::Texture* tailTexture, const Source& source, uint32_t tailLevel) {
+    if (tailTexture == nullptr || entryByTail.count(tailTexture) != 0) {
+        return;
+    }
+
+    Entry entry;
+    entry.source = source;
+    entry.tail = tailTexture;
+    entry.tailLevel = tailLevel;
+    entry.tailBytes = imageBytes(*tailTexture);
+    entry.residentLevel = tailLevel;
+    entry.wantedLevel = tailLevel;
+
+    entryByTail[tailTexture] = static_cast<uint32_t>(entries.size());
+    entries.push_back(std::move(entry));
+}
+
+void TextureStreamer::registerMaterial(Rendering::Material* material) {
+    for (Rendering::Texture* texture : material->getTextures()) {
+        auto it = entryByTail.find(texture);
+        if (it == entryByTail.end()) {
+            continue;
+        }
+        std::vector<uint32_t>& materialEntries = entriesByMaterial[material];
+        if (std::find(materialEntries.begin(), materialEntries.end(), it->second) == materialEntries.end()) {
+            materialEntries.push_back(it->second);
+            entries[it->second].materials.push_back(material);
+        }
+    }
+}
+
+void TextureStreamer::unregisterTexture(Rendering::Texture* tailTexture) {
+    auto it = entryByTail.find(tailTexture);
+    if (it == entryByTail.end()) {
+        return;
+    }
+    const uint32_t entryIndex = it->second;
+    Entry& entry = entries[entryIndex];
+    if (entry.streamed) {
+        swapTexture(entry, nullptr, entry.tailLevel);
+    }
+    for (Rendering::Material* material : entry.materials) {
+        std::vector<uint32_t>& materialEntries = entriesByMaterial[material];
+        materialEntries.erase(std::remove(materialEntries.begin(), materialEntries.end(), entryIndex), materialEntries.end());
+    }
+    // Entry indices stay stable; the emptied entry is never scheduled again
+    entry.materials.clear();
+    entry.tail = nullptr;
+    entry.failed = true;
+    entryByTail.erase(it);
+}
+
+void TextureStreamer::unregisterMaterial(Rendering::Material* material) {
+    auto it = entriesByMaterial.find(material);
+    if (it == entriesByMaterial.end()) {
+        return;
+    }
+    for (uint32_t entryIndex : it->second) {
+        std::vector<Rendering::Material*>& materials = entries[entryIndex].materials;
+        materials.erase(std::remove(materials.begin(), materials.end(), material), materials.end());
+    }
+    entriesByMaterial.erase(it);
+}
+
+void TextureStreamer::update(const Rendering::FrameContext& frameContext) {
+    frameNumber++;
+    releaseRetired(false);
+    gatherDemand(frameContext);
+    commitLoads();
+    scheduleLoads();
+}
+
+TextureStreamer::Stats TextureStreamer::getStats() const {
+    Stats stats{};
+    for (const auto& entry : entries) {
+        if (entry.streamed) {
+            stats.streamedCount++;
+        }
+    }
+    stats.streamedBytes = residentBytes;
+    stats.pendingCount = static_cast<uint32_t>(pendingLoads.size());
+    stats.evictionCount = evictionCount;
+    return stats;
+}
+
+void TextureStreamer::gatherDemand(const Rendering::FrameContext& frameContext) {
+    for (const auto& [material, density] : frameContext.materialScreenDensity) {
+        auto it = entriesByMaterial.find(material);
+        if (it == entriesByMaterial.end()) {
+            continue;
+        }
+
+        for (uint32_t entryIndex : it->second) {
+            Entry& entry = entries[entryIndex];
+            // Level at which one texel covers about one pixel
+            float texelsPerPixel = std::max(entry.source.width, entry.source.height) / std::max(density, 1e-6f);
+            float level = std::log2(std::max(texelsPerPixel, 1.0f)) + TEXTURE_STREAMING_MIP_BIAS;
+            uint32_t wanted = std::min(static_cast<uint32_t>(std::max(level, 0.0f)), entry.tailLevel);
+
+            if (entry.lastUsedFrame != frameNumber) {
+                entry.lastUsedFrame = frameNumber;
+                entry.wantedLevel = wanted;
+            } else {
+                entry.wantedLevel = std::min(entry.wantedLevel, wanted);
+            }
+        }
+    }
+}
+
+void TextureStreamer::commitLoads() {
+    uint32_t swapCount = 0;
+    for (auto it = pendingLoads.begin(); it != pendingLoads.end();) {
+        PendingLoad& load = *it;
+        Entry& entry = entries[load.entryIndex];
+
+        if (!load.texture) {
+            if (load.decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            DecodedLevels decoded = load.decode.get();
+            if (entry.tail == nullptr) {
+                entry.pending = false;
+                pendingBytes -= load.estimatedBytes;
+                it = pendingLoads.erase(it);
+                continue;
+            }
+            if (!decoded.valid) {
+                std::cerr << "Texture streaming could not read " << entry.source.path << ", keeping its tail" << std::endl;
+                entry.failed = true;
+                entry.pending = false;
+                pendingBytes -= load.estimatedBytes;
+                it = pendingLoads.erase(it);
+                continue;
+            }
+
+            std::string debugName = std::filesystem::path(entry.source.path).filename().string() + "_mip" + std::to_string(load.level);
+            if (decoded.prebuilt) {
+                load.texture = std::make_unique<Rendering::Texture>(
+                    device, uploadManager,
+                    decoded.width, decoded.height, decoded.format, decoded.levelCount,
+                    decoded.data.data(), static_cast<VkDeviceSize>(decoded.data.size()), decoded.levelOffsets,
+                    debugName);
+            } else {
+                load.texture = std::make_unique<Rendering::Texture>(
+                    device, uploadManager,
+                    decoded.width, decoded.height, decoded.format,
+                    decoded.data.data(),
+                    debugName);
+            }
+            // Submitted now, swapped in on a later frame once the GPU is done with it
+            load.ticket = uploadManager.flush();
+            ++it;
+            continue;
+        }
+
+        // Unregistered while uploading: nothing can sample the new image, so it goes as soon as the copy is done
+        if (entry.tail == nullptr) {
+            if (uploadManager.isComplete(load.ticket)) {
+                pendingBytes -= load.estimatedBytes;
+                entry.pending = false;
+                it = pendingLoads.erase(it);
+            } else {
+                ++it;
+            }
+            continue;
+        }
+
+        if (swapCount >= TEXTURE_STREAMING_MAX_SWAPS_PER_FRAME || !uploadManager.isComplete(load.ticket) || !hasDescriptorHeadroom(entry)) {
+            ++it;
+            continue;
+        }
+
+        pendingBytes -= load.estimatedBytes;
+        swapTexture(entry, std::move(load.texture), load.level);
+        entry.pending = false;
+        swapCount++;
+        it = pendingLoads.erase(it);
+    }
+}
+
+void TextureStreamer::scheduleLoads() {
+    // Visible textures that want more detail than is resident, largest shortfall first
+    std::vector<uint32_t> requests;
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        if (entry.lastUsedFrame == frameNumber && entry.wantedLevel < entry.residentLevel && !entry.pending && !entry.failed) {
+            requests.push_back(i);
+        }
+    }
+    std::sort(requests.begin(), requests.end(), [this](uint32_t a, uint32_t b) {
+        return entries[a].residentLevel - entries[a].wantedLevel > entries[b].residentLevel - entries[b].wantedLevel;
+    });
+
+    for (uint32_t entryIndex : requests) {
+        if (pendingLoads.size() >= TEXTURE_STREAMING_MAX_PENDING) {
+            break;
+        }
+
+        Entry& entry = entries[entryIndex];
+        VkDeviceSize estimate = estimateBytes(entry, entry.wantedLevel);
+        VkDeviceSize committed = residentBytes + pendingBytes + estimate - entry.streamedBytes;
+        if (committed > TEXTURE_STREAMING_BUDGET && !evict(committed - TEXTURE_STREAMING_BUDGET, entryIndex)) {
+            continue;
+        }
+
+        PendingLoad load{};
+        load.entryIndex = entryIndex;
+        load.level = entry.wantedLevel;
+        load.estimatedBytes = estimate;
+        load.decode = decodePool.submit([source = entry.source, level = entry.wantedLevel]() {
+            return decodeLevels(source, level);
+        });
+        entry.pending = true;
+        pendingBytes += estimate;
+        pendingLoads.push_back(std::move(load));
+    }
+}
+
+bool TextureStreamer::evict(VkDeviceSize bytesNeeded, uint32_t protectedEntry) {
+    // Unseen textures go first, oldest first; visible ones only when they hold more detail than they need
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        bool overResident = entry.residentLevel < entry.wantedLevel;
+        if (i != protectedEntry && entry.streamed && !entry.pending && (entry.lastUsedFrame != frameNumber || overResident)) {
+            candidates.push_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return entries[a].lastUsedFrame < entries[b].lastUsedFrame;
+    });
+
+    VkDeviceSize freeable = 0;
+    size_t victimCount = 0;
+    size_t descriptorSets = retiredDescriptorSetCount;
+    while (victimCount < candidates.size() && freeable < bytesNeeded) {
+        const Entry& entry = entries[candidates[victimCount]];
+        descriptorSets += entry.materials.size();
+        if (descriptorSets > TEXTURE_STREAMING_DESCRIPTOR_HEADROOM) {
+            break;
+        }
+        freeable += entry.streamedBytes;
+        victimCount++;
+    }
+    if (freeable < bytesNeeded) {
+        return false;
+    }
+
+    for (size_t i = 0; i < victimCount; i++) {
+        Entry& entry = entries[candidates[i]];
+        swapTexture(entry, nullptr, entry.tailLevel);
+        evictionCount++;
+    }
+    return true;
+}
+
+void TextureStreamer::swapTexture(Entry& entry, std::unique_ptr<Rendering::Texture> texture, uint32_t level) {
+    Rendering::Texture* current = entry.streamed ? entry.streamed.get() : entry.tail;
+    Rendering::Texture* next = texture ? texture.get() : entry.tail;
+
+    Retired retiredResources{frameNumber};
+    for (Rendering::Material* material : entry.materials) {
+        VkDescriptorSet previousSet = material->replaceTexture(current, next);
+        if (previousSet != VK_NULL_HANDLE) {
+            retiredResources.descriptorSets.push_back(previousSet);
+        }
+    }
+    retiredResources.texture = std::move(entry.streamed);
+    retiredDescriptorSetCount += retiredResources.descriptorSets.size();
+    retired.push_back(std::move(retiredResources));
+
+    residentBytes -= entry.streamedBytes;
+    entry.streamed = std::move(texture);
+    entry.streamedBytes = entry.streamed ? imageBytes(*entry.streamed) : 0;
+    residentBytes += entry.streamedBytes;
+    entry.residentLevel = level;
+}
+
+void TextureStreamer::releaseRetired(bool all) {
+    while (!retired.empty() && (all || retired.front().frame + device.getFramesInFlight() <= frameNumber)) {
+        materialPool.freeDescriptors(retired.front().descriptorSets);
+        retiredDescriptorSetCount -= retired.front().descriptorSets.size();
+        retired.pop_front();
+    }
+}
+
+bool TextureStreamer::hasDescriptorHeadroom(const Entry& entry) const {
+    return retiredDescriptorSetCount + entry.materials.size() <= TEXTURE_STREAMING_DESCRIPTOR_HEADROOM;
+}
+
+VkDeviceSize TextureStreamer::estimateBytes(const Entry& entry, uint32_t level) const {
+    // Every level up from the tail roughly quadruples the chain
+    VkDeviceSize bytes = entry.tailBytes;
+    for (uint32_t i = level; i < entry.tailLevel; i++) {
+        bytes *= 4;
+    }
+    return bytes;
+}
+
+VkDeviceSize TextureStreamer::imageBytes(const Rendering::Texture& texture) const {
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(device.getDevice(), texture.getImage(), &memoryRequirements);
+    return memoryRequirements.size;
+}
+
+TextureStreamer::DecodedLevels TextureStreamer::decodeLevels(const Source& source, uint32_t firstLevel) {
+    DecodedLevels decoded;
+
+    MappedFile cacheMapping;
+    DerivedTextureView cached;
+    if (source.cacheKey != 0 && DerivedDataCache::readTexture(source.cacheKey, source.cacheKind, cacheMapping, cached) &&
+        firstLevel < cached.header->levelCount) {
+        for (uint32_t level = firstLevel; level < cached.header->levelCount; level++) {
+            decoded.levelOffsets.push_back(decoded.data.size());
+            decoded.data.insert(decoded.data.end(), cached.data + cached.levels[level].offset,
+                                cached.data + cached.levels[level].offset + cached.levels[level].size);
+        }
+        decoded.prebuilt = true;
+        decoded.format = static_cast<VkFormat>(cached.header->format);
+        decoded.width = std::max(cached.header->width >> firstLevel, 1u);
+        decoded.height = std::max(cached.header->height >> firstLevel, 1u);
+        decoded.levelCount = cached.header->levelCount - firstLevel;
+        decoded.valid = true;
+        return decoded;
+    }
+
+    if (source.ktx) {
+        std::filesystem::path ktxPath(source.path);
+        ktxPath.replace_extension(".ktx2");
+
+        ktxTexture2* kTexture2 = nullptr;
+        if (ktxTexture2_CreateFromNamedFile(ktxPath.string().c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture2) != KTX_SUCCESS) {
+            return decoded;
+        }
+        KTX_error_code result = KTX_SUCCESS;
+        if (ktxTexture2_NeedsTranscoding(kTexture2)) {
+            result = ktxTexture2_TranscodeBasis(kTexture2, source.transcodeFormat, 0);
+        }
+        if (result != KTX_SUCCESS || firstLevel >= kTexture2->numLevels) {
+            ktxTexture2_Destroy(kTexture2);
+            return decoded;
+        }
+
+        // Only the requested levels are kept, packed in level order
+        ktxTexture* baseTexture = ktxTexture(kTexture2);
+        const unsigned char* data = ktxTexture_GetData(baseTexture);
+        for (uint32_t level = firstLevel; level < kTexture2->numLevels; level++) {
+            ktx_size_t offset = 0;
+            ktxTexture_GetImageOffset(baseTexture, level, 0, 0, &offset);
+            ktx_size_t size = ktxTexture_GetImageSize(baseTexture, level);
+            decoded.levelOffsets.push_back(decoded.data.size());
+            decoded.data.insert(decoded.data.end(), data + offset, data + offset + size);
+        }
+
+        decoded.prebuilt = true;
+        decoded.format = static_cast<VkFormat>(kTexture2->vkFormat);
+        decoded.width = std::max(kTexture2->baseWidth >> firstLevel, 1u);
+        decoded.height = std::max(kTexture2->baseHeight >> firstLevel, 1u);
+        decoded.levelCount = kTexture2->numLevels - firstLevel;
+        decoded.valid = true;
+        ktxTexture2_Destroy(kTexture2);
+        return decoded;
+    }
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc* pixels = stbi_load(source.path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (pixels == nullptr) {
+        return decoded;
+    }
+
+    decoded.width = static_cast<uint32_t>(width);
+    decoded.height = static_cast<uint32_t>(height);
+    decoded.data = downsampleRGBA8(pixels, decoded.width, decoded.height, firstLevel, source.format == VK_FORMAT_R8G8B8A8_SRGB);
+    stbi_image_free(pixels);
+
+    decoded.format = source.format;
+    decoded.valid = true;
+    return decoded;
+}
+
+} // namespace Resources
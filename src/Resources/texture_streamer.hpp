@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Rendering/Core/device.hpp"
+#include "Rendering/Core/descriptors.hpp"
+#include "Rendering/Core/upload_manager.hpp"
+#include "Rendering/Core/frame_context.hpp"
+#include "Rendering/Resources/material.hpp"
+#include "Rendering/Resources/texture.hpp"
+#include "Rendering/rendering_constants.hpp"
+#include "derived_data_cache.hpp"
+#include "thread_pool.hpp"
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Resources {
+    // Keeps scene textures at the resolution they are seen at. The loader uploads only the mip tail of each texture;
+    // every frame the streamer turns the per-material screen density gathered by CameraCulling into a wanted mip,
+    // decodes the missing levels on a background thread, uploads them through the UploadManager and, once the upload
+    // has completed on the GPU, points the materials at the new image. Streamed images count against
+    // TEXTURE_STREAMING_BUDGET and fall back to their tail least-recently-used first.
+    // Not thread-safe: registration and update() both happen on the render thread (the loader defers registrations).
+    class TextureStreamer {
+    public:
+        // Where the full mip chain of a texture is read back from
+        struct Source {
+            std::string path;                   // source image; KTX2 sources are read from the .ktx2 next to it
+            bool ktx = false;
+            ktx_transcode_fmt_e transcodeFormat = KTX_TTF_BC7_RGBA;
+            VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;  // upload format of decoded RGBA sources
+            uint32_t width = 0;                 // level 0
+            uint32_t height = 0;
+            uint32_t levelCount = 1;            // full chain
+            uint64_t cacheKey = 0;              // derived data cache entry holding the prebuilt chain, tried first
+            DerivedDataKind cacheKind = DerivedDataKind::TextureMips;
+        };
+
+        struct Stats {
+            uint32_t streamedCount = 0;         // textures above their tail
+            VkDeviceSize streamedBytes = 0;
+            uint32_t pendingCount = 0;
+            uint32_t evictionCount = 0;         // since creation
+        };
+
+        TextureStreamer(Rendering::Device& device, Rendering::UploadManager& uploadManager, Rendering::DescriptorPool& materialPool);
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        // tailTexture holds levels tailLevel.. of source and stays owned by the caller; it is what eviction falls back to
+        void registerTexture(Rendering::Texture* tailTexture, const Source& source, uint32_t tailLevel);
+        // Call once the material's textures are set and registered
+        void registerMaterial(Rendering::Material* material);
+        // Before the resource manager unloads them. An unregistered texture falls back to its tail first (the caller
+        // then takes the tail out of its materials); a level still uploading for it is dropped once the upload lands
+        void unregisterTexture(Rendering::Texture* tailTexture);
+        void unregisterMaterial(Rendering::Material* material);
+
+        // Once per frame, after culling and before any pass records; frames that used retired images are complete by
+        // the time they are destroyed since the renderer waits Device::getFramesInFlight() frames back
+        void update(const Rendering::FrameContext& frameContext);
+
+        Stats getStats() const;
+
+        // First level whose larger side fits TEXTURE_STREAMING_TAIL_SIZE
+        static uint32_t tailLevelFor(uint32_t width, uint32_t height, uint32_t levelCount);
+        // Halves RGBA8 pixels levels times with a 2x2 box filter, averaging sRGB data in linear space
+        static std::vector<unsigned char> downsampleRGBA8(const unsigned char* pixels, uint32_t& width, uint32_t& height, uint32_t levels, bool srgb);
+
+    private:
+        struct Entry {
+            Source source;
+            Rendering::Texture* tail = nullptr;             // null once unregistered
+            uint32_t tailLevel = 0;
+            VkDeviceSize tailBytes = 0;
+            std::unique_ptr<Rendering::Texture> streamed;   // null while only the tail is resident
+            VkDeviceSize streamedBytes = 0;
+            uint32_t residentLevel = 0;
+            uint32_t wantedLevel = 0;                       // valid for lastUsedFrame
+            uint64_t lastUsedFrame = 0;
+            bool pending = false;
+            bool failed = false;                            // source could not be read, stays at its tail
+            std::vector<Rendering::Material*> materials;
+        };
+
+        // CPU side of a streaming request, built on the decode thread
+        struct DecodedLevels {
+            bool valid = false;
+            bool prebuilt = false;          // data holds the whole chain (KTX2); otherwise level 0 only, blitted on upload
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t levelCount = 0;
+            std::vector<unsigned char> data;
+            std::vector<VkDeviceSize> levelOffsets;
+        };
+
+        struct PendingLoad {
+            uint32_t entryIndex;
+            uint32_t level;
+            VkDeviceSize estimatedBytes;
+            std::future<DecodedLevels> decode;
+            std::unique_ptr<Rendering::Texture> texture;    // set once uploaded, swapped in when ticket completes
+            Rendering::UploadTicket ticket = 0;
+        };
+
+        struct Retired {
+            uint64_t frame;
+            std::unique_ptr<Rendering::Texture> texture;
+            std::vector<VkDescriptorSet> descriptorSets;
+        };
+
+        static DecodedLevels decodeLevels(const Source& source, uint32_t firstLevel);
+
+        void gatherDemand(const Rendering::FrameContext& frameContext);
+        void commitLoads();
+        void scheduleLoads();
+        // Frees at least bytesNeeded of streamed memory from textures other than protectedEntry, or nothing at all
+        bool evict(VkDeviceSize bytesNeeded, uint32_t protectedEntry);
+        // Points the entry's materials at texture (its tail when null) and retires what they used before
+        void swapTexture(Entry& entry, std::unique_ptr<Rendering::Texture> texture, uint32_t level);
+        void releaseRetired(bool all);
+        bool hasDescriptorHeadroom(const Entry& entry) const;
+        VkDeviceSize estimateBytes(const Entry& entry, uint32_t level) const;
+        VkDeviceSize imageBytes(const Rendering::Texture& texture) const;
+
+        Rendering::Device& device;
+        Rendering::UploadManager& uploadManager;
+        Rendering::DescriptorPool& materialPool;
+
+        std::vector<Entry> entries;
+        std::unordered_map<Rendering::Texture*, uint32_t> entryByTail;
+        std::unordered_map<Rendering::Material*, std::vector<uint32_t>> entriesByMaterial;
+
+        std::vector<PendingLoad> pendingLoads;
+        std::deque<Retired> retired;
+        size_t retiredDescriptorSetCount = 0;
+
+        uint64_t frameNumber = 0;
+        VkDeviceSize residentBytes = 0;     // streamed images currently bound to materials
+        VkDeviceSize pendingBytes = 0;      // estimated size of the loads in flight
+        uint32_t evictionCount = 0;
+
+        // Declared last so the worker is joined before anything its jobs could touch goes away
+        ThreadPool decodePool{1, "Texture streaming"};
+    };
+} // namespace Resources
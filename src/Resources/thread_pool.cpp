@@ -0,0 +1,58 @@
+#include "thread_pool.hpp"
+#include "Engine/cpu_profiler.hpp"
+
+#include <string>
+
+namespace Resources {
+
+namespace {
+    thread_local uint32_t workerIndexOfThread = UINT32_MAX;
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount, const char* name) : name{name} {
+    if (threadCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    // Queued jobs still run so that no future is left without a value
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::currentWorkerIndex() {
+    return workerIndexOfThread;
+}
+
+void ThreadPool::workerLoop(uint32_t workerIndex) {
+    CPU_PROFILE_THREAD(std::string(name) + " " + std::to_string(workerIndex));
+    workerIndexOfThread = workerIndex;
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+} // namespace Resources
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Resources {
+    // Fixed set of worker threads draining a FIFO of CPU-only jobs (file reads, decoding, transcoding).
+    // Jobs must not touch the ECS, nor Vulkan objects other threads use (ParallelRecorder gives every worker its
+    // own command pools); their results are consumed on the submitting thread.
+    class ThreadPool {
+    public:
+        // 0 picks hardware_concurrency - 1, leaving a core for the thread that records uploads. Workers are named
+        // "<name> <i>" in the CPU profiler
+        explicit ThreadPool(uint32_t threadCount = 0, const char* name = "Worker");
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        template <typename F>
+        auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            // packaged_task is move-only, std::function needs a copyable target
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+            std::future<Result> future = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                jobs.emplace([task]() { (*task)(); });
+            }
+            jobAvailable.notify_one();
+            return future;
+        }
+
+        uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+        // Index of the calling worker in its pool, for per-worker state; UINT32_MAX outside any pool
+        static uint32_t currentWorkerIndex();
+
+    private:
+        void workerLoop(uint32_t workerIndex);
+
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> jobs;
+        std::mutex queueMutex;
+        std::condition_variable jobAvailable;
+        bool stopping = false;
+        const char* name;
+    };
+} // namespace Resources
@@ -2,6 +2,8 @@
 
 #include "core.hpp"
 
+#include <array>
+
 namespace Scene {
 
 struct EnvironmentLighting {
@@ -9,6 +11,9 @@ struct EnvironmentLighting {
     float ambientIntensity;
     Texture* skyboxTexture{nullptr};
     float reflectionIntensity;
+    // Diffuse irradiance of the skybox as prefiltered by the loader, see Resources::PrefilteredEnvironment
+    std::array<glm::vec4, 9> irradianceSH{};
+    bool hasIrradianceSH = false;
     
     EnvironmentLighting(glm::vec3 ambientColor, float ambientIntensity, Texture* skyboxTexture, float reflectionIntensity)
         : ambientColor(ambientColor), ambientIntensity(ambientIntensity), skyboxTexture(skyboxTexture), reflectionIntensity(reflectionIntensity) {}
@@ -18,6 +18,46 @@ namespace Scene{
         rendererMap[&renderable] = octreeObject;
     }
 
+    void Scene::addRenderers(const std::vector<Renderable*>& renderables){
+        std::vector<AABB> worldAABBs(renderables.size());
+        for(size_t i=0;i<renderables.size();i++){
+            const Renderable& renderable=*renderables[i];
+            BoundingBoxSystem::getWorldBounds(worldAABBs[i],renderable.meshRenderer.mesh->getLocalBounds(),renderable.transform.modelMatrix);
+        }
+
+        auto octreeObjects=rendererTree.createObjects(renderables,worldAABBs);
+        rendererMap.reserve(rendererMap.size()+renderables.size());
+        for(size_t i=0;i<renderables.size();i++){
+            rendererMap[renderables[i]]=octreeObjects[i];
+        }
+    }
+
+    void Scene::addLights(const std::vector<ECS::Light*>& lights){
+        std::vector<AABB> worldAABBs(lights.size());
+        for(size_t i=0;i<lights.size();i++){
+            createLightAABB(*lights[i],worldAABBs[i]);
+        }
+
+        auto octreeObjects=lightTree.createObjects(lights,worldAABBs);
+        lightMap.reserve(lightMap.size()+lights.size());
+        for(size_t i=0;i<lights.size();i++){
+            lightMap[lights[i]]=octreeObjects[i];
+        }
+    }
+
+    void Scene::rebuildSpatialIndex(){
+        rendererTree.rebuild();
+        lightTree.rebuild();
+    }
+
+    void Scene::createLightAABB(ECS::Light& light, AABB& worldAABB){
+        if(light.type==LightType::POINT_LIGHT){
+            createPointLightAABB(static_cast<PointLight&>(light),worldAABB);
+        }else if(light.type==LightType::SPOT_LIGHT){
+            createSpotLightAABB(static_cast<SpotLight&>(light),worldAABB);
+        }
+    }
+
     void Scene::createPointLightAABB(PointLight& light, AABB& worldAABB){
         auto transform=light.transform;
         worldAABB.center = transform.position;
@@ -74,11 +114,7 @@ namespace Scene{
 
     void Scene::addLight(ECS::Light& light){
         AABB worldAABB{};
-        if(light.type==LightType::POINT_LIGHT){ 
-            createPointLightAABB(static_cast<PointLight&>(light),worldAABB);    
-        }else if(light.type==LightType::SPOT_LIGHT){
-            createSpotLightAABB(static_cast<SpotLight&>(light),worldAABB);
-        }
+        createLightAABB(light,worldAABB);
 
         // Create light in octree and store reference
         auto* octreeObject = lightTree.createObject(&light, worldAABB);
@@ -127,11 +163,7 @@ namespace Scene{
         if (it != lightMap.end()) {
             // Calculate new bounds
             AABB worldAABB{};
-            if (light.type == LightType::POINT_LIGHT) {
-                createPointLightAABB(static_cast<PointLight&>(light), worldAABB);
-            } else if (light.type == LightType::SPOT_LIGHT) {
-                createSpotLightAABB(static_cast<SpotLight&>(light), worldAABB);
-            }
+            createLightAABB(light, worldAABB);
             
             // Update the object in the octree
             lightTree.updateObject(it->second, worldAABB);
@@ -26,6 +26,11 @@ namespace Scene{
 
             void addRenderer(Renderable& renderable);
             void addLight(ECS::Light& light);
+            // Bulk versions for scene loading, see Octree::createObjects
+            void addRenderers(const std::vector<Renderable*>& renderables);
+            void addLights(const std::vector<ECS::Light*>& lights);
+            // Rebuilds both octrees top-down once a run of single adds is over
+            void rebuildSpatialIndex();
             void removeRenderer(const Renderable& renderable);
             void removeLight(const ECS::Light& light);
             void updateRenderer(ECS::Renderable& renderable);
@@ -42,6 +47,7 @@ namespace Scene{
             Scene();
             void createSpotLightAABB(SpotLight& light, AABB& worldAABB);
             void createPointLightAABB(PointLight& light, AABB& worldAABB);
+            void createLightAABB(ECS::Light& light, AABB& worldAABB);
             Octree<Renderable> rendererTree;
             Octree<ECS::Light> lightTree;
             std::unordered_map<const Renderable*, typename Octree<Renderable>::OctreeObject*> rendererMap{};
@@ -1,4 +1,7 @@
 #include "camera_culling.hpp"
+#include "Rendering/Resources/rendering_resources.hpp"
+
+#include <cmath>
 
 using namespace ECS;
 using namespace Math;
@@ -10,7 +13,8 @@ namespace Systems{
    void CameraCulling::frustumCullRenderers(
         const ViewFrustum viewFrustum,
         AABB& frameSceneBounds,
-        MeshRenderingData& meshRenderingData)
+        MeshRenderingData& meshRenderingData,
+        FrameContext& frameContext)
     {
 
 
@@ -19,8 +23,16 @@ namespace Systems{
         auto visibleObjects=scene.getVisibleRenderers(viewFrustum);
         scene.getVisibleBounds(viewFrustum,frameSceneBounds);
 
+        // Pixels covered by one world unit at distance one along the view direction
+        const CameraData& cameraData=frameContext.cameraData;
+        float pixelsPerUnitAtOne=frameContext.extent.height/(2.0f*std::tan(cameraData.fov*0.5f));
+        frameContext.materialScreenDensity.clear();
+
         // Process visible objects
         for (const auto& renderable : visibleObjects) {
+            if(TEXTURE_STREAMING_ENABLED){
+                recordScreenDensity(*renderable,cameraData,pixelsPerUnitAtOne,frameContext.materialScreenDensity);
+            }
             uint32_t submeshCount = renderable->meshRenderer.materials.size();
             Mesh* mesh = renderable->meshRenderer.mesh;
             for (uint32_t i = 0; i < submeshCount; i++) {
@@ -45,11 +57,35 @@ namespace Systems{
        
     }
 
+    void CameraCulling::recordScreenDensity(
+        const Renderable& renderable,
+        const CameraData& cameraData,
+        float pixelsPerUnitAtOne,
+        std::unordered_map<Material*, float>& materialScreenDensity)
+    {
+        const Mesh* mesh=renderable.meshRenderer.mesh;
+        const glm::mat4& modelMatrix=renderable.transform.modelMatrix;
+        const AABB& localBounds=mesh->getLocalBounds();
+
+        // Largest axis scale, so non-uniformly scaled objects ask for the sharper mip
+        float scale=glm::max(glm::length(glm::vec3(modelMatrix[0])),glm::max(glm::length(glm::vec3(modelMatrix[1])),glm::length(glm::vec3(modelMatrix[2]))));
+        glm::vec3 worldCenter=glm::vec3(modelMatrix*glm::vec4(localBounds.center,1.0f));
+        float radius=glm::length(localBounds.extents)*scale;
+        float distance=glm::max(glm::length(worldCenter-cameraData.position)-radius,cameraData.nearPlane);
+
+        // pixels per world unit / UV units per world unit
+        float density=pixelsPerUnitAtOne/distance*scale/glm::max(mesh->getUVDensity(),1e-6f);
+        for(Material* material:renderable.meshRenderer.materials){
+            float& materialDensity=materialScreenDensity[material];
+            materialDensity=glm::max(materialDensity,density);
+        }
+    }
+
     void CameraCulling::updateFrameContext(FrameContext& frameContext){
 
         MeshRenderingData meshRenderingData{};
         AABB frameSceneBounds{};
-        frustumCullRenderers(frameContext.cameraData.viewFrustum,frameSceneBounds,meshRenderingData);
+        frustumCullRenderers(frameContext.cameraData.viewFrustum,frameSceneBounds,meshRenderingData,frameContext);
         updateOpaqueModelBuffers(frameContext,meshRenderingData);
         updateTransparentModelBuffers(frameContext,meshRenderingData);
     }
@@ -62,6 +98,9 @@ namespace Systems{
         uint32_t mat4size=sizeof(glm::mat4);
         auto& opaqueModelMap=meshRenderingData.opaqueModelMap;
         auto& opaqueNormalMap=meshRenderingData.opaqueNormalMap;
+        if(frameContext.renderingResources){
+            frameContext.renderingResources->reserveOpaqueInstances(frameContext.frameIndex,meshRenderingData.opaqueInstanceCount);
+        }
 
         for(auto& [key,instances]:opaqueModelMap){
             size_t instancesSize=instances.size();
@@ -95,6 +134,9 @@ namespace Systems{
 
         auto& transparentModelMap=meshRenderingData.transparentModelMap;
         auto& transparentNormalMap=meshRenderingData.transparentNormalMap;
+        if(frameContext.renderingResources){
+            frameContext.renderingResources->reserveTransparentInstances(frameContext.frameIndex,meshRenderingData.transparentInstanceCount);
+        }
 
         for(auto& [key,instances]:transparentModelMap){
             size_t instancesSize=instances.size();
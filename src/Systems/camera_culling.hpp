@@ -17,7 +17,15 @@ namespace Systems{
             static void frustumCullRenderers(
                 const ViewFrustum viewFrustum,
                 AABB& frameSceneBounds,
-                MeshRenderingData& meshRenderingData); 
+                MeshRenderingData& meshRenderingData,
+                FrameContext& frameContext); 
+
+            // Screen pixels per UV unit at the instance's closest point, accumulated per material for texture streaming
+            static void recordScreenDensity(
+                const Renderable& renderable,
+                const CameraData& cameraData,
+                float pixelsPerUnitAtOne,
+                std::unordered_map<Material*, float>& materialScreenDensity);
 
             static void updateOpaqueModelBuffers(
                 FrameContext& frameContext,
@@ -17,6 +17,9 @@ void KeyboardMovemenSystem::run(const float deltaTime) {
     // Check for cursor toggle
     auto& ecsManager = ECSManager::getInstance(); 
     auto cameraEntity = ecsManager.getFirstComponent<Camera>();
+    if (!cameraEntity) {
+        return;
+    }
     Transform& transform = *ecsManager.getComponent<Transform>(cameraEntity->owner);
     handleArrowLook(transform,deltaTime);    
     handleKeyboardMovement(transform, deltaTime);
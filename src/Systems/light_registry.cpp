@@ -0,0 +1,115 @@
+#include "light_registry.hpp"
+#include "ECS/ecs.hpp"
+#include <cstring>
+#include <iostream>
+
+using namespace ECS;
+
+namespace Systems{
+
+    uint64_t LightRegistry::makeKey(EntityID owner, LightType type){
+        return (static_cast<uint64_t>(owner) << 2) | static_cast<uint64_t>(type);
+    }
+
+    void LightRegistry::synchronize(){
+        auto& ecsManager = ECSManager::getInstance();
+        syncCounter++;
+
+        ecsManager.forEachComponent<DirectionalLight>([&](DirectionalLight& light){
+            touch(light.owner, light.type);
+        });
+        ecsManager.forEachComponent<SpotLight>([&](SpotLight& light){
+            touch(light.owner, light.type);
+        });
+        ecsManager.forEachComponent<PointLight>([&](PointLight& light){
+            touch(light.owner, light.type);
+        });
+
+        // Anything not visited this sync has been removed from the ECS
+        for(uint32_t slot = 0; slot < slotHighWater; slot++){
+            if(slots[slot].active && slots[slot].lastSeenSync != syncCounter){
+                releaseSlot(slot);
+            }
+        }
+    }
+
+    uint32_t LightRegistry::getSlot(EntityID owner, LightType type) const{
+        auto it = slotByLight.find(makeKey(owner, type));
+        return it != slotByLight.end() ? it->second : INVALID_LIGHT_SLOT;
+    }
+
+    void LightRegistry::touch(EntityID owner, LightType type){
+        uint32_t slot = getSlot(owner, type);
+        if(slot == INVALID_LIGHT_SLOT){
+            slot = acquireSlot(owner, type);
+            if(slot == INVALID_LIGHT_SLOT){
+                return;
+            }
+        }
+        slots[slot].lastSeenSync = syncCounter;
+    }
+
+    uint32_t LightRegistry::acquireSlot(EntityID owner, LightType type){
+        uint32_t slot = INVALID_LIGHT_SLOT;
+        if(!freeSlots.empty()){
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }else if(slotHighWater < Rendering::MAX_LIGHTS){
+            slot = slotHighWater++;
+        }else{
+            if(!reportedFull){
+                std::cerr << "Light registry full (" << Rendering::MAX_LIGHTS << " slots), ignoring additional lights" << std::endl;
+                reportedFull = true;
+            }
+            return INVALID_LIGHT_SLOT;
+        }
+
+        Slot& entry = slots[slot];
+        entry.owner = owner;
+        entry.type = type;
+        entry.active = true;
+        entry.uploaded = false;
+        entry.lastSeenSync = syncCounter;
+        slotByLight[makeKey(owner, type)] = slot;
+        return slot;
+    }
+
+    void LightRegistry::releaseSlot(uint32_t slot){
+        Slot& entry = slots[slot];
+        slotByLight.erase(makeKey(entry.owner, entry.type));
+        entry.owner = INVALID_ENTITY_ID;
+        entry.active = false;
+        entry.uploaded = false;
+        freeSlots.push_back(slot);
+        reportedFull = false;
+    }
+
+    bool LightRegistry::updateSlot(uint32_t slot, const Rendering::Light& gpuLight){
+        Slot& entry = slots[slot];
+        // Packed lights are zero-filled before assignment, so a byte compare is a reliable change test
+        if(entry.uploaded && std::memcmp(&entry.gpuLight, &gpuLight, sizeof(Rendering::Light)) == 0){
+            return false;
+        }
+        std::memcpy(&entry.gpuLight, &gpuLight, sizeof(Rendering::Light));
+        if(!entry.dirty){
+            entry.dirty = true;
+            dirtySlots.push_back(slot);
+        }
+        return true;
+    }
+
+    void LightRegistry::collectDirtySlots(std::vector<uint32_t>& outDirtySlots){
+        outDirtySlots.clear();
+        for(uint32_t slot : dirtySlots){
+            Slot& entry = slots[slot];
+            entry.dirty = false;
+            // A slot released after it was marked has nothing left worth uploading
+            if(!entry.active){
+                continue;
+            }
+            entry.uploaded = true;
+            outDirtySlots.push_back(slot);
+        }
+        dirtySlots.clear();
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ECS/components.hpp"
+#include "ECS/ecs_types.hpp"
+#include "Rendering/RenderPasses/render_passes_buffers.hpp"
+#include "Rendering/rendering_constants.hpp"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Systems{
+
+    constexpr uint32_t INVALID_LIGHT_SLOT = UINT32_MAX;
+
+    // Stable identity for every light component: a slot in the persistent GPU light buffer that is
+    // keyed by owner entity and light type, so it survives ComponentStorage moving the component
+    class LightRegistry{
+        public:
+            static LightRegistry& getInstance(){
+                static LightRegistry instance{};
+                return instance;
+            }
+
+            LightRegistry(const LightRegistry&) = delete;
+            LightRegistry& operator=(const LightRegistry&) = delete;
+
+            // Gives new light components a slot and frees the slots of lights that no longer exist
+            void synchronize();
+            uint32_t getSlot(ECS::EntityID owner, ECS::LightType type) const;
+
+            // Caches the packed GPU data of a slot and marks it dirty when it differs from the uploaded copy
+            bool updateSlot(uint32_t slot, const Rendering::Light& gpuLight);
+            // Returns the slots changed since the last call; the caller is expected to upload them this frame
+            void collectDirtySlots(std::vector<uint32_t>& outDirtySlots);
+            const Rendering::Light& getSlotData(uint32_t slot) const { return slots[slot].gpuLight; }
+            uint32_t getActiveSlotCount() const { return static_cast<uint32_t>(slotByLight.size()); }
+
+        private:
+            LightRegistry() = default;
+
+            struct Slot{
+                ECS::EntityID owner{ECS::INVALID_ENTITY_ID};
+                ECS::LightType type{ECS::LightType::DIRECTIONAL_LIGHT};
+                bool active{false};
+                bool uploaded{false};   // gpuLight matches the device-local copy
+                bool dirty{false};      // queued in dirtySlots
+                uint32_t lastSeenSync{0};
+                Rendering::Light gpuLight{};
+            };
+
+            static uint64_t makeKey(ECS::EntityID owner, ECS::LightType type);
+            void touch(ECS::EntityID owner, ECS::LightType type);
+            uint32_t acquireSlot(ECS::EntityID owner, ECS::LightType type);
+            void releaseSlot(uint32_t slot);
+
+            std::array<Slot, Rendering::MAX_LIGHTS> slots{};
+            std::unordered_map<uint64_t, uint32_t> slotByLight;
+            std::vector<uint32_t> freeSlots;
+            std::vector<uint32_t> dirtySlots;
+            uint32_t slotHighWater = 0;
+            uint32_t syncCounter = 0;
+            bool reportedFull = false;
+    };
+}
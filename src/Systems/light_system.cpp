@@ -2,12 +2,17 @@
 #include "Rendering/Resources/material.hpp"
 #include "Scene/scene.hpp"
 #include "Systems/bounding_box_system.hpp"
+#include "Rendering/Resources/rendering_resources.hpp"
 #include <iostream>
 #include <vector>
 #include <limits>
 #include <algorithm>
 #include <iomanip>
-#include <unordered_set>
+#include <array>
+#include <functional>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
 using namespace ECS;
 using namespace Math;
 
@@ -19,14 +24,15 @@ namespace Systems{
     void LightSystem::updateDirectionalLight(
         DirectionalLight& directionalLight,
         const Transform& transform,
-        CameraData& cameraData
+        CameraData& cameraData,
+        const glm::vec2& shadowDepthRange
     ) {
         directionalLight.direction = glm::vec4(TransformSystem::getForward(transform), 0.0f);
-        // Calculate the cascade splits first
-        calculateCascadeSplits(directionalLight, cameraData.nearPlane, cameraData.farPlane);
+        // Calculate the cascade splits first (over the visible depth range when SDSM has one)
+        calculateCascadeSplits(directionalLight, shadowDepthRange.x, shadowDepthRange.y);
         
-        // Then calculate the view-projection matrices
-        calculateCascadeViewProjections(directionalLight, cameraData);
+        // Then calculate the view-projection matrices; cascade 0 starts at the same near bound as the splits
+        calculateCascadeViewProjections(directionalLight, cameraData, shadowDepthRange.x);
     }
 
     void LightSystem::updateSpotLight(SpotLight& spotLight){
@@ -117,9 +123,46 @@ namespace Systems{
         }
     }
 
+    bool LightSystem::readVisibleDepthRange(FrameContext& frameContext, float& visibleNear, float& visibleFar) {
+        if (!Rendering::SDSM_ENABLED || frameContext.depthBoundsBuffer == nullptr) {
+            return false;
+        }
+
+        // Written by RCGIPass the last time this frame context was submitted; its fence has been waited on
+        DepthBoundsBuffer depthBounds{};
+        memcpy(&depthBounds, frameContext.depthBoundsBuffer->getMappedMemory(), sizeof(DepthBoundsBuffer));
+        if (depthBounds.sampleCount == 0) {
+            return false;
+        }
+
+        float minDepth;
+        float maxDepth;
+        memcpy(&minDepth, &depthBounds.minDepthBits, sizeof(float));
+        memcpy(&maxDepth, &depthBounds.maxDepthBits, sizeof(float));
+
+        const CameraData& cameraData = frameContext.cameraData;
+        if (!(minDepth > 0.0f) || !(maxDepth >= minDepth)) {
+            return false;
+        }
+
+        // The readback is a few frames old: quantize outward on a geometric grid so small camera moves
+        // neither clip visible receivers nor make the splits (and shadow texels) shimmer every frame
+        constexpr float quantizationStep = 1.15f;
+        const float logStep = std::log(quantizationStep);
+        const float nearSteps = std::floor(std::log(std::max(minDepth, cameraData.nearPlane)) / logStep);
+        const float farSteps = std::ceil(std::log(std::max(maxDepth, cameraData.nearPlane)) / logStep) + 1.0f;
+
+        // Keep the near bound inside the shadow distance so the split distribution stays valid
+        visibleNear = std::max(cameraData.nearPlane, std::pow(quantizationStep, nearSteps));
+        visibleNear = std::min(visibleNear, Rendering::MAX_SHADOW_DISTANCE * 0.5f);
+        visibleFar = std::min(cameraData.farPlane, std::pow(quantizationStep, farSteps));
+        return visibleFar > visibleNear;
+    }
+
     void LightSystem::calculateCascadeViewProjections(
         DirectionalLight& dirLight,
-        CameraData& cameraData)
+        CameraData& cameraData,
+        float nearClip)
     {
         const glm::vec3 lightDir = glm::normalize(glm::vec3(dirLight.direction));
 
@@ -149,7 +192,7 @@ namespace Systems{
 
         for (uint32_t i = 0; i < MAX_SHADOW_CASCADE_COUNT; ++i)
         {
-            const float cascadeNear = (i == 0) ? cameraData.nearPlane : dirLight.cascadeSplits[i-1];
+            const float cascadeNear = (i == 0) ? nearClip : dirLight.cascadeSplits[i-1];
             const float cascadeFar  = dirLight.cascadeSplits[i];
 
             glm::mat4 proj = glm::perspectiveLH_ZO(cameraData.fov,
@@ -258,57 +301,40 @@ namespace Systems{
         ubo.projectionMatrix = frameContext.cameraData.projectionMatrix;  
         
         // Set Enviroment settings
-        Scene::EnvironmentLighting envLighting = Scene::Scene::getInstance().getEnvironmentLighting();
+        const Scene::EnvironmentLighting& envLighting = Scene::Scene::getInstance().getEnvironmentLighting();
         ubo.cameraPosition = glm::vec4(frameContext.cameraData.position, 1.0f);
         ubo.reflectionIntensity = envLighting.reflectionIntensity;
         ubo.ambientIntensity = envLighting.ambientIntensity;
+        ubo.hasIrradianceSH = envLighting.hasIrradianceSH ? 1u : 0u;
+        for (size_t i = 0; i < envLighting.irradianceSH.size(); i++) {
+            ubo.irradianceSH[i] = envLighting.irradianceSH[i];
+        }
 
         frameContext.sceneLightingBuffer->writeToBuffer(&ubo);
     }
 
-    void LightSystem::updateLightArrayBuffer(FrameContext& frameContext,LightData& lightData){
-        UnifiedLightBuffer unifiedBuffer{};
-        uint32_t lightIndex = 0;
-        uint32_t lightMatrixOffset = 0;
-        
-        // Convert directional lights to unified format
-        uint32_t directionalShadowmapIndex = 0;
-        for (auto* dirLightPtr : lightData.directionalLights) {
-            if (lightIndex >= MAX_LIGHTS) break;
-            
-            DirectionalLight& dirLight = *dirLightPtr;
-            Rendering::Light& light = unifiedBuffer.lights[lightIndex];
-            
-            // Unity approach: For directional lights, position.w = 0.0 
-            // This makes lightVector = direction, distanceSqr = 1.0 (normalized direction)
-            light.positionAndData = glm::vec4(-dirLight.direction.x, -dirLight.direction.y, -dirLight.direction.z, 0.0f);
-            light.colorAndIntensity = glm::vec4(dirLight.color, dirLight.intensity);
-            light.directionAndRange = glm::vec4(dirLight.direction.x, dirLight.direction.y, dirLight.direction.z, 0.0f);
-            
-            // Directional lights: encode data so both attenuations return 1.0
-            // Distance attenuation: set x=0 so UnityDistanceAttenuation returns 1.0
-            // Angle attenuation: set z=0, w=1 so SdotL*0 + 1 = 1, then 1*1 = 1
-            light.attenuationParams = glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
-            
-            light.lightType = 0; // Directional
-            light.isCastingShadow = dirLight.isCastingShadows ? 1 : 0;
-            light.lightMatrixOffset = lightMatrixOffset;
-            light.shadowmapIndex = directionalShadowmapIndex;
-            light.shadowStrength = dirLight.shadowStrength;
-        
-            lightMatrixOffset += MAX_SHADOW_CASCADE_COUNT;
-            directionalShadowmapIndex++; // Each directional light has ONE sampler2DArray (cascades are layers)
-            lightIndex++;
-        }
+    void LightSystem::packDirectionalLight(const DirectionalLight& dirLight, Rendering::Light& light){
+        // Zero padding too, the registry detects changes by comparing bytes
+        std::memset(&light, 0, sizeof(Rendering::Light));
 
-        // Convert spot lights to unified format  
-    uint32_t spotShadowmapIndex = 0;
-    for (auto* spotLightPtr : lightData.spotLights) {
-        if (lightIndex >= MAX_LIGHTS) break;
+        // Unity approach: For directional lights, position.w = 0.0 
+        // This makes lightVector = direction, distanceSqr = 1.0 (normalized direction)
+        light.positionAndData = glm::vec4(-dirLight.direction.x, -dirLight.direction.y, -dirLight.direction.z, 0.0f);
+        light.colorAndIntensity = glm::vec4(dirLight.color, dirLight.intensity);
+        light.directionAndRange = glm::vec4(dirLight.direction.x, dirLight.direction.y, dirLight.direction.z, 0.0f);
         
-        SpotLight& spotLight = *spotLightPtr;
-        Rendering::Light& light = unifiedBuffer.lights[lightIndex];
+        // Directional lights: encode data so both attenuations return 1.0
+        // Distance attenuation: set x=0 so UnityDistanceAttenuation returns 1.0
+        // Angle attenuation: set z=0, w=1 so SdotL*0 + 1 = 1, then 1*1 = 1
+        light.attenuationParams = glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
         
+        light.lightType = 0; // Directional
+        light.shadowStrength = dirLight.shadowStrength;
+    }
+
+    void LightSystem::packSpotLight(const SpotLight& spotLight, Rendering::Light& light){
+        std::memset(&light, 0, sizeof(Rendering::Light));
+
         // Spot lights: position.w = 1.0 for proper distance calculation
         light.positionAndData = glm::vec4(spotLight.transform.position, 1.0f);
         light.colorAndIntensity = glm::vec4(spotLight.color, spotLight.intensity);
@@ -332,22 +358,11 @@ namespace Systems{
         );
         
         light.lightType = 1; // Spot
-        light.isCastingShadow = spotLight.isCastingShadows ? 1 : 0;
-        light.lightMatrixOffset = lightMatrixOffset;
-        light.shadowmapIndex = spotShadowmapIndex;
         light.shadowStrength = spotLight.shadowStrength;
-        lightMatrixOffset++;
-        spotShadowmapIndex++;
-        lightIndex++;
     }
 
-    // Convert point lights to unified format
-    uint32_t pointShadowmapIndex = 0;
-    for (auto* pointLightPtr : lightData.pointLights) {
-        if (lightIndex >= MAX_LIGHTS) break;
-        
-        PointLight& pointLight = *pointLightPtr;
-        Rendering::Light& light = unifiedBuffer.lights[lightIndex];
+    void LightSystem::packPointLight(const PointLight& pointLight, Rendering::Light& light){
+        std::memset(&light, 0, sizeof(Rendering::Light));
 
         // Point lights: position.w = 1.0 for proper distance calculation
         light.positionAndData = glm::vec4(pointLight.transform.position, 1.0f);
@@ -365,46 +380,117 @@ namespace Systems{
         );
         
         light.lightType = 2; // Point
-        light.isCastingShadow = pointLight.isCastingShadows ? 1 : 0;
-        light.lightMatrixOffset = lightMatrixOffset;
-        light.shadowmapIndex = pointShadowmapIndex;
         light.shadowStrength = pointLight.shadowStrength;
-        lightMatrixOffset += 6; // 6 faces for cubemap
-        pointShadowmapIndex++;
-        lightIndex++;
     }
-    
-    unifiedBuffer.lightCount = lightIndex; 
-    frameContext.lightArrayUniformBuffer->writeToBuffer(&unifiedBuffer);
-}
+
+    void LightSystem::updateLightArrayBuffer(FrameContext& frameContext,LightData& lightData,const ShadowcastingData& shadowcastingData){
+        auto& registry = LightRegistry::getInstance();
+        VisibleLightBuffer visibleBuffer{};
+        uint32_t lightIndex = 0;
+
+        // Persistent data only changes when the light does; the per-frame list just references the slot
+        auto addVisibleLight = [&](uint32_t slot, const Rendering::Light& packedLight){
+            registry.updateSlot(slot, packedLight);
+
+            VisibleLight& visibleLight = visibleBuffer.lights[lightIndex];
+            visibleLight.lightSlot = slot;
+            const ShadowcastingLight* shadowcastingLight = shadowcastingData.findLight(slot);
+            if (shadowcastingLight != nullptr) {
+                visibleLight.lightMatrixOffset = shadowcastingLight->lightMatrixBase;
+                visibleLight.shadowmapIndex = shadowcastingLight->shadowmapIndex;
+                visibleLight.isCastingShadow = 1;
+            }
+            lightIndex++;
+        };
+
+        Rendering::Light packedLight;
+        for (auto& [slot, dirLightPtr] : lightData.directionalLights) {
+            if (lightIndex >= MAX_LIGHTS) break;
+            packDirectionalLight(*dirLightPtr, packedLight);
+            addVisibleLight(slot, packedLight);
+        }
+
+        for (auto& [slot, spotLightPtr] : lightData.spotLights) {
+            if (lightIndex >= MAX_LIGHTS) break;
+            packSpotLight(*spotLightPtr, packedLight);
+            addVisibleLight(slot, packedLight);
+        }
+
+        for (auto& [slot, pointLightPtr] : lightData.pointLights) {
+            if (lightIndex >= MAX_LIGHTS) break;
+            packPointLight(*pointLightPtr, packedLight);
+            addVisibleLight(slot, packedLight);
+        }
+
+        // Only the count and the referenced entries are read by the shaders
+        visibleBuffer.lightCount = lightIndex;
+        frameContext.lightArrayUniformBuffer->writeToBuffer(&visibleBuffer, offsetof(VisibleLightBuffer, lightCount) + sizeof(uint32_t));
+
+        uploadDirtyLightSlots(frameContext);
+    }
+
+    void LightSystem::uploadDirtyLightSlots(FrameContext& frameContext){
+        auto& registry = LightRegistry::getInstance();
+        std::vector<uint32_t> dirtySlots;
+        registry.collectDirtySlots(dirtySlots);
+        std::sort(dirtySlots.begin(), dirtySlots.end());
+
+        frameContext.lightSlotCopyRegions.clear();
+        const VkDeviceSize slotSize = sizeof(Rendering::Light);
+        for (uint32_t slot : dirtySlots) {
+            // Staging mirrors the slot layout, so adjacent dirty slots merge into one copy region
+            const VkDeviceSize offset = slot * slotSize;
+            frameContext.lightSlotStagingBuffer->writeToBuffer(&registry.getSlotData(slot), slotSize, offset);
+
+            if (!frameContext.lightSlotCopyRegions.empty()) {
+                VkBufferCopy& last = frameContext.lightSlotCopyRegions.back();
+                if (last.srcOffset + last.size == offset) {
+                    last.size += slotSize;
+                    continue;
+                }
+            }
+            VkBufferCopy region{};
+            region.srcOffset = offset;
+            region.dstOffset = offset;
+            region.size = slotSize;
+            frameContext.lightSlotCopyRegions.push_back(region);
+        }
+    }
           
     void LightSystem::frustumCullLights(
         CameraData& cameraData, 
-        LightData& lightData) {
+        LightData& lightData,
+        const glm::vec2& shadowDepthRange) {
 
         auto& ecsManager = ECSManager::getInstance();
         auto& scene = Scene::Scene::getInstance();
+        auto& registry = LightRegistry::getInstance();
         auto potentialLights = scene.getVisibleLights(cameraData.viewFrustum);
 
 
         ecsManager.forEachComponent<DirectionalLight>([&](DirectionalLight& directionalLight){         
             auto* transform = ecsManager.getComponent<ECS::Transform>(directionalLight.owner);
-            if(transform){
-                updateDirectionalLight(directionalLight,*transform,cameraData);               
-                lightData.directionalLights.push_back(&directionalLight);
+            uint32_t slot = registry.getSlot(directionalLight.owner, directionalLight.type);
+            if(transform && slot != INVALID_LIGHT_SLOT){
+                updateDirectionalLight(directionalLight,*transform,cameraData,shadowDepthRange);               
+                lightData.directionalLights.push_back({slot, &directionalLight});
             }
         });
 
         for(auto lightPtr:potentialLights){
             ECS::Light& light = *lightPtr;
+            uint32_t slot = registry.getSlot(light.owner, light.type);
+            if(slot == INVALID_LIGHT_SLOT){
+                continue;
+            }
             if(light.type == LightType::SPOT_LIGHT){
                 SpotLight& spotLight = static_cast<SpotLight&>(light);
                 updateSpotLight(spotLight);
-                lightData.spotLights.push_back(&spotLight);
+                lightData.spotLights.push_back({slot, &spotLight});
             }else{
                 PointLight& pointLight = static_cast<PointLight&>(light);
                 updatePointLight(pointLight);
-                lightData.pointLights.push_back(&pointLight);
+                lightData.pointLights.push_back({slot, &pointLight});
             }
         }
         
@@ -413,31 +499,129 @@ namespace Systems{
     void LightSystem::lightFrustumCullShadowCasters(
         LightData& lightData,
         ShadowcastingData& shadowcastingData,
-        const CameraData& cameraData){
+        const CameraData& cameraData,
+        bool singlePassPointShadows){
         
         auto& scene = Scene::Scene::getInstance();
         
-        // Directional lights always cast shadows (they affect the entire scene)
-        for(auto lightPtr:lightData.directionalLights){
+        // Shadow maps and light matrices are handed out in visibility order as lights are processed, so the
+        // index the shaders sample matches the map the shadow pass renders into
+        for(auto& [slot, lightPtr]:lightData.directionalLights){
             DirectionalLight& directionalLight = *lightPtr;
-            if(directionalLight.isCastingShadows){
-                processDirectionalLightShadowCasters(directionalLight,shadowcastingData,scene,cameraData);
+            if(!directionalLight.isCastingShadows ||
+               shadowcastingData.directionalShadowCastingCount >= MAX_DIRECTIONAL_LIGHTS ||
+               shadowcastingData.lightMatrixCount + MAX_SHADOW_CASCADE_COUNT > MAX_SHADOWCASTING_LIGHT_MATRICES){
+                continue;
             }
+            size_t firstView = shadowcastingData.views.size();
+            processDirectionalLightShadowCasters(directionalLight,shadowcastingData,scene,cameraData);
+            commitShadowcastingLight(shadowcastingData, firstView, slot,
+                directionalLight.viewProjectionMatrix.data(), MAX_SHADOW_CASCADE_COUNT,
+                glm::vec4(0.0f, 0.0f, 0.0f, -1.0f), shadowcastingData.directionalShadowCastingCount);
         }
 
-        for(auto lightPtr:lightData.spotLights){
+        for(auto& [slot, lightPtr]:lightData.spotLights){
             SpotLight& spotLight = *lightPtr;
-            if(spotLight.isCastingShadows){
-                processSpotLightShadowCasters(spotLight,shadowcastingData,scene,cameraData.position);
+            if(!spotLight.isCastingShadows ||
+               shadowcastingData.spotShadowCastingCount >= MAX_SPOT_LIGHTS ||
+               shadowcastingData.lightMatrixCount + 1 > MAX_SHADOWCASTING_LIGHT_MATRICES){
+                continue;
             }
+            size_t firstView = shadowcastingData.views.size();
+            processSpotLightShadowCasters(spotLight,shadowcastingData,scene,cameraData.position);
+            commitShadowcastingLight(shadowcastingData, firstView, slot,
+                &spotLight.viewProjectionMatrix, 1,
+                glm::vec4(spotLight.transform.position, spotLight.range), shadowcastingData.spotShadowCastingCount);
         }
 
-        for(auto lightPtr:lightData.pointLights){
+        for(auto& [slot, lightPtr]:lightData.pointLights){
             PointLight& pointLight = *lightPtr;
-            if(pointLight.isCastingShadows){
+            if(!pointLight.isCastingShadows ||
+               shadowcastingData.pointShadowCastingCount >= MAX_POINT_LIGHTS ||
+               shadowcastingData.lightMatrixCount + 6 > MAX_SHADOWCASTING_LIGHT_MATRICES){
+                continue;
+            }
+            size_t firstView = shadowcastingData.views.size();
+            if(singlePassPointShadows){
+                processPointLightShadowCastersSinglePass(pointLight,shadowcastingData,scene,cameraData.position);
+            }else{
                 processPointLightShadowCasters(pointLight,shadowcastingData,scene,cameraData.position);
             }
+            commitShadowcastingLight(shadowcastingData, firstView, slot,
+                pointLight.viewProjectionMatrix.data(), 6,
+                glm::vec4(pointLight.transform.position, pointLight.range), shadowcastingData.pointShadowCastingCount);
+        }
+    }
+
+    ShadowView LightSystem::beginShadowView(
+        const ShadowcastingData& shadowcastingData,
+        LightType lightType,
+        uint32_t shadowmapIndex,
+        uint32_t layer,
+        const glm::vec4& lightPosRange,
+        bool multiview) {
+
+        ShadowView view{};
+        view.lightType = lightType;
+        view.shadowmapIndex = shadowmapIndex;
+        view.layer = layer;
+        // Matrices of the light being processed start where the previous committed light's ended
+        view.lightMatrixIndex = shadowcastingData.lightMatrixCount + layer;
+        view.lightPosRange = lightPosRange;
+        view.multiview = multiview;
+        view.instanceOffset = static_cast<uint32_t>(shadowcastingData.instances.size());
+        return view;
+    }
+
+    void LightSystem::appendShadowCaster(ShadowcastingData& shadowcastingData, const Renderable& renderable, uint32_t faceMask) {
+        uint32_t submeshCount = renderable.meshRenderer.materials.size();
+        Mesh* mesh = renderable.meshRenderer.mesh;
+        for (uint32_t submeshIndex = 0; submeshIndex < submeshCount; submeshIndex++) {
+            Material* material = renderable.meshRenderer.materials[submeshIndex];
+            TransparencyType transparencyType = material->getTransparencyType();
+            // Skip transparent materials - only opaque objects should cast shadows
+            if (transparencyType != Rendering::TransparencyType::TYPE_OPAQUE &&
+                transparencyType != Rendering::TransparencyType::TYPE_MASK) {
+                continue;
+            }
+            shadowcastingData.instances.push_back({{mesh, material, submeshIndex}, &renderable.transform.modelMatrix, faceMask});
+        }
+    }
+
+    void LightSystem::endShadowView(ShadowcastingData& shadowcastingData, ShadowView& view) {
+        view.instanceCount = static_cast<uint32_t>(shadowcastingData.instances.size()) - view.instanceOffset;
+        if (view.instanceCount > 0) {
+            shadowcastingData.views.push_back(view);
+        }
+    }
+
+    bool LightSystem::commitShadowcastingLight(
+        ShadowcastingData& shadowcastingData,
+        size_t firstView,
+        uint32_t lightSlot,
+        const glm::mat4* matrices,
+        uint32_t matrixCount,
+        const glm::vec4& lightPosRange,
+        uint32_t& shadowmapCounter) {
+
+        // Lights whose views all came out empty keep neither a shadow map nor matrices
+        if (shadowcastingData.views.size() == firstView) {
+            return false;
         }
+
+        ShadowcastingLight light{};
+        light.lightSlot = lightSlot;
+        light.shadowmapIndex = shadowmapCounter;
+        light.lightMatrixBase = shadowcastingData.lightMatrixCount;
+        light.matrixCount = matrixCount;
+        light.matrices = matrices;
+        light.lightPosRange = lightPosRange;
+
+        shadowcastingData.lightIndexBySlot[lightSlot] = static_cast<int32_t>(shadowcastingData.lights.size());
+        shadowcastingData.lights.push_back(light);
+        shadowcastingData.lightMatrixCount += matrixCount;
+        shadowmapCounter++;
+        return true;
     }
     
     void LightSystem::processDirectionalLightShadowCasters(
@@ -449,9 +633,8 @@ namespace Systems{
         
         // Maximum distance from camera for shadow casters (precomputed constant)
         const float maxShadowCasterDistanceSqr = Rendering::MAX_SHADOW_CASTER_DISTANCE_SQR;
+        const glm::vec4 lightPosRange(0.0f, 0.0f, 0.0f, -1.0f);
         for(uint32_t cascadeIndex = 0; cascadeIndex < MAX_SHADOW_CASCADE_COUNT; cascadeIndex++) {
-            std::unordered_set<MeshMaterialSubmeshKey> uniqueKeys;
-
        
             float paddedCascadeFar  = 0;
             if(cascadeIndex != 0){
@@ -466,6 +649,9 @@ namespace Systems{
             ViewFrustum lightFrustum = ViewFrustum::createFromViewProjection(directionalLight.viewProjectionMatrix[cascadeIndex]);
             std::vector<Renderable*> visibleObjects = scene.getVisibleRenderers(lightFrustum);
 
+            ShadowView view = beginShadowView(shadowcastingData, LightType::DIRECTIONAL_LIGHT,
+                shadowcastingData.directionalShadowCastingCount, cascadeIndex, lightPosRange, false);
+
             for(const auto& renderable : visibleObjects) {
 
                 if(cascadeIndex!=0){
@@ -489,30 +675,12 @@ namespace Systems{
                     }
                 }
 
-                uint32_t submeshCount = renderable->meshRenderer.materials.size();
-                Mesh* mesh = renderable->meshRenderer.mesh;
-                for (uint32_t submeshIndex = 0; submeshIndex < submeshCount; submeshIndex++) {
-                    Material* material = renderable->meshRenderer.materials[submeshIndex];
-                    TransparencyType transparencyType = material->getTransparencyType();
-                    // Skip transparent materials - only opaque objects should cast shadows
-                    if (transparencyType != Rendering::TransparencyType::TYPE_OPAQUE&&
-                        transparencyType != Rendering::TransparencyType::TYPE_MASK) {
-                        continue;
-                    }
-                    
-                    MeshMaterialSubmeshKey key{mesh, material, submeshIndex};
-                    shadowcastingData.directionalShadowModelsByCascade[&directionalLight][cascadeIndex][key].push_back(renderable->transform.modelMatrix);
-    
-                    if (uniqueKeys.find(key) == uniqueKeys.end()) {
-                        shadowcastingData.directionalShadowcastingKeyMapByCascade[&directionalLight][cascadeIndex].push_back(key);
-                        uniqueKeys.insert(key);
-                    }
-                }
+                appendShadowCaster(shadowcastingData, *renderable, 0u);
             }
+
+            endShadowView(shadowcastingData, view);
         }
-    
-        shadowcastingData.directionalShadowCastingCount++;
-}
+    }
 
     void LightSystem::processSpotLightShadowCasters(
         SpotLight& spotLight,
@@ -533,12 +701,13 @@ namespace Systems{
         if (closestInfluenceDistance > Rendering::MAX_SHADOW_DISTANCE) {
             return; // Light too far - skip shadow generation entirely
         }
-        
-        std::unordered_set<MeshMaterialSubmeshKey> uniqueKeys;
 
         // Use AABB intersection instead of ViewFrustum for consistency and to avoid frustum extraction issues
         ViewFrustum lightFrustum = ViewFrustum::createFromViewProjection(spotLight.viewProjectionMatrix);
         std::vector<Renderable*> visibleObjects = scene.getVisibleRenderers(lightFrustum);
+
+        ShadowView view = beginShadowView(shadowcastingData, LightType::SPOT_LIGHT,
+            shadowcastingData.spotShadowCastingCount, 0, glm::vec4(lightPosition, lightRange), false);
         
         for (const auto& renderable : visibleObjects) {
             // Skip objects too far from camera to cast relevant shadows
@@ -547,28 +716,10 @@ namespace Systems{
             if (distanceToCameraSqr > Rendering::MAX_SHADOW_CASTER_DISTANCE_SQR) {
                 continue;
             }
-            
-            uint32_t submeshCount = renderable->meshRenderer.materials.size();
-            Mesh* mesh = renderable->meshRenderer.mesh;
-            for (uint32_t i = 0; i < submeshCount; i++) {
-                Material* material = renderable->meshRenderer.materials[i];
-                TransparencyType transparencyType = material->getTransparencyType();
-                // Skip transparent materials - only opaque objects should cast shadows
-                if (transparencyType != Rendering::TransparencyType::TYPE_OPAQUE &&
-                    transparencyType != Rendering::TransparencyType::TYPE_MASK) {
-                    continue;
-                }
-                
-                MeshMaterialSubmeshKey key{mesh, material, i};
-                shadowcastingData.spotShadowModels[&spotLight][key].push_back(renderable->transform.modelMatrix);
+            appendShadowCaster(shadowcastingData, *renderable, 0u);
+        }
 
-                if (uniqueKeys.find(key) == uniqueKeys.end()) {
-                    shadowcastingData.spotShadowcastingKeyMap[&spotLight].push_back(key);
-                    uniqueKeys.insert(key);
-                }
-            }
-        }     
-        shadowcastingData.spotShadowCastingCount++;
+        endShadowView(shadowcastingData, view);
     }
 
     void LightSystem::processPointLightShadowCasters(
@@ -588,13 +739,14 @@ namespace Systems{
         if (closestInfluenceDistance > Rendering::MAX_SHADOW_DISTANCE) {
             return; // Light too far - skip shadow generation entirely
         }
-        
-       
 
-        for(int face = 0; face < 6; face++){
+        for(uint32_t face = 0; face < 6; face++){
             ViewFrustum faceFrustum = ViewFrustum::createFromViewProjection(pointLight.viewProjectionMatrix[face]);
-            std::unordered_set<MeshMaterialSubmeshKey> uniqueKeys;
             std::vector<Renderable*> faceVisibleObjects = scene.getVisibleRenderers(faceFrustum);
+
+            ShadowView view = beginShadowView(shadowcastingData, LightType::POINT_LIGHT,
+                shadowcastingData.pointShadowCastingCount, face, glm::vec4(lightPosition, lightRange), false);
+
             for (const auto& renderable : faceVisibleObjects) {
                 // Skip objects too far from camera to cast relevant shadows
                 glm::vec3 objectPos = glm::vec3(renderable->transform.modelMatrix[3]);
@@ -602,39 +754,83 @@ namespace Systems{
                 if (distanceToCameraSqr > Rendering::MAX_SHADOW_CASTER_DISTANCE_SQR) {
                     continue;
                 }
+                appendShadowCaster(shadowcastingData, *renderable, 0u);
+            }
 
-                uint32_t submeshCount = renderable->meshRenderer.materials.size();
-                Mesh* mesh = renderable->meshRenderer.mesh;
-                for (uint32_t submeshIndex = 0; submeshIndex < submeshCount; submeshIndex++) {
-                    Material* material = renderable->meshRenderer.materials[submeshIndex];
-                    TransparencyType transparencyType = material->getTransparencyType();
-                    // Skip transparent materials - only opaque objects should cast shadows
-                    if (transparencyType != Rendering::TransparencyType::TYPE_OPAQUE &&
-                        transparencyType != Rendering::TransparencyType::TYPE_MASK) {
-                        continue;
-                    }
+            endShadowView(shadowcastingData, view);
+        }
+    }
 
-                    MeshMaterialSubmeshKey key{mesh, material, submeshIndex};
-                    shadowcastingData.pointShadowModelsByFace[&pointLight][face][key].push_back(renderable->transform.modelMatrix);
+    void LightSystem::processPointLightShadowCastersSinglePass(
+        PointLight& pointLight,
+        ShadowcastingData& shadowcastingData,
+        Scene::Scene& scene,
+        const glm::vec3& cameraPosition) {
 
-                    if (uniqueKeys.find(key) == uniqueKeys.end()) {
-                        shadowcastingData.pointShadowcastingKeyMapByFace[&pointLight][face].push_back(key);
-                        uniqueKeys.insert(key);
-                    }
+        const glm::vec3 lightPosition = pointLight.transform.position;
+        const float lightRange = pointLight.range;
+
+        float distanceToLight = glm::length(lightPosition - cameraPosition);
+        float closestInfluenceDistance = distanceToLight - lightRange;
+
+        if (closestInfluenceDistance > Rendering::MAX_SHADOW_DISTANCE) {
+            return; // Light too far - skip shadow generation entirely
+        }
+
+        std::array<ViewFrustum, 6> faceFrustums;
+        for(int face = 0; face < 6; face++){
+            faceFrustums[face] = ViewFrustum::createFromViewProjection(pointLight.viewProjectionMatrix[face]);
+        }
+
+        // The six faces together cover the light's range cube, so one query replaces six frustum traversals
+        AABB lightBounds{};
+        BoundingBoxSystem::calculatePointLightBounds(lightBounds, lightPosition, lightRange);
+        std::vector<Renderable*> candidates = scene.getIntersectingRenderers(lightBounds);
+
+        // One view for the whole cube; the vertex shader offsets the matrix by gl_ViewIndex
+        ShadowView view = beginShadowView(shadowcastingData, LightType::POINT_LIGHT,
+            shadowcastingData.pointShadowCastingCount, 0, glm::vec4(lightPosition, lightRange), true);
+
+        for (const auto& renderable : candidates) {
+            glm::vec3 objectPos = glm::vec3(renderable->transform.modelMatrix[3]);
+            float distanceToCameraSqr = glm::dot(objectPos - cameraPosition, objectPos - cameraPosition);
+            if (distanceToCameraSqr > Rendering::MAX_SHADOW_CASTER_DISTANCE_SQR) {
+                continue;
+            }
+
+            AABB worldBounds{};
+            BoundingBoxSystem::getWorldBounds(
+                worldBounds,
+                renderable->meshRenderer.mesh->getLocalBounds(),
+                renderable->transform.modelMatrix);
+
+            uint32_t faceMask = 0;
+            for(uint32_t face = 0; face < 6; face++){
+                if(faceFrustums[face].testAABB(worldBounds) != ViewFrustum::Intersection::OUTSIDE){
+                    faceMask |= 1u << face;
                 }
             }
+            if(faceMask == 0){
+                continue;
+            }
+
+            appendShadowCaster(shadowcastingData, *renderable, faceMask);
         }
-               
-        shadowcastingData.pointShadowCastingCount++;
+
+        endShadowView(shadowcastingData, view);
     }
     
-    void LightSystem::updateCascadeSplitsBuffer(FrameContext& frameContext,LightData& lightData){
+    void LightSystem::updateCascadeSplitsBuffer(FrameContext& frameContext,LightData& lightData,const ShadowcastingData& shadowcastingData){
         DirectionalLightCascadesBuffer cascadeBuffer{};   
-        uint32_t cascadeIndex = 0;
     
-        // Fill cascade splits for each directional light
-        for (auto* dirLightPtr : lightData.directionalLights) {
-            if (cascadeIndex >= MAX_SHADOWCASTING_LIGHT_MATRICES) break;
+        // Fill cascade splits for each shadowcasting directional light; the shader finds them at lightMatrixOffset / cascade count
+        for (auto& [slot, dirLightPtr] : lightData.directionalLights) {
+            const ShadowcastingLight* shadowcastingLight = shadowcastingData.findLight(slot);
+            if (shadowcastingLight == nullptr) {
+                continue;
+            }
+            uint32_t cascadeIndex = shadowcastingLight->lightMatrixBase / MAX_SHADOW_CASCADE_COUNT;
+            if (cascadeIndex >= MAX_SHADOWCASTING_DIRECTIONAL) continue;
             
             DirectionalLight& dirLight = *dirLightPtr;
             
@@ -645,179 +841,112 @@ namespace Systems{
                 dirLight.cascadeSplits[2],
                 dirLight.cascadeSplits[3]
             );
-            
-            cascadeIndex++;
         }
         
         frameContext.cascadeSplitsBuffer->writeToBuffer(&cascadeBuffer);
     }
     
-    void LightSystem::updateShadowLightMatrixBuffer(FrameContext& frameContext,ShadowcastingData& shadowcastingData){
-        size_t currentOffset = 0;
-    void* data = frameContext.lightMatrixBuffer->getMappedMemory();  
-    size_t mat4Size = sizeof(glm::mat4);
-
-    // Update directional light shadow matrices
-    for (const auto& [lightPtr, cascadeKeys] : shadowcastingData.directionalShadowcastingKeyMapByCascade) {
-        frameContext.directionalLightMatrixBase[lightPtr] = static_cast<uint32_t>(currentOffset / mat4Size);
-        memcpy(static_cast<char*>(data) + currentOffset, lightPtr->viewProjectionMatrix.data(), sizeof(glm::mat4) * MAX_SHADOW_CASCADE_COUNT);
-        currentOffset += mat4Size * MAX_SHADOW_CASCADE_COUNT;
-    }
-    
-    
-    // Update spot light shadow matrices
-    for(auto& [lightPtr,meshKeys]:shadowcastingData.spotShadowcastingKeyMap){
-        frameContext.spotLightMatrixBase[lightPtr] = static_cast<uint32_t>(currentOffset / mat4Size);
-        memcpy(static_cast<char*>(data) + currentOffset, &lightPtr->viewProjectionMatrix, sizeof(glm::mat4));
-        currentOffset += mat4Size;
-    }
-    
-    // Update point light shadow matrices
-    for(auto& [lightPtr,meshKeys]:shadowcastingData.pointShadowcastingKeyMapByFace){
-        frameContext.pointLightMatrixBase[lightPtr] = static_cast<uint32_t>(currentOffset / mat4Size);
-        memcpy(static_cast<char*>(data) + currentOffset, lightPtr->viewProjectionMatrix.data(), sizeof(glm::mat4)*6);
-        currentOffset += mat4Size*6;
-    }
+    void LightSystem::updateShadowLightMatrixBuffer(FrameContext& frameContext,const ShadowcastingData& shadowcastingData){
+        char* data = static_cast<char*>(frameContext.lightMatrixBuffer->getMappedMemory());
+        for (const ShadowcastingLight& light : shadowcastingData.lights) {
+            memcpy(data + light.lightMatrixBase * sizeof(glm::mat4), light.matrices, sizeof(glm::mat4) * light.matrixCount);
+        }
     }
 
     void LightSystem::updateShadowModelMatrixBuffer(FrameContext& frameContext,ShadowcastingData& shadowcastingData){     
-        VkDeviceSize modelBufferOffset = 0;
-        uint32_t matrixOffset = 0;
-        uint32_t mat4size = sizeof(glm::mat4);
-        frameContext.directionalShadowcastingMaterialMap.clear();
-        frameContext.spotShadowcastingMaterialMap.clear();
-        frameContext.pointShadowcastingMaterialMapByFace.clear();
-
-        for(auto& [lightPtr,cascadeKeys]:shadowcastingData.directionalShadowcastingKeyMapByCascade){
-            auto modelsByCascadeIt = shadowcastingData.directionalShadowModelsByCascade.find(lightPtr);
-            if(modelsByCascadeIt == shadowcastingData.directionalShadowModelsByCascade.end()){
-                continue;
-            }
-            auto& cascadeModelMaps = modelsByCascadeIt->second;
-            for(uint32_t cascadeIndex = 0; cascadeIndex < MAX_SHADOW_CASCADE_COUNT; ++cascadeIndex){
-                for(auto& key:cascadeKeys[cascadeIndex]){
-                    auto& cascadeModelMap = cascadeModelMaps[cascadeIndex];
-                    auto instancesIt = cascadeModelMap.find(key);
-                    if(instancesIt == cascadeModelMap.end()){
-                        continue;
-                    }
-                    auto& instances = instancesIt->second;
-                    uint32_t instancesSize = instances.size();
-
-                    // Prevent buffer overflow when many instances are duplicated across cascades.
-                    VkDeviceSize bytesNeeded = instancesSize * mat4size;
-                    VkDeviceSize bufferSize = frameContext.shadowModelMatrixBuffer->getBufferSize();
-                    if(modelBufferOffset + bytesNeeded > bufferSize){
-                        std::cerr << "Shadow model matrix buffer overflow for directional light cascade "
-                                  << cascadeIndex << " (needed " << (modelBufferOffset + bytesNeeded)
-                                  << " bytes, have " << bufferSize << ")\n";
-                        continue;
-                    }
-    
-                    frameContext.shadowModelMatrixBuffer->writeToBuffer(instances.data(), instancesSize*mat4size, modelBufferOffset);
-            
-                    MaterialBatch materialBatch{};
-                    materialBatch.mesh = key.mesh;
-                    materialBatch.material = key.material;
-                    materialBatch.submeshIndex = key.submeshIndex;
-                    materialBatch.instanceCount = instancesSize;
-                    materialBatch.matrixOffset = matrixOffset;
-        
-                    modelBufferOffset += instancesSize*mat4size;
-                    matrixOffset += instancesSize;
-
-                    frameContext.directionalShadowcastingMaterialMap[lightPtr][cascadeIndex].push_back(materialBatch);
-                }
-            }
+        frameContext.shadowViews.clear();
+        frameContext.shadowBatches.clear();
+        if (frameContext.renderingResources) {
+            frameContext.renderingResources->reserveShadowInstances(
+                frameContext.frameIndex, static_cast<uint32_t>(shadowcastingData.instances.size()));
         }
 
-        for(auto& [lightPtr,meshKeys]:shadowcastingData.spotShadowcastingKeyMap){
-            auto modelsIt = shadowcastingData.spotShadowModels.find(lightPtr);
-            if(modelsIt == shadowcastingData.spotShadowModels.end()){
-                continue;
-            }
-            auto& modelMap = modelsIt->second;
-            for(auto& key:meshKeys){
-                auto instancesIt = modelMap.find(key);
-                if(instancesIt == modelMap.end()){
-                    continue;
+        char* modelData = static_cast<char*>(frameContext.shadowModelMatrixBuffer->getMappedMemory());
+        uint32_t* faceMaskData = static_cast<uint32_t*>(frameContext.shadowFaceMaskBuffer->getMappedMemory());
+        const uint32_t capacity = static_cast<uint32_t>(std::min(
+            frameContext.shadowModelMatrixBuffer->getBufferSize() / sizeof(glm::mat4),
+            frameContext.shadowFaceMaskBuffer->getBufferSize() / sizeof(uint32_t)));
+
+        auto keyLess = [](const ShadowCasterInstance& a, const ShadowCasterInstance& b) {
+            if (a.key.mesh != b.key.mesh) return std::less<Mesh*>{}(a.key.mesh, b.key.mesh);
+            if (a.key.material != b.key.material) return std::less<Material*>{}(a.key.material, b.key.material);
+            return a.key.submeshIndex < b.key.submeshIndex;
+        };
+
+        uint32_t matrixOffset = 0;
+        bool overflowed = false;
+        for (ShadowView view : shadowcastingData.views) {
+            auto begin = shadowcastingData.instances.begin() + view.instanceOffset;
+            auto end = begin + view.instanceCount;
+            std::sort(begin, end, keyLess);
+
+            view.batchOffset = static_cast<uint32_t>(frameContext.shadowBatches.size());
+            for (auto runBegin = begin; runBegin != end && !overflowed; ) {
+                auto runEnd = runBegin;
+                while (runEnd != end && runEnd->key == runBegin->key) {
+                    ++runEnd;
                 }
-                auto& instances = instancesIt->second;
-                uint32_t instancesSize = instances.size();
-
-                VkDeviceSize bytesNeeded = instancesSize * mat4size;
-                VkDeviceSize bufferSize = frameContext.shadowModelMatrixBuffer->getBufferSize();
-                if(modelBufferOffset + bytesNeeded > bufferSize){
-                    std::cerr << "Shadow model matrix buffer overflow for spot light (matrixOffset "
-                              << matrixOffset << ")\n";
-                    continue;
+                uint32_t runCount = static_cast<uint32_t>(runEnd - runBegin);
+
+                // Only reachable when the frame context cannot grow the buffers (no renderingResources)
+                if (matrixOffset + runCount > capacity) {
+                    std::cerr << "Shadow model matrix buffer overflow (needed " << (matrixOffset + runCount)
+                              << " instances, have " << capacity << ")\n";
+                    overflowed = true;
+                    break;
                 }
-                frameContext.shadowModelMatrixBuffer->writeToBuffer(instances.data(), instancesSize*mat4size, modelBufferOffset);
-            
+
+                // Face masks share the model matrix indexing, so they land at the same instance offset
+                uint32_t instanceIndex = matrixOffset;
+                for (auto it = runBegin; it != runEnd; ++it, ++instanceIndex) {
+                    memcpy(modelData + instanceIndex * sizeof(glm::mat4), it->modelMatrix, sizeof(glm::mat4));
+                    if (view.multiview) {
+                        faceMaskData[instanceIndex] = it->faceMask;
+                    }
+                }
+
                 MaterialBatch materialBatch{};
-                materialBatch.mesh = key.mesh;
-                materialBatch.material = key.material;
-                materialBatch.submeshIndex = key.submeshIndex;
-                materialBatch.instanceCount = instancesSize;
+                materialBatch.mesh = runBegin->key.mesh;
+                materialBatch.material = runBegin->key.material;
+                materialBatch.submeshIndex = runBegin->key.submeshIndex;
+                materialBatch.instanceCount = runCount;
                 materialBatch.matrixOffset = matrixOffset;
+                frameContext.shadowBatches.push_back(materialBatch);
 
-                modelBufferOffset += instancesSize*mat4size;
-                matrixOffset += instancesSize;
-
-                frameContext.spotShadowcastingMaterialMap[lightPtr].push_back(materialBatch);
+                matrixOffset += runCount;
+                runBegin = runEnd;
             }
-        }
 
-        for(auto& [lightPtr,meshKeys]:shadowcastingData.pointShadowcastingKeyMapByFace){
-            auto modelsByFaceIt = shadowcastingData.pointShadowModelsByFace.find(lightPtr);
-            if(modelsByFaceIt == shadowcastingData.pointShadowModelsByFace.end()){
-                continue;
-            }
-            auto& faceModelMaps = modelsByFaceIt->second;
-            for(uint32_t faceIndex = 0; faceIndex < 6; ++faceIndex){
-                for(auto& key:meshKeys[faceIndex]){
-                    auto& faceModelMap = faceModelMaps[faceIndex];
-                    auto instancesIt = faceModelMap.find(key);
-                    if(instancesIt == faceModelMap.end()){
-                        continue;
-                    }
-                    auto& instances = instancesIt->second;
-                    uint32_t instancesSize = instances.size();
-
-                    VkDeviceSize bytesNeeded = instancesSize * mat4size;
-                    VkDeviceSize bufferSize = frameContext.shadowModelMatrixBuffer->getBufferSize();
-                    if(modelBufferOffset + bytesNeeded > bufferSize){
-                        std::cerr << "Shadow model matrix buffer overflow for point light face "
-                                  << faceIndex << " (matrixOffset " << matrixOffset << ")\n";
-                        continue;
-                    }
-                    frameContext.shadowModelMatrixBuffer->writeToBuffer(instances.data(), instancesSize*mat4size, modelBufferOffset);
-                
-                    MaterialBatch materialBatch{};
-                    materialBatch.mesh = key.mesh;
-                    materialBatch.material = key.material;
-                    materialBatch.submeshIndex = key.submeshIndex;
-                    materialBatch.instanceCount = instancesSize;
-                    materialBatch.matrixOffset = matrixOffset;
-
-                    modelBufferOffset += instancesSize*mat4size;
-                    matrixOffset += instancesSize;
-
-                    frameContext.pointShadowcastingMaterialMapByFace[lightPtr][faceIndex].push_back(materialBatch);
-                }
+            view.batchCount = static_cast<uint32_t>(frameContext.shadowBatches.size()) - view.batchOffset;
+            if (view.batchCount > 0) {
+                frameContext.shadowViews.push_back(view);
             }
         }
     }
+
     void LightSystem::updateFrameContext(FrameContext& frameContext){
         LightData lightData{};
-        ShadowcastingData shadowcastingData{};
+        // Reused across frames so the flat arrays keep their capacity
+        static ShadowcastingData shadowcastingData{};
+        shadowcastingData.reset();
         CameraData& cameraData = frameContext.cameraData;
-        frustumCullLights(cameraData, lightData);
-        lightFrustumCullShadowCasters(lightData, shadowcastingData, cameraData);
-        updateLightArrayBuffer(frameContext,lightData);
-        updateSceneLightBuffer(frameContext);
-        updateCascadeSplitsBuffer(frameContext,lightData);
+
+        // Fixed log/uniform splits over the camera range unless SDSM reports what is actually on screen
+        glm::vec2 shadowDepthRange(cameraData.nearPlane, cameraData.farPlane);
+        float visibleNear = 0.0f;
+        float visibleFar = 0.0f;
+        if (readVisibleDepthRange(frameContext, visibleNear, visibleFar)) {
+            shadowDepthRange = glm::vec2(visibleNear, visibleFar);
+        }
+
+        LightRegistry::getInstance().synchronize();
+        frustumCullLights(cameraData, lightData, shadowDepthRange);
+        // Also assigns shadow maps so the visible light list can reference them
+        lightFrustumCullShadowCasters(lightData, shadowcastingData, cameraData, frameContext.singlePassPointShadows);
         updateShadowLightMatrixBuffer(frameContext,shadowcastingData);
+        updateLightArrayBuffer(frameContext,lightData,shadowcastingData);
+        updateSceneLightBuffer(frameContext);
+        updateCascadeSplitsBuffer(frameContext,lightData,shadowcastingData);
         updateShadowModelMatrixBuffer(frameContext,shadowcastingData);
     }
 
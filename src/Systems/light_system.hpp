@@ -9,6 +9,7 @@
 #include "Math/view_frustum.hpp"
 #include "Rendering/Core/frame_context.hpp"
 #include "Scene/scene.hpp"
+#include "Systems/light_registry.hpp"
 using namespace ECS;
 using namespace Rendering;
 
@@ -20,18 +21,24 @@ namespace Systems{
             static void updateFrameContext(FrameContext& frameContext);
         private:
             static void calculateCascadeSplits(DirectionalLight& directionalLight,float nearClip,float farClip);
+            // SDSM: visible depth range from the GPU reduction, widened and quantized to keep splits stable
+            static bool readVisibleDepthRange(FrameContext& frameContext,float& visibleNear,float& visibleFar);
+            // Cascade 0 spans nearClip to the first split: the SDSM visible near when there is one, else the camera near
             static void calculateCascadeViewProjections(
                 DirectionalLight& directionalLight,
-                CameraData& cameraData);
+                CameraData& cameraData,
+                float nearClip);
                 
             static void frustumCullLights(
                     CameraData& cameraData, 
-                    LightData& lightData);
+                    LightData& lightData,
+                    const glm::vec2& shadowDepthRange);
 
             static void lightFrustumCullShadowCasters(
                 LightData& lightData,
                 ShadowcastingData& shadowcastingData,
-                const CameraData& cameraData);        
+                const CameraData& cameraData,
+                bool singlePassPointShadows);        
             static void processDirectionalLightShadowCasters(
                     DirectionalLight& directionalLight,
                     ShadowcastingData& shadowcastingData,
@@ -49,19 +56,46 @@ namespace Systems{
                     ShadowcastingData& shadowcastingData,
                     Scene::Scene& scene,
                     const glm::vec3& cameraPosition);
+
+            // Single octree query per light; each instance carries a bitmask of the cube faces it touches
+            static void processPointLightShadowCastersSinglePass(
+                    PointLight& pointLight,
+                    ShadowcastingData& shadowcastingData,
+                    Scene::Scene& scene,
+                    const glm::vec3& cameraPosition);
+
+            // Views are only kept when they received casters; a light is only kept when one of its views was
+            static ShadowView beginShadowView(const ShadowcastingData& shadowcastingData,LightType lightType,uint32_t shadowmapIndex,uint32_t layer,const glm::vec4& lightPosRange,bool multiview);
+            static void appendShadowCaster(ShadowcastingData& shadowcastingData,const Renderable& renderable,uint32_t faceMask);
+            static void endShadowView(ShadowcastingData& shadowcastingData,ShadowView& view);
+            static bool commitShadowcastingLight(
+                    ShadowcastingData& shadowcastingData,
+                    size_t firstView,
+                    uint32_t lightSlot,
+                    const glm::mat4* matrices,
+                    uint32_t matrixCount,
+                    const glm::vec4& lightPosRange,
+                    uint32_t& shadowmapCounter);
             
             static void updateDirectionalLight(
                 DirectionalLight& directionalLight,
                 const Transform& transform,
-                CameraData& cameraData);
+                CameraData& cameraData,
+                const glm::vec2& shadowDepthRange);
                         
             static void updatePointLight(PointLight& pointLight);
             static void updateSpotLight(SpotLight& spotLight);
+            // Persistent slot contents; per-frame shadow fields are left zero and supplied by the visible list
+            static void packDirectionalLight(const DirectionalLight& directionalLight,Rendering::Light& light);
+            static void packSpotLight(const SpotLight& spotLight,Rendering::Light& light);
+            static void packPointLight(const PointLight& pointLight,Rendering::Light& light);
+
             static void updateSceneLightBuffer(FrameContext& frameContext);    
-            static void updateLightArrayBuffer(FrameContext& frameContext,LightData& lightData);
-            static void updateCascadeSplitsBuffer(FrameContext& frameContext,LightData& lightData);
-            static void updateShadowLightMatrixBuffer(FrameContext& frameContext,ShadowcastingData& shadowcastingData);
+            static void updateLightArrayBuffer(FrameContext& frameContext,LightData& lightData,const ShadowcastingData& shadowcastingData);
+            static void uploadDirtyLightSlots(FrameContext& frameContext);
+            static void updateCascadeSplitsBuffer(FrameContext& frameContext,LightData& lightData,const ShadowcastingData& shadowcastingData);
+            static void updateShadowLightMatrixBuffer(FrameContext& frameContext,const ShadowcastingData& shadowcastingData);
+            // Sorts each view's casters by mesh/material/submesh and emits one batch per run
             static void updateShadowModelMatrixBuffer(FrameContext& frameContext,ShadowcastingData& shadowcastingData);
-            static void updateShadowcastingData(FrameContext& frameContext,LightData& lightData);
     };
 }
\ No newline at end of file
@@ -4,10 +4,12 @@
 #include <iostream>
 #include <stdexcept>
 
-int main() {
+int main(int argc, char** argv) {
      std::cout << "Starting program..." << std::endl;
-     AlphaEngine engine{};
+     Engine::BenchmarkSettings settings;
     try {
+        settings = Engine::BenchmarkSettings::parse(argc, argv);
+        AlphaEngine engine{settings};
         engine.run();
         std::cout << "Engine run completed normally" << std::endl;
     }
@@ -19,7 +21,10 @@ int main() {
         std::cerr << "Unknown exception in main" << '\n';
         return EXIT_FAILURE;
     }
-    std::cout << "Program ending... Press Enter to exit." << std::endl;
-    std::cin.get();
+    // Headless runs are unattended
+    if (!settings.headless) {
+        std::cout << "Program ending... Press Enter to exit." << std::endl;
+        std::cin.get();
+    }
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
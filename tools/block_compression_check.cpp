@@ -0,0 +1,89 @@
+// Round-trips synthetic images through the CPU block compressors and checks the result.
+// Usage: block_compression_check
+// Each image is encoded into a buffer of exactly getEncodedSize bytes on the heap, as SceneLoader does, and decoded
+// back; the check fails when a format's PSNR drops below its floor. Built with AddressSanitizer where the toolchain
+// has it (ALPHA_TOOLS_ASAN), so a write past the last block aborts the run.
+#include "Resources/block_compression.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace Resources;
+
+namespace {
+    constexpr double BC7_MIN_PSNR = 30.0;
+    constexpr double BC5_MIN_PSNR = 30.0;
+
+    struct ImageSize {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Partial edge blocks in both directions, single texels and power-of-two mips
+    constexpr ImageSize IMAGE_SIZES[] = {{1, 1}, {2, 3}, {4, 4}, {13, 7}, {64, 64}, {257, 129}};
+
+    // Smooth gradients with a little deterministic noise. Color images ramp all channels along one diagonal, as a
+    // mode 6 block fits one line per block; normal maps vary red and green independently, one BC4 half each
+    std::vector<unsigned char> makeImage(uint32_t width, uint32_t height, bool normalMap) {
+        std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+        uint32_t state = 12345u;
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                state = state * 1664525u + 1013904223u;
+                const int noise = static_cast<int>((state >> 24) & 7u) - 4;
+                unsigned char* pixel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+                auto channel = [noise](int value) { return static_cast<unsigned char>(std::clamp(value + noise, 0, 255)); };
+                if (normalMap) {
+                    pixel[0] = channel(static_cast<int>(x * 255 / width));
+                    pixel[1] = channel(static_cast<int>(y * 255 / height));
+                    pixel[2] = 255;
+                } else {
+                    const int t = static_cast<int>((x + y) * 255 / (width + height));
+                    pixel[0] = channel(t);
+                    pixel[1] = channel(20 + t * 3 / 4);
+                    pixel[2] = channel(255 - t * 3 / 4);
+                }
+                pixel[3] = 255;
+            }
+        }
+        return rgba;
+    }
+
+    bool check(const char* format, const ImageSize& size, bool bc5) {
+        const std::vector<unsigned char> source = makeImage(size.width, size.height, bc5);
+        // Exactly sized so the sanitizer catches any write past the last block
+        std::vector<unsigned char> blocks(BlockCompression::getEncodedSize(size.width, size.height));
+        std::vector<unsigned char> decoded(source.size(), 0);
+        if (bc5) {
+            BlockCompression::encodeBC5(source.data(), size.width, size.height, blocks.data());
+            BlockCompression::decodeBC5(blocks.data(), size.width, size.height, decoded.data());
+        } else {
+            BlockCompression::encodeBC7(source.data(), size.width, size.height, blocks.data());
+            BlockCompression::decodeBC7(blocks.data(), size.width, size.height, decoded.data());
+        }
+
+        const size_t pixelCount = static_cast<size_t>(size.width) * size.height;
+        const double psnr = BlockCompression::computePsnr(source.data(), decoded.data(), pixelCount, bc5 ? 2 : 4);
+        const double minPsnr = bc5 ? BC5_MIN_PSNR : BC7_MIN_PSNR;
+        const bool passed = psnr >= minPsnr;
+        std::cout << format << " " << size.width << "x" << size.height << ": " << psnr << " dB"
+                  << (passed ? "" : " (below the floor)") << std::endl;
+        return passed;
+    }
+}
+
+int main() {
+    bool passed = true;
+    for (const ImageSize& size : IMAGE_SIZES) {
+        passed = check("BC7", size, false) && passed;
+        passed = check("BC5", size, true) && passed;
+    }
+    if (!passed) {
+        std::cerr << "Block compression round trip failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+// Writes the light system benchmark scene: 8 point, 8 spot and 4 directional lights, all casting shadows, over a grid
+// of shadow casters built from the bundled Cube and Sphere meshes and materials.
+// Usage: light_benchmark_scene <out.json> [casterCount]
+// Run the result with main --headless --scene <out.json> from the repository root, where the asset paths resolve;
+// frames.csv and summary.json then report light_ms, the CPU time of LightSystem::updateFrameContext.
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr size_t DEFAULT_CASTER_COUNT = 20000;
+    constexpr size_t GRID_COLUMNS = 200;
+    constexpr float GRID_SPACING = 1.5f;
+    constexpr float PI = 3.14159265f;
+
+    const char* const MESH_PATHS[] = {
+        "Assets/Scene/meshes/Cube_0fddae11-53cc-4449-9567-08431abf328b.json",
+        "Assets/Scene/meshes/Sphere_63fae732-5757-4e03-8194-3205dacef2f5.json",
+    };
+    const char* const MESH_IDS[] = {
+        "Cube_0fddae11-53cc-4449-9567-08431abf328b",
+        "Sphere_63fae732-5757-4e03-8194-3205dacef2f5",
+    };
+    const char* const MATERIAL_IDS[] = {
+        "13e1d11d-293b-4ae9-90b0-a1ac3b0af3e8",
+        "47df98d2-3111-4570-a3c9-faf8dbe98bd4",
+        "91f0ccc9-0d87-497c-985a-d7f3876eec16",
+        "cec13c4c-61f0-4224-a411-5740583ae52a",
+        "d65c42c9-b7ab-405a-b4df-3256448a8f77",
+    };
+    const char* const SKYBOX_PATHS[] = {
+        "Assets/Scene/textures/FluffballDayFront_9852452c.hdr",
+        "Assets/Scene/textures/FluffballDayBack_392749dd.hdr",
+        "Assets/Scene/textures/FluffballDayRight_976ce4fb.hdr",
+        "Assets/Scene/textures/FluffballDayLeft_53679ff1.hdr",
+        "Assets/Scene/textures/FluffballDayTop_08394a24.hdr",
+        "Assets/Scene/textures/FluffballDayBottom_fa5cfdaf.hdr",
+    };
+
+    struct Quat {
+        float x, y, z, w;
+    };
+
+    // Yaw about Y after pitch about X, in degrees; a positive pitch turns +Z down
+    Quat yawPitch(float yawDegrees, float pitchDegrees) {
+        const float halfYaw = yawDegrees * PI / 360.0f;
+        const float halfPitch = pitchDegrees * PI / 360.0f;
+        const float cy = std::cos(halfYaw), sy = std::sin(halfYaw);
+        const float cx = std::cos(halfPitch), sx = std::sin(halfPitch);
+        return {cy * sx, sy * cx, -sy * sx, cy * cx};
+    }
+
+    void writeVec3(std::ostream& out, const char* key, float x, float y, float z) {
+        out << "\"" << key << "\":{\"x\":" << x << ",\"y\":" << y << ",\"z\":" << z << "}";
+    }
+
+    void writeQuat(std::ostream& out, const char* key, const Quat& q) {
+        out << "\"" << key << "\":{\"x\":" << q.x << ",\"y\":" << q.y << ",\"z\":" << q.z << ",\"w\":" << q.w << "}";
+    }
+
+    void writeTransform(std::ostream& out, float x, float y, float z, const Quat& rotation, float scale) {
+        out << "{\"$type\":\"SceneSerialization.sTransform, Assembly-CSharp\",";
+        writeVec3(out, "Position", x, y, z);
+        out << ",";
+        writeQuat(out, "Rotation", rotation);
+        out << ",";
+        writeVec3(out, "Scale", scale, scale, scale);
+        out << "}";
+    }
+
+    void writeScene(const std::string& path, size_t casterCount) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to create " + path);
+        }
+
+        out << "{\"ColorTexturePaths\":[],\"NormalTexturePaths\":[],\"MeshPaths\":[";
+        for (size_t i = 0; i < std::size(MESH_PATHS); i++) {
+            out << (i == 0 ? "" : ",") << "\"" << MESH_PATHS[i] << "\"";
+        }
+        out << "],\"MaterialPaths\":[";
+        for (size_t i = 0; i < std::size(MATERIAL_IDS); i++) {
+            out << (i == 0 ? "" : ",") << "\"Assets/Scene/materials/Material_" << MATERIAL_IDS[i] << ".json\"";
+        }
+        out << "],\"Gameobjects\":[";
+
+        // Camera at the near edge of the grid, looking down across it
+        size_t entityId = 0;
+        out << "{\"EntityID\":" << entityId++ << ",\"components\":[";
+        writeTransform(out, 0.0f, 12.0f, -20.0f, yawPitch(0.0f, 20.0f), 1.0f);
+        out << ",{\"$type\":\"SceneSerialization.sCamera, Assembly-CSharp\",\"FieldOfView\":60,\"NearPlane\":0.3,\"FarPlane\":1000}]}";
+
+        // Directional lights from four sides at different elevations; the light system reads the direction from the
+        // transform, so both carry the rotation
+        for (int i = 0; i < 4; i++) {
+            const Quat direction = yawPitch(45.0f + 90.0f * i, 35.0f + 10.0f * i);
+            out << ",{\"EntityID\":" << entityId++ << ",\"components\":[";
+            writeTransform(out, 0.0f, 0.0f, 0.0f, direction, 1.0f);
+            out << ",{\"$type\":\"SceneSerialization.sDirectionalLight, Assembly-CSharp\",";
+            writeQuat(out, "Direction", direction);
+            out << ",";
+            writeVec3(out, "Color", 1.0f, 0.95f, 0.9f);
+            out << ",\"Intensity\":0.5,\"IsCastingShadows\":true,\"ShadowStrength\":1}]}";
+        }
+
+        // Point lights in a row above the front of the grid, spot lights pointing down behind them
+        for (int i = 0; i < 8; i++) {
+            const float x = (static_cast<float>(i) - 3.5f) * 12.0f;
+            out << ",{\"EntityID\":" << entityId++ << ",\"components\":[";
+            writeTransform(out, x, 3.0f, 10.0f, yawPitch(0.0f, 0.0f), 1.0f);
+            out << ",{\"$type\":\"SceneSerialization.sPointLight, Assembly-CSharp\",\"Intensity\":3,\"Range\":15,";
+            writeVec3(out, "Color", 1.0f, 0.8f, 0.6f);
+            out << ",\"IsCastingShadows\":true,\"ShadowStrength\":1}]}";
+        }
+        for (int i = 0; i < 8; i++) {
+            const float x = (static_cast<float>(i) - 3.5f) * 12.0f;
+            out << ",{\"EntityID\":" << entityId++ << ",\"components\":[";
+            writeTransform(out, x, 10.0f, 30.0f, yawPitch(0.0f, 90.0f), 1.0f);
+            out << ",{\"$type\":\"SceneSerialization.sSpotLight, Assembly-CSharp\",\"Intensity\":5,\"Range\":20,"
+                << "\"InnerCutoff\":40,\"OuterCutoff\":60,";
+            writeVec3(out, "Color", 0.6f, 0.8f, 1.0f);
+            out << ",\"IsCastingShadows\":true,\"ShadowStrength\":1}]}";
+        }
+
+        for (size_t i = 0; i < casterCount; i++) {
+            const float x = (static_cast<float>(i % GRID_COLUMNS) - GRID_COLUMNS * 0.5f) * GRID_SPACING;
+            const float z = static_cast<float>(i / GRID_COLUMNS) * GRID_SPACING;
+            out << ",{\"EntityID\":" << entityId++ << ",\"components\":[";
+            writeTransform(out, x, 0.5f, z, yawPitch(static_cast<float>(i % 8) * 45.0f, 0.0f), 0.8f);
+            out << ",{\"$type\":\"SceneSerialization.sMeshRenderer, Assembly-CSharp\",\"MeshID\":\""
+                << MESH_IDS[i % std::size(MESH_IDS)] << "\",\"MaterialIDs\":[\""
+                << MATERIAL_IDS[i % std::size(MATERIAL_IDS)] << "\"],\"CastingShadows\":true}]}";
+        }
+
+        out << "],\"EnviromentLighting\":{";
+        writeVec3(out, "Color", 0.2f, 0.2f, 0.25f);
+        out << ",\"AmbientIntensity\":1,\"SkyboxPaths\":[";
+        for (size_t i = 0; i < std::size(SKYBOX_PATHS); i++) {
+            out << (i == 0 ? "" : ",") << "\"" << SKYBOX_PATHS[i] << "\"";
+        }
+        out << "],\"ReflectionIntensity\":1}}";
+        if (!out) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+        std::cout << "Wrote 20 lights and " << casterCount << " shadow casters to " << path << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: light_benchmark_scene <out.json> [casterCount]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const size_t casterCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : DEFAULT_CASTER_COUNT;
+    try {
+        writeScene(argv[1], casterCount);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
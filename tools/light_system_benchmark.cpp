@@ -0,0 +1,317 @@
+// Times LightSystem::updateFrameContext on the light benchmark fixture without a GPU.
+// Usage: light_system_benchmark [casterCount] [iterations]
+// The fixture has the layout light_benchmark_scene writes (8 point, 8 spot and 4 directional lights, all casting
+// shadows, over a grid of Cube and Sphere casters) but is built straight into the ECS and scene from bounds-only
+// meshes and properties-only materials. The frame buffers the light system writes are host memory buffers, so no
+// Vulkan device is created. Both point shadow modes are reported: time per call and heap allocations per call.
+#include "Systems/light_system.hpp"
+#include "Systems/camera_system.hpp"
+#include "Rendering/Resources/material.hpp"
+#include "Rendering/Resources/mesh.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+    std::atomic<size_t> allocatedBytes{0};
+}
+
+// Counts every allocation in the process; the harness only reads the difference across the timed calls
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+using namespace Rendering;
+
+namespace {
+    using BenchmarkClock = std::chrono::steady_clock;
+
+    constexpr size_t DEFAULT_CASTER_COUNT = 20000;
+    constexpr size_t DEFAULT_ITERATIONS = 200;
+    constexpr size_t WARMUP_ITERATIONS = 10;
+    // Same grid and camera as light_benchmark_scene
+    constexpr size_t GRID_COLUMNS = 200;
+    constexpr float GRID_SPACING = 1.5f;
+    constexpr size_t MATERIAL_COUNT = 5;
+    // Room for every caster in this many shadow views before the buffers have to grow
+    constexpr size_t INITIAL_VIEWS_PER_CASTER = 8;
+
+    // Yaw about Y after pitch about X, in degrees, as light_benchmark_scene writes them
+    glm::quat yawPitch(float yawDegrees, float pitchDegrees) {
+        const float halfYaw = glm::radians(yawDegrees) * 0.5f;
+        const float halfPitch = glm::radians(pitchDegrees) * 0.5f;
+        const float cy = std::cos(halfYaw), sy = std::sin(halfYaw);
+        const float cx = std::cos(halfPitch), sx = std::sin(halfPitch);
+        return glm::quat(cy * cx, cy * sx, sy * cx, -sy * sx);
+    }
+
+    ECS::Transform makeTransform(ECS::EntityID owner, const glm::vec3& position, const glm::quat& rotation, float scale) {
+        ECS::Transform transform{owner};
+        transform.position = position;
+        transform.rotation = rotation;
+        transform.scale = glm::vec3(scale);
+        Systems::TransformSystem::updateTransform(transform);
+        return transform;
+    }
+
+    struct Fixture {
+        // Unity's Cube and Sphere both fill the unit box around the origin
+        std::vector<std::unique_ptr<Mesh>> meshes;
+        std::vector<std::unique_ptr<Material>> materials;
+    };
+
+    // Adds the fixture to the ECS and scene the way SceneLoader::commitBatch does
+    void buildFixture(Fixture& fixture, size_t casterCount) {
+        fixture.meshes.push_back(std::make_unique<Mesh>(glm::vec3(-0.5f), glm::vec3(0.5f), "Cube"));
+        fixture.meshes.push_back(std::make_unique<Mesh>(glm::vec3(-0.5f), glm::vec3(0.5f), "Sphere"));
+        for (size_t i = 0; i < MATERIAL_COUNT; i++) {
+            Material::MaterialInfo info{};
+            info.name = "Material" + std::to_string(i);
+            info.transparencyType = TransparencyType::TYPE_OPAQUE;
+            fixture.materials.push_back(std::make_unique<Material>(info));
+        }
+
+        auto& ecsManager = ECS::ECSManager::getInstance();
+        ECS::EntityID entity = ecsManager.createEntities(4 + 8 + 8 + casterCount);
+
+        // Directional lights take their direction from the transform
+        std::vector<ECS::EntityID> directionalEntities;
+        std::vector<ECS::Transform> directionalTransforms;
+        std::vector<ECS::DirectionalLight> directionalLights;
+        for (int i = 0; i < 4; i++, entity++) {
+            const glm::quat rotation = yawPitch(45.0f + 90.0f * i, 35.0f + 10.0f * i);
+            directionalEntities.push_back(entity);
+            directionalTransforms.push_back(makeTransform(entity, glm::vec3(0.0f), rotation, 1.0f));
+            directionalLights.emplace_back(entity, 0.5f, glm::vec3(1.0f, 0.95f, 0.9f),
+                glm::vec4(glm::rotate(rotation, glm::vec3(0.0f, 0.0f, 1.0f)), 0.0f), true, 1.0f);
+        }
+        ecsManager.addComponents(directionalEntities, directionalTransforms);
+        ecsManager.addComponents(directionalEntities, directionalLights);
+
+        std::vector<ECS::EntityID> pointEntities;
+        std::vector<ECS::PointLight> pointLights;
+        std::vector<ECS::EntityID> spotEntities;
+        std::vector<ECS::SpotLight> spotLights;
+        for (int i = 0; i < 8; i++, entity++) {
+            const float x = (static_cast<float>(i) - 3.5f) * 12.0f;
+            ECS::PointLight pointLight{entity, 3.0f, 15.0f, glm::vec3(1.0f, 0.8f, 0.6f), true, 1.0f};
+            pointLight.transform = makeTransform(entity, glm::vec3(x, 3.0f, 10.0f), yawPitch(0.0f, 0.0f), 1.0f);
+            pointEntities.push_back(entity);
+            pointLights.push_back(pointLight);
+        }
+        for (int i = 0; i < 8; i++, entity++) {
+            const float x = (static_cast<float>(i) - 3.5f) * 12.0f;
+            ECS::SpotLight spotLight{entity, 5.0f, 20.0f, 40.0f, 60.0f, glm::vec3(0.6f, 0.8f, 1.0f), true, 1.0f};
+            spotLight.transform = makeTransform(entity, glm::vec3(x, 10.0f, 30.0f), yawPitch(0.0f, 90.0f), 1.0f);
+            spotEntities.push_back(entity);
+            spotLights.push_back(spotLight);
+        }
+
+        std::vector<ECS::Light*> lights;
+        for (ECS::SpotLight* spotLight : ecsManager.addComponents(spotEntities, spotLights)) {
+            lights.push_back(spotLight);
+        }
+        for (ECS::PointLight* pointLight : ecsManager.addComponents(pointEntities, pointLights)) {
+            lights.push_back(pointLight);
+        }
+
+        std::vector<ECS::EntityID> casterEntities;
+        std::vector<ECS::Renderable> casters;
+        casterEntities.reserve(casterCount);
+        casters.reserve(casterCount);
+        for (size_t i = 0; i < casterCount; i++, entity++) {
+            const float x = (static_cast<float>(i % GRID_COLUMNS) - GRID_COLUMNS * 0.5f) * GRID_SPACING;
+            const float z = static_cast<float>(i / GRID_COLUMNS) * GRID_SPACING;
+            ECS::Renderable renderable{entity};
+            renderable.transform = makeTransform(entity, glm::vec3(x, 0.5f, z), yawPitch(static_cast<float>(i % 8) * 45.0f, 0.0f), 0.8f);
+            renderable.meshRenderer = ECS::MeshRenderer(entity, fixture.meshes[i % fixture.meshes.size()].get(),
+                {fixture.materials[i % fixture.materials.size()].get()}, true);
+            casterEntities.push_back(entity);
+            casters.push_back(renderable);
+        }
+
+        auto& scene = Scene::Scene::getInstance();
+        scene.addLights(lights);
+        scene.addRenderers(ecsManager.addComponents(casterEntities, casters));
+    }
+
+    // Camera at the near edge of the grid, looking down across it; matrices as CameraSystem builds them
+    CameraData makeCameraData() {
+        ECS::Transform transform = makeTransform(ECS::INVALID_ENTITY_ID, glm::vec3(0.0f, 12.0f, -20.0f), yawPitch(0.0f, 20.0f), 1.0f);
+        ECS::Camera camera{ECS::INVALID_ENTITY_ID};
+        camera.fov = glm::radians(60.0f);
+        camera.aspectRatio = 1920.0f / 1080.0f;
+        camera.nearPlane = 0.3f;
+        camera.farPlane = 1000.0f;
+        camera.projectionMatrix = glm::perspectiveLH_ZO(camera.fov, camera.aspectRatio, camera.nearPlane, camera.farPlane);
+        camera.projectionMatrix[1][1] *= -1.0f;
+        camera.viewMatrix = glm::lookAtLH(transform.position,
+            transform.position + Systems::TransformSystem::getForward(transform), glm::vec3(0.0f, 1.0f, 0.0f));
+        camera.viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
+
+        CameraData cameraData{};
+        cameraData.viewMatrix = camera.viewMatrix;
+        cameraData.viewProjectionMatrix = camera.viewProjectionMatrix;
+        cameraData.projectionMatrix = camera.projectionMatrix;
+        cameraData.position = transform.position;
+        cameraData.nearPlane = camera.nearPlane;
+        cameraData.farPlane = camera.farPlane;
+        cameraData.fov = camera.fov;
+        cameraData.aspectRatio = camera.aspectRatio;
+        cameraData.invViewMatrix = glm::inverse(camera.viewMatrix);
+        cameraData.invProjectionMatrix = glm::inverse(camera.projectionMatrix);
+        cameraData.viewFrustum = Systems::CameraSystem::createFrustumFromCamera(camera);
+        return cameraData;
+    }
+
+    // The buffers LightSystem writes, sized as RenderingResources sizes them
+    struct HostFrameBuffers {
+        std::unique_ptr<Buffer> lightArray = std::make_unique<Buffer>(sizeof(VisibleLightBuffer), 1);
+        std::unique_ptr<Buffer> lightSlotStaging = std::make_unique<Buffer>(sizeof(Rendering::Light), MAX_LIGHTS);
+        std::unique_ptr<Buffer> cascadeSplits = std::make_unique<Buffer>(sizeof(DirectionalLightCascadesBuffer), 1);
+        std::unique_ptr<Buffer> sceneLighting = std::make_unique<Buffer>(sizeof(SceneLightingUbo), 1);
+        std::unique_ptr<Buffer> lightMatrices = std::make_unique<Buffer>(sizeof(ShadowcastingLightMatrices), 1);
+        std::unique_ptr<Buffer> shadowModelMatrices;
+        std::unique_ptr<Buffer> shadowFaceMasks;
+        // Empty, so the splits fall back to the camera range as they do before the first SDSM readback
+        std::unique_ptr<Buffer> depthBounds = std::make_unique<Buffer>(sizeof(DepthBoundsBuffer), 1);
+
+        explicit HostFrameBuffers(size_t shadowInstanceCount)
+            : shadowModelMatrices(std::make_unique<Buffer>(sizeof(glm::mat4), static_cast<uint32_t>(shadowInstanceCount))),
+              shadowFaceMasks(std::make_unique<Buffer>(sizeof(uint32_t), static_cast<uint32_t>(shadowInstanceCount))) {
+            for (Buffer* buffer : {lightArray.get(), lightSlotStaging.get(), cascadeSplits.get(), sceneLighting.get(),
+                                   lightMatrices.get(), shadowModelMatrices.get(), shadowFaceMasks.get(), depthBounds.get()}) {
+                buffer->map();
+            }
+            DepthBoundsBuffer emptyBounds{};
+            depthBounds->writeToBuffer(&emptyBounds);
+        }
+
+        void attach(FrameContext& frameContext) const {
+            frameContext.lightArrayUniformBuffer = lightArray.get();
+            frameContext.lightSlotStagingBuffer = lightSlotStaging.get();
+            frameContext.cascadeSplitsBuffer = cascadeSplits.get();
+            frameContext.sceneLightingBuffer = sceneLighting.get();
+            frameContext.lightMatrixBuffer = lightMatrices.get();
+            frameContext.shadowModelMatrixBuffer = shadowModelMatrices.get();
+            frameContext.shadowFaceMaskBuffer = shadowFaceMasks.get();
+            frameContext.depthBoundsBuffer = depthBounds.get();
+        }
+
+        // Stands in for RenderingResources::reserveShadowInstances, which the frame context cannot reach here
+        void growShadowInstances(size_t instanceCount) {
+            for (Buffer* buffer : {shadowModelMatrices.get(), shadowFaceMasks.get()}) {
+                buffer->resize(buffer->getInstanceSize() * instanceCount);
+                buffer->map();
+            }
+        }
+    };
+
+    uint32_t countShadowInstances(const FrameContext& frameContext) {
+        uint32_t instanceCount = 0;
+        for (const MaterialBatch& batch : frameContext.shadowBatches) {
+            instanceCount += batch.instanceCount;
+        }
+        return instanceCount;
+    }
+
+    void runMode(FrameContext& frameContext, HostFrameBuffers& buffers, size_t casterCount, size_t iterations, bool singlePass) {
+        frameContext.singlePassPointShadows = singlePass;
+
+        // Grow until a call leaves room for every caster: a run of one mesh and material never holds more, so the
+        // light system cannot have dropped instances
+        for (;;) {
+            Systems::LightSystem::updateFrameContext(frameContext);
+            frameContext.temporalFrameIndex++;
+            const size_t capacity = buffers.shadowModelMatrices->getInstanceCount();
+            const size_t instanceCount = countShadowInstances(frameContext);
+            if (instanceCount + casterCount <= capacity) {
+                break;
+            }
+            buffers.growShadowInstances(std::max(capacity * 2, instanceCount + casterCount));
+        }
+        for (size_t i = 0; i < WARMUP_ITERATIONS; i++) {
+            Systems::LightSystem::updateFrameContext(frameContext);
+            frameContext.temporalFrameIndex++;
+        }
+
+        std::vector<double> callMs;
+        callMs.reserve(iterations);
+        const size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        const size_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < iterations; i++) {
+            const auto start = BenchmarkClock::now();
+            Systems::LightSystem::updateFrameContext(frameContext);
+            callMs.push_back(std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count());
+            frameContext.temporalFrameIndex++;
+        }
+        const size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        const size_t bytes = allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+        double totalMs = 0.0;
+        for (double ms : callMs) {
+            totalMs += ms;
+        }
+        std::sort(callMs.begin(), callMs.end());
+        std::cout << (singlePass ? "single-pass" : "per-face") << " point shadows: "
+                  << frameContext.shadowViews.size() << " shadow views, " << frameContext.shadowBatches.size()
+                  << " batches, " << countShadowInstances(frameContext) << " instances" << std::endl;
+        std::cout << "  mean " << totalMs / iterations << " ms, median " << callMs[callMs.size() / 2]
+                  << " ms, best " << callMs.front() << " ms per call" << std::endl;
+        std::cout << "  " << static_cast<double>(allocations) / iterations << " allocations, "
+                  << static_cast<double>(bytes) / iterations << " bytes allocated per call" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t casterCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_CASTER_COUNT;
+    const size_t iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : DEFAULT_ITERATIONS;
+    if (iterations == 0) {
+        std::cerr << "Usage: light_system_benchmark [casterCount] [iterations]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Fixture fixture;
+        buildFixture(fixture, casterCount);
+
+        // Holds the instance batch arrays, too large for the stack
+        auto frameContext = std::make_unique<FrameContext>();
+        frameContext->frameIndex = 0;
+        frameContext->temporalFrameIndex = 0;
+        frameContext->cameraData = makeCameraData();
+        HostFrameBuffers buffers(std::max<size_t>(casterCount * INITIAL_VIEWS_PER_CASTER, 1));
+        buffers.attach(*frameContext);
+
+        std::cout << "20 lights, " << casterCount << " shadow casters, " << iterations << " calls per mode" << std::endl;
+        runMode(*frameContext, buffers, casterCount, iterations, false);
+        runMode(*frameContext, buffers, casterCount, iterations, true);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
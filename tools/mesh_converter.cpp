@@ -0,0 +1,103 @@
+// Offline converter from the Unity JSON meshes to the binary .amesh container.
+// Usage: mesh_converter <mesh.json | directory> [...]
+// Each input is written next to itself with the .amesh extension; directories convert every *.json inside.
+#include "Resources/mesh_binary.hpp"
+#include "Resources/mapped_file.hpp"
+#include "external/libraries/json.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace Resources;
+
+namespace {
+    void readFloats(const json& j, const char* const* keys, int count, float* out) {
+        for (int i = 0; i < count; i++) {
+            out[i] = j.at(keys[i]).get<float>();
+        }
+    }
+
+    void convertMesh(const std::filesystem::path& jsonPath) {
+        std::ifstream file(jsonPath);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open mesh file: " + jsonPath.string());
+        }
+        json j = json::parse(file);
+
+        static const char* const xyzw[] = {"x", "y", "z", "w"};
+        const json& positions = j.at("Vertices");
+        const json& normals = j.at("Normals");
+        const json& uvs = j.at("UVs");
+        const json& tangents = j.at("Tangents");
+
+        // Missing attributes stay zero, as in SceneLoader's JSON path
+        std::vector<MeshBinaryVertex> vertices(positions.size(), MeshBinaryVertex{});
+        for (size_t i = 0; i < vertices.size(); i++) {
+            readFloats(positions[i], xyzw, 3, vertices[i].position);
+            if (i < normals.size()) readFloats(normals[i], xyzw, 3, vertices[i].normal);
+            if (i < uvs.size()) readFloats(uvs[i], xyzw, 2, vertices[i].uv);
+            if (i < tangents.size()) readFloats(tangents[i], xyzw, 4, vertices[i].tangent);
+        }
+
+        std::vector<uint32_t> indices = j.at("Indices").get<std::vector<uint32_t>>();
+        std::vector<MeshBinarySubmesh> submeshes;
+        for (const auto& submesh : j.at("SubMeshes")) {
+            submeshes.push_back({submesh.at("IndexStart").get<uint32_t>(), submesh.at("IndexCount").get<uint32_t>()});
+        }
+
+        const std::string id = j.contains("ID") ? j["ID"].get<std::string>() : "unknown";
+        const std::string binaryPath = MeshBinary::getBinaryPath(jsonPath.string());
+        MeshBinary::write(binaryPath, id, vertices, indices, submeshes);
+
+        // Read the result back through the loader's validation
+        MappedFile mapped;
+        MeshBinaryView view;
+        if (!mapped.open(binaryPath) || !MeshBinary::parse(mapped.data(), mapped.size(), view) ||
+            std::memcmp(view.vertices, vertices.data(), vertices.size() * sizeof(MeshBinaryVertex)) != 0) {
+            throw std::runtime_error("Verification failed for " + binaryPath);
+        }
+
+        std::cout << jsonPath.filename().string() << " -> " << std::filesystem::path(binaryPath).filename().string()
+                  << " (" << vertices.size() << " vertices, " << indices.size() << " indices, "
+                  << std::filesystem::file_size(jsonPath) << " -> " << mapped.size() << " bytes)" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: mesh_converter <mesh.json | directory> [...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int failures = 0;
+    for (int arg = 1; arg < argc; arg++) {
+        std::vector<std::filesystem::path> inputs;
+        const std::filesystem::path input(argv[arg]);
+        if (std::filesystem::is_directory(input)) {
+            for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                    inputs.push_back(entry.path());
+                }
+            }
+        } else {
+            inputs.push_back(input);
+        }
+
+        for (const auto& path : inputs) {
+            try {
+                convertMesh(path);
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to convert " << path.string() << ": " << e.what() << std::endl;
+                failures++;
+            }
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
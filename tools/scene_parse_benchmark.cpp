@@ -0,0 +1,166 @@
+// Compares the scene JSON parsers on parse time and peak memory.
+// Usage: scene_parse_benchmark <dom | sax | stream> <Scene.json> [runs]
+//        scene_parse_benchmark generate <gameObjectCount> <out.json>
+// dom reads the whole file into a string and builds a DOM (the old SceneLoader path), sax streams the mapped file into
+// a DeserializedScene and stream hands each game object to a callback without keeping it. Peak RSS only grows, so
+// run each parser in its own process.
+#include "Resources/deserialized_scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace Resources;
+
+namespace {
+    using BenchmarkClock = std::chrono::steady_clock;
+
+    size_t getPeakRss() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return counters.PeakWorkingSetSize;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Returns the number of game objects seen
+    size_t parseOnce(const std::string& mode, const std::string& path) {
+        if (mode == "dom") {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to open scene file: " + path);
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            return DeserializedScene::deserialize_scene(buffer.str()).gameObjects.size();
+        }
+        if (mode == "sax") {
+            return DeserializedScene::deserialize_scene_file(path).gameObjects.size();
+        }
+        if (mode == "stream") {
+            size_t count = 0;
+            DeserializedScene::deserialize_scene_file(path, [&count](DeserializedGameObject&&) { count++; });
+            return count;
+        }
+        throw std::runtime_error("Unknown mode " + mode);
+    }
+
+    void writeVec3(std::ostream& out, const char* key, float x, float y, float z) {
+        out << "\"" << key << "\":{\"x\":" << x << ",\"y\":" << y << ",\"z\":" << z << "}";
+    }
+
+    // Synthetic scene in the exporter's layout: a camera, a directional light, then mesh objects with a point or spot
+    // light every 64th object
+    void generateScene(size_t gameObjectCount, const std::string& path) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to create " + path);
+        }
+
+        const char* transform = "{\"$type\":\"AlphaExporter.sTransform\",";
+        out << "{\"ColorTexturePaths\":[],\"NormalTexturePaths\":[],\"MeshPaths\":[],\"MaterialPaths\":[],\"Gameobjects\":[";
+        out << "{\"EntityID\":0,\"components\":[" << transform;
+        writeVec3(out, "Position", 0.0f, 2.0f, -10.0f);
+        out << ",\"Rotation\":{\"x\":0,\"y\":0,\"z\":0,\"w\":1},";
+        writeVec3(out, "Scale", 1.0f, 1.0f, 1.0f);
+        out << "},{\"$type\":\"AlphaExporter.sCamera\",\"FieldOfView\":60,\"NearPlane\":0.1,\"FarPlane\":1000}]},";
+        out << "{\"EntityID\":1,\"components\":[{\"$type\":\"AlphaExporter.sDirectionalLight\","
+            << "\"Direction\":{\"x\":0.3,\"y\":0.2,\"z\":0,\"w\":0.93},";
+        writeVec3(out, "Color", 1.0f, 0.95f, 0.9f);
+        out << ",\"Intensity\":1.2,\"IsCastingShadows\":true,\"ShadowStrength\":1}]}";
+
+        for (size_t i = 0; i < gameObjectCount; i++) {
+            const float x = static_cast<float>(i % 100) * 2.0f;
+            const float z = static_cast<float>(i / 100) * 2.0f;
+            out << ",{\"EntityID\":" << i + 2 << ",\"components\":[" << transform;
+            writeVec3(out, "Position", x, 0.0f, z);
+            out << ",\"Rotation\":{\"x\":0,\"y\":0.382683,\"z\":0,\"w\":0.92388},";
+            writeVec3(out, "Scale", 1.0f, 1.0f, 1.0f);
+            out << "},{\"$type\":\"AlphaExporter.sMeshRenderer\",\"MeshID\":\"mesh_" << i % 32
+                << "\",\"CastingShadows\":true,\"MaterialIDs\":[\"material_" << i % 16 << "\",\"material_" << (i + 1) % 16 << "\"]}";
+            if (i % 128 == 0) {
+                out << ",{\"$type\":\"AlphaExporter.sPointLight\",\"Intensity\":2,\"Range\":8,";
+                writeVec3(out, "Color", 1.0f, 0.8f, 0.6f);
+                out << ",\"IsCastingShadows\":false,\"ShadowStrength\":1}";
+            } else if (i % 128 == 64) {
+                out << ",{\"$type\":\"AlphaExporter.sSpotLight\",\"Intensity\":4,\"Range\":12,\"InnerCutoff\":20,\"OuterCutoff\":30,";
+                writeVec3(out, "Color", 0.6f, 0.8f, 1.0f);
+                out << ",\"IsCastingShadows\":false,\"ShadowStrength\":1}";
+            }
+            out << "]}";
+        }
+
+        out << "],\"EnviromentLighting\":{";
+        writeVec3(out, "Color", 0.2f, 0.2f, 0.25f);
+        out << ",\"AmbientIntensity\":1,\"SkyboxPaths\":[\"px.png\",\"nx.png\",\"py.png\",\"ny.png\",\"pz.png\",\"nz.png\"],"
+            << "\"ReflectionIntensity\":1}}";
+        if (!out) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+        std::cout << "Wrote " << gameObjectCount + 2 << " game objects to " << path << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: scene_parse_benchmark <dom | sax | stream> <Scene.json> [runs]" << std::endl;
+        std::cerr << "       scene_parse_benchmark generate <gameObjectCount> <out.json>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string mode = argv[1];
+    try {
+        if (mode == "generate") {
+            if (argc < 4) {
+                std::cerr << "Usage: scene_parse_benchmark generate <gameObjectCount> <out.json>" << std::endl;
+                return EXIT_FAILURE;
+            }
+            generateScene(std::strtoull(argv[2], nullptr, 10), argv[3]);
+            return EXIT_SUCCESS;
+        }
+
+        const std::string path = argv[2];
+        const int runs = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+        const size_t baselineRss = getPeakRss();
+
+        double bestMs = 0.0;
+        double totalMs = 0.0;
+        size_t gameObjectCount = 0;
+        for (int run = 0; run < runs; run++) {
+            const auto start = BenchmarkClock::now();
+            gameObjectCount = parseOnce(mode, path);
+            const double ms = std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count();
+            bestMs = run == 0 ? ms : std::min(bestMs, ms);
+            totalMs += ms;
+        }
+
+        const size_t peakRss = getPeakRss();
+        std::cout << mode << ": " << gameObjectCount << " game objects, best " << bestMs << " ms, average "
+                  << totalMs / runs << " ms over " << runs << " run(s), peak RSS " << peakRss / (1024.0 * 1024.0)
+                  << " MB (+" << (peakRss - baselineRss) / (1024.0 * 1024.0) << " MB while parsing)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}